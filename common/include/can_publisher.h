@@ -0,0 +1,147 @@
+/**
+ * @file can_publisher.h
+ * @brief Header for can_publisher.c file. Periodic publication of the distances and the state of the Urbanite on the CAN bus.
+ *
+ * Four messages are published, each one at its own configurable period:
+ * - State (`CAN_PUBLISHER_ID_STATE`): byte 0 state of the Urbanite FSM, byte 1 number of sensors, bytes 2-3 frames dropped
+ *   (saturated), bytes 4-7 uptime in ms.
+ * - Distance (`CAN_PUBLISHER_ID_DISTANCE` + page): 4 sensors per frame, 2 bytes per sensor in cm. `CAN_PUBLISHER_NO_VALUE` if
+ *   the sensor has no measurement.
+ * - Confidence (`CAN_PUBLISHER_ID_CONFIDENCE`): 8 sensors per frame, 1 byte per sensor in % (0 to 100).
+ * - Time to collision (`CAN_PUBLISHER_ID_TTC` + page): 4 sensors per frame, 2 bytes per sensor in units of
+ *   `CAN_PUBLISHER_TTC_UNIT_MS`. `CAN_PUBLISHER_NO_VALUE` if the obstacle is not approaching.
+ * - Quantiles (`CAN_PUBLISHER_ID_QUANTILES` + index of the quantile metric in `METRICS_QUANTILES`): bytes 0-1 median, 2-3 p90,
+ *   4-5 p99 and 6-7 number of samples, all saturated. Only with `USE_METRICS`, and disabled by default: enable it with
+ *   `can_publisher_set_period()`.
+ *
+ * All the multi-byte fields are little endian. The page of a message is the index of its first sensor divided by the number of
+ * sensors per frame, so all the sensors of the system are packed in as few frames as possible.
+ *
+ * The frames are written into a software queue and moved to the free transmit mailboxes of the controller (all of them) by
+ * `can_publisher_run()`, so publishing never waits for the bus. When the queue is full, the new frames are dropped and counted.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef CAN_PUBLISHER_H_
+#define CAN_PUBLISHER_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Other includes */
+#include "port_can.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define CAN_PUBLISHER_MAX_SENSORS 8             /*!<    Maximum number of sensors published*/
+#define CAN_PUBLISHER_QUEUE_LEN 16              /*!<    Number of frames of the software queue. It must be a power of 2*/
+
+#define CAN_PUBLISHER_ID_STATE 0x300U           /*!<    Identifier of the state message*/
+#define CAN_PUBLISHER_ID_DISTANCE 0x310U        /*!<    Identifier of the first page of the distance message*/
+#define CAN_PUBLISHER_ID_CONFIDENCE 0x320U      /*!<    Identifier of the first page of the confidence message*/
+#define CAN_PUBLISHER_ID_TTC 0x330U             /*!<    Identifier of the first page of the time-to-collision message*/
+#define CAN_PUBLISHER_ID_QUANTILES 0x340U       /*!<    Identifier of the quantiles of the first quantile metric*/
+
+#define CAN_PUBLISHER_NO_VALUE 0xFFFFU          /*!<    Value of a 2-byte field without data*/
+#define CAN_PUBLISHER_TTC_UNIT_MS 10U           /*!<    Resolution of the time to collision in ms*/
+
+#define CAN_PUBLISHER_STATE_PERIOD_MS 1000U     /*!<    Default period of the state message in ms*/
+#define CAN_PUBLISHER_DISTANCE_PERIOD_MS 100U   /*!<    Default period of the distance message in ms (one measurement period)*/
+#define CAN_PUBLISHER_CONFIDENCE_PERIOD_MS 500U /*!<    Default period of the confidence message in ms*/
+#define CAN_PUBLISHER_TTC_PERIOD_MS 100U        /*!<    Default period of the time-to-collision message in ms*/
+#define CAN_PUBLISHER_QUANTILES_PERIOD_MS 10000U    /*!<    Recommended period of the quantiles message in ms (disabled by default)*/
+
+/* Enums */
+/**
+ * @brief Messages published on the CAN bus.
+ */
+typedef enum
+{
+    CAN_PUBLISHER_MSG_STATE = 0,    /*!<    State of the system*/
+    CAN_PUBLISHER_MSG_DISTANCE,     /*!<    Distance of each sensor*/
+    CAN_PUBLISHER_MSG_CONFIDENCE,   /*!<    Confidence of the distance of each sensor*/
+    CAN_PUBLISHER_MSG_TTC,          /*!<    Time to collision of each sensor*/
+    CAN_PUBLISHER_MSG_QUANTILES,    /*!<    Quantiles of each quantile metric*/
+    CAN_PUBLISHER_NUM_MSGS          /*!<    Number of messages*/
+} can_publisher_msg_t;
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Statistics of the publisher.
+ */
+typedef struct
+{
+    uint32_t queued;        /*!<    Number of frames written into the software queue*/
+    uint32_t sent;          /*!<    Number of frames moved to a transmit mailbox*/
+    uint32_t dropped;       /*!<    Number of frames dropped because the queue was full*/
+    uint32_t max_depth;     /*!<    Maximum number of frames waiting in the queue*/
+} can_publisher_stats_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Initialize the publisher and the CAN controller. All the messages but the quantiles are enabled with their default
+ * periods and are published in the first call to `can_publisher_run()`.
+ *
+ * @param num_sensors   Number of sensors published (up to `CAN_PUBLISHER_MAX_SENSORS`).
+ * @param loopback      Start the controller in loopback mode (tests).
+ * @return true         If the controller has started.
+ * @return false        Otherwise. The frames are queued but not sent.
+ */
+bool can_publisher_init(uint32_t num_sensors, bool loopback);
+
+/**
+ * @brief Set the period of a message.
+ *
+ * @param msg           Message.
+ * @param period_ms     Period in ms. 0 to stop publishing the message.
+ */
+void can_publisher_set_period(can_publisher_msg_t msg, uint32_t period_ms);
+
+/**
+ * @brief Update the measurement of a sensor. The time to collision is computed from the approach speed between two
+ * measurements with different timestamps.
+ *
+ * @param sensor_idx        Index of the sensor.
+ * @param distance_cm       Distance in cm.
+ * @param confidence_pct    Confidence of the distance in %.
+ * @param timestamp_ms      Time of the measurement in ms. Calls with the same timestamp update the same measurement.
+ */
+void can_publisher_set_sensor(uint32_t sensor_idx, uint32_t distance_cm, uint32_t confidence_pct, uint32_t timestamp_ms);
+
+/**
+ * @brief Update the state of the system published in the state message.
+ *
+ * @param state     State of the Urbanite FSM.
+ */
+void can_publisher_set_state(uint32_t state);
+
+/**
+ * @brief Queue a frame for transmission, and move the queued frames to the free mailboxes. It does not wait.
+ *
+ * @param p_frame   Pointer to the frame. It is copied.
+ * @return true     If the frame has been queued.
+ * @return false    If the queue is full. The frame is dropped.
+ */
+bool can_publisher_publish(const port_can_frame_t *p_frame);
+
+/**
+ * @brief Queue the messages whose period has elapsed and move the queued frames to the free mailboxes. It does not wait.
+ * Call it periodically (e.g., as a task of the scheduler).
+ *
+ * @return uint32_t Number of frames moved to the mailboxes.
+ */
+uint32_t can_publisher_run(void);
+
+/**
+ * @brief Get the statistics of the publisher.
+ *
+ * @param p_stats   Pointer to the structure that receives the statistics.
+ */
+void can_publisher_get_stats(can_publisher_stats_t *p_stats);
+
+#endif /* CAN_PUBLISHER_H_ */
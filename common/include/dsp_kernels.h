@@ -0,0 +1,130 @@
+/**
+ * @file dsp_kernels.h
+ * @brief Header for dsp_kernels.c file. Arithmetic kernels of the per-measurement path of the system.
+ *
+ * Each kernel has two implementations with exactly the same results:
+ * - `dsp_xxx()`: the one used by the system. When the target has the DSP extension (`__ARM_FEATURE_DSP`, i.e. Cortex-M4/M7)
+ *   it uses the packed 8/16-bit SIMD instructions (`SMLAD`, `USUB16`/`SEL`, `UXTB16`). Otherwise it is the portable one.
+ * - `dsp_xxx_c()`: the portable C reference. It is always compiled, so tests and benchmarks can compare both of them on the target.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef DSP_KERNELS_H_
+#define DSP_KERNELS_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define DSP_RGB_PACK(r, g, b) ((uint32_t)(r) | ((uint32_t)(g) << 8) | ((uint32_t)(b) << 16))  /*!<    Pack the levels of a color in a word as `0x00BBGGRR` @hideinitializer */
+#define DSP_RGB_GET_R(rgb) ((uint8_t)((rgb) & 0xFFU))          /*!<    Get the red level of a packed color @hideinitializer */
+#define DSP_RGB_GET_G(rgb) ((uint8_t)(((rgb) >> 8) & 0xFFU))   /*!<    Get the green level of a packed color @hideinitializer */
+#define DSP_RGB_GET_B(rgb) ((uint8_t)(((rgb) >> 16) & 0xFFU))  /*!<    Get the blue level of a packed color @hideinitializer */
+
+#define DSP_ECHO_TIMER_PERIOD_TICKS 65536U  /*!<    Number of ticks of a period of the echo timers (16-bit counters)   */
+
+#define DSP_TICKS_TO_CM_NUM 10          /*!<    Numerator of the conversion of echo ticks (us) into cm. Speed of sound: 1 cm = 58.3 us   */
+#define DSP_TICKS_TO_CM_DEN 583         /*!<    Denominator of the conversion of echo ticks (us) into cm   */
+#define DSP_TICKS_TO_CM_MAGIC 18417527U /*!<    ceil(2^30 * 10 / 583). Multiplying by it and shifting 30 bits is exact for ticks below 2^30   */
+#define DSP_TICKS_TO_CM_SHIFT 30        /*!<    Shift of the reciprocal multiplication of the conversion into cm   */
+
+#define DSP_MEDIAN_MAX_VALUES 16        /*!<    Maximum number of values of the window of the median   */
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Blend two packed colors.
+ * Each level is `((255 - t) * level_1 + t * level_2) / 255`, truncated.
+ * - t = 0   → 100% rgb_1
+ * - t = 255 → 100% rgb_2
+ *
+ * @param rgb_1     First color, packed with `DSP_RGB_PACK()`.
+ * @param rgb_2     Second color, packed with `DSP_RGB_PACK()`.
+ * @param t         Weight of the second color, from 0 to 255.
+ * @return uint32_t Blended color, packed as `0x00BBGGRR`.
+ */
+uint32_t dsp_blend_rgb(uint32_t rgb_1, uint32_t rgb_2, uint8_t t);
+
+/**
+ * @brief Portable C reference of `dsp_blend_rgb()`.
+ *
+ * @param rgb_1     First color, packed with `DSP_RGB_PACK()`.
+ * @param rgb_2     Second color, packed with `DSP_RGB_PACK()`.
+ * @param t         Weight of the second color, from 0 to 255.
+ * @return uint32_t Blended color, packed as `0x00BBGGRR`.
+ */
+uint32_t dsp_blend_rgb_c(uint32_t rgb_1, uint32_t rgb_2, uint8_t t);
+
+/**
+ * @brief Compute the duration of an echo from the captures of its edges and the overflows of the echo timer in between.
+ * If the end capture is lower than the init one, the counter has wrapped around between the edges: that overflow is already
+ * counted by the difference, so it is discounted. It has a single (portable) implementation.
+ *
+ * @param init_tick Capture of the rising edge of the echo.
+ * @param end_tick  Capture of the falling edge of the echo.
+ * @param overflows Number of overflows of the echo timer between the edges.
+ * @return uint32_t Duration of the echo in ticks (us).
+ */
+uint32_t dsp_echo_ticks(uint32_t init_tick, uint32_t end_tick, uint32_t overflows);
+
+/**
+ * @brief Convert the duration of an echo in ticks of 1 us into a distance in cm.
+ * The result is `ticks * 10 / 583`, truncated, without the 64-bit division.
+ *
+ * @param ticks     Duration of the echo in us.
+ * @return uint32_t Distance in cm.
+ */
+uint32_t dsp_ticks_to_cm(uint32_t ticks);
+
+/**
+ * @brief Portable C reference of `dsp_ticks_to_cm()`. It performs the 64-bit division.
+ *
+ * @param ticks     Duration of the echo in us.
+ * @return uint32_t Distance in cm.
+ */
+uint32_t dsp_ticks_to_cm_c(uint32_t ticks);
+
+/**
+ * @brief Compute the median of a window of values. The window is not modified.
+ * If the number of values is even, the median is the truncated mean of the two central values.
+ *
+ * @param p_values  Pointer to the window of values.
+ * @param n         Number of values of the window. It must be greater than 0 and not greater than `DSP_MEDIAN_MAX_VALUES`.
+ * @return uint32_t Median of the window. 0 if the number of values is not valid.
+ */
+uint32_t dsp_median_u32(const uint32_t *p_values, uint32_t n);
+
+/**
+ * @brief Portable C reference of `dsp_median_u32()`. It sorts a copy of the window by insertion.
+ *
+ * @param p_values  Pointer to the window of values.
+ * @param n         Number of values of the window. It must be greater than 0 and not greater than `DSP_MEDIAN_MAX_VALUES`.
+ * @return uint32_t Median of the window. 0 if the number of values is not valid.
+ */
+uint32_t dsp_median_u32_c(const uint32_t *p_values, uint32_t n);
+
+/**
+ * @brief Compute the truncated mean of a window of values.
+ * The window is stored as 32-bit words, so packing it into halfwords for `SMLAD` costs more than the additions it saves:
+ * this kernel is the portable loop in all the targets.
+ *
+ * @param p_values  Pointer to the window of values.
+ * @param n         Number of values of the window.
+ * @return uint32_t Mean of the window. 0 if there are no values.
+ */
+uint32_t dsp_mean_u32(const uint32_t *p_values, uint32_t n);
+
+/**
+ * @brief Portable C reference of `dsp_mean_u32()`.
+ *
+ * @param p_values  Pointer to the window of values.
+ * @param n         Number of values of the window.
+ * @return uint32_t Mean of the window. 0 if there are no values.
+ */
+uint32_t dsp_mean_u32_c(const uint32_t *p_values, uint32_t n);
+
+#endif /* DSP_KERNELS_H_ */
@@ -42,6 +42,15 @@ enum FSM_DISPLAY_SYSTEM
 /* Typedefs --------------------------------------------------------------------*/
 typedef struct fsm_display_t fsm_display_t;     /*!<    Structure to define the FSM of the display system.*/
 
+/**
+ * @brief Snapshot of the display FSM, to resume the display after a low power mode or a reset.
+ */
+typedef struct
+{
+    int32_t distance_cm;    /*!<    Last distance shown*/
+    bool status;            /*!<    The display is active*/
+} fsm_display_snapshot_t;
+
 /* Function prototypes and explanation -------------------------------------------------*/
 /**
  * @brief Create a new display FSM.
@@ -136,4 +145,22 @@ uint32_t fsm_display_get_state (fsm_display_t * p_fsm);
 void fsm_display_set_state (fsm_display_t * p_fsm, int8_t state);		
 
 
-#endif /* FSM_DISPLAY_SYSTEM_H_ */
\ No newline at end of file
+/**
+ * @brief Save the state of the display FSM.
+ * 
+ * @param p_fsm         Pointer to an fsm_display_t struct.
+ * @param p_snapshot    Pointer to store the snapshot.
+ */
+void fsm_display_save (fsm_display_t * p_fsm, fsm_display_snapshot_t *p_snapshot);
+
+/**
+ * @brief Restore a snapshot into a new display FSM (as returned by `fsm_display_new()`).
+ * The display is activated if it was active, but the last distance is not shown again: the color is set with the next distance,
+ * so a distance measured before the reset is never presented as a current one.
+ * 
+ * @param p_fsm         Pointer to an fsm_display_t struct.
+ * @param p_snapshot    Pointer to the snapshot.
+ */
+void fsm_display_restore (fsm_display_t * p_fsm, const fsm_display_snapshot_t *p_snapshot);
+
+#endif /* FSM_DISPLAY_SYSTEM_H_ */
@@ -16,9 +16,14 @@
 
 /* Project includes */
 #include "fsm.h"
+#include "ranging.h"
 
 /* Defines and enums ----------------------------------------------------------*/
 #define FSM_ULTRASOUND_NUM_MEASUREMENTS   5         /*!<    Number of measurements to store in the array*/
+#define FSM_ULTRASOUND_CONFIDENCE_TOL_CM  5         /*!<    Maximum distance in cm to the median of the measurements that agree with it*/
+#define FSM_ULTRASOUND_QUEUE_LEN          8         /*!<    Number of published distances queued until they are read. It must be a power of 2*/
+#define FSM_ULTRASOUND_RESTORE_NEW_MEASUREMENTS (FSM_ULTRASOUND_NUM_MEASUREMENTS / 2 + 1)   /*!<    New measurements before the median of a restored window is published: a majority, so the median lies within their range*/
+#define FSM_ULTRASOUND_SHORT_RANGE_CM     30        /*!<    Distance in cm up to which the short-range device, if any, also measures*/
 
 /**
  * @brief Enumerator for the ultrasound finite state machine.
@@ -37,7 +42,50 @@ enum  FSM_ULTRASOUND
 /* Typedefs --------------------------------------------------------------------*/
 typedef struct fsm_ultrasound_t fsm_ultrasound_t;       /*!<    Structure to define the ultrasound FSM.*/
 
+/**
+ * @brief Distance published by the ultrasound FSM, as queued until it is read.
+ */
+typedef struct
+{
+    uint32_t distance_cm;       /*!<    Median of the window in cm*/
+    uint32_t confidence_pct;    /*!<    Percentage of measurements of the window within `FSM_ULTRASOUND_CONFIDENCE_TOL_CM` of the median*/
+    uint32_t timestamp_ms;      /*!<    Time of the publication in ms of the system*/
+} fsm_ultrasound_measurement_t;
+
+/**
+ * @brief Snapshot of the ultrasound FSM, to resume the measurements after a low power mode or a reset without refilling the whole window.
+ */
+typedef struct
+{
+    uint32_t distance_arr[FSM_ULTRASOUND_NUM_MEASUREMENTS];    /*!<    Window of the last distance measurements*/
+    uint32_t distance_idx;                                      /*!<    Index of the next measurement in the window*/
+    uint32_t distance_cm;                                       /*!<    Last distance published*/
+    bool window_full;                                           /*!<    The window holds a whole set of measurements*/
+    bool status;                                                /*!<    The sensor is measuring*/
+    bool standby;                                               /*!<    The sensor is in warm standby*/
+} fsm_ultrasound_snapshot_t;
+
 /* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Store the distance of the echo captured by the port in a window of distances, and release the echo timer for the next measurement.
+ * It is the computation of each echo, shared by the ultrasound FSM and the protothread (`pt_ultrasound.h`).
+ *
+ * @param ultrasound_id     Ultrasound ID.
+ * @param p_distance_arr    Window of `FSM_ULTRASOUND_NUM_MEASUREMENTS` distances.
+ * @param distance_idx      Index of the window where the distance is stored.
+ * @return uint32_t         Index of the next distance. 0 if the window has been completed.
+ */
+uint32_t fsm_ultrasound_store_echo(uint32_t ultrasound_id, uint32_t *p_distance_arr, uint32_t distance_idx);
+
+/**
+ * @brief Compute the median of a window of distances and record it in the metrics.
+ * It is the computation of each distance published, shared by the ultrasound FSM and the protothread (`pt_ultrasound.h`).
+ *
+ * @param p_distance_arr    Window of `FSM_ULTRASOUND_NUM_MEASUREMENTS` distances.
+ * @return uint32_t         Median of the window in cm.
+ */
+uint32_t fsm_ultrasound_publish_median(const uint32_t *p_distance_arr);
+
 /**
  * @brief Set the state of the ultrasound FSM.
  *
@@ -73,6 +121,7 @@ void fsm_ultrasound_destroy(fsm_ultrasound_t * p_fsm);
 /**
  * @brief Fire the ultrasound FSM.
  * This function is used to fire the ultrasound FSM. It is used to check the transitions and execute the actions of the ultrasound FSM.
+ * Then, the short-range device, if any, is served (`fsm_ultrasound_set_short_range()`).
  * 
  * @param p_fsm     Pointer to an fsm_ultrasound_t struct.
  */
@@ -80,13 +129,57 @@ void fsm_ultrasound_fire(fsm_ultrasound_t * p_fsm);
 
 /**
  * @brief Return the distance of the last object detected by the ultrasound sensor.a64l.
- * The function also resets the field new_measurement to indicate that the distance has been read.
+ * The function also discards the queued measurements to indicate that the distance has been read.
+ * Use `fsm_ultrasound_read_measurements()` instead to process every distance published.
  * 
  * @param p_fsm        Pointer to an fsm_ultrasound_t struct.
  * @return uint32_t    Distance measured by the ultrasound sensor in centimeters.
  */
 uint32_t fsm_ultrasound_get_distance(fsm_ultrasound_t * p_fsm);
 
+/**
+ * @brief Get the last distance published by the sensor, with its confidence and its time, without reading the queue of measurements.
+ * The confidence is the one published with the distance: the percentage of measurements of the window within
+ * `FSM_ULTRASOUND_CONFIDENCE_TOL_CM` of the median, or the confidence of the result of the short-range device.
+ * 
+ * @param p_fsm             Pointer to an fsm_ultrasound_t struct.
+ * @param p_distance_cm     Pointer to store the distance in cm.
+ * @param p_confidence_pct  Pointer to store the confidence in %.
+ * @param p_timestamp_ms    Pointer to store the time of the distance in ms of the system.
+ * @return true             If the sensor has published a distance since it was created.
+ * @return false            Otherwise. The outputs are not written.
+ */
+bool fsm_ultrasound_get_measurement(fsm_ultrasound_t * p_fsm, uint32_t *p_distance_cm, uint32_t *p_confidence_pct, uint32_t *p_timestamp_ms);
+
+/**
+ * @brief Read the queued measurements of the sensor, oldest first. The ones read are removed from the queue.
+ * Up to `FSM_ULTRASOUND_QUEUE_LEN` distances are kept until they are read: the ones published while the queue is full are dropped
+ * and counted as overruns. In the warm standby, the oldest distance is replaced instead, without counting an overrun.
+ *
+ * @param p_fsm             Pointer to an fsm_ultrasound_t struct.
+ * @param p_measurements    Array to store the measurements.
+ * @param max               Size of the array.
+ * @return uint32_t         Number of measurements stored in the array.
+ */
+uint32_t fsm_ultrasound_read_measurements(fsm_ultrasound_t * p_fsm, fsm_ultrasound_measurement_t *p_measurements, uint32_t max);
+
+/**
+ * @brief Get the number of queued measurements of the sensor that have not been read.
+ *
+ * @param p_fsm     Pointer to an fsm_ultrasound_t struct.
+ * @return uint32_t Number of measurements in the queue.
+ */
+uint32_t fsm_ultrasound_get_num_measurements(fsm_ultrasound_t * p_fsm);
+
+/**
+ * @brief Get the number of distances dropped because the queue of measurements was full since the sensor was started.
+ * A non-zero value means that the reader does not keep up with the sensor.
+ *
+ * @param p_fsm     Pointer to an fsm_ultrasound_t struct.
+ * @return uint32_t Number of overruns.
+ */
+uint32_t fsm_ultrasound_get_overruns(fsm_ultrasound_t * p_fsm);
+
 /**
  * @brief Get the inner FSM of the ultrasound.
  * This function returns the inner FSM of the ultrasound.
@@ -97,7 +190,7 @@ uint32_t fsm_ultrasound_get_distance(fsm_ultrasound_t * p_fsm);
 fsm_t* fsm_ultrasound_get_inner_fsm	(fsm_ultrasound_t * p_fsm);
 
 /**
- * @brief Return the flag that indicates if a new measurement is ready.
+ * @brief Check if there are measurements in the queue that have not been read.
  * 
  * @param p_fsm     Pointer to the ultrasound FSM.
  * @return true 
@@ -157,15 +250,73 @@ void fsm_ultrasound_set_status(fsm_ultrasound_t * p_fsm, bool status);
  * @brief Start the ultrasound sensor.
  * This function starts the ultrasound sensor by indicating to the port to start the ultrasound sensor (to reset all timer ticks)
  * and to set the status of the ultrasound sensor to active.
+ * It also powers up the sensor. If it has a supply-enable pin, the first measurement waits for the settling time of the sensor.
  * 
  * @param p_fsm     Pointer to an fsm_ultrasound_t struct.
  */
 void fsm_ultrasound_start(fsm_ultrasound_t * p_fsm);
 
+/**
+ * @brief Start the ultrasound sensor in warm standby, or move a running sensor to the warm standby.
+ * In warm standby the sensor stays powered and measures at the low rate `PORT_PARKING_SENSOR_STANDBY_PERIOD_MS`, so the window
+ * of distances is always filled. A later call to `fsm_ultrasound_start()` leaves the standby: the next measurement is triggered
+ * right away and the median of the window is published with it, so a valid distance is ready within one measurement period.
+ * 
+ * @param p_fsm     Pointer to an fsm_ultrasound_t struct.
+ */
+void fsm_ultrasound_start_standby(fsm_ultrasound_t * p_fsm);
+
+/**
+ * @brief Check if the ultrasound sensor is in warm standby.
+ * 
+ * @param p_fsm     Pointer to an fsm_ultrasound_t struct.
+ * @return true     If the sensor is measuring at the low rate of the warm standby.
+ * @return false    Otherwise.
+ */
+bool fsm_ultrasound_get_standby(fsm_ultrasound_t * p_fsm);
+
+/**
+ * @brief Save the state of the measurements of the ultrasound FSM.
+ * 
+ * @param p_fsm         Pointer to an fsm_ultrasound_t struct.
+ * @param p_snapshot    Pointer to store the snapshot.
+ */
+void fsm_ultrasound_save(fsm_ultrasound_t * p_fsm, fsm_ultrasound_snapshot_t *p_snapshot);
+
+/**
+ * @brief Restore a snapshot into a new ultrasound FSM (as returned by `fsm_ultrasound_new()`).
+ * If the sensor was measuring, it is started again. If the window is kept and it was full, its median is published once
+ * `FSM_ULTRASOUND_RESTORE_NEW_MEASUREMENTS` new measurements have replaced the oldest distances, instead of after a whole new
+ * window: the distances of the snapshot alone are never published. If it was in warm standby, it goes back to the low rate.
+ * 
+ * @param p_fsm         Pointer to an fsm_ultrasound_t struct.
+ * @param p_snapshot    Pointer to the snapshot.
+ * @param keep_window   Keep the window of distances of the snapshot. It must be false when the snapshot may be outdated
+ *                      (e.g., after a power-on reset): the sensor then starts with an empty window.
+ */
+void fsm_ultrasound_restore(fsm_ultrasound_t * p_fsm, const fsm_ultrasound_snapshot_t *p_snapshot, bool keep_window);
+
+/**
+ * @brief Bind a ranging device of another technology (e.g., a ToF sensor) that measures the short range, faster than the ultrasound sensor.
+ * While the sensor is measuring (not in warm standby) and the last distance published is within `FSM_ULTRASOUND_SHORT_RANGE_CM`,
+ * the device is enabled and measures continuously with each fire of the FSM. Each of its results with confidence within the short
+ * range is published right away, with its own confidence, between the medians of the ultrasound sensor. The device is disabled
+ * when the distance leaves the short range and when the sensor stops.
+ *
+ * The device must be initialized (`ranging_init()`) and must not drive the ultrasound sensor of the FSM.
+ *
+ * @param p_fsm     Pointer to an fsm_ultrasound_t struct.
+ * @param p_device  Pointer to the short-range device. NULL to measure with the ultrasound sensor only.
+ */
+void fsm_ultrasound_set_short_range(fsm_ultrasound_t * p_fsm, ranging_device_t *p_device);
+
 /**
  * @brief Stop the ultrasound sensor.
  * This function stops the ultrasound sensor by indicating to the port to stop the ultrasound sensor
  * (to reset all timer ticks) and to set the status of the ultrasound sensor to inactive.
+ * The port also powers down the sensor if it has a supply-enable pin.
+ * The FSM goes back to `WAIT_START`: a measurement in progress is discarded, and so are the queued measurements and their overruns.
+ * The short-range device, if any, is disabled.
  * 
  * @param p_fsm     Pointer to an fsm_ultrasound_t struct.
  */
@@ -12,6 +12,7 @@
 /* Includes ------------------------------------------------------------------*/
 /* Standard C includes */
 #include <stdint.h>
+#include <stdbool.h>
 
 
 /* Project includes */
@@ -36,6 +37,10 @@ enum FSM_URBANITE
 };
 
 
+/* Defines */
+#define FSM_URBANITE_SNAPSHOT_VERSION 1     /*!<    Version of the layout of the snapshot. Change it when the snapshot of any FSM changes*/
+
+
 /* Typedefs --------------------------------------------------------------------*/
 typedef struct fsm_urbanite_t fsm_urbanite_t;       /*!<    Structure that contains the information of the Urbanite FSM.*/
 
@@ -54,6 +59,49 @@ typedef struct fsm_urbanite_t fsm_urbanite_t;       /*!<    Structure that conta
  */
 fsm_urbanite_t * fsm_urbanite_new (fsm_button_t *p_fsm_button, uint32_t on_off_press_time_ms, uint32_t pause_display_time_ms, uint32_t emergency_time_ms, fsm_ultrasound_t *p_fsm_ultrasound_rear, fsm_display_t *p_fsm_display_rear);
 
+/**
+ * @brief Enable the activation of the Urbanite by the reverse gear of the vehicle.
+ * Engaging the reverse gear turns the system ON without the long press of the button, and releasing it turns the system OFF
+ * (if it was turned ON by the reverse gear). With warm standby, the sensor keeps measuring at a low rate while the ignition is on
+ * and the system is OFF, so a valid distance is shown within one measurement period of engaging the reverse gear.
+ * The HW of the reverse input must be initialized with `port_reverse_init()`.
+ * 
+ * @param p_fsm         Pointer to the fsm_urbanite_t struct.
+ * @param reverse_id    Reverse input ID of the vehicle.
+ * @param warm_standby  Keep the sensor in warm standby while the ignition is on.
+ */
+void fsm_urbanite_set_reverse (fsm_urbanite_t *p_fsm, uint32_t reverse_id, bool warm_standby);
+
+/**
+ * @brief Resume the Urbanite from the snapshot in the backup memory, and save a snapshot before each low power mode from now on.
+ * If the system was ON, it goes back to MEASURE without the ON gesture, with the display active (or paused) and the sensor
+ * measuring with its window of distances, so a filtered distance is shown once a majority of the window is new. The window is
+ * dropped after a power-on reset, as the time the system has been off is unknown. If it was OFF in warm standby,
+ * the standby is resumed. The time from the resume to the first distance shown is recorded (`fsm_urbanite_get_resume_latency_ms()`).
+ * The HW of the backup memory must be initialized with `port_backup_init()`.
+ * 
+ * @param p_fsm     Pointer to the fsm_urbanite_t struct, just created.
+ * @return true     If a valid snapshot has been restored.
+ * @return false    If there is no valid snapshot (first power up, other firmware). The system starts OFF.
+ */
+bool fsm_urbanite_resume (fsm_urbanite_t *p_fsm);
+
+/**
+ * @brief Get the time from the resume from a snapshot to the first distance shown.
+ * 
+ * @param p_fsm     Pointer to the fsm_urbanite_t struct.
+ * @return uint32_t Time in ms. 0 if the system has not been resumed or no distance has been shown yet.
+ */
+uint32_t fsm_urbanite_get_resume_latency_ms (fsm_urbanite_t *p_fsm);
+
+/**
+ * @brief Get the state of the Urbanite FSM.
+ * 
+ * @param p_fsm     Pointer to the fsm_urbanite_t struct.
+ * @return uint32_t Current state of the Urbanite FSM (`enum FSM_URBANITE`).
+ */
+uint32_t fsm_urbanite_get_state (fsm_urbanite_t *p_fsm);
+
 /**
  * @brief Fire the Urbanite FSM.
  * This function is used to check the transitions and execute the actions of the Urbanite FSM.
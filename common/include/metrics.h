@@ -0,0 +1,217 @@
+/**
+ * @file metrics.h
+ * @brief Header for metrics.c file. Registry of named counters, gauges and histograms.
+ *
+ * All the metrics of the system are declared statically in the `METRICS_SCALARS`, `METRICS_HISTOGRAMS` and `METRICS_QUANTILES`
+ * lists below. A quantile metric estimates the median, p90 and p99 of its samples in fixed memory (`quantile.h`), so the
+ * distributions can be snapshotted without shipping the samples.
+ * The registry is only compiled when `USE_METRICS` is defined (CMake option `-DUSE_METRICS=true`). Otherwise, all the
+ * functions of this header are replaced by empty macros and the metrics have no cost in code size nor in execution time.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef METRICS_H_
+#define METRICS_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* Project includes */
+#include "quantile.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define METRICS_HISTOGRAM_NUM_BUCKETS 8     /*!<    Number of buckets of every histogram. Bucket i holds the values whose bit length (after shifting) is i. The last one holds the rest */
+#define METRICS_NUM_QUANTILES 3             /*!<    Number of quantiles estimated by every quantile metric: median, p90 and p99 (`METRICS_QUANTILES_PCT`) */
+#define METRICS_QUANTILES_PCT {50, 90, 99}  /*!<    Percentiles estimated by every quantile metric @hideinitializer */
+
+/**
+ * @brief List of the scalar metrics (counters and gauges) of the system.
+ * Each entry is `X(id, kind, name)`. Add a new line here to register a new counter or gauge.
+ */
+#define METRICS_SCALARS(X)                                                                  \
+    X(METRIC_ULTRASOUND_MEASUREMENTS,       METRIC_KIND_COUNTER,    "ultrasound.measurements")  \
+    X(METRIC_ULTRASOUND_NO_ECHO,            METRIC_KIND_COUNTER,    "ultrasound.no_echo")       \
+    X(METRIC_ULTRASOUND_OVERCAPTURES,       METRIC_KIND_COUNTER,    "ultrasound.overcaptures")  \
+    X(METRIC_ULTRASOUND_DISTANCE_CM,        METRIC_KIND_GAUGE,      "ultrasound.distance_cm")   \
+    X(METRIC_ULTRASOUND_QUEUE_OVERRUNS,     METRIC_KIND_COUNTER,    "ultrasound.queue_overruns") \
+    X(METRIC_URBANITE_GESTURES,             METRIC_KIND_COUNTER,    "urbanite.gestures")        \
+    X(METRIC_URBANITE_EMERGENCY_ENTRIES,    METRIC_KIND_COUNTER,    "urbanite.emergency")       \
+    X(METRIC_DISPLAY_UPDATES,               METRIC_KIND_COUNTER,    "display.updates")          \
+    X(METRIC_SYSTEM_SLEEP_ENTRIES,          METRIC_KIND_COUNTER,    "system.sleep_entries")     \
+    X(METRIC_SCHEDULER_DEADLINE_MISSES,     METRIC_KIND_COUNTER,    "scheduler.deadline_misses") \
+    X(METRIC_CAN_FRAMES_SENT,               METRIC_KIND_COUNTER,    "can.frames_sent")          \
+    X(METRIC_CAN_QUEUE_DROPS,               METRIC_KIND_COUNTER,    "can.queue_drops")          \
+    X(METRIC_TOF_MEASUREMENTS,              METRIC_KIND_COUNTER,    "tof.measurements")         \
+    X(METRIC_TOF_BUS_ERRORS,                METRIC_KIND_COUNTER,    "tof.bus_errors")
+
+/**
+ * @brief List of the histograms of the system.
+ * Each entry is `X(id, shift, name)`. The value is shifted `shift` bits to the right before computing its bucket,
+ * so the first bucket holds the values lower than 2^shift and the last one the values greater or equal than 2^(shift + 6).
+ */
+#define METRICS_HISTOGRAMS(X)                                                       \
+    X(METRIC_ULTRASOUND_ECHO_US,    7,  "ultrasound.echo_us")                       \
+    X(METRIC_BUTTON_PRESS_MS,       6,  "button.press_ms")                          \
+    X(METRIC_URBANITE_RESUME_MS,    4,  "urbanite.resume_ms")
+
+/**
+ * @brief List of the quantile metrics of the system.
+ * Each entry is `X(id, name)`. Add a new line here to estimate the quantiles of a new magnitude.
+ */
+#define METRICS_QUANTILES(X)                                                        \
+    X(METRIC_ULTRASOUND_DISTANCE_Q,     "ultrasound.distance_cm.q")                 \
+    X(METRIC_ULTRASOUND_ECHO_Q,         "ultrasound.echo_us.q")                     \
+    X(METRIC_SCHEDULER_EXEC_Q,          "scheduler.exec_ms.q")                      \
+    X(METRIC_BUTTON_PRESS_Q,            "button.press_ms.q")
+
+/* Enums */
+/**
+ * @brief Kind of a metric.
+ */
+typedef enum
+{
+    METRIC_KIND_COUNTER = 0,    /*!<    Monotonic counter of events*/
+    METRIC_KIND_GAUGE,          /*!<    Last value of a magnitude*/
+    METRIC_KIND_HISTOGRAM,      /*!<    Distribution of the values of a magnitude*/
+    METRIC_KIND_QUANTILES       /*!<    Estimated quantiles of the values of a magnitude*/
+} metrics_kind_t;
+
+#define METRICS_X_ID(id, ...) id,   /*!<    Helper to build the enumerator of the metrics from the lists @hideinitializer */
+
+/**
+ * @brief Identifiers of all the metrics. Scalars first, then histograms, then quantiles.
+ */
+typedef enum
+{
+    METRICS_SCALARS(METRICS_X_ID)
+    METRICS_HISTOGRAMS(METRICS_X_ID)
+    METRICS_QUANTILES(METRICS_X_ID)
+    METRICS_NUM_METRICS             /*!<    Number of metrics registered*/
+} metrics_id_t;
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Snapshot of a metric passed to the visitor of `metrics_for_each()`.
+ */
+typedef struct
+{
+    metrics_id_t id;            /*!<    Identifier of the metric*/
+    metrics_kind_t kind;        /*!<    Kind of the metric*/
+    const char *p_name;         /*!<    Name of the metric*/
+    uint32_t value;             /*!<    Value of the counter or gauge. Number of samples for histograms and quantiles*/
+    uint32_t sum;               /*!<    Sum of the samples of a histogram (saturated). 0 for the rest*/
+    uint8_t shift;              /*!<    Shift of the buckets of a histogram. 0 for the rest*/
+    const uint32_t *p_buckets;  /*!<    Buckets of a histogram. NULL for the rest*/
+    uint32_t quantiles[METRICS_NUM_QUANTILES];  /*!<    Estimates of the median, p90 and p99 of a quantile metric. 0 for the rest*/
+} metrics_entry_t;
+
+/**
+ * @brief Function called for every metric by `metrics_for_each()`.
+ *
+ * @param p_entry   Pointer to the snapshot of the metric. It is only valid during the call.
+ * @param p_ctx     User context given to `metrics_for_each()`.
+ */
+typedef void (*metrics_visitor_t)(const metrics_entry_t *p_entry, void *p_ctx);
+
+/* Function prototypes and explanation -------------------------------------------------*/
+#ifdef USE_METRICS
+
+/**
+ * @brief Reset all the metrics to 0.
+ */
+void metrics_reset(void);
+
+/**
+ * @brief Add a number of events to a counter.
+ *
+ * @note Each counter must be updated from a single context (main loop or one ISR) because the update is not atomic.
+ *
+ * @param id    Identifier of the counter.
+ * @param n     Number of events to add.
+ */
+void metrics_counter_add(metrics_id_t id, uint32_t n);
+
+/**
+ * @brief Set the value of a gauge.
+ *
+ * @param id        Identifier of the gauge.
+ * @param value     New value of the gauge.
+ */
+void metrics_gauge_set(metrics_id_t id, uint32_t value);
+
+/**
+ * @brief Add a sample to a histogram.
+ *
+ * @param id        Identifier of the histogram.
+ * @param value     Value of the sample.
+ */
+void metrics_histogram_record(metrics_id_t id, uint32_t value);
+
+/**
+ * @brief Add a sample to a quantile metric. O(1): one update of each estimator.
+ *
+ * @note Each quantile metric must be updated from a single context (main loop or one ISR) because the update is not atomic.
+ *
+ * @param id        Identifier of the quantile metric.
+ * @param value     Value of the sample.
+ */
+void metrics_quantile_record(metrics_id_t id, uint32_t value);
+
+/**
+ * @brief Get an estimated quantile of a quantile metric.
+ *
+ * @param id            Identifier of the quantile metric.
+ * @param idx           Index of the quantile in `METRICS_QUANTILES_PCT`.
+ * @return uint32_t     Estimate. 0 if there are no samples or the metric is not a quantile metric.
+ */
+uint32_t metrics_get_quantile(metrics_id_t id, uint32_t idx);
+
+/**
+ * @brief Get the value of a metric.
+ *
+ * @param id            Identifier of the metric.
+ * @return uint32_t     Value of the counter or gauge, or number of samples of the histogram or the quantile metric.
+ */
+uint32_t metrics_get_value(metrics_id_t id);
+
+/**
+ * @brief Call a function for every registered metric, in the order of `metrics_id_t`.
+ * This is the single entry point to export the metrics (console, telemetry, tests...).
+ *
+ * @param visitor   Function to call for every metric.
+ * @param p_ctx     User context passed to the visitor.
+ */
+void metrics_for_each(metrics_visitor_t visitor, void *p_ctx);
+
+/**
+ * @brief Print all the metrics through the standard output.
+ */
+void metrics_dump(void);
+
+#else /* USE_METRICS */
+
+#define metrics_reset() ((void)0)                                                       /*!<    Metrics compiled out @hideinitializer */
+#define metrics_counter_add(id, n) ((void)(id), (void)(n))                              /*!<    Metrics compiled out @hideinitializer */
+#define metrics_gauge_set(id, value) ((void)(id), (void)(value))                        /*!<    Metrics compiled out @hideinitializer */
+#define metrics_histogram_record(id, value) ((void)(id), (void)(value))                 /*!<    Metrics compiled out @hideinitializer */
+#define metrics_quantile_record(id, value) ((void)(id), (void)(value))                  /*!<    Metrics compiled out @hideinitializer */
+#define metrics_get_quantile(id, idx) ((void)(id), (void)(idx), 0U)                     /*!<    Metrics compiled out @hideinitializer */
+#define metrics_get_value(id) ((void)(id), 0U)                                          /*!<    Metrics compiled out @hideinitializer */
+#define metrics_for_each(visitor, p_ctx) ((void)(visitor), (void)(p_ctx))               /*!<    Metrics compiled out @hideinitializer */
+#define metrics_dump() ((void)0)                                                        /*!<    Metrics compiled out @hideinitializer */
+
+#endif /* USE_METRICS */
+
+/**
+ * @brief Add one event to a counter.
+ *
+ * @param id    Identifier of the counter.
+ */
+#define metrics_counter_inc(id) metrics_counter_add((id), 1U)
+
+#endif /* METRICS_H_ */
@@ -0,0 +1,156 @@
+/**
+ * @file pt.h
+ * @brief Stackless coroutines (protothreads) for linear sequences of waits.
+ *
+ * A protothread is a function whose body is written as a linear sequence of steps and waits between `PT_BEGIN()` and
+ * `PT_END()`. When a wait is not satisfied, the function returns; the next call resumes it straight at that wait, without
+ * going through the previous steps nor evaluating the conditions of other states. The only state of a protothread is its
+ * local continuation (`pt_t`): 2 bytes with the default implementation, so many instances can run concurrently.
+ *
+ * Two implementations of the local continuation are available:
+ * - Default (Duff's device): the body is a `switch` and the resume point is the line of the wait. Portable C.
+ *   The body of a protothread cannot contain other `switch` statements.
+ * - Computed goto (`PT_USE_COMPUTED_GOTO` defined, GCC/Clang only): the resume point is the address of a label, so the
+ *   resume is a single indirect jump. The continuation is a pointer (4 bytes on the target).
+ *
+ * Rules of both implementations:
+ * - The local variables of a protothread are not kept between calls. Keep the state in the structure of the instance.
+ * - There cannot be two waits on the same line.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef PT_H_
+#define PT_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define PT_WAITING 0    /*!<    The protothread is blocked in a wait */
+#define PT_YIELDED 1    /*!<    The protothread has yielded */
+#define PT_EXITED 2     /*!<    The protothread has exited with `PT_EXIT()` */
+#define PT_ENDED 3      /*!<    The protothread has reached `PT_END()` */
+
+/* Local continuations */
+#ifdef PT_USE_COMPUTED_GOTO
+typedef void *pt_lc_t;  /*!<    Local continuation: address of the label of the resume point. NULL at the beginning */
+
+#define PT_LC_CONCAT2(a, b) a##b                                    /*!<    Helper to build the labels @hideinitializer */
+#define PT_LC_CONCAT(a, b) PT_LC_CONCAT2(a, b)                      /*!<    Helper to build the labels @hideinitializer */
+#define PT_LC_INIT(lc) ((lc) = NULL)                                /*!<    Initialize a local continuation @hideinitializer */
+#define PT_LC_RESUME(lc) if ((lc) != NULL) { goto *(lc); }          /*!<    Jump to the resume point @hideinitializer */
+#define PT_LC_SET(lc) PT_LC_CONCAT(pt_lc_, __LINE__) : (lc) = &&PT_LC_CONCAT(pt_lc_, __LINE__)  /*!<    Set the resume point @hideinitializer */
+#define PT_LC_END(lc)                                               /*!<    End of the body @hideinitializer */
+#else
+typedef uint16_t pt_lc_t;   /*!<    Local continuation: line of the resume point. 0 at the beginning */
+
+#define PT_LC_INIT(lc) ((lc) = 0)                                   /*!<    Initialize a local continuation @hideinitializer */
+#define PT_LC_RESUME(lc) switch (lc) { case 0:                      /*!<    Jump to the resume point @hideinitializer */
+#define PT_LC_SET(lc) (lc) = __LINE__; case __LINE__:               /*!<    Set the resume point @hideinitializer */
+#define PT_LC_END(lc) }                                             /*!<    End of the body @hideinitializer */
+#endif
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Context of a protothread.
+ */
+typedef struct
+{
+    pt_lc_t lc;     /*!<    Local continuation: resume point of the protothread */
+} pt_t;
+
+/* Protothread macros ---------------------------------------------------------*/
+/**
+ * @brief Declare a protothread. The function returns `PT_WAITING`, `PT_YIELDED`, `PT_EXITED` or `PT_ENDED`.
+ * @hideinitializer
+ */
+#define PT_THREAD(name_args) char name_args
+
+/**
+ * @brief Initialize a protothread. The next call starts it from the beginning.
+ * @hideinitializer
+ */
+#define PT_INIT(pt) PT_LC_INIT((pt)->lc)
+
+/**
+ * @brief Start the body of a protothread. It jumps to the resume point of the last call.
+ * @hideinitializer
+ */
+#define PT_BEGIN(pt) { char pt_yield_flag = 1; (void)pt_yield_flag; PT_LC_RESUME((pt)->lc)
+
+/**
+ * @brief End the body of a protothread. The next call starts it from the beginning.
+ * @hideinitializer
+ */
+#define PT_END(pt) PT_LC_END((pt)->lc); pt_yield_flag = 0; PT_INIT(pt); return PT_ENDED; }
+
+/**
+ * @brief Block the protothread until a condition is true. The condition is the only code evaluated when it is resumed.
+ * @hideinitializer
+ */
+#define PT_WAIT_UNTIL(pt, condition)    \
+    do                                  \
+    {                                   \
+        PT_LC_SET((pt)->lc);            \
+        if (!(condition))               \
+        {                               \
+            return PT_WAITING;          \
+        }                               \
+    } while (0)
+
+/**
+ * @brief Block the protothread while a condition is true.
+ * @hideinitializer
+ */
+#define PT_WAIT_WHILE(pt, condition) PT_WAIT_UNTIL((pt), !(condition))
+
+/**
+ * @brief Return from the protothread once. The next call continues after this point.
+ * @hideinitializer
+ */
+#define PT_YIELD(pt)                    \
+    do                                  \
+    {                                   \
+        pt_yield_flag = 0;              \
+        PT_LC_SET((pt)->lc);            \
+        if (pt_yield_flag == 0)         \
+        {                               \
+            return PT_YIELDED;          \
+        }                               \
+    } while (0)
+
+/**
+ * @brief Exit the protothread. The next call starts it from the beginning.
+ * @hideinitializer
+ */
+#define PT_EXIT(pt)                     \
+    do                                  \
+    {                                   \
+        PT_INIT(pt);                    \
+        return PT_EXITED;               \
+    } while (0)
+
+/**
+ * @brief Restart the protothread from the beginning in the next call.
+ * @hideinitializer
+ */
+#define PT_RESTART(pt)                  \
+    do                                  \
+    {                                   \
+        PT_INIT(pt);                    \
+        return PT_WAITING;              \
+    } while (0)
+
+/**
+ * @brief Check if a protothread is still running (it has not exited nor ended) after calling it.
+ * @hideinitializer
+ */
+#define PT_SCHEDULE(f) ((f) < PT_EXITED)
+
+#endif /* PT_H_ */
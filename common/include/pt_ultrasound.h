@@ -0,0 +1,102 @@
+/**
+ * @file pt_ultrasound.h
+ * @brief Header for pt_ultrasound.c file. Ranging cycle of the ultrasound sensors as a protothread.
+ *
+ * It is an alternative to the ultrasound FSM (`fsm_ultrasound.h`) with the same behavior and the same port. The ranging
+ * cycle is written as the linear sequence that it is: trigger → wait start of the echo → wait end of the echo → compute
+ * the distance → wait for the next measurement period. Each call resumes the sequence straight at the pending wait,
+ * instead of checking the guards of the transitions of the current state.
+ *
+ * The instances are plain structures that can be allocated statically (e.g., an array with one per sensor). The context of
+ * the coroutine is 2 bytes, and the whole instance (window of distances included) is 32 bytes.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef PT_ULTRASOUND_H_
+#define PT_ULTRASOUND_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Other includes */
+#include "pt.h"
+#include "fsm_ultrasound.h"
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure of an ultrasound sensor ranged by a protothread.
+ */
+typedef struct
+{
+    pt_t pt;                        /*!<    Context of the protothread of the ranging cycle*/
+    uint8_t ultrasound_id;          /*!<    Ultrasound ID. Must be unique*/
+    uint8_t distance_idx;           /*!<    Index to store the next distance of the window*/
+    bool status;                    /*!<    Flag to indicate if the ultrasound sensor is active*/
+    bool new_measurement;           /*!<    Flag to indicate if a new measurement (median of the window) has been completed*/
+    uint32_t distance_cm;           /*!<    Last measurement: median of the window of distances*/
+    uint32_t distance_arr[FSM_ULTRASOUND_NUM_MEASUREMENTS];    /*!<    Window of the last distances*/
+} pt_ultrasound_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Initialize an ultrasound protothread and the HW of its sensor.
+ *
+ * @param p_pt_ultrasound   Pointer to the instance.
+ * @param ultrasound_id     Unique ultrasound identifier number.
+ */
+void pt_ultrasound_init(pt_ultrasound_t *p_pt_ultrasound, uint32_t ultrasound_id);
+
+/**
+ * @brief Resume the ranging cycle of an ultrasound sensor. Call it periodically, as `fsm_ultrasound_fire()`.
+ *
+ * @param p_pt_ultrasound   Pointer to the instance.
+ * @return char             `PT_WAITING` while the cycle is blocked in a wait. `PT_ENDED` when the cycle ends because the status was cleared.
+ */
+char pt_ultrasound_run(pt_ultrasound_t *p_pt_ultrasound);
+
+/**
+ * @brief Start the measurements of an ultrasound sensor. It powers the sensor up and starts the measurement timer.
+ *
+ * @param p_pt_ultrasound   Pointer to the instance.
+ */
+void pt_ultrasound_start(pt_ultrasound_t *p_pt_ultrasound);
+
+/**
+ * @brief Stop the measurements of an ultrasound sensor and restart its cycle, so the next start begins with a new trigger.
+ *
+ * @param p_pt_ultrasound   Pointer to the instance.
+ */
+void pt_ultrasound_stop(pt_ultrasound_t *p_pt_ultrasound);
+
+/**
+ * @brief Get the last measurement (median of the window) and clear the flag of new measurement.
+ *
+ * @param p_pt_ultrasound   Pointer to the instance.
+ * @return uint32_t         Distance in cm.
+ */
+uint32_t pt_ultrasound_get_distance(pt_ultrasound_t *p_pt_ultrasound);
+
+/**
+ * @brief Check if a new measurement is available.
+ *
+ * @param p_pt_ultrasound   Pointer to the instance.
+ * @return true             If a new measurement has been completed since the last call to `pt_ultrasound_get_distance()`.
+ * @return false            Otherwise.
+ */
+bool pt_ultrasound_get_new_measurement_ready(pt_ultrasound_t *p_pt_ultrasound);
+
+/**
+ * @brief Get the status of an ultrasound sensor.
+ *
+ * @param p_pt_ultrasound   Pointer to the instance.
+ * @return true             If the sensor is measuring.
+ * @return false            Otherwise.
+ */
+bool pt_ultrasound_get_status(pt_ultrasound_t *p_pt_ultrasound);
+
+#endif /* PT_ULTRASOUND_H_ */
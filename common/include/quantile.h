@@ -0,0 +1,84 @@
+/**
+ * @file quantile.h
+ * @brief Header for quantile.c file. Streaming estimator of a quantile in fixed memory (P² algorithm) and fixed point.
+ *
+ * The P² algorithm (Jain and Chlamtac, 1985) keeps 5 markers: the minimum, the maximum, the estimated quantile and two
+ * intermediate quantiles. Each sample moves the positions of the markers and, when a marker is at least one sample away from
+ * its desired position, its height is adjusted with a piecewise-parabolic interpolation of its neighbours. So an update is O(1)
+ * (a few comparisons and at most 3 adjustments) and the estimator takes 48 bytes, whatever the number of samples.
+ *
+ * Fixed point: the heights are in Q8 (`QUANTILE_Q_BITS`), so the samples saturate at 2^23 - 1; the probability and the desired
+ * positions are in Q16. No floating point nor division by zero is used. When the count reaches `QUANTILE_MAX_COUNT`, the
+ * positions are halved: the estimator keeps working, with the older samples weighting half.
+ *
+ * An estimator must be updated from a single context: the update is not atomic.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef QUANTILE_H_
+#define QUANTILE_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define QUANTILE_NUM_MARKERS 5                                  /*!<    Number of markers of the P² algorithm*/
+#define QUANTILE_Q_BITS 8                                       /*!<    Fractional bits of the heights of the markers*/
+#define QUANTILE_MAX_VALUE ((uint32_t)(INT32_MAX >> QUANTILE_Q_BITS))  /*!<    Maximum value of a sample. Greater samples saturate @hideinitializer */
+#define QUANTILE_PROB_ONE 65536U                                /*!<    Probability 1 in Q16*/
+#define QUANTILE_PROB(pct) ((uint32_t)(((pct) * QUANTILE_PROB_ONE + 50U) / 100U))   /*!<    Probability in Q16 of a percentile (integer %) @hideinitializer */
+#ifndef QUANTILE_MAX_COUNT
+#define QUANTILE_MAX_COUNT (1UL << 30)                          /*!<    Number of samples that halves the positions of the markers*/
+#endif
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Streaming estimator of a quantile.
+ */
+typedef struct
+{
+    uint32_t prob;                                  /*!<    Probability of the quantile in Q16*/
+    uint32_t count;                                 /*!<    Number of samples (halved with the positions)*/
+    int32_t heights[QUANTILE_NUM_MARKERS];          /*!<    Heights of the markers in Q8. The first samples, sorted, until there are 5*/
+    uint32_t positions[QUANTILE_NUM_MARKERS];       /*!<    Positions of the markers (0-based ranks)*/
+} quantile_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Initialize an estimator without samples.
+ *
+ * @param p_quantile    Pointer to the estimator.
+ * @param prob          Probability of the quantile in Q16, from 0 to `QUANTILE_PROB_ONE` (e.g., `QUANTILE_PROB(99)`).
+ */
+void quantile_init(quantile_t *p_quantile, uint32_t prob);
+
+/**
+ * @brief Add a sample to an estimator.
+ *
+ * @param p_quantile    Pointer to the estimator.
+ * @param value         Value of the sample. It saturates at `QUANTILE_MAX_VALUE`.
+ */
+void quantile_update(quantile_t *p_quantile, uint32_t value);
+
+/**
+ * @brief Get the estimate of the quantile. With less than 5 samples, it is the exact quantile of the samples.
+ *
+ * @param p_quantile    Pointer to the estimator.
+ * @return uint32_t     Estimate, rounded to the nearest integer. 0 if there are no samples.
+ */
+uint32_t quantile_get(const quantile_t *p_quantile);
+
+/**
+ * @brief Get the number of samples of an estimator.
+ *
+ * @param p_quantile    Pointer to the estimator.
+ * @return uint32_t     Number of samples (it is halved every `QUANTILE_MAX_COUNT` samples).
+ */
+uint32_t quantile_get_count(const quantile_t *p_quantile);
+
+#endif /* QUANTILE_H_ */
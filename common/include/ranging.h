@@ -0,0 +1,155 @@
+/**
+ * @file ranging.h
+ * @brief Header for ranging.c file. Generic interface of the distance sensors, independent of their technology.
+ *
+ * A ranging device is a sensor ID bound to a backend: a constant table of functions that drive one technology of sensor
+ * through its port (ultrasound echo timing, time of flight over I2C, ...). The users of the distances start a measurement,
+ * poll the device until it completes and read a result with a common unit (cm) and a confidence, so a sensor can be
+ * replaced by another technology without changing them. A measurement that does not complete in the timeout of its
+ * backend is aborted and completes with confidence 0.
+ *
+ * The backends are stateless: all the state of a measurement is in the port of the sensor and in the device, so the
+ * devices can be allocated statically (e.g., an array with one per sensor).
+ *
+ * A sensor is driven either by a ranging device or by its FSM, never by both: they would share the state of its port. The
+ * ultrasound FSM drives its ultrasound sensor itself and uses a ranging device for a sensor of another technology that
+ * measures the short range (`fsm_ultrasound_set_short_range()`).
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef RANGING_H_
+#define RANGING_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+#define RANGING_CONFIDENCE_MAX 100U     /*!<    Confidence of a result whose distance is fully reliable (percentage) */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Result of a measurement of a ranging device.
+ */
+typedef struct
+{
+    uint32_t distance_cm;       /*!<    Distance in cm. Only meaningful if the confidence is not 0 */
+    uint32_t confidence_pct;    /*!<    Reliability of the distance, from 0 (no target, timeout or failure) to `RANGING_CONFIDENCE_MAX` */
+    uint32_t timestamp_ms;      /*!<    System time in ms when the measurement completed */
+} ranging_result_t;
+
+/**
+ * @brief Backend of a technology of distance sensors. The functions receive the sensor ID of the port of the technology.
+ * NULL entries are skipped (all of them but `p_start` and `p_poll`).
+ */
+typedef struct
+{
+    void (*p_init)(uint32_t sensor_id);                             /*!<    Configure the HW of the sensor */
+    void (*p_enable)(uint32_t sensor_id);                           /*!<    Power the sensor up and prepare its measurements */
+    void (*p_disable)(uint32_t sensor_id);                          /*!<    Abort the measurement in progress, if any, and power the sensor down */
+    bool (*p_start)(uint32_t sensor_id);                            /*!<    Start a measurement. False if the sensor cannot start it now */
+    bool (*p_poll)(uint32_t sensor_id, ranging_result_t *p_result); /*!<    Check the measurement in progress. True when it has completed: distance and confidence are filled */
+    uint32_t timeout_ms;                                            /*!<    Maximum duration of a measurement in ms */
+} ranging_backend_t;
+
+/**
+ * @brief Structure of a ranging device: a sensor bound to its backend, and its last result.
+ */
+typedef struct
+{
+    const ranging_backend_t *p_backend; /*!<    Backend of the technology of the sensor */
+    uint8_t sensor_id;                  /*!<    ID of the sensor in the port of its technology */
+    bool enabled;                       /*!<    Flag to indicate that the sensor is enabled */
+    bool busy;                          /*!<    Flag to indicate that a measurement is in progress */
+    bool has_result;                    /*!<    Flag to indicate that `result` holds a completed measurement */
+    uint32_t start_ms;                  /*!<    System time in ms when the measurement in progress started */
+    ranging_result_t result;            /*!<    Last completed measurement */
+} ranging_device_t;
+
+/* Backends -------------------------------------------------------------------*/
+extern const ranging_backend_t ranging_ultrasound_backend; /*!<    Ultrasound sensors (`port_ultrasound.h`) */
+extern const ranging_backend_t ranging_tof_backend;        /*!<    Time-of-flight sensors (`port_tof.h`) */
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Bind a sensor to its backend and initialize its HW. The device is left disabled.
+ *
+ * @param p_device      Pointer to the device.
+ * @param p_backend     Backend of the technology of the sensor.
+ * @param sensor_id     ID of the sensor in the port of its technology.
+ */
+void ranging_init(ranging_device_t *p_device, const ranging_backend_t *p_backend, uint32_t sensor_id);
+
+/**
+ * @brief Power the sensor of a device up. The last result is discarded.
+ *
+ * @param p_device  Pointer to the device.
+ */
+void ranging_enable(ranging_device_t *p_device);
+
+/**
+ * @brief Abort the measurement in progress of a device, if any, and power its sensor down.
+ *
+ * @param p_device  Pointer to the device.
+ */
+void ranging_disable(ranging_device_t *p_device);
+
+/**
+ * @brief Start a measurement of a device. It does not wait for the measurement: call `ranging_poll()` until it completes.
+ *
+ * @param p_device  Pointer to the device.
+ * @return true     If the measurement has been started.
+ * @return false    If the device is disabled, is busy with another measurement, or its sensor is not ready yet.
+ */
+bool ranging_start(ranging_device_t *p_device);
+
+/**
+ * @brief Check the measurement in progress of a device. If it has not completed in the timeout of the backend, it is
+ * aborted and completes with confidence 0.
+ *
+ * @param p_device  Pointer to the device.
+ * @return true     If the measurement has completed in this call: the result is updated and timestamped.
+ * @return false    Otherwise (in progress, or no measurement started).
+ */
+bool ranging_poll(ranging_device_t *p_device);
+
+/**
+ * @brief Check if a device has a measurement in progress.
+ *
+ * @param p_device  Pointer to the device.
+ * @return true     If a measurement has been started and has not completed yet.
+ * @return false    Otherwise.
+ */
+bool ranging_get_busy(const ranging_device_t *p_device);
+
+/**
+ * @brief Get the last result of a device.
+ *
+ * @param p_device  Pointer to the device.
+ * @param p_result  Pointer to store the result.
+ * @return true     If the device has completed a measurement since it was enabled.
+ * @return false    Otherwise. The result is not written.
+ */
+bool ranging_get_result(const ranging_device_t *p_device, ranging_result_t *p_result);
+
+/**
+ * @brief Get the distance of the last result of a device.
+ *
+ * @param p_device  Pointer to the device.
+ * @return uint32_t Distance in cm. 0 if there is no result.
+ */
+uint32_t ranging_get_distance_cm(const ranging_device_t *p_device);
+
+/**
+ * @brief Get the confidence of the last result of a device.
+ *
+ * @param p_device  Pointer to the device.
+ * @return uint32_t Confidence (percentage). 0 if there is no result.
+ */
+uint32_t ranging_get_confidence_pct(const ranging_device_t *p_device);
+
+#endif /* RANGING_H_ */
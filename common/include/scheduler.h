@@ -0,0 +1,109 @@
+/**
+ * @file scheduler.h
+ * @brief Header for scheduler.c file. Cooperative earliest-deadline-first (EDF) scheduler of the FSMs and the background jobs.
+ *
+ * Each task declares a relative deadline and a period:
+ * - Period 0 (FSMs): the task is released once per round of the scheduler, with an absolute deadline of the start of the
+ *   round plus its relative deadline. A round ends when every released task has been executed, so each FSM is fired once
+ *   per round, as in the former loop of `main()`, and the FSMs keep running while the system tick is suspended.
+ * - Period > 0 (background jobs): the task is released every `period_ms` milliseconds, with an absolute deadline of the
+ *   release time plus its relative deadline.
+ *
+ * Among the released tasks, the one with the earliest absolute deadline runs first (in case of a tie, the one added first).
+ * Tasks run to completion. If a task completes after its absolute deadline, a deadline miss is recorded in its statistics
+ * and in the metric `scheduler.deadline_misses`. A background job with a loose deadline is therefore executed after the
+ * FSMs with tighter deadlines of the same round, right after the display has been updated.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef SCHEDULER_H_
+#define SCHEDULER_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define SCHEDULER_MAX_TASKS 8           /*!<    Maximum number of tasks of the scheduler*/
+#define SCHEDULER_INVALID_TASK_ID (-1)  /*!<    Identifier returned when a task cannot be added*/
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Function executed by a task. It must run to completion without blocking.
+ *
+ * @param p_ctx     User context given to `scheduler_add_task()`. For example, a pointer to an FSM.
+ */
+typedef void (*scheduler_job_t)(void *p_ctx);
+
+/**
+ * @brief Statistics of the executions of a task.
+ */
+typedef struct
+{
+    uint32_t runs;              /*!<    Number of executions*/
+    uint32_t misses;            /*!<    Number of executions completed after their absolute deadline*/
+    uint32_t max_lateness_ms;   /*!<    Maximum time in ms between the absolute deadline and the completion of a late execution*/
+    uint32_t max_exec_ms;       /*!<    Maximum execution time in ms*/
+} scheduler_stats_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Remove all the tasks of the scheduler and clear their statistics.
+ */
+void scheduler_init(void);
+
+/**
+ * @brief Add a task to the scheduler. A periodic task is released for the first time when it is added.
+ *
+ * @param p_name        Name of the task, for the reports. It must be a string stored for the lifetime of the task.
+ * @param job           Function executed by the task.
+ * @param p_ctx         User context passed to `job`.
+ * @param period_ms     Period of the task in ms. 0 to release it once per round of the scheduler (FSMs).
+ * @param deadline_ms   Relative deadline of the task in ms. If it is 0, the deadline is the period.
+ * @return int32_t      Identifier of the task, or `SCHEDULER_INVALID_TASK_ID` if the scheduler is full, `job` is NULL,
+ *                      or both `period_ms` and `deadline_ms` are 0.
+ */
+int32_t scheduler_add_task(const char *p_name, scheduler_job_t job, void *p_ctx, uint32_t period_ms, uint32_t deadline_ms);
+
+/**
+ * @brief Execute the released task with the earliest absolute deadline.
+ * If there is no released task and the scheduler has tasks with period 0, a new round is started.
+ *
+ * @return true     If a task has been executed.
+ * @return false    If no task was released (all the tasks are periodic and are waiting for their next release).
+ */
+bool scheduler_run_next(void);
+
+/**
+ * @brief Execute the released tasks until none is left. It runs a whole round of the scheduler.
+ *
+ * @return uint32_t Number of executed tasks.
+ */
+uint32_t scheduler_run_round(void);
+
+/**
+ * @brief Get the statistics of a task.
+ *
+ * @param task_id   Identifier of the task.
+ * @param p_stats   Pointer to the structure that receives the statistics. It is not modified if `task_id` is not valid.
+ */
+void scheduler_get_stats(int32_t task_id, scheduler_stats_t *p_stats);
+
+/**
+ * @brief Get the number of deadline misses of all the tasks.
+ *
+ * @return uint32_t Total number of deadline misses.
+ */
+uint32_t scheduler_get_total_misses(void);
+
+/**
+ * @brief Print the statistics of every task through the standard output.
+ */
+void scheduler_dump(void);
+
+#endif /* SCHEDULER_H_ */
@@ -0,0 +1,201 @@
+/**
+ * @file spsc_ring.h
+ * @brief Lock-free single-producer/single-consumer ring buffer, header-only, for the target and the host.
+ *
+ * `SPSC_RING_DEFINE(name, type, capacity)` defines the type `name_t` and its `static inline` functions `name_xxx()` for
+ * elements of `type`. The producer (e.g., an ISR) only calls the push functions and the consumer (e.g., the main loop) only
+ * calls the pop functions, so no critical section is needed:
+ * - The indexes are free-running 32-bit counters. Each one is written by a single side: `tail` by the producer and `head` by
+ *   the consumer. The number of elements is `tail - head`, also when the counters wrap around.
+ * - The capacity is a power of 2, so the slot of an index is `index & (capacity - 1)`: a single AND.
+ * - The producer writes the element before it publishes the new `tail` (release) and the consumer reads `tail` before it
+ *   reads the element (acquire). The same for `head` in the other direction, so a slot is not overwritten while it is read.
+ * - A push into a full ring drops the new element and counts an overrun. The elements already queued are never lost.
+ *
+ * Barriers: on a single-core Cortex-M the memory accesses of the core are observed in program order by its own ISRs, so only
+ * the compiler must not reorder them (no `DMB` is emitted). On the host, or when the peer is another bus master (define
+ * `SPSC_RING_SMP`), the barriers are full acquire/release fences.
+ *
+ * Example: `SPSC_RING_DEFINE(echo_ring, uint32_t, 16)` and then `static echo_ring_t ring;`, `echo_ring_push(&ring, ticks);`
+ * from the ISR and `while (echo_ring_pop(&ring, &ticks)) { ... }` from the main loop.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef SPSC_RING_H_
+#define SPSC_RING_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Barriers */
+#if (defined(__ARM_ARCH_6M__) || defined(__ARM_ARCH_7M__) || defined(__ARM_ARCH_7EM__)) && !defined(SPSC_RING_SMP)
+#define SPSC_RING_ACQUIRE() __atomic_signal_fence(__ATOMIC_ACQUIRE)    /*!<    Later accesses are not moved before the read of the index (compiler only) @hideinitializer */
+#define SPSC_RING_RELEASE() __atomic_signal_fence(__ATOMIC_RELEASE)    /*!<    Earlier accesses are not moved after the write of the index (compiler only) @hideinitializer */
+#else
+#define SPSC_RING_ACQUIRE() __atomic_thread_fence(__ATOMIC_ACQUIRE)    /*!<    Later accesses are not moved before the read of the index @hideinitializer */
+#define SPSC_RING_RELEASE() __atomic_thread_fence(__ATOMIC_RELEASE)    /*!<    Earlier accesses are not moved after the write of the index @hideinitializer */
+#endif
+
+#define SPSC_RING_LOAD(p_index) __atomic_load_n((p_index), __ATOMIC_RELAXED)             /*!<    Single-copy atomic read of an index (LDR) @hideinitializer */
+#define SPSC_RING_STORE(p_index, value) __atomic_store_n((p_index), (value), __ATOMIC_RELAXED)   /*!<    Single-copy atomic write of an index (STR) @hideinitializer */
+
+/**
+ * @brief Define a ring buffer type `name_t` of `capacity` elements of `type`, and its functions.
+ *
+ * Producer side: `name_push()`, `name_push_batch()`.
+ * Consumer side: `name_pop()`, `name_pop_batch()`, `name_front()` + `name_drop()` (read in place, without a copy).
+ * Any side: `name_count()`, `name_get_overruns()`, `name_get_max_level()`. `name_init()` when neither side is running.
+ *
+ * @param name      Prefix of the type and the functions.
+ * @param type      Type of the elements.
+ * @param capacity  Maximum number of elements. It must be a power of 2.
+ * @hideinitializer
+ */
+#define SPSC_RING_DEFINE(name, type, capacity)                                                                          \
+    _Static_assert(((capacity) > 0) && (((capacity) & ((capacity) - 1U)) == 0), #name ": the capacity must be a power of 2"); \
+                                                                                                                        \
+    typedef struct                                                                                                      \
+    {                                                                                                                   \
+        uint32_t head;              /*!<    Free-running index of the next element to pop. Written by the consumer */   \
+        uint32_t tail;              /*!<    Free-running index of the next free slot. Written by the producer */        \
+        uint32_t overruns;          /*!<    Elements dropped because the ring was full. Written by the producer */     \
+        uint32_t max_level;         /*!<    Maximum number of elements queued. Written by the producer */              \
+        type buf[(capacity)];       /*!<    Slots of the elements */                                                    \
+    } name##_t;                                                                                                         \
+                                                                                                                        \
+    /* Empty the ring and clear its counters */                                                                         \
+    static inline void name##_init(name##_t *p_ring)                                                                    \
+    {                                                                                                                   \
+        p_ring->head = 0;                                                                                               \
+        p_ring->tail = 0;                                                                                               \
+        p_ring->overruns = 0;                                                                                           \
+        p_ring->max_level = 0;                                                                                          \
+    }                                                                                                                   \
+                                                                                                                        \
+    /* Number of elements queued. Exact for the consumer, a lower bound of the free slots for the producer */          \
+    static inline uint32_t name##_count(const name##_t *p_ring)                                                         \
+    {                                                                                                                   \
+        return SPSC_RING_LOAD(&p_ring->tail) - SPSC_RING_LOAD(&p_ring->head);                                           \
+    }                                                                                                                   \
+                                                                                                                        \
+    /* Update the maximum level after a push (producer) */                                                             \
+    static inline void name##_track_level(name##_t *p_ring, uint32_t level)                                             \
+    {                                                                                                                   \
+        if (level > p_ring->max_level)                                                                                  \
+        {                                                                                                               \
+            p_ring->max_level = level;                                                                                  \
+        }                                                                                                               \
+    }                                                                                                                   \
+                                                                                                                        \
+    /* Push an element (producer). False if the ring is full: the element is dropped and counted as an overrun */      \
+    static inline bool name##_push(name##_t *p_ring, const type *p_item)                                                \
+    {                                                                                                                   \
+        uint32_t tail = p_ring->tail;                                                                                   \
+        uint32_t level = tail - SPSC_RING_LOAD(&p_ring->head);                                                          \
+        if (level >= (capacity))                                                                                        \
+        {                                                                                                               \
+            p_ring->overruns++;                                                                                         \
+            return false;                                                                                               \
+        }                                                                                                               \
+        SPSC_RING_ACQUIRE(); /* The slot is not written before the consumer has released it */                         \
+        p_ring->buf[tail & ((capacity) - 1U)] = *p_item;                                                                \
+        SPSC_RING_RELEASE(); /* The element is written before it is published */                                       \
+        SPSC_RING_STORE(&p_ring->tail, tail + 1U);                                                                      \
+        name##_track_level(p_ring, level + 1U);                                                                         \
+        return true;                                                                                                    \
+    }                                                                                                                   \
+                                                                                                                        \
+    /* Push up to num elements (producer). The ones that do not fit are dropped and counted. Returns the ones pushed */ \
+    static inline uint32_t name##_push_batch(name##_t *p_ring, const type *p_items, uint32_t num)                       \
+    {                                                                                                                   \
+        uint32_t tail = p_ring->tail;                                                                                   \
+        uint32_t level = tail - SPSC_RING_LOAD(&p_ring->head);                                                          \
+        uint32_t n = ((capacity) - level < num) ? ((capacity) - level) : num;                                           \
+        p_ring->overruns += num - n;                                                                                    \
+        if (n == 0)                                                                                                     \
+        {                                                                                                               \
+            return 0;                                                                                                   \
+        }                                                                                                               \
+        SPSC_RING_ACQUIRE();                                                                                            \
+        uint32_t slot = tail & ((capacity) - 1U);                                                                       \
+        uint32_t first = ((capacity) - slot < n) ? ((capacity) - slot) : n; /* Up to the end of the buffer */           \
+        memcpy(&p_ring->buf[slot], p_items, first * sizeof(type));                                                      \
+        memcpy(&p_ring->buf[0], p_items + first, (n - first) * sizeof(type));                                           \
+        SPSC_RING_RELEASE();                                                                                            \
+        SPSC_RING_STORE(&p_ring->tail, tail + n);                                                                       \
+        name##_track_level(p_ring, level + n);                                                                          \
+        return n;                                                                                                       \
+    }                                                                                                                   \
+                                                                                                                        \
+    /* Pointer to the oldest element, read in place (consumer). NULL if the ring is empty. Valid until name_drop() */   \
+    static inline const type *name##_front(const name##_t *p_ring)                                                      \
+    {                                                                                                                   \
+        uint32_t head = p_ring->head;                                                                                   \
+        if (SPSC_RING_LOAD(&p_ring->tail) == head)                                                                      \
+        {                                                                                                               \
+            return NULL;                                                                                                \
+        }                                                                                                               \
+        SPSC_RING_ACQUIRE(); /* The element is not read before it has been published */                                \
+        return &p_ring->buf[head & ((capacity) - 1U)];                                                                  \
+    }                                                                                                                   \
+                                                                                                                        \
+    /* Release the oldest element after name_front() (consumer) */                                                     \
+    static inline void name##_drop(name##_t *p_ring)                                                                    \
+    {                                                                                                                   \
+        SPSC_RING_RELEASE(); /* The element has been read before its slot is released */                               \
+        SPSC_RING_STORE(&p_ring->head, p_ring->head + 1U);                                                              \
+    }                                                                                                                   \
+                                                                                                                        \
+    /* Pop the oldest element (consumer). False if the ring is empty */                                                \
+    static inline bool name##_pop(name##_t *p_ring, type *p_item)                                                       \
+    {                                                                                                                   \
+        const type *p_front = name##_front(p_ring);                                                                     \
+        if (p_front == NULL)                                                                                            \
+        {                                                                                                               \
+            return false;                                                                                               \
+        }                                                                                                               \
+        *p_item = *p_front;                                                                                             \
+        name##_drop(p_ring);                                                                                            \
+        return true;                                                                                                    \
+    }                                                                                                                   \
+                                                                                                                        \
+    /* Pop up to max elements, oldest first (consumer). Returns the ones popped */                                     \
+    static inline uint32_t name##_pop_batch(name##_t *p_ring, type *p_items, uint32_t max)                              \
+    {                                                                                                                   \
+        uint32_t head = p_ring->head;                                                                                   \
+        uint32_t level = SPSC_RING_LOAD(&p_ring->tail) - head;                                                          \
+        uint32_t n = (level < max) ? level : max;                                                                       \
+        if (n == 0)                                                                                                     \
+        {                                                                                                               \
+            return 0;                                                                                                   \
+        }                                                                                                               \
+        SPSC_RING_ACQUIRE();                                                                                            \
+        uint32_t slot = head & ((capacity) - 1U);                                                                       \
+        uint32_t first = ((capacity) - slot < n) ? ((capacity) - slot) : n;                                             \
+        memcpy(p_items, &p_ring->buf[slot], first * sizeof(type));                                                      \
+        memcpy(p_items + first, &p_ring->buf[0], (n - first) * sizeof(type));                                           \
+        SPSC_RING_RELEASE();                                                                                            \
+        SPSC_RING_STORE(&p_ring->head, head + n);                                                                       \
+        return n;                                                                                                       \
+    }                                                                                                                   \
+                                                                                                                        \
+    /* Number of elements dropped because the ring was full */                                                         \
+    static inline uint32_t name##_get_overruns(const name##_t *p_ring)                                                  \
+    {                                                                                                                   \
+        return SPSC_RING_LOAD(&p_ring->overruns);                                                                       \
+    }                                                                                                                   \
+                                                                                                                        \
+    /* Maximum number of elements queued since the initialization */                                                  \
+    static inline uint32_t name##_get_max_level(const name##_t *p_ring)                                                 \
+    {                                                                                                                   \
+        return SPSC_RING_LOAD(&p_ring->max_level);                                                                      \
+    }
+
+#endif /* SPSC_RING_H_ */
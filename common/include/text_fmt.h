@@ -0,0 +1,108 @@
+/**
+ * @file text_fmt.h
+ * @brief Header for text_fmt.c file. Allocation-free and reentrant text formatter for the diagnostics.
+ *
+ * It supports the conversions used by the messages of the FSMs: `%d`, `%u`, `%x`, `%ld`, `%lu`, `%lx`, `%s`, `%c` and `%%`,
+ * without flags, width nor precision. An unsupported conversion is copied as it is. Unlike newlib `printf()`, it does not
+ * use `malloc()`, the `_reent` structure nor floating point, so it can be called from the ISRs and is a few hundred bytes of flash.
+ *
+ * The execution time is bounded: each character of the format or of the output is visited once and a number has at most 20 digits.
+ * The output is always terminated and never longer than the buffer.
+ *
+ * The ring (`text_fmt_ring_t`) holds whole lines for the console: any context (main loop or ISRs of any priority) formats a line
+ * into its own slot, and the main loop pops them in order and sends them. A full ring drops the new line and counts an overrun.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef TEXT_FMT_H_
+#define TEXT_FMT_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define TEXT_FMT_RING_LEN 8         /*!<    Number of lines of the ring. It must be a power of 2*/
+#define TEXT_FMT_LINE_LEN 96        /*!<    Maximum length of a line of the ring, including the terminator*/
+
+#define TEXT_FMT_CHECK(fmt_idx, arg_idx) __attribute__((format(printf, fmt_idx, arg_idx)))    /*!<    The compiler checks the arguments against the format, as for `printf()` @hideinitializer */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Ring of formatted lines. Multiple producers (any context) and a single consumer (the main loop).
+ */
+typedef struct
+{
+    volatile uint32_t head;                                 /*!<    Free-running index of the next line to pop. Written by the consumer*/
+    volatile uint32_t tail;                                 /*!<    Free-running index of the next slot to reserve. Written by the producers*/
+    volatile uint32_t overruns;                             /*!<    Lines dropped because the ring was full*/
+    volatile bool ready[TEXT_FMT_RING_LEN];                 /*!<    The line of each slot is complete*/
+    char lines[TEXT_FMT_RING_LEN][TEXT_FMT_LINE_LEN];       /*!<    Lines*/
+} text_fmt_ring_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Format a text into a buffer.
+ *
+ * @param p_buf         Pointer to the buffer.
+ * @param size          Size of the buffer, including the terminator.
+ * @param p_format      Format, with the conversions listed in this header.
+ * @param ...           Arguments of the conversions.
+ * @return uint32_t     Number of characters written, without the terminator. The text is truncated if it does not fit.
+ */
+uint32_t text_fmt(char *p_buf, uint32_t size, const char *p_format, ...) TEXT_FMT_CHECK(3, 4);
+
+/**
+ * @brief Format a text into a buffer, with the arguments in a `va_list`.
+ *
+ * @param p_buf         Pointer to the buffer.
+ * @param size          Size of the buffer, including the terminator.
+ * @param p_format      Format, with the conversions listed in this header.
+ * @param args          Arguments of the conversions.
+ * @return uint32_t     Number of characters written, without the terminator. The text is truncated if it does not fit.
+ */
+uint32_t text_fmt_va(char *p_buf, uint32_t size, const char *p_format, va_list args);
+
+/**
+ * @brief Empty a ring and clear its overrun counter. Only when no context is using it.
+ *
+ * @param p_ring        Pointer to the ring.
+ */
+void text_fmt_ring_init(text_fmt_ring_t *p_ring);
+
+/**
+ * @brief Format a line into a ring. It can be called from any context, also from ISRs that preempt another call.
+ *
+ * @param p_ring        Pointer to the ring.
+ * @param p_format      Format, with the conversions listed in this header.
+ * @param ...           Arguments of the conversions.
+ * @retval true if the line is queued (truncated to `TEXT_FMT_LINE_LEN - 1` characters), false if the ring is full.
+ */
+bool text_fmt_ring_printf(text_fmt_ring_t *p_ring, const char *p_format, ...) TEXT_FMT_CHECK(2, 3);
+
+/**
+ * @brief Pop the oldest line of a ring. Only from the consumer (the main loop).
+ * A line whose producer has been preempted is not popped until it is complete, so the lines are always popped in order.
+ *
+ * @param p_ring        Pointer to the ring.
+ * @param p_line        Pointer to the buffer where the line is copied.
+ * @param size          Size of the buffer, including the terminator.
+ * @retval true if a line has been popped, false if there is no complete line.
+ */
+bool text_fmt_ring_pop(text_fmt_ring_t *p_ring, char *p_line, uint32_t size);
+
+/**
+ * @brief Get the number of lines dropped because the ring was full.
+ *
+ * @param p_ring        Pointer to the ring.
+ * @return uint32_t     Number of lines dropped since the initialization.
+ */
+uint32_t text_fmt_ring_get_overruns(text_fmt_ring_t *p_ring);
+
+#endif /* TEXT_FMT_H_ */
@@ -0,0 +1,322 @@
+/**
+ * @file can_publisher.c
+ * @brief Periodic publication of the distances and the state of the Urbanite on the CAN bus.
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <string.h>
+
+/* HW dependent includes */
+#include "port_can.h"
+#include "port_system.h"
+
+/* Project includes */
+#include "can_publisher.h"
+#include "metrics.h"
+#include "spsc_ring.h"
+
+/* Defines --------------------------------------------------------------------*/
+#define CAN_PUBLISHER_WORDS_PER_FRAME 4U                            /*!<    Number of 2-byte fields per frame @hideinitializer */
+#define CAN_PUBLISHER_BYTES_PER_FRAME 8U                            /*!<    Number of 1-byte fields per frame @hideinitializer */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Last measurement of a sensor.
+ */
+typedef struct
+{
+    uint16_t distance_cm;       /*!<    Distance in cm. `CAN_PUBLISHER_NO_VALUE` if there is no measurement*/
+    uint16_t ttc;               /*!<    Time to collision in units of `CAN_PUBLISHER_TTC_UNIT_MS`. `CAN_PUBLISHER_NO_VALUE` if not approaching*/
+    uint8_t confidence_pct;     /*!<    Confidence in %*/
+    uint32_t timestamp_ms;      /*!<    Time of the measurement*/
+} can_publisher_sensor_t;
+
+SPSC_RING_DEFINE(can_queue, port_can_frame_t, CAN_PUBLISHER_QUEUE_LEN)
+
+/* Global variables */
+static can_queue_t queue;                                           /*!<    Software queue of frames*/
+static can_publisher_sensor_t sensors_arr[CAN_PUBLISHER_MAX_SENSORS];   /*!<    Last measurement of each sensor*/
+static uint32_t num_sensors;                                        /*!<    Number of sensors published*/
+static uint32_t state;                                              /*!<    State of the system*/
+static uint32_t periods_arr[CAN_PUBLISHER_NUM_MSGS];                /*!<    Period of each message in ms. 0 if disabled*/
+static uint32_t next_arr[CAN_PUBLISHER_NUM_MSGS];                   /*!<    Time of the next publication of each message*/
+static can_publisher_stats_t stats;                                 /*!<    Statistics of the publisher*/
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Check if a time is before another one. It is valid when the system tick wraps around.
+ *
+ * @param a         First time in ms.
+ * @param b         Second time in ms.
+ * @return true     If `a` is before `b`.
+ * @return false    Otherwise.
+ */
+static bool _time_before(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) < 0;
+}
+
+/**
+ * @brief Write a 2-byte field into a frame (little endian).
+ *
+ * @param p_data    Pointer to the first byte of the field.
+ * @param value     Value of the field.
+ */
+static void _put_u16(uint8_t *p_data, uint16_t value)
+{
+    p_data[0] = (uint8_t)value;
+    p_data[1] = (uint8_t)(value >> 8);
+}
+
+/**
+ * @brief Saturate a value to a 2-byte field, keeping `CAN_PUBLISHER_NO_VALUE` for the missing data.
+ *
+ * @param value     Value.
+ * @return uint16_t Saturated value.
+ */
+static uint16_t _sat_u16(uint32_t value)
+{
+    return (value >= CAN_PUBLISHER_NO_VALUE) ? (CAN_PUBLISHER_NO_VALUE - 1U) : (uint16_t)value;
+}
+
+/**
+ * @brief Move the queued frames to the free mailboxes of the controller.
+ *
+ * @return uint32_t Number of frames moved.
+ */
+static uint32_t _pump(void)
+{
+    uint32_t sent = 0;
+    const port_can_frame_t *p_frame;
+    while (((p_frame = can_queue_front(&queue)) != NULL) && port_can_transmit(p_frame))
+    {
+        can_queue_drop(&queue);
+        sent++;
+    }
+    stats.sent += sent;
+    metrics_counter_add(METRIC_CAN_FRAMES_SENT, sent);
+    return sent;
+}
+
+/**
+ * @brief Write a frame into the queue.
+ *
+ * @param p_frame   Pointer to the frame.
+ * @return true     If the frame has been queued.
+ * @return false    If the queue is full.
+ */
+static bool _enqueue(const port_can_frame_t *p_frame)
+{
+    if (!can_queue_push(&queue, p_frame))
+    {
+        stats.dropped = can_queue_get_overruns(&queue);
+        metrics_counter_inc(METRIC_CAN_QUEUE_DROPS);
+        return false;
+    }
+
+    stats.queued++;
+    stats.max_depth = can_queue_get_max_level(&queue);
+    return true;
+}
+
+/**
+ * @brief Visitor of the metrics that queues one frame of the quantiles message per quantile metric.
+ *
+ * @param p_entry   Pointer to the snapshot of the metric.
+ * @param p_ctx     Pointer to the index of the next quantile metric.
+ */
+static void _queue_quantiles(const metrics_entry_t *p_entry, void *p_ctx)
+{
+    if (p_entry->kind != METRIC_KIND_QUANTILES)
+    {
+        return;
+    }
+    uint32_t *p_idx = (uint32_t *)p_ctx;
+
+    port_can_frame_t frame;
+    memset(&frame, 0, sizeof(frame));
+    frame.id = CAN_PUBLISHER_ID_QUANTILES + *p_idx;
+    frame.dlc = 8;
+    for (uint32_t i = 0; (i < METRICS_NUM_QUANTILES) && (i < 3U); i++)
+    {
+        _put_u16(&frame.data[2 * i], _sat_u16(p_entry->quantiles[i]));
+    }
+    _put_u16(&frame.data[6], _sat_u16(p_entry->value));
+    _enqueue(&frame);
+    (*p_idx)++;
+}
+
+/**
+ * @brief Queue the frames of a message: one frame for the state, as many pages as needed for the sensors.
+ *
+ * @param msg   Message.
+ * @param now   Current time in ms.
+ */
+static void _queue_msg(can_publisher_msg_t msg, uint32_t now)
+{
+    port_can_frame_t frame;
+
+    if (msg == CAN_PUBLISHER_MSG_STATE)
+    {
+        memset(&frame, 0, sizeof(frame));
+        frame.id = CAN_PUBLISHER_ID_STATE;
+        frame.dlc = 8;
+        frame.data[0] = (uint8_t)state;
+        frame.data[1] = (uint8_t)num_sensors;
+        _put_u16(&frame.data[2], _sat_u16(stats.dropped));
+        _put_u16(&frame.data[4], (uint16_t)now);
+        _put_u16(&frame.data[6], (uint16_t)(now >> 16));
+        _enqueue(&frame);
+        return;
+    }
+
+    if (msg == CAN_PUBLISHER_MSG_QUANTILES)
+    {
+        uint32_t idx = 0;
+        metrics_for_each(_queue_quantiles, &idx);
+        return;
+    }
+
+    uint32_t per_frame = (msg == CAN_PUBLISHER_MSG_CONFIDENCE) ? CAN_PUBLISHER_BYTES_PER_FRAME : CAN_PUBLISHER_WORDS_PER_FRAME;
+    uint32_t base_id = (msg == CAN_PUBLISHER_MSG_DISTANCE) ? CAN_PUBLISHER_ID_DISTANCE : ((msg == CAN_PUBLISHER_MSG_CONFIDENCE) ? CAN_PUBLISHER_ID_CONFIDENCE : CAN_PUBLISHER_ID_TTC);
+
+    for (uint32_t first = 0; first < num_sensors; first += per_frame)
+    {
+        uint32_t count = ((num_sensors - first) < per_frame) ? (num_sensors - first) : per_frame;
+
+        memset(&frame, 0, sizeof(frame));
+        frame.id = base_id + (first / per_frame);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const can_publisher_sensor_t *p_sensor = &sensors_arr[first + i];
+            if (msg == CAN_PUBLISHER_MSG_DISTANCE)
+            {
+                _put_u16(&frame.data[2 * i], p_sensor->distance_cm);
+            }
+            else if (msg == CAN_PUBLISHER_MSG_TTC)
+            {
+                _put_u16(&frame.data[2 * i], p_sensor->ttc);
+            }
+            else
+            {
+                frame.data[i] = p_sensor->confidence_pct;
+            }
+        }
+        frame.dlc = (uint8_t)((msg == CAN_PUBLISHER_MSG_CONFIDENCE) ? count : (2 * count));
+        _enqueue(&frame);
+    }
+}
+
+/* Public functions -----------------------------------------------------------*/
+bool can_publisher_init(uint32_t sensors, bool loopback)
+{
+    uint32_t now = port_system_get_millis();
+
+    can_queue_init(&queue);
+    memset(&stats, 0, sizeof(stats));
+    state = 0;
+
+    num_sensors = (sensors > CAN_PUBLISHER_MAX_SENSORS) ? CAN_PUBLISHER_MAX_SENSORS : sensors;
+    for (uint32_t i = 0; i < CAN_PUBLISHER_MAX_SENSORS; i++)
+    {
+        sensors_arr[i].distance_cm = CAN_PUBLISHER_NO_VALUE;
+        sensors_arr[i].ttc = CAN_PUBLISHER_NO_VALUE;
+        sensors_arr[i].confidence_pct = 0;
+        sensors_arr[i].timestamp_ms = 0;
+    }
+
+    periods_arr[CAN_PUBLISHER_MSG_STATE] = CAN_PUBLISHER_STATE_PERIOD_MS;
+    periods_arr[CAN_PUBLISHER_MSG_DISTANCE] = CAN_PUBLISHER_DISTANCE_PERIOD_MS;
+    periods_arr[CAN_PUBLISHER_MSG_CONFIDENCE] = CAN_PUBLISHER_CONFIDENCE_PERIOD_MS;
+    periods_arr[CAN_PUBLISHER_MSG_TTC] = CAN_PUBLISHER_TTC_PERIOD_MS;
+    periods_arr[CAN_PUBLISHER_MSG_QUANTILES] = 0;
+    for (uint32_t msg = 0; msg < CAN_PUBLISHER_NUM_MSGS; msg++)
+    {
+        next_arr[msg] = now;
+    }
+
+    return port_can_init(loopback);
+}
+
+void can_publisher_set_period(can_publisher_msg_t msg, uint32_t period_ms)
+{
+    if (msg >= CAN_PUBLISHER_NUM_MSGS)
+    {
+        return;
+    }
+    periods_arr[msg] = period_ms;
+    next_arr[msg] = port_system_get_millis();
+}
+
+void can_publisher_set_sensor(uint32_t sensor_idx, uint32_t distance_cm, uint32_t confidence_pct, uint32_t timestamp_ms)
+{
+    if (sensor_idx >= num_sensors)
+    {
+        return;
+    }
+    can_publisher_sensor_t *p_sensor = &sensors_arr[sensor_idx];
+
+    // Time to collision at the approach speed since the previous measurement
+    if ((p_sensor->distance_cm != CAN_PUBLISHER_NO_VALUE) && (timestamp_ms != p_sensor->timestamp_ms))
+    {
+        uint32_t prev_cm = p_sensor->distance_cm;
+        if (distance_cm < prev_cm)
+        {
+            uint32_t dt_ms = timestamp_ms - p_sensor->timestamp_ms;
+            uint32_t ttc_ms = (uint32_t)(((uint64_t)distance_cm * dt_ms) / (prev_cm - distance_cm));
+            p_sensor->ttc = _sat_u16(ttc_ms / CAN_PUBLISHER_TTC_UNIT_MS);
+        }
+        else
+        {
+            p_sensor->ttc = CAN_PUBLISHER_NO_VALUE;
+        }
+    }
+
+    p_sensor->distance_cm = _sat_u16(distance_cm);
+    p_sensor->confidence_pct = (uint8_t)((confidence_pct > 100) ? 100 : confidence_pct);
+    p_sensor->timestamp_ms = timestamp_ms;
+}
+
+void can_publisher_set_state(uint32_t new_state)
+{
+    state = new_state;
+}
+
+bool can_publisher_publish(const port_can_frame_t *p_frame)
+{
+    bool queued = _enqueue(p_frame);
+    _pump();
+    return queued;
+}
+
+uint32_t can_publisher_run(void)
+{
+    uint32_t now = port_system_get_millis();
+
+    for (uint32_t msg = 0; msg < CAN_PUBLISHER_NUM_MSGS; msg++)
+    {
+        if ((periods_arr[msg] == 0) || _time_before(now, next_arr[msg]))
+        {
+            continue;
+        }
+        _queue_msg((can_publisher_msg_t)msg, now);
+
+        // Keep the rate without bursts to catch up after a long stop
+        next_arr[msg] += periods_arr[msg];
+        if (_time_before(next_arr[msg], now))
+        {
+            next_arr[msg] = now + periods_arr[msg];
+        }
+    }
+
+    return _pump();
+}
+
+void can_publisher_get_stats(can_publisher_stats_t *p_stats)
+{
+    *p_stats = stats;
+}
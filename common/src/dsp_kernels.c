@@ -0,0 +1,211 @@
+/**
+ * @file dsp_kernels.c
+ * @brief Arithmetic kernels of the per-measurement path: color blending, conversion of echo ticks into cm and filtering of the distance window.
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* Project includes */
+#include "dsp_kernels.h"
+#include "port_system.h"
+
+#if defined(__ARM_FEATURE_DSP) && __ARM_FEATURE_DSP
+#include <arm_acle.h>
+#define DSP_USE_SIMD    /*!<    The target has the packed SIMD instructions of the DSP extension   */
+#endif
+
+/* Defines and enums ----------------------------------------------------------*/
+#define DSP_MEDIAN_SIMD_VALUES 5    /*!<    Size of the window handled by the packed median network   */
+#define DSP_U16_MAX 0xFFFFU         /*!<    Maximum value of a halfword lane   */
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Divide by 255 with shifts. Exact for 0 <= x <= 255 * 255, i.e. for any blend of two levels.
+ *
+ * @param x         Dividend.
+ * @return uint32_t x / 255, truncated.
+ */
+static inline uint32_t _div255(uint32_t x)
+{
+    return (x + 1U + (x >> 8)) >> 8;
+}
+
+#ifdef DSP_USE_SIMD
+/**
+ * @brief Compare and exchange the two halfword lanes of two words at once.
+ * After the call, each lane of `*p_lo` holds the minimum of the lanes and each lane of `*p_hi` the maximum.
+ *
+ * @param p_lo  Pointer to the first word. It receives the minimums.
+ * @param p_hi  Pointer to the second word. It receives the maximums.
+ */
+static inline void _cmpx_u16x2(uint32_t *p_lo, uint32_t *p_hi)
+{
+    uint32_t lo = *p_lo;
+    uint32_t hi = *p_hi;
+    (void)__usub16(lo, hi);     // GE flags of each lane: lo >= hi
+    *p_lo = __sel(hi, lo);
+    *p_hi = __sel(lo, hi);
+}
+
+/**
+ * @brief Median of 5 values with the network of 7 compare-exchanges, the first 4 of them in packed pairs.
+ * The values are saturated to 16 bits. As the saturation keeps the order, the result is exact unless it is saturated.
+ *
+ * @param p_values  Pointer to the 5 values.
+ * @return uint32_t Median of the saturated values.
+ */
+PORT_RAMFUNC static uint32_t _median5_u16x2(const uint32_t *p_values)
+{
+    uint32_t v[DSP_MEDIAN_SIMD_VALUES];
+    for (uint32_t i = 0; i < DSP_MEDIAN_SIMD_VALUES; i++)
+    {
+        v[i] = (p_values[i] > DSP_U16_MAX) ? DSP_U16_MAX : p_values[i];
+    }
+
+    uint32_t a = v[0] | (v[3] << 16);   // [v0, v3]
+    uint32_t b = v[1] | (v[4] << 16);   // [v1, v4]
+    _cmpx_u16x2(&a, &b);                // sort (v0, v1) and (v3, v4)
+
+    uint32_t c = (a & DSP_U16_MAX) | (b << 16);     // [v0, v1]
+    uint32_t d = (a >> 16) | (b & ~DSP_U16_MAX);    // [v3, v4]
+    _cmpx_u16x2(&c, &d);                            // sort (v0, v3) and (v1, v4)
+
+    uint32_t v1 = c >> 16;
+    uint32_t v2 = v[2];
+    uint32_t v3 = d & DSP_U16_MAX;
+    uint32_t lo = (v1 < v2) ? v1 : v2;
+    uint32_t hi = (v1 < v2) ? v2 : v1;
+    hi = (hi < v3) ? hi : v3;
+    return (lo > hi) ? lo : hi;
+}
+#endif
+
+/* Public functions -----------------------------------------------------------*/
+/* The kernels of the distance (echo ticks, conversion to cm and median of the window) run once per echo, called from the
+   per-measurement path of the ultrasound FSM: they are placed in SRAM with it, so that path does not reach flash. */
+uint32_t dsp_blend_rgb_c(uint32_t rgb_1, uint32_t rgb_2, uint8_t t)
+{
+    uint32_t w_1 = 255U - t;
+    uint32_t r = (w_1 * DSP_RGB_GET_R(rgb_1) + t * DSP_RGB_GET_R(rgb_2)) / 255U;
+    uint32_t g = (w_1 * DSP_RGB_GET_G(rgb_1) + t * DSP_RGB_GET_G(rgb_2)) / 255U;
+    uint32_t b = (w_1 * DSP_RGB_GET_B(rgb_1) + t * DSP_RGB_GET_B(rgb_2)) / 255U;
+    return DSP_RGB_PACK(r, g, b);
+}
+
+uint32_t dsp_blend_rgb(uint32_t rgb_1, uint32_t rgb_2, uint8_t t)
+{
+#ifdef DSP_USE_SIMD
+    // Zero-extend the bytes 0 and 2 of each color into halfwords: [R, B] and [G, 0]
+    uint32_t rb_1 = __uxtb16(rgb_1);
+    uint32_t rb_2 = __uxtb16(rgb_2);
+    uint32_t g_1 = __uxtb16(rgb_1 >> 8);
+    uint32_t g_2 = __uxtb16(rgb_2 >> 8);
+
+    // Pair each level of both colors and weight them with a single dual multiply-accumulate
+    uint32_t weights = (255U - t) | ((uint32_t)t << 16);
+    uint32_t r = (uint32_t)__smlad((int16x2_t)((rb_1 & DSP_U16_MAX) | (rb_2 << 16)), (int16x2_t)weights, 0);
+    uint32_t g = (uint32_t)__smlad((int16x2_t)((g_1 & DSP_U16_MAX) | (g_2 << 16)), (int16x2_t)weights, 0);
+    uint32_t b = (uint32_t)__smlad((int16x2_t)((rb_1 >> 16) | (rb_2 & ~DSP_U16_MAX)), (int16x2_t)weights, 0);
+#else
+    uint32_t w_1 = 255U - t;
+    uint32_t r = w_1 * DSP_RGB_GET_R(rgb_1) + t * DSP_RGB_GET_R(rgb_2);
+    uint32_t g = w_1 * DSP_RGB_GET_G(rgb_1) + t * DSP_RGB_GET_G(rgb_2);
+    uint32_t b = w_1 * DSP_RGB_GET_B(rgb_1) + t * DSP_RGB_GET_B(rgb_2);
+#endif
+    return DSP_RGB_PACK(_div255(r), _div255(g), _div255(b));
+}
+
+PORT_RAMFUNC uint32_t dsp_echo_ticks(uint32_t init_tick, uint32_t end_tick, uint32_t overflows)
+{
+    if (end_tick >= init_tick)
+    {
+        return end_tick - init_tick + (overflows * DSP_ECHO_TIMER_PERIOD_TICKS);
+    }
+    if (overflows > 0)
+    {
+        overflows--;
+    }
+    return (DSP_ECHO_TIMER_PERIOD_TICKS - init_tick) + end_tick + (overflows * DSP_ECHO_TIMER_PERIOD_TICKS);
+}
+
+PORT_RAMFUNC uint32_t dsp_ticks_to_cm_c(uint32_t ticks)
+{
+    return (uint32_t)(((uint64_t)ticks * DSP_TICKS_TO_CM_NUM) / DSP_TICKS_TO_CM_DEN);
+}
+
+PORT_RAMFUNC uint32_t dsp_ticks_to_cm(uint32_t ticks)
+{
+    if (ticks >= (1UL << DSP_TICKS_TO_CM_SHIFT))
+    {
+        return dsp_ticks_to_cm_c(ticks);
+    }
+    // A single 32x32->64 multiplication (UMULL) instead of the call to the 64-bit division of the library
+    return (uint32_t)(((uint64_t)ticks * DSP_TICKS_TO_CM_MAGIC) >> DSP_TICKS_TO_CM_SHIFT);
+}
+
+PORT_RAMFUNC uint32_t dsp_median_u32_c(const uint32_t *p_values, uint32_t n)
+{
+    if ((n == 0) || (n > DSP_MEDIAN_MAX_VALUES))
+    {
+        return 0;
+    }
+
+    uint32_t sorted[DSP_MEDIAN_MAX_VALUES];
+    for (uint32_t i = 0; i < n; i++)
+    {
+        uint32_t value = p_values[i];
+        uint32_t j = i;
+        while ((j > 0) && (sorted[j - 1] > value))
+        {
+            sorted[j] = sorted[j - 1];
+            j--;
+        }
+        sorted[j] = value;
+    }
+
+    if (n % 2 == 0)
+    {
+        return (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+    }
+    return sorted[n / 2];
+}
+
+PORT_RAMFUNC uint32_t dsp_median_u32(const uint32_t *p_values, uint32_t n)
+{
+#ifdef DSP_USE_SIMD
+    if (n == DSP_MEDIAN_SIMD_VALUES)
+    {
+        uint32_t median = _median5_u16x2(p_values);
+        if (median < DSP_U16_MAX)
+        {
+            return median;
+        }
+    }
+#endif
+    return dsp_median_u32_c(p_values, n);
+}
+
+uint32_t dsp_mean_u32_c(const uint32_t *p_values, uint32_t n)
+{
+    if (n == 0)
+    {
+        return 0;
+    }
+
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < n; i++)
+    {
+        sum += p_values[i];
+    }
+    return (uint32_t)(sum / n);
+}
+
+uint32_t dsp_mean_u32(const uint32_t *p_values, uint32_t n)
+{
+    return dsp_mean_u32_c(p_values, n);
+}
@@ -18,6 +18,7 @@
 
 /* Project includes */
 #include "fsm_button.h"
+#include "metrics.h"
 
 
 /* Typedefs --------------------------------------------------------------------*/
@@ -111,6 +112,9 @@ static void do_set_duration	(fsm_t * p_this)
     p_fsm->duration = time - p_fsm->tick_pressed;
     p_fsm->next_timeout = time + p_fsm->debounce_time;
 
+    metrics_histogram_record(METRIC_BUTTON_PRESS_MS, p_fsm->duration);
+    metrics_quantile_record(METRIC_BUTTON_PRESS_Q, p_fsm->duration);
+
     printf("[DEBUG][%ld] Duración: %ld\n", time ,p_fsm -> duration);
 }	
 
@@ -18,6 +18,8 @@
 /* Project includes */
 #include "fsm.h"
 #include "fsm_display.h"
+#include "metrics.h"
+#include "dsp_kernels.h"
 
 /* Typedefs --------------------------------------------------------------------*/
 /**
@@ -40,6 +42,7 @@ struct fsm_display_t
  * 
  * This function computes a linear interpolation between two RGB color values based on 
  * the interpolation factor t. The result is stored in the p_color output parameter.
+ * The three levels are blended at once by `dsp_blend_rgb()` on the packed colors.
  * - t = 0   → 100% colour_1
  * - t = 255 → 100% colour_2
  * 
@@ -49,9 +52,10 @@ struct fsm_display_t
  * @param t         Interpolation factor between 0.0 and 1.0. Values outside this range are extrapolated.
  */
 void _interpolate_color(rgb_color_t *p_color, rgb_color_t colour_1, rgb_color_t colour_2, uint8_t t) {
-    p_color -> r = (((uint16_t)(255 - t)) * colour_1.r + ((uint16_t)t) * colour_2.r) / 255;
-    p_color -> g = (((uint16_t)(255 - t)) * colour_1.g + ((uint16_t)t) * colour_2.g) / 255;
-    p_color -> b = (((uint16_t)(255 - t)) * colour_1.b + ((uint16_t)t) * colour_2.b) / 255;
+    uint32_t rgb = dsp_blend_rgb(DSP_RGB_PACK(colour_1.r, colour_1.g, colour_1.b), DSP_RGB_PACK(colour_2.r, colour_2.g, colour_2.b), t);
+    p_color -> r = DSP_RGB_GET_R(rgb);
+    p_color -> g = DSP_RGB_GET_G(rgb);
+    p_color -> b = DSP_RGB_GET_B(rgb);
 }
 
 /**
@@ -151,6 +155,7 @@ static void do_set_on (fsm_t * p_this)
 {
     fsm_display_t *p_fsm = (fsm_display_t *)(p_this);
     port_display_set_rgb(p_fsm -> display_id, COLOR_OFF);
+    metrics_counter_inc(METRIC_DISPLAY_UPDATES);
 }
 
 /**
@@ -165,6 +170,7 @@ static void do_set_color (fsm_t * p_this)
 
     _compute_display_levels (&color, p_fsm -> distance_cm);
     port_display_set_rgb(p_fsm -> display_id, color);
+    metrics_counter_inc(METRIC_DISPLAY_UPDATES);
 
     p_fsm -> new_color = false;
     p_fsm -> idle = true;
@@ -180,6 +186,7 @@ static void do_set_off (fsm_t * p_this)
     fsm_display_t *p_fsm = (fsm_display_t *)(p_this);
 
     port_display_set_rgb(p_fsm -> display_id, COLOR_OFF);
+    metrics_counter_inc(METRIC_DISPLAY_UPDATES);
 
     p_fsm -> idle = false;
 }
@@ -287,3 +294,15 @@ bool fsm_display_check_activity	(fsm_display_t * p_fsm)
 {
     return (p_fsm -> status) && !(p_fsm -> idle);
 }
+
+void fsm_display_save (fsm_display_t * p_fsm, fsm_display_snapshot_t *p_snapshot)
+{
+    p_snapshot -> distance_cm = p_fsm -> distance_cm;
+    p_snapshot -> status = p_fsm -> status;
+}
+
+void fsm_display_restore (fsm_display_t * p_fsm, const fsm_display_snapshot_t *p_snapshot)
+{
+    p_fsm -> distance_cm = p_snapshot -> distance_cm;
+    p_fsm -> status = p_snapshot -> status;
+}
@@ -18,8 +18,13 @@
 /* Project includes */
 #include "fsm.h"
 #include "fsm_ultrasound.h"
+#include "metrics.h"
+#include "dsp_kernels.h"
+#include "spsc_ring.h"
 
 /* Typedefs --------------------------------------------------------------------*/
+SPSC_RING_DEFINE(fsm_ultrasound_queue, fsm_ultrasound_measurement_t, FSM_ULTRASOUND_QUEUE_LEN)
+
 /**
  * @brief Structure of the Ultrasaund FSM.
  * 
@@ -29,23 +34,25 @@ struct fsm_ultrasound_t
     fsm_t f;                    /*!<Ultrasound FSM*/
     uint32_t distance_cm;       /*!<How much time the ultrasound has been pressed*/
     bool status;                /*!<Indicate if the ultrasound sensor is active or not*/
-    bool new_measurement;       /*!<Flag to indicate if a new measurement has been completed*/
+    fsm_ultrasound_queue_t queue;   /*!<Queue of the distances published and not read yet, oldest first*/
     uint32_t ultrasound_id;     /*!<Ultrasound ID. Must be unique*/
     uint32_t distance_arr [FSM_ULTRASOUND_NUM_MEASUREMENTS];    /*!<Array to store the last distance measurements*/
     uint32_t distance_idx;      /*!<Index to store the last distance measurement*/
+    bool standby;               /*!<Flag to indicate that the sensor is measuring at the low rate of the warm standby*/
+    bool window_full;           /*!<Flag to indicate that the array holds a whole window of measurements since the start*/
+    uint32_t publish_after;     /*!<Number of new measurements after which the median of the window is published, without waiting for a new window. 0: only complete windows are published*/
+    bool published;             /*!<Flag to indicate that a distance has been published since the creation of the FSM*/
+    uint32_t published_ms;      /*!<Time of the last distance published*/
+    uint32_t published_confidence_pct;  /*!<Confidence of the last distance published*/
+    ranging_device_t *p_short_range;    /*!<Device of another technology that measures the short range. NULL if there is none*/
+    bool short_range_enabled;   /*!<Flag to indicate that the short-range device is enabled*/
 };
 
 /* Private functions -----------------------------------------------------------*/
-// Comparison function for qsort
-int _compare(const void *a, const void *b)
-{
-    return (*(uint32_t *)a - *(uint32_t *)b);
-}
-
-
 /* State machine input or transition functions */
 /**
  * @brief Check if the ultrasound sensor is active and ready to start a new measurement.
+ * The first trigger after a power up is delayed until the sensor has settled.
  * 
  * @param p_this    Pointer to an fsm_t struct that contains an fsm_ultrasound_t.
  * @return true 
@@ -53,7 +60,7 @@ int _compare(const void *a, const void *b)
  */
 static bool check_on(fsm_t *p_this) {
     fsm_ultrasound_t *p_fsm = (fsm_ultrasound_t *)(p_this);
-    return (port_ultrasound_get_trigger_ready(p_fsm -> ultrasound_id)&&(p_fsm -> status));
+    return (port_ultrasound_get_trigger_ready(p_fsm -> ultrasound_id)&&(p_fsm -> status)&&(port_ultrasound_get_settle_remaining_ms(p_fsm -> ultrasound_id) == 0));
 }
 
 /**
@@ -103,7 +110,8 @@ static bool check_echo_init(fsm_t *p_this) {
  */
 static bool check_echo_received(fsm_t *p_this) {
     fsm_ultrasound_t *p_fsm = (fsm_ultrasound_t *)(p_this);
-    return port_ultrasound_get_echo_received(p_fsm -> ultrasound_id);
+    // The ISRs set the flags of all the sensors in one word: a single read, then the bit of this sensor
+    return (port_ultrasound_get_echo_received_mask() >> p_fsm -> ultrasound_id) & 1U;
 }
 
 /**
@@ -119,6 +127,126 @@ static bool check_new_measurement(fsm_t *p_this) {
 }
 
 
+/* Auxiliary functions */
+/**
+ * @brief Compute the confidence of the last distance published: the share of the window that agrees with it.
+ *
+ * @param p_fsm Pointer to an fsm_ultrasound_t struct.
+ * @return uint32_t Confidence (percentage).
+ */
+static uint32_t _compute_confidence_pct(const fsm_ultrasound_t *p_fsm)
+{
+    uint32_t agree = 0;
+    for (uint32_t i = 0; i < FSM_ULTRASOUND_NUM_MEASUREMENTS; i++)
+    {
+        uint32_t d = p_fsm->distance_arr[i];
+        uint32_t diff = (d > p_fsm->distance_cm) ? (d - p_fsm->distance_cm) : (p_fsm->distance_cm - d);
+        if (diff <= FSM_ULTRASOUND_CONFIDENCE_TOL_CM)
+        {
+            agree++;
+        }
+    }
+    return (agree * 100) / FSM_ULTRASOUND_NUM_MEASUREMENTS;
+}
+
+/**
+ * @brief Publish a distance: it becomes the last distance of the FSM and it is queued with its confidence and timestamp.
+ * If the queue is full, the distance is dropped and counted as an overrun, but in the warm standby, where the oldest distance
+ * is replaced instead.
+ *
+ * @param p_fsm             Pointer to an fsm_ultrasound_t struct.
+ * @param distance_cm       Distance in cm.
+ * @param confidence_pct    Confidence of the distance (percentage).
+ * @param timestamp_ms      Time of the distance in ms of the system.
+ */
+PORT_RAMFUNC static void _publish(fsm_ultrasound_t *p_fsm, uint32_t distance_cm, uint32_t confidence_pct, uint32_t timestamp_ms)
+{
+    p_fsm -> distance_cm = distance_cm;
+    p_fsm -> published = true;
+    p_fsm -> published_ms = timestamp_ms;
+    p_fsm -> published_confidence_pct = confidence_pct;
+
+    fsm_ultrasound_measurement_t measurement = {
+        .distance_cm = distance_cm,
+        .confidence_pct = confidence_pct,
+        .timestamp_ms = timestamp_ms,
+    };
+    if (p_fsm -> standby && (fsm_ultrasound_queue_count(&p_fsm -> queue) == FSM_ULTRASOUND_QUEUE_LEN))
+    {
+        // Nobody reads the queue in the warm standby and its distances are flushed when it ends: keep the newest ones
+        // without counting overruns. The queue is written and read from the same context (the FSMs are fired by the main loop)
+        fsm_ultrasound_queue_drop(&p_fsm -> queue);
+    }
+    if (!fsm_ultrasound_queue_push(&p_fsm -> queue, &measurement))
+    {
+        metrics_counter_inc(METRIC_ULTRASOUND_QUEUE_OVERRUNS);
+    }
+}
+
+/**
+ * @brief Disable the short-range device, if it is enabled.
+ *
+ * @param p_fsm Pointer to an fsm_ultrasound_t struct.
+ */
+static void _short_range_disable(fsm_ultrasound_t *p_fsm)
+{
+    if (p_fsm->short_range_enabled)
+    {
+        ranging_disable(p_fsm->p_short_range);
+        p_fsm->short_range_enabled = false;
+    }
+}
+
+/**
+ * @brief Serve the short-range device: enable it while the last distance is within the short range, publish its results
+ * with confidence within the short range and start its next measurement.
+ *
+ * @param p_fsm Pointer to an fsm_ultrasound_t struct.
+ */
+static void _short_range_fire(fsm_ultrasound_t *p_fsm)
+{
+    ranging_device_t *p_device = p_fsm->p_short_range;
+    if (p_device == NULL)
+    {
+        return;
+    }
+
+    if (!p_fsm->status || p_fsm->standby || !p_fsm->published || (p_fsm->distance_cm > FSM_ULTRASOUND_SHORT_RANGE_CM))
+    {
+        _short_range_disable(p_fsm);
+        return;
+    }
+    if (!p_fsm->short_range_enabled)
+    {
+        ranging_enable(p_device);
+        p_fsm->short_range_enabled = true;
+    }
+
+    ranging_result_t result;
+    if (ranging_poll(p_device) && ranging_get_result(p_device, &result) &&
+        (result.confidence_pct > 0) && (result.distance_cm <= FSM_ULTRASOUND_SHORT_RANGE_CM))
+    {
+        _publish(p_fsm, result.distance_cm, result.confidence_pct, result.timestamp_ms);
+    }
+    if (!ranging_get_busy(p_device))
+    {
+        ranging_start(p_device);
+    }
+}
+
+/**
+ * @brief Discard the measurements of the queue that have not been read.
+ *
+ * @param p_fsm Pointer to an fsm_ultrasound_t struct.
+ */
+static void _flush_measurements(fsm_ultrasound_t *p_fsm)
+{
+    while (fsm_ultrasound_queue_front(&p_fsm->queue) != NULL)
+    {
+        fsm_ultrasound_queue_drop(&p_fsm->queue);
+    }
+}
+
 /* State machine output or action functions */
 /**
  * @brief Start a measurement of the ultrasound transceiver for the first time after the FSM is started.
@@ -173,62 +301,39 @@ static void do_start_new_measurement(fsm_t *p_this)
 /**
  * @brief Set the distance measured by the ultrasound sensor.
  * This function is called when the ultrasound sensor has received the echo signal.
- * It calculates the distance in cm and stores it in the array of distances.
- * When the array is full, it computes the median of the array and resets the index of the array.
+ * It stores the distance of the echo in the array of distances (`fsm_ultrasound_store_echo()`).
+ * When the array is full, it computes the median of the array (`fsm_ultrasound_publish_median()`) and publishes it with its
+ * confidence (`_publish()`).
  * 
+ * It is executed from SRAM (`PORT_RAMFUNC`), since it runs once per echo.
+ *
  * @param p_this Pointer to an fsm_t struct than contains an fsm_ultrasound_t.
  */
-static void do_set_distance(fsm_t * p_this)
+PORT_RAMFUNC static void do_set_distance(fsm_t * p_this)
 {
     fsm_ultrasound_t *p_fsm = (fsm_ultrasound_t *)(p_this);
 
-    uint32_t end_tick = port_ultrasound_get_echo_end_tick(p_fsm -> ultrasound_id);
-    uint32_t init_tick = port_ultrasound_get_echo_init_tick(p_fsm -> ultrasound_id);
-    uint32_t overflows = port_ultrasound_get_echo_overflows(p_fsm -> ultrasound_id);
-
-    uint32_t ticks_elapsed;
-    if (end_tick >= init_tick)
-    {
-        ticks_elapsed = end_tick - init_tick;
-    }
-    else
-    {
-        ticks_elapsed = (65536 - init_tick) + end_tick; 
-        if(overflows > 0)
-        {
-        overflows = overflows - 1;
-        }
+    p_fsm -> distance_idx = fsm_ultrasound_store_echo(p_fsm -> ultrasound_id, p_fsm -> distance_arr, p_fsm -> distance_idx);
+    if (p_fsm -> distance_idx == 0) {
+        p_fsm -> window_full = true;
     }
 
-    ticks_elapsed = ticks_elapsed + (overflows * 65536);                        // 1 tick = 1us
-    uint32_t distance = (uint32_t)(((uint64_t)ticks_elapsed * 10) / 583);       // Taking into account the speed of sound (1cm = 58.3us)
-    
-    p_fsm -> distance_arr[p_fsm -> distance_idx] = distance;
-
-    p_fsm -> distance_idx++;
-    if (p_fsm -> distance_idx >= FSM_ULTRASOUND_NUM_MEASUREMENTS) {
-        p_fsm -> distance_idx = 0;
-
-        qsort(p_fsm -> distance_arr, FSM_ULTRASOUND_NUM_MEASUREMENTS, sizeof(uint32_t), _compare);
-
-        if (FSM_ULTRASOUND_NUM_MEASUREMENTS % 2 == 0)
-        {
-            uint32_t mid = FSM_ULTRASOUND_NUM_MEASUREMENTS / 2;
-            p_fsm -> distance_cm = (p_fsm -> distance_arr[mid - 1] + p_fsm -> distance_arr[mid]) / 2;
-        } 
-        else
-        {
-            p_fsm -> distance_cm = p_fsm -> distance_arr[FSM_ULTRASOUND_NUM_MEASUREMENTS / 2];
-        }
-
-        p_fsm -> new_measurement = true;
+    // A complete window or, for a window that already holds valid distances (warm standby, restored snapshot), the required
+    // number of new measurements
+    bool publish;
+    if (p_fsm -> publish_after > 0) {
+        p_fsm -> publish_after--;
+        publish = (p_fsm -> publish_after == 0) && p_fsm -> window_full;
+    } else {
+        publish = (p_fsm -> distance_idx == 0);
     }
 
-    port_ultrasound_stop_echo_timer(p_fsm -> ultrasound_id);
-    port_ultrasound_reset_echo_ticks(p_fsm -> ultrasound_id);
+    if (publish) {
+        p_fsm -> distance_cm = fsm_ultrasound_publish_median(p_fsm -> distance_arr);  // The confidence is computed against the new median
+        _publish(p_fsm, p_fsm -> distance_cm, _compute_confidence_pct(p_fsm), port_system_get_millis());
+    }
 }
 
-
 /**
  * @brief Array representing the transitions table of the FSM ultrasaund.
  * 
@@ -268,9 +373,17 @@ void fsm_ultrasound_init(fsm_ultrasound_t *p_fsm_ultrasound, uint32_t ultrasound
     p_fsm_ultrasound->distance_cm = 0;
     p_fsm_ultrasound->distance_idx = 0;
 
-    // Set status and new_measurement to false
+    // Set status to false and empty the queue of measurements
     p_fsm_ultrasound->status = false;
-    p_fsm_ultrasound->new_measurement = false;
+    fsm_ultrasound_queue_init(&p_fsm_ultrasound->queue);
+    p_fsm_ultrasound->standby = false;
+    p_fsm_ultrasound->window_full = false;
+    p_fsm_ultrasound->publish_after = 0;
+    p_fsm_ultrasound->published = false;
+    p_fsm_ultrasound->published_ms = 0;
+    p_fsm_ultrasound->published_confidence_pct = 0;
+    p_fsm_ultrasound->p_short_range = NULL;
+    p_fsm_ultrasound->short_range_enabled = false;
 
     // Initialize the distance array to 0
     memset(p_fsm_ultrasound->distance_arr, 0, sizeof(p_fsm_ultrasound->distance_arr));
@@ -281,6 +394,34 @@ void fsm_ultrasound_init(fsm_ultrasound_t *p_fsm_ultrasound, uint32_t ultrasound
 
 
 /* Public functions -----------------------------------------------------------*/
+PORT_RAMFUNC uint32_t fsm_ultrasound_store_echo(uint32_t ultrasound_id, uint32_t *p_distance_arr, uint32_t distance_idx)
+{
+    uint32_t ticks_elapsed = dsp_echo_ticks(port_ultrasound_get_echo_init_tick(ultrasound_id),
+                                            port_ultrasound_get_echo_end_tick(ultrasound_id),
+                                            port_ultrasound_get_echo_overflows(ultrasound_id));    // 1 tick = 1us
+
+    metrics_counter_inc(METRIC_ULTRASOUND_MEASUREMENTS);
+    metrics_histogram_record(METRIC_ULTRASOUND_ECHO_US, ticks_elapsed);
+    metrics_quantile_record(METRIC_ULTRASOUND_ECHO_Q, ticks_elapsed);
+
+    p_distance_arr[distance_idx] = dsp_ticks_to_cm(ticks_elapsed);    // Taking into account the speed of sound (1cm = 58.3us)
+
+    // Release the echo timer for the next measurement
+    port_ultrasound_stop_echo_timer(ultrasound_id);
+    port_ultrasound_reset_echo_ticks(ultrasound_id);
+
+    distance_idx++;
+    return (distance_idx >= FSM_ULTRASOUND_NUM_MEASUREMENTS) ? 0 : distance_idx;
+}
+
+PORT_RAMFUNC uint32_t fsm_ultrasound_publish_median(const uint32_t *p_distance_arr)
+{
+    uint32_t distance_cm = dsp_median_u32(p_distance_arr, FSM_ULTRASOUND_NUM_MEASUREMENTS);
+    metrics_gauge_set(METRIC_ULTRASOUND_DISTANCE_CM, distance_cm);
+    metrics_quantile_record(METRIC_ULTRASOUND_DISTANCE_Q, distance_cm);
+    return distance_cm;
+}
+
 fsm_ultrasound_t *fsm_ultrasound_new(uint32_t ultrasound_id)
 {
     fsm_ultrasound_t *p_fsm_ultrasound = malloc(sizeof(fsm_ultrasound_t)); /* Do malloc to reserve memory of all other FSM elements, although it is interpreted as fsm_t (the first element of the structure) */
@@ -292,6 +433,7 @@ fsm_ultrasound_t *fsm_ultrasound_new(uint32_t ultrasound_id)
 void fsm_ultrasound_fire(fsm_ultrasound_t * p_fsm)
 {
     fsm_fire(&p_fsm->f); 
+    _short_range_fire(p_fsm);
 }
 
 void fsm_ultrasound_destroy(fsm_ultrasound_t * p_fsm)
@@ -313,29 +455,149 @@ uint32_t fsm_ultrasound_get_state(fsm_ultrasound_t *p_fsm)
 
 uint32_t fsm_ultrasound_get_distance(fsm_ultrasound_t *p_fsm)
 {
-    p_fsm->new_measurement = false;  // Reset the flag
-    return p_fsm->distance_cm;;
+    _flush_measurements(p_fsm);  // The latest distance supersedes the queued ones
+    return p_fsm->distance_cm;
+}
+
+uint32_t fsm_ultrasound_read_measurements(fsm_ultrasound_t *p_fsm, fsm_ultrasound_measurement_t *p_measurements, uint32_t max)
+{
+    return fsm_ultrasound_queue_pop_batch(&p_fsm->queue, p_measurements, max);
+}
+
+uint32_t fsm_ultrasound_get_num_measurements(fsm_ultrasound_t *p_fsm)
+{
+    return fsm_ultrasound_queue_count(&p_fsm->queue);
+}
+
+uint32_t fsm_ultrasound_get_overruns(fsm_ultrasound_t *p_fsm)
+{
+    return fsm_ultrasound_queue_get_overruns(&p_fsm->queue);
+}
+
+bool fsm_ultrasound_get_measurement(fsm_ultrasound_t *p_fsm, uint32_t *p_distance_cm, uint32_t *p_confidence_pct, uint32_t *p_timestamp_ms)
+{
+    if (!p_fsm->published)
+    {
+        return false;
+    }
+
+    *p_distance_cm = p_fsm->distance_cm;
+    *p_confidence_pct = p_fsm->published_confidence_pct;
+    *p_timestamp_ms = p_fsm->published_ms;
+    return true;
+}
+
+void fsm_ultrasound_save(fsm_ultrasound_t *p_fsm, fsm_ultrasound_snapshot_t *p_snapshot)
+{
+    memcpy(p_snapshot->distance_arr, p_fsm->distance_arr, sizeof(p_snapshot->distance_arr));
+    p_snapshot->distance_idx = p_fsm->distance_idx;
+    p_snapshot->distance_cm = p_fsm->distance_cm;
+    p_snapshot->window_full = p_fsm->window_full;
+    p_snapshot->status = p_fsm->status;
+    p_snapshot->standby = p_fsm->standby;
+}
+
+void fsm_ultrasound_restore(fsm_ultrasound_t *p_fsm, const fsm_ultrasound_snapshot_t *p_snapshot, bool keep_window)
+{
+    if (!p_snapshot->status)
+    {
+        return;
+    }
+
+    // Start the sensor as fsm_ultrasound_start(), but with the window of the snapshot. Its distances may be older than the
+    // reset: they are only published together with a majority of new ones.
+    fsm_ultrasound_start(p_fsm);
+    if (keep_window)
+    {
+        memcpy(p_fsm->distance_arr, p_snapshot->distance_arr, sizeof(p_fsm->distance_arr));
+        p_fsm->distance_idx = (p_snapshot->distance_idx < FSM_ULTRASOUND_NUM_MEASUREMENTS) ? p_snapshot->distance_idx : 0;
+        p_fsm->distance_cm = p_snapshot->distance_cm;
+        p_fsm->window_full = p_snapshot->window_full;
+        p_fsm->publish_after = p_snapshot->window_full ? FSM_ULTRASOUND_RESTORE_NEW_MEASUREMENTS : 0;
+    }
+
+    if (p_snapshot->standby)
+    {
+        p_fsm->standby = true;
+        port_ultrasound_set_measurement_period_ms(PORT_PARKING_SENSOR_STANDBY_PERIOD_MS);
+    }
 }
 
 void fsm_ultrasound_stop(fsm_ultrasound_t *p_fsm)
 {
     p_fsm->status = false;
     port_ultrasound_stop_ultrasound(p_fsm->ultrasound_id);
+    _short_range_disable(p_fsm);
+
+    // The queued distances and their overruns belong to this run: they must not be read after the next start
+    fsm_ultrasound_queue_init(&p_fsm->queue);
+
+    // The timers that end a measurement in progress are stopped: wait for the next start, or the FSM would wait for them forever
+    p_fsm->f.current_state = WAIT_START;
+
+    if (p_fsm->standby)
+    {
+        p_fsm->standby = false;
+        port_ultrasound_set_measurement_period_ms(PORT_PARKING_SENSOR_TIMEOUT_MS);
+    }
 }
 
 void fsm_ultrasound_start(fsm_ultrasound_t *p_fsm)
 {
+    if (p_fsm->status && p_fsm->standby)
+    {
+        // Leave the warm standby: the sensor is powered and the window is filled, so the median is published with the next
+        // measurement, which is triggered right away instead of at the end of the slow period.
+        p_fsm->standby = false;
+        if (p_fsm->publish_after == 0)  // A restored window still waits for its new measurements
+        {
+            p_fsm->publish_after = 1;
+        }
+        _flush_measurements(p_fsm);
+        port_ultrasound_set_measurement_period_ms(PORT_PARKING_SENSOR_TIMEOUT_MS);
+        port_ultrasound_set_trigger_ready(p_fsm->ultrasound_id, true);
+        return;
+    }
+
     p_fsm->status = true;
     p_fsm->distance_idx = 0;
+    p_fsm->window_full = false;
+    p_fsm->publish_after = 0;
 
     p_fsm->distance_cm = 0;
 
+    // Power up the sensor first, so it settles while the rest of the system starts
+    port_ultrasound_power_on(p_fsm->ultrasound_id);
+
     port_ultrasound_reset_echo_ticks(p_fsm->ultrasound_id);
     port_ultrasound_set_trigger_ready(p_fsm->ultrasound_id, true);
 
     port_ultrasound_start_new_measurement_timer();
 }
 
+void fsm_ultrasound_start_standby(fsm_ultrasound_t *p_fsm)
+{
+    if (!p_fsm->status)
+    {
+        fsm_ultrasound_start(p_fsm);
+    }
+
+    // The measurements continue at the low rate. The window of distances is kept.
+    p_fsm->standby = true;
+    port_ultrasound_set_measurement_period_ms(PORT_PARKING_SENSOR_STANDBY_PERIOD_MS);
+}
+
+void fsm_ultrasound_set_short_range(fsm_ultrasound_t *p_fsm, ranging_device_t *p_device)
+{
+    _short_range_disable(p_fsm);
+    p_fsm->p_short_range = p_device;
+}
+
+bool fsm_ultrasound_get_standby(fsm_ultrasound_t *p_fsm)
+{
+    return p_fsm->standby;
+}
+
 bool fsm_ultrasound_get_status(fsm_ultrasound_t *p_fsm)
 {
     return p_fsm -> status;
@@ -353,7 +615,7 @@ bool fsm_ultrasound_get_ready(fsm_ultrasound_t *p_fsm)
 
 bool fsm_ultrasound_get_new_measurement_ready(fsm_ultrasound_t *p_fsm)
 {
-    return p_fsm->new_measurement;
+    return fsm_ultrasound_queue_count(&p_fsm->queue) > 0;
 }
 
 
@@ -10,14 +10,18 @@
 /* Standard C includes */
 #include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 
 
 /* HW dependent includes */
 #include "port_system.h"
+#include "port_reverse.h"
+#include "port_backup.h"
 
 /* Project includes */
 #include "fsm.h"
 #include "fsm_urbanite.h"
+#include "metrics.h"
 
 
 /* Typedefs --------------------------------------------------------------------*/
@@ -37,10 +41,120 @@ struct fsm_urbanite_t
     bool emergency;                             /*!<    To indicate the emergency state*/
     fsm_ultrasound_t * p_fsm_ultrasound_rear;   /*!<    Pointer to the ultrasound FSM*/
     fsm_display_t * p_fsm_display_rear;         /*!<    Pointer to the display FSM*/
+    uint32_t reverse_id;                        /*!<    Reverse input ID of the vehicle*/
+    bool reverse_enabled;                       /*!<    Flag to indicate that the reverse gear activates the system*/
+    bool warm_standby;                          /*!<    Flag to indicate that the sensor is kept in warm standby while the ignition is on*/
+    bool by_reverse;                            /*!<    Flag to indicate that the system has been turned ON by the reverse gear*/
+    bool reverse_dismissed;                     /*!<    Flag to indicate that the system has been turned OFF with the button while in reverse*/
+    bool snapshot_enabled;                      /*!<    Flag to indicate that a snapshot is saved in the backup memory before each low power mode*/
+    bool resume_pending;                        /*!<    Flag to indicate that the system has been resumed from a snapshot and no distance has been shown yet*/
+    uint32_t resume_ms;                         /*!<    Time of the resume from the snapshot*/
+    uint32_t resume_latency_ms;                 /*!<    Time from the resume to the first distance shown*/
 };
 
+/**
+ * @brief Snapshot of the Urbanite and its FSMs, kept in the backup memory.
+ */
+typedef struct
+{
+    uint32_t version;                           /*!<    `FSM_URBANITE_SNAPSHOT_VERSION` of the firmware that saved it*/
+    int32_t state;                              /*!<    State to resume: OFF or MEASURE*/
+    bool is_paused;                             /*!<    The display was paused*/
+    bool by_reverse;                            /*!<    The system was turned ON by the reverse gear*/
+    bool reverse_dismissed;                     /*!<    The system was turned OFF with the button while in reverse*/
+    fsm_ultrasound_snapshot_t ultrasound_rear;  /*!<    Snapshot of the rear ultrasound FSM*/
+    fsm_display_snapshot_t display_rear;        /*!<    Snapshot of the rear display FSM*/
+} fsm_urbanite_snapshot_t;
+
 /* Private functions -----------------------------------------------------------*/
 /* State machine input or transition functions */
+/**
+ * @brief Check if the sensor must be in warm standby: the reverse gear is enabled with warm standby and the ignition is on.
+ * 
+ * @param p_fsm     Pointer to the Urbanite FSM.
+ * @return true 
+ * @return false 
+ */
+static bool _warm_standby_required(fsm_urbanite_t * p_fsm)
+{
+    return (p_fsm -> reverse_enabled)&&(p_fsm -> warm_standby)&&port_reverse_get_ignition(p_fsm -> reverse_id);
+}
+
+/**
+ * @brief Check if the reverse gear has been engaged to turn ON the Urbanite system.
+ * It is not checked again after the system has been turned OFF with the button, until the reverse gear is released.
+ * 
+ * @param p_this    Pointer to an fsm_t struct that contains an fsm_urbanite_t.
+ * @return true 
+ * @return false 
+ */
+static bool check_reverse_on(fsm_t * p_this)
+{
+    fsm_urbanite_t *p_fsm = (fsm_urbanite_t *)(p_this);
+    return (p_fsm -> reverse_enabled)&&(!p_fsm -> reverse_dismissed)&&port_reverse_get_engaged(p_fsm -> reverse_id);
+}
+
+/**
+ * @brief Check if the reverse gear has been released after turning ON the Urbanite system.
+ * 
+ * @param p_this    Pointer to an fsm_t struct that contains an fsm_urbanite_t.
+ * @return true 
+ * @return false 
+ */
+static bool check_reverse_off(fsm_t * p_this)
+{
+    fsm_urbanite_t *p_fsm = (fsm_urbanite_t *)(p_this);
+    return (p_fsm -> by_reverse)&&(!port_reverse_get_engaged(p_fsm -> reverse_id));
+}
+
+/**
+ * @brief Check if the reverse gear has been released after turning OFF the system with the button while in reverse.
+ * 
+ * @param p_this    Pointer to an fsm_t struct that contains an fsm_urbanite_t.
+ * @return true 
+ * @return false 
+ */
+static bool check_reverse_rearm(fsm_t * p_this)
+{
+    fsm_urbanite_t *p_fsm = (fsm_urbanite_t *)(p_this);
+    return (p_fsm -> reverse_dismissed)&&(!port_reverse_get_engaged(p_fsm -> reverse_id));
+}
+
+/**
+ * @brief Check if the warm standby of the sensor must start or stop because the ignition has changed while the system is OFF.
+ * 
+ * @param p_this    Pointer to an fsm_t struct that contains an fsm_urbanite_t.
+ * @return true 
+ * @return false 
+ */
+static bool check_warm_standby_change(fsm_t * p_this)
+{
+    fsm_urbanite_t *p_fsm = (fsm_urbanite_t *)(p_this);
+    return (p_fsm -> reverse_enabled)&&(p_fsm -> warm_standby)&&(_warm_standby_required(p_fsm) != fsm_ultrasound_get_status(p_fsm -> p_fsm_ultrasound_rear));
+}
+
+/**
+ * @brief Check if the vehicle inputs require an action of the Urbanite FSM in its current state, or if a change of their levels
+ * is still being debounced.
+ * 
+ * @param p_this    Pointer to an fsm_t struct that contains an fsm_urbanite_t.
+ * @return true 
+ * @return false 
+ */
+static bool check_reverse_activity(fsm_t * p_this)
+{
+    fsm_urbanite_t *p_fsm = (fsm_urbanite_t *)(p_this);
+    if ((p_fsm -> reverse_enabled)&&port_reverse_get_debouncing(p_fsm -> reverse_id))
+    {
+        return true;
+    }
+    if ((p_this -> current_state == OFF)||(p_this -> current_state == SLEEP_WHILE_OFF))
+    {
+        return check_reverse_on(p_this)||check_reverse_rearm(p_this)||check_warm_standby_change(p_this);
+    }
+    return check_reverse_off(p_this);
+}
+
 /**
  * @brief Check if the button has been pressed for the required time to turn ON the Urbanite system.
  * 
@@ -148,7 +262,7 @@ static bool check_pause_display(fsm_t * p_this)
 static bool check_activity(fsm_t * p_this)
 {
     fsm_urbanite_t *p_fsm = (fsm_urbanite_t *)(p_this);
-    return (fsm_ultrasound_check_activity(p_fsm -> p_fsm_ultrasound_rear)||fsm_display_check_activity(p_fsm -> p_fsm_display_rear)||fsm_button_check_activity(p_fsm -> p_fsm_button));
+    return (fsm_ultrasound_check_activity(p_fsm -> p_fsm_ultrasound_rear)||fsm_display_check_activity(p_fsm -> p_fsm_display_rear)||fsm_button_check_activity(p_fsm -> p_fsm_button)||check_reverse_activity(p_this));
 }
 
 /**
@@ -164,7 +278,9 @@ static bool check_no_activity(fsm_t * p_this)
 }
 
 /**
- * @brief Check if any a new measurement is ready while the system is in low power mode.
+ * @brief Check if any a new measurement is ready or the button is pressed while the system is in low power mode.
+ * The press is handled awake: if it only woke up with the next measurement, it could go back to sleep before the duration of the
+ * press is checked, and the press would be lost.
  * 
  * @param p_this    Pointer to an fsm_t struct that contains an fsm_urbanite_t.
  * @return true 
@@ -172,11 +288,29 @@ static bool check_no_activity(fsm_t * p_this)
  */
 static bool check_activity_in_measure(fsm_t * p_this)
 {
-    return check_new_measure(p_this);
+    fsm_urbanite_t *p_fsm = (fsm_urbanite_t *)(p_this);
+    return check_new_measure(p_this) || fsm_button_check_activity(p_fsm -> p_fsm_button) || check_reverse_activity(p_this);
 }
 
 
 /* State machine output or action functions */
+/**
+ * @brief Stop the ultrasound sensor, or move it to warm standby if the ignition is on.
+ * 
+ * @param p_fsm     Pointer to the Urbanite FSM.
+ */
+static void _stop_or_standby(fsm_urbanite_t * p_fsm)
+{
+    if (_warm_standby_required(p_fsm))
+    {
+        fsm_ultrasound_start_standby(p_fsm -> p_fsm_ultrasound_rear);
+    }
+    else
+    {
+        fsm_ultrasound_stop(p_fsm -> p_fsm_ultrasound_rear);
+    }
+}
+
 /**
  * @brief Turn the Urbanite system ON.
  * 
@@ -186,6 +320,7 @@ static void do_start_up_measure(fsm_t * p_this)
 {
     fsm_urbanite_t *p_fsm = (fsm_urbanite_t *)(p_this);
     fsm_button_reset_duration(p_fsm -> p_fsm_button);
+    metrics_counter_inc(METRIC_URBANITE_GESTURES);
 
     // Start the ultrasound sensor
     fsm_ultrasound_start(p_fsm -> p_fsm_ultrasound_rear);
@@ -206,14 +341,77 @@ static void do_stop_urbanite(fsm_t * p_this)
     fsm_urbanite_t *p_fsm = (fsm_urbanite_t *)(p_this);
 
     fsm_button_reset_duration(p_fsm -> p_fsm_button);
-    fsm_ultrasound_stop(p_fsm -> p_fsm_ultrasound_rear);
+    metrics_counter_inc(METRIC_URBANITE_GESTURES);
+    _stop_or_standby(p_fsm);
     fsm_display_set_status(p_fsm -> p_fsm_display_rear, false);
 
     p_fsm -> is_paused = false;     // Remove pause status
 
+    // Turned OFF by the driver while in reverse: do not turn it ON again until the reverse gear is released
+    p_fsm -> reverse_dismissed = (p_fsm -> reverse_enabled)&&port_reverse_get_engaged(p_fsm -> reverse_id);
+    p_fsm -> by_reverse = false;
+
     printf("[URBANITE][%ld] Urbanite system OFF\n", port_system_get_millis());  // DEBUG
 }	
 
+/**
+ * @brief Turn the Urbanite system ON because the reverse gear has been engaged.
+ * If the sensor was in warm standby, a valid distance is ready within one measurement period.
+ * 
+ * @param p_this Pointer to an fsm_t struct that contains an fsm_urbanite_t.
+ */
+static void do_start_up_reverse(fsm_t * p_this)
+{
+    fsm_urbanite_t *p_fsm = (fsm_urbanite_t *)(p_this);
+
+    p_fsm -> by_reverse = true;
+
+    fsm_ultrasound_start(p_fsm -> p_fsm_ultrasound_rear);
+    fsm_display_set_status(p_fsm -> p_fsm_display_rear, true);
+
+    printf("[URBANITE][%ld] Urbanite system ON (reverse gear)\n", port_system_get_millis());   // DEBUG
+}
+
+/**
+ * @brief Turn the Urbanite system OFF because the reverse gear has been released.
+ * 
+ * @param p_this Pointer to an fsm_t struct that contains an fsm_urbanite_t.
+ */
+static void do_stop_reverse(fsm_t * p_this)
+{
+    fsm_urbanite_t *p_fsm = (fsm_urbanite_t *)(p_this);
+
+    p_fsm -> by_reverse = false;
+    p_fsm -> is_paused = false;
+
+    _stop_or_standby(p_fsm);
+    fsm_display_set_status(p_fsm -> p_fsm_display_rear, false);
+
+    printf("[URBANITE][%ld] Urbanite system OFF (reverse gear released)\n", port_system_get_millis());   // DEBUG
+}
+
+/**
+ * @brief Allow the reverse gear to turn the system ON again, once it has been released.
+ * 
+ * @param p_this Pointer to an fsm_t struct that contains an fsm_urbanite_t.
+ */
+static void do_rearm_reverse(fsm_t * p_this)
+{
+    fsm_urbanite_t *p_fsm = (fsm_urbanite_t *)(p_this);
+    p_fsm -> reverse_dismissed = false;
+}
+
+/**
+ * @brief Start or stop the warm standby of the sensor following the ignition, while the system is OFF.
+ * 
+ * @param p_this Pointer to an fsm_t struct that contains an fsm_urbanite_t.
+ */
+static void do_warm_standby(fsm_t * p_this)
+{
+    fsm_urbanite_t *p_fsm = (fsm_urbanite_t *)(p_this);
+    _stop_or_standby(p_fsm);
+}
+
 /**
  * @brief Pause or resume the display system.
  * 
@@ -224,6 +422,7 @@ static void do_pause_display(fsm_t * p_this)
     fsm_urbanite_t *p_fsm = (fsm_urbanite_t *)(p_this);
 
     fsm_button_reset_duration(p_fsm -> p_fsm_button);
+    metrics_counter_inc(METRIC_URBANITE_GESTURES);
 
     // Invert the pause status and activate or deactivate the display depending on the new pause status.
     p_fsm -> is_paused = !(p_fsm -> is_paused);
@@ -241,7 +440,10 @@ static void do_pause_display(fsm_t * p_this)
 }
 
 /**
- * @brief Display the distance measured by the ultrasound sensor.
+ * @brief Display the distances measured by the ultrasound sensor.
+ * All the distances queued since the last display are drained in order, so none is lost for the log while the system is
+ * busy (e.g., in the delays of the emergency mode). Only the latest one is displayed: the older ones are already outdated,
+ * and setting each of them would refresh the display several times per call.
  * 
  * @param p_this Pointer to an fsm_t struct that contains an fsm_urbanite_t.
  */
@@ -249,7 +451,19 @@ static void do_display_distance(fsm_t * p_this)
 {
     fsm_urbanite_t *p_fsm = (fsm_urbanite_t *)(p_this);
     
-    uint32_t distance_cm = fsm_ultrasound_get_distance(p_fsm -> p_fsm_ultrasound_rear);
+    fsm_ultrasound_measurement_t measurements[FSM_ULTRASOUND_QUEUE_LEN];
+    uint32_t num = fsm_ultrasound_read_measurements(p_fsm -> p_fsm_ultrasound_rear, measurements, FSM_ULTRASOUND_QUEUE_LEN);
+    if (num == 0)
+    {
+        return;
+    }
+
+    for (uint32_t i = 0; i < num; i++)
+    {
+        printf("[URBANITE][%ld] Distance: %ld cm\n", measurements[i].timestamp_ms, measurements[i].distance_cm);    // DEBUG
+    }
+
+    uint32_t distance_cm = measurements[num - 1].distance_cm;
 
     if(p_fsm -> is_paused)
     {
@@ -268,7 +482,14 @@ static void do_display_distance(fsm_t * p_this)
         fsm_display_set_distance(p_fsm -> p_fsm_display_rear, distance_cm);
     }
 
-    printf("[URBANITE][%ld] Distance: %ld cm\n", port_system_get_millis(), distance_cm);    // DEBUG
+    if (p_fsm -> resume_pending)
+    {
+        // First valid output after the resume from the snapshot
+        p_fsm -> resume_pending = false;
+        p_fsm -> resume_latency_ms = port_system_get_millis() - p_fsm -> resume_ms;
+        metrics_histogram_record(METRIC_URBANITE_RESUME_MS, p_fsm -> resume_latency_ms);
+        printf("[URBANITE][%ld] Resumed: first distance in %ld ms\n", port_system_get_millis(), p_fsm -> resume_latency_ms);   // DEBUG
+    }
 }
 
 /**
@@ -281,6 +502,8 @@ static void do_start_emergency(fsm_t * p_this)
     fsm_urbanite_t *p_fsm = (fsm_urbanite_t *)(p_this);
 
     fsm_button_reset_duration(p_fsm -> p_fsm_button);
+    metrics_counter_inc(METRIC_URBANITE_GESTURES);
+    metrics_counter_inc(METRIC_URBANITE_EMERGENCY_ENTRIES);
 
     fsm_display_set_status(p_fsm -> p_fsm_display_rear, true);
     fsm_ultrasound_stop(p_fsm -> p_fsm_ultrasound_rear);
@@ -301,6 +524,7 @@ static void do_stop_emergency(fsm_t * p_this)
     fsm_urbanite_t *p_fsm = (fsm_urbanite_t *)(p_this);
 
     fsm_button_reset_duration(p_fsm -> p_fsm_button);
+    metrics_counter_inc(METRIC_URBANITE_GESTURES);
     fsm_ultrasound_start(p_fsm -> p_fsm_ultrasound_rear);
 
     // Deactivate the display if it was paused
@@ -342,23 +566,65 @@ static void do_continue_emergency(fsm_t * p_this)
 }
 
 /**
- * @brief Start the low power mode while the Urbanite is OFF.
+ * @brief Save the snapshot of the system in the backup memory (if enabled).
+ * It is only saved when the system enters the low power mode: the self-transitions of the sleep states do not change the
+ * state to resume, and rewriting the backup memory (with its checksum) at each wake-up would only cost time and power.
+ * 
+ * @param p_fsm         Pointer to the Urbanite FSM.
+ * @param resume_state  State to resume from the snapshot (OFF or MEASURE).
+ */
+static void _save_snapshot(fsm_urbanite_t * p_fsm, int32_t resume_state)
+{
+    if (!p_fsm -> snapshot_enabled)
+    {
+        return;
+    }
+
+    fsm_urbanite_snapshot_t snapshot;
+    memset(&snapshot, 0, sizeof(snapshot));     // Deterministic padding for the checksum
+
+    snapshot.version = FSM_URBANITE_SNAPSHOT_VERSION;
+    snapshot.state = resume_state;
+    snapshot.is_paused = p_fsm -> is_paused;
+    snapshot.by_reverse = p_fsm -> by_reverse;
+    snapshot.reverse_dismissed = p_fsm -> reverse_dismissed;
+    fsm_ultrasound_save(p_fsm -> p_fsm_ultrasound_rear, &snapshot.ultrasound_rear);
+    fsm_display_save(p_fsm -> p_fsm_display_rear, &snapshot.display_rear);
+
+    port_backup_write(&snapshot, sizeof(snapshot));
+}
+
+/**
+ * @brief Start the low power mode.
+ */
+static void _sleep(void)
+{
+    metrics_counter_inc(METRIC_SYSTEM_SLEEP_ENTRIES);
+    port_system_sleep();
+}
+
+/**
+ * @brief Save the snapshot and start the low power mode while the Urbanite is OFF.
  * 
  * @param p_this Pointer to an fsm_t struct that contains an fsm_urbanite_t.
  */
 static void do_sleep_off(fsm_t * p_this)
 {
-    port_system_sleep();
+    fsm_urbanite_t *p_fsm = (fsm_urbanite_t *)(p_this);
+    _save_snapshot(p_fsm, OFF);
+    _sleep();
 }	
 
 /**
- * @brief Start the low power mode while the Urbanite is measuring the distance and it is waiting for a new measurement.
+ * @brief Save the snapshot and start the low power mode while the Urbanite is measuring the distance and it is waiting for a new measurement.
  * 
- * @param p_this Call function port_system_sleep() to start the low power mode
+ * @param p_this Pointer to an fsm_t struct that contains an fsm_urbanite_t.
  */
 static void do_sleep_while_measure(fsm_t * p_this)
 {
-    port_system_sleep();
+    fsm_urbanite_t *p_fsm = (fsm_urbanite_t *)(p_this);
+    _save_snapshot(p_fsm, MEASURE);
+    _sleep();
 }	
 
 /**
@@ -368,7 +634,7 @@ static void do_sleep_while_measure(fsm_t * p_this)
  */
 static void do_sleep_while_off(fsm_t * p_this)
 {
-    port_system_sleep();
+    _sleep();
 }
 
 /**
@@ -378,7 +644,7 @@ static void do_sleep_while_off(fsm_t * p_this)
  */
 static void do_sleep_while_on	(fsm_t * p_this)	
 {
-    port_system_sleep();
+    _sleep();
 }
 
 
@@ -392,6 +658,9 @@ static fsm_trans_t fsm_trans_urbanite[] = {
     {SLEEP_WHILE_OFF, check_no_activity, SLEEP_WHILE_OFF, do_sleep_while_off},
     
     {OFF, check_on, MEASURE, do_start_up_measure},
+    {OFF, check_reverse_on, MEASURE, do_start_up_reverse},
+    {OFF, check_reverse_rearm, OFF, do_rearm_reverse},
+    {OFF, check_warm_standby_change, OFF, do_warm_standby},
     {MEASURE, check_pause_display, MEASURE, do_pause_display},
     {MEASURE, check_new_measure, MEASURE, do_display_distance},
 
@@ -405,6 +674,7 @@ static fsm_trans_t fsm_trans_urbanite[] = {
     
 
     {MEASURE, check_off, OFF, do_stop_urbanite},
+    {MEASURE, check_reverse_off, OFF, do_stop_reverse},
     {-1, NULL, -1, NULL}
 };
 
@@ -441,6 +711,19 @@ static void fsm_urbanite_init(fsm_urbanite_t * p_fsm_urbanite, fsm_button_t * p_
     p_fsm_urbanite -> is_paused = false;
     p_fsm_urbanite -> emergency_aux = false;
     p_fsm_urbanite -> emergency = false;
+
+    // The reverse gear is disabled until it is configured
+    p_fsm_urbanite -> reverse_id = 0;
+    p_fsm_urbanite -> reverse_enabled = false;
+    p_fsm_urbanite -> warm_standby = false;
+    p_fsm_urbanite -> by_reverse = false;
+    p_fsm_urbanite -> reverse_dismissed = false;
+
+    // No snapshot until the resume is requested
+    p_fsm_urbanite -> snapshot_enabled = false;
+    p_fsm_urbanite -> resume_pending = false;
+    p_fsm_urbanite -> resume_ms = 0;
+    p_fsm_urbanite -> resume_latency_ms = 0;
 }
 
 
@@ -452,6 +735,54 @@ fsm_urbanite_t* fsm_urbanite_new(fsm_button_t * p_fsm_button, uint32_t on_off_pr
     return p_fsm_urbanite;
 }
 
+void fsm_urbanite_set_reverse(fsm_urbanite_t * p_fsm, uint32_t reverse_id, bool warm_standby)
+{
+    p_fsm -> reverse_id = reverse_id;
+    p_fsm -> reverse_enabled = true;
+    p_fsm -> warm_standby = warm_standby;
+}
+
+bool fsm_urbanite_resume(fsm_urbanite_t * p_fsm)
+{
+    fsm_urbanite_snapshot_t snapshot;
+
+    p_fsm -> snapshot_enabled = true;
+    if (!port_backup_read(&snapshot, sizeof(snapshot)) || (snapshot.version != FSM_URBANITE_SNAPSHOT_VERSION))
+    {
+        return false;
+    }
+
+    // The sensor is restored in both states: measuring, or in warm standby while OFF. After a power-on reset the system may have
+    // been off for any time (the backup memory is kept by the battery), so the distances of the window are dropped
+    bool keep_window = !port_system_get_power_on_reset();
+    fsm_ultrasound_restore(p_fsm -> p_fsm_ultrasound_rear, &snapshot.ultrasound_rear, keep_window);
+    p_fsm -> reverse_dismissed = snapshot.reverse_dismissed;
+
+    if (snapshot.state == MEASURE)
+    {
+        p_fsm -> f.current_state = MEASURE;
+        p_fsm -> is_paused = snapshot.is_paused;
+        p_fsm -> by_reverse = snapshot.by_reverse;
+        fsm_display_restore(p_fsm -> p_fsm_display_rear, &snapshot.display_rear);
+
+        p_fsm -> resume_pending = true;
+        p_fsm -> resume_ms = port_system_get_millis();
+    }
+
+    printf("[URBANITE][%ld] Resumed from snapshot (%s)\n", port_system_get_millis(), (snapshot.state == MEASURE) ? "ON" : "OFF");   // DEBUG
+    return true;
+}
+
+uint32_t fsm_urbanite_get_resume_latency_ms(fsm_urbanite_t * p_fsm)
+{
+    return p_fsm -> resume_latency_ms;
+}
+
+uint32_t fsm_urbanite_get_state(fsm_urbanite_t * p_fsm)
+{
+    return p_fsm->f.current_state;
+}
+
 void fsm_urbanite_fire(fsm_urbanite_t * p_fsm)
 {
     fsm_fire(&p_fsm->f); 
@@ -0,0 +1,248 @@
+/**
+ * @file metrics.c
+ * @brief Registry of named counters, gauges and histograms.
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Project includes */
+#include "metrics.h"
+
+#ifdef USE_METRICS
+
+/* Standard C includes */
+#include <stdio.h>
+#include <string.h>
+
+/* Defines --------------------------------------------------------------------*/
+#define METRICS_X_COUNT(...) +1                                         /*!<    Helper to count the elements of a list @hideinitializer */
+#define METRICS_NUM_SCALARS (0 METRICS_SCALARS(METRICS_X_COUNT))        /*!<    Number of counters and gauges @hideinitializer */
+#define METRICS_NUM_HISTOGRAMS (0 METRICS_HISTOGRAMS(METRICS_X_COUNT))  /*!<    Number of histograms @hideinitializer */
+#define METRICS_NUM_QUANTILE_METRICS (0 METRICS_QUANTILES(METRICS_X_COUNT)) /*!<    Number of quantile metrics @hideinitializer */
+#define METRICS_FIRST_QUANTILE (METRICS_NUM_SCALARS + METRICS_NUM_HISTOGRAMS)   /*!<    Identifier of the first quantile metric @hideinitializer */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Storage of a histogram.
+ */
+typedef struct
+{
+    uint32_t buckets[METRICS_HISTOGRAM_NUM_BUCKETS];    /*!<    Number of samples in each bucket*/
+    uint32_t count;                                     /*!<    Number of samples*/
+    uint32_t sum;                                       /*!<    Sum of the samples (saturated)*/
+} metrics_histogram_t;
+
+/* Global variables */
+#define METRICS_X_SCALAR_KIND(id, kind, name) kind,
+#define METRICS_X_SCALAR_NAME(id, kind, name) name,
+#define METRICS_X_HISTOGRAM_SHIFT(id, shift, name) shift,
+#define METRICS_X_HISTOGRAM_NAME(id, shift, name) name,
+#define METRICS_X_QUANTILE_NAME(id, name) name,
+
+static const metrics_kind_t scalars_kind[METRICS_NUM_SCALARS] = { METRICS_SCALARS(METRICS_X_SCALAR_KIND) };   /*!<    Kind of each scalar metric (flash)*/
+static const char *const scalars_name[METRICS_NUM_SCALARS] = { METRICS_SCALARS(METRICS_X_SCALAR_NAME) };      /*!<    Name of each scalar metric (flash)*/
+static const uint8_t histograms_shift[METRICS_NUM_HISTOGRAMS] = { METRICS_HISTOGRAMS(METRICS_X_HISTOGRAM_SHIFT) };   /*!<    Shift of each histogram (flash)*/
+static const char *const histograms_name[METRICS_NUM_HISTOGRAMS] = { METRICS_HISTOGRAMS(METRICS_X_HISTOGRAM_NAME) }; /*!<    Name of each histogram (flash)*/
+
+static const char *const quantiles_name[METRICS_NUM_QUANTILE_METRICS] = { METRICS_QUANTILES(METRICS_X_QUANTILE_NAME) };   /*!<    Name of each quantile metric (flash)*/
+static const uint32_t quantiles_pct[METRICS_NUM_QUANTILES] = METRICS_QUANTILES_PCT;  /*!<    Percentiles of the quantile metrics (flash)*/
+
+static volatile uint32_t scalars_arr[METRICS_NUM_SCALARS];          /*!<    Values of the counters and gauges. Updated from ISRs too*/
+static metrics_histogram_t histograms_arr[METRICS_NUM_HISTOGRAMS];  /*!<    Storage of the histograms*/
+static quantile_t quantiles_arr[METRICS_NUM_QUANTILE_METRICS][METRICS_NUM_QUANTILES];  /*!<    Estimators of the quantile metrics*/
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Get the bucket of a value in a histogram.
+ *
+ * @param value     Value of the sample.
+ * @param shift     Shift of the histogram.
+ * @return uint32_t Index of the bucket.
+ */
+static uint32_t _metrics_bucket(uint32_t value, uint8_t shift)
+{
+    uint32_t scaled = value >> shift;
+    uint32_t bucket = 0;
+
+    while ((scaled != 0) && (bucket < (METRICS_HISTOGRAM_NUM_BUCKETS - 1)))
+    {
+        scaled >>= 1;
+        bucket++;
+    }
+    return bucket;
+}
+
+/**
+ * @brief Visitor used by `metrics_dump()` to print a metric.
+ *
+ * @param p_entry   Pointer to the snapshot of the metric.
+ * @param p_ctx     Not used.
+ */
+static void _metrics_print(const metrics_entry_t *p_entry, void *p_ctx)
+{
+    if (p_entry->kind == METRIC_KIND_QUANTILES)
+    {
+        printf("[METRICS] %s: n = %lu", p_entry->p_name, (unsigned long)p_entry->value);
+        for (uint32_t i = 0; i < METRICS_NUM_QUANTILES; i++)
+        {
+            printf(", p%lu = %lu", (unsigned long)quantiles_pct[i], (unsigned long)p_entry->quantiles[i]);
+        }
+        printf("\n");
+        return;
+    }
+    if (p_entry->kind != METRIC_KIND_HISTOGRAM)
+    {
+        printf("[METRICS] %s = %lu\n", p_entry->p_name, (unsigned long)p_entry->value);
+        return;
+    }
+
+    printf("[METRICS] %s: n = %lu, sum = %lu, buckets =", p_entry->p_name, (unsigned long)p_entry->value, (unsigned long)p_entry->sum);
+    for (uint32_t i = 0; i < METRICS_HISTOGRAM_NUM_BUCKETS; i++)
+    {
+        printf(" %lu", (unsigned long)p_entry->p_buckets[i]);
+    }
+    printf("\n");
+}
+
+/* Public functions -----------------------------------------------------------*/
+void metrics_reset(void)
+{
+    for (uint32_t i = 0; i < METRICS_NUM_SCALARS; i++)
+    {
+        scalars_arr[i] = 0;
+    }
+    memset(histograms_arr, 0, sizeof(histograms_arr));
+    memset(quantiles_arr, 0, sizeof(quantiles_arr));
+}
+
+void metrics_counter_add(metrics_id_t id, uint32_t n)
+{
+    if ((uint32_t)id < METRICS_NUM_SCALARS)
+    {
+        scalars_arr[id] += n;
+    }
+}
+
+void metrics_gauge_set(metrics_id_t id, uint32_t value)
+{
+    if ((uint32_t)id < METRICS_NUM_SCALARS)
+    {
+        scalars_arr[id] = value;
+    }
+}
+
+void metrics_histogram_record(metrics_id_t id, uint32_t value)
+{
+    uint32_t idx = (uint32_t)id - METRICS_NUM_SCALARS;
+    if (((uint32_t)id < METRICS_NUM_SCALARS) || (idx >= METRICS_NUM_HISTOGRAMS))
+    {
+        return;
+    }
+
+    metrics_histogram_t *p_histogram = &histograms_arr[idx];
+    p_histogram->buckets[_metrics_bucket(value, histograms_shift[idx])]++;
+    p_histogram->count++;
+    p_histogram->sum = (p_histogram->sum > (UINT32_MAX - value)) ? UINT32_MAX : (p_histogram->sum + value);
+}
+
+void metrics_quantile_record(metrics_id_t id, uint32_t value)
+{
+    uint32_t idx = (uint32_t)id - METRICS_FIRST_QUANTILE;
+    if (((uint32_t)id < METRICS_FIRST_QUANTILE) || (idx >= METRICS_NUM_QUANTILE_METRICS))
+    {
+        return;
+    }
+
+    for (uint32_t j = 0; j < METRICS_NUM_QUANTILES; j++)
+    {
+        // The estimators are zeroed like the rest of the registry: the first sample sets their probability
+        if (quantile_get_count(&quantiles_arr[idx][j]) == 0)
+        {
+            quantile_init(&quantiles_arr[idx][j], QUANTILE_PROB(quantiles_pct[j]));
+        }
+        quantile_update(&quantiles_arr[idx][j], value);
+    }
+}
+
+uint32_t metrics_get_quantile(metrics_id_t id, uint32_t idx)
+{
+    uint32_t q_idx = (uint32_t)id - METRICS_FIRST_QUANTILE;
+    if (((uint32_t)id < METRICS_FIRST_QUANTILE) || (q_idx >= METRICS_NUM_QUANTILE_METRICS) || (idx >= METRICS_NUM_QUANTILES))
+    {
+        return 0;
+    }
+    return quantile_get(&quantiles_arr[q_idx][idx]);
+}
+
+uint32_t metrics_get_value(metrics_id_t id)
+{
+    if ((uint32_t)id < METRICS_NUM_SCALARS)
+    {
+        return scalars_arr[id];
+    }
+    if ((uint32_t)id < METRICS_FIRST_QUANTILE)
+    {
+        return histograms_arr[id - METRICS_NUM_SCALARS].count;
+    }
+    if ((uint32_t)id < METRICS_NUM_METRICS)
+    {
+        return quantile_get_count(&quantiles_arr[id - METRICS_FIRST_QUANTILE][0]);
+    }
+    return 0;
+}
+
+void metrics_for_each(metrics_visitor_t visitor, void *p_ctx)
+{
+    metrics_entry_t entry;
+
+    for (uint32_t i = 0; i < METRICS_NUM_SCALARS; i++)
+    {
+        entry.id = (metrics_id_t)i;
+        entry.kind = scalars_kind[i];
+        entry.p_name = scalars_name[i];
+        entry.value = scalars_arr[i];
+        entry.sum = 0;
+        entry.shift = 0;
+        entry.p_buckets = NULL;
+        memset(entry.quantiles, 0, sizeof(entry.quantiles));
+        visitor(&entry, p_ctx);
+    }
+
+    for (uint32_t i = 0; i < METRICS_NUM_HISTOGRAMS; i++)
+    {
+        entry.id = (metrics_id_t)(METRICS_NUM_SCALARS + i);
+        entry.kind = METRIC_KIND_HISTOGRAM;
+        entry.p_name = histograms_name[i];
+        entry.value = histograms_arr[i].count;
+        entry.sum = histograms_arr[i].sum;
+        entry.shift = histograms_shift[i];
+        entry.p_buckets = histograms_arr[i].buckets;
+        memset(entry.quantiles, 0, sizeof(entry.quantiles));
+        visitor(&entry, p_ctx);
+    }
+
+    for (uint32_t i = 0; i < METRICS_NUM_QUANTILE_METRICS; i++)
+    {
+        entry.id = (metrics_id_t)(METRICS_FIRST_QUANTILE + i);
+        entry.kind = METRIC_KIND_QUANTILES;
+        entry.p_name = quantiles_name[i];
+        entry.value = quantile_get_count(&quantiles_arr[i][0]);
+        entry.sum = 0;
+        entry.shift = 0;
+        entry.p_buckets = NULL;
+        for (uint32_t j = 0; j < METRICS_NUM_QUANTILES; j++)
+        {
+            entry.quantiles[j] = quantile_get(&quantiles_arr[i][j]);
+        }
+        visitor(&entry, p_ctx);
+    }
+}
+
+void metrics_dump(void)
+{
+    metrics_for_each(_metrics_print, NULL);
+}
+
+#endif /* USE_METRICS */
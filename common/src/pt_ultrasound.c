@@ -0,0 +1,120 @@
+/**
+ * @file pt_ultrasound.c
+ * @brief Ranging cycle of the ultrasound sensors as a protothread.
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <string.h>
+
+/* HW dependent includes */
+#include "port_ultrasound.h"
+#include "port_system.h"
+
+/* Project includes */
+#include "pt.h"
+#include "pt_ultrasound.h"
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Compute the distance of the last echo and add it to the window. When the window is full, publish its median.
+ * The computation is the one of the ultrasound FSM (`fsm_ultrasound_store_echo()`, `fsm_ultrasound_publish_median()`).
+ *
+ * @param p_pt_ultrasound   Pointer to the instance.
+ */
+static void _pt_ultrasound_set_distance(pt_ultrasound_t *p_pt_ultrasound)
+{
+    p_pt_ultrasound->distance_idx = (uint8_t)fsm_ultrasound_store_echo(p_pt_ultrasound->ultrasound_id, p_pt_ultrasound->distance_arr, p_pt_ultrasound->distance_idx);
+    if (p_pt_ultrasound->distance_idx == 0)
+    {
+        p_pt_ultrasound->distance_cm = fsm_ultrasound_publish_median(p_pt_ultrasound->distance_arr);
+        p_pt_ultrasound->new_measurement = true;
+    }
+}
+
+/* Public functions -----------------------------------------------------------*/
+void pt_ultrasound_init(pt_ultrasound_t *p_pt_ultrasound, uint32_t ultrasound_id)
+{
+    memset(p_pt_ultrasound, 0, sizeof(pt_ultrasound_t));
+    PT_INIT(&p_pt_ultrasound->pt);
+    p_pt_ultrasound->ultrasound_id = (uint8_t)ultrasound_id;
+
+    port_ultrasound_init(ultrasound_id);
+}
+
+PT_THREAD(pt_ultrasound_run(pt_ultrasound_t *p_pt_ultrasound))
+{
+    pt_t *p_pt = &p_pt_ultrasound->pt;
+    uint32_t id = p_pt_ultrasound->ultrasound_id;
+
+    PT_BEGIN(p_pt);
+
+    // The first trigger after a power up is delayed until the sensor has settled
+    PT_WAIT_UNTIL(p_pt, p_pt_ultrasound->status && port_ultrasound_get_trigger_ready(id) && (port_ultrasound_get_settle_remaining_ms(id) == 0));
+
+    while (p_pt_ultrasound->status)
+    {
+        // Trigger
+        port_ultrasound_start_measurement(id);
+        PT_WAIT_UNTIL(p_pt, port_ultrasound_get_trigger_end(id));
+        port_ultrasound_stop_trigger_timer(id);
+        port_ultrasound_set_trigger_end(id, false);
+
+        // Echo: rising edge, falling edge and distance
+        PT_WAIT_UNTIL(p_pt, port_ultrasound_get_echo_init_tick(id) > 0);
+        PT_WAIT_UNTIL(p_pt, port_ultrasound_get_echo_received(id));
+        _pt_ultrasound_set_distance(p_pt_ultrasound);
+
+        // Next measurement period or stop
+        PT_WAIT_UNTIL(p_pt, port_ultrasound_get_trigger_ready(id) || !p_pt_ultrasound->status);
+    }
+
+    port_ultrasound_stop_ultrasound(id);
+
+    PT_END(p_pt);
+}
+
+void pt_ultrasound_start(pt_ultrasound_t *p_pt_ultrasound)
+{
+    uint32_t id = p_pt_ultrasound->ultrasound_id;
+
+    p_pt_ultrasound->status = true;
+    p_pt_ultrasound->distance_idx = 0;
+    p_pt_ultrasound->distance_cm = 0;
+
+    // The first trigger of the cycle waits for the settle time of the sensor from here
+    port_ultrasound_power_on(id);
+
+    port_ultrasound_reset_echo_ticks(id);
+    port_ultrasound_set_trigger_ready(id, true);
+
+    port_ultrasound_start_new_measurement_timer();
+}
+
+void pt_ultrasound_stop(pt_ultrasound_t *p_pt_ultrasound)
+{
+    p_pt_ultrasound->status = false;
+    port_ultrasound_stop_ultrasound(p_pt_ultrasound->ultrasound_id);
+
+    // The cycle may be blocked waiting for an echo that will not arrive: the next start begins with a new trigger
+    PT_INIT(&p_pt_ultrasound->pt);
+}
+
+uint32_t pt_ultrasound_get_distance(pt_ultrasound_t *p_pt_ultrasound)
+{
+    p_pt_ultrasound->new_measurement = false;
+    return p_pt_ultrasound->distance_cm;
+}
+
+bool pt_ultrasound_get_new_measurement_ready(pt_ultrasound_t *p_pt_ultrasound)
+{
+    return p_pt_ultrasound->new_measurement;
+}
+
+bool pt_ultrasound_get_status(pt_ultrasound_t *p_pt_ultrasound)
+{
+    return p_pt_ultrasound->status;
+}
@@ -0,0 +1,211 @@
+/**
+ * @file quantile.c
+ * @brief Streaming estimator of a quantile in fixed memory (P² algorithm) and fixed point.
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stddef.h>
+
+/* Project includes */
+#include "quantile.h"
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Desired position of a marker in Q16 for the current count: `(count - 1) * increment`, with the increments of the
+ * P² algorithm `{0, p/2, p, (1 + p)/2, 1}`.
+ *
+ * @param p_quantile    Pointer to the estimator.
+ * @param marker        Index of the marker.
+ * @return int64_t      Desired position in Q16.
+ */
+static int64_t _desired_q16(const quantile_t *p_quantile, uint32_t marker)
+{
+    static const uint32_t half[QUANTILE_NUM_MARKERS] = {0, 1, 2, 1, 2};    // Increment in units of p/2, ...
+    static const uint32_t base[QUANTILE_NUM_MARKERS] = {0, 0, 0, 1, 2};    // ... plus units of 1/2
+    uint32_t increment = (half[marker] * p_quantile->prob + base[marker] * QUANTILE_PROB_ONE) / 2U;
+    return (int64_t)(p_quantile->count - 1U) * increment;
+}
+
+/**
+ * @brief Piecewise-parabolic (P²) prediction of the height of a marker moved one position.
+ *
+ * @param q         Heights of the markers.
+ * @param n         Positions of the markers.
+ * @param i         Index of the marker (1 to 3).
+ * @param d         Direction of the move (+1 or -1).
+ * @return int64_t  Predicted height in Q8.
+ */
+static int64_t _parabolic(const int32_t *q, const uint32_t *n, uint32_t i, int32_t d)
+{
+    int64_t n_prev = n[i - 1], n_cur = n[i], n_next = n[i + 1];
+    int64_t up = (n_cur - n_prev + d) * ((int64_t)q[i + 1] - q[i]) / (n_next - n_cur);
+    int64_t down = (n_next - n_cur - d) * ((int64_t)q[i] - q[i - 1]) / (n_cur - n_prev);
+    return q[i] + (d * (up + down)) / (n_next - n_prev);
+}
+
+/**
+ * @brief Linear prediction of the height of a marker moved one position, towards its neighbour.
+ *
+ * @param q         Heights of the markers.
+ * @param n         Positions of the markers.
+ * @param i         Index of the marker (1 to 3).
+ * @param d         Direction of the move (+1 or -1).
+ * @return int64_t  Predicted height in Q8.
+ */
+static int64_t _linear(const int32_t *q, const uint32_t *n, uint32_t i, int32_t d)
+{
+    uint32_t j = (uint32_t)((int32_t)i + d);
+    return q[i] + (int64_t)d * ((int64_t)q[j] - q[i]) / ((int64_t)n[j] - n[i]);
+}
+
+/**
+ * @brief Halve the positions of the markers, keeping them strictly increasing, so the counters never overflow.
+ *
+ * @param p_quantile    Pointer to the estimator.
+ */
+static void _halve(quantile_t *p_quantile)
+{
+    uint32_t *n = p_quantile->positions;
+    for (uint32_t i = 0; i < QUANTILE_NUM_MARKERS; i++)
+    {
+        n[i] /= 2U;
+        if ((i > 0) && (n[i] <= n[i - 1]))
+        {
+            n[i] = n[i - 1] + 1U;
+        }
+    }
+    p_quantile->count = n[QUANTILE_NUM_MARKERS - 1] + 1U;
+}
+
+/* Public functions -----------------------------------------------------------*/
+void quantile_init(quantile_t *p_quantile, uint32_t prob)
+{
+    if (p_quantile == NULL)
+    {
+        return;
+    }
+    p_quantile->prob = (prob > QUANTILE_PROB_ONE) ? QUANTILE_PROB_ONE : prob;
+    p_quantile->count = 0;
+    for (uint32_t i = 0; i < QUANTILE_NUM_MARKERS; i++)
+    {
+        p_quantile->heights[i] = 0;
+        p_quantile->positions[i] = i;
+    }
+}
+
+void quantile_update(quantile_t *p_quantile, uint32_t value)
+{
+    if (p_quantile == NULL)
+    {
+        return;
+    }
+    int32_t *q = p_quantile->heights;
+    uint32_t *n = p_quantile->positions;
+    int32_t x = (int32_t)(((value > QUANTILE_MAX_VALUE) ? QUANTILE_MAX_VALUE : value) << QUANTILE_Q_BITS);
+
+    // The first samples are kept sorted: they are the initial heights of the markers
+    if (p_quantile->count < QUANTILE_NUM_MARKERS)
+    {
+        uint32_t i = p_quantile->count;
+        while ((i > 0) && (q[i - 1] > x))
+        {
+            q[i] = q[i - 1];
+            i--;
+        }
+        q[i] = x;
+        p_quantile->count++;
+        return;
+    }
+
+    // Cell of the sample, extending the extremes if needed, and shift of the markers above it
+    uint32_t k;
+    if (x < q[0])
+    {
+        q[0] = x;
+        k = 0;
+    }
+    else if (x >= q[QUANTILE_NUM_MARKERS - 1])
+    {
+        q[QUANTILE_NUM_MARKERS - 1] = x;
+        k = QUANTILE_NUM_MARKERS - 2;
+    }
+    else
+    {
+        k = 0;
+        while (x >= q[k + 1])
+        {
+            k++;
+        }
+    }
+    for (uint32_t i = k + 1; i < QUANTILE_NUM_MARKERS; i++)
+    {
+        n[i]++;
+    }
+    p_quantile->count++;
+
+    // Move the intermediate markers that are one position or more away from their desired position
+    for (uint32_t i = 1; i < QUANTILE_NUM_MARKERS - 1; i++)
+    {
+        int64_t delta = _desired_q16(p_quantile, i) - ((int64_t)n[i] << 16);
+        int32_t d;
+        if ((delta >= (int64_t)QUANTILE_PROB_ONE) && ((n[i + 1] - n[i]) > 1U))
+        {
+            d = 1;
+        }
+        else if ((delta <= -(int64_t)QUANTILE_PROB_ONE) && ((n[i] - n[i - 1]) > 1U))
+        {
+            d = -1;
+        }
+        else
+        {
+            continue;
+        }
+
+        int64_t height = _parabolic(q, n, i, d);
+        if ((height <= q[i - 1]) || (height >= q[i + 1]))
+        {
+            height = _linear(q, n, i, d);
+        }
+        q[i] = (int32_t)height;
+        n[i] = (uint32_t)((int32_t)n[i] + d);
+    }
+
+    if (p_quantile->count >= QUANTILE_MAX_COUNT)
+    {
+        _halve(p_quantile);
+    }
+}
+
+uint32_t quantile_get(const quantile_t *p_quantile)
+{
+    if ((p_quantile == NULL) || (p_quantile->count == 0))
+    {
+        return 0;
+    }
+
+    int32_t height;
+    if (p_quantile->count < QUANTILE_NUM_MARKERS)
+    {
+        // Exact quantile of the sorted samples: nearest rank
+        uint32_t rank = (uint32_t)((((uint64_t)(p_quantile->count - 1U) * p_quantile->prob) + (QUANTILE_PROB_ONE / 2U)) >> 16);
+        height = p_quantile->heights[rank];
+    }
+    else
+    {
+        height = p_quantile->heights[2];
+    }
+    return ((uint32_t)height + (1U << (QUANTILE_Q_BITS - 1))) >> QUANTILE_Q_BITS;
+}
+
+uint32_t quantile_get_count(const quantile_t *p_quantile)
+{
+    if (p_quantile == NULL)
+    {
+        return 0;
+    }
+    return p_quantile->count;
+}
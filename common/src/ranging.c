@@ -0,0 +1,138 @@
+/**
+ * @file ranging.c
+ * @brief Generic interface of the distance sensors, independent of their technology.
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stddef.h>
+#include <string.h>
+
+/* HW dependent includes */
+#include "port_system.h"
+
+/* Project includes */
+#include "ranging.h"
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Finish the measurement in progress of a device with a result.
+ *
+ * @param p_device  Pointer to the device.
+ * @param p_result  Result of the measurement. Its timestamp is set here.
+ */
+static void _ranging_complete(ranging_device_t *p_device, const ranging_result_t *p_result)
+{
+    p_device->result = *p_result;
+    p_device->result.timestamp_ms = port_system_get_millis();
+    p_device->has_result = true;
+    p_device->busy = false;
+}
+
+/* Public functions -----------------------------------------------------------*/
+void ranging_init(ranging_device_t *p_device, const ranging_backend_t *p_backend, uint32_t sensor_id)
+{
+    memset(p_device, 0, sizeof(ranging_device_t));
+    p_device->p_backend = p_backend;
+    p_device->sensor_id = (uint8_t)sensor_id;
+
+    if (p_backend->p_init != NULL)
+    {
+        p_backend->p_init(sensor_id);
+    }
+}
+
+void ranging_enable(ranging_device_t *p_device)
+{
+    p_device->enabled = true;
+    p_device->busy = false;
+    p_device->has_result = false;
+
+    if (p_device->p_backend->p_enable != NULL)
+    {
+        p_device->p_backend->p_enable(p_device->sensor_id);
+    }
+}
+
+void ranging_disable(ranging_device_t *p_device)
+{
+    p_device->enabled = false;
+    p_device->busy = false;
+
+    if (p_device->p_backend->p_disable != NULL)
+    {
+        p_device->p_backend->p_disable(p_device->sensor_id);
+    }
+}
+
+bool ranging_start(ranging_device_t *p_device)
+{
+    if (!p_device->enabled || p_device->busy || !p_device->p_backend->p_start(p_device->sensor_id))
+    {
+        return false;
+    }
+    p_device->busy = true;
+    p_device->start_ms = port_system_get_millis();
+    return true;
+}
+
+bool ranging_poll(ranging_device_t *p_device)
+{
+    if (!p_device->busy)
+    {
+        return false;
+    }
+
+    ranging_result_t result = {0};
+    if (p_device->p_backend->p_poll(p_device->sensor_id, &result))
+    {
+        _ranging_complete(p_device, &result);
+        return true;
+    }
+
+    if ((port_system_get_millis() - p_device->start_ms) >= p_device->p_backend->timeout_ms)
+    {
+        // Abort the measurement and leave the sensor ready for the next one
+        if (p_device->p_backend->p_disable != NULL)
+        {
+            p_device->p_backend->p_disable(p_device->sensor_id);
+        }
+        if (p_device->p_backend->p_enable != NULL)
+        {
+            p_device->p_backend->p_enable(p_device->sensor_id);
+        }
+        result.distance_cm = 0;
+        result.confidence_pct = 0;
+        _ranging_complete(p_device, &result);
+        return true;
+    }
+    return false;
+}
+
+bool ranging_get_busy(const ranging_device_t *p_device)
+{
+    return p_device->busy;
+}
+
+bool ranging_get_result(const ranging_device_t *p_device, ranging_result_t *p_result)
+{
+    if (!p_device->has_result)
+    {
+        return false;
+    }
+    *p_result = p_device->result;
+    return true;
+}
+
+uint32_t ranging_get_distance_cm(const ranging_device_t *p_device)
+{
+    return p_device->has_result ? p_device->result.distance_cm : 0;
+}
+
+uint32_t ranging_get_confidence_pct(const ranging_device_t *p_device)
+{
+    return p_device->has_result ? p_device->result.confidence_pct : 0;
+}
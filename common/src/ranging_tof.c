@@ -0,0 +1,64 @@
+/**
+ * @file ranging_tof.c
+ * @brief Backend of the ranging interface for the time-of-flight (ToF) sensors.
+ *
+ * The sensor reports its own range status and the rate of the return signal: the confidence of a valid range grows with the
+ * signal rate, up to `RANGING_TOF_FULL_CONFIDENCE_KCPS`. An invalid range (no target, weak signal, failure of the bus) has
+ * confidence 0.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stddef.h>
+
+/* HW dependent includes */
+#include "port_tof.h"
+
+/* Project includes */
+#include "ranging.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define RANGING_TOF_FULL_CONFIDENCE_KCPS 1000U  /*!<    Signal rate in kcps from which a valid range has full confidence */
+#define RANGING_TOF_TIMEOUT_MS 100U             /*!<    Maximum duration of a measurement: ranging (about 33 ms by default) and the transfers of the bus */
+
+/* Private functions -----------------------------------------------------------*/
+static void _ranging_tof_init(uint32_t sensor_id)
+{
+    (void)port_tof_init(sensor_id);
+}
+
+static bool _ranging_tof_poll(uint32_t sensor_id, ranging_result_t *p_result)
+{
+    if (!port_tof_get_measurement_ready(sensor_id))
+    {
+        return false;
+    }
+    port_tof_set_measurement_ready(sensor_id, false);
+
+    if (port_tof_get_range_valid(sensor_id))
+    {
+        uint32_t kcps = port_tof_get_signal_rate_kcps(sensor_id);
+        p_result->distance_cm = (port_tof_get_distance_mm(sensor_id) + 5U) / 10U;
+        p_result->confidence_pct = (kcps >= RANGING_TOF_FULL_CONFIDENCE_KCPS) ? RANGING_CONFIDENCE_MAX : ((kcps * RANGING_CONFIDENCE_MAX) / RANGING_TOF_FULL_CONFIDENCE_KCPS);
+    }
+    else
+    {
+        p_result->distance_cm = 0;
+        p_result->confidence_pct = 0;
+    }
+    return true;
+}
+
+/* Public variables -----------------------------------------------------------*/
+const ranging_backend_t ranging_tof_backend = {
+    .p_init = _ranging_tof_init,
+    .p_enable = NULL,
+    .p_disable = port_tof_stop,
+    .p_start = port_tof_start_measurement,
+    .p_poll = _ranging_tof_poll,
+    .timeout_ms = RANGING_TOF_TIMEOUT_MS,
+};
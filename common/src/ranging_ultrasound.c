@@ -0,0 +1,89 @@
+/**
+ * @file ranging_ultrasound.c
+ * @brief Backend of the ranging interface for the ultrasound sensors.
+ *
+ * A measurement is the trigger of the sensor and the timing of its echo, as in the ultrasound FSM, without the window of
+ * the median: each echo is a result. The measurement timer of the port keeps pacing the triggers, so a measurement can only
+ * start when the period of the previous one has elapsed. If the period elapses again without an echo, there is no target
+ * in range.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* HW dependent includes */
+#include "port_ultrasound.h"
+
+/* Project includes */
+#include "ranging.h"
+#include "metrics.h"
+#include "dsp_kernels.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define RANGING_ULTRASOUND_MAX_RANGE_CM 400U    /*!<    Maximum distance measured by the sensor. Longer echoes are reflections or noise */
+
+/* Private functions -----------------------------------------------------------*/
+static void _ranging_ultrasound_enable(uint32_t sensor_id)
+{
+    port_ultrasound_power_on(sensor_id);
+    port_ultrasound_reset_echo_ticks(sensor_id);
+    port_ultrasound_set_trigger_ready(sensor_id, true);
+    port_ultrasound_start_new_measurement_timer();
+}
+
+static bool _ranging_ultrasound_start(uint32_t sensor_id)
+{
+    if (!port_ultrasound_get_trigger_ready(sensor_id) || (port_ultrasound_get_settle_remaining_ms(sensor_id) > 0))
+    {
+        return false;
+    }
+    port_ultrasound_start_measurement(sensor_id);
+    return true;
+}
+
+static bool _ranging_ultrasound_poll(uint32_t sensor_id, ranging_result_t *p_result)
+{
+    if (port_ultrasound_get_trigger_end(sensor_id))
+    {
+        port_ultrasound_stop_trigger_timer(sensor_id);
+        port_ultrasound_set_trigger_end(sensor_id, false);
+    }
+
+    if (port_ultrasound_get_echo_received(sensor_id))
+    {
+        uint32_t ticks = dsp_echo_ticks(port_ultrasound_get_echo_init_tick(sensor_id),
+                                        port_ultrasound_get_echo_end_tick(sensor_id),
+                                        port_ultrasound_get_echo_overflows(sensor_id));
+        metrics_counter_inc(METRIC_ULTRASOUND_MEASUREMENTS);
+        metrics_histogram_record(METRIC_ULTRASOUND_ECHO_US, ticks);
+
+        p_result->distance_cm = dsp_ticks_to_cm(ticks);
+        p_result->confidence_pct = (p_result->distance_cm <= RANGING_ULTRASOUND_MAX_RANGE_CM) ? RANGING_CONFIDENCE_MAX : 0;
+    }
+    else if (port_ultrasound_get_trigger_ready(sensor_id))
+    {
+        // A whole measurement period without echo: no target in range
+        p_result->distance_cm = 0;
+        p_result->confidence_pct = 0;
+    }
+    else
+    {
+        return false;
+    }
+
+    port_ultrasound_stop_echo_timer(sensor_id);
+    port_ultrasound_reset_echo_ticks(sensor_id);
+    return true;
+}
+
+/* Public variables -----------------------------------------------------------*/
+const ranging_backend_t ranging_ultrasound_backend = {
+    .p_init = port_ultrasound_init,
+    .p_enable = _ranging_ultrasound_enable,
+    .p_disable = port_ultrasound_stop_ultrasound,
+    .p_start = _ranging_ultrasound_start,
+    .p_poll = _ranging_ultrasound_poll,
+    .timeout_ms = 2 * PORT_PARKING_SENSOR_STANDBY_PERIOD_MS,
+};
@@ -0,0 +1,246 @@
+/**
+ * @file scheduler.c
+ * @brief Cooperative earliest-deadline-first (EDF) scheduler of the FSMs and the background jobs.
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <string.h>
+
+/* HW dependent includes */
+#include "port_system.h"
+
+/* Project includes */
+#include "scheduler.h"
+#include "metrics.h"
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure of a task of the scheduler.
+ */
+typedef struct
+{
+    const char *p_name;         /*!<    Name of the task*/
+    scheduler_job_t job;        /*!<    Function executed by the task*/
+    void *p_ctx;                /*!<    User context passed to the function*/
+    uint32_t period_ms;         /*!<    Period in ms. 0 if the task is released once per round*/
+    uint32_t deadline_ms;       /*!<    Relative deadline in ms*/
+    uint32_t release_ms;        /*!<    Time of the current or next release of a periodic task*/
+    uint32_t abs_deadline_ms;   /*!<    Absolute deadline of the current release*/
+    bool released;              /*!<    Flag to indicate that the task is released and waiting to be executed*/
+    scheduler_stats_t stats;    /*!<    Statistics of the executions*/
+} scheduler_task_t;
+
+/* Global variables */
+static scheduler_task_t tasks_arr[SCHEDULER_MAX_TASKS];    /*!<    Tasks of the scheduler*/
+static uint32_t num_tasks;                                  /*!<    Number of tasks of the scheduler*/
+static uint32_t total_misses;                               /*!<    Number of deadline misses of all the tasks*/
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Check if a time is before another one. It is valid when the system tick wraps around.
+ *
+ * @param a         First time in ms.
+ * @param b         Second time in ms.
+ * @return true     If `a` is before `b`.
+ * @return false    Otherwise.
+ */
+static bool _time_before(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) < 0;
+}
+
+/**
+ * @brief Release the periodic tasks whose release time has arrived.
+ *
+ * @param now   Current time in ms.
+ */
+static void _release_periodic(uint32_t now)
+{
+    for (uint32_t i = 0; i < num_tasks; i++)
+    {
+        scheduler_task_t *p_task = &tasks_arr[i];
+        if ((p_task->period_ms != 0) && !p_task->released && !_time_before(now, p_task->release_ms))
+        {
+            p_task->released = true;
+            p_task->abs_deadline_ms = p_task->release_ms + p_task->deadline_ms;
+        }
+    }
+}
+
+/**
+ * @brief Start a new round: release the tasks with period 0 that are not released yet.
+ *
+ * @param now       Current time in ms.
+ * @return true     If any task has been released.
+ * @return false    If the scheduler has no task with period 0 waiting.
+ */
+static bool _start_round(uint32_t now)
+{
+    bool any = false;
+    for (uint32_t i = 0; i < num_tasks; i++)
+    {
+        scheduler_task_t *p_task = &tasks_arr[i];
+        if ((p_task->period_ms == 0) && !p_task->released)
+        {
+            p_task->released = true;
+            p_task->abs_deadline_ms = now + p_task->deadline_ms;
+            any = true;
+        }
+    }
+    return any;
+}
+
+/**
+ * @brief Get the released task with the earliest absolute deadline. In case of a tie, the one added first.
+ *
+ * @return int32_t  Identifier of the task, or `SCHEDULER_INVALID_TASK_ID` if no task is released.
+ */
+static int32_t _earliest_released(void)
+{
+    int32_t earliest = SCHEDULER_INVALID_TASK_ID;
+    for (uint32_t i = 0; i < num_tasks; i++)
+    {
+        scheduler_task_t *p_task = &tasks_arr[i];
+        if (p_task->released && ((earliest == SCHEDULER_INVALID_TASK_ID) || _time_before(p_task->abs_deadline_ms, tasks_arr[earliest].abs_deadline_ms)))
+        {
+            earliest = (int32_t)i;
+        }
+    }
+    return earliest;
+}
+
+/**
+ * @brief Execute a released task, update its statistics and compute its next release.
+ *
+ * @param p_task    Pointer to the task.
+ */
+static void _run_task(scheduler_task_t *p_task)
+{
+    p_task->released = false;
+
+    uint32_t start = port_system_get_millis();
+    p_task->job(p_task->p_ctx);
+    uint32_t end = port_system_get_millis();
+
+    p_task->stats.runs++;
+    metrics_quantile_record(METRIC_SCHEDULER_EXEC_Q, end - start);
+    if ((end - start) > p_task->stats.max_exec_ms)
+    {
+        p_task->stats.max_exec_ms = end - start;
+    }
+    if (_time_before(p_task->abs_deadline_ms, end))
+    {
+        uint32_t lateness = end - p_task->abs_deadline_ms;
+        p_task->stats.misses++;
+        if (lateness > p_task->stats.max_lateness_ms)
+        {
+            p_task->stats.max_lateness_ms = lateness;
+        }
+        total_misses++;
+        metrics_counter_inc(METRIC_SCHEDULER_DEADLINE_MISSES);
+    }
+
+    if (p_task->period_ms != 0)
+    {
+        p_task->release_ms += p_task->period_ms;
+        // If the task is more than a period behind, the releases that have been lost are skipped
+        if (!_time_before(end, p_task->release_ms + p_task->period_ms))
+        {
+            p_task->release_ms = end;
+        }
+    }
+}
+
+/* Public functions -----------------------------------------------------------*/
+void scheduler_init(void)
+{
+    memset(tasks_arr, 0, sizeof(tasks_arr));
+    num_tasks = 0;
+    total_misses = 0;
+}
+
+int32_t scheduler_add_task(const char *p_name, scheduler_job_t job, void *p_ctx, uint32_t period_ms, uint32_t deadline_ms)
+{
+    if ((num_tasks >= SCHEDULER_MAX_TASKS) || (job == NULL) || ((period_ms == 0) && (deadline_ms == 0)))
+    {
+        return SCHEDULER_INVALID_TASK_ID;
+    }
+
+    scheduler_task_t *p_task = &tasks_arr[num_tasks];
+    memset(p_task, 0, sizeof(scheduler_task_t));
+    p_task->p_name = p_name;
+    p_task->job = job;
+    p_task->p_ctx = p_ctx;
+    p_task->period_ms = period_ms;
+    p_task->deadline_ms = (deadline_ms != 0) ? deadline_ms : period_ms;
+    p_task->release_ms = port_system_get_millis();
+
+    return (int32_t)num_tasks++;
+}
+
+bool scheduler_run_next(void)
+{
+    _release_periodic(port_system_get_millis());
+
+    int32_t task_id = _earliest_released();
+    if ((task_id == SCHEDULER_INVALID_TASK_ID) && _start_round(port_system_get_millis()))
+    {
+        task_id = _earliest_released();
+    }
+    if (task_id == SCHEDULER_INVALID_TASK_ID)
+    {
+        return false;
+    }
+
+    _run_task(&tasks_arr[task_id]);
+    return true;
+}
+
+uint32_t scheduler_run_round(void)
+{
+    uint32_t runs = 0;
+    _start_round(port_system_get_millis());
+
+    while (true)
+    {
+        _release_periodic(port_system_get_millis());
+        int32_t task_id = _earliest_released();
+        if (task_id == SCHEDULER_INVALID_TASK_ID)
+        {
+            break;
+        }
+        _run_task(&tasks_arr[task_id]);
+        runs++;
+    }
+    return runs;
+}
+
+void scheduler_get_stats(int32_t task_id, scheduler_stats_t *p_stats)
+{
+    if ((task_id < 0) || ((uint32_t)task_id >= num_tasks) || (p_stats == NULL))
+    {
+        return;
+    }
+    *p_stats = tasks_arr[task_id].stats;
+}
+
+uint32_t scheduler_get_total_misses(void)
+{
+    return total_misses;
+}
+
+void scheduler_dump(void)
+{
+    for (uint32_t i = 0; i < num_tasks; i++)
+    {
+        scheduler_task_t *p_task = &tasks_arr[i];
+        printf("[SCHEDULER] %s: period %lu ms, deadline %lu ms, runs %lu, misses %lu, max lateness %lu ms, max exec %lu ms\n",
+               p_task->p_name, (unsigned long)p_task->period_ms, (unsigned long)p_task->deadline_ms, (unsigned long)p_task->stats.runs,
+               (unsigned long)p_task->stats.misses, (unsigned long)p_task->stats.max_lateness_ms, (unsigned long)p_task->stats.max_exec_ms);
+    }
+}
@@ -0,0 +1,267 @@
+/**
+ * @file text_fmt.c
+ * @brief Allocation-free and reentrant text formatter for the diagnostics.
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stddef.h>
+
+/* Project includes */
+#include "text_fmt.h"
+
+/* Defines --------------------------------------------------------------------*/
+#define TEXT_FMT_MAX_DIGITS 20  /*!<    Maximum number of digits of an `unsigned long` in base 10 (64 bits on the host) @hideinitializer */
+
+_Static_assert((TEXT_FMT_RING_LEN & (TEXT_FMT_RING_LEN - 1)) == 0, "TEXT_FMT_RING_LEN must be a power of 2");
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Output of a call: the next character and the last position before the terminator.
+ */
+typedef struct
+{
+    char *p_next;       /*!<    Position of the next character*/
+    char *p_last;       /*!<    Position reserved for the terminator*/
+} text_fmt_out_t;
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Write a character if it fits.
+ *
+ * @param p_out     Pointer to the output.
+ * @param c         Character.
+ */
+static inline void _put_char(text_fmt_out_t *p_out, char c)
+{
+    if (p_out->p_next < p_out->p_last)
+    {
+        *p_out->p_next++ = c;
+    }
+}
+
+/**
+ * @brief Write an unsigned number. The digits are computed from the least significant one into a local buffer.
+ *
+ * @param p_out     Pointer to the output.
+ * @param value     Number.
+ * @param base      Base: 10 or 16.
+ */
+static void _put_unsigned(text_fmt_out_t *p_out, unsigned long value, uint32_t base)
+{
+    static const char digits_arr[] = "0123456789abcdef";
+    char digits[TEXT_FMT_MAX_DIGITS];
+    uint32_t n = 0;
+    do
+    {
+        digits[n++] = digits_arr[value % base];
+        value /= base;
+    } while (value != 0);
+
+    while (n > 0)
+    {
+        _put_char(p_out, digits[--n]);
+    }
+}
+
+/**
+ * @brief Write a signed number. The magnitude of the minimum value does not overflow, as it is computed as unsigned.
+ *
+ * @param p_out     Pointer to the output.
+ * @param value     Number.
+ */
+static void _put_signed(text_fmt_out_t *p_out, long value)
+{
+    unsigned long magnitude = (unsigned long)value;
+    if (value < 0)
+    {
+        _put_char(p_out, '-');
+        magnitude = 0UL - magnitude;
+    }
+    _put_unsigned(p_out, magnitude, 10);
+}
+
+/* Public functions -----------------------------------------------------------*/
+uint32_t text_fmt_va(char *p_buf, uint32_t size, const char *p_format, va_list args)
+{
+    if ((p_buf == NULL) || (size == 0))
+    {
+        return 0;
+    }
+    text_fmt_out_t out = {p_buf, p_buf + size - 1};
+    if (p_format == NULL)
+    {
+        *p_buf = '\0';
+        return 0;
+    }
+
+    // Stop at the end of the format or when the buffer is full, whatever comes first
+    while ((*p_format != '\0') && (out.p_next < out.p_last))
+    {
+        char c = *p_format++;
+        if (c != '%')
+        {
+            _put_char(&out, c);
+            continue;
+        }
+
+        bool is_long = (*p_format == 'l');
+        if (is_long)
+        {
+            p_format++;
+        }
+
+        char conv = *p_format;
+        if (conv == '\0')
+        {
+            // Incomplete conversion at the end of the format: copied as it is
+            _put_char(&out, '%');
+            if (is_long)
+            {
+                _put_char(&out, 'l');
+            }
+            break;
+        }
+        p_format++;
+
+        switch (conv)
+        {
+        case 'd':
+        case 'i':
+            _put_signed(&out, is_long ? va_arg(args, long) : (long)va_arg(args, int));
+            break;
+        case 'u':
+            _put_unsigned(&out, is_long ? va_arg(args, unsigned long) : (unsigned long)va_arg(args, unsigned int), 10);
+            break;
+        case 'x':
+            _put_unsigned(&out, is_long ? va_arg(args, unsigned long) : (unsigned long)va_arg(args, unsigned int), 16);
+            break;
+        case 's':
+        {
+            const char *p_str = va_arg(args, const char *);
+            if (p_str == NULL)
+            {
+                p_str = "(null)";
+            }
+            while ((*p_str != '\0') && (out.p_next < out.p_last))
+            {
+                *out.p_next++ = *p_str++;
+            }
+            break;
+        }
+        case 'c':
+            _put_char(&out, (char)va_arg(args, int));
+            break;
+        case '%':
+            _put_char(&out, '%');
+            break;
+        default:
+            // Unsupported conversion: copied as it is, without consuming an argument
+            _put_char(&out, '%');
+            if (is_long)
+            {
+                _put_char(&out, 'l');
+            }
+            _put_char(&out, conv);
+            break;
+        }
+    }
+
+    *out.p_next = '\0';
+    return (uint32_t)(out.p_next - p_buf);
+}
+
+uint32_t text_fmt(char *p_buf, uint32_t size, const char *p_format, ...)
+{
+    va_list args;
+    va_start(args, p_format);
+    uint32_t len = text_fmt_va(p_buf, size, p_format, args);
+    va_end(args);
+    return len;
+}
+
+void text_fmt_ring_init(text_fmt_ring_t *p_ring)
+{
+    if (p_ring == NULL)
+    {
+        return;
+    }
+    p_ring->head = 0;
+    p_ring->tail = 0;
+    p_ring->overruns = 0;
+    for (uint32_t i = 0; i < TEXT_FMT_RING_LEN; i++)
+    {
+        p_ring->ready[i] = false;
+    }
+}
+
+bool text_fmt_ring_printf(text_fmt_ring_t *p_ring, const char *p_format, ...)
+{
+    if (p_ring == NULL)
+    {
+        return false;
+    }
+
+    // Reserve a slot. The compare-and-swap (LDREX/STREX) only fails if another context has reserved one in between, so the
+    // number of retries is bounded by the number of preemptions
+    uint32_t tail = __atomic_load_n(&p_ring->tail, __ATOMIC_RELAXED);
+    do
+    {
+        if (tail - __atomic_load_n(&p_ring->head, __ATOMIC_ACQUIRE) >= TEXT_FMT_RING_LEN)
+        {
+            __atomic_fetch_add(&p_ring->overruns, 1, __ATOMIC_RELAXED);
+            return false;
+        }
+    } while (!__atomic_compare_exchange_n(&p_ring->tail, &tail, tail + 1, true, __ATOMIC_ACQ_REL, __ATOMIC_RELAXED));
+
+    // The slot is owned by this call until it is marked as ready
+    uint32_t slot = tail & (TEXT_FMT_RING_LEN - 1);
+    va_list args;
+    va_start(args, p_format);
+    text_fmt_va(p_ring->lines[slot], TEXT_FMT_LINE_LEN, p_format, args);
+    va_end(args);
+
+    __atomic_store_n(&p_ring->ready[slot], true, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool text_fmt_ring_pop(text_fmt_ring_t *p_ring, char *p_line, uint32_t size)
+{
+    if ((p_ring == NULL) || (p_line == NULL) || (size == 0))
+    {
+        return false;
+    }
+
+    uint32_t head = __atomic_load_n(&p_ring->head, __ATOMIC_RELAXED);
+    uint32_t slot = head & (TEXT_FMT_RING_LEN - 1);
+    if ((head == __atomic_load_n(&p_ring->tail, __ATOMIC_RELAXED)) || !__atomic_load_n(&p_ring->ready[slot], __ATOMIC_ACQUIRE))
+    {
+        return false;
+    }
+
+    const char *p_src = p_ring->lines[slot];
+    uint32_t i = 0;
+    while ((p_src[i] != '\0') && (i < size - 1))
+    {
+        p_line[i] = p_src[i];
+        i++;
+    }
+    p_line[i] = '\0';
+
+    // Free the slot: a producer only reserves it again once the new head is visible
+    __atomic_store_n(&p_ring->ready[slot], false, __ATOMIC_RELAXED);
+    __atomic_store_n(&p_ring->head, head + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+uint32_t text_fmt_ring_get_overruns(text_fmt_ring_t *p_ring)
+{
+    if (p_ring == NULL)
+    {
+        return 0;
+    }
+    return p_ring->overruns;
+}
@@ -0,0 +1,143 @@
+/**
+ * @file example_dsp_benchmark.c
+ * @brief Benchmark of the arithmetic kernels of the per-measurement path.
+ *
+ * It measures with the cycle counter of the core the average number of cycles of each kernel (`dsp_xxx()`), of its portable C
+ * reference (`dsp_xxx_c()`) and of the code that the FSMs used before the kernels (`qsort()` and the 64-bit division).
+ * The results are printed by semihosting.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "dsp_kernels.h"
+#include "fsm_ultrasound.h"
+#include "port_system.h"
+#include "stm32f4_system.h"
+
+/* Defines */
+#define BENCHMARK_ITERATIONS 1000   /*!< Number of calls averaged in each measurement @hideinitializer */
+
+/* Global variables */
+static volatile uint32_t sink;  /*!< Destination of the results, so the compiler does not remove the calls */
+static uint32_t window[FSM_ULTRASOUND_NUM_MEASUREMENTS] = {172, 168, 1715, 170, 0};  /*!< Window of distances with two outliers */
+
+/**
+ * @brief Comparison function of the former median based on `qsort()`.
+ */
+static int _compare(const void *a, const void *b)
+{
+    return (*(uint32_t *)a - *(uint32_t *)b);
+}
+
+/**
+ * @brief Median computed as the ultrasound FSM did before the kernels: sorting the window in place with `qsort()`.
+ */
+static uint32_t _median_qsort(const uint32_t *p_values, uint32_t n)
+{
+    uint32_t sorted[FSM_ULTRASOUND_NUM_MEASUREMENTS];
+    for (uint32_t i = 0; i < n; i++)
+    {
+        sorted[i] = p_values[i];
+    }
+    qsort(sorted, n, sizeof(uint32_t), _compare);
+    return sorted[n / 2];
+}
+
+/**
+ * @brief Print the average number of cycles of a measurement.
+ */
+static void _print_cycles(const char *p_name, uint32_t cycles, uint32_t overhead)
+{
+    printf("%-24s %5ld cycles\n", p_name, (cycles - overhead) / BENCHMARK_ITERATIONS);
+}
+
+int main(void)
+{
+    port_system_init();
+    stm32f4_system_cycle_counter_init();
+
+    uint32_t start;
+    uint32_t overhead;
+    uint32_t rgb_1 = DSP_RGB_PACK(255, 0, 0);
+    uint32_t rgb_2 = DSP_RGB_PACK(94, 94, 0);
+
+    printf("DSP kernels benchmark. Core clock: %ld Hz\n", SystemCoreClock);
+
+    // Cost of the loop and the store, subtracted from every measurement
+    start = stm32f4_system_get_cycles();
+    for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        sink = i;
+    }
+    overhead = stm32f4_system_get_cycles() - start;
+
+    start = stm32f4_system_get_cycles();
+    for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        sink = dsp_blend_rgb(rgb_1, rgb_2, (uint8_t)i);
+    }
+    _print_cycles("dsp_blend_rgb", stm32f4_system_get_cycles() - start, overhead);
+
+    start = stm32f4_system_get_cycles();
+    for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        sink = dsp_blend_rgb_c(rgb_1, rgb_2, (uint8_t)i);
+    }
+    _print_cycles("dsp_blend_rgb_c", stm32f4_system_get_cycles() - start, overhead);
+
+    start = stm32f4_system_get_cycles();
+    for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        sink = dsp_ticks_to_cm(i * 97);
+    }
+    _print_cycles("dsp_ticks_to_cm", stm32f4_system_get_cycles() - start, overhead);
+
+    start = stm32f4_system_get_cycles();
+    for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        sink = dsp_ticks_to_cm_c(i * 97);
+    }
+    _print_cycles("dsp_ticks_to_cm_c", stm32f4_system_get_cycles() - start, overhead);
+
+    start = stm32f4_system_get_cycles();
+    for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        window[i % FSM_ULTRASOUND_NUM_MEASUREMENTS] += 1;
+        sink = dsp_median_u32(window, FSM_ULTRASOUND_NUM_MEASUREMENTS);
+    }
+    _print_cycles("dsp_median_u32", stm32f4_system_get_cycles() - start, overhead);
+
+    start = stm32f4_system_get_cycles();
+    for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        window[i % FSM_ULTRASOUND_NUM_MEASUREMENTS] += 1;
+        sink = dsp_median_u32_c(window, FSM_ULTRASOUND_NUM_MEASUREMENTS);
+    }
+    _print_cycles("dsp_median_u32_c", stm32f4_system_get_cycles() - start, overhead);
+
+    start = stm32f4_system_get_cycles();
+    for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        window[i % FSM_ULTRASOUND_NUM_MEASUREMENTS] += 1;
+        sink = _median_qsort(window, FSM_ULTRASOUND_NUM_MEASUREMENTS);
+    }
+    _print_cycles("median (qsort)", stm32f4_system_get_cycles() - start, overhead);
+
+    start = stm32f4_system_get_cycles();
+    for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)
+    {
+        window[i % FSM_ULTRASOUND_NUM_MEASUREMENTS] += 1;
+        sink = dsp_mean_u32(window, FSM_ULTRASOUND_NUM_MEASUREMENTS);
+    }
+    _print_cycles("dsp_mean_u32", stm32f4_system_get_cycles() - start, overhead);
+
+    while (1)
+    {
+    }
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+/**
+ * @file example_irq_latency.c
+ * @brief Measurement of the worst-case interrupt latency of the ISRs that timestamp the events of the system.
+ *
+ * Each ISR (`SysTick_Handler`, `EXTI15_10_IRQHandler` and `TIM2_IRQHandler`) is pended by software many times and the probe
+ * at its first statement records the cycles from the pend to the ISR. Two cases are measured:
+ * - Warm: the ISR has just been executed, so its code is in the flash cache (ART accelerator).
+ * - Cold: the flash cache is invalidated before each pend, which is the worst case of an ISR executed from flash.
+ * Build it twice, with `-DUSE_RAMFUNC=true` and `-DUSE_RAMFUNC=false`, to compare the ISRs in SRAM with the ISRs in flash.
+ * It requires `-DUSE_IRQ_LATENCY=true`. The results are printed by semihosting.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "port_system.h"
+#include "stm32f4_system.h"
+
+/* Defines */
+#define LATENCY_ITERATIONS 1000     /*!< Number of pends of each ISR in each case @hideinitializer */
+#define LATENCY_IRQ_PRIORITY 1      /*!< Priority of the peripheral interrupts during the measurement @hideinitializer */
+
+#ifdef USE_IRQ_LATENCY
+/* ISRs of interr.c */
+extern void SysTick_Handler(void);
+extern void EXTI15_10_IRQHandler(void);
+extern void TIM2_IRQHandler(void);
+
+/**
+ * @brief Measure the latency of an interrupt and print the minimum and maximum cycles.
+ *
+ * @param p_name    Name of the ISR.
+ * @param irqn      Interrupt to pend.
+ * @param p_isr     Address of the ISR, to show whether it is in SRAM or in flash.
+ * @param cold      Invalidate the flash cache before each pend.
+ */
+static void _measure(const char *p_name, IRQn_Type irqn, void (*p_isr)(void), bool cold)
+{
+    // First pend out of the measurement, so the warm case starts with the ISR in the flash cache
+    stm32f4_system_irq_latency_reset();
+    stm32f4_system_irq_latency_trigger(irqn);
+    while (stm32f4_irq_latency.count == 0)
+    {
+    }
+    stm32f4_system_irq_latency_reset();
+
+    for (uint32_t i = 0; i < LATENCY_ITERATIONS; i++)
+    {
+        uint32_t count = stm32f4_irq_latency.count;
+        if (cold)
+        {
+            stm32f4_system_flash_cache_flush();
+        }
+        stm32f4_system_irq_latency_trigger(irqn);
+        while (stm32f4_irq_latency.count == count)
+        {
+        }
+    }
+
+    uint32_t address = (uint32_t)(uintptr_t)p_isr;
+    printf("%-22s @ 0x%08lx (%s) | %s: min %3ld, max %3ld cycles\n", p_name, address, (address >= SRAM1_BASE) ? "SRAM" : "flash",
+           cold ? "cold" : "warm", stm32f4_irq_latency.min, stm32f4_irq_latency.max);
+}
+#endif
+
+int main(void)
+{
+    port_system_init();
+
+    printf("Interrupt latency. Core clock: %ld Hz, flash latency: %ld WS\n", SystemCoreClock, (uint32_t)(FLASH->ACR & FLASH_ACR_LATENCY));
+
+#ifdef USE_IRQ_LATENCY
+    NVIC_SetPriority(EXTI15_10_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), LATENCY_IRQ_PRIORITY, 0));
+    NVIC_EnableIRQ(EXTI15_10_IRQn);
+    NVIC_SetPriority(TIM2_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), LATENCY_IRQ_PRIORITY, 0));
+    NVIC_EnableIRQ(TIM2_IRQn);
+
+    for (uint32_t cold = 0; cold < 2; cold++)
+    {
+        _measure("SysTick_Handler", SysTick_IRQn, SysTick_Handler, cold);
+        _measure("EXTI15_10_IRQHandler", EXTI15_10_IRQn, EXTI15_10_IRQHandler, cold);
+        _measure("TIM2_IRQHandler", TIM2_IRQn, TIM2_IRQHandler, cold);
+    }
+
+    NVIC_DisableIRQ(TIM2_IRQn);
+    NVIC_DisableIRQ(EXTI15_10_IRQn);
+#else
+    printf("The latency probes are not compiled. Build with -DUSE_IRQ_LATENCY=true\n");
+#endif
+
+    while (1)
+    {
+    }
+
+    return 0;
+}
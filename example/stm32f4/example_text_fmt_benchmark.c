@@ -0,0 +1,104 @@
+/**
+ * @file example_text_fmt_benchmark.c
+ * @brief Benchmark of the text formatter of the diagnostics (`text_fmt()`) against newlib `snprintf()`, in cycles and in flash.
+ *
+ * It formats the messages of the FSMs and measures the minimum and maximum cycles of a call with the cycle counter of the core.
+ * The results are formatted by `text_fmt()` and sent with `puts()`, so newlib `printf()` is only linked when it is measured:
+ * - Default build: only `text_fmt()`.
+ * - Build with `-DCMAKE_C_FLAGS=-DBENCHMARK_NEWLIB`: also `snprintf()`.
+ * The difference of `arm-none-eabi-size` of both builds is the flash of the newlib formatter (`_vfprintf_r()`, `_dtoa_r()`,
+ * `_malloc_r()`, locale and `_reent` data). The results are printed by semihosting.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+#include <stdio.h>
+
+#include "port_system.h"
+#include "stm32f4_system.h"
+#include "text_fmt.h"
+
+/* Defines */
+#define BENCHMARK_ITERATIONS 200    /*!< Number of calls of each measurement @hideinitializer */
+
+/* Typedefs */
+/**
+ * @brief Minimum and maximum cycles of a call.
+ */
+typedef struct
+{
+    uint32_t min;   /*!< Minimum cycles */
+    uint32_t max;   /*!< Maximum cycles */
+} bench_cycles_t;
+
+/* Global variables */
+static volatile uint32_t sink;          /*!< Destination of the results, so the compiler does not remove the calls */
+static char buf[TEXT_FMT_LINE_LEN];     /*!< Output of the formatters */
+static char line[TEXT_FMT_LINE_LEN];    /*!< Line of the report */
+
+/**
+ * @brief Record the cycles of a call.
+ */
+static void _record(bench_cycles_t *p_cycles, uint32_t cycles)
+{
+    p_cycles->min = (cycles < p_cycles->min) ? cycles : p_cycles->min;
+    p_cycles->max = (cycles > p_cycles->max) ? cycles : p_cycles->max;
+}
+
+#ifdef BENCHMARK_NEWLIB
+/**
+ * @brief Measure a message with newlib `snprintf()`.
+ * @hideinitializer
+ */
+#define BENCHMARK_NEWLIB_CASE(p_cycles, ...)                                            \
+    for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)                                 \
+    {                                                                                   \
+        uint32_t start = stm32f4_system_get_cycles();                                   \
+        sink = (uint32_t)snprintf(buf, sizeof(buf), __VA_ARGS__);                       \
+        _record((p_cycles), stm32f4_system_get_cycles() - start);                       \
+    }
+#else
+#define BENCHMARK_NEWLIB_CASE(p_cycles, ...)
+#endif
+
+/**
+ * @brief Measure a message with both formatters and print the cycles.
+ * @hideinitializer
+ */
+#define BENCHMARK_CASE(p_name, ...)                                                     \
+    do                                                                                  \
+    {                                                                                   \
+        bench_cycles_t fmt = {UINT32_MAX, 0}, newlib = {UINT32_MAX, 0};                 \
+        for (uint32_t i = 0; i < BENCHMARK_ITERATIONS; i++)                             \
+        {                                                                               \
+            uint32_t start = stm32f4_system_get_cycles();                               \
+            sink = text_fmt(buf, sizeof(buf), __VA_ARGS__);                             \
+            _record(&fmt, stm32f4_system_get_cycles() - start);                         \
+        }                                                                               \
+        BENCHMARK_NEWLIB_CASE(&newlib, __VA_ARGS__)                                     \
+        text_fmt(line, sizeof(line), "%s: text_fmt %lu..%lu cycles, snprintf %lu..%lu cycles", (p_name), \
+                 fmt.min, fmt.max, (newlib.max == 0) ? 0 : newlib.min, newlib.max);     \
+        puts(line);                                                                     \
+    } while (0)
+
+int main(void)
+{
+    port_system_init();
+    stm32f4_system_cycle_counter_init();
+
+    text_fmt(line, sizeof(line), "Text formatter benchmark. Core clock: %lu Hz", SystemCoreClock);
+    puts(line);
+
+    uint32_t now = port_system_get_millis() + 1234567;
+    BENCHMARK_CASE("distance", "[URBANITE][%ld] Distance: %ld cm\n", (long)now, 173L);
+    BENCHMARK_CASE("state", "[URBANITE][%ld] Resumed from snapshot (%s)\n", (long)now, "ON");
+    BENCHMARK_CASE("press", "[DEBUG][%ld] Duracion: %ld\n", (long)now, 1200L);
+    BENCHMARK_CASE("limits", "%ld %ld %lu", -2147483647L, (long)now, 4294967295UL);
+
+    while (1)
+    {
+    }
+
+    return 0;
+}
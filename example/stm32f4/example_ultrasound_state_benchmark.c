@@ -0,0 +1,207 @@
+/**
+ * @file example_ultrasound_state_benchmark.c
+ * @brief Benchmark of the layout of the state of the ultrasound sensors with 8 and 16 sensors.
+ *
+ * It compares the former layout of the port, one struct per sensor that mixes the configuration with the state updated by
+ * the ISRs, with the current one: a `const` configuration table, a compact array of hot state and one word of flags per kind of flag.
+ * Two paths are measured with the cycle counter of the core:
+ * - ISR: the input capture of the two edges of the echo of every sensor.
+ * - Scheduler: the scan that looks for the sensors whose echo has been received and clears their flags.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "port_system.h"
+#include "stm32f4_system.h"
+
+/* Defines */
+#define BENCHMARK_MAX_SENSORS 16    /*!< Maximum number of sensors of the benchmark @hideinitializer */
+#define BENCHMARK_ITERATIONS 100    /*!< Number of rounds averaged in each measurement @hideinitializer */
+
+/* Typedefs */
+/**
+ * @brief Former layout: configuration and state of a sensor in the same struct.
+ */
+typedef struct
+{
+    GPIO_TypeDef *p_echo_port;
+    GPIO_TypeDef *p_trigger_port;
+    uint8_t trigger_pin;
+    uint8_t echo_alt_fun;
+    uint8_t echo_pin;
+    bool echo_received;
+    bool trigger_end;
+    bool trigger_ready;
+    uint32_t echo_end_tick;
+    uint32_t echo_init_tick;
+    uint32_t echo_overflows;
+    GPIO_TypeDef *p_power_port;
+    uint8_t power_pin;
+    bool powered;
+    uint32_t power_on_ms;
+} mixed_hw_t;
+
+/**
+ * @brief Current layout: hot state of a sensor.
+ */
+typedef struct
+{
+    uint32_t echo_init_tick;
+    uint32_t echo_end_tick;
+    uint32_t echo_overflows;
+    uint32_t power_on_ms;
+} hot_state_t;
+
+/* Global variables */
+static mixed_hw_t mixed_arr[BENCHMARK_MAX_SENSORS];             /*!< Sensors with the former layout */
+static hot_state_t hot_arr[BENCHMARK_MAX_SENSORS];              /*!< Sensors with the current layout */
+static volatile uint32_t echo_received_mask;                    /*!< Echo received flags of the current layout */
+static volatile uint32_t sink;                                  /*!< Destination of the results, so the compiler does not remove the scans */
+static uint32_t num_sensors;                                    /*!< Number of sensors of the current measurement */
+
+/**
+ * @brief Get a sensor with the former layout, with the same bounds check as the port.
+ */
+__attribute__((noinline)) static mixed_hw_t *_mixed_get(uint32_t id)
+{
+    return (id < num_sensors) ? &mixed_arr[id] : NULL;
+}
+
+/**
+ * @brief Get the hot state of a sensor with the current layout, with the same bounds check as the port.
+ */
+__attribute__((noinline)) static hot_state_t *_hot_get(uint32_t id)
+{
+    return (id < num_sensors) ? &hot_arr[id] : NULL;
+}
+
+/**
+ * @brief Input capture of one edge of the echo of a sensor, former layout.
+ */
+__attribute__((noinline)) static void _mixed_isr(uint32_t id, uint32_t ccr)
+{
+    mixed_hw_t *p_hw = _mixed_get(id);
+    if ((p_hw->echo_init_tick == 0) && (p_hw->echo_end_tick == 0))
+    {
+        p_hw->echo_init_tick = ccr;
+    }
+    else
+    {
+        p_hw->echo_end_tick = ccr;
+        p_hw->echo_received = true;
+    }
+}
+
+/**
+ * @brief Input capture of one edge of the echo of a sensor, current layout.
+ */
+__attribute__((noinline)) static void _hot_isr(uint32_t id, uint32_t ccr)
+{
+    hot_state_t *p_state = _hot_get(id);
+    if ((p_state->echo_init_tick == 0) && (p_state->echo_end_tick == 0))
+    {
+        p_state->echo_init_tick = ccr;
+    }
+    else
+    {
+        p_state->echo_end_tick = ccr;
+        __atomic_fetch_or(&echo_received_mask, 1UL << id, __ATOMIC_RELAXED);
+    }
+}
+
+/**
+ * @brief Scan of the sensors with a new echo, former layout: one flag per sensor.
+ */
+__attribute__((noinline)) static void _mixed_scan(void)
+{
+    for (uint32_t id = 0; id < num_sensors; id++)
+    {
+        mixed_hw_t *p_hw = _mixed_get(id);
+        if (p_hw->echo_received)
+        {
+            sink = p_hw->echo_end_tick - p_hw->echo_init_tick;
+            p_hw->echo_received = false;
+            p_hw->echo_init_tick = 0;
+            p_hw->echo_end_tick = 0;
+        }
+    }
+}
+
+/**
+ * @brief Scan of the sensors with a new echo, current layout: one read of the flags and a jump to each sensor that has one.
+ */
+__attribute__((noinline)) static void _hot_scan(void)
+{
+    uint32_t pending = __atomic_exchange_n(&echo_received_mask, 0, __ATOMIC_RELAXED);
+    while (pending != 0)
+    {
+        uint32_t id = (uint32_t)__builtin_ctz(pending);
+        pending &= pending - 1;
+        hot_state_t *p_state = &hot_arr[id];
+        sink = p_state->echo_end_tick - p_state->echo_init_tick;
+        p_state->echo_init_tick = 0;
+        p_state->echo_end_tick = 0;
+    }
+}
+
+/**
+ * @brief Measure the average cycles of the ISR and the scan paths of both layouts for a number of sensors.
+ * In each round every sensor receives an echo, as in the worst case.
+ */
+static void _run(uint32_t sensors)
+{
+    uint32_t isr_mixed = 0, isr_hot = 0, scan_mixed = 0, scan_hot = 0;
+    num_sensors = sensors;
+
+    for (uint32_t r = 0; r < BENCHMARK_ITERATIONS; r++)
+    {
+        uint32_t start = stm32f4_system_get_cycles();
+        for (uint32_t id = 0; id < sensors; id++)
+        {
+            _mixed_isr(id, 100 + r);
+            _mixed_isr(id, 1200 + r);
+        }
+        isr_mixed += stm32f4_system_get_cycles() - start;
+
+        start = stm32f4_system_get_cycles();
+        _mixed_scan();
+        scan_mixed += stm32f4_system_get_cycles() - start;
+
+        start = stm32f4_system_get_cycles();
+        for (uint32_t id = 0; id < sensors; id++)
+        {
+            _hot_isr(id, 100 + r);
+            _hot_isr(id, 1200 + r);
+        }
+        isr_hot += stm32f4_system_get_cycles() - start;
+
+        start = stm32f4_system_get_cycles();
+        _hot_scan();
+        scan_hot += stm32f4_system_get_cycles() - start;
+    }
+
+    printf("%2ld sensors | ISR (2 edges/sensor): mixed %5ld, split %5ld cycles | scan: mixed %5ld, split %5ld cycles\n",
+           sensors, isr_mixed / BENCHMARK_ITERATIONS, isr_hot / BENCHMARK_ITERATIONS, scan_mixed / BENCHMARK_ITERATIONS, scan_hot / BENCHMARK_ITERATIONS);
+}
+
+int main(void)
+{
+    port_system_init();
+    stm32f4_system_cycle_counter_init();
+
+    printf("Ultrasound state layout benchmark. sizeof: mixed %u bytes/sensor, hot %u bytes/sensor\n", (unsigned)sizeof(mixed_hw_t), (unsigned)sizeof(hot_state_t));
+
+    _run(8);
+    _run(12);
+    _run(BENCHMARK_MAX_SENSORS);
+
+    while (1)
+    {
+    }
+
+    return 0;
+}
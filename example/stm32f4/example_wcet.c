@@ -0,0 +1,230 @@
+/**
+ * @file example_wcet.c
+ * @brief Measurement of the worst-case execution time of the hot functions of the per-measurement path.
+ *
+ * Unlike the benchmarks, which average many calls with typical inputs, each function is driven with the inputs that exercise its
+ * longest path, and the maximum number of cycles of a single call is recorded with the cycle counter of the core:
+ * - `do_set_distance()` (through `fsm_ultrasound_fire()`): echoes that wrap around the timer with the maximum number of overflows
+ *   before the next trigger, in decreasing order, so the call that completes the window computes the median of a reverse-sorted window.
+ * - `_compute_display_levels()`: every distance of the bands and both sides of each band edge.
+ * - `port_display_set_rgb()`: the three channels change in every call, also from and to off, and with a change of the system clock.
+ * - `dsp_median_u32()`: reverse-sorted windows.
+ * Each call is measured with the interrupts disabled and the flash cache invalidated before it (cold), which is the worst case of
+ * code executed from flash. The table is printed by semihosting in Markdown, ready for the safety case.
+ * QEMU does not model the cycle counter of the core: if it does not advance, the table is not printed.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+#include <stdio.h>
+#include <stdbool.h>
+
+#include "dsp_kernels.h"
+#include "fsm_display.h"
+#include "fsm_ultrasound.h"
+#include "port_display.h"
+#include "port_system.h"
+#include "port_ultrasound.h"
+#include "stm32f4_system.h"
+
+/* Defines */
+#define WCET_ROUNDS 100     /*!< Number of rounds of adversarial inputs of each function @hideinitializer */
+#define WCET_MAX_OVERFLOWS ((PORT_PARKING_SENSOR_TIMEOUT_MS * 1000) / 65536 + 1) /*!< Maximum overflows of the echo timer (1 tick = 1 us) before the next trigger @hideinitializer */
+
+/* Typedefs */
+/**
+ * @brief Worst case of a function.
+ */
+typedef struct
+{
+    const char *p_name;     /*!< Name of the function */
+    const char *p_input;    /*!< Description of the adversarial inputs */
+    uint32_t calls;         /*!< Number of calls measured */
+    uint32_t min;           /*!< Minimum cycles of a call */
+    uint32_t max;           /*!< Maximum cycles of a call */
+} wcet_entry_t;
+
+/* Global variables */
+static volatile uint32_t sink;  /*!< Destination of the results, so the compiler does not remove the calls */
+static uint32_t overhead;       /*!< Cycles of an empty measurement, subtracted from every call */
+
+/* Function of fsm_display.c without a public prototype */
+extern void _compute_display_levels(rgb_color_t *p_color, int32_t distance_cm);
+
+/**
+ * @brief Start the measurement of a call: invalidate the flash cache and read the cycle counter with the interrupts disabled.
+ */
+static inline uint32_t _start(void)
+{
+    __disable_irq();
+    stm32f4_system_flash_cache_flush();
+    return stm32f4_system_get_cycles();
+}
+
+/**
+ * @brief End the measurement of a call and record it in the worst case of the function.
+ */
+static inline void _stop(wcet_entry_t *p_entry, uint32_t start)
+{
+    uint32_t cycles = stm32f4_system_get_cycles() - start;
+    __enable_irq();
+
+    cycles = (cycles > overhead) ? (cycles - overhead) : 0;
+    p_entry->calls++;
+    if (cycles < p_entry->min)
+    {
+        p_entry->min = cycles;
+    }
+    if (cycles > p_entry->max)
+    {
+        p_entry->max = cycles;
+    }
+}
+
+/**
+ * @brief Measure `do_set_distance()`: echoes that wrap around the timer with the maximum overflows, longest first.
+ */
+static void _measure_set_distance(wcet_entry_t *p_entry, fsm_ultrasound_t *p_fsm)
+{
+    for (uint32_t r = 0; r < WCET_ROUNDS; r++)
+    {
+        for (uint32_t i = 0; i < FSM_ULTRASOUND_NUM_MEASUREMENTS; i++)
+        {
+            // End tick lower than the init tick: the path that discounts the overflow of the wrap around
+            port_ultrasound_set_echo_init_tick(PORT_REAR_PARKING_SENSOR_ID, 65535 - r);
+            port_ultrasound_set_echo_end_tick(PORT_REAR_PARKING_SENSOR_ID, 60000 - (i * 1000));
+            port_ultrasound_set_echo_overflows(PORT_REAR_PARKING_SENSOR_ID, WCET_MAX_OVERFLOWS);
+            port_ultrasound_set_echo_received(PORT_REAR_PARKING_SENSOR_ID, true);
+            fsm_ultrasound_set_state(p_fsm, WAIT_ECHO_END);
+
+            uint32_t start = _start();
+            fsm_ultrasound_fire(p_fsm);
+            _stop(p_entry, start);
+        }
+        sink = fsm_ultrasound_get_distance(p_fsm);
+    }
+}
+
+/**
+ * @brief Measure `_compute_display_levels()`: every distance of the bands, from one below the first edge to one above the last.
+ */
+static void _measure_display_levels(wcet_entry_t *p_entry)
+{
+    rgb_color_t color;
+    for (uint32_t r = 0; r < WCET_ROUNDS / 10; r++)
+    {
+        for (int32_t distance_cm = DANGER_MIN_CM - 1; distance_cm <= OK_MAX_CM + 1; distance_cm++)
+        {
+            uint32_t start = _start();
+            _compute_display_levels(&color, distance_cm);
+            _stop(p_entry, start);
+            sink = color.r + color.g + color.b;
+        }
+    }
+}
+
+/**
+ * @brief Measure `port_display_set_rgb()`: the three channels change in every call.
+ */
+static void _measure_set_rgb(wcet_entry_t *p_entry)
+{
+    static const rgb_color_t colors[] = {{255, 255, 255}, {1, 2, 3}, {0, 0, 0}, {128, 64, 32}, {25, 89, 82}, {94, 94, 1}};
+    uint32_t num_colors = sizeof(colors) / sizeof(colors[0]);
+
+    for (uint32_t r = 0; r < WCET_ROUNDS; r++)
+    {
+        uint32_t start = _start();
+        port_display_set_rgb(PORT_REAR_PARKING_DISPLAY_ID, colors[r % num_colors]);
+        _stop(p_entry, start);
+    }
+}
+
+/**
+ * @brief Measure `port_display_set_rgb()` when the system clock has changed since the last call, so the PWM period is derived again.
+ */
+static void _measure_set_rgb_clock(wcet_entry_t *p_entry)
+{
+    uint32_t clock_hz = SystemCoreClock;
+    for (uint32_t r = 0; r < WCET_ROUNDS; r++)
+    {
+        // Alternate between two clocks, restoring the real one at the end
+        SystemCoreClock = (r % 2 == 0) ? (clock_hz / 2) : clock_hz;
+        uint32_t start = _start();
+        port_display_set_rgb(PORT_REAR_PARKING_DISPLAY_ID, (r % 2 == 0) ? COLOR_TURQUOISE : COLOR_YELLOW);
+        _stop(p_entry, start);
+    }
+    SystemCoreClock = clock_hz;
+    port_display_set_rgb(PORT_REAR_PARKING_DISPLAY_ID, COLOR_OFF);
+}
+
+/**
+ * @brief Measure `dsp_median_u32()` with reverse-sorted windows.
+ */
+static void _measure_median(wcet_entry_t *p_entry)
+{
+    uint32_t window[FSM_ULTRASOUND_NUM_MEASUREMENTS];
+    for (uint32_t r = 0; r < WCET_ROUNDS; r++)
+    {
+        for (uint32_t i = 0; i < FSM_ULTRASOUND_NUM_MEASUREMENTS; i++)
+        {
+            window[i] = 1000 + r - (i * 10);
+        }
+        uint32_t start = _start();
+        sink = dsp_median_u32(window, FSM_ULTRASOUND_NUM_MEASUREMENTS);
+        _stop(p_entry, start);
+    }
+}
+
+int main(void)
+{
+    port_system_init();
+    stm32f4_system_cycle_counter_init();
+
+    fsm_ultrasound_t *p_fsm_ultrasound = fsm_ultrasound_new(PORT_REAR_PARKING_SENSOR_ID);
+    port_display_init(PORT_REAR_PARKING_DISPLAY_ID);
+
+    wcet_entry_t table[] = {
+        {"do_set_distance", "wrap + max overflows, reverse-sorted window", 0, UINT32_MAX, 0},
+        {"_compute_display_levels", "every distance and band edge +/- 1", 0, UINT32_MAX, 0},
+        {"port_display_set_rgb", "all channels change, from and to off", 0, UINT32_MAX, 0},
+        {"port_display_set_rgb", "system clock changed", 0, UINT32_MAX, 0},
+        {"dsp_median_u32", "reverse-sorted window", 0, UINT32_MAX, 0},
+    };
+
+    // Cost of an empty measurement, subtracted from every call. The minimum of many, as the flush does not always cost the same.
+    wcet_entry_t empty = {"", "", 0, UINT32_MAX, 0};
+    for (uint32_t r = 0; r < WCET_ROUNDS; r++)
+    {
+        _stop(&empty, _start());
+    }
+    overhead = empty.min;
+
+    printf("WCET of the hot functions. Core clock: %ld Hz, flash latency: %ld WS\n\n", SystemCoreClock, (uint32_t)(FLASH->ACR & FLASH_ACR_LATENCY));
+    if (overhead == 0)
+    {
+        printf("The cycle counter does not advance (QEMU does not model it): no measurements\n");
+    }
+    else
+    {
+        _measure_set_distance(&table[0], p_fsm_ultrasound);
+        _measure_display_levels(&table[1]);
+        _measure_set_rgb(&table[2]);
+        _measure_set_rgb_clock(&table[3]);
+        _measure_median(&table[4]);
+
+        printf("| %-24s | %-44s | %6s | %6s | %6s | %9s |\n", "Function", "Adversarial input", "Calls", "Min", "WCET", "WCET (us)");
+        printf("|%s|%s|%s|%s|%s|%s|\n", "--------------------------", "----------------------------------------------", "--------", "--------", "--------", "-----------");
+        for (uint32_t i = 0; i < sizeof(table) / sizeof(table[0]); i++)
+        {
+            printf("| %-24s | %-44s | %6ld | %6ld | %6ld | %9ld |\n", table[i].p_name, table[i].p_input, table[i].calls, table[i].min, table[i].max,
+                   (table[i].max + (SystemCoreClock / 1000000) - 1) / (SystemCoreClock / 1000000));
+        }
+    }
+
+    while (1)
+    {
+    }
+
+    return 0;
+}
@@ -16,17 +16,118 @@
 #include "port_button.h"
 #include "port_ultrasound.h"
 #include "port_display.h"
+#include "port_reverse.h"
+#include "port_backup.h"
+#include "port_tof.h"
 
 #include "fsm.h"
 #include "fsm_button.h"
 #include "fsm_ultrasound.h"
 #include "fsm_display.h"
 #include "fsm_urbanite.h"
+#include "metrics.h"
+#include "scheduler.h"
+#include "can_publisher.h"
+#include "ranging.h"
 
 /* Defines ------------------------------------------------------------------*/
 #define URBANITE_ON_OFF_PRESS_TIME_MS 1000  // Time in ms to activate the Urbanite system, started mainly due to a parking maneuver (long press) (1 s)
 #define URBANITE_PAUSE_DISPLAY_TIME_MS 250  // Time in ms to pause the display (0,25 s)
 #define URBANITE_EMERGENCY_TIME_MS 3000     // Time in ms to activate emergency mode (5 s)
+#define URBANITE_REVERSE_WARM_STANDBY true  // Keep the sensor in warm standby while the ignition is on, to show a distance as soon as the reverse gear is engaged
+
+/* Relative deadlines of the FSMs. The FSMs are fired once per round of the scheduler, the tightest deadline first */
+#define MAIN_DISPLAY_DEADLINE_MS 5          // Time in ms to update the display after the start of a round (safety-relevant)
+#define MAIN_BUTTON_DEADLINE_MS 10          // Time in ms to process the button (much lower than its debounce time)
+#define MAIN_ULTRASOUND_DEADLINE_MS 10      // Time in ms to process the ultrasound sensor (much lower than its measurement period)
+#define MAIN_URBANITE_DEADLINE_MS 20        // Time in ms to process the Urbanite system
+#define MAIN_CAN_DEADLINE_MS 20             // Time in ms to refill the CAN mailboxes (a mailbox takes about 0,25 ms at 500 kbit/s)
+/* Background jobs */
+#define MAIN_METRICS_PERIOD_MS 5000         // Period in ms of the dump of the metrics (telemetry)
+#define MAIN_MISSES_REPORT_PERIOD_MS 1000   // Period in ms of the check of the deadline misses
+
+/* Tasks of the scheduler ---------------------------------------------------*/
+/**
+ * @brief Task that fires the button FSM.
+ */
+static void _task_button(void *p_ctx)
+{
+    fsm_button_fire((fsm_button_t *)p_ctx);
+}
+
+/**
+ * @brief Task that fires the ultrasound FSM.
+ */
+static void _task_ultrasound(void *p_ctx)
+{
+    fsm_ultrasound_fire((fsm_ultrasound_t *)p_ctx);
+}
+
+/**
+ * @brief Task that fires the display FSM.
+ */
+static void _task_display(void *p_ctx)
+{
+    fsm_display_fire((fsm_display_t *)p_ctx);
+}
+
+/**
+ * @brief Task that fires the Urbanite FSM.
+ */
+static void _task_urbanite(void *p_ctx)
+{
+    fsm_urbanite_fire((fsm_urbanite_t *)p_ctx);
+}
+
+/**
+ * @brief Context of the CAN task: sources of the published data.
+ */
+typedef struct
+{
+    fsm_urbanite_t *p_fsm_urbanite;             /*!<    Urbanite FSM*/
+    fsm_ultrasound_t *p_fsm_ultrasound_rear;    /*!<    Rear ultrasound FSM*/
+} main_can_ctx_t;
+
+/**
+ * @brief Task that updates the data of the CAN publisher and refills the free mailboxes.
+ */
+static void _task_can(void *p_ctx)
+{
+    main_can_ctx_t *p_can = (main_can_ctx_t *)p_ctx;
+    uint32_t distance_cm, confidence_pct, timestamp_ms;
+
+    can_publisher_set_state(fsm_urbanite_get_state(p_can->p_fsm_urbanite));
+    if (fsm_ultrasound_get_measurement(p_can->p_fsm_ultrasound_rear, &distance_cm, &confidence_pct, &timestamp_ms))
+    {
+        can_publisher_set_sensor(PORT_REAR_PARKING_SENSOR_ID, distance_cm, confidence_pct, timestamp_ms);
+    }
+    can_publisher_run();
+}
+
+#ifdef USE_METRICS
+/**
+ * @brief Background job that prints the metrics.
+ */
+static void _job_metrics(void *p_ctx)
+{
+    metrics_dump();
+}
+#endif
+
+/**
+ * @brief Background job that prints the statistics of the tasks when new deadline misses have happened.
+ */
+static void _job_misses_report(void *p_ctx)
+{
+    static uint32_t reported_misses = 0;
+    uint32_t misses = scheduler_get_total_misses();
+    if (misses != reported_misses)
+    {
+        printf("[SCHEDULER][%ld] %ld deadline misses\n", port_system_get_millis(), misses - reported_misses);
+        scheduler_dump();
+        reported_misses = misses;
+    }
+}
 
 
 /**
@@ -44,15 +145,46 @@ int main(void)
     fsm_ultrasound_t* p_fsm_ultrasound_rear = fsm_ultrasound_new(PORT_REAR_PARKING_SENSOR_ID);
     fsm_display_t* p_fsm_display_rear = fsm_display_new(PORT_REAR_PARKING_DISPLAY_ID);
 
+    // The ToF sensor measures the last centimetres, faster than the ultrasound sensor
+    static ranging_device_t tof_rear;
+    ranging_init(&tof_rear, &ranging_tof_backend, PORT_REAR_TOF_SENSOR_ID);
+    fsm_ultrasound_set_short_range(p_fsm_ultrasound_rear, &tof_rear);
+
     fsm_urbanite_t*  p_fsm_urbanite = fsm_urbanite_new(p_fsm_button,URBANITE_ON_OFF_PRESS_TIME_MS, URBANITE_PAUSE_DISPLAY_TIME_MS, URBANITE_EMERGENCY_TIME_MS, p_fsm_ultrasound_rear, p_fsm_display_rear);
 
+    // The reverse gear of the vehicle turns the Urbanite ON and OFF
+    port_reverse_init(PORT_REVERSE_GEAR_ID);
+    fsm_urbanite_set_reverse(p_fsm_urbanite, PORT_REVERSE_GEAR_ID, URBANITE_REVERSE_WARM_STANDBY);
+
+    // Resume in the mode before the reset or the low power mode, without the ON gesture nor refilling the filter
+    port_backup_init();
+    fsm_urbanite_resume(p_fsm_urbanite);
+
+    // Publish the distances and the state on the CAN bus of the vehicle
+    static main_can_ctx_t can_ctx;
+    can_ctx.p_fsm_urbanite = p_fsm_urbanite;
+    can_ctx.p_fsm_ultrasound_rear = p_fsm_ultrasound_rear;
+    can_publisher_init(1, false);
+#ifdef USE_METRICS
+    can_publisher_set_period(CAN_PUBLISHER_MSG_QUANTILES, CAN_PUBLISHER_QUANTILES_PERIOD_MS);
+#endif
+
+    // Create the tasks of the scheduler: the FSMs are released once per round, the background jobs periodically.
+    scheduler_init();
+    scheduler_add_task("button", _task_button, p_fsm_button, 0, MAIN_BUTTON_DEADLINE_MS);
+    scheduler_add_task("ultrasound", _task_ultrasound, p_fsm_ultrasound_rear, 0, MAIN_ULTRASOUND_DEADLINE_MS);
+    scheduler_add_task("display", _task_display, p_fsm_display_rear, 0, MAIN_DISPLAY_DEADLINE_MS);
+    scheduler_add_task("urbanite", _task_urbanite, p_fsm_urbanite, 0, MAIN_URBANITE_DEADLINE_MS);
+    scheduler_add_task("can", _task_can, &can_ctx, 0, MAIN_CAN_DEADLINE_MS);
+#ifdef USE_METRICS
+    scheduler_add_task("metrics", _job_metrics, NULL, MAIN_METRICS_PERIOD_MS, 0);
+#endif
+    scheduler_add_task("misses_report", _job_misses_report, NULL, MAIN_MISSES_REPORT_PERIOD_MS, 0);
+
     /* Infinite loop */
     while (1)
     {        
-        fsm_button_fire(p_fsm_button);
-        fsm_ultrasound_fire(p_fsm_ultrasound_rear);
-        fsm_display_fire(p_fsm_display_rear);
-        fsm_urbanite_fire(p_fsm_urbanite);
+        scheduler_run_next();
         
     } // End of while(1)
 
@@ -0,0 +1,61 @@
+/**
+ * @file port_backup.h
+ * @brief Header for the portable functions to keep a snapshot of the state of the system in a memory that survives the low power
+ * modes and the resets. The functions must be implemented in the platform-specific code.
+ *
+ * The memory holds a single snapshot. The platform stores it with its size and a checksum, so a snapshot that has never been
+ * written, that has been corrupted (e.g., a reset in the middle of a write) or that has a different size is not read back.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef PORT_BACKUP_H_
+#define PORT_BACKUP_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Configure the HW of the backup memory: clock, write access and retention in the low power modes.
+ * It does not modify the snapshot stored.
+ */
+void port_backup_init(void);
+
+/**
+ * @brief Get the maximum size of a snapshot.
+ *
+ * @return uint32_t Maximum size in bytes.
+ */
+uint32_t port_backup_get_capacity(void);
+
+/**
+ * @brief Store a snapshot, replacing the previous one.
+ *
+ * @param p_data    Pointer to the data of the snapshot.
+ * @param size      Size of the snapshot in bytes.
+ * @return true     If the snapshot has been stored.
+ * @return false    If it does not fit in the backup memory.
+ */
+bool port_backup_write(const void *p_data, uint32_t size);
+
+/**
+ * @brief Read the snapshot stored.
+ *
+ * @param p_data    Pointer to store the data of the snapshot.
+ * @param size      Expected size of the snapshot in bytes.
+ * @return true     If a valid snapshot of the expected size has been read.
+ * @return false    Otherwise. The output is not written.
+ */
+bool port_backup_read(void *p_data, uint32_t size);
+
+/**
+ * @brief Invalidate the snapshot stored, so the next read fails.
+ */
+void port_backup_invalidate(void);
+
+#endif /* PORT_BACKUP_H_ */
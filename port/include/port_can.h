@@ -0,0 +1,76 @@
+/**
+ * @file port_can.h
+ * @brief Header for the portable functions to interact with the HW of the CAN controller. The functions must be implemented in the platform-specific code.
+ *
+ * The controller has `PORT_CAN_NUM_TX_MAILBOXES` transmit mailboxes. A frame written into a free mailbox is sent by the HW without CPU
+ * intervention, so the functions of this API never wait for the bus. In loopback mode, the frames sent are received by the controller
+ * itself and are not driven onto the bus, so the tests do not need a transceiver nor other nodes.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef PORT_CAN_H_
+#define PORT_CAN_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define PORT_CAN_BITRATE_BPS 500000         /*!<    Bit rate of the CAN bus of the vehicle in bit/s   */
+#define PORT_CAN_NUM_TX_MAILBOXES 3         /*!<    Number of transmit mailboxes of the controller   */
+#define PORT_CAN_MAX_DLC 8                  /*!<    Maximum number of data bytes of a frame   */
+#define PORT_CAN_STD_ID_MAX 0x7FFU          /*!<    Maximum standard (11-bit) identifier. Greater identifiers are sent as extended (29-bit)   */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief CAN data frame.
+ */
+typedef struct
+{
+    uint32_t id;                        /*!<    Identifier. Standard if it is not greater than `PORT_CAN_STD_ID_MAX`, extended otherwise   */
+    uint8_t dlc;                        /*!<    Number of data bytes (0 to `PORT_CAN_MAX_DLC`)   */
+    uint8_t data[PORT_CAN_MAX_DLC];     /*!<    Data bytes   */
+} port_can_frame_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Configure the HW of the CAN controller (pins, bit timing, acceptance filter) and start it.
+ *
+ * @param loopback  Run in silent loopback mode: the frames sent are received back and the bus is not driven. Used by the tests.
+ * @return true     If the controller has joined the bus (or started the loopback).
+ * @return false    If the controller has not left its initialization mode.
+ */
+bool port_can_init(bool loopback);
+
+/**
+ * @brief Get the number of free transmit mailboxes.
+ *
+ * @return uint32_t     Number of mailboxes that can be filled with `port_can_transmit()` without failing.
+ */
+uint32_t port_can_get_free_mailboxes(void);
+
+/**
+ * @brief Request the transmission of a frame in a free mailbox. It does not wait for the transmission.
+ * The mailboxes are sent in the order of the requests.
+ *
+ * @param p_frame   Pointer to the frame to send.
+ * @return true     If the frame has been written into a mailbox.
+ * @return false    If all the mailboxes are busy.
+ */
+bool port_can_transmit(const port_can_frame_t *p_frame);
+
+/**
+ * @brief Get a received frame, if any.
+ *
+ * @param p_frame   Pointer to store the frame.
+ * @return true     If a frame has been received.
+ * @return false    If the receive FIFO is empty.
+ */
+bool port_can_receive(port_can_frame_t *p_frame);
+
+#endif /* PORT_CAN_H_ */
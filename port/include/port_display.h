@@ -29,6 +29,14 @@ typedef struct
 #define 	PORT_REAR_PARKING_DISPLAY_ID    0       /*!<    Display system identifier for the rear parking sensor*/
 #define 	PORT_DISPLAY_RGB_MAX_VALUE      255     /*!<    Maximum value for the RGB LED*/
 
+#define 	PORT_DISPLAY_PWM_LF_FREQ_HZ     50      /*!<    Low PWM frequency of the RGB LED. Maximum duty resolution, but it flickers*/
+#define 	PORT_DISPLAY_PWM_HF_FREQ_HZ     2000    /*!<    High PWM frequency of the RGB LED. Flicker-free*/
+#ifdef USE_DISPLAY_PWM_HF
+#define 	PORT_DISPLAY_PWM_FREQ_HZ        PORT_DISPLAY_PWM_HF_FREQ_HZ    /*!<    PWM frequency of the RGB LED after initialization*/
+#else
+#define 	PORT_DISPLAY_PWM_FREQ_HZ        PORT_DISPLAY_PWM_LF_FREQ_HZ    /*!<    PWM frequency of the RGB LED after initialization*/
+#endif
+
 #define 	COLOR_RED           (rgb_color_t){255, 0, 0}   /*!<    Red color (Danger)*/
 #define 	COLOR_GREEN         (rgb_color_t){0, 255, 0}   /*!<    Green color (No problem)*/
 #define 	COLOR_BLUE          (rgb_color_t){0, 0, 255}   /*!<    Blue color (OK)*/
@@ -53,5 +61,16 @@ void port_display_init (uint32_t display_id);
  */
 void port_display_set_rgb (uint32_t display_id, rgb_color_t color);	
 
+/**
+ * @brief Set the PWM frequency of the RGB LED of a display.
+ * The prescaler and the period of the timer are derived from the current system clock to get the maximum duty resolution at the given frequency.
+ * They are derived again automatically if the system clock changes. The color is applied again with the new period.
+ * 
+ * @param display_id    Display ID. This index is used to select the element of the displays_arr[] array
+ * @param freq_hz       PWM frequency in Hz. It is limited so the duty resolution is never lower than the one required by the color palette.
+ * @return uint32_t     PWM frequency in Hz actually configured. 0 if the display ID is not valid.
+ */
+uint32_t port_display_set_pwm_frequency (uint32_t display_id, uint32_t freq_hz);
+
 
 #endif /* PORT_DISPLAY_SYSTEM_H_ */
\ No newline at end of file
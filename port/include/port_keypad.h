@@ -0,0 +1,94 @@
+/**
+ * @file port_keypad.h
+ * @brief Header for the portable functions to interact with the HW of the keypad. The functions must be implemented in the platform-specific code.
+ *
+ * The keypad groups several keys (direct buttons and a small matrix) that are sampled periodically by the HW without CPU intervention.
+ * Each complete scan is debounced at once for all the keys, so the state of every key is a bit of a single word.
+ * Bit `i` of the words returned by this API corresponds to the key with ID `i`.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef PORT_KEYPAD_H_
+#define PORT_KEYPAD_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+// Define here all the key identifiers that are used in the system
+#define PORT_KEYPAD_AUX_1_ID 0          /*!<    Direct auxiliary key 1   */
+#define PORT_KEYPAD_AUX_2_ID 1          /*!<    Direct auxiliary key 2   */
+#define PORT_KEYPAD_MATRIX_R0C0_ID 2    /*!<    Key of the matrix in row 0 and column 0   */
+#define PORT_KEYPAD_MATRIX_R0C1_ID 3    /*!<    Key of the matrix in row 0 and column 1   */
+#define PORT_KEYPAD_MATRIX_R0C2_ID 4    /*!<    Key of the matrix in row 0 and column 2   */
+#define PORT_KEYPAD_MATRIX_R1C0_ID 5    /*!<    Key of the matrix in row 1 and column 0   */
+#define PORT_KEYPAD_MATRIX_R1C1_ID 6    /*!<    Key of the matrix in row 1 and column 1   */
+#define PORT_KEYPAD_MATRIX_R1C2_ID 7    /*!<    Key of the matrix in row 1 and column 2   */
+#define PORT_KEYPAD_NUM_KEYS 8          /*!<    Number of keys of the keypad. It must not be greater than 32   */
+
+#define PORT_KEYPAD_DEBOUNCE_SCANS 4    /*!<    Number of consecutive scans required to accept a change of a key. Fixed by the 2-bit vertical counter of the port   */
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Configure the HW of the keypad: GPIOs of the keys, sampling timer and DMA transfers.
+ * The sampling is not started until `port_keypad_start()` is called.
+ */
+void port_keypad_init(void);
+
+/**
+ * @brief Start the periodic sampling of the keypad.
+ * The debounced state of all the keys is reset to released.
+ */
+void port_keypad_start(void);
+
+/**
+ * @brief Stop the periodic sampling of the keypad.
+ */
+void port_keypad_stop(void);
+
+/**
+ * @brief Get the debounced state of all the keys.
+ *
+ * @return uint32_t     Bit `i` is 1 if the key with ID `i` is pressed.
+ */
+uint32_t port_keypad_get_state(void);
+
+/**
+ * @brief Get the debounced state of a key.
+ *
+ * @param key_id    Key ID. This index is used to select the element of the keys_arr[] array.
+ * @return true     If the key is pressed.
+ * @return false    If the key is released or the ID is not valid.
+ */
+bool port_keypad_get_key(uint32_t key_id);
+
+/**
+ * @brief Get and clear the keys that have been pressed since the last call.
+ * This is the equivalent of the `flag_pressed` of a button, but for all the keys at once.
+ *
+ * @return uint32_t     Bit `i` is 1 if the key with ID `i` has been pressed.
+ */
+uint32_t port_keypad_get_pressed_events(void);
+
+/**
+ * @brief Get the number of complete scans of the keypad since it was started.
+ *
+ * @return uint32_t     Number of scans.
+ */
+uint32_t port_keypad_get_scan_count(void);
+
+/**
+ * @brief Debounce a complete scan of the keypad.
+ * It is called by the ISR of the sampling transfer each time one of the two scan buffers has been filled, while the HW fills the other one.
+ *
+ * @param buffer_idx    Index (0 or 1) of the scan buffer that has been filled.
+ */
+void port_keypad_process_scan(uint32_t buffer_idx);
+
+#endif /* PORT_KEYPAD_H_ */
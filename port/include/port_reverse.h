@@ -0,0 +1,110 @@
+/**
+ * @file port_reverse.h
+ * @brief Header for the portable functions to interact with the HW of the vehicle inputs: the reverse-gear signal and the ignition signal.
+ * The functions must be implemented in the platform-specific code.
+ *
+ * Both signals are level inputs of the vehicle (through a level shifter). Their changes interrupt the MCU, so the Urbanite can be
+ * activated as soon as the reverse gear is engaged, without the long press of the button.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef PORT_REVERSE_H_
+#define PORT_REVERSE_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define PORT_REVERSE_GEAR_ID 0                  /*!<    Reverse-gear input identifier   */
+#define PORT_REVERSE_DEBOUNCE_MS 50             /*!<    Time in ms a new level of the inputs must be stable to be taken as the status of the signals   */
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Configure the HW of the reverse-gear and ignition inputs, and read their initial levels.
+ *
+ * @param reverse_id Reverse input ID. This index is used to select the element of the reverse_arr[] array.
+ */
+void port_reverse_init(uint32_t reverse_id);
+
+/**
+ * @brief Get the status of the reverse gear, as updated by the interrupt of its input and debounced for `PORT_REVERSE_DEBOUNCE_MS`.
+ *
+ * @param reverse_id Reverse input ID.
+ * @return true     If the reverse gear is engaged.
+ * @return false    Otherwise.
+ */
+bool port_reverse_get_engaged(uint32_t reverse_id);
+
+/**
+ * @brief Set the status of the reverse gear. It is used by the ISR and to simulate the reverse signal in the tests.
+ *
+ * @param reverse_id Reverse input ID.
+ * @param engaged   Status of the reverse gear.
+ */
+void port_reverse_set_engaged(uint32_t reverse_id, bool engaged);
+
+/**
+ * @brief Get the status of the ignition, as updated by the interrupt of its input and debounced for `PORT_REVERSE_DEBOUNCE_MS`.
+ *
+ * @param reverse_id Reverse input ID.
+ * @return true     If the ignition is on.
+ * @return false    If the ignition is off, or if the platform does not have an ignition input.
+ */
+bool port_reverse_get_ignition(uint32_t reverse_id);
+
+/**
+ * @brief Check if a change of level of the inputs is waiting for the debounce time. The system must not sleep meanwhile: the
+ * interrupt of the change has already been served, and the new status is only taken when it is read again.
+ *
+ * @param reverse_id Reverse input ID.
+ * @return true     If the status of any of the signals may still change.
+ * @return false    Otherwise.
+ */
+bool port_reverse_get_debouncing(uint32_t reverse_id);
+
+/**
+ * @brief Set the status of the ignition. It is used by the ISR and to simulate the ignition signal in the tests.
+ *
+ * @param reverse_id Reverse input ID.
+ * @param ignition  Status of the ignition.
+ */
+void port_reverse_set_ignition(uint32_t reverse_id, bool ignition);
+
+/**
+ * @brief Read the level of the reverse-gear input and of the ignition input, and restart their debounce time.
+ * It is called by the ISR of the inputs, after clearing their pending interrupts.
+ *
+ * @param reverse_id Reverse input ID.
+ */
+void port_reverse_update(uint32_t reverse_id);
+
+/**
+ * @brief Get the status of the interrupt lines of the reverse-gear and ignition inputs.
+ *
+ * @param reverse_id Reverse input ID.
+ * @return true     If any of the lines has a pending interrupt.
+ * @return false    Otherwise.
+ */
+bool port_reverse_get_pending_interrupt(uint32_t reverse_id);
+
+/**
+ * @brief Clear the pending interrupts of the reverse-gear and ignition inputs.
+ *
+ * @param reverse_id Reverse input ID.
+ */
+void port_reverse_clear_pending_interrupt(uint32_t reverse_id);
+
+/**
+ * @brief Disable the interrupts of the reverse-gear and ignition inputs. It is used in the unit tests to avoid unwanted interrupts.
+ *
+ * @param reverse_id Reverse input ID.
+ */
+void port_reverse_disable_interrupts(uint32_t reverse_id);
+
+#endif /* PORT_REVERSE_H_ */
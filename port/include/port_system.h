@@ -10,6 +10,20 @@
 
 /* Includes del sistema */
 #include <stdint.h>
+#include <stdbool.h>
+
+/* Defines */
+/**
+ * @brief Attribute that places a function in SRAM. The code is copied from flash at startup.
+ * Use it on the ISRs and on the functions of the per-measurement path whose latency must not depend on the flash cache.
+ * It is only effective when `USE_RAMFUNC` is defined (CMake option `-DUSE_RAMFUNC=true`, default). Otherwise, it is empty.
+ * @hideinitializer
+ */
+#ifdef USE_RAMFUNC
+#define PORT_RAMFUNC __attribute__((section(".RamFunc"), noinline))
+#else
+#define PORT_RAMFUNC
+#endif
 
 /**
  * @brief Initializes the system.
@@ -33,6 +47,10 @@ void port_system_set_millis(uint32_t ms);
 /**
  * @brief Delays the program execution for the specified number of milliseconds.
  *
+ * When `USE_VIRTUAL_CLOCK` is defined (CMake option `-DUSE_VIRTUAL_CLOCK=true`, only for the test executables), the delay does not wait:
+ * it advances the System tick 1 ms at a time and, at each step, fast-forwards the counters of the running timers with update
+ * interrupt, so their interrupts due within the delay are taken at once and in order. The real clock keeps running as well.
+ *
  * @param ms Number of milliseconds to delay.
  */
 void port_system_delay_ms(uint32_t ms);
@@ -63,6 +81,15 @@ void port_system_systick_suspend(void);
 
 
 
+/**
+ * @brief Check if the last reset was caused by the supply: a power-on or a brown-out.
+ * After such a reset, the time the system has been off is unknown, so the state saved before it may be outdated.
+ *
+ * @return true     If the last reset was a power-on or brown-out reset.
+ * @return false    If it was another reset (pin, watchdog, software...).
+ */
+bool port_system_get_power_on_reset(void);
+
 /**
  * @brief Set the system in sleep mode for low power consumption.
  * 
@@ -0,0 +1,132 @@
+/**
+ * @file port_tof.h
+ * @brief Header for the portable functions to interact with the HW of the time-of-flight (ToF) distance sensors. The functions must be implemented in the platform-specific code.
+ *
+ * A ToF sensor (VL53L0X class) measures the flight time of an infrared pulse, with a few mm of resolution up to about 2 m and a
+ * measurement every few tens of ms. It is connected by I2C and signals the end of each measurement with an interrupt pin.
+ * A measurement runs without CPU intervention: the start command, the read of the result and the clear of the interrupt of the
+ * sensor are transfers of the bus completed by interrupts and DMA, so the functions of this API never wait for the bus (but
+ * `port_tof_init()`).
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef PORT_TOF_H_
+#define PORT_TOF_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define PORT_REAR_TOF_SENSOR_ID 0           /*!<    Rear short-range ToF sensor identifier   */
+#define PORT_TOF_MAX_RANGE_MM 2000          /*!<    Maximum distance in mm measured by the sensor   */
+#define PORT_TOF_BOOT_MS 2                  /*!<    Time in ms the sensor needs after power up before it answers on the bus   */
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Configure the HW of a ToF sensor (bus, DMA transfers and interrupt pin) and the sensor itself.
+ * The configuration of the sensor is written with blocking transfers: this is the only function of the API that waits for the bus.
+ *
+ * @param tof_id    ToF ID. This index is used to select the element of the tofs_arr[] array.
+ * @return true     If the sensor has answered with its identification and has been configured.
+ * @return false    If the sensor is not connected or the bus has failed. The measurements of the sensor are not valid.
+ */
+bool port_tof_init(uint32_t tof_id);
+
+/**
+ * @brief Start a single measurement of a ToF sensor. It does not wait for the bus.
+ * The measurement ready flag is cleared. It is set when the result has been read, or when a transfer of the bus fails.
+ *
+ * @param tof_id    ToF ID. This index is used to select the element of the tofs_arr[] array.
+ * @return true     If the measurement has been started.
+ * @return false    If the bus is busy with another transfer or the sensor has not been configured.
+ */
+bool port_tof_start_measurement(uint32_t tof_id);
+
+/**
+ * @brief Abort the measurement in progress of a ToF sensor, if any. The transfer in progress on the bus is stopped.
+ *
+ * @param tof_id    ToF ID. This index is used to select the element of the tofs_arr[] array.
+ */
+void port_tof_stop(uint32_t tof_id);
+
+/**
+ * @brief Check if a ToF sensor has a measurement in progress (started and not ready yet).
+ *
+ * @param tof_id    ToF ID. This index is used to select the element of the tofs_arr[] array.
+ * @return true     If a measurement is in progress.
+ * @return false    Otherwise.
+ */
+bool port_tof_get_busy(uint32_t tof_id);
+
+/**
+ * @brief Get the status of the last measurement of a ToF sensor.
+ * It will be true if the result of the measurement has been read from the sensor, or if the measurement has failed.
+ *
+ * @param tof_id    ToF ID. This index is used to select the element of the tofs_arr[] array.
+ * @return true
+ * @return false
+ */
+bool port_tof_get_measurement_ready(uint32_t tof_id);
+
+/**
+ * @brief Set the status of the last measurement of a ToF sensor.
+ * It is set by the ISRs when the result has been read, and cleared by the reader of the result.
+ *
+ * @param tof_id            ToF ID. This index is used to select the element of the tofs_arr[] array.
+ * @param measurement_ready Status of the measurement.
+ */
+void port_tof_set_measurement_ready(uint32_t tof_id, bool measurement_ready);
+
+/**
+ * @brief Get the distance of the last measurement of a ToF sensor.
+ *
+ * @param tof_id    ToF ID. This index is used to select the element of the tofs_arr[] array.
+ * @return uint32_t Distance in mm. Only meaningful if `port_tof_get_range_valid()` is true.
+ */
+uint32_t port_tof_get_distance_mm(uint32_t tof_id);
+
+/**
+ * @brief Get the return signal rate of the last measurement of a ToF sensor.
+ * The stronger the return signal, the lower the noise of the distance: it is the quality of the measurement.
+ *
+ * @param tof_id    ToF ID. This index is used to select the element of the tofs_arr[] array.
+ * @return uint32_t Signal rate in kilo-counts per second (kcps).
+ */
+uint32_t port_tof_get_signal_rate_kcps(uint32_t tof_id);
+
+/**
+ * @brief Get the validity of the last measurement of a ToF sensor.
+ *
+ * @param tof_id    ToF ID. This index is used to select the element of the tofs_arr[] array.
+ * @return true     If the sensor has reported a valid range.
+ * @return false    If there is no target in range, the signal is too weak or noisy, or a transfer of the bus has failed.
+ */
+bool port_tof_get_range_valid(uint32_t tof_id);
+
+/**
+ * @brief Read the result of the measurement of a ToF sensor.
+ * It is called by the ISR of the interrupt pin of the sensor when a measurement has finished. The read is done by DMA.
+ *
+ * @param tof_id    ToF ID. This index is used to select the element of the tofs_arr[] array.
+ */
+void port_tof_process_sample_ready(uint32_t tof_id);
+
+/**
+ * @brief Advance the transfer in progress on the bus of the ToF sensors.
+ * It is called by the ISRs of the events of the bus and of the end of its DMA transfers.
+ */
+void port_tof_process_bus_event(void);
+
+/**
+ * @brief Abort the transfer in progress on the bus of the ToF sensors after an error (no acknowledge, arbitration lost, bus error).
+ * The measurement in progress is finished as not valid. It is called by the ISRs of the errors of the bus and of its DMA transfers.
+ */
+void port_tof_process_bus_error(void);
+
+#endif /* PORT_TOF_H_ */
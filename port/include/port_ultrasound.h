@@ -17,7 +17,9 @@
 #define PORT_REAR_PARKING_SENSOR_ID 0               /*!<    Rear parking sensor identifier   */
 #define PORT_PARKING_SENSOR_TRIGGER_UP_US 10        /*!<    Duration in microseconds of the trigger signal   */
 #define PORT_PARKING_SENSOR_TIMEOUT_MS 100          /*!<    Time in ms to wait for the next measurement   */
+#define PORT_PARKING_SENSOR_STANDBY_PERIOD_MS 500  /*!<    Time in ms between measurements in warm standby (low rate, sensors ready for the reverse gear)   */
 #define SPEED_OF_SOUND_MS 343                       /*!<    Speed of sound in air in m/s   */
+#define PORT_PARKING_SENSOR_POWER_SETTLE_MS 20      /*!<    Time in ms the sensor needs after power up before the first trigger   */
 
 #define PORT_PARKING_SENSOR_TRIGGER_UP_US 10        /*!<    Duration in microseconds of the trigger signal   */
 
@@ -116,6 +118,14 @@ void port_ultrasound_set_echo_overflows	(uint32_t ultrasound_id, uint32_t echo_o
  */
 void port_ultrasound_set_echo_received (uint32_t ultrasound_id, bool echo_received);	
 
+/**
+ * @brief Get the echo received flags of all the ultrasound sensors at once.
+ * It lets the main loop check whether any sensor has a new echo to process with a single read, instead of one call per sensor.
+ * 
+ * @return uint32_t     Bit `i` is 1 if the echo of the sensor with ID `i` has been received.
+ */
+uint32_t port_ultrasound_get_echo_received_mask (void);
+
 
 /**
  * @brief Get the status of the trigger signal.
@@ -189,6 +199,15 @@ void port_ultrasound_stop_echo_timer (uint32_t ultrasound_id);
  */
 void port_ultrasound_stop_new_measurement_timer (void);
 
+/**
+ * @brief Set the period of the timer that controls the new measurement.
+ * It is `PORT_PARKING_SENSOR_TIMEOUT_MS` after the initialization. If the timer is running, the new period starts at once: the
+ * counter restarts, without requesting a measurement.
+ *
+ * @param period_ms     Time in ms between two measurements.
+ */
+void port_ultrasound_set_measurement_period_ms (uint32_t period_ms);
+
 /**
  * @brief Stop the timer that controls the trigger signal.
  * This function stops the timer that controls the trigger signal because the time to trigger the ultrasound sensor has finished. It also sets the trigger signal to low.
@@ -205,5 +224,32 @@ void port_ultrasound_stop_trigger_timer (uint32_t ultrasound_id);
  */
 void port_ultrasound_stop_ultrasound (uint32_t ultrasound_id);    
 
+/**
+ * @brief Power up the ultrasound sensor.
+ * This function enables the supply of the sensor and stores the time of the power up, so the first trigger is delayed until the sensor has settled.
+ * It does nothing if the sensor is already powered or if it has no supply-enable pin.
+ * 
+ * @param ultrasound_id     Ultrasound ID. This index is used to select the element of the ultrasound_arr[] array.
+ */
+void port_ultrasound_power_on (uint32_t ultrasound_id);
+
+/**
+ * @brief Power down the ultrasound sensor.
+ * This function disables the supply of the sensor. It does nothing if the sensor has no supply-enable pin.
+ * 
+ * @param ultrasound_id     Ultrasound ID. This index is used to select the element of the ultrasound_arr[] array.
+ */
+void port_ultrasound_power_off (uint32_t ultrasound_id);
+
+/**
+ * @brief Get the time left for the ultrasound sensor to be ready after a power up.
+ * This function returns 0 if the sensor is powered and has settled, or if it has no supply-enable pin.
+ * The scheduler of the measurements uses it to avoid triggering a sensor that is still settling.
+ * 
+ * @param ultrasound_id     Ultrasound ID. This index is used to select the element of the ultrasound_arr[] array.
+ * @return uint32_t         Time in ms until the sensor can be triggered. `PORT_PARKING_SENSOR_POWER_SETTLE_MS` if it is powered off.
+ */
+uint32_t port_ultrasound_get_settle_remaining_ms (uint32_t ultrasound_id);
+
 
 #endif /* PORT_ULTRASOUND_H_ */
\ No newline at end of file
@@ -0,0 +1,436 @@
+# Generator of the port tables of the STM32F4 platform from the description of the board.
+#
+# It reads a board description (JSON) with the sensors, displays and buttons, and emits into OUTPUT_DIR:
+#   stm32f4_board.h: the pins, alternate functions and timers of each element, and the initializers of the const tables
+#                    of the drivers.
+#   stm32f4_board.c: the init and start functions of the timers of each element, specialised for its timers and channels.
+#                    The fields of the channels of a timer are merged into one access per register (stm32f4_reg.h).
+#   stm32f4_board_isr.c: the ISRs of the timers of the ultrasound sensors, which hand their timer to the driver. It is linked
+#                    with each executable, like interr.c, so the ISRs are not dropped by the linker.
+# Adding an element to the board only changes the description: the drivers index the tables and never switch on the ID.
+#
+# The description is checked before anything is written: unknown GPIOs, pins, timers or channels, alternate functions that
+# do not match the timer, and pins or timers used twice are reported as errors.
+#
+# Usage (done by port/stm32f4/CMakeLists.txt at configure time):
+#   cmake -DBOARD_FILE=<board.json> -DOUTPUT_DIR=<dir> -P stm32f4_board_gen.cmake
+CMAKE_MINIMUM_REQUIRED(VERSION 3.19) # string(JSON)
+
+IF(NOT DEFINED BOARD_FILE OR NOT DEFINED OUTPUT_DIR)
+    MESSAGE(FATAL_ERROR "Usage: cmake -DBOARD_FILE=<board.json> -DOUTPUT_DIR=<dir> -P stm32f4_board_gen.cmake")
+ENDIF()
+FILE(READ ${BOARD_FILE} BOARD_JSON)
+
+SET(USED_PINS "")   # GPIOx:pin of the signals already assigned
+SET(USED_TIMERS "") # Timers already assigned
+
+########################################################################################
+## Helpers                                                                            ##
+########################################################################################
+# Read a member of the description. Missing members are an error.
+FUNCTION(BOARD_GET out)
+    STRING(JSON value ERROR_VARIABLE error GET "${BOARD_JSON}" ${ARGN})
+    IF(error)
+        STRING(REPLACE ";" "." path "${ARGN}")
+        MESSAGE(FATAL_ERROR "${BOARD_FILE}: missing '${path}' (${error})")
+    ENDIF()
+    SET(${out} "${value}" PARENT_SCOPE)
+ENDFUNCTION()
+
+# Check that a value is an integer in [min, max].
+FUNCTION(BOARD_CHECK_RANGE what value min max)
+    IF(NOT value MATCHES "^[0-9]+$" OR value LESS min OR value GREATER max)
+        MESSAGE(FATAL_ERROR "${BOARD_FILE}: ${what} must be in [${min}, ${max}], got '${value}'")
+    ENDIF()
+ENDFUNCTION()
+
+# Read the GPIO and pin of a signal and check that the pin is not used by another signal.
+FUNCTION(BOARD_GET_PIN prefix what)
+    BOARD_GET(gpio ${ARGN} gpio)
+    BOARD_GET(pin ${ARGN} pin)
+    IF(NOT gpio MATCHES "^GPIO[A-H]$")
+        MESSAGE(FATAL_ERROR "${BOARD_FILE}: ${what} has an unknown GPIO '${gpio}'")
+    ENDIF()
+    BOARD_CHECK_RANGE("the pin of ${what}" ${pin} 0 15)
+    IF("${gpio}:${pin}" IN_LIST USED_PINS)
+        MESSAGE(FATAL_ERROR "${BOARD_FILE}: ${what} uses ${gpio} pin ${pin}, which is already assigned")
+    ENDIF()
+    SET(USED_PINS ${USED_PINS} "${gpio}:${pin}" PARENT_SCOPE)
+    SET(${prefix}_GPIO ${gpio} PARENT_SCOPE)
+    SET(${prefix}_PIN ${pin} PARENT_SCOPE)
+ENDFUNCTION()
+
+# Read a timer and derive its names. Only the general-purpose timers TIM2 to TIM5 are supported: they have 4 channels, an
+# interrupt of their own and they are clocked from APB1. A timer has a single function in the board.
+FUNCTION(BOARD_GET_TIMER prefix what)
+    BOARD_GET(timer ${ARGN} timer)
+    BOARD_CHECK_RANGE("the timer of ${what}" ${timer} 2 5)
+    IF("${timer}" IN_LIST USED_TIMERS)
+        MESSAGE(FATAL_ERROR "${BOARD_FILE}: ${what} uses TIM${timer}, which is already assigned")
+    ENDIF()
+    SET(USED_TIMERS ${USED_TIMERS} ${timer} PARENT_SCOPE)
+    SET(${prefix}_TIM TIM${timer} PARENT_SCOPE)
+    SET(${prefix}_IRQN TIM${timer}_IRQn PARENT_SCOPE)
+    SET(${prefix}_RCC_EN RCC_APB1ENR_TIM${timer}EN PARENT_SCOPE)
+    # Alternate function of the channels of the timer on the STM32F4
+    IF(timer EQUAL 2)
+        SET(${prefix}_AF 1 PARENT_SCOPE)
+    ELSE()
+        SET(${prefix}_AF 2 PARENT_SCOPE)
+    ENDIF()
+ENDFUNCTION()
+
+# Check the alternate function of a signal against the one of its timer.
+FUNCTION(BOARD_CHECK_AF what af timer_af)
+    IF(NOT af EQUAL timer_af)
+        MESSAGE(FATAL_ERROR "${BOARD_FILE}: ${what} must use AF${timer_af} for its timer, got AF${af}")
+    ENDIF()
+ENDFUNCTION()
+
+# Derive the names of the registers and bits of a channel of a timer.
+FUNCTION(BOARD_CHANNEL prefix what channel)
+    BOARD_CHECK_RANGE("the channel of ${what}" ${channel} 1 4)
+    IF(channel LESS_EQUAL 2)
+        SET(ccmr CCMR1)
+    ELSE()
+        SET(ccmr CCMR2)
+    ENDIF()
+    SET(${prefix}_CH ${channel} PARENT_SCOPE)
+    SET(${prefix}_CCMR ${ccmr} PARENT_SCOPE)
+    SET(${prefix}_CCR CCR${channel} PARENT_SCOPE)
+ENDFUNCTION()
+
+# Read the priority of an interrupt.
+FUNCTION(BOARD_GET_PRIO out what)
+    BOARD_GET(prio ${ARGN} irq_priority)
+    BOARD_CHECK_RANGE("the interrupt priority of ${what}" ${prio} 0 15)
+    SET(${out} ${prio} PARENT_SCOPE)
+ENDFUNCTION()
+
+# Write a file only if its content changes, so the sources that include it are not rebuilt for nothing.
+FUNCTION(BOARD_WRITE file content)
+    IF(EXISTS ${file})
+        FILE(READ ${file} old)
+        IF(old STREQUAL content)
+            RETURN()
+        ENDIF()
+    ENDIF()
+    FILE(WRITE ${file} "${content}")
+ENDFUNCTION()
+
+########################################################################################
+## Ultrasound sensors                                                                 ##
+########################################################################################
+BOARD_GET(BOARD_NAME board)
+BOARD_GET_TIMER(MEAS "the measurement timer" ultrasound measurement_timer)
+BOARD_GET_PRIO(MEAS_PRIO "the measurement timer" ultrasound measurement_timer)
+
+SET(H_PINS "")
+SET(H_PROTOS "")
+SET(H_ULTRASOUNDS "")
+SET(H_DISPLAYS "")
+SET(H_BUTTONS "")
+SET(C_FUNCS "")
+SET(C_ISRS "")
+SET(USED_IDS "")
+
+STRING(APPEND H_PINS "/* Ultrasound sensors */\n")
+STRING(APPEND H_PINS "#define STM32F4_ULTRASOUND_MEASUREMENT_TIM ${MEAS_TIM}              /*!<    Timer of the measurement period, shared by all the sensors   */\n")
+STRING(APPEND H_PINS "#define STM32F4_ULTRASOUND_MEASUREMENT_IRQN ${MEAS_IRQN}       /*!<    Interrupt of the timer of the measurement period   */\n")
+STRING(APPEND H_PINS "#define STM32F4_ULTRASOUND_MEASUREMENT_RCC_EN ${MEAS_RCC_EN} /*!<    Clock enable bit (APB1) of the timer of the measurement period   */\n")
+STRING(APPEND H_PINS "#define STM32F4_ULTRASOUND_MEASUREMENT_IRQ_PRIO ${MEAS_PRIO}           /*!<    Priority of the interrupt of the measurement period   */\n")
+
+STRING(REPLACE "_IRQn" "_IRQHandler" MEAS_HANDLER ${MEAS_IRQN})
+STRING(CONFIGURE [=[
+
+/**
+ * @brief Interrupt service routine for @MEAS_TIM@, the timer of the measurement period of all the ultrasound sensors.
+ */
+void @MEAS_HANDLER@(void)
+{
+    stm32f4_ultrasound_measurement_timer_isr();
+}
+]=] ISR @ONLY)
+STRING(APPEND C_ISRS "${ISR}")
+
+STRING(JSON NUM_SENSORS LENGTH "${BOARD_JSON}" ultrasound sensors)
+MATH(EXPR LAST_SENSOR "${NUM_SENSORS} - 1")
+FOREACH(i RANGE ${LAST_SENSOR})
+    BOARD_GET(NAME ultrasound sensors ${i} name)
+    BOARD_GET(ID ultrasound sensors ${i} id)
+    STRING(TOLOWER ${NAME} FN)
+    IF("${ID}" IN_LIST USED_IDS)
+        MESSAGE(FATAL_ERROR "${BOARD_FILE}: ${ID} is used by more than one element")
+    ENDIF()
+    LIST(APPEND USED_IDS ${ID})
+
+    BOARD_GET_PIN(TRIG "the trigger of ${NAME}" ultrasound sensors ${i} trigger)
+    BOARD_GET_TIMER(TRIG "the trigger of ${NAME}" ultrasound sensors ${i} trigger)
+    BOARD_GET_PRIO(TRIG_PRIO "the trigger of ${NAME}" ultrasound sensors ${i} trigger)
+
+    BOARD_GET_PIN(ECHO "the echo of ${NAME}" ultrasound sensors ${i} echo)
+    BOARD_GET_TIMER(ECHO "the echo of ${NAME}" ultrasound sensors ${i} echo)
+    BOARD_GET_PRIO(ECHO_PRIO "the echo of ${NAME}" ultrasound sensors ${i} echo)
+    BOARD_GET(ECHO_AF_CFG ultrasound sensors ${i} echo af)
+    BOARD_CHECK_AF("the echo of ${NAME}" ${ECHO_AF_CFG} ${ECHO_AF})
+    BOARD_GET(ECHO_CH ultrasound sensors ${i} echo channel)
+    BOARD_CHANNEL(ECHO "the echo of ${NAME}" ${ECHO_CH})
+
+    STRING(JSON POWER_TYPE TYPE "${BOARD_JSON}" ultrasound sensors ${i} power)
+    IF(POWER_TYPE STREQUAL "NULL")
+        SET(POWER_GPIO NULL)
+        SET(POWER_PIN 0)
+    ELSE()
+        BOARD_GET_PIN(POWER "the power supply of ${NAME}" ultrasound sensors ${i} power)
+    ENDIF()
+
+    STRING(APPEND H_PINS "#define STM32F4_${NAME}_TRIGGER_GPIO ${TRIG_GPIO}    /*!<    Ultrasound trigger signal GPIO port   */\n")
+    STRING(APPEND H_PINS "#define STM32F4_${NAME}_TRIGGER_PIN ${TRIG_PIN}        /*!<    Ultrasound trigger signal GPIO pin   */\n")
+    STRING(APPEND H_PINS "#define STM32F4_${NAME}_TRIGGER_TIM ${TRIG_TIM}     /*!<    Timer of the duration of the trigger signal   */\n")
+    STRING(APPEND H_PINS "#define STM32F4_${NAME}_ECHO_GPIO ${ECHO_GPIO}       /*!<    Ultrasound echo signal GPIO port   */\n")
+    STRING(APPEND H_PINS "#define STM32F4_${NAME}_ECHO_PIN ${ECHO_PIN}           /*!<    Ultrasound echo signal GPIO pin   */\n")
+    STRING(APPEND H_PINS "#define STM32F4_${NAME}_ECHO_AF STM32F4_AF${ECHO_AF}  /*!<    Alternate function of the echo signal   */\n")
+    STRING(APPEND H_PINS "#define STM32F4_${NAME}_ECHO_TIM ${ECHO_TIM}        /*!<    Timer that captures the echo signal   */\n")
+    STRING(APPEND H_PINS "#define STM32F4_${NAME}_ECHO_CHANNEL ${ECHO_CH}       /*!<    Input capture channel of the echo signal   */\n")
+    STRING(APPEND H_PINS "#define STM32F4_${NAME}_POWER_GPIO ${POWER_GPIO}       /*!<    Ultrasound supply-enable GPIO port. NULL if the sensor is always powered   */\n")
+    STRING(APPEND H_PINS "#define STM32F4_${NAME}_POWER_PIN ${POWER_PIN}          /*!<    Ultrasound supply-enable GPIO pin (active high). Ignored if the port is NULL   */\n")
+
+    STRING(APPEND H_PROTOS "void stm32f4_board_${FN}_timers_init(void);\n")
+    STRING(APPEND H_PROTOS "void stm32f4_board_${FN}_timers_start(void);\n")
+
+    STRING(APPEND H_ULTRASOUNDS " \\\n    [${ID}] = {.p_echo_port = STM32F4_${NAME}_ECHO_GPIO, .p_trigger_port = STM32F4_${NAME}_TRIGGER_GPIO, .p_power_port = STM32F4_${NAME}_POWER_GPIO, .trigger_pin = STM32F4_${NAME}_TRIGGER_PIN, .echo_alt_fun = STM32F4_${NAME}_ECHO_AF, .echo_pin = STM32F4_${NAME}_ECHO_PIN, .power_pin = STM32F4_${NAME}_POWER_PIN, .echo_channel = STM32F4_${NAME}_ECHO_CHANNEL, .p_echo_tim = STM32F4_${NAME}_ECHO_TIM, .p_trigger_tim = STM32F4_${NAME}_TRIGGER_TIM, .p_timers_init = stm32f4_board_${FN}_timers_init, .p_timers_start = stm32f4_board_${FN}_timers_start},")
+
+    STRING(CONFIGURE [=[
+
+/**
+ * @brief Enable the clocks of the timers of the @NAME@, configure the input capture of its echo and the priorities of its interrupts.
+ */
+void stm32f4_board_@FN@_timers_init(void)
+{
+    RCC->APB1ENR |= @TRIG_RCC_EN@ | @ECHO_RCC_EN@;
+
+    // Echo: channel @ECHO_CH@ as input mapped on TI@ECHO_CH@, no filter, no prescaler, both edges
+    STM32F4_REG_MODIFY(@ECHO_TIM@->@ECHO_CCMR@,
+                       STM32F4_REG_FIELD(TIM_@ECHO_CCMR@_CC@ECHO_CH@S, TIM_@ECHO_CCMR@_CC@ECHO_CH@S_0),
+                       STM32F4_REG_FIELD(TIM_@ECHO_CCMR@_IC@ECHO_CH@F, 0),
+                       STM32F4_REG_FIELD(TIM_@ECHO_CCMR@_IC@ECHO_CH@PSC, 0));
+    @ECHO_TIM@->CCER |= TIM_CCER_CC@ECHO_CH@P | TIM_CCER_CC@ECHO_CH@NP | TIM_CCER_CC@ECHO_CH@E;
+    @ECHO_TIM@->DIER |= TIM_DIER_CC@ECHO_CH@IE;
+
+    NVIC_SetPriority(@TRIG_IRQN@, @TRIG_PRIO@);
+    NVIC_SetPriority(@ECHO_IRQN@, @ECHO_PRIO@);
+}
+
+/**
+ * @brief Start the timers of the trigger and the echo of the @NAME@ from 0.
+ */
+void stm32f4_board_@FN@_timers_start(void)
+{
+    @ECHO_TIM@->CNT = 0;
+    @TRIG_TIM@->CNT = 0;
+
+    NVIC_EnableIRQ(@ECHO_IRQN@);
+    NVIC_EnableIRQ(@TRIG_IRQN@);
+
+    @ECHO_TIM@->CR1 |= TIM_CR1_CEN;
+    @TRIG_TIM@->CR1 |= TIM_CR1_CEN;
+}
+]=] FUNCS @ONLY)
+    STRING(APPEND C_FUNCS "${FUNCS}")
+
+    # The echo ISR bounds the resolution of the measurement: it is executed from SRAM and its latency can be probed
+    STRING(REPLACE "_IRQn" "_IRQHandler" ECHO_HANDLER ${ECHO_IRQN})
+    STRING(REPLACE "_IRQn" "_IRQHandler" TRIG_HANDLER ${TRIG_IRQN})
+    STRING(CONFIGURE [=[
+
+/**
+ * @brief Interrupt service routine for @ECHO_TIM@, the timer that captures the echo of the @NAME@.
+ */
+PORT_RAMFUNC void @ECHO_HANDLER@(void)
+{
+    STM32F4_IRQ_LATENCY_PROBE(@ECHO_IRQN@);
+
+    port_system_systick_resume();
+
+    stm32f4_ultrasound_echo_timer_isr(STM32F4_@NAME@_ECHO_TIM);
+}
+
+/**
+ * @brief Interrupt service routine for @TRIG_TIM@, the timer of the duration of the trigger of the @NAME@.
+ */
+void @TRIG_HANDLER@(void)
+{
+    stm32f4_ultrasound_trigger_timer_isr(STM32F4_@NAME@_TRIGGER_TIM);
+}
+]=] ISR @ONLY)
+    STRING(APPEND C_ISRS "${ISR}")
+ENDFOREACH()
+
+########################################################################################
+## Displays                                                                           ##
+########################################################################################
+STRING(APPEND H_PINS "\n/* Displays */\n")
+STRING(JSON NUM_DISPLAYS LENGTH "${BOARD_JSON}" displays)
+MATH(EXPR LAST_DISPLAY "${NUM_DISPLAYS} - 1")
+FOREACH(i RANGE ${LAST_DISPLAY})
+    BOARD_GET(NAME displays ${i} name)
+    BOARD_GET(ID displays ${i} id)
+    STRING(TOLOWER ${NAME} FN)
+    IF("${ID}" IN_LIST USED_IDS)
+        MESSAGE(FATAL_ERROR "${BOARD_FILE}: ${ID} is used by more than one element")
+    ENDIF()
+    LIST(APPEND USED_IDS ${ID})
+
+    BOARD_GET_TIMER(PWM "the PWM of ${NAME}" displays ${i})
+    BOARD_GET(PWM_AF_CFG displays ${i} af)
+    BOARD_CHECK_AF("the PWM of ${NAME}" ${PWM_AF_CFG} ${PWM_AF})
+
+    STRING(APPEND H_PINS "#define STM32F4_${NAME}_TIM ${PWM_TIM}             /*!<    Timer of the PWM of the RGB LED   */\n")
+    STRING(APPEND H_PINS "#define STM32F4_${NAME}_AF STM32F4_AF${PWM_AF}         /*!<    Alternate function of the pins of the RGB LED   */\n")
+
+    SET(COLOR_NAME_R red)
+    SET(COLOR_NAME_G green)
+    SET(COLOR_NAME_B blue)
+    SET(INIT_CHANNELS "")
+    SET(FIELDS_CCER "")
+    SET(FIELDS_CCMR1 "")
+    SET(FIELDS_CCMR2 "")
+    SET(CHANNELS_INIT "")
+    SET(CHANNELS_USED "")
+    FOREACH(COLOR R G B)
+        SET(color ${COLOR_NAME_${COLOR}})
+        STRING(TOLOWER ${COLOR} COLOR_KEY)
+        BOARD_GET_PIN(LED "the ${color} LED of ${NAME}" displays ${i} rgb_${COLOR_KEY})
+        BOARD_GET(LED_CH displays ${i} rgb_${COLOR_KEY} channel)
+        BOARD_CHANNEL(LED "the ${color} LED of ${NAME}" ${LED_CH})
+        IF(LED_CH IN_LIST CHANNELS_USED)
+            MESSAGE(FATAL_ERROR "${BOARD_FILE}: the ${color} LED of ${NAME} uses channel ${LED_CH}, which is already assigned")
+        ENDIF()
+        LIST(APPEND CHANNELS_USED ${LED_CH})
+
+        STRING(APPEND H_PINS "#define STM32F4_${NAME}_RGB_${COLOR}_GPIO ${LED_GPIO}   /*!<    GPIO port of the ${color} LED   */\n")
+        STRING(APPEND H_PINS "#define STM32F4_${NAME}_RGB_${COLOR}_PIN ${LED_PIN}       /*!<    GPIO pin of the ${color} LED   */\n")
+        STRING(APPEND H_PINS "#define STM32F4_${NAME}_RGB_${COLOR}_CHANNEL ${LED_CH}   /*!<    PWM channel of the ${color} LED   */\n")
+
+        STRING(APPEND CHANNELS_INIT "{.p_port = STM32F4_${NAME}_RGB_${COLOR}_GPIO, .pin = STM32F4_${NAME}_RGB_${COLOR}_PIN, .p_ccr = &STM32F4_${NAME}_TIM->${LED_CCR}, .ccer_en = TIM_CCER_CC${LED_CH}E}, ")
+
+        # Fields of the channel, merged with the ones of the other channels in the same registers
+        STRING(APPEND INIT_CHANNELS "    // Channel ${LED_CH} (${color} LED): disabled, active high, PWM mode 1 with preload\n")
+        LIST(APPEND FIELDS_CCER "STM32F4_REG_FIELD(TIM_CCER_CC${LED_CH}E | TIM_CCER_CC${LED_CH}P | TIM_CCER_CC${LED_CH}NP, 0)")
+        LIST(APPEND FIELDS_${LED_CCMR} "STM32F4_REG_FIELD(TIM_${LED_CCMR}_OC${LED_CH}M | TIM_${LED_CCMR}_OC${LED_CH}PE, TIM_${LED_CCMR}_OC${LED_CH}M_2 | TIM_${LED_CCMR}_OC${LED_CH}M_1 | TIM_${LED_CCMR}_OC${LED_CH}PE)")
+    ENDFOREACH()
+    FOREACH(REG CCER CCMR1 CCMR2)
+        IF(FIELDS_${REG})
+            LIST(JOIN FIELDS_${REG} ",\n                       " FIELDS)
+            STRING(APPEND INIT_CHANNELS "    STM32F4_REG_MODIFY(${PWM_TIM}->${REG},\n                       ${FIELDS});\n")
+        ENDIF()
+    ENDFOREACH()
+
+    STRING(APPEND H_PROTOS "void stm32f4_board_${FN}_pwm_init(void);\n")
+    STRING(APPEND H_DISPLAYS " \\\n    [${ID}] = {.p_tim = STM32F4_${NAME}_TIM, .alt_fun = STM32F4_${NAME}_AF, .p_pwm_init = stm32f4_board_${FN}_pwm_init, .channels = {${CHANNELS_INIT}}, .pwm_freq_hz = PORT_DISPLAY_PWM_FREQ_HZ},")
+
+    STRING(CONFIGURE [=[
+
+/**
+ * @brief Enable the clock of the PWM timer of the @NAME@ and configure the channels of its RGB LED.
+ */
+void stm32f4_board_@FN@_pwm_init(void)
+{
+    RCC->APB1ENR |= @PWM_RCC_EN@;
+
+@INIT_CHANNELS@}
+]=] FUNCS @ONLY)
+    STRING(APPEND C_FUNCS "${FUNCS}")
+ENDFOREACH()
+
+########################################################################################
+## Buttons                                                                            ##
+########################################################################################
+STRING(APPEND H_PINS "\n/* Buttons */\n")
+STRING(JSON NUM_BUTTONS LENGTH "${BOARD_JSON}" buttons)
+MATH(EXPR LAST_BUTTON "${NUM_BUTTONS} - 1")
+FOREACH(i RANGE ${LAST_BUTTON})
+    BOARD_GET(NAME buttons ${i} name)
+    BOARD_GET(ID buttons ${i} id)
+    IF("${ID}" IN_LIST USED_IDS)
+        MESSAGE(FATAL_ERROR "${BOARD_FILE}: ${ID} is used by more than one element")
+    ENDIF()
+    LIST(APPEND USED_IDS ${ID})
+
+    BOARD_GET_PIN(BTN "${NAME}" buttons ${i})
+    BOARD_GET_PRIO(BTN_PRIO "${NAME}" buttons ${i})
+    BOARD_GET(BTN_PULL buttons ${i} pull)
+    IF(NOT BTN_PULL MATCHES "^(NOPULL|PULLUP|PULLDOWN)$")
+        MESSAGE(FATAL_ERROR "${BOARD_FILE}: the pull of ${NAME} must be NOPULL, PULLUP or PULLDOWN, got '${BTN_PULL}'")
+    ENDIF()
+
+    STRING(APPEND H_PINS "#define STM32F4_${NAME}_GPIO ${BTN_GPIO}   /*!<    GPIO port of the button   */\n")
+    STRING(APPEND H_PINS "#define STM32F4_${NAME}_PIN ${BTN_PIN}      /*!<    GPIO pin of the button   */\n")
+
+    STRING(APPEND H_BUTTONS " \\\n    [${ID}] = {.p_port = STM32F4_${NAME}_GPIO, .pin = STM32F4_${NAME}_PIN, .pupd_mode = STM32F4_GPIO_PUPDR_${BTN_PULL}, .irq_prio = ${BTN_PRIO}},")
+ENDFOREACH()
+
+########################################################################################
+## Output                                                                             ##
+########################################################################################
+GET_FILENAME_COMPONENT(BOARD_FILE_NAME ${BOARD_FILE} NAME)
+
+STRING(CONFIGURE [=[
+/**
+ * @file stm32f4_board.h
+ * @brief Pins, alternate functions and timers of the @BOARD_NAME@, and initializers of the tables of the drivers.
+ *
+ * Generated by stm32f4_board_gen.cmake from @BOARD_FILE_NAME@. Do not edit: change the description of the board instead.
+ */
+#ifndef STM32F4_BOARD_H_
+#define STM32F4_BOARD_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* HW dependent includes */
+#include "stm32f4xx.h"
+#include "stm32f4_system.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+@H_PINS@
+/* Initializers of the tables of the drivers, indexed by the ID of each element */
+#define STM32F4_BOARD_ULTRASOUNDS@H_ULTRASOUNDS@
+#define STM32F4_BOARD_DISPLAYS@H_DISPLAYS@
+#define STM32F4_BOARD_BUTTONS@H_BUTTONS@
+
+/* Function prototypes and explanation -------------------------------------------------*/
+@H_PROTOS@
+#endif /* STM32F4_BOARD_H_ */
+]=] HEADER @ONLY)
+
+STRING(CONFIGURE [=[
+/**
+ * @file stm32f4_board.c
+ * @brief Init and start functions of the timers of the @BOARD_NAME@, specialised for the timers and channels of each element.
+ *
+ * Generated by stm32f4_board_gen.cmake from @BOARD_FILE_NAME@. Do not edit: change the description of the board instead.
+ */
+
+/* HW dependent includes */
+#include "stm32f4_reg.h"
+#include "stm32f4_board.h"
+@C_FUNCS@]=] SOURCE @ONLY)
+
+STRING(CONFIGURE [=[
+/**
+ * @file stm32f4_board_isr.c
+ * @brief Interrupt service routines of the timers of the ultrasound sensors of the @BOARD_NAME@.
+ * Each ISR hands its timer to the driver, which serves every sensor that uses it.
+ *
+ * Generated by stm32f4_board_gen.cmake from @BOARD_FILE_NAME@. Do not edit: change the description of the board instead.
+ */
+
+/* HW dependent includes */
+#include "port_system.h"
+#include "stm32f4_system.h"
+#include "stm32f4_board.h"
+#include "stm32f4_ultrasound.h"
+@C_ISRS@]=] ISR_SOURCE @ONLY)
+
+BOARD_WRITE(${OUTPUT_DIR}/stm32f4_board.h "${HEADER}")
+BOARD_WRITE(${OUTPUT_DIR}/stm32f4_board.c "${SOURCE}")
+BOARD_WRITE(${OUTPUT_DIR}/stm32f4_board_isr.c "${ISR_SOURCE}")
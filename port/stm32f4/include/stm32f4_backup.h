@@ -0,0 +1,46 @@
+/**
+ * @file stm32f4_backup.h
+ * @brief Header for stm32f4_backup.c file.
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+#ifndef STM32F4_BACKUP_H_
+#define STM32F4_BACKUP_H_
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* HW dependent includes */
+#include "stm32f4xx.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define STM32F4_BACKUP_SRAM_BASE BKPSRAM_BASE   /*!<    Base address of the backup SRAM. It keeps its content in Stop and Standby modes and through the resets   */
+#define STM32F4_BACKUP_SRAM_SIZE 4096U          /*!<    Size of the backup SRAM in bytes   */
+#define STM32F4_BACKUP_MAGIC 0x55524253U        /*!<    Marker of a snapshot written by this driver ("URBS")   */
+#define STM32F4_BACKUP_BRR_TIMEOUT 100000U      /*!<    Maximum number of polls of the ready flag of the backup regulator   */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Header of the snapshot at the beginning of the backup SRAM. The data of the snapshot follows it.
+ */
+typedef struct
+{
+    uint32_t magic;     /*!<    `STM32F4_BACKUP_MAGIC` if a snapshot has been written   */
+    uint32_t size;      /*!<    Size of the data in bytes   */
+    uint32_t crc;       /*!<    CRC-32 of the size and the data, computed by the CRC unit   */
+} stm32f4_backup_header_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Compute the CRC-32 (polynomial 0x04C11DB7, as the CRC unit) of a size and a block of data.
+ * The data is fed in words of 4 bytes (little endian); the last word is padded with zeros.
+ *
+ * @param p_data    Pointer to the data.
+ * @param size      Size of the data in bytes.
+ * @return uint32_t CRC of the block.
+ */
+uint32_t stm32f4_backup_crc(const uint8_t *p_data, uint32_t size);
+
+#endif /* STM32F4_BACKUP_H_ */
@@ -13,13 +13,7 @@
 
 /* HW dependent includes */
 #include "stm32f4xx.h"
-
-/* Defines and enums ----------------------------------------------------------*/
-/* Defines */
-#define STM32F4_PARKING_BUTTON_GPIO GPIOC   // Name of the GPIO
-#define STM32F4_PARKING_BUTTON_PIN 13       // Pin (Number) of the GPIO
-
-
+#include "stm32f4_board.h"     // Pins of the buttons (STM32F4_<BUTTON>_GPIO, ...), generated from the board description
 
 /* Function prototypes and explanation -------------------------------------------------*/
 /**
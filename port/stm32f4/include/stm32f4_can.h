@@ -0,0 +1,41 @@
+/**
+ * @file stm32f4_can.h
+ * @brief Header for stm32f4_can.c file.
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+#ifndef STM32F4_CAN_H_
+#define STM32F4_CAN_H_
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* HW dependent includes */
+#include "stm32f4xx.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define STM32F4_CAN CAN1                    /*!<    CAN controller (bxCAN master)   */
+#define STM32F4_CAN_RX_GPIO GPIOA           /*!<    CAN RX GPIO port   */
+#define STM32F4_CAN_RX_PIN 11               /*!<    CAN RX GPIO pin   */
+#define STM32F4_CAN_TX_GPIO GPIOA           /*!<    CAN TX GPIO port   */
+#define STM32F4_CAN_TX_PIN 12               /*!<    CAN TX GPIO pin   */
+#define STM32F4_CAN_AF 9                    /*!<    Alternate function of CAN1 in the RX and TX pins   */
+
+#define STM32F4_CAN_MAX_TQ 16               /*!<    Maximum number of time quanta per bit searched for the bit timing   */
+#define STM32F4_CAN_MIN_TQ 8                /*!<    Minimum number of time quanta per bit searched for the bit timing   */
+#define STM32F4_CAN_SJW_TQ 1                /*!<    Resynchronization jump width in time quanta   */
+#define STM32F4_CAN_MODE_TIMEOUT 100000     /*!<    Maximum number of polls of the acknowledge of a change of mode   */
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Compute the value of the bit timing register for a bit rate, with a sample point of about 87.5 %.
+ *
+ * @param pclk_hz   Clock of the controller (APB1) in Hz.
+ * @param bitrate   Bit rate in bit/s.
+ * @return uint32_t Value of the fields BRP, TS1, TS2 and SJW of CAN_BTR. 0 if the bit rate cannot be generated exactly from the clock.
+ */
+uint32_t stm32f4_can_compute_btr(uint32_t pclk_hz, uint32_t bitrate);
+
+#endif /* STM32F4_CAN_H_ */
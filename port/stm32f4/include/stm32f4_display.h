@@ -14,15 +14,11 @@
 
 /* HW dependent includes */
 #include "stm32f4xx.h"
+#include "stm32f4_board.h"     // Pins and timers of the displays (STM32F4_<DISPLAY>_RGB_R_GPIO, ...), generated from the board description
 
 /* Defines and enums ----------------------------------------------------------*/
 /* Defines */
-#define 	STM32F4_REAR_PARKING_DISPLAY_RGB_R_GPIO GPIOB   /*!<    Red LED GPIO port   */
-#define 	STM32F4_REAR_PARKING_DISPLAY_RGB_R_PIN  6       /*!<    Red LED GPIO pin    */
-#define 	STM32F4_REAR_PARKING_DISPLAY_RGB_G_GPIO GPIOB   /*!<    Green LED GPIO port */
-#define 	STM32F4_REAR_PARKING_DISPLAY_RGB_G_PIN  8       /*!<    Green LED GPIO pin  */
-#define 	STM32F4_REAR_PARKING_DISPLAY_RGB_B_GPIO GPIOB   /*!<    Blue LED GPIO port  */
-#define 	STM32F4_REAR_PARKING_DISPLAY_RGB_B_PIN  9       /*!<    Blue LED GPIO pin   */
+#define 	STM32F4_DISPLAY_PWM_MIN_STEPS           1024    /*!<    Minimum number of timer ticks per PWM period (10 bits), so each level of the palette maps to a different duty   */
 
 
 #endif /* STM32F4_DISPLAY_SYSTEM_H_ */
\ No newline at end of file
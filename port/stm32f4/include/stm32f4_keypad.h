@@ -0,0 +1,60 @@
+/**
+ * @file stm32f4_keypad.h
+ * @brief Header for stm32f4_keypad.c file.
+ *
+ * All the inputs of the keypad (direct keys and matrix columns) are in the same GPIO port, so a single DMA transfer of its IDR samples all of them.
+ * TIM8 paces two DMA2 streams: the CC1 event writes the next row pattern into the BSRR of the rows port and,
+ * half a period later, the update event copies the IDR of the inputs port into the scan buffer.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+#ifndef STM32F4_KEYPAD_H_
+#define STM32F4_KEYPAD_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* HW dependent includes */
+#include "stm32f4xx.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define STM32F4_KEYPAD_INPUT_GPIO GPIOC         /*!<    GPIO port of the direct keys and the columns of the matrix (inputs with pull-up, active low)   */
+#define STM32F4_KEYPAD_AUX_1_PIN 3              /*!<    Pin of the direct auxiliary key 1   */
+#define STM32F4_KEYPAD_AUX_2_PIN 4              /*!<    Pin of the direct auxiliary key 2   */
+#define STM32F4_KEYPAD_COL_0_PIN 0              /*!<    Pin of the column 0 of the matrix   */
+#define STM32F4_KEYPAD_COL_1_PIN 1              /*!<    Pin of the column 1 of the matrix   */
+#define STM32F4_KEYPAD_COL_2_PIN 2              /*!<    Pin of the column 2 of the matrix   */
+
+#define STM32F4_KEYPAD_ROW_GPIO GPIOB           /*!<    GPIO port of the rows of the matrix (outputs, the active row is driven low)   */
+#define STM32F4_KEYPAD_ROW_0_PIN 12             /*!<    Pin of the row 0 of the matrix   */
+#define STM32F4_KEYPAD_ROW_1_PIN 13             /*!<    Pin of the row 1 of the matrix   */
+#define STM32F4_KEYPAD_NUM_ROWS 2               /*!<    Number of rows of the matrix. A complete scan takes one sample per row   */
+#define STM32F4_KEYPAD_NO_ROW 0xFF              /*!<    Row of the keys that are not part of the matrix   */
+
+#define STM32F4_KEYPAD_SAMPLE_PERIOD_US 2000    /*!<    Time between two samples of the inputs port in microseconds   */
+
+#define STM32F4_KEYPAD_TIMER TIM8                       /*!<    Timer that paces the sampling   */
+#define STM32F4_KEYPAD_SAMPLE_DMA DMA2_Stream1          /*!<    DMA stream triggered by TIM8_UP that reads the inputs port   */
+#define STM32F4_KEYPAD_ROW_DMA DMA2_Stream2             /*!<    DMA stream triggered by TIM8_CH1 that drives the rows   */
+#define STM32F4_KEYPAD_DMA_CHANNEL 7U                   /*!<    DMA channel of TIM8_UP and TIM8_CH1 in both streams   */
+#define STM32F4_KEYPAD_SAMPLE_DMA_IRQn DMA2_Stream1_IRQn /*!<    IRQ of the sampling DMA stream   */
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Debounce a complete scan of the keypad given the raw samples of the inputs port.
+ * It is called with the DMA buffers by `port_keypad_process_scan()`. It is also used for testing purposes to inject samples without the HW.
+ *
+ * @param p_samples     Array of `STM32F4_KEYPAD_NUM_ROWS` values of the IDR of the inputs port. Sample `i` is taken while row `i` is active.
+ */
+void stm32f4_keypad_process_samples(const uint16_t *p_samples);
+
+/**
+ * @brief Auxiliary function to reset the debounce state of the keypad without starting the sampling. This function is used for testing purposes.
+ */
+void stm32f4_keypad_reset(void);
+
+#endif /* STM32F4_KEYPAD_H_ */
@@ -0,0 +1,103 @@
+/**
+ * @file stm32f4_reg.h
+ * @brief Helpers to configure several fields of a peripheral register with a single access.
+ *
+ * The setup of a peripheral sets many fields of the same registers (CR1, CCER, CCMRx, DIER, ...). Writing each field with
+ * its own `|=` or `&= ~` is a read-modify-write of a volatile register per field. These macros merge the fields of a register
+ * at compile time and emit one access:
+ *
+ * @code
+ * STM32F4_REG_MODIFY(TIMx->CR1,
+ *                    STM32F4_REG_FIELD(TIM_CR1_CEN, 0),
+ *                    STM32F4_REG_FIELD(TIM_CR1_ARPE, TIM_CR1_ARPE));
+ * @endcode
+ *
+ * A field is a mask and the value of its bits. Both must be constant expressions, and they are checked at compile time:
+ * the value must not set bits outside its mask, and the masks of the fields of an access must not overlap (two fields
+ * writing the same bits are a bug of the setup, whatever the order of the writes was).
+ *
+ * Up to `STM32F4_REG_MAX_FIELDS` fields per access.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+#ifndef STM32F4_REG_H_
+#define STM32F4_REG_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+#define STM32F4_REG_MAX_FIELDS 8    /*!< Maximum number of fields of an access */
+
+/**
+ * @brief Field of a register: the bits of `mask` take the value `value` (already shifted to the position of the field).
+ * @hideinitializer
+ */
+#define STM32F4_REG_FIELD(mask, value) ((mask), (value))
+
+/**
+ * @brief Bits of the register written by a list of fields.
+ * @hideinitializer
+ */
+#define STM32F4_REG_MASK(...) (0U STM32F4_REG_FOLD(STM32F4_REG_OR_MASK, __VA_ARGS__))
+
+/**
+ * @brief Value of the bits of the register written by a list of fields.
+ * @hideinitializer
+ */
+#define STM32F4_REG_VALUE(...) (0U STM32F4_REG_FOLD(STM32F4_REG_OR_VALUE, __VA_ARGS__))
+
+/**
+ * @brief Set the fields of a register with a single read-modify-write. The bits outside the fields are kept.
+ * @hideinitializer
+ */
+#define STM32F4_REG_MODIFY(reg, ...)                                                            \
+    do                                                                                          \
+    {                                                                                           \
+        STM32F4_REG_CHECK(__VA_ARGS__);                                                         \
+        (reg) = ((reg) & ~STM32F4_REG_MASK(__VA_ARGS__)) | STM32F4_REG_VALUE(__VA_ARGS__);      \
+    } while (0)
+
+/**
+ * @brief Set the fields of a register with a single store, without reading it. The bits outside the fields are cleared.
+ * @hideinitializer
+ */
+#define STM32F4_REG_WRITE(reg, ...)                                                             \
+    do                                                                                          \
+    {                                                                                           \
+        STM32F4_REG_CHECK(__VA_ARGS__);                                                         \
+        (reg) = STM32F4_REG_VALUE(__VA_ARGS__);                                                 \
+    } while (0)
+
+/* Implementation of the macros above. Not to be used directly */
+#define STM32F4_REG_OR_MASK(mask, value) | (uint32_t)(mask)
+#define STM32F4_REG_OR_VALUE(mask, value) | (uint32_t)(value)
+#define STM32F4_REG_ADD_MASK(mask, value) + (uint64_t)(uint32_t)(mask)
+#define STM32F4_REG_OR_STRAY(mask, value) | ((uint32_t)(value) & ~(uint32_t)(mask))
+
+/* The masks do not overlap if and only if their sum equals their OR */
+#define STM32F4_REG_CHECK(...)                                                                                         \
+    _Static_assert((0U STM32F4_REG_FOLD(STM32F4_REG_OR_STRAY, __VA_ARGS__)) == 0, "A field sets bits outside its mask"); \
+    _Static_assert((0U STM32F4_REG_FOLD(STM32F4_REG_ADD_MASK, __VA_ARGS__)) == STM32F4_REG_MASK(__VA_ARGS__),           \
+                   "The fields of a register overlap")
+
+#define STM32F4_REG_CAT(a, b) STM32F4_REG_CAT_(a, b)
+#define STM32F4_REG_CAT_(a, b) a##b
+#define STM32F4_REG_NARGS(...) STM32F4_REG_NARGS_(__VA_ARGS__, 8, 7, 6, 5, 4, 3, 2, 1, 0)
+#define STM32F4_REG_NARGS_(_1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+
+/* Apply op to each field: STM32F4_REG_FIELD() expands to the parenthesized arguments of op */
+#define STM32F4_REG_FOLD(op, ...) STM32F4_REG_CAT(STM32F4_REG_FOLD_, STM32F4_REG_NARGS(__VA_ARGS__))(op, __VA_ARGS__)
+#define STM32F4_REG_FOLD_1(op, f) op f
+#define STM32F4_REG_FOLD_2(op, f, ...) op f STM32F4_REG_FOLD_1(op, __VA_ARGS__)
+#define STM32F4_REG_FOLD_3(op, f, ...) op f STM32F4_REG_FOLD_2(op, __VA_ARGS__)
+#define STM32F4_REG_FOLD_4(op, f, ...) op f STM32F4_REG_FOLD_3(op, __VA_ARGS__)
+#define STM32F4_REG_FOLD_5(op, f, ...) op f STM32F4_REG_FOLD_4(op, __VA_ARGS__)
+#define STM32F4_REG_FOLD_6(op, f, ...) op f STM32F4_REG_FOLD_5(op, __VA_ARGS__)
+#define STM32F4_REG_FOLD_7(op, f, ...) op f STM32F4_REG_FOLD_6(op, __VA_ARGS__)
+#define STM32F4_REG_FOLD_8(op, f, ...) op f STM32F4_REG_FOLD_7(op, __VA_ARGS__)
+
+#endif /* STM32F4_REG_H_ */
@@ -0,0 +1,36 @@
+/**
+ * @file stm32f4_reverse.h
+ * @brief Header for stm32f4_reverse.c file.
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+#ifndef STM32F4_REVERSE_H_
+#define STM32F4_REVERSE_H_
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* HW dependent includes */
+#include "stm32f4xx.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define STM32F4_REVERSE_GEAR_GPIO GPIOC         /*!<    Reverse-gear signal GPIO port (active high, with pull-down)   */
+#define STM32F4_REVERSE_GEAR_PIN 8              /*!<    Reverse-gear signal GPIO pin. Its EXTI line is served by EXTI9_5_IRQHandler   */
+#define STM32F4_REVERSE_IGNITION_GPIO GPIOC     /*!<    Ignition signal GPIO port (active high, with pull-down). NULL if there is no ignition input   */
+#define STM32F4_REVERSE_IGNITION_PIN 9          /*!<    Ignition signal GPIO pin. Ignored if the port is NULL   */
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Auxiliary function to change the GPIOs and pins of the reverse-gear and ignition inputs. This function is used for testing purposes mainly.
+ *
+ * @param reverse_id        ID of the reverse input to change.
+ * @param p_reverse_port    New GPIO port of the reverse-gear signal.
+ * @param reverse_pin       New GPIO pin of the reverse-gear signal.
+ * @param p_ignition_port   New GPIO port of the ignition signal. NULL to remove the ignition input.
+ * @param ignition_pin      New GPIO pin of the ignition signal.
+ */
+void stm32f4_reverse_set_new_gpio(uint32_t reverse_id, GPIO_TypeDef *p_reverse_port, uint8_t reverse_pin, GPIO_TypeDef *p_ignition_port, uint8_t ignition_pin);
+
+#endif /* STM32F4_REVERSE_H_ */
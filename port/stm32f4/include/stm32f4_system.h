@@ -46,6 +46,20 @@
 #define STM32F4_AF1 0x01U /*!< Alternate function 1 */
 #define STM32F4_AF2 0x02U /*!< Alternate function 2 */
 
+/* Interrupt latency */
+#define STM32F4_IRQ_LATENCY_NONE INT32_MIN /*!< Value of the armed interrupt of the latency probes when no interrupt is armed */
+
+/**
+ * @brief Probe of the interrupt latency. It must be the first statement of the ISR of `irqn`.
+ * It is only compiled when `USE_IRQ_LATENCY` is defined (CMake option `-DUSE_IRQ_LATENCY=true`). Otherwise, it is empty.
+ * @hideinitializer
+ */
+#ifdef USE_IRQ_LATENCY
+#define STM32F4_IRQ_LATENCY_PROBE(irqn) stm32f4_system_irq_latency_probe(irqn)
+#else
+#define STM32F4_IRQ_LATENCY_PROBE(irqn)
+#endif
+
 /** @verbatim
       ==============================================================================
                               ##### How to use GPIOs #####
@@ -196,5 +210,84 @@ void stm32f4_system_gpio_write (GPIO_TypeDef *p_port,  uint8_t 	pin, bool value)
  */
 void stm32f4_system_gpio_toggle (GPIO_TypeDef *p_port, uint8_t pin);
 
+/**
+ * @brief Enable and reset the cycle counter of the core (DWT_CYCCNT).
+ * It counts the cycles of the core clock (`SystemCoreClock`) and wraps around every 2^32 cycles.
+ * It is used to measure the execution time of short pieces of code.
+ */
+void stm32f4_system_cycle_counter_init(void);
+
+/**
+ * @brief Get the current value of the cycle counter of the core.
+ * The number of cycles of a piece of code is the unsigned difference of two readings, even if the counter has wrapped around.
+ *
+ * @return uint32_t Number of cycles since `stm32f4_system_cycle_counter_init()` was called.
+ */
+uint32_t stm32f4_system_get_cycles(void);
+
+/**
+ * @brief Structure to store the interrupt latency measured by the probes of the ISRs.
+ * Only one interrupt is armed at a time, so a probe of another ISR that preempts the measurement does not count.
+ */
+typedef struct
+{
+    volatile int32_t armed_irqn;    /*!< Interrupt whose latency is being measured. `STM32F4_IRQ_LATENCY_NONE` if none */
+    volatile uint32_t pend_cycles;  /*!< Value of the cycle counter when the interrupt was pended */
+    volatile uint32_t last;         /*!< Cycles from the pend of the last measurement to the first instruction of its ISR */
+    volatile uint32_t min;          /*!< Minimum latency since the last reset */
+    volatile uint32_t max;          /*!< Maximum (worst-case) latency since the last reset */
+    volatile uint32_t count;        /*!< Number of measurements since the last reset */
+} stm32f4_irq_latency_t;
+
+extern stm32f4_irq_latency_t stm32f4_irq_latency; /*!< Interrupt latency measured by the probes of the ISRs */
+
+/**
+ * @brief Record the latency of an interrupt if it is the armed one. Use it through `STM32F4_IRQ_LATENCY_PROBE()`.
+ * It is inlined in the ISR, so it runs from the same memory as the ISR and reads the cycle counter with its first load.
+ *
+ * @param irqn Interrupt number of the ISR that calls the probe.
+ */
+static inline void stm32f4_system_irq_latency_probe(int32_t irqn)
+{
+    uint32_t now = DWT->CYCCNT;
+    if (stm32f4_irq_latency.armed_irqn != irqn)
+    {
+        return;
+    }
+    uint32_t latency = now - stm32f4_irq_latency.pend_cycles;
+    stm32f4_irq_latency.armed_irqn = STM32F4_IRQ_LATENCY_NONE;
+    stm32f4_irq_latency.last = latency;
+    if (latency < stm32f4_irq_latency.min)
+    {
+        stm32f4_irq_latency.min = latency;
+    }
+    if (latency > stm32f4_irq_latency.max)
+    {
+        stm32f4_irq_latency.max = latency;
+    }
+    stm32f4_irq_latency.count++;
+}
+
+/**
+ * @brief Reset the interrupt latency measurements and enable the cycle counter of the core.
+ */
+void stm32f4_system_irq_latency_reset(void);
+
+/**
+ * @brief Pend an interrupt by software and arm its probe to measure its latency.
+ * The latency is the number of cycles from the write that pends the interrupt to the probe of its ISR: exception entry
+ * (stacking and vector fetch), fetch of the first instructions of the ISR and the few cycles of the write itself.
+ * The interrupt must be enabled in the NVIC and have a higher priority than the code that calls this function.
+ *
+ * @param irqn Interrupt to pend. `SysTick_IRQn` or a peripheral interrupt (e.g., `TIM2_IRQn`, `EXTI15_10_IRQn`).
+ */
+void stm32f4_system_irq_latency_trigger(IRQn_Type irqn);
+
+/**
+ * @brief Invalidate the instruction and data caches of the flash (ART accelerator).
+ * The next fetches from flash are misses, which is the worst case of the code executed from flash.
+ */
+void stm32f4_system_flash_cache_flush(void);
+
 
 #endif /* STM32F4_SYSTEM_H_ */
\ No newline at end of file
@@ -0,0 +1,77 @@
+/**
+ * @file stm32f4_tof.h
+ * @brief Header for stm32f4_tof.c file.
+ *
+ * The ToF sensors share the I2C2 bus (fast mode, 400 kHz). The data of the transfers are moved by two DMA1 streams, and the
+ * addressing phases are driven by the event interrupt of the bus, so a measurement takes 3 transfers without CPU polling:
+ * 1. Write of the start command.
+ * 2. Read of the result block when the interrupt pin of the sensor signals a new sample (falling edge).
+ * 3. Write of the clear of the interrupt of the sensor.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+#ifndef STM32F4_TOF_H_
+#define STM32F4_TOF_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* HW dependent includes */
+#include "stm32f4xx.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define STM32F4_TOF_I2C I2C2                        /*!<    I2C controller of the bus of the ToF sensors   */
+#define STM32F4_TOF_SCL_GPIO GPIOB                  /*!<    I2C SCL GPIO port   */
+#define STM32F4_TOF_SCL_PIN 10                      /*!<    I2C SCL GPIO pin   */
+#define STM32F4_TOF_SDA_GPIO GPIOC                  /*!<    I2C SDA GPIO port   */
+#define STM32F4_TOF_SDA_PIN 12                      /*!<    I2C SDA GPIO pin   */
+#define STM32F4_TOF_I2C_AF 4                        /*!<    Alternate function of I2C2 in the SCL and SDA pins   */
+#define STM32F4_TOF_I2C_SPEED_HZ 400000             /*!<    Clock of the bus in Hz (fast mode)   */
+#define STM32F4_TOF_I2C_IRQ_PRIO 6                  /*!<    Priority of the event and error interrupts of the bus and of its DMA streams   */
+
+#define STM32F4_TOF_TX_DMA DMA1_Stream7             /*!<    DMA stream of I2C2_TX   */
+#define STM32F4_TOF_RX_DMA DMA1_Stream2             /*!<    DMA stream of I2C2_RX   */
+#define STM32F4_TOF_DMA_CHANNEL 7U                  /*!<    DMA channel of I2C2_TX and I2C2_RX in both streams   */
+
+#define STM32F4_REAR_TOF_ADDRESS 0x29U              /*!<    7-bit I2C address of the rear ToF sensor   */
+#define STM32F4_REAR_TOF_INT_GPIO GPIOB             /*!<    Interrupt pin (GPIO1, open drain, active low) GPIO port   */
+#define STM32F4_REAR_TOF_INT_PIN 4                  /*!<    Interrupt pin GPIO pin. Its EXTI line is served by EXTI4_IRQHandler   */
+#define STM32F4_REAR_TOF_INT_IRQ_PRIO 5             /*!<    Priority of the interrupt of the new samples   */
+#define STM32F4_REAR_TOF_XSHUT_GPIO GPIOB           /*!<    Shutdown pin (XSHUT, active low) GPIO port. NULL if it is tied high   */
+#define STM32F4_REAR_TOF_XSHUT_PIN 5                /*!<    Shutdown pin GPIO pin. Ignored if the port is NULL   */
+
+#define STM32F4_TOF_BUS_TIMEOUT 100000              /*!<    Maximum number of polls of a flag of the bus in the blocking transfers of the configuration   */
+
+/* Registers of the sensor (VL53L0X) */
+#define STM32F4_TOF_REG_SYSRANGE_START 0x00U        /*!<    Start of a measurement. 0x01: single shot   */
+#define STM32F4_TOF_REG_SEQUENCE_CONFIG 0x01U       /*!<    Steps of the ranging sequence   */
+#define STM32F4_TOF_REG_INTERRUPT_CONFIG 0x0AU      /*!<    Event of the interrupt pin. 0x04: new sample ready   */
+#define STM32F4_TOF_REG_INTERRUPT_CLEAR 0x0BU       /*!<    Clear of the interrupt   */
+#define STM32F4_TOF_REG_RESULT_RANGE 0x14U          /*!<    First register of the result block   */
+#define STM32F4_TOF_REG_GPIO_HV_MUX 0x84U           /*!<    Polarity of the interrupt pin. Bit 4 cleared: active low   */
+#define STM32F4_TOF_REG_I2C_MODE 0x88U              /*!<    Mode of the I2C interface. 0x00: standard   */
+#define STM32F4_TOF_REG_PAD_EXTSUP_HV 0x89U         /*!<    I/O voltage. Bit 0 set: 2.8 V   */
+#define STM32F4_TOF_REG_MODEL_ID 0xC0U              /*!<    Identification of the model   */
+#define STM32F4_TOF_MODEL_ID 0xEEU                  /*!<    Expected identification of the model   */
+
+#define STM32F4_TOF_RESULT_LEN 12                   /*!<    Number of bytes of the result block   */
+#define STM32F4_TOF_RANGE_STATUS_VALID 11U          /*!<    Range status of a valid measurement (bits 6:3 of the first byte of the result)   */
+#define STM32F4_TOF_RANGE_OUT 8190U                 /*!<    Distance reported in mm when there is no target in range   */
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Decode the result block of a measurement of a ToF sensor: range status, signal rate and distance.
+ * It is called with the DMA buffer when the result has been read. It is also used for testing purposes to inject results without the HW.
+ * The measurement ready flag is not changed.
+ *
+ * @param tof_id    ToF ID. This index is used to select the element of the tofs_arr[] array.
+ * @param p_result  Array of `STM32F4_TOF_RESULT_LEN` bytes read from `STM32F4_TOF_REG_RESULT_RANGE`. The 16-bit values are big endian:
+ *                  byte 0 holds the range status, bytes 6-7 the signal rate in Mcps (Q9.7) and bytes 10-11 the distance in mm.
+ */
+void stm32f4_tof_process_result(uint32_t tof_id, const uint8_t *p_result);
+
+#endif /* STM32F4_TOF_H_ */
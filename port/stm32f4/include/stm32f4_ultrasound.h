@@ -14,13 +14,7 @@
 
 /* HW dependent includes */
 #include "stm32f4xx.h"
-
-/* Defines and enums ----------------------------------------------------------*/
-/* Defines */
-#define STM32F4_REAR_PARKING_SENSOR_ECHO_GPIO GPIOA     /*!<    Ultrasound echo signal GPIO port   */
-#define STM32F4_REAR_PARKING_SENSOR_ECHO_PIN 1          /*!<    Ultrasound echo signal GPIO pin   */
-#define STM32F4_REAR_PARKING_SENSOR_TRIGGER_GPIO GPIOB  /*!<    Ultrasound trigger signal GPIO port   */
-#define STM32F4_REAR_PARKING_SENSOR_TRIGGER_PIN 0       /*!<    Ultrasound trigger signal GPIO pin   */
+#include "stm32f4_board.h"     // Pins and timers of the sensors (STM32F4_<SENSOR>_ECHO_GPIO, ...), generated from the board description
 
 
 /* Function prototypes and explanation -------------------------------------------------*/
@@ -44,5 +38,40 @@ void stm32f4_ultrasound_set_new_trigger_gpio(uint32_t ultrasound_id, GPIO_TypeDe
  */
 void stm32f4_ultrasound_set_new_echo_gpio(uint32_t ultrasound_id, GPIO_TypeDef *p_port, uint8_t pin);
 
+/**
+ * @brief Auxiliary function to change the GPIO and pin of the supply-enable pin of an ultrasound transceiver. Use a NULL port to disable the power gating of the sensor.
+ * The new pin is configured and driven low (sensor powered off) when the port is not NULL.
+ *
+ * @param ultrasound_id ID of the supply-enable signal to change.
+ * @param p_port New GPIO port for the supply-enable signal. NULL if the sensor is always powered.
+ * @param pin New GPIO pin for the supply-enable signal.
+ *
+ */
+void stm32f4_ultrasound_set_new_power_gpio(uint32_t ultrasound_id, GPIO_TypeDef *p_port, uint8_t pin);
+
+/**
+ * @brief Serve the interrupt of a timer that captures the echo signals.
+ * Every sensor whose echo is captured by `TIMx` is checked: an update counts an overflow of its echo, a lost capture is counted
+ * in the metrics, and a capture in its channel stores the init tick or, if it was already stored, the end tick and its echo received flag.
+ * The ISR of the timer only has to call this function. It is executed from SRAM, like the ISR, because it bounds the resolution of the echo.
+ *
+ * @param TIMx  Timer of the echo signal that has interrupted.
+ */
+void stm32f4_ultrasound_echo_timer_isr(TIM_TypeDef *TIMx);
+
+/**
+ * @brief Serve the interrupt of a timer of the duration of the trigger signals.
+ * The trigger end flag of every sensor whose trigger is timed by `TIMx` is set, so its trigger signal is lowered.
+ *
+ * @param TIMx  Timer of the trigger signal that has interrupted.
+ */
+void stm32f4_ultrasound_trigger_timer_isr(TIM_TypeDef *TIMx);
+
+/**
+ * @brief Serve the interrupt of the timer of the measurement period, shared by all the sensors.
+ * The sensors whose echo timer is still running have not received their echo during the whole period, which is counted in the metrics.
+ * Then a new measurement of every sensor can be started.
+ */
+void stm32f4_ultrasound_measurement_timer_isr(void);
 
 #endif /* STM32F4_ULTRASOUND_H_ */
@@ -8,14 +8,22 @@
 #include "port_system.h"
 #include "stm32f4_system.h"
 #include "port_button.h"
-#include "port_ultrasound.h"
+#include "port_keypad.h"
+#include "port_reverse.h"
+#include "port_tof.h"
 #include "stm32f4_button.h"
-#include "stm32f4_ultrasound.h"
+#include "stm32f4_tof.h"
 // Include headers of different port elements:
 
+// Include common services used from the ISRs:
+#include "metrics.h"
+
 //------------------------------------------------------
 // INTERRUPT SERVICE ROUTINES
 //------------------------------------------------------
+// The ISRs whose latency bounds the resolution of the measurements (SysTick, button and echo capture) are executed
+// from SRAM (PORT_RAMFUNC), so their entry does not depend on the flash cache. The functions they call stay in flash.
+// The ISRs of the timers of the ultrasound sensors are generated from the description of the board (stm32f4_board_isr.c).
 /**
  * @brief Interrupt service routine for the System tick timer (SysTick).
  *
@@ -29,8 +37,10 @@
  * @warning **The variable `msTicks` must be declared volatile!** Just because it is modified by a call of an ISR, in order to avoid [*race conditions*](https://en.wikipedia.org/wiki/Race_condition). **Added to the definition** after *static*.
  *
  */
-void SysTick_Handler(void)
+PORT_RAMFUNC void SysTick_Handler(void)
 {
+    STM32F4_IRQ_LATENCY_PROBE(SysTick_IRQn);
+
     uint32_t millis = port_system_get_millis();
     port_system_set_millis(millis + 1);
 
@@ -41,8 +51,10 @@ void SysTick_Handler(void)
  * First, this function identifies the line/ pin which has raised the interruption.
  * Then, perform the desired action. Before leaving it cleans the interrupt pending register.
  */
-void EXTI15_10_IRQHandler ( void )
+PORT_RAMFUNC void EXTI15_10_IRQHandler ( void )
 {
+    STM32F4_IRQ_LATENCY_PROBE(EXTI15_10_IRQn);
+
     port_system_systick_resume();
 
     /* ISR parking button */
@@ -55,65 +67,106 @@ void EXTI15_10_IRQHandler ( void )
     }
 }
 
+/**
+ * @brief This function handles Px5-Px9 global interrupts.
+ * The reverse-gear and ignition inputs of the vehicle interrupt on both edges: the pending lines are cleaned and the levels
+ * of both signals are read. Their changes wake up the system from the low power mode.
+ */
+void EXTI9_5_IRQHandler(void)
+{
+    port_system_systick_resume();
+
+    /* ISR reverse gear and ignition */
+    if (port_reverse_get_pending_interrupt(PORT_REVERSE_GEAR_ID))
+    {
+        // Cleared before the levels are read: an edge in between interrupts again instead of being lost
+        port_reverse_clear_pending_interrupt(PORT_REVERSE_GEAR_ID);
+
+        port_reverse_update(PORT_REVERSE_GEAR_ID);
+    }
+}
+
 
 /**
- * @brief Interrupt service routine for the TIM2 timer.
- * This timer controls the duration of the echo signal of the ultrasound sensor by means of the input capture mode.
- * The timer can interrupt in two cases:
- *      1.  When the echo signal has not been received and the ARR register overflows. 
- *          In this case, the echo_overflows counter is incremented.
- *      2.  When the echo signal has been received. In this case, the echo_init_tick and echo_end_tick are updated.
+ * @brief Interrupt service routine for the stream 1 of DMA2.
+ * This stream copies the inputs of the keypad into two scan buffers each time TIM8 overflows.
+ * When one of the buffers is full (half transfer or transfer complete), its scan is debounced while the DMA fills the other one.
  */
-void TIM2_IRQHandler(void)
+void DMA2_Stream1_IRQHandler(void)
 {
     port_system_systick_resume();
 
-    if(TIM2 -> SR & TIM_SR_UIF)
+    if (DMA2->LISR & DMA_LISR_HTIF1)
     {
-        uint32_t new_overflows = port_ultrasound_get_echo_overflows(PORT_REAR_PARKING_SENSOR_ID) + 1;
-        port_ultrasound_set_echo_overflows(PORT_REAR_PARKING_SENSOR_ID, new_overflows);
-    
-        TIM2-> SR &= ~TIM_SR_UIF;
-    }    
-    if((TIM2-> SR & TIM_SR_CC2IF) != 0)              
+        DMA2->LIFCR = DMA_LIFCR_CHTIF1;
+        port_keypad_process_scan(0);
+    }
+    if (DMA2->LISR & DMA_LISR_TCIF1)
     {
-        uint32_t CCR_value = TIM2 -> CCR2;          
-        uint32_t init_tick = port_ultrasound_get_echo_init_tick(PORT_REAR_PARKING_SENSOR_ID);
-        uint32_t end_tick = port_ultrasound_get_echo_end_tick(PORT_REAR_PARKING_SENSOR_ID);
-
-        if((init_tick == 0)&&(end_tick == 0))
-        {
-            port_ultrasound_set_echo_init_tick(PORT_REAR_PARKING_SENSOR_ID, CCR_value);
-        } else
-        {
-            port_ultrasound_set_echo_end_tick(PORT_REAR_PARKING_SENSOR_ID, CCR_value);
-            port_ultrasound_set_echo_received(PORT_REAR_PARKING_SENSOR_ID, true);
-        }
-        
-        //TIM2 -> SR &= ~TIM_SR_CC2IF;                                
-    } 
-}	
+        DMA2->LIFCR = DMA_LIFCR_CTCIF1;
+        port_keypad_process_scan(1);
+    }
+}
 
 /**
- * @brief Interrupt service routine for the TIM3 timer.
- * This timer controls the duration of the trigger signal of the ultrasound sensor.
- * When the interrupt occurs it means that the time of the trigger signal has expired and must be lowered.
+ * @brief This function handles Px4 global interrupts.
+ * The interrupt pin of the rear ToF sensor falls when a measurement has finished: the read of its result is started.
  */
-void TIM3_IRQHandler(void)
+void EXTI4_IRQHandler(void)
 {
-    TIM3->SR &= ~TIM_SR_UIF;
-    
-    port_ultrasound_set_trigger_end(PORT_REAR_PARKING_SENSOR_ID, true);
-}	
+    port_system_systick_resume();
+
+    if (EXTI->PR & BIT_POS_TO_MASK(STM32F4_REAR_TOF_INT_PIN))
+    {
+        EXTI->PR = BIT_POS_TO_MASK(STM32F4_REAR_TOF_INT_PIN);
+        port_tof_process_sample_ready(PORT_REAR_TOF_SENSOR_ID);
+    }
+}
 
 /**
- * @brief Interrupt service routine for the TIM5 timer.
- * This timer controls the duration of the measurements of the ultrasound sensor.
- * When the interrupt occurs it means that the time of the a measurement has expired and a new measurement can be started.
+ * @brief Interrupt service routine for the events of the I2C2 bus (start sent, address acknowledged, byte transferred).
+ * Each event advances the transfer of the ToF sensors in progress.
  */
-void TIM5_IRQHandler(void)
+void I2C2_EV_IRQHandler(void)
 {
-    TIM5->SR &= ~TIM_SR_UIF;
+    port_tof_process_bus_event();
+}
+
+/**
+ * @brief Interrupt service routine for the errors of the I2C2 bus (no acknowledge, arbitration lost, bus error, overrun).
+ */
+void I2C2_ER_IRQHandler(void)
+{
+    port_tof_process_bus_error();
+}
+
+/**
+ * @brief Interrupt service routine for the stream 2 of DMA1.
+ * This stream reads the result block of the ToF sensors from I2C2. The complete transfer ends the read.
+ */
+void DMA1_Stream2_IRQHandler(void)
+{
+    if (DMA1->LISR & DMA_LISR_TEIF2)
+    {
+        DMA1->LIFCR = DMA_LIFCR_CTEIF2;
+        port_tof_process_bus_error();
+    }
+    if (DMA1->LISR & DMA_LISR_TCIF2)
+    {
+        DMA1->LIFCR = DMA_LIFCR_CTCIF2;
+        port_tof_process_bus_event();
+    }
+}
 
-    port_ultrasound_set_trigger_ready(PORT_REAR_PARKING_SENSOR_ID, true);
+/**
+ * @brief Interrupt service routine for the stream 7 of DMA1.
+ * This stream writes the registers of the ToF sensors into I2C2. Only its errors interrupt: the end of a write is an event of the bus.
+ */
+void DMA1_Stream7_IRQHandler(void)
+{
+    if (DMA1->HISR & DMA_HISR_TEIF7)
+    {
+        DMA1->HIFCR = DMA_HIFCR_CTEIF7;
+        port_tof_process_bus_error();
+    }
 }
@@ -0,0 +1,98 @@
+/**
+ * @file stm32f4_backup.c
+ * @brief Portable functions to keep a snapshot of the state of the system in the backup SRAM of the STM32F4 platform.
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <string.h>
+
+/* HW dependent includes */
+#include "port_backup.h"
+
+/* Microcontroller dependent includes */
+#include "stm32f4_system.h"
+#include "stm32f4_backup.h"
+
+/* Defines --------------------------------------------------------------------*/
+#define BACKUP_HEADER ((volatile stm32f4_backup_header_t *)STM32F4_BACKUP_SRAM_BASE)                       /*!<    Header of the snapshot @hideinitializer */
+#define BACKUP_DATA ((uint8_t *)(STM32F4_BACKUP_SRAM_BASE + sizeof(stm32f4_backup_header_t)))             /*!<    Data of the snapshot @hideinitializer */
+#define BACKUP_CAPACITY (STM32F4_BACKUP_SRAM_SIZE - sizeof(stm32f4_backup_header_t))                       /*!<    Maximum size of the data @hideinitializer */
+
+/* Public functions -----------------------------------------------------------*/
+uint32_t stm32f4_backup_crc(const uint8_t *p_data, uint32_t size)
+{
+    RCC->AHB1ENR |= RCC_AHB1ENR_CRCEN;
+    CRC->CR = CRC_CR_RESET;
+
+    CRC->DR = size;
+    for (uint32_t i = 0; i < size; i += 4)
+    {
+        uint32_t word = 0;
+        for (uint32_t j = 0; (j < 4) && ((i + j) < size); j++)
+        {
+            word |= (uint32_t)p_data[i + j] << (8 * j);
+        }
+        CRC->DR = word;
+    }
+    return CRC->DR;
+}
+
+void port_backup_init(void)
+{
+    // Write access to the backup domain
+    RCC->APB1ENR |= RCC_APB1ENR_PWREN;
+    PWR->CR |= PWR_CR_DBP;
+
+    RCC->AHB1ENR |= RCC_AHB1ENR_BKPSRAMEN;
+
+    // Backup regulator: the SRAM also keeps its content in Standby mode and on VBAT
+    PWR->CSR |= PWR_CSR_BRE;
+    for (uint32_t i = 0; (i < STM32F4_BACKUP_BRR_TIMEOUT) && !(PWR->CSR & PWR_CSR_BRR); i++)
+    {
+    }
+}
+
+uint32_t port_backup_get_capacity(void)
+{
+    return BACKUP_CAPACITY;
+}
+
+bool port_backup_write(const void *p_data, uint32_t size)
+{
+    if (size > BACKUP_CAPACITY)
+    {
+        return false;
+    }
+
+    // Invalidate first: a reset in the middle of the copy leaves no valid snapshot, not a mixed one
+    BACKUP_HEADER->magic = 0;
+    memcpy(BACKUP_DATA, p_data, size);
+    BACKUP_HEADER->size = size;
+    BACKUP_HEADER->crc = stm32f4_backup_crc(BACKUP_DATA, size);
+    BACKUP_HEADER->magic = STM32F4_BACKUP_MAGIC;
+    return true;
+}
+
+bool port_backup_read(void *p_data, uint32_t size)
+{
+    if ((BACKUP_HEADER->magic != STM32F4_BACKUP_MAGIC) || (BACKUP_HEADER->size != size) || (size > BACKUP_CAPACITY))
+    {
+        return false;
+    }
+    if (BACKUP_HEADER->crc != stm32f4_backup_crc(BACKUP_DATA, size))
+    {
+        return false;
+    }
+
+    memcpy(p_data, BACKUP_DATA, size);
+    return true;
+}
+
+void port_backup_invalidate(void)
+{
+    BACKUP_HEADER->magic = 0;
+}
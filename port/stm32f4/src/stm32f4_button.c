@@ -26,12 +26,14 @@ typedef struct
     GPIO_TypeDef *p_port;
     uint8_t pin;
     uint8_t pupd_mode;
+    uint8_t irq_prio;
     bool flag_pressed;
 } stm32f4_button_hw_t;
 
 /* Global variables ------------------------------------------------------------*/
+// Generated from the description of the board, so adding a button does not change this file
 static stm32f4_button_hw_t buttons_arr[] = {
-    [PORT_PARKING_BUTTON_ID] = {.p_port = STM32F4_PARKING_BUTTON_GPIO, .pin = STM32F4_PARKING_BUTTON_PIN, .pupd_mode = STM32F4_GPIO_PUPDR_NOPULL},
+    STM32F4_BOARD_BUTTONS
 };
 
 /* Private functions ----------------------------------------------------------*/
@@ -72,7 +74,7 @@ void port_button_init(uint32_t button_id)
     /* TO-DO alumnos */
     stm32f4_system_gpio_config(p_button->p_port, p_button->pin, STM32F4_GPIO_MODE_IN, p_button->pupd_mode);
     stm32f4_system_gpio_config_exti(p_button->p_port, p_button->pin, STM32F4_TRIGGER_BOTH_EDGE | STM32F4_TRIGGER_ENABLE_INTERR_REQ);
-    stm32f4_system_gpio_exti_enable(p_button->pin, 1, 0);
+    stm32f4_system_gpio_exti_enable(p_button->pin, p_button->irq_prio, 0);
 
 }
 
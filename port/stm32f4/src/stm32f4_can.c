@@ -0,0 +1,206 @@
+/**
+ * @file stm32f4_can.c
+ * @brief Portable functions to interact with the CAN controller (bxCAN) of the STM32F4 platform.
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stddef.h>
+
+/* HW dependent includes */
+#include "port_can.h"
+#include "port_system.h"
+
+/* Microcontroller dependent includes */
+#include "stm32f4_system.h"
+#include "stm32f4_can.h"
+
+/* Defines --------------------------------------------------------------------*/
+#define CAN_TSR_TME_ALL (CAN_TSR_TME0 | CAN_TSR_TME1 | CAN_TSR_TME2)   /*!<    Flags of the empty transmit mailboxes @hideinitializer */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Wait until the acknowledge of the initialization mode (INAK) has the expected value.
+ *
+ * @param inak      Expected value of INAK.
+ * @return true     If the controller has acknowledged the mode.
+ * @return false    If the timeout has expired (e.g., the bus is not connected when leaving the initialization mode).
+ */
+static bool _can_wait_inak(bool inak)
+{
+    for (uint32_t i = 0; i < STM32F4_CAN_MODE_TIMEOUT; i++)
+    {
+        if (((STM32F4_CAN->MSR & CAN_MSR_INAK) != 0) == inak)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Pack 4 bytes of a frame into a data register (little endian).
+ *
+ * @param p_data    Pointer to the first byte.
+ * @return uint32_t Value of the register.
+ */
+static uint32_t _can_pack(const uint8_t *p_data)
+{
+    return (uint32_t)p_data[0] | ((uint32_t)p_data[1] << 8) | ((uint32_t)p_data[2] << 16) | ((uint32_t)p_data[3] << 24);
+}
+
+/**
+ * @brief Unpack a data register into 4 bytes of a frame (little endian).
+ *
+ * @param reg       Value of the register.
+ * @param p_data    Pointer to the first byte.
+ */
+static void _can_unpack(uint32_t reg, uint8_t *p_data)
+{
+    p_data[0] = (uint8_t)reg;
+    p_data[1] = (uint8_t)(reg >> 8);
+    p_data[2] = (uint8_t)(reg >> 16);
+    p_data[3] = (uint8_t)(reg >> 24);
+}
+
+/* Public functions -----------------------------------------------------------*/
+uint32_t stm32f4_can_compute_btr(uint32_t pclk_hz, uint32_t bitrate)
+{
+    if (bitrate == 0)
+    {
+        return 0;
+    }
+
+    // The more time quanta per bit, the finer the sample point and the resynchronization
+    for (uint32_t tq = STM32F4_CAN_MAX_TQ; tq >= STM32F4_CAN_MIN_TQ; tq--)
+    {
+        if ((pclk_hz % (bitrate * tq)) != 0)
+        {
+            continue;
+        }
+        uint32_t brp = pclk_hz / (bitrate * tq);
+        if ((brp == 0) || (brp > 1024))
+        {
+            continue;
+        }
+        uint32_t ts2 = (tq + 4) / 8;        // Sample point at 87.5 % (CiA recommendation)
+        uint32_t ts1 = tq - 1 - ts2;        // The synchronization segment is 1 time quantum
+
+        return ((brp - 1) << CAN_BTR_BRP_Pos) | ((ts1 - 1) << CAN_BTR_TS1_Pos) | ((ts2 - 1) << CAN_BTR_TS2_Pos) | ((STM32F4_CAN_SJW_TQ - 1) << CAN_BTR_SJW_Pos);
+    }
+    return 0;
+}
+
+bool port_can_init(bool loopback)
+{
+    // Pins: alternate function of CAN1
+    stm32f4_system_gpio_config(STM32F4_CAN_RX_GPIO, STM32F4_CAN_RX_PIN, STM32F4_GPIO_MODE_AF, STM32F4_GPIO_PUPDR_PULLUP);
+    stm32f4_system_gpio_config_alternate(STM32F4_CAN_RX_GPIO, STM32F4_CAN_RX_PIN, STM32F4_CAN_AF);
+    stm32f4_system_gpio_config(STM32F4_CAN_TX_GPIO, STM32F4_CAN_TX_PIN, STM32F4_GPIO_MODE_AF, STM32F4_GPIO_PUPDR_NOPULL);
+    stm32f4_system_gpio_config_alternate(STM32F4_CAN_TX_GPIO, STM32F4_CAN_TX_PIN, STM32F4_CAN_AF);
+
+    RCC->APB1ENR |= RCC_APB1ENR_CAN1EN;
+
+    // Initialization mode, out of sleep mode
+    STM32F4_CAN->MCR |= CAN_MCR_INRQ;
+    STM32F4_CAN->MCR &= ~CAN_MCR_SLEEP;
+    if (!_can_wait_inak(true))
+    {
+        return false;
+    }
+
+    // Mailboxes sent in chronological order (not by identifier), automatic recovery from bus-off
+    STM32F4_CAN->MCR |= CAN_MCR_TXFP | CAN_MCR_ABOM;
+
+    // Bit timing from the clock of APB1
+    uint32_t pclk_hz = SystemCoreClock >> APBPrescTable[(RCC->CFGR & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos];
+    uint32_t btr = stm32f4_can_compute_btr(pclk_hz, PORT_CAN_BITRATE_BPS);
+    if (loopback)
+    {
+        btr |= CAN_BTR_LBKM | CAN_BTR_SILM;
+    }
+    STM32F4_CAN->BTR = btr;
+
+    // Filter 0: 32-bit mask with all the bits "don't care", so every frame is accepted into FIFO 0
+    STM32F4_CAN->FMR |= CAN_FMR_FINIT;
+    STM32F4_CAN->FA1R &= ~CAN_FA1R_FACT0;
+    STM32F4_CAN->FM1R &= ~CAN_FM1R_FBM0;
+    STM32F4_CAN->FS1R |= CAN_FS1R_FSC0;
+    STM32F4_CAN->FFA1R &= ~CAN_FFA1R_FFA0;
+    STM32F4_CAN->sFilterRegister[0].FR1 = 0;
+    STM32F4_CAN->sFilterRegister[0].FR2 = 0;
+    STM32F4_CAN->FA1R |= CAN_FA1R_FACT0;
+    STM32F4_CAN->FMR &= ~CAN_FMR_FINIT;
+
+    // Normal mode: the controller joins the bus after 11 recessive bits
+    STM32F4_CAN->MCR &= ~CAN_MCR_INRQ;
+    return _can_wait_inak(false);
+}
+
+uint32_t port_can_get_free_mailboxes(void)
+{
+    uint32_t tme = STM32F4_CAN->TSR & CAN_TSR_TME_ALL;
+    return ((tme & CAN_TSR_TME0) != 0) + ((tme & CAN_TSR_TME1) != 0) + ((tme & CAN_TSR_TME2) != 0);
+}
+
+bool port_can_transmit(const port_can_frame_t *p_frame)
+{
+    uint32_t tsr = STM32F4_CAN->TSR;
+    if ((tsr & CAN_TSR_TME_ALL) == 0)
+    {
+        return false;
+    }
+
+    // The HW gives the number of the next empty mailbox
+    uint32_t mailbox = (tsr & CAN_TSR_CODE) >> CAN_TSR_CODE_Pos;
+    CAN_TxMailBox_TypeDef *p_mailbox = &STM32F4_CAN->sTxMailBox[mailbox];
+
+    uint32_t tir;
+    if (p_frame->id > PORT_CAN_STD_ID_MAX)
+    {
+        tir = (p_frame->id << CAN_TI0R_EXID_Pos) | CAN_TI0R_IDE;
+    }
+    else
+    {
+        tir = p_frame->id << CAN_TI0R_STID_Pos;
+    }
+    uint8_t dlc = (p_frame->dlc > PORT_CAN_MAX_DLC) ? PORT_CAN_MAX_DLC : p_frame->dlc;
+
+    p_mailbox->TIR = tir;
+    p_mailbox->TDTR = (p_mailbox->TDTR & ~CAN_TDT0R_DLC) | dlc;
+    p_mailbox->TDLR = _can_pack(&p_frame->data[0]);
+    p_mailbox->TDHR = _can_pack(&p_frame->data[4]);
+
+    // Request the transmission once the mailbox is complete
+    p_mailbox->TIR = tir | CAN_TI0R_TXRQ;
+    return true;
+}
+
+bool port_can_receive(port_can_frame_t *p_frame)
+{
+    if ((STM32F4_CAN->RF0R & CAN_RF0R_FMP0) == 0)
+    {
+        return false;
+    }
+
+    CAN_FIFOMailBox_TypeDef *p_fifo = &STM32F4_CAN->sFIFOMailBox[0];
+    uint32_t rir = p_fifo->RIR;
+    if (rir & CAN_RI0R_IDE)
+    {
+        p_frame->id = rir >> CAN_RI0R_EXID_Pos;
+    }
+    else
+    {
+        p_frame->id = rir >> CAN_RI0R_STID_Pos;
+    }
+    p_frame->dlc = (uint8_t)(p_fifo->RDTR & CAN_RDT0R_DLC);
+    _can_unpack(p_fifo->RDLR, &p_frame->data[0]);
+    _can_unpack(p_fifo->RDHR, &p_frame->data[4]);
+
+    // Release the output of the FIFO
+    STM32F4_CAN->RF0R |= CAN_RF0R_RFOM0;
+    return true;
+}
@@ -15,21 +15,34 @@
 
 /* Microcontroller dependent includes */
 #include "stm32f4_system.h"
+#include "stm32f4_reg.h"
 #include "stm32f4_display.h"
 
 /* Defines --------------------------------------------------------------------*/
+#define STM32F4_DISPLAY_NUM_CHANNELS 3  /*!< Number of PWM channels of a display: red, green and blue @hideinitializer */
 
 /* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure to define the HW dependencies of an LED of the RGB LED.
+ */
+typedef struct {
+    GPIO_TypeDef      *p_port;      /*!< GPIO port of the LED */
+    uint8_t            pin;         /*!< Pin number of the LED */
+    volatile uint32_t *p_ccr;       /*!< Capture/compare register of the PWM channel of the LED */
+    uint32_t           ccer_en;     /*!< Enable bit of the PWM channel of the LED in the CCER register */
+} stm32f4_display_channel_t;
+
 /**
  * @brief Structure to define the HW dependencies of an RGB LED.
  */
 typedef struct {
-    GPIO_TypeDef *p_port_red;     /*!< GPIO port for the red LED */
-    uint8_t       pin_red;        /*!< Pin number for the red LED */
-    GPIO_TypeDef *p_port_green;   /*!< GPIO port for the green LED */
-    uint8_t       pin_green;      /*!< Pin number for the green LED */
-    GPIO_TypeDef *p_port_blue;    /*!< GPIO port for the blue LED */
-    uint8_t       pin_blue;       /*!< Pin number for the blue LED */
+    TIM_TypeDef  *p_tim;          /*!< Timer that controls the PWM of the RGB LED */
+    uint8_t       alt_fun;        /*!< Alternate function of the pins of the RGB LED for the timer */
+    void        (*p_pwm_init)(void);  /*!< Enable the clock of the timer and configure the PWM channels of the LEDs. Generated for the timer and channels of the display */
+    stm32f4_display_channel_t channels[STM32F4_DISPLAY_NUM_CHANNELS];   /*!< Red, green and blue LEDs */
+    uint32_t      pwm_freq_hz;    /*!< PWM frequency of the RGB LED in Hz */
+    uint32_t      pwm_clock_hz;   /*!< System clock in Hz used to derive the prescaler and the period of the PWM. 0 if they have not been derived yet */
+    rgb_color_t   color;          /*!< Last color set, applied again when the PWM period changes */
 } stm32f4_display_hw_t;
 
 
@@ -37,10 +50,11 @@ typedef struct {
 /**
  * @brief Array of elements that represents the HW characteristics of the RGB LED of the display systems connected to the STM32F4 platform.
  * This must be hidden from the user, so it is declared as static. To access the elements of this array, use the function _stm32f4_display_get().
+ * The elements are generated from the description of the board (`STM32F4_BOARD_DISPLAYS`), so adding a display does not change this file.
  * 
  */
 static stm32f4_display_hw_t displays_arr [] = {
-    [PORT_REAR_PARKING_DISPLAY_ID] = {.p_port_red = STM32F4_REAR_PARKING_DISPLAY_RGB_R_GPIO, .pin_red = STM32F4_REAR_PARKING_DISPLAY_RGB_R_PIN, .p_port_green = STM32F4_REAR_PARKING_DISPLAY_RGB_G_GPIO, .pin_green = STM32F4_REAR_PARKING_DISPLAY_RGB_G_PIN, .p_port_blue = STM32F4_REAR_PARKING_DISPLAY_RGB_B_GPIO, .pin_blue = STM32F4_REAR_PARKING_DISPLAY_RGB_B_PIN},
+    STM32F4_BOARD_DISPLAYS
 };
 
 /* Private functions -----------------------------------------------------------*/
@@ -63,65 +77,64 @@ stm32f4_display_hw_t *_stm32f4_display_get(uint32_t display_id)
 }
 
 /**
- * @brief Configure the timer that controls the PWM of each one of the RGB LEDs of the display system.
- * This function is called by the port_display_init() public function to configure the timer that controls the PWM of the RGB LEDs of the display.
+ * @brief Set the prescaler and the period of the PWM timer of a display from its PWM frequency and the current system clock.
+ * The prescaler is the lowest one that fits the period in 16 bits, so the duty resolution is the maximum for that frequency.
+ * The frequency is limited so a period has at least `STM32F4_DISPLAY_PWM_MIN_STEPS` timer ticks.
  * 
- * @param display_id    Display system identifier number.
+ * @param p_display     Pointer to the display struct.
  */
-void _timer_pwm_config (uint32_t display_id)
+static void _timer_pwm_set_period (stm32f4_display_hw_t *p_display)
 {
-    TIM_TypeDef *TIMx = NULL;
-    uint32_t RCC_APB1ENR_TIMxEN = 0;
+    TIM_TypeDef *TIMx = p_display->p_tim;
+    uint32_t clock_hz = SystemCoreClock;
+    uint32_t max_freq_hz = clock_hz / STM32F4_DISPLAY_PWM_MIN_STEPS;
 
-    switch (display_id)
+    uint32_t freq_hz = p_display->pwm_freq_hz;
+    if (freq_hz > max_freq_hz)
     {
-    case PORT_REAR_PARKING_DISPLAY_ID:
-        TIMx = TIM4;
-        RCC_APB1ENR_TIMxEN = RCC_APB1ENR_TIM4EN;
-
-        break;
-
-    default:
-        return; // Invalid display ID
+        freq_hz = max_freq_hz;
+    }
+    if (freq_hz == 0)
+    {
+        freq_hz = 1;
     }
 
-    // Enable the clock of the timer that controls the trigger signal.
-    RCC->APB1ENR |= RCC_APB1ENR_TIMxEN;
-
-    // Disable counter and enable auto-reload preload
-    TIMx->CR1 &= ~TIM_CR1_CEN;
-    TIMx->CR1 |= TIM_CR1_ARPE;
+    uint32_t ticks = clock_hz / freq_hz;
+    uint32_t psc = (ticks - 1) / 65536;     // Lowest prescaler that keeps ARR <= 65535
+    TIMx->PSC = psc;
+    TIMx->ARR = (ticks / (psc + 1)) - 1;
 
-    // Reset timer counter
-    TIMx->CNT = 0;
+    p_display->pwm_freq_hz = freq_hz;
+    p_display->pwm_clock_hz = clock_hz;
+}
 
-    // Configure prescaler and auto-reload for 50Hz PWM
-    TIMx->PSC = 4;              // Timer frequency
-    TIMx->ARR = 63999;          // PWM frequency
+/**
+ * @brief Configure the timer that controls the PWM of each one of the RGB LEDs of the display system.
+ * This function is called by the port_display_init() public function to configure the timer that controls the PWM of the RGB LEDs of the display.
+ * The clock of the timer and its channels are configured by the init function of the board (`p_pwm_init`).
+ * 
+ * @param p_display     Pointer to the display struct.
+ */
+static void _timer_pwm_config (stm32f4_display_hw_t *p_display)
+{
+    TIM_TypeDef *TIMx = p_display->p_tim;
 
-    // Disable output for all channels
-    TIMx->CCER &= ~TIM_CCER_CC1E;   // CH1 (Red)
-    TIMx->CCER &= ~TIM_CCER_CC3E;   // CH3 (Green)
-    TIMx->CCER &= ~TIM_CCER_CC4E;   // CH4 (Blue)
+    // Enable the clock of the timer, disable the output of the channels and set them in PWM mode 1 with preload
+    p_display->p_pwm_init();
 
-    // Clear polarity bits for channels
-    TIMx->CCER &= ~(TIM_CCER_CC1P | TIM_CCER_CC1NP);    // CH1 (Red)
-    TIMx->CCER &= ~(TIM_CCER_CC3P | TIM_CCER_CC3NP);    // CH3 (Green)
-    TIMx->CCER &= ~(TIM_CCER_CC4P | TIM_CCER_CC4NP);    // CH4 (Blue)
+    // Disable counter and enable auto-reload preload. The timer is left disabled at the end
+    STM32F4_REG_MODIFY(TIMx->CR1,
+                       STM32F4_REG_FIELD(TIM_CR1_CEN, 0),
+                       STM32F4_REG_FIELD(TIM_CR1_ARPE, TIM_CR1_ARPE));
 
-    // Set PWM mode 1 and enable output compare preload
-    TIMx->CCMR1 |= (TIM_CCMR1_OC1M_2 | TIM_CCMR1_OC1M_1); // CH1 (Red)
-    TIMx->CCMR2 |= (TIM_CCMR2_OC3M_2 | TIM_CCMR2_OC3M_1); // CH3 (Green)
-    TIMx->CCMR2 |= (TIM_CCMR2_OC4M_2 | TIM_CCMR2_OC4M_1); // CH4 (Blue)
+    // Reset timer counter
+    TIMx->CNT = 0;
 
-    TIMx->CCMR1 |= TIM_CCMR1_OC1PE;                         // CH1 (Reed)
-    TIMx->CCMR2 |= (TIM_CCMR2_OC3PE | TIM_CCMR2_OC4PE);     // CH3 (Green) & CH4 (Blue)
+    // Configure prescaler and auto-reload for the PWM frequency of the display (PSC = 4 and ARR = 63999 for 50 Hz at 16 MHz)
+    _timer_pwm_set_period(p_display);
 
     // Generate update event to apply changes
     TIMx->EGR |= TIM_EGR_UG;
-
-    //Leave timer disabled at the end.
-    TIMx->CR1 &= ~TIM_CR1_CEN;
 }
 
 
@@ -135,18 +148,16 @@ void port_display_init (uint32_t display_id)
         return;
     }
     
-    // Configure RGB GPIOs in alternate function mode with no pull-up/pull-down
-    stm32f4_system_gpio_config(p_display->p_port_red, p_display->pin_red, STM32F4_GPIO_MODE_AF, STM32F4_GPIO_PUPDR_NOPULL);
-    stm32f4_system_gpio_config(p_display->p_port_green, p_display->pin_green, STM32F4_GPIO_MODE_AF, STM32F4_GPIO_PUPDR_NOPULL);
-    stm32f4_system_gpio_config(p_display->p_port_blue, p_display->pin_blue, STM32F4_GPIO_MODE_AF, STM32F4_GPIO_PUPDR_NOPULL);
-
-    // Assign the alternate function (AF2 for TIM4)
-    stm32f4_system_gpio_config_alternate(p_display->p_port_red, p_display->pin_red, STM32F4_AF2);
-    stm32f4_system_gpio_config_alternate(p_display->p_port_green, p_display->pin_green, STM32F4_AF2);
-    stm32f4_system_gpio_config_alternate(p_display->p_port_blue, p_display->pin_blue, STM32F4_AF2);
+    // Configure RGB GPIOs in alternate function mode with no pull-up/pull-down, and assign the alternate function of the timer
+    for (uint32_t i = 0; i < STM32F4_DISPLAY_NUM_CHANNELS; i++)
+    {
+        const stm32f4_display_channel_t *p_channel = &p_display->channels[i];
+        stm32f4_system_gpio_config(p_channel->p_port, p_channel->pin, STM32F4_GPIO_MODE_AF, STM32F4_GPIO_PUPDR_NOPULL);
+        stm32f4_system_gpio_config_alternate(p_channel->p_port, p_channel->pin, p_display->alt_fun);
+    }
 
     // Configure the PWM timer
-    _timer_pwm_config(display_id);
+    _timer_pwm_config(p_display);
 
     // Set all RGB values to 0% (turn off display)
     port_display_set_rgb(display_id, COLOR_OFF);
@@ -156,58 +167,50 @@ void port_display_init (uint32_t display_id)
 void port_display_set_rgb (uint32_t display_id, rgb_color_t color)
 {
     // Check display ID
-    if (display_id != PORT_REAR_PARKING_DISPLAY_ID) return;
+    stm32f4_display_hw_t *p_display = _stm32f4_display_get(display_id);
+    if (p_display == NULL)
+    {
+        return;
+    }
+    p_display->color = color;
 
-    // Retrieve RGB values
-    uint8_t r = color.r;
-    uint8_t g = color.g;
-    uint8_t b = color.b;
+    // Retrieve RGB values, in the order of the channels
+    uint8_t levels[STM32F4_DISPLAY_NUM_CHANNELS] = {color.r, color.g, color.b};
 
     // Get timer and disable it
-    TIM_TypeDef *TIMx = TIM4;
+    TIM_TypeDef *TIMx = p_display->p_tim;
     TIMx->CR1 &= ~TIM_CR1_CEN;
 
+    // Derive the PWM period again if the system clock has changed since the last time
+    if (p_display->pwm_clock_hz != SystemCoreClock)
+    {
+        _timer_pwm_set_period(p_display);
+    }
+
     // All values are zero
-    if ((r == 0) && (g == 0) && (b == 0))
+    if ((levels[0] == 0) && (levels[1] == 0) && (levels[2] == 0))
     {
         // Disable all output channels
-        TIMx->CCER &= ~TIM_CCER_CC1E; // Red
-        TIMx->CCER &= ~TIM_CCER_CC3E; // Green
-        TIMx->CCER &= ~TIM_CCER_CC4E; // Blue
+        for (uint32_t i = 0; i < STM32F4_DISPLAY_NUM_CHANNELS; i++)
+        {
+            TIMx->CCER &= ~p_display->channels[i].ccer_en;
+        }
     }
     else
     {
-        // RED
-        if (r == 0)
-        {
-            TIMx->CCER &= ~TIM_CCER_CC1E;
-        }
-        else
-        {
-            TIMx->CCR1 = ((uint32_t)r * TIM4->ARR) / PORT_DISPLAY_RGB_MAX_VALUE;
-            TIMx->CCER |= TIM_CCER_CC1E;
-        }
-
-        // GREEN
-        if (g == 0)
+        // Duty of each LED, with its channel disabled when it is off
+        for (uint32_t i = 0; i < STM32F4_DISPLAY_NUM_CHANNELS; i++)
         {
-            TIMx->CCER &= ~TIM_CCER_CC3E;
-        }
-        else
-        {
-            TIMx->CCR3 = ((uint32_t)g * TIM4->ARR) / PORT_DISPLAY_RGB_MAX_VALUE;
-            TIMx->CCER |= TIM_CCER_CC3E;
-        }
-
-        // BLUE
-        if (b == 0)
-        {
-            TIMx->CCER &= ~TIM_CCER_CC4E;
-        }
-        else
-        {
-            TIMx->CCR4 = ((uint32_t)b * TIM4->ARR) / PORT_DISPLAY_RGB_MAX_VALUE;
-            TIMx->CCER |= TIM_CCER_CC4E;
+            const stm32f4_display_channel_t *p_channel = &p_display->channels[i];
+            if (levels[i] == 0)
+            {
+                TIMx->CCER &= ~p_channel->ccer_en;
+            }
+            else
+            {
+                *p_channel->p_ccr = ((uint32_t)levels[i] * TIMx->ARR) / PORT_DISPLAY_RGB_MAX_VALUE;
+                TIMx->CCER |= p_channel->ccer_en;
+            }
         }
 
         // Update registers and enable timer
@@ -215,3 +218,23 @@ void port_display_set_rgb (uint32_t display_id, rgb_color_t color)
         TIMx->CR1 |= TIM_CR1_CEN;
     }
 }
+
+uint32_t port_display_set_pwm_frequency (uint32_t display_id, uint32_t freq_hz)
+{
+    // Check display ID
+    stm32f4_display_hw_t *p_display = _stm32f4_display_get(display_id);
+    if (p_display == NULL)
+    {
+        return 0;
+    }
+
+    p_display->p_tim->CR1 &= ~TIM_CR1_CEN;
+
+    p_display->pwm_freq_hz = freq_hz;
+    _timer_pwm_set_period(p_display);
+
+    // Apply the color again with the new period
+    port_display_set_rgb(display_id, p_display->color);
+
+    return p_display->pwm_freq_hz;
+}
@@ -0,0 +1,248 @@
+/**
+ * @file stm32f4_keypad.c
+ * @brief Portable functions to interact with the keypad. All portable functions must be implemented in this file.
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+
+/* HW dependent includes */
+#include "port_keypad.h"
+#include "port_system.h"
+
+/* Microcontroller dependent includes */
+#include "stm32f4_system.h"
+#include "stm32f4_reg.h"
+#include "stm32f4_keypad.h"
+
+/* Defines --------------------------------------------------------------------*/
+#define KEYPAD_DMA_STREAM1_FLAGS (DMA_LIFCR_CTCIF1 | DMA_LIFCR_CHTIF1 | DMA_LIFCR_CTEIF1 | DMA_LIFCR_CDMEIF1 | DMA_LIFCR_CFEIF1) /*!<    All the flags of DMA2 stream 1 @hideinitializer */
+#define KEYPAD_DMA_STREAM2_FLAGS (DMA_LIFCR_CTCIF2 | DMA_LIFCR_CHTIF2 | DMA_LIFCR_CTEIF2 | DMA_LIFCR_CDMEIF2 | DMA_LIFCR_CFEIF2) /*!<    All the flags of DMA2 stream 2 @hideinitializer */
+#define KEYPAD_ROWS_MASK (BIT_POS_TO_MASK(STM32F4_KEYPAD_ROW_0_PIN) | BIT_POS_TO_MASK(STM32F4_KEYPAD_ROW_1_PIN))                  /*!<    Mask of all the rows in the rows port @hideinitializer */
+
+/* Typedefs --------------------------------------------------------------------*/
+typedef struct
+{
+    uint8_t pin;    /*!<    Pin of the inputs port where the key (or its column) is connected   */
+    uint8_t row;    /*!<    Row of the matrix of the key. `STM32F4_KEYPAD_NO_ROW` for direct keys   */
+} stm32f4_keypad_key_hw_t;
+
+/* Global variables ------------------------------------------------------------*/
+/**
+ * @brief Array of elements that represents the HW characteristics of the keys connected to the STM32F4 platform.
+ * This must be hidden from the user, so it is declared as static.
+ */
+static const stm32f4_keypad_key_hw_t keys_arr[PORT_KEYPAD_NUM_KEYS] = {
+    [PORT_KEYPAD_AUX_1_ID] = {.pin = STM32F4_KEYPAD_AUX_1_PIN, .row = STM32F4_KEYPAD_NO_ROW},
+    [PORT_KEYPAD_AUX_2_ID] = {.pin = STM32F4_KEYPAD_AUX_2_PIN, .row = STM32F4_KEYPAD_NO_ROW},
+    [PORT_KEYPAD_MATRIX_R0C0_ID] = {.pin = STM32F4_KEYPAD_COL_0_PIN, .row = 0},
+    [PORT_KEYPAD_MATRIX_R0C1_ID] = {.pin = STM32F4_KEYPAD_COL_1_PIN, .row = 0},
+    [PORT_KEYPAD_MATRIX_R0C2_ID] = {.pin = STM32F4_KEYPAD_COL_2_PIN, .row = 0},
+    [PORT_KEYPAD_MATRIX_R1C0_ID] = {.pin = STM32F4_KEYPAD_COL_0_PIN, .row = 1},
+    [PORT_KEYPAD_MATRIX_R1C1_ID] = {.pin = STM32F4_KEYPAD_COL_1_PIN, .row = 1},
+    [PORT_KEYPAD_MATRIX_R1C2_ID] = {.pin = STM32F4_KEYPAD_COL_2_PIN, .row = 1},
+};
+
+/**
+ * @brief Values written into the BSRR of the rows port to activate each row: the active row is reset (low) and the rest are set (high).
+ */
+static const uint32_t row_patterns_arr[STM32F4_KEYPAD_NUM_ROWS] = {
+    (KEYPAD_ROWS_MASK & ~BIT_POS_TO_MASK(STM32F4_KEYPAD_ROW_0_PIN)) | (BIT_POS_TO_MASK(STM32F4_KEYPAD_ROW_0_PIN) << 16),
+    (KEYPAD_ROWS_MASK & ~BIT_POS_TO_MASK(STM32F4_KEYPAD_ROW_1_PIN)) | (BIT_POS_TO_MASK(STM32F4_KEYPAD_ROW_1_PIN) << 16),
+};
+
+static volatile uint16_t samples_arr[2 * STM32F4_KEYPAD_NUM_ROWS];  /*!<    Two scan buffers filled by the DMA in circular mode   */
+
+static volatile uint32_t keys_state;        /*!<    Debounced state of the keys. Bit `i` is 1 if the key `i` is pressed   */
+static volatile uint32_t keys_pressed;      /*!<    Keys pressed since the last call to `port_keypad_get_pressed_events()`   */
+static volatile uint32_t scan_count;        /*!<    Number of complete scans since the keypad was started   */
+static uint32_t vc_cnt0;                    /*!<    Bit 0 of the vertical counter of each key   */
+static uint32_t vc_cnt1;                    /*!<    Bit 1 of the vertical counter of each key   */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Configure the timer that paces the sampling of the keypad.
+ * The update event requests a sample of the inputs port and the CC1 event, in the middle of the period, requests the activation of the next row.
+ * This gives half a period for the row to settle before it is sampled.
+ */
+static void _timer_scan_setup(void)
+{
+    RCC->APB2ENR |= RCC_APB2ENR_TIM8EN;
+
+    STM32F4_REG_MODIFY(STM32F4_KEYPAD_TIMER->CR1,
+                       STM32F4_REG_FIELD(TIM_CR1_CEN, 0),
+                       STM32F4_REG_FIELD(TIM_CR1_ARPE, TIM_CR1_ARPE));
+    STM32F4_KEYPAD_TIMER->CNT = 0;
+
+    STM32F4_KEYPAD_TIMER->PSC = (SystemCoreClock / 1000000) - 1;        // 1 MHz
+    STM32F4_KEYPAD_TIMER->ARR = STM32F4_KEYPAD_SAMPLE_PERIOD_US - 1;
+    STM32F4_KEYPAD_TIMER->CCR1 = STM32F4_KEYPAD_SAMPLE_PERIOD_US / 2;
+
+    // Output compare frozen: CC1 only generates the event, the pin is not used
+    STM32F4_KEYPAD_TIMER->CCMR1 &= ~(TIM_CCMR1_CC1S | TIM_CCMR1_OC1M);
+
+    // Load PSC and ARR before enabling the DMA requests, so this update event does not trigger a transfer
+    STM32F4_KEYPAD_TIMER->EGR |= TIM_EGR_UG;
+    STM32F4_KEYPAD_TIMER->SR = 0;
+
+    STM32F4_KEYPAD_TIMER->DIER |= TIM_DIER_UDE | TIM_DIER_CC1DE;
+}
+
+/**
+ * @brief Configure (and leave disabled) the DMA streams of the keypad.
+ * The sampling stream transfers half-words from the IDR of the inputs port into the two scan buffers, and interrupts when each one is full.
+ * The rows stream transfers words from the row patterns into the BSRR of the rows port.
+ */
+static void _dma_scan_setup(void)
+{
+    RCC->AHB1ENR |= RCC_AHB1ENR_DMA2EN;
+
+    STM32F4_KEYPAD_SAMPLE_DMA->CR &= ~DMA_SxCR_EN;
+    STM32F4_KEYPAD_ROW_DMA->CR &= ~DMA_SxCR_EN;
+    while ((STM32F4_KEYPAD_SAMPLE_DMA->CR & DMA_SxCR_EN) || (STM32F4_KEYPAD_ROW_DMA->CR & DMA_SxCR_EN))
+    {
+        // Wait for the streams to be disabled
+    }
+    DMA2->LIFCR = KEYPAD_DMA_STREAM1_FLAGS | KEYPAD_DMA_STREAM2_FLAGS;
+
+    // Peripheral to memory, 16 bits, circular, interrupts at half and complete transfer
+    STM32F4_KEYPAD_SAMPLE_DMA->CR = (STM32F4_KEYPAD_DMA_CHANNEL << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_PL_1 | DMA_SxCR_MSIZE_0 | DMA_SxCR_PSIZE_0 | DMA_SxCR_MINC | DMA_SxCR_CIRC | DMA_SxCR_HTIE | DMA_SxCR_TCIE;
+    STM32F4_KEYPAD_SAMPLE_DMA->PAR = (uint32_t)(uintptr_t)&STM32F4_KEYPAD_INPUT_GPIO->IDR;
+    STM32F4_KEYPAD_SAMPLE_DMA->M0AR = (uint32_t)(uintptr_t)samples_arr;
+    STM32F4_KEYPAD_SAMPLE_DMA->NDTR = 2 * STM32F4_KEYPAD_NUM_ROWS;
+
+    // Memory to peripheral, 32 bits, circular
+    STM32F4_KEYPAD_ROW_DMA->CR = (STM32F4_KEYPAD_DMA_CHANNEL << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_PL_1 | DMA_SxCR_MSIZE_1 | DMA_SxCR_PSIZE_1 | DMA_SxCR_MINC | DMA_SxCR_CIRC | DMA_SxCR_DIR_0;
+    STM32F4_KEYPAD_ROW_DMA->PAR = (uint32_t)(uintptr_t)&STM32F4_KEYPAD_ROW_GPIO->BSRR;
+    STM32F4_KEYPAD_ROW_DMA->M0AR = (uint32_t)(uintptr_t)row_patterns_arr;
+    STM32F4_KEYPAD_ROW_DMA->NDTR = STM32F4_KEYPAD_NUM_ROWS;
+
+    NVIC_SetPriority(STM32F4_KEYPAD_SAMPLE_DMA_IRQn, 6);
+}
+
+/* Public functions -----------------------------------------------------------*/
+void port_keypad_init(void)
+{
+    for (uint32_t i = 0; i < PORT_KEYPAD_NUM_KEYS; i++)
+    {
+        stm32f4_system_gpio_config(STM32F4_KEYPAD_INPUT_GPIO, keys_arr[i].pin, STM32F4_GPIO_MODE_IN, STM32F4_GPIO_PUPDR_PULLUP);
+    }
+
+    // All the rows inactive (high) until the sampling starts
+    stm32f4_system_gpio_config(STM32F4_KEYPAD_ROW_GPIO, STM32F4_KEYPAD_ROW_0_PIN, STM32F4_GPIO_MODE_OUT, STM32F4_GPIO_PUPDR_NOPULL);
+    stm32f4_system_gpio_config(STM32F4_KEYPAD_ROW_GPIO, STM32F4_KEYPAD_ROW_1_PIN, STM32F4_GPIO_MODE_OUT, STM32F4_GPIO_PUPDR_NOPULL);
+    STM32F4_KEYPAD_ROW_GPIO->BSRR = KEYPAD_ROWS_MASK;
+
+    stm32f4_keypad_reset();
+
+    _timer_scan_setup();
+    _dma_scan_setup();
+}
+
+void port_keypad_start(void)
+{
+    port_keypad_stop();
+    stm32f4_keypad_reset();
+
+    STM32F4_KEYPAD_SAMPLE_DMA->NDTR = 2 * STM32F4_KEYPAD_NUM_ROWS;
+    STM32F4_KEYPAD_ROW_DMA->NDTR = STM32F4_KEYPAD_NUM_ROWS;
+    DMA2->LIFCR = KEYPAD_DMA_STREAM1_FLAGS | KEYPAD_DMA_STREAM2_FLAGS;
+    STM32F4_KEYPAD_SAMPLE_DMA->CR |= DMA_SxCR_EN;
+    STM32F4_KEYPAD_ROW_DMA->CR |= DMA_SxCR_EN;
+
+    NVIC_EnableIRQ(STM32F4_KEYPAD_SAMPLE_DMA_IRQn);
+
+    STM32F4_KEYPAD_TIMER->CNT = 0;
+    STM32F4_KEYPAD_TIMER->CR1 |= TIM_CR1_CEN;
+}
+
+void port_keypad_stop(void)
+{
+    STM32F4_KEYPAD_TIMER->CR1 &= ~TIM_CR1_CEN;
+    NVIC_DisableIRQ(STM32F4_KEYPAD_SAMPLE_DMA_IRQn);
+
+    STM32F4_KEYPAD_SAMPLE_DMA->CR &= ~DMA_SxCR_EN;
+    STM32F4_KEYPAD_ROW_DMA->CR &= ~DMA_SxCR_EN;
+    while ((STM32F4_KEYPAD_SAMPLE_DMA->CR & DMA_SxCR_EN) || (STM32F4_KEYPAD_ROW_DMA->CR & DMA_SxCR_EN))
+    {
+        // Wait for the streams to finish the current transfer
+    }
+
+    // Release all the rows
+    STM32F4_KEYPAD_ROW_GPIO->BSRR = KEYPAD_ROWS_MASK;
+}
+
+uint32_t port_keypad_get_state(void)
+{
+    return keys_state;
+}
+
+bool port_keypad_get_key(uint32_t key_id)
+{
+    if (key_id >= PORT_KEYPAD_NUM_KEYS)
+    {
+        return false;
+    }
+    return (keys_state & BIT_POS_TO_MASK(key_id)) != 0;
+}
+
+uint32_t port_keypad_get_pressed_events(void)
+{
+    // The ISR of the DMA also writes the events: read and clear them with it disabled
+    NVIC_DisableIRQ(STM32F4_KEYPAD_SAMPLE_DMA_IRQn);
+    uint32_t events = keys_pressed;
+    keys_pressed = 0;
+    if (STM32F4_KEYPAD_TIMER->CR1 & TIM_CR1_CEN)
+    {
+        NVIC_EnableIRQ(STM32F4_KEYPAD_SAMPLE_DMA_IRQn);
+    }
+    return events;
+}
+
+uint32_t port_keypad_get_scan_count(void)
+{
+    return scan_count;
+}
+
+void port_keypad_process_scan(uint32_t buffer_idx)
+{
+    stm32f4_keypad_process_samples((const uint16_t *)&samples_arr[(buffer_idx & 0x01U) * STM32F4_KEYPAD_NUM_ROWS]);
+}
+
+void stm32f4_keypad_process_samples(const uint16_t *p_samples)
+{
+    // Build the raw state of all the keys (active low)
+    uint32_t raw = 0;
+    for (uint32_t i = 0; i < PORT_KEYPAD_NUM_KEYS; i++)
+    {
+        uint32_t sample_idx = (keys_arr[i].row == STM32F4_KEYPAD_NO_ROW) ? 0 : keys_arr[i].row;
+        if ((p_samples[sample_idx] & BIT_POS_TO_MASK(keys_arr[i].pin)) == 0)
+        {
+            raw |= BIT_POS_TO_MASK(i);
+        }
+    }
+
+    // 2-bit vertical counter: a key toggles after PORT_KEYPAD_DEBOUNCE_SCANS consecutive scans different from its state.
+    // Any scan equal to the state resets its counter.
+    uint32_t delta = raw ^ keys_state;
+    vc_cnt0 = ~(vc_cnt0 & delta);
+    vc_cnt1 = vc_cnt0 ^ (vc_cnt1 & delta);
+    uint32_t toggle = delta & vc_cnt0 & vc_cnt1;
+
+    keys_state ^= toggle;
+    keys_pressed |= toggle & keys_state;
+    scan_count++;
+}
+
+void stm32f4_keypad_reset(void)
+{
+    keys_state = 0;
+    keys_pressed = 0;
+    scan_count = 0;
+    vc_cnt0 = UINT32_MAX;
+    vc_cnt1 = UINT32_MAX;
+}
@@ -0,0 +1,222 @@
+/**
+ * @file stm32f4_reverse.c
+ * @brief Portable functions to interact with the reverse-gear and ignition inputs of the vehicle.
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stddef.h>
+
+/* HW dependent includes */
+#include "port_reverse.h"
+#include "port_system.h"
+
+/* Microcontroller dependent includes */
+#include "stm32f4_system.h"
+#include "stm32f4_reverse.h"
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure to define the HW dependencies of the vehicle inputs of a reverse sensor system.
+ */
+typedef struct
+{
+    GPIO_TypeDef *p_reverse_port;   /*!<    GPIO port of the reverse-gear signal */
+    GPIO_TypeDef *p_ignition_port;  /*!<    GPIO port of the ignition signal. NULL if there is no ignition input */
+    uint8_t reverse_pin;            /*!<    GPIO pin of the reverse-gear signal */
+    uint8_t ignition_pin;           /*!<    GPIO pin of the ignition signal */
+    volatile bool flag_engaged;     /*!<    Flag to indicate that the reverse gear is engaged (debounced level) */
+    volatile bool flag_ignition;    /*!<    Flag to indicate that the ignition is on (debounced level) */
+    volatile bool raw_engaged;      /*!<    Level of the reverse-gear input read by the last interrupt */
+    volatile bool raw_ignition;     /*!<    Level of the ignition input read by the last interrupt */
+    volatile uint32_t change_ms;    /*!<    System time of the last interrupt of the inputs, in ms */
+} stm32f4_reverse_hw_t;
+
+/* Global variables ------------------------------------------------------------*/
+static stm32f4_reverse_hw_t reverse_arr[] = {
+    [PORT_REVERSE_GEAR_ID] = {.p_reverse_port = STM32F4_REVERSE_GEAR_GPIO, .reverse_pin = STM32F4_REVERSE_GEAR_PIN, .p_ignition_port = STM32F4_REVERSE_IGNITION_GPIO, .ignition_pin = STM32F4_REVERSE_IGNITION_PIN},
+};
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Get the reverse input struct with the given ID.
+ *
+ * @param reverse_id Reverse input ID.
+ *
+ * @return Pointer to the reverse input struct.
+ * @return NULL If the reverse input ID is not valid.
+ */
+static stm32f4_reverse_hw_t *_stm32f4_reverse_get(uint32_t reverse_id)
+{
+    if (reverse_id < sizeof(reverse_arr) / sizeof(reverse_arr[0]))
+    {
+        return &reverse_arr[reverse_id];
+    }
+    else
+    {
+        return NULL;
+    }
+}
+
+/**
+ * @brief Get the EXTI mask of the lines of the inputs.
+ *
+ * @param p_reverse Pointer to the reverse input struct.
+ * @return uint32_t Mask of the EXTI lines of the reverse-gear and ignition signals.
+ */
+static uint32_t _stm32f4_reverse_exti_mask(stm32f4_reverse_hw_t *p_reverse)
+{
+    uint32_t mask = BIT_POS_TO_MASK(p_reverse->reverse_pin);
+    if (p_reverse->p_ignition_port != NULL)
+    {
+        mask |= BIT_POS_TO_MASK(p_reverse->ignition_pin);
+    }
+    return mask;
+}
+
+/**
+ * @brief Read the levels of the inputs.
+ *
+ * @param p_reverse Pointer to the reverse input struct.
+ */
+static void _stm32f4_reverse_read(stm32f4_reverse_hw_t *p_reverse)
+{
+    p_reverse->raw_engaged = stm32f4_system_gpio_read(p_reverse->p_reverse_port, p_reverse->reverse_pin);
+    if (p_reverse->p_ignition_port != NULL)
+    {
+        p_reverse->raw_ignition = stm32f4_system_gpio_read(p_reverse->p_ignition_port, p_reverse->ignition_pin);
+    }
+}
+
+/**
+ * @brief Take the levels read by the last interrupt as the status of the signals once they have been stable for
+ * `PORT_REVERSE_DEBOUNCE_MS`. The bounces of the contacts of the vehicle interrupt several times: each one restarts the time.
+ *
+ * @param p_reverse Pointer to the reverse input struct.
+ * @return true     If a change of level is still waiting for the debounce time.
+ * @return false    Otherwise.
+ */
+static bool _stm32f4_reverse_debounce(stm32f4_reverse_hw_t *p_reverse)
+{
+    // The levels are read before the time: if the ISR changes them in between, the time of the change is the new one
+    bool engaged = p_reverse->raw_engaged;
+    bool ignition = p_reverse->raw_ignition;
+    uint32_t change_ms = p_reverse->change_ms;
+
+    if ((engaged == p_reverse->flag_engaged) && (ignition == p_reverse->flag_ignition))
+    {
+        return false;
+    }
+    if ((port_system_get_millis() - change_ms) < PORT_REVERSE_DEBOUNCE_MS)
+    {
+        return true;
+    }
+    p_reverse->flag_engaged = engaged;
+    p_reverse->flag_ignition = ignition;
+    return false;
+}
+
+/* Public functions -----------------------------------------------------------*/
+void port_reverse_init(uint32_t reverse_id)
+{
+    stm32f4_reverse_hw_t *p_reverse = _stm32f4_reverse_get(reverse_id);
+    if (p_reverse == NULL)
+    {
+        return;
+    }
+
+    // Both signals are interrupting inputs: every change of level (engage/release, ignition on/off) wakes up the system
+    stm32f4_system_gpio_config(p_reverse->p_reverse_port, p_reverse->reverse_pin, STM32F4_GPIO_MODE_IN, STM32F4_GPIO_PUPDR_PULLDOWN);
+    stm32f4_system_gpio_config_exti(p_reverse->p_reverse_port, p_reverse->reverse_pin, STM32F4_TRIGGER_BOTH_EDGE | STM32F4_TRIGGER_ENABLE_INTERR_REQ);
+    stm32f4_system_gpio_exti_enable(p_reverse->reverse_pin, 1, 0);
+
+    if (p_reverse->p_ignition_port != NULL)
+    {
+        stm32f4_system_gpio_config(p_reverse->p_ignition_port, p_reverse->ignition_pin, STM32F4_GPIO_MODE_IN, STM32F4_GPIO_PUPDR_PULLDOWN);
+        stm32f4_system_gpio_config_exti(p_reverse->p_ignition_port, p_reverse->ignition_pin, STM32F4_TRIGGER_BOTH_EDGE | STM32F4_TRIGGER_ENABLE_INTERR_REQ);
+        stm32f4_system_gpio_exti_enable(p_reverse->ignition_pin, 1, 0);
+    }
+
+    // The vehicle may be started with the reverse gear already engaged: the initial levels are taken without debounce
+    _stm32f4_reverse_read(p_reverse);
+    p_reverse->flag_engaged = p_reverse->raw_engaged;
+    p_reverse->flag_ignition = p_reverse->raw_ignition;
+}
+
+void stm32f4_reverse_set_new_gpio(uint32_t reverse_id, GPIO_TypeDef *p_reverse_port, uint8_t reverse_pin, GPIO_TypeDef *p_ignition_port, uint8_t ignition_pin)
+{
+    stm32f4_reverse_hw_t *p_reverse = _stm32f4_reverse_get(reverse_id);
+    p_reverse->p_reverse_port = p_reverse_port;
+    p_reverse->reverse_pin = reverse_pin;
+    p_reverse->p_ignition_port = p_ignition_port;
+    p_reverse->ignition_pin = ignition_pin;
+}
+
+bool port_reverse_get_engaged(uint32_t reverse_id)
+{
+    stm32f4_reverse_hw_t *p_reverse = _stm32f4_reverse_get(reverse_id);
+    _stm32f4_reverse_debounce(p_reverse);
+    return p_reverse->flag_engaged;
+}
+
+void port_reverse_set_engaged(uint32_t reverse_id, bool engaged)
+{
+    stm32f4_reverse_hw_t *p_reverse = _stm32f4_reverse_get(reverse_id);
+    p_reverse->flag_engaged = engaged;
+    p_reverse->raw_engaged = engaged;
+}
+
+bool port_reverse_get_ignition(uint32_t reverse_id)
+{
+    stm32f4_reverse_hw_t *p_reverse = _stm32f4_reverse_get(reverse_id);
+    _stm32f4_reverse_debounce(p_reverse);
+    return p_reverse->flag_ignition;
+}
+
+bool port_reverse_get_debouncing(uint32_t reverse_id)
+{
+    stm32f4_reverse_hw_t *p_reverse = _stm32f4_reverse_get(reverse_id);
+    return _stm32f4_reverse_debounce(p_reverse);
+}
+
+void port_reverse_set_ignition(uint32_t reverse_id, bool ignition)
+{
+    stm32f4_reverse_hw_t *p_reverse = _stm32f4_reverse_get(reverse_id);
+    p_reverse->flag_ignition = ignition;
+    p_reverse->raw_ignition = ignition;
+}
+
+void port_reverse_update(uint32_t reverse_id)
+{
+    stm32f4_reverse_hw_t *p_reverse = _stm32f4_reverse_get(reverse_id);
+
+    _stm32f4_reverse_read(p_reverse);
+    p_reverse->change_ms = port_system_get_millis();
+}
+
+bool port_reverse_get_pending_interrupt(uint32_t reverse_id)
+{
+    stm32f4_reverse_hw_t *p_reverse = _stm32f4_reverse_get(reverse_id);
+    return (EXTI->PR & _stm32f4_reverse_exti_mask(p_reverse)) != 0;
+}
+
+void port_reverse_clear_pending_interrupt(uint32_t reverse_id)
+{
+    stm32f4_reverse_hw_t *p_reverse = _stm32f4_reverse_get(reverse_id);
+
+    // Write 1 to clear: only the lines of the inputs, not the other pending lines
+    EXTI->PR = _stm32f4_reverse_exti_mask(p_reverse);
+}
+
+void port_reverse_disable_interrupts(uint32_t reverse_id)
+{
+    stm32f4_reverse_hw_t *p_reverse = _stm32f4_reverse_get(reverse_id);
+    stm32f4_system_gpio_exti_disable(p_reverse->reverse_pin);
+    if (p_reverse->p_ignition_port != NULL)
+    {
+        stm32f4_system_gpio_exti_disable(p_reverse->ignition_pin);
+    }
+}
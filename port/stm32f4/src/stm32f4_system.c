@@ -13,6 +13,13 @@
 extern void initialise_monitor_handles(void);
 #endif
 
+#ifdef USE_RAMFUNC
+/* Symbols of the linker script fragment stm32f4_ramfunc.ld */
+extern uint32_t _siramfunc; /*!< Load address of the functions placed in SRAM (in flash) */
+extern uint32_t _sramfunc;  /*!< Start address of the functions placed in SRAM */
+extern uint32_t _eramfunc;  /*!< End address of the functions placed in SRAM */
+#endif
+
 //------------------------------------------------------
 // FILE-SPECIFIC DEFINITIONS
 //------------------------------------------------------
@@ -26,11 +33,17 @@ extern void initialise_monitor_handles(void);
                                                          0 bit  for subpriority */
 /* Power */
 #define POWER_REGULATOR_VOLTAGE_SCALE3 0x01 /*!< Scale 3 mode: the maximum value of fHCLK is 120 MHz. */
+/* Virtual clock */
+#define VIRTUAL_CLOCK_NUM_TIMERS 4U /*!< Number of timers fast-forwarded by the virtual clock */
 
 //------------------------------------------------------
 // PRIVATE (STATIC) VARIABLES
 //------------------------------------------------------
 static volatile uint32_t msTicks = 0; /*!< Variable to store millisecond ticks. @warning **It must be declared volatile!** Just because it is modified in an ISR. **Add it to the definition** after *static*. */
+static bool power_on_reset = false;  /*!< The last reset was a power-on or brown-out reset. Its flags are cleared by `port_system_init()` */
+#ifdef USE_VIRTUAL_CLOCK
+static TIM_TypeDef *const virtual_clock_timers[VIRTUAL_CLOCK_NUM_TIMERS] = {TIM2, TIM3, TIM4, TIM5}; /*!< Timers of the port whose update events are fired by the virtual clock */
+#endif
 
 //------------------------------------------------------
 // PUBLIC (GLOBAL) VARIABLES
@@ -41,10 +54,31 @@ uint32_t SystemCoreClock = HSI_VALUE;
 const uint8_t AHBPrescTable[16] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 2, 3, 4, 6, 7, 8, 9}; /*!< Prescaler values for AHB bus */
 const uint8_t APBPrescTable[8] = {0, 0, 0, 0, 1, 2, 3, 4};                          /*!< Prescaler values for APB bus */
 
+stm32f4_irq_latency_t stm32f4_irq_latency = {.armed_irqn = STM32F4_IRQ_LATENCY_NONE, .min = UINT32_MAX}; /*!< Interrupt latency measured by the probes of the ISRs */
+
 //------------------------------------------------------
 // PRIVATE (STATIC) FUNCTIONS
 //------------------------------------------------------
 
+/**
+ * @brief Copy the functions marked with `PORT_RAMFUNC` from flash to SRAM.
+ *
+ * @note This function is called by `SystemInit()` before `main()`, so the ISRs in SRAM are ready before any interrupt is enabled.
+ * It does not use any global variable, because `.data` and `.bss` may not be initialized yet.
+ */
+static void system_ramfunc_copy(void)
+{
+#ifdef USE_RAMFUNC
+  const uint32_t *p_src = &_siramfunc;
+  for (uint32_t *p_dst = &_sramfunc; p_dst < &_eramfunc; p_dst++)
+  {
+    *p_dst = *p_src++;
+  }
+  __DSB(); /* Complete the copy before fetching code from SRAM */
+  __ISB();
+#endif
+}
+
 /**
  * @brief System Clock Configuration
  *
@@ -102,6 +136,9 @@ static void system_clock_config(void)
  */
 void SystemInit(void)
 {
+  /* Functions executed from SRAM ----------------------------------------------*/
+  system_ramfunc_copy();
+
 /* FPU settings ------------------------------------------------------------*/
 #if (__FPU_PRESENT == 1) && (__FPU_USED == 1)
   SCB->CPACR |= ((3UL << 10 * 2) | (3UL << 11 * 2)); /* set CP10 and CP11 Full Access */
@@ -142,6 +179,10 @@ uint32_t port_system_init()
   /* Configure the SysTick IRQ priority. It must be the highest (lower number: 0)*/
   NVIC_SetPriority(SysTick_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 0U, 0U)); /* Tick interrupt priority */
 
+  /* Cause of the reset. The flags are cleared, so the next reset reports its own cause only */
+  power_on_reset = (RCC->CSR & (RCC_CSR_PORRSTF | RCC_CSR_BORRSTF)) != 0;
+  RCC->CSR |= RCC_CSR_RMVF;
+
   /* Init the low level hardware */
   /* Reset and clock control (RCC) */
   RCC->APB2ENR |= RCC_APB2ENR_SYSCFGEN; /* Syscfg clock enabling */
@@ -155,14 +196,76 @@ uint32_t port_system_init()
   return 0;
 }
 
+#ifdef USE_VIRTUAL_CLOCK
+/**
+ * @brief Get the clock of the timers of APB1 (TIM2 to TIM5).
+ * It is the clock of the bus, doubled by the RCC when the APB1 prescaler is not 1.
+ *
+ * @return uint32_t Clock of the timers in Hz.
+ */
+static uint32_t system_apb1_timer_clock(void)
+{
+  uint32_t shift = APBPrescTable[(RCC->CFGR & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos];
+  uint32_t pclk1 = SystemCoreClock >> shift;
+  return (shift == 0U) ? pclk1 : (2U * pclk1);
+}
+
+/**
+ * @brief Advance the virtual clock 1 ms.
+ *
+ * The counter of each running timer with update interrupt is advanced the ticks of 1 ms. If it reaches the update, the update
+ * event is generated by software (`UG`), so its interrupt is taken now, and the counter then goes on with the remaining ticks.
+ * A timer gets at most one update per step: faster timers also run in real time. Finally, the System tick is incremented with
+ * the interrupts masked, as the SysTick ISR would do.
+ */
+static void system_virtual_clock_tick(void)
+{
+  uint32_t ticks_per_ms = system_apb1_timer_clock() / 1000U;
+  for (uint32_t i = 0; i < VIRTUAL_CLOCK_NUM_TIMERS; i++)
+  {
+    TIM_TypeDef *TIMx = virtual_clock_timers[i];
+    if (!(TIMx->CR1 & TIM_CR1_CEN) || !(TIMx->DIER & TIM_DIER_UIE))
+    {
+      continue;
+    }
+    uint64_t ticks = ticks_per_ms / (TIMx->PSC + 1U);
+    uint64_t to_update = (uint64_t)TIMx->ARR - TIMx->CNT + 1U;
+    if (ticks < to_update)
+    {
+      TIMx->CNT += (uint32_t)ticks;
+      continue;
+    }
+    TIMx->EGR = TIM_EGR_UG; /* Update event now: the counter restarts and the ISR is taken */
+    __DSB();
+    __ISB();
+    if (TIMx->CR1 & TIM_CR1_CEN) /* The ISR may have stopped or reconfigured the timer */
+    {
+      TIMx->CNT = (uint32_t)((ticks - to_update) % ((uint64_t)TIMx->ARR + 1U));
+    }
+  }
+
+  uint32_t primask = __get_PRIMASK();
+  __disable_irq();
+  msTicks++;
+  __set_PRIMASK(primask);
+}
+#endif
+
 //------------------------------------------------------
 // TIMER RELATED FUNCTIONS
 //------------------------------------------------------
 void port_system_delay_ms(uint32_t ms)
 {
+#ifdef USE_VIRTUAL_CLOCK
+  for (uint32_t i = 0; i < ms; i++)
+  {
+    system_virtual_clock_tick();
+  }
+#else
   uint32_t tickstart = msTicks;
 
   while ((msTicks - tickstart) < ms);
+#endif
 }
 
 void port_system_delay_until_ms(uint32_t *p_t, uint32_t ms)
@@ -187,6 +290,11 @@ void port_system_set_millis(uint32_t ms)
 }
 
 
+bool port_system_get_power_on_reset(void)
+{
+  return power_on_reset;
+}
+
 void port_system_systick_suspend(void)
 {
  SysTick->CTRL &= ~SysTick_CTRL_TICKINT_Msk;
@@ -327,6 +435,61 @@ void stm32f4_system_gpio_toggle (GPIO_TypeDef *p_port, uint8_t pin)
   bool value = stm32f4_system_gpio_read(p_port, pin);
   stm32f4_system_gpio_write(p_port, pin, !value);
 }
+
+//------------------------------------------------------
+// CYCLE COUNTER RELATED FUNCTIONS
+//------------------------------------------------------
+void stm32f4_system_cycle_counter_init(void)
+{
+  CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk; // Enable the trace and debug blocks, DWT included
+  DWT->CYCCNT = 0;
+  DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+uint32_t stm32f4_system_get_cycles(void)
+{
+  return DWT->CYCCNT;
+}
+
+//------------------------------------------------------
+// INTERRUPT LATENCY RELATED FUNCTIONS
+//------------------------------------------------------
+void stm32f4_system_irq_latency_reset(void)
+{
+  stm32f4_system_cycle_counter_init();
+  stm32f4_irq_latency.armed_irqn = STM32F4_IRQ_LATENCY_NONE;
+  stm32f4_irq_latency.last = 0;
+  stm32f4_irq_latency.min = UINT32_MAX;
+  stm32f4_irq_latency.max = 0;
+  stm32f4_irq_latency.count = 0;
+}
+
+void stm32f4_system_irq_latency_trigger(IRQn_Type irqn)
+{
+  stm32f4_irq_latency.armed_irqn = irqn;
+  stm32f4_irq_latency.pend_cycles = DWT->CYCCNT;
+  if (irqn == SysTick_IRQn)
+  {
+    SCB->ICSR = SCB_ICSR_PENDSTSET_Msk;
+  }
+  else
+  {
+    NVIC->STIR = (uint32_t)irqn;
+  }
+  __DSB();
+  __ISB();
+}
+
+void stm32f4_system_flash_cache_flush(void)
+{
+  uint32_t caches = FLASH->ACR & (FLASH_ACR_ICEN | FLASH_ACR_DCEN);
+
+  /* The caches can only be reset while they are disabled */
+  FLASH->ACR &= ~(FLASH_ACR_ICEN | FLASH_ACR_DCEN);
+  FLASH->ACR |= (FLASH_ACR_ICRST | FLASH_ACR_DCRST);
+  FLASH->ACR &= ~(FLASH_ACR_ICRST | FLASH_ACR_DCRST);
+  FLASH->ACR |= caches;
+}
 // ------------------------------------------------------
 // POWER RELATED FUNCTIONS
 // ------------------------------------------------------
@@ -0,0 +1,651 @@
+/**
+ * @file stm32f4_tof.c
+ * @brief Portable functions to interact with the ToF distance sensors. All portable functions must be implemented in this file.
+ *
+ * The I2C controller runs in master mode with the event and error interrupts enabled and without the buffer interrupts: the
+ * addressing phases of each transfer are advanced by `port_tof_process_bus_event()` and the data bytes are moved by the DMA.
+ * Only the configuration in `port_tof_init()` polls the flags of the bus.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stddef.h>
+
+/* HW dependent includes */
+#include "port_tof.h"
+#include "port_system.h"
+
+/* Microcontroller dependent includes */
+#include "stm32f4_system.h"
+#include "stm32f4_tof.h"
+
+/* Project includes */
+#include "metrics.h"
+
+/* Defines --------------------------------------------------------------------*/
+#define TOF_TX_DMA_FLAGS (DMA_HIFCR_CTCIF7 | DMA_HIFCR_CHTIF7 | DMA_HIFCR_CTEIF7 | DMA_HIFCR_CDMEIF7 | DMA_HIFCR_CFEIF7)  /*!<    All the flags of DMA1 stream 7 @hideinitializer */
+#define TOF_RX_DMA_FLAGS (DMA_LIFCR_CTCIF2 | DMA_LIFCR_CHTIF2 | DMA_LIFCR_CTEIF2 | DMA_LIFCR_CDMEIF2 | DMA_LIFCR_CFEIF2)  /*!<    All the flags of DMA1 stream 2 @hideinitializer */
+#define TOF_BUS_ERRORS (I2C_SR1_BERR | I2C_SR1_ARLO | I2C_SR1_AF | I2C_SR1_OVR)                                           /*!<    Error flags of the bus @hideinitializer */
+#define TOF_NUM_SENSORS (sizeof(tofs_arr) / sizeof(tofs_arr[0]))                                                        /*!<    Number of ToF sensors @hideinitializer */
+
+/**
+ * @brief Steps of the measurement of a sensor.
+ */
+enum
+{
+    TOF_STEP_IDLE = 0,      /*!<    No measurement in progress */
+    TOF_STEP_START,         /*!<    Write of the start command */
+    TOF_STEP_WAIT_SAMPLE,   /*!<    Ranging, waiting for the interrupt pin */
+    TOF_STEP_READ,          /*!<    Read of the result block (pending while the bus is busy) */
+    TOF_STEP_CLEAR,         /*!<    Write of the clear of the interrupt of the sensor */
+};
+
+/**
+ * @brief Phases of a transfer on the bus.
+ */
+enum
+{
+    TOF_BUS_IDLE = 0,       /*!<    No transfer in progress */
+    TOF_BUS_START,          /*!<    Start condition requested */
+    TOF_BUS_ADDRESS,        /*!<    Address (write) sent */
+    TOF_BUS_REGISTER,       /*!<    Register of a read sent, waiting for it to be transmitted */
+    TOF_BUS_RESTART,        /*!<    Repeated start condition of a read requested */
+    TOF_BUS_READ_ADDRESS,   /*!<    Address (read) sent */
+    TOF_BUS_DATA,           /*!<    Data moved by the DMA */
+};
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Structure to define the HW dependencies of a ToF sensor.
+ */
+typedef struct
+{
+    GPIO_TypeDef *p_int_port;   /*!<    GPIO where the interrupt pin of the sensor is connected */
+    uint8_t int_pin;            /*!<    Pin where the interrupt pin of the sensor is connected */
+    uint8_t int_prio;           /*!<    Priority of the interrupt of the new samples */
+    GPIO_TypeDef *p_xshut_port; /*!<    GPIO where the shutdown pin of the sensor is connected. NULL if it is tied high */
+    uint8_t xshut_pin;          /*!<    Pin where the shutdown pin of the sensor is connected */
+    uint8_t address;            /*!<    7-bit I2C address of the sensor */
+} stm32f4_tof_hw_t;
+
+/**
+ * @brief Structure to define the state of the measurements of a ToF sensor.
+ */
+typedef struct
+{
+    volatile uint8_t step;              /*!<    Step of the measurement in progress */
+    volatile bool measurement_ready;    /*!<    Flag to indicate that the last measurement has finished */
+    bool configured;                    /*!<    Flag to indicate that the sensor has answered and has been configured */
+    bool range_valid;                   /*!<    Validity of the last measurement */
+    uint16_t distance_mm;               /*!<    Distance of the last measurement in mm */
+    uint32_t signal_rate_kcps;          /*!<    Return signal rate of the last measurement in kcps */
+} stm32f4_tof_state_t;
+
+/**
+ * @brief Structure to define the transfer in progress on the bus.
+ */
+typedef struct
+{
+    volatile uint8_t phase; /*!<    Phase of the transfer */
+    uint8_t tof_id;         /*!<    Sensor of the transfer */
+    bool read;              /*!<    Read of `STM32F4_TOF_RESULT_LEN` bytes (true) or write of a register (false) */
+} stm32f4_tof_bus_t;
+
+/* Global variables ------------------------------------------------------------*/
+/**
+ * @brief Array of elements that represents the HW characteristics of the ToF sensors connected to the STM32F4 platform.
+ * This must be hidden from the user, so it is declared as static.
+ */
+static const stm32f4_tof_hw_t tofs_arr[] = {
+    [PORT_REAR_TOF_SENSOR_ID] = {.p_int_port = STM32F4_REAR_TOF_INT_GPIO, .int_pin = STM32F4_REAR_TOF_INT_PIN, .int_prio = STM32F4_REAR_TOF_INT_IRQ_PRIO, .p_xshut_port = STM32F4_REAR_TOF_XSHUT_GPIO, .xshut_pin = STM32F4_REAR_TOF_XSHUT_PIN, .address = STM32F4_REAR_TOF_ADDRESS},
+};
+
+/**
+ * @brief Configuration written into each sensor after its identification: pairs of register and value.
+ * 2.8 V I/O, standard I2C mode, interrupt pin active low on each new sample, and the default ranging sequence (DSS, pre-range and final range).
+ */
+static const uint8_t tof_config_arr[][2] = {
+    {STM32F4_TOF_REG_PAD_EXTSUP_HV, 0x01U},
+    {STM32F4_TOF_REG_I2C_MODE, 0x00U},
+    {STM32F4_TOF_REG_SEQUENCE_CONFIG, 0xE8U},
+    {STM32F4_TOF_REG_INTERRUPT_CONFIG, 0x04U},
+    {STM32F4_TOF_REG_GPIO_HV_MUX, 0x01U},
+    {STM32F4_TOF_REG_INTERRUPT_CLEAR, 0x01U},
+};
+
+static stm32f4_tof_state_t tofs_state_arr[TOF_NUM_SENSORS];    /*!<    State of the measurements of each sensor   */
+static stm32f4_tof_bus_t bus;                                   /*!<    Transfer in progress on the bus   */
+static bool bus_configured;                                     /*!<    The bus and its DMA streams have been configured   */
+static uint8_t tx_buffer[2];                                    /*!<    Register and value of the write in progress, sent by the DMA   */
+static volatile uint8_t rx_buffer[STM32F4_TOF_RESULT_LEN];      /*!<    Result block filled by the DMA   */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Configure the pins, the I2C controller and the DMA streams of the bus of the ToF sensors.
+ * The pins are open drain with the internal pull-ups (the external ones of the boards of the sensors are also valid).
+ */
+static void _bus_setup(void)
+{
+    stm32f4_system_gpio_config(STM32F4_TOF_SCL_GPIO, STM32F4_TOF_SCL_PIN, STM32F4_GPIO_MODE_AF, STM32F4_GPIO_PUPDR_PULLUP);
+    stm32f4_system_gpio_config_alternate(STM32F4_TOF_SCL_GPIO, STM32F4_TOF_SCL_PIN, STM32F4_TOF_I2C_AF);
+    STM32F4_TOF_SCL_GPIO->OTYPER |= BIT_POS_TO_MASK(STM32F4_TOF_SCL_PIN);
+    stm32f4_system_gpio_config(STM32F4_TOF_SDA_GPIO, STM32F4_TOF_SDA_PIN, STM32F4_GPIO_MODE_AF, STM32F4_GPIO_PUPDR_PULLUP);
+    stm32f4_system_gpio_config_alternate(STM32F4_TOF_SDA_GPIO, STM32F4_TOF_SDA_PIN, STM32F4_TOF_I2C_AF);
+    STM32F4_TOF_SDA_GPIO->OTYPER |= BIT_POS_TO_MASK(STM32F4_TOF_SDA_PIN);
+
+    RCC->APB1ENR |= RCC_APB1ENR_I2C2EN;
+    RCC->AHB1ENR |= RCC_AHB1ENR_DMA1EN;
+
+    // Reset the controller, in case the bus was left busy by an interrupted transfer
+    STM32F4_TOF_I2C->CR1 = I2C_CR1_SWRST;
+    STM32F4_TOF_I2C->CR1 = 0;
+
+    // Fast mode with duty 2:1: the period of SCL is 3 * CCR periods of PCLK1, rounded up so the bus is never faster than
+    // its speed. The maximum rise time is 300 ns
+    uint32_t pclk_hz = SystemCoreClock >> APBPrescTable[(RCC->CFGR & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos];
+    uint32_t pclk_mhz = pclk_hz / 1000000;
+    uint32_t ccr = (pclk_hz + (3 * STM32F4_TOF_I2C_SPEED_HZ) - 1) / (3 * STM32F4_TOF_I2C_SPEED_HZ);
+    STM32F4_TOF_I2C->CR2 = (pclk_mhz << I2C_CR2_FREQ_Pos) & I2C_CR2_FREQ;
+    STM32F4_TOF_I2C->CCR = I2C_CCR_FS | (((ccr == 0) ? 1 : ccr) & I2C_CCR_CCR);
+    STM32F4_TOF_I2C->TRISE = ((pclk_mhz * 300) / 1000) + 1;
+    STM32F4_TOF_I2C->CR1 = I2C_CR1_PE;
+
+    STM32F4_TOF_TX_DMA->CR &= ~DMA_SxCR_EN;
+    STM32F4_TOF_RX_DMA->CR &= ~DMA_SxCR_EN;
+    while ((STM32F4_TOF_TX_DMA->CR & DMA_SxCR_EN) || (STM32F4_TOF_RX_DMA->CR & DMA_SxCR_EN))
+    {
+        // Wait for the streams to be disabled
+    }
+    DMA1->HIFCR = TOF_TX_DMA_FLAGS;
+    DMA1->LIFCR = TOF_RX_DMA_FLAGS;
+
+    // Memory to peripheral, 8 bits, interrupt on error. The end of the write is the BTF event of the bus
+    STM32F4_TOF_TX_DMA->CR = (STM32F4_TOF_DMA_CHANNEL << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_PL_1 | DMA_SxCR_MINC | DMA_SxCR_DIR_0 | DMA_SxCR_TEIE;
+    STM32F4_TOF_TX_DMA->PAR = (uint32_t)(uintptr_t)&STM32F4_TOF_I2C->DR;
+    STM32F4_TOF_TX_DMA->M0AR = (uint32_t)(uintptr_t)tx_buffer;
+
+    // Peripheral to memory, 8 bits, interrupts on complete transfer and error
+    STM32F4_TOF_RX_DMA->CR = (STM32F4_TOF_DMA_CHANNEL << DMA_SxCR_CHSEL_Pos) | DMA_SxCR_PL_1 | DMA_SxCR_MINC | DMA_SxCR_TCIE | DMA_SxCR_TEIE;
+    STM32F4_TOF_RX_DMA->PAR = (uint32_t)(uintptr_t)&STM32F4_TOF_I2C->DR;
+    STM32F4_TOF_RX_DMA->M0AR = (uint32_t)(uintptr_t)rx_buffer;
+
+    NVIC_SetPriority(I2C2_EV_IRQn, STM32F4_TOF_I2C_IRQ_PRIO);
+    NVIC_SetPriority(I2C2_ER_IRQn, STM32F4_TOF_I2C_IRQ_PRIO);
+    NVIC_SetPriority(DMA1_Stream2_IRQn, STM32F4_TOF_I2C_IRQ_PRIO);
+    NVIC_SetPriority(DMA1_Stream7_IRQn, STM32F4_TOF_I2C_IRQ_PRIO);
+    NVIC_EnableIRQ(I2C2_EV_IRQn);
+    NVIC_EnableIRQ(I2C2_ER_IRQn);
+    NVIC_EnableIRQ(DMA1_Stream2_IRQn);
+    NVIC_EnableIRQ(DMA1_Stream7_IRQn);
+
+    bus.phase = TOF_BUS_IDLE;
+    bus_configured = true;
+}
+
+/**
+ * @brief Wait for a flag of the status register 1 of the bus, with a timeout. A missing acknowledge aborts the wait.
+ *
+ * @param flag      Flag of SR1.
+ * @return true     If the flag has been set.
+ * @return false    If the slave has not acknowledged or the flag has not been set in `STM32F4_TOF_BUS_TIMEOUT` polls.
+ */
+static bool _bus_wait_flag(uint32_t flag)
+{
+    for (uint32_t i = 0; i < STM32F4_TOF_BUS_TIMEOUT; i++)
+    {
+        uint32_t sr1 = STM32F4_TOF_I2C->SR1;
+        if (sr1 & flag)
+        {
+            return true;
+        }
+        if (sr1 & I2C_SR1_AF)
+        {
+            break;
+        }
+    }
+    STM32F4_TOF_I2C->SR1 &= ~TOF_BUS_ERRORS;
+    STM32F4_TOF_I2C->CR1 |= I2C_CR1_STOP;
+    return false;
+}
+
+/**
+ * @brief Generate a start condition and send the address of a sensor, polling the flags. The ADDR flag is left set.
+ *
+ * @param address   7-bit address of the sensor.
+ * @param read      Direction of the transfer.
+ * @return true     If the sensor has acknowledged its address.
+ * @return false    Otherwise. A stop condition has been generated.
+ */
+static bool _bus_start_blocking(uint8_t address, bool read)
+{
+    STM32F4_TOF_I2C->CR1 |= I2C_CR1_START;
+    if (!_bus_wait_flag(I2C_SR1_SB))
+    {
+        return false;
+    }
+    STM32F4_TOF_I2C->DR = (uint32_t)(address << 1) | (read ? 1U : 0U);
+    return _bus_wait_flag(I2C_SR1_ADDR);
+}
+
+/**
+ * @brief Write a register of a sensor, polling the flags of the bus.
+ *
+ * @param address   7-bit address of the sensor.
+ * @param reg       Register.
+ * @param value     Value.
+ * @return true     If the write has been acknowledged.
+ * @return false    Otherwise.
+ */
+static bool _bus_write_blocking(uint8_t address, uint8_t reg, uint8_t value)
+{
+    if (!_bus_start_blocking(address, false))
+    {
+        return false;
+    }
+    (void)STM32F4_TOF_I2C->SR2;     // Clear ADDR
+    STM32F4_TOF_I2C->DR = reg;
+    if (!_bus_wait_flag(I2C_SR1_TXE))
+    {
+        return false;
+    }
+    STM32F4_TOF_I2C->DR = value;
+    if (!_bus_wait_flag(I2C_SR1_BTF))
+    {
+        return false;
+    }
+    STM32F4_TOF_I2C->CR1 |= I2C_CR1_STOP;
+    return true;
+}
+
+/**
+ * @brief Read a register of a sensor, polling the flags of the bus.
+ *
+ * @param address   7-bit address of the sensor.
+ * @param reg       Register.
+ * @param p_value   Pointer to store the value.
+ * @return true     If the read has been acknowledged.
+ * @return false    Otherwise.
+ */
+static bool _bus_read_blocking(uint8_t address, uint8_t reg, uint8_t *p_value)
+{
+    if (!_bus_start_blocking(address, false))
+    {
+        return false;
+    }
+    (void)STM32F4_TOF_I2C->SR2;     // Clear ADDR
+    STM32F4_TOF_I2C->DR = reg;
+    if (!_bus_wait_flag(I2C_SR1_BTF) || !_bus_start_blocking(address, true))
+    {
+        return false;
+    }
+    // Single byte: NACK and stop are programmed before ADDR is cleared
+    STM32F4_TOF_I2C->CR1 &= ~I2C_CR1_ACK;
+    (void)STM32F4_TOF_I2C->SR2;
+    STM32F4_TOF_I2C->CR1 |= I2C_CR1_STOP;
+    bool ok = _bus_wait_flag(I2C_SR1_RXNE);
+    *p_value = (uint8_t)STM32F4_TOF_I2C->DR;
+    return ok;
+}
+
+/**
+ * @brief Start a transfer of a sensor on the bus, driven by the interrupts. The bus must be idle.
+ *
+ * @param tof_id    ToF ID.
+ * @param read      Read of the result block (true) or write of a register (false).
+ * @param reg       Register of the write. Ignored in the read.
+ * @param value     Value of the write. Ignored in the read.
+ */
+static void _bus_transfer_start(uint32_t tof_id, bool read, uint8_t reg, uint8_t value)
+{
+    bus.tof_id = (uint8_t)tof_id;
+    bus.read = read;
+    if (read)
+    {
+        STM32F4_TOF_RX_DMA->NDTR = STM32F4_TOF_RESULT_LEN;
+    }
+    else
+    {
+        // The TX stream only transfers after ADDR is cleared, when the data register is empty
+        tx_buffer[0] = reg;
+        tx_buffer[1] = value;
+        DMA1->HIFCR = TOF_TX_DMA_FLAGS;
+        STM32F4_TOF_TX_DMA->NDTR = sizeof(tx_buffer);
+        STM32F4_TOF_TX_DMA->CR |= DMA_SxCR_EN;
+        STM32F4_TOF_I2C->CR2 |= I2C_CR2_DMAEN;
+    }
+    bus.phase = TOF_BUS_START;
+    STM32F4_TOF_I2C->CR2 |= I2C_CR2_ITEVTEN | I2C_CR2_ITERREN;
+    STM32F4_TOF_I2C->CR1 |= I2C_CR1_ACK | I2C_CR1_START;
+}
+
+/**
+ * @brief Start the transfer of the next step of a measurement, or finish it.
+ *
+ * @param tof_id    ToF ID.
+ */
+static void _measurement_advance(uint32_t tof_id)
+{
+    stm32f4_tof_state_t *p_state = &tofs_state_arr[tof_id];
+    switch (p_state->step)
+    {
+    case TOF_STEP_START:
+        // The sensor is ranging: the interrupt pin signals the end
+        p_state->step = TOF_STEP_WAIT_SAMPLE;
+        break;
+    case TOF_STEP_READ:
+        stm32f4_tof_process_result(tof_id, (const uint8_t *)rx_buffer);
+        p_state->step = TOF_STEP_CLEAR;
+        _bus_transfer_start(tof_id, false, STM32F4_TOF_REG_INTERRUPT_CLEAR, 0x01U);
+        break;
+    case TOF_STEP_CLEAR:
+        p_state->step = TOF_STEP_IDLE;
+        p_state->measurement_ready = true;
+        metrics_counter_inc(METRIC_TOF_MEASUREMENTS);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Release the bus at the end of a transfer and continue with the measurements that were waiting for it.
+ *
+ * @param ok    The transfer has finished without errors.
+ */
+static void _bus_transfer_end(bool ok)
+{
+    STM32F4_TOF_I2C->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_DMAEN | I2C_CR2_LAST);
+    STM32F4_TOF_TX_DMA->CR &= ~DMA_SxCR_EN;
+    STM32F4_TOF_RX_DMA->CR &= ~DMA_SxCR_EN;
+    bus.phase = TOF_BUS_IDLE;
+
+    uint32_t tof_id = bus.tof_id;
+    if (ok)
+    {
+        _measurement_advance(tof_id);
+    }
+    else
+    {
+        stm32f4_tof_state_t *p_state = &tofs_state_arr[tof_id];
+        p_state->step = TOF_STEP_IDLE;
+        p_state->range_valid = false;
+        p_state->measurement_ready = true;
+        metrics_counter_inc(METRIC_TOF_BUS_ERRORS);
+    }
+
+    // Results signalled while the bus was busy
+    for (uint32_t i = 0; (i < TOF_NUM_SENSORS) && (bus.phase == TOF_BUS_IDLE); i++)
+    {
+        if (tofs_state_arr[i].step == TOF_STEP_READ)
+        {
+            _bus_transfer_start(i, true, 0, 0);
+        }
+    }
+}
+
+/* Public functions -----------------------------------------------------------*/
+bool port_tof_init(uint32_t tof_id)
+{
+    if (tof_id >= TOF_NUM_SENSORS)
+    {
+        return false;
+    }
+    const stm32f4_tof_hw_t *p_tof = &tofs_arr[tof_id];
+    stm32f4_tof_state_t *p_state = &tofs_state_arr[tof_id];
+    p_state->step = TOF_STEP_IDLE;
+    p_state->measurement_ready = false;
+    p_state->configured = false;
+    p_state->range_valid = false;
+    p_state->distance_mm = 0;
+    p_state->signal_rate_kcps = 0;
+
+    if (!bus_configured)
+    {
+        _bus_setup();
+    }
+
+    // Power up (or reset) the sensor
+    if (p_tof->p_xshut_port != NULL)
+    {
+        stm32f4_system_gpio_config(p_tof->p_xshut_port, p_tof->xshut_pin, STM32F4_GPIO_MODE_OUT, STM32F4_GPIO_PUPDR_NOPULL);
+        stm32f4_system_gpio_write(p_tof->p_xshut_port, p_tof->xshut_pin, LOW);
+        port_system_delay_ms(PORT_TOF_BOOT_MS);
+        stm32f4_system_gpio_write(p_tof->p_xshut_port, p_tof->xshut_pin, HIGH);
+    }
+    port_system_delay_ms(PORT_TOF_BOOT_MS);
+
+    // Open drain, active low
+    stm32f4_system_gpio_config(p_tof->p_int_port, p_tof->int_pin, STM32F4_GPIO_MODE_IN, STM32F4_GPIO_PUPDR_PULLUP);
+    stm32f4_system_gpio_config_exti(p_tof->p_int_port, p_tof->int_pin, STM32F4_TRIGGER_FALLING_EDGE | STM32F4_TRIGGER_ENABLE_INTERR_REQ);
+
+    uint8_t model_id = 0;
+    if (!_bus_read_blocking(p_tof->address, STM32F4_TOF_REG_MODEL_ID, &model_id) || (model_id != STM32F4_TOF_MODEL_ID))
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < sizeof(tof_config_arr) / sizeof(tof_config_arr[0]); i++)
+    {
+        if (!_bus_write_blocking(p_tof->address, tof_config_arr[i][0], tof_config_arr[i][1]))
+        {
+            return false;
+        }
+    }
+
+    stm32f4_system_gpio_exti_enable(p_tof->int_pin, p_tof->int_prio, 0);
+    p_state->configured = true;
+    return true;
+}
+
+bool port_tof_start_measurement(uint32_t tof_id)
+{
+    if ((tof_id >= TOF_NUM_SENSORS) || !tofs_state_arr[tof_id].configured || (tofs_state_arr[tof_id].step != TOF_STEP_IDLE))
+    {
+        return false;
+    }
+
+    // The ISRs of the bus start the reads of the other sensors: check and take the bus with them disabled
+    NVIC_DisableIRQ(I2C2_EV_IRQn);
+    NVIC_DisableIRQ(GET_PIN_IRQN(tofs_arr[tof_id].int_pin));
+    bool started = (bus.phase == TOF_BUS_IDLE);
+    if (started)
+    {
+        tofs_state_arr[tof_id].measurement_ready = false;
+        tofs_state_arr[tof_id].step = TOF_STEP_START;
+        _bus_transfer_start(tof_id, false, STM32F4_TOF_REG_SYSRANGE_START, 0x01U);
+    }
+    NVIC_EnableIRQ(GET_PIN_IRQN(tofs_arr[tof_id].int_pin));
+    NVIC_EnableIRQ(I2C2_EV_IRQn);
+    return started;
+}
+
+void port_tof_stop(uint32_t tof_id)
+{
+    if (tof_id >= TOF_NUM_SENSORS)
+    {
+        return;
+    }
+    NVIC_DisableIRQ(I2C2_EV_IRQn);
+    if ((bus.phase != TOF_BUS_IDLE) && (bus.tof_id == tof_id))
+    {
+        STM32F4_TOF_I2C->CR1 |= I2C_CR1_STOP;
+        STM32F4_TOF_I2C->CR2 &= ~(I2C_CR2_ITEVTEN | I2C_CR2_DMAEN | I2C_CR2_LAST);
+        STM32F4_TOF_TX_DMA->CR &= ~DMA_SxCR_EN;
+        STM32F4_TOF_RX_DMA->CR &= ~DMA_SxCR_EN;
+        bus.phase = TOF_BUS_IDLE;
+    }
+    tofs_state_arr[tof_id].step = TOF_STEP_IDLE;
+    tofs_state_arr[tof_id].measurement_ready = false;
+    NVIC_EnableIRQ(I2C2_EV_IRQn);
+}
+
+bool port_tof_get_busy(uint32_t tof_id)
+{
+    if (tof_id >= TOF_NUM_SENSORS)
+    {
+        return false;
+    }
+    return tofs_state_arr[tof_id].step != TOF_STEP_IDLE;
+}
+
+bool port_tof_get_measurement_ready(uint32_t tof_id)
+{
+    if (tof_id >= TOF_NUM_SENSORS)
+    {
+        return false;
+    }
+    return tofs_state_arr[tof_id].measurement_ready;
+}
+
+void port_tof_set_measurement_ready(uint32_t tof_id, bool measurement_ready)
+{
+    if (tof_id >= TOF_NUM_SENSORS)
+    {
+        return;
+    }
+    tofs_state_arr[tof_id].measurement_ready = measurement_ready;
+}
+
+uint32_t port_tof_get_distance_mm(uint32_t tof_id)
+{
+    if (tof_id >= TOF_NUM_SENSORS)
+    {
+        return 0;
+    }
+    return tofs_state_arr[tof_id].distance_mm;
+}
+
+uint32_t port_tof_get_signal_rate_kcps(uint32_t tof_id)
+{
+    if (tof_id >= TOF_NUM_SENSORS)
+    {
+        return 0;
+    }
+    return tofs_state_arr[tof_id].signal_rate_kcps;
+}
+
+bool port_tof_get_range_valid(uint32_t tof_id)
+{
+    if (tof_id >= TOF_NUM_SENSORS)
+    {
+        return false;
+    }
+    return tofs_state_arr[tof_id].range_valid;
+}
+
+void port_tof_process_sample_ready(uint32_t tof_id)
+{
+    if ((tof_id >= TOF_NUM_SENSORS) || (tofs_state_arr[tof_id].step != TOF_STEP_WAIT_SAMPLE))
+    {
+        return;
+    }
+    // If the bus is busy, the read is started at the end of the current transfer
+    tofs_state_arr[tof_id].step = TOF_STEP_READ;
+    if (bus.phase == TOF_BUS_IDLE)
+    {
+        _bus_transfer_start(tof_id, true, 0, 0);
+    }
+}
+
+void port_tof_process_bus_event(void)
+{
+    uint32_t sr1 = STM32F4_TOF_I2C->SR1;
+    uint8_t address = tofs_arr[bus.tof_id].address;
+    switch (bus.phase)
+    {
+    case TOF_BUS_START:
+        if (sr1 & I2C_SR1_SB)
+        {
+            STM32F4_TOF_I2C->DR = (uint32_t)(address << 1);
+            bus.phase = TOF_BUS_ADDRESS;
+        }
+        break;
+    case TOF_BUS_ADDRESS:
+        if (sr1 & I2C_SR1_ADDR)
+        {
+            (void)STM32F4_TOF_I2C->SR2;     // Clear ADDR: the TX stream of a write starts
+            if (bus.read)
+            {
+                STM32F4_TOF_I2C->DR = STM32F4_TOF_REG_RESULT_RANGE;
+                bus.phase = TOF_BUS_REGISTER;
+            }
+            else
+            {
+                bus.phase = TOF_BUS_DATA;
+            }
+        }
+        break;
+    case TOF_BUS_REGISTER:
+        if (sr1 & I2C_SR1_BTF)
+        {
+            STM32F4_TOF_I2C->CR1 |= I2C_CR1_START;
+            bus.phase = TOF_BUS_RESTART;
+        }
+        break;
+    case TOF_BUS_RESTART:
+        if (sr1 & I2C_SR1_SB)
+        {
+            // LAST makes the controller NACK the last byte moved by the DMA
+            DMA1->LIFCR = TOF_RX_DMA_FLAGS;
+            STM32F4_TOF_RX_DMA->CR |= DMA_SxCR_EN;
+            STM32F4_TOF_I2C->CR2 |= I2C_CR2_DMAEN | I2C_CR2_LAST;
+            STM32F4_TOF_I2C->DR = (uint32_t)(address << 1) | 1U;
+            bus.phase = TOF_BUS_READ_ADDRESS;
+        }
+        break;
+    case TOF_BUS_READ_ADDRESS:
+        if (sr1 & I2C_SR1_ADDR)
+        {
+            (void)STM32F4_TOF_I2C->SR2;     // Clear ADDR: the RX stream starts
+            bus.phase = TOF_BUS_DATA;
+        }
+        break;
+    case TOF_BUS_DATA:
+        if (!bus.read && (sr1 & I2C_SR1_BTF))
+        {
+            // Both bytes written and transmitted
+            STM32F4_TOF_I2C->CR1 |= I2C_CR1_STOP;
+            _bus_transfer_end(true);
+        }
+        else if (bus.read && (STM32F4_TOF_RX_DMA->NDTR == 0))
+        {
+            // Called from the complete transfer of the RX stream
+            STM32F4_TOF_I2C->CR1 |= I2C_CR1_STOP;
+            _bus_transfer_end(true);
+        }
+        break;
+    default:
+        // No transfer in progress: the event is not expected
+        STM32F4_TOF_I2C->CR2 &= ~I2C_CR2_ITEVTEN;
+        break;
+    }
+}
+
+void port_tof_process_bus_error(void)
+{
+    STM32F4_TOF_I2C->SR1 &= ~TOF_BUS_ERRORS;
+    if (bus.phase != TOF_BUS_IDLE)
+    {
+        STM32F4_TOF_I2C->CR1 |= I2C_CR1_STOP;
+        _bus_transfer_end(false);
+    }
+}
+
+void stm32f4_tof_process_result(uint32_t tof_id, const uint8_t *p_result)
+{
+    if (tof_id >= TOF_NUM_SENSORS)
+    {
+        return;
+    }
+    stm32f4_tof_state_t *p_state = &tofs_state_arr[tof_id];
+    uint32_t status = (p_result[0] >> 3) & 0x0FU;
+    uint32_t signal_rate_q7 = ((uint32_t)p_result[6] << 8) | p_result[7];
+    uint32_t distance_mm = ((uint32_t)p_result[10] << 8) | p_result[11];
+
+    p_state->signal_rate_kcps = (signal_rate_q7 * 1000U) >> 7;
+    p_state->distance_mm = (uint16_t)distance_mm;
+    p_state->range_valid = (status == STM32F4_TOF_RANGE_STATUS_VALID) && (distance_mm < STM32F4_TOF_RANGE_OUT);
+}
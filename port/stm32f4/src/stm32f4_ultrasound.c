@@ -13,53 +13,93 @@
 
 /* HW dependent includes */
 #include "stm32f4_system.h"
+#include "stm32f4_reg.h"
 #include "stm32f4_ultrasound.h"
 
 /* Microcontroller dependent includes */
 #include "port_ultrasound.h"
 #include "port_system.h"
 
+/* Common services used from the ISRs */
+#include "metrics.h"
+
 /* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Configuration of the HW of an ultrasound sensor (cold data).
+ * It does not change at run time, so the table of configurations is `const` and lives in flash.
+ */
 typedef struct
 {
     GPIO_TypeDef* p_echo_port;      /*!<    GPIO where the echo signal is connected   */
     GPIO_TypeDef* p_trigger_port;   /*!<    GPIO where the trigger signal is connected   */
+    GPIO_TypeDef* p_power_port;     /*!<    GPIO where the supply-enable signal is connected. NULL if the sensor is always powered   */
     uint8_t trigger_pin;            /*!<    Pin/line where the trigger signal is connected   */
     uint8_t echo_alt_fun;           /*!<    Alternate function for the echo signal   */
     uint8_t echo_pin;               /*!<    Pin/line where the echo signal is connected   */
-    bool echo_received;             /*!<    Flag to indicate that the echo signal has been received     false at the begining   */
-    bool trigger_end;               /*!<    Flag to indicate that the trigger signal has been sent     false at the begining   */
-    bool trigger_ready;             /*!<    Flag to indicate that a new measurement can be started     true at the begining   */
-    uint32_t echo_end_tick;         /*!<    Tick time when the echo signal was received      0 at the begining  */
+    uint8_t power_pin;              /*!<    Pin/line where the supply-enable signal is connected   */
+    uint8_t echo_channel;           /*!<    Input capture channel (1 to 4) of the echo timer   */
+    TIM_TypeDef* p_echo_tim;        /*!<    Timer that captures the echo signal   */
+    TIM_TypeDef* p_trigger_tim;     /*!<    Timer of the duration of the trigger signal   */
+    void (*p_timers_init)(void);    /*!<    Enable the clocks of both timers, configure the capture channel of the echo and the priorities of the interrupts. Generated for the timers and channel of the sensor   */
+    void (*p_timers_start)(void);   /*!<    Start both timers from 0 with their interrupts enabled. Generated for the timers of the sensor   */
+}stm32f4_ultrasound_cfg_t;
+
+/**
+ * @brief State of an ultrasound sensor updated by the ISRs and the FSM (hot data).
+ * The elements are 16 bytes, so the state of a sensor is found with a shift and the state of all the sensors is contiguous.
+ * The flags of all the sensors are kept apart, one bit per sensor, so they are checked at once.
+ */
+typedef struct
+{
     uint32_t echo_init_tick;        /*!<    Tick time when the echo signal was received     0 at the begining   */
+    uint32_t echo_end_tick;         /*!<    Tick time when the echo signal was received      0 at the begining  */
     uint32_t echo_overflows;        /*!<    Number of overflows of the timer during the echo signal     0 at the begining   */
-}stm32f4_ultrasound_hw_t;
+    uint32_t power_on_ms;           /*!<    System time in ms when the sensor was powered up   */
+}stm32f4_ultrasound_state_t;
 
 /* Global variables */
 /**
  * @brief Array of elements that represents the HW characteristics of the ultrasounds connected to the STM32F4 platform.
  * This must be hidden from the user, so it is declared as static.
- * To access the elements of this array, use the function _stm32f4_ultrasound_get().
+ * To access the elements of this array, use the function _stm32f4_ultrasound_get_cfg().
+ * The elements are generated from the description of the board (`STM32F4_BOARD_ULTRASOUNDS`), so adding a sensor does not change this file.
  */
-static stm32f4_ultrasound_hw_t ultrasounds_arr[] = {
-    [PORT_REAR_PARKING_SENSOR_ID] = {.p_echo_port = STM32F4_REAR_PARKING_SENSOR_ECHO_GPIO, .p_trigger_port = STM32F4_REAR_PARKING_SENSOR_TRIGGER_GPIO, .trigger_pin = STM32F4_REAR_PARKING_SENSOR_TRIGGER_PIN,  .echo_pin = STM32F4_REAR_PARKING_SENSOR_ECHO_PIN},
+static const stm32f4_ultrasound_cfg_t ultrasounds_cfg_arr[] = {
+    STM32F4_BOARD_ULTRASOUNDS
 };
 
+#define STM32F4_ULTRASOUND_NUM_SENSORS (sizeof(ultrasounds_cfg_arr) / sizeof(ultrasounds_cfg_arr[0]))  /*!<    Number of ultrasound sensors of the platform   */
+_Static_assert(STM32F4_ULTRASOUND_NUM_SENSORS <= 32, "The flags of the sensors are bits of a 32-bit word");
+
+/**
+ * @brief Copy in RAM of the configuration of each sensor whose GPIOs have been changed at run time (tests). NULL if the sensor uses the table in flash.
+ */
+static const stm32f4_ultrasound_cfg_t *ultrasounds_p_cfg_arr[STM32F4_ULTRASOUND_NUM_SENSORS];
+
+static stm32f4_ultrasound_cfg_t ultrasounds_cfg_ram_arr[STM32F4_ULTRASOUND_NUM_SENSORS];    /*!<    Copies of the configuration of the sensors whose GPIOs have been changed at run time */
+static stm32f4_ultrasound_state_t ultrasounds_state_arr[STM32F4_ULTRASOUND_NUM_SENSORS];    /*!<    Hot state of the sensors */
+
+static volatile uint32_t echo_received_mask;    /*!<    Bit i: the echo of sensor i has been received     false at the begining   */
+static volatile uint32_t trigger_end_mask;      /*!<    Bit i: the trigger signal of sensor i has been sent     false at the begining   */
+static volatile uint32_t trigger_ready_mask;    /*!<    Bit i: a new measurement of sensor i can be started     true at the begining   */
+static volatile uint32_t powered_mask;          /*!<    Bit i: the supply of sensor i is enabled   */
+
 
 /* Private functions ----------------------------------------------------------*/
 
 /**
- * @brief Get the ultrasound struct with the given ID.
+ * @brief Get the configuration of the ultrasound with the given ID.
  * 
- * @param ultrasound_id                 Ultrasound ID. This index is used to select the element of the ultrasound_arr[] array.
- * @return stm32f4_ultrasound_hw_t*     Pointer to the ultrasound struct. NULL If the ultrasound ID is not valid.
+ * @param ultrasound_id                     Ultrasound ID. This index is used to select the element of the ultrasounds_p_cfg_arr[] array.
+ * @return const stm32f4_ultrasound_cfg_t*  Pointer to the configuration. NULL If the ultrasound ID is not valid.
  */
-stm32f4_ultrasound_hw_t* _stm32f4_ultrasound_get (uint32_t ultrasound_id)
+static const stm32f4_ultrasound_cfg_t* _stm32f4_ultrasound_get_cfg (uint32_t ultrasound_id)
 {
-    // Return the pointer to the button with the given ID. If the ID is not valid, return NULL.
-    if (ultrasound_id < sizeof(ultrasounds_arr) / sizeof(ultrasounds_arr[0]))
+    // Return the pointer to the configuration with the given ID. If the ID is not valid, return NULL.
+    if (ultrasound_id < STM32F4_ULTRASOUND_NUM_SENSORS)
     {
-        return &ultrasounds_arr[ultrasound_id];
+        const stm32f4_ultrasound_cfg_t *p_cfg_ram = ultrasounds_p_cfg_arr[ultrasound_id];
+        return (p_cfg_ram != NULL) ? p_cfg_ram : &ultrasounds_cfg_arr[ultrasound_id];
     }
     else
     {
@@ -68,22 +108,94 @@ stm32f4_ultrasound_hw_t* _stm32f4_ultrasound_get (uint32_t ultrasound_id)
 }
 
 /**
- * @brief Configure the timer that controls the duration of the trigger signal.
+ * @brief Get the state of the ultrasound with the given ID.
  * 
+ * @param ultrasound_id                 Ultrasound ID. This index is used to select the element of the ultrasounds_state_arr[] array.
+ * @return stm32f4_ultrasound_state_t*  Pointer to the state. NULL If the ultrasound ID is not valid.
  */
-static void _timer_trigger_setup(void)
+static stm32f4_ultrasound_state_t* _stm32f4_ultrasound_get_state (uint32_t ultrasound_id)
 {
-    // Enable the clock of the timer that controls the trigger signal.
-    RCC->APB1ENR |= RCC_APB1ENR_TIM3EN;  
+    if (ultrasound_id < STM32F4_ULTRASOUND_NUM_SENSORS)
+    {
+        return &ultrasounds_state_arr[ultrasound_id];
+    }
+    else
+    {
+        return NULL;
+    }
+}
+
+/**
+ * @brief Get a writable copy of the configuration of an ultrasound, to change its GPIOs at run time.
+ * The first time, the configuration in flash is copied into RAM and the sensor uses the copy from then on.
+ * 
+ * @param ultrasound_id                 Ultrasound ID.
+ * @return stm32f4_ultrasound_cfg_t*    Pointer to the copy of the configuration in RAM. NULL If the ultrasound ID is not valid.
+ */
+static stm32f4_ultrasound_cfg_t* _stm32f4_ultrasound_get_cfg_ram (uint32_t ultrasound_id)
+{
+    if (ultrasound_id >= STM32F4_ULTRASOUND_NUM_SENSORS)
+    {
+        return NULL;
+    }
+    stm32f4_ultrasound_cfg_t *p_cfg_ram = &ultrasounds_cfg_ram_arr[ultrasound_id];
+    if (ultrasounds_p_cfg_arr[ultrasound_id] != p_cfg_ram)
+    {
+        *p_cfg_ram = ultrasounds_cfg_arr[ultrasound_id];
+        ultrasounds_p_cfg_arr[ultrasound_id] = p_cfg_ram;
+    }
+    return p_cfg_ram;
+}
+
+/**
+ * @brief Read the flag of a sensor.
+ * 
+ * @param mask          Word of flags of all the sensors.
+ * @param ultrasound_id Ultrasound ID.
+ * @return true         If the flag of the sensor is set.
+ * @return false        If the flag of the sensor is clear.
+ */
+static inline bool _flag_get(uint32_t mask, uint32_t ultrasound_id)
+{
+    return (mask >> ultrasound_id) & 1U;
+}
 
-    // Disable the counter of the timer.
-    TIM3->CR1 &= ~TIM_CR1_CEN;
+/**
+ * @brief Write the flag of a sensor.
+ * The word is shared by the ISRs and the main loop, so the read-modify-write is atomic (LDREX/STREX).
+ * 
+ * @param p_mask        Pointer to the word of flags of all the sensors.
+ * @param ultrasound_id Ultrasound ID.
+ * @param value         New value of the flag.
+ */
+static inline void _flag_set(volatile uint32_t *p_mask, uint32_t ultrasound_id, bool value)
+{
+    uint32_t bit = 1UL << ultrasound_id;
+    if (value)
+    {
+        __atomic_fetch_or(p_mask, bit, __ATOMIC_RELAXED);
+    }
+    else
+    {
+        __atomic_fetch_and(p_mask, ~bit, __ATOMIC_RELAXED);
+    }
+}
 
-    // Enable the autoreload preload
-    TIM3->CR1 |= TIM_CR1_ARPE;
+/**
+ * @brief Configure the timer that controls the duration of the trigger signal.
+ * The clock of the timer and the priority of its interrupt are set by the init function of the board (`p_timers_init`).
+ * 
+ * @param TIMx  Timer of the trigger signal of the sensor.
+ */
+static void _timer_trigger_setup(TIM_TypeDef *TIMx)
+{
+    // Disable the counter of the timer and enable the autoreload preload
+    STM32F4_REG_MODIFY(TIMx->CR1,
+                       STM32F4_REG_FIELD(TIM_CR1_CEN, 0),
+                       STM32F4_REG_FIELD(TIM_CR1_ARPE, TIM_CR1_ARPE));
 
     // Set the counter of the timer to 0
-    TIM3-> CNT = 0;
+    TIMx->CNT = 0;
 
     // Compute the prescaler and the auto-reload register to set the duration of the trigger signal.
     double sysclk_as_double = (double)SystemCoreClock; 
@@ -99,122 +211,96 @@ static void _timer_trigger_setup(void)
     }
  
     // Load the values computed for ARR and PSC into the corresponding registers of the timer.
-    TIM3->PSC = (uint32_t)psc_temp;
-    TIM3->ARR = (uint32_t)arr_temp;
+    TIMx->PSC = (uint32_t)psc_temp;
+    TIMx->ARR = (uint32_t)arr_temp;
  
-    TIM3->EGR |= TIM_EGR_UG;
+    TIMx->EGR |= TIM_EGR_UG;
  
     // Clear the update interrupt flag.
-    TIM3->SR &= ~TIM_SR_UIF;
+    TIMx->SR &= ~TIM_SR_UIF;
  
     // Enable the interrupts of the timer by setting the UIE bit of the DIER register.
-    TIM3->DIER |= TIM_DIER_UIE;
- 
-    // Set the priority of the timer interrupt in the NVIC.
-    NVIC_SetPriority(TIM3_IRQn, 4);
- 
+    TIMx->DIER |= TIM_DIER_UIE;
 }
 
 /**
  * @brief Configure the timer that controls the duration of the new measurement.
+ * The timer is shared by all the sensors and it is selected in the description of the board.
  * 
  */
 void _timer_new_measurement_setup(void)
 {
     // Enable the clock of the timer that controls the trigger signal.
-    RCC->APB1ENR |= RCC_APB1ENR_TIM5EN;  
+    RCC->APB1ENR |= STM32F4_ULTRASOUND_MEASUREMENT_RCC_EN;
 
-    // Disable the counter of the timer.
-    TIM5->CR1 &= ~TIM_CR1_CEN;
-
-    // Enable the autoreload preload
-    TIM5->CR1 |= TIM_CR1_ARPE;
+    // Disable the counter of the timer and enable the autoreload preload
+    STM32F4_REG_MODIFY(STM32F4_ULTRASOUND_MEASUREMENT_TIM->CR1,
+                       STM32F4_REG_FIELD(TIM_CR1_CEN, 0),
+                       STM32F4_REG_FIELD(TIM_CR1_ARPE, TIM_CR1_ARPE));
 
     // Set the counter of the timer to 0
-    TIM5->CNT = 0;
+    STM32F4_ULTRASOUND_MEASUREMENT_TIM->CNT = 0;
 
-    // Compute the prescaler and the auto-reload register to set the duration of the trigger signal.
-    double sysclk_as_double = (double)SystemCoreClock; 
-    double timeout_ms_d = (double)PORT_PARKING_SENSOR_TIMEOUT_MS;
- 
-    double psc_temp = round((sysclk_as_double / (1000.0 * 65535.0)) - 1.0);
- 
-    double arr_temp = round(timeout_ms_d * (sysclk_as_double / 1000.0) / (psc_temp + 1.0));
- 
-    if (arr_temp > 65535.0) {
-        psc_temp += 1.0;
-        arr_temp = round(timeout_ms_d * (sysclk_as_double / 1000.0) / (psc_temp + 1.0));
-    }
-    // Load the values computed for ARR and PSC into the corresponding registers of the timer.
-    TIM5->PSC = (uint32_t)psc_temp;
-    TIM5->ARR = (uint32_t)arr_temp;
+    // Set the duration of the measurement period and load it.
+    port_ultrasound_set_measurement_period_ms(PORT_PARKING_SENSOR_TIMEOUT_MS);
  
-    TIM5->EGR |= TIM_EGR_UG;
+    STM32F4_ULTRASOUND_MEASUREMENT_TIM->EGR |= TIM_EGR_UG;
  
     // Clear the update interrupt flag.
-    TIM5->SR &= ~TIM_SR_UIF;
+    STM32F4_ULTRASOUND_MEASUREMENT_TIM->SR &= ~TIM_SR_UIF;
  
     // Enable the interrupts of the timer by setting the UIE bit of the DIER register.
-    TIM5->DIER |= TIM_DIER_UIE;
+    STM32F4_ULTRASOUND_MEASUREMENT_TIM->DIER |= TIM_DIER_UIE;
  
     // Set the priority of the timer interrupt in the NVIC.
-    NVIC_SetPriority(TIM5_IRQn, 5);
+    NVIC_SetPriority(STM32F4_ULTRASOUND_MEASUREMENT_IRQN, STM32F4_ULTRASOUND_MEASUREMENT_IRQ_PRIO);
 }
 
 /**
- * @brief Configure the timer that controls the duration of the echo signal.
+ * @brief Configure the time base of the timer that controls the duration of the echo signal: 1 tick per microsecond.
+ * The clock of the timer, its capture channel and the priority of its interrupt are set by the init function of the board (`p_timers_init`).
  * 
- * @param ultrasound_id     Ultrasound ID. This ID is used to configure the timer that controls the echo signal of the ultrasound sensor.
+ * @param TIMx  Timer of the echo signal of the sensor.
  */
-static void _timer_echo_setup(uint32_t ultrasound_id)
+static void _timer_echo_setup(TIM_TypeDef *TIMx)
 {   
-    
-    TIM_TypeDef *TIMx;          // Timer of the ultrasound
-    uint32_t TIMx_IRQn;     // Timer IRQn of the ultrasound
-
-    // Select the timer based on the ID
-    switch (ultrasound_id) {
-        case PORT_REAR_PARKING_SENSOR_ID:
-            TIMx = TIM2;  
-            TIMx_IRQn = TIM2_IRQn;
-
-            break;
-        default:
-            return;  
-    }
-    
-    // Enable the clock of the timer that controls the trigger signal.
-    RCC->APB1ENR |= RCC_APB1ENR_TIM2EN;
-    TIMx->CR1 &= ~TIM_CR1_CEN;
+    // Disable the counter and set the auto-reload preload bit (ARPE) in the control register (CR1) to enable the auto-reload register.
+    STM32F4_REG_MODIFY(TIMx->CR1,
+                       STM32F4_REG_FIELD(TIM_CR1_CEN, 0),
+                       STM32F4_REG_FIELD(TIM_CR1_ARPE, TIM_CR1_ARPE));
 
     // Set the values of the prescaler and the auto-reload registers.
     TIMx->PSC = (SystemCoreClock / 1000000) - 1;  // Convert to 1MHz
     TIMx->ARR = 65535;                            // MAX value
     
-    // Set the auto-reload preload bit (ARPE) in the control register (CR1) to enable the auto-reload register. 
-    TIMx->CR1 |= TIM_CR1_ARPE;  
     TIMx->EGR |= TIM_EGR_UG;  
 
-    // Set the direction as input in the Capture/Compare mode register (CCMRx) for CH2.
-    if (ultrasound_id == PORT_REAR_PARKING_SENSOR_ID) {
-        TIM2->CCMR1 &= ~TIM_CCMR1_CC2S;  
-        TIM2->CCMR1 |= TIM_CCMR1_CC2S_0; 
-    }
+    // Clear the update interrupt flag set by UG, or the first echo would count an overflow.
+    TIMx->SR &= ~TIM_SR_UIF;
 
-    TIMx->CCMR1 &= ~TIM_CCMR1_IC2F;     // Disable digital filtering by clearing the ICxF bits in the Capture/Compare mode register (CCMRx).
+    TIMx->DIER |= TIM_DIER_UIE;     // Enable the update interrupt bit (UIE) in the DMA/interrupt enable register (DIER).
+}
 
-    // Select the edge of the active transition in the Capture/Compare enable register (CCER) for CH2.
-    TIMx->CCER |= TIM_CCER_CC2P;  
-    TIMx->CCER |= TIM_CCER_CC2NP;
 
-    TIMx->CCMR1 &= ~TIM_CCMR1_IC2PSC;   // Program the input prescaler to capture each valid transition.
+/**
+ * @brief Configure the supply-enable pin of the ultrasound sensor and power it down.
+ * 
+ * @param ultrasound_id Ultrasound ID.
+ */
+static void _power_setup(uint32_t ultrasound_id)
+{
+    const stm32f4_ultrasound_cfg_t *p_cfg = _stm32f4_ultrasound_get_cfg(ultrasound_id);
+
+    _flag_set(&powered_mask, ultrasound_id, false);
+    _stm32f4_ultrasound_get_state(ultrasound_id)->power_on_ms = 0;
 
-    TIMx->CCER |= TIM_CCER_CC2E;    // Enable the Capture/compare enable register (CCER) for the corresponding channel.
-    TIMx->DIER |= TIM_DIER_CC2IE;   // Enable the Capture/Compare interrupts bit (CCxIE) for the corresponding channel in the DMA/interrupt enable register (DIER).
-    TIMx->DIER |= TIM_DIER_UIE;     // Enable the update interrupt bit (UIE) in the DMA/interrupt enable register (DIER).
+    if (p_cfg->p_power_port == NULL)
+    {
+        return;
+    }
 
-    // Set the priority of the timer interrupt in the NVIC.
-    NVIC_SetPriority(TIMx_IRQn, 3);
+    stm32f4_system_gpio_config(p_cfg->p_power_port, p_cfg->power_pin, STM32F4_GPIO_MODE_OUT, STM32F4_GPIO_PUPDR_NOPULL);
+    stm32f4_system_gpio_write(p_cfg->p_power_port, p_cfg->power_pin, LOW);
 }
 
 
@@ -222,99 +308,112 @@ static void _timer_echo_setup(uint32_t ultrasound_id)
 void port_ultrasound_init(uint32_t ultrasound_id)
 {
     /* Get the ultrasound sensor */
-    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
+    const stm32f4_ultrasound_cfg_t *p_cfg = _stm32f4_ultrasound_get_cfg(ultrasound_id);
 
     /* TO-DO alumnos: */
 
     /* Trigger pin configuration */
-    p_ultrasound -> trigger_ready = true;
-    p_ultrasound -> trigger_end = false;
+    _flag_set(&trigger_ready_mask, ultrasound_id, true);
+    _flag_set(&trigger_end_mask, ultrasound_id, false);
 
     /* Echo pin configuration */
-    p_ultrasound -> echo_received = false;
-
-    p_ultrasound -> echo_end_tick = 0;
-    p_ultrasound -> echo_init_tick = 0;
-    p_ultrasound -> echo_overflows = 0;
+    port_ultrasound_reset_echo_ticks(ultrasound_id);
 
     /* Configure timers */
-    stm32f4_system_gpio_config(p_ultrasound-> p_trigger_port, p_ultrasound->trigger_pin, STM32F4_GPIO_MODE_OUT, STM32F4_GPIO_PUPDR_NOPULL);
+    stm32f4_system_gpio_config(p_cfg->p_trigger_port, p_cfg->trigger_pin, STM32F4_GPIO_MODE_OUT, STM32F4_GPIO_PUPDR_NOPULL);
 
-    stm32f4_system_gpio_config(p_ultrasound->p_echo_port, p_ultrasound->echo_pin, STM32F4_GPIO_MODE_AF, STM32F4_GPIO_PUPDR_NOPULL);
-    stm32f4_system_gpio_config_alternate(p_ultrasound->p_echo_port, p_ultrasound->echo_pin, STM32F4_AF1);
+    stm32f4_system_gpio_config(p_cfg->p_echo_port, p_cfg->echo_pin, STM32F4_GPIO_MODE_AF, STM32F4_GPIO_PUPDR_NOPULL);
+    stm32f4_system_gpio_config_alternate(p_cfg->p_echo_port, p_cfg->echo_pin, p_cfg->echo_alt_fun);
 
-    _timer_trigger_setup();
-    _timer_echo_setup(ultrasound_id);
+    _power_setup(ultrasound_id);
+
+    p_cfg->p_timers_init();
+    _timer_trigger_setup(p_cfg->p_trigger_tim);
+    _timer_echo_setup(p_cfg->p_echo_tim);
     _timer_new_measurement_setup();
 }
 
 
 void port_ultrasound_stop_trigger_timer(uint32_t ultrasound_id)
 {
-    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
+    const stm32f4_ultrasound_cfg_t *p_cfg = _stm32f4_ultrasound_get_cfg(ultrasound_id);
 
-    stm32f4_system_gpio_write(p_ultrasound -> p_trigger_port, p_ultrasound -> trigger_pin, 0);
+    stm32f4_system_gpio_write(p_cfg -> p_trigger_port, p_cfg -> trigger_pin, 0);
 
-    TIM3 -> CR1 &= ~TIM_CR1_CEN; 
+    p_cfg -> p_trigger_tim -> CR1 &= ~TIM_CR1_CEN;
 }
 
 void port_ultrasound_stop_echo_timer(uint32_t ultrasound_id)
 {
-    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
+    const stm32f4_ultrasound_cfg_t *p_cfg = _stm32f4_ultrasound_get_cfg(ultrasound_id);
 
-    stm32f4_system_gpio_write(p_ultrasound -> p_echo_port, p_ultrasound -> echo_pin, 0);
+    stm32f4_system_gpio_write(p_cfg -> p_echo_port, p_cfg -> echo_pin, 0);
 
-    TIM2 -> CR1 &= ~TIM_CR1_CEN;
+    p_cfg -> p_echo_tim -> CR1 &= ~TIM_CR1_CEN;
 }
 
 void port_ultrasound_reset_echo_ticks(uint32_t ultrasound_id)
 {
-    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
+    stm32f4_ultrasound_state_t *p_state = _stm32f4_ultrasound_get_state(ultrasound_id);
 
-    p_ultrasound -> echo_received = false;
+    _flag_set(&echo_received_mask, ultrasound_id, false);
 
-    p_ultrasound -> echo_end_tick = 0;
-    p_ultrasound -> echo_init_tick = 0;
-    p_ultrasound -> echo_overflows = 0;
+    p_state -> echo_end_tick = 0;
+    p_state -> echo_init_tick = 0;
+    p_state -> echo_overflows = 0;
 }
 
 
 void port_ultrasound_start_measurement(uint32_t ultrasound_id)
 {
-    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
+    const stm32f4_ultrasound_cfg_t *p_cfg = _stm32f4_ultrasound_get_cfg(ultrasound_id);
 
-    p_ultrasound -> trigger_ready = false;
-    TIM5 -> CNT = 0;
+    _flag_set(&trigger_ready_mask, ultrasound_id, false);
+    STM32F4_ULTRASOUND_MEASUREMENT_TIM -> CNT = 0;
 
-    if(ultrasound_id == PORT_REAR_PARKING_SENSOR_ID)
-    {
-        TIM2 -> CNT = 0;
-        TIM3 -> CNT = 0;
-    }
-
-    stm32f4_system_gpio_write(p_ultrasound -> p_trigger_port, p_ultrasound -> trigger_pin, HIGH);
-    NVIC_EnableIRQ(TIM5_IRQn);
-    TIM5 -> CR1 |= TIM_CR1_CEN;
+    stm32f4_system_gpio_write(p_cfg -> p_trigger_port, p_cfg -> trigger_pin, HIGH);
+    NVIC_EnableIRQ(STM32F4_ULTRASOUND_MEASUREMENT_IRQN);
+    STM32F4_ULTRASOUND_MEASUREMENT_TIM -> CR1 |= TIM_CR1_CEN;
 
-    if(ultrasound_id == PORT_REAR_PARKING_SENSOR_ID)
-    {
-        NVIC_EnableIRQ(TIM2_IRQn);
-        NVIC_EnableIRQ(TIM3_IRQn);
-
-        TIM2 -> CR1 |= TIM_CR1_CEN;
-        TIM3 -> CR1 |= TIM_CR1_CEN;
-    }
+    // Trigger and echo timers of the sensor, from 0
+    p_cfg -> p_timers_start();
 }
 
 void port_ultrasound_start_new_measurement_timer(void)
 {
-    NVIC_EnableIRQ(TIM5_IRQn);
-    TIM5 -> CR1 |= TIM_CR1_CEN;
+    NVIC_EnableIRQ(STM32F4_ULTRASOUND_MEASUREMENT_IRQN);
+    STM32F4_ULTRASOUND_MEASUREMENT_TIM -> CR1 |= TIM_CR1_CEN;
 }
 
 void port_ultrasound_stop_new_measurement_timer(void)
 {   
-    TIM5 -> CR1 &= ~TIM_CR1_CEN;
+    STM32F4_ULTRASOUND_MEASUREMENT_TIM -> CR1 &= ~TIM_CR1_CEN;
+}
+
+void port_ultrasound_set_measurement_period_ms(uint32_t period_ms)
+{
+    // Compute the prescaler and the auto-reload register to set the duration of the measurement period.
+    double sysclk_as_double = (double)SystemCoreClock; 
+    double timeout_ms_d = (double)period_ms;
+ 
+    double psc_temp = round((sysclk_as_double / (1000.0 * 65535.0)) - 1.0);
+ 
+    double arr_temp = round(timeout_ms_d * (sysclk_as_double / 1000.0) / (psc_temp + 1.0));
+ 
+    if (arr_temp > 65535.0) {
+        psc_temp += 1.0;
+        arr_temp = round(timeout_ms_d * (sysclk_as_double / 1000.0) / (psc_temp + 1.0));
+    }
+    // Load the values computed for ARR and PSC into the corresponding registers of the timer.
+    STM32F4_ULTRASOUND_MEASUREMENT_TIM->PSC = (uint32_t)psc_temp;
+    STM32F4_ULTRASOUND_MEASUREMENT_TIM->ARR = (uint32_t)arr_temp;
+
+    // Both are preloaded: an update event applies them and restarts the counter, or a running timer would still wait out
+    // the old period (e.g. the 500 ms of the warm standby). With URS the software update does not set UIF, so it does not
+    // request a measurement.
+    STM32F4_ULTRASOUND_MEASUREMENT_TIM->CR1 |= TIM_CR1_URS;
+    STM32F4_ULTRASOUND_MEASUREMENT_TIM->EGR = TIM_EGR_UG;
+    STM32F4_ULTRASOUND_MEASUREMENT_TIM->CR1 &= ~TIM_CR1_URS;
 }
 
 void port_ultrasound_stop_ultrasound(uint32_t ultrasound_id)
@@ -324,91 +423,224 @@ void port_ultrasound_stop_ultrasound(uint32_t ultrasound_id)
     port_ultrasound_stop_new_measurement_timer();
 
     port_ultrasound_reset_echo_ticks(ultrasound_id);
+    port_ultrasound_power_off(ultrasound_id);
 }	
 
+void port_ultrasound_power_on(uint32_t ultrasound_id)
+{
+    const stm32f4_ultrasound_cfg_t *p_cfg = _stm32f4_ultrasound_get_cfg(ultrasound_id);
+
+    if ((p_cfg->p_power_port == NULL) || _flag_get(powered_mask, ultrasound_id))
+    {
+        return;
+    }
+
+    stm32f4_system_gpio_write(p_cfg->p_power_port, p_cfg->power_pin, HIGH);
+    _stm32f4_ultrasound_get_state(ultrasound_id)->power_on_ms = port_system_get_millis();
+    _flag_set(&powered_mask, ultrasound_id, true);
+}
+
+void port_ultrasound_power_off(uint32_t ultrasound_id)
+{
+    const stm32f4_ultrasound_cfg_t *p_cfg = _stm32f4_ultrasound_get_cfg(ultrasound_id);
+
+    if (p_cfg->p_power_port == NULL)
+    {
+        return;
+    }
+
+    // The trigger pin is already low, so no current is injected into the unpowered sensor.
+    stm32f4_system_gpio_write(p_cfg->p_power_port, p_cfg->power_pin, LOW);
+    _flag_set(&powered_mask, ultrasound_id, false);
+}
+
+uint32_t port_ultrasound_get_settle_remaining_ms(uint32_t ultrasound_id)
+{
+    const stm32f4_ultrasound_cfg_t *p_cfg = _stm32f4_ultrasound_get_cfg(ultrasound_id);
+
+    if (p_cfg->p_power_port == NULL)
+    {
+        return 0;
+    }
+    if (!_flag_get(powered_mask, ultrasound_id))
+    {
+        return PORT_PARKING_SENSOR_POWER_SETTLE_MS;
+    }
+
+    uint32_t elapsed_ms = port_system_get_millis() - _stm32f4_ultrasound_get_state(ultrasound_id)->power_on_ms;
+    return (elapsed_ms >= PORT_PARKING_SENSOR_POWER_SETTLE_MS) ? 0 : (PORT_PARKING_SENSOR_POWER_SETTLE_MS - elapsed_ms);
+}
+
 
 // Getters and setters functions
 bool port_ultrasound_get_trigger_ready(uint32_t ultrasound_id) {
-    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
-    return p_ultrasound -> trigger_ready;
+    return _flag_get(trigger_ready_mask, ultrasound_id);
 }
 
 void port_ultrasound_set_trigger_ready(uint32_t ultrasound_id, bool trigger_ready) {
-    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
-    p_ultrasound -> trigger_ready = trigger_ready;
+    _flag_set(&trigger_ready_mask, ultrasound_id, trigger_ready);
 }
 
 bool port_ultrasound_get_trigger_end(uint32_t ultrasound_id) {
-    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
-    return p_ultrasound -> trigger_end;
+    return _flag_get(trigger_end_mask, ultrasound_id);
 }
 
 void port_ultrasound_set_trigger_end(uint32_t ultrasound_id, bool trigger_end) {
-    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
-    p_ultrasound -> trigger_end = trigger_end;
+    _flag_set(&trigger_end_mask, ultrasound_id, trigger_end);
 }
 
 
 uint32_t port_ultrasound_get_echo_end_tick(uint32_t ultrasound_id)
 {
-    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
-    return p_ultrasound -> echo_end_tick;
+    stm32f4_ultrasound_state_t *p_state = _stm32f4_ultrasound_get_state(ultrasound_id);
+    return p_state -> echo_end_tick;
 }
 
 void port_ultrasound_set_echo_end_tick(uint32_t ultrasound_id, uint32_t echo_end_tick)
 {
-    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
-    p_ultrasound -> echo_end_tick = echo_end_tick;
+    stm32f4_ultrasound_state_t *p_state = _stm32f4_ultrasound_get_state(ultrasound_id);
+    p_state -> echo_end_tick = echo_end_tick;
 }	
 
 uint32_t port_ultrasound_get_echo_init_tick	(uint32_t ultrasound_id)
 {
-    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
-    return p_ultrasound -> echo_init_tick;
+    stm32f4_ultrasound_state_t *p_state = _stm32f4_ultrasound_get_state(ultrasound_id);
+    return p_state -> echo_init_tick;
 }
 
 void port_ultrasound_set_echo_init_tick(uint32_t ultrasound_id, uint32_t echo_init_tick)	
 {
-    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
-     p_ultrasound -> echo_init_tick = echo_init_tick;
+    stm32f4_ultrasound_state_t *p_state = _stm32f4_ultrasound_get_state(ultrasound_id);
+    p_state -> echo_init_tick = echo_init_tick;
 }
 
 uint32_t port_ultrasound_get_echo_overflows	(uint32_t ultrasound_id)
 {
-    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
-    return p_ultrasound -> echo_overflows;
+    stm32f4_ultrasound_state_t *p_state = _stm32f4_ultrasound_get_state(ultrasound_id);
+    return p_state -> echo_overflows;
 }
 
 void port_ultrasound_set_echo_overflows(uint32_t ultrasound_id, uint32_t echo_overflows)	
 {
-    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
-    p_ultrasound -> echo_overflows = echo_overflows;
+    stm32f4_ultrasound_state_t *p_state = _stm32f4_ultrasound_get_state(ultrasound_id);
+    p_state -> echo_overflows = echo_overflows;
 }
 
 bool port_ultrasound_get_echo_received(uint32_t ultrasound_id)
 {
-    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
-    return p_ultrasound -> echo_received;
+    return _flag_get(echo_received_mask, ultrasound_id);
 }
 
 void port_ultrasound_set_echo_received(uint32_t ultrasound_id, bool echo_received)	
 {
-    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
-    p_ultrasound -> echo_received = echo_received;
+    _flag_set(&echo_received_mask, ultrasound_id, echo_received);
+}
+
+uint32_t port_ultrasound_get_echo_received_mask(void)
+{
+    return echo_received_mask;
+}
+
+
+// ISRs
+PORT_RAMFUNC void stm32f4_ultrasound_echo_timer_isr(TIM_TypeDef *TIMx)
+{
+    uint32_t sr = TIMx->SR;
+
+    for (uint32_t id = 0; id < STM32F4_ULTRASOUND_NUM_SENSORS; id++)
+    {
+        const stm32f4_ultrasound_cfg_t *p_cfg = _stm32f4_ultrasound_get_cfg(id);
+        if (p_cfg->p_echo_tim != TIMx)
+        {
+            continue;
+        }
+        stm32f4_ultrasound_state_t *p_state = &ultrasounds_state_arr[id];
+        uint32_t ch = p_cfg->echo_channel - 1U;
+
+        if (sr & TIM_SR_UIF)
+        {
+            p_state->echo_overflows++;
+        }
+        if (sr & (TIM_SR_CC1OF << ch))
+        {
+            // A new edge was captured before the previous one was read: one edge of the echo has been lost
+            metrics_counter_inc(METRIC_ULTRASOUND_OVERCAPTURES);
+
+            TIMx->SR &= ~(TIM_SR_CC1OF << ch);
+        }
+        if (sr & (TIM_SR_CC1IF << ch))
+        {
+            // Reading the capture register clears its flag
+            uint32_t ccr_value = (&TIMx->CCR1)[ch];
+
+            if ((p_state->echo_init_tick == 0) && (p_state->echo_end_tick == 0))
+            {
+                p_state->echo_init_tick = ccr_value;
+            }
+            else
+            {
+                p_state->echo_end_tick = ccr_value;
+                _flag_set(&echo_received_mask, id, true);
+            }
+        }
+    }
+
+    if (sr & TIM_SR_UIF)
+    {
+        TIMx->SR &= ~TIM_SR_UIF;
+    }
+}
+
+void stm32f4_ultrasound_trigger_timer_isr(TIM_TypeDef *TIMx)
+{
+    TIMx->SR &= ~TIM_SR_UIF;
+
+    for (uint32_t id = 0; id < STM32F4_ULTRASOUND_NUM_SENSORS; id++)
+    {
+        if (_stm32f4_ultrasound_get_cfg(id)->p_trigger_tim == TIMx)
+        {
+            _flag_set(&trigger_end_mask, id, true);
+        }
+    }
+}
+
+void stm32f4_ultrasound_measurement_timer_isr(void)
+{
+    STM32F4_ULTRASOUND_MEASUREMENT_TIM->SR &= ~TIM_SR_UIF;
+
+    for (uint32_t id = 0; id < STM32F4_ULTRASOUND_NUM_SENSORS; id++)
+    {
+        // If the echo timer of a sensor is still running, its echo has not been received during the whole period
+        if ((_stm32f4_ultrasound_get_cfg(id)->p_echo_tim->CR1 & TIM_CR1_CEN) && !_flag_get(echo_received_mask, id))
+        {
+            metrics_counter_inc(METRIC_ULTRASOUND_NO_ECHO);
+        }
+    }
+
+    // The period is shared: a new measurement of every sensor can be started
+    __atomic_fetch_or(&trigger_ready_mask, (uint32_t)((1ULL << STM32F4_ULTRASOUND_NUM_SENSORS) - 1U), __ATOMIC_RELAXED);
 }
 
 
 // Util
 void stm32f4_ultrasound_set_new_trigger_gpio(uint32_t ultrasound_id, GPIO_TypeDef *p_port, uint8_t pin)
 {
-    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
-    p_ultrasound->p_trigger_port = p_port;
-    p_ultrasound->trigger_pin = pin;
+    stm32f4_ultrasound_cfg_t *p_cfg = _stm32f4_ultrasound_get_cfg_ram(ultrasound_id);
+    p_cfg->p_trigger_port = p_port;
+    p_cfg->trigger_pin = pin;
 }
 
 void stm32f4_ultrasound_set_new_echo_gpio(uint32_t ultrasound_id, GPIO_TypeDef *p_port, uint8_t pin)
 {
-    stm32f4_ultrasound_hw_t *p_ultrasound = _stm32f4_ultrasound_get(ultrasound_id);
-    p_ultrasound->p_echo_port = p_port;
-    p_ultrasound->echo_pin = pin;
+    stm32f4_ultrasound_cfg_t *p_cfg = _stm32f4_ultrasound_get_cfg_ram(ultrasound_id);
+    p_cfg->p_echo_port = p_port;
+    p_cfg->echo_pin = pin;
+}
+
+void stm32f4_ultrasound_set_new_power_gpio(uint32_t ultrasound_id, GPIO_TypeDef *p_port, uint8_t pin)
+{
+    stm32f4_ultrasound_cfg_t *p_cfg = _stm32f4_ultrasound_get_cfg_ram(ultrasound_id);
+    p_cfg->p_power_port = p_port;
+    p_cfg->power_pin = pin;
+    _power_setup(ultrasound_id);
 }
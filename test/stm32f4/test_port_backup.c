@@ -0,0 +1,95 @@
+/**
+ * @file test_port_backup.c
+ * @brief Unit test for the port driver of the backup memory of the snapshots.
+ *
+ * It checks the configuration of the backup SRAM, and the write, read and validation of the snapshots using the Unity framework.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* HW independent libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+#include "port_backup.h"
+#include "port_system.h"
+/* HW dependent libraries */
+#include "stm32f4_system.h"
+#include "stm32f4_backup.h"
+#include "stm32f4xx.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define TEST_SNAPSHOT_SIZE 37   /*!< Size of the snapshot of the tests. Not a multiple of 4 to check the padding of the checksum @hideinitializer */
+
+/* Global variables */
+static uint8_t snapshot_arr[TEST_SNAPSHOT_SIZE];    /*!< Snapshot written by the tests */
+
+void setUp(void)
+{
+    port_backup_init();
+    for (uint32_t i = 0; i < TEST_SNAPSHOT_SIZE; i++)
+    {
+        snapshot_arr[i] = (uint8_t)(0xA0 + i);
+    }
+}
+
+void tearDown(void)
+{
+    port_backup_invalidate();
+}
+
+void test_config(void)
+{
+    UNITY_TEST_ASSERT(RCC->AHB1ENR & RCC_AHB1ENR_BKPSRAMEN, __LINE__, "ERROR: The clock of the backup SRAM must be enabled");
+    UNITY_TEST_ASSERT(PWR->CR & PWR_CR_DBP, __LINE__, "ERROR: The write access to the backup domain must be enabled");
+    UNITY_TEST_ASSERT(PWR->CSR & PWR_CSR_BRE, __LINE__, "ERROR: The backup regulator must be enabled to keep the snapshot in Standby mode");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_BACKUP_SRAM_SIZE - sizeof(stm32f4_backup_header_t), port_backup_get_capacity(), __LINE__, "ERROR: Wrong capacity of the backup memory");
+}
+
+void test_round_trip(void)
+{
+    uint8_t read_arr[TEST_SNAPSHOT_SIZE];
+    memset(read_arr, 0, sizeof(read_arr));
+
+    UNITY_TEST_ASSERT(port_backup_write(snapshot_arr, TEST_SNAPSHOT_SIZE), __LINE__, "ERROR: The snapshot must be written");
+    UNITY_TEST_ASSERT(port_backup_read(read_arr, TEST_SNAPSHOT_SIZE), __LINE__, "ERROR: A valid snapshot must be read");
+    UNITY_TEST_ASSERT_EQUAL_UINT8_ARRAY(snapshot_arr, read_arr, TEST_SNAPSHOT_SIZE, __LINE__, "ERROR: Wrong data of the snapshot read");
+
+    // The snapshot survives a new initialization of the HW (as after a reset)
+    port_backup_init();
+    UNITY_TEST_ASSERT(port_backup_read(read_arr, TEST_SNAPSHOT_SIZE), __LINE__, "ERROR: The snapshot must be kept by a new initialization");
+}
+
+void test_invalid(void)
+{
+    uint8_t read_arr[TEST_SNAPSHOT_SIZE];
+
+    port_backup_invalidate();
+    UNITY_TEST_ASSERT(!port_backup_read(read_arr, TEST_SNAPSHOT_SIZE), __LINE__, "ERROR: An invalidated snapshot must not be read");
+
+    port_backup_write(snapshot_arr, TEST_SNAPSHOT_SIZE);
+    UNITY_TEST_ASSERT(!port_backup_read(read_arr, TEST_SNAPSHOT_SIZE - 1), __LINE__, "ERROR: A snapshot of a different size must not be read");
+
+    // Corrupt the last byte of the data in the backup SRAM
+    uint8_t *p_data = (uint8_t *)(STM32F4_BACKUP_SRAM_BASE + sizeof(stm32f4_backup_header_t));
+    p_data[TEST_SNAPSHOT_SIZE - 1] ^= 0xFF;
+    UNITY_TEST_ASSERT(!port_backup_read(read_arr, TEST_SNAPSHOT_SIZE), __LINE__, "ERROR: A corrupted snapshot must not be read");
+
+    UNITY_TEST_ASSERT(!port_backup_write(snapshot_arr, port_backup_get_capacity() + 1), __LINE__, "ERROR: A snapshot larger than the backup memory must be rejected");
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_config);
+    RUN_TEST(test_round_trip);
+    RUN_TEST(test_invalid);
+
+    exit(UNITY_END());
+}
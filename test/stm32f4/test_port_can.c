@@ -0,0 +1,147 @@
+/**
+ * @file test_port_can.c
+ * @brief Unit test for the port driver of the CAN controller.
+ *
+ * It checks the configuration of the pins, the bit timing and the transmission and reception of standard and extended frames
+ * with the controller in silent loopback mode (no transceiver nor other nodes needed) using the Unity framework.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* HW independent libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+#include "port_can.h"
+#include "port_system.h"
+/* HW dependent libraries */
+#include "stm32f4_system.h"
+#include "stm32f4_can.h"
+#include "stm32f4xx.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define TEST_LOOPBACK_TIMEOUT_MS 10     /*!< Maximum time in ms to receive a frame sent in loopback @hideinitializer */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Wait for a frame sent in loopback.
+ *
+ * @param p_frame   Pointer to store the frame.
+ * @return true     If a frame has been received before the timeout.
+ * @return false    Otherwise.
+ */
+static bool _wait_frame(port_can_frame_t *p_frame)
+{
+    uint32_t start = port_system_get_millis();
+    while ((port_system_get_millis() - start) < TEST_LOOPBACK_TIMEOUT_MS)
+    {
+        if (port_can_receive(p_frame))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Send a frame in loopback and check that it is received unchanged.
+ *
+ * @param p_sent    Pointer to the frame to send.
+ */
+static void _check_round_trip(const port_can_frame_t *p_sent)
+{
+    port_can_frame_t received;
+    memset(&received, 0, sizeof(received));
+
+    UNITY_TEST_ASSERT(port_can_transmit(p_sent), __LINE__, "ERROR: The frame must be written into a free mailbox");
+    UNITY_TEST_ASSERT(_wait_frame(&received), __LINE__, "ERROR: The frame sent in loopback has not been received");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(p_sent->id, received.id, __LINE__, "ERROR: Wrong identifier of the received frame");
+    UNITY_TEST_ASSERT_EQUAL_UINT8(p_sent->dlc, received.dlc, __LINE__, "ERROR: Wrong DLC of the received frame");
+    UNITY_TEST_ASSERT_EQUAL_UINT8_ARRAY(p_sent->data, received.data, p_sent->dlc, __LINE__, "ERROR: Wrong data of the received frame");
+}
+
+void setUp(void)
+{
+    port_can_frame_t frame;
+    UNITY_TEST_ASSERT(port_can_init(true), __LINE__, "ERROR: The controller has not left the initialization mode in loopback");
+    while (port_can_receive(&frame))
+    {
+        // Flush the frames of the previous test
+    }
+}
+
+void tearDown(void)
+{
+    // Nothing to do
+}
+
+void test_pins(void)
+{
+    UNITY_TEST_ASSERT_EQUAL_INT(GPIOA, STM32F4_CAN_RX_GPIO, __LINE__, "ERROR: CAN RX GPIO must be GPIOA");
+    UNITY_TEST_ASSERT_EQUAL_INT(11, STM32F4_CAN_RX_PIN, __LINE__, "ERROR: CAN RX pin must be 11");
+    UNITY_TEST_ASSERT_EQUAL_INT(GPIOA, STM32F4_CAN_TX_GPIO, __LINE__, "ERROR: CAN TX GPIO must be GPIOA");
+    UNITY_TEST_ASSERT_EQUAL_INT(12, STM32F4_CAN_TX_PIN, __LINE__, "ERROR: CAN TX pin must be 12");
+
+    uint32_t mode_rx = (GPIOA->MODER >> (STM32F4_CAN_RX_PIN * 2)) & GPIO_MODER_MODER0_Msk;
+    uint32_t mode_tx = (GPIOA->MODER >> (STM32F4_CAN_TX_PIN * 2)) & GPIO_MODER_MODER0_Msk;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_GPIO_MODE_AF, mode_rx, __LINE__, "ERROR: CAN RX pin must be in alternate function mode");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_GPIO_MODE_AF, mode_tx, __LINE__, "ERROR: CAN TX pin must be in alternate function mode");
+
+    uint32_t af_rx = (GPIOA->AFR[STM32F4_CAN_RX_PIN / 8] >> ((STM32F4_CAN_RX_PIN % 8) * 4)) & 0xF;
+    uint32_t af_tx = (GPIOA->AFR[STM32F4_CAN_TX_PIN / 8] >> ((STM32F4_CAN_TX_PIN % 8) * 4)) & 0xF;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_CAN_AF, af_rx, __LINE__, "ERROR: CAN RX pin must be in AF9");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_CAN_AF, af_tx, __LINE__, "ERROR: CAN TX pin must be in AF9");
+}
+
+void test_bit_timing(void)
+{
+    // 16 MHz / (2 * 16 tq) = 500 kbit/s, TS1 = 13 tq, TS2 = 2 tq: sample point at 14 / 16 = 87.5 %
+    uint32_t btr = stm32f4_can_compute_btr(16000000, 500000);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, (btr & CAN_BTR_BRP) >> CAN_BTR_BRP_Pos, __LINE__, "ERROR: Wrong prescaler for 500 kbit/s at 16 MHz");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(12, (btr & CAN_BTR_TS1) >> CAN_BTR_TS1_Pos, __LINE__, "ERROR: Wrong time segment 1 for 500 kbit/s at 16 MHz");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, (btr & CAN_BTR_TS2) >> CAN_BTR_TS2_Pos, __LINE__, "ERROR: Wrong time segment 2 for 500 kbit/s at 16 MHz");
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, stm32f4_can_compute_btr(16000000, 0), __LINE__, "ERROR: A bit rate of 0 must not be generated");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, stm32f4_can_compute_btr(16000000, 470000), __LINE__, "ERROR: A bit rate that cannot be generated exactly must be rejected");
+
+    UNITY_TEST_ASSERT(STM32F4_CAN->BTR & CAN_BTR_LBKM, __LINE__, "ERROR: The loopback mode must be enabled in the tests");
+    UNITY_TEST_ASSERT(STM32F4_CAN->BTR & CAN_BTR_SILM, __LINE__, "ERROR: The silent mode must be enabled in the loopback of the tests");
+}
+
+void test_mailboxes(void)
+{
+    UNITY_TEST_ASSERT_EQUAL_UINT32(PORT_CAN_NUM_TX_MAILBOXES, port_can_get_free_mailboxes(), __LINE__, "ERROR: All the mailboxes must be free after the initialization");
+}
+
+void test_loopback_standard(void)
+{
+    port_can_frame_t frame = {.id = 0x310, .dlc = 8, .data = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88}};
+    _check_round_trip(&frame);
+
+    port_can_frame_t short_frame = {.id = PORT_CAN_STD_ID_MAX, .dlc = 3, .data = {0xA5, 0x5A, 0xFF}};
+    _check_round_trip(&short_frame);
+}
+
+void test_loopback_extended(void)
+{
+    port_can_frame_t frame = {.id = 0x18FEF100, .dlc = 2, .data = {0xCA, 0xFE}};
+    _check_round_trip(&frame);
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_pins);
+    RUN_TEST(test_bit_timing);
+    RUN_TEST(test_mailboxes);
+    RUN_TEST(test_loopback_standard);
+    RUN_TEST(test_loopback_extended);
+
+    exit(UNITY_END());
+}
@@ -40,7 +40,7 @@
 #define DISPLAY_RGB_PWM TIM4                            /*!< Display RGB timer @hideinitializer */
 #define DISPLAY_RGB_PWM_PER_BUS RCC->APB1ENR            /*!< Display RGB timer peripheral bus @hideinitializer */
 #define DISPLAY_RGB_PWM_PER_BUS_MASK RCC_APB1ENR_TIM4EN /*!< Display RGB timer peripheral bus mask @hideinitializer */
-#define DISPLAY_RGB_PWM_PERIOD_MS 20                    /*!< Period of the RGB display timer @hideinitializer */
+#define DISPLAY_RGB_PWM_PERIOD_MS (1000 / PORT_DISPLAY_PWM_FREQ_HZ) /*!< Period of the RGB display timer (20 ms by default) @hideinitializer */
 
 /* Private variables ---------------------------------------------------------*/
 static char msg[200]; /*!< Buffer for the error messages */
@@ -313,6 +313,52 @@ void test_display_set_color(void)
     UNITY_TEST_ASSERT_EQUAL_UINT32(prev_tim_pwm_ccmr2, curr_tim_pwm_ccmr2, __LINE__, "ERROR: The register CCMR2 of the DISPLAY timer for PWM has been modified and it should not have been changed");
 }
 
+/**
+ * @brief Get the period of the PWM of the DISPLAY in microseconds from the registers of the timer.
+ *
+ * @return uint32_t Period in microseconds.
+ */
+static uint32_t _get_pwm_period_us(void)
+{
+    uint64_t ticks = (uint64_t)(DISPLAY_RGB_PWM->PSC + 1) * (DISPLAY_RGB_PWM->ARR + 1);
+    return (uint32_t)((ticks * 1000000ULL) / SystemCoreClock);
+}
+
+/**
+ * @brief Test the configuration of the PWM frequency of the DISPLAY and its derivation from the system clock
+ *
+ */
+void test_display_pwm_frequency(void)
+{
+    rgb_color_t color = {TEST_PORT_DISPLAY_RGB_MAX_VALUE / 2, TEST_PORT_DISPLAY_RGB_MAX_VALUE / 4, TEST_PORT_DISPLAY_RGB_MAX_VALUE};
+    port_display_set_rgb(TEST_PORT_REAR_PARKING_DISPLAY_ID, color);
+
+    // High frequency mode
+    uint32_t freq_hz = port_display_set_pwm_frequency(TEST_PORT_REAR_PARKING_DISPLAY_ID, PORT_DISPLAY_PWM_HF_FREQ_HZ);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(PORT_DISPLAY_PWM_HF_FREQ_HZ, freq_hz, __LINE__, "ERROR: The high PWM frequency of the DISPLAY has not been configured");
+    UNITY_TEST_ASSERT_UINT32_WITHIN(1, 1000000 / PORT_DISPLAY_PWM_HF_FREQ_HZ, _get_pwm_period_us(), __LINE__, "ERROR: DISPLAY PWM period duration ARR and PSC are not configured correctly for the high frequency");
+    UNITY_TEST_ASSERT(DISPLAY_RGB_PWM->ARR + 1 >= STM32F4_DISPLAY_PWM_MIN_STEPS, __LINE__, "ERROR: DISPLAY PWM resolution is too low for the color palette");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TIM_CR1_CEN_Msk, DISPLAY_RGB_PWM->CR1 & TIM_CR1_CEN_Msk, __LINE__, "ERROR: The color must be applied again after changing the PWM frequency");
+    _test_display_set_color(color);
+
+    // A frequency without enough resolution is limited
+    freq_hz = port_display_set_pwm_frequency(TEST_PORT_REAR_PARKING_DISPLAY_ID, SystemCoreClock);
+    UNITY_TEST_ASSERT(freq_hz <= SystemCoreClock / STM32F4_DISPLAY_PWM_MIN_STEPS, __LINE__, "ERROR: The PWM frequency of the DISPLAY must be limited to keep the resolution");
+    UNITY_TEST_ASSERT(DISPLAY_RGB_PWM->ARR + 1 >= STM32F4_DISPLAY_PWM_MIN_STEPS, __LINE__, "ERROR: DISPLAY PWM resolution is too low for the color palette");
+
+    // A change of the system clock derives the period again when the color is set
+    port_display_set_pwm_frequency(TEST_PORT_REAR_PARKING_DISPLAY_ID, PORT_DISPLAY_PWM_HF_FREQ_HZ);
+    uint32_t system_core_clock = SystemCoreClock;
+    SystemCoreClock = system_core_clock / 2;
+    port_display_set_rgb(TEST_PORT_REAR_PARKING_DISPLAY_ID, color);
+    UNITY_TEST_ASSERT_UINT32_WITHIN(1, 1000000 / PORT_DISPLAY_PWM_HF_FREQ_HZ, _get_pwm_period_us(), __LINE__, "ERROR: DISPLAY PWM period has not been derived again after a change of the system clock");
+    SystemCoreClock = system_core_clock;
+
+    // Restore the default configuration
+    port_display_set_pwm_frequency(TEST_PORT_REAR_PARKING_DISPLAY_ID, PORT_DISPLAY_PWM_FREQ_HZ);
+    port_display_set_rgb(TEST_PORT_REAR_PARKING_DISPLAY_ID, COLOR_OFF);
+}
+
 int main(void)
 {
     port_system_init();
@@ -324,6 +370,7 @@ int main(void)
     RUN_TEST(test_trigger_regs);
     RUN_TEST(test_display_timer_pwm_config);
     RUN_TEST(test_display_set_color);
+    RUN_TEST(test_display_pwm_frequency);
 
     exit(UNITY_END());
 }
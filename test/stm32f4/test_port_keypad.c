@@ -0,0 +1,151 @@
+/**
+ * @file test_port_keypad.c
+ * @brief Unit test for the keypad port driver.
+ *
+ * It checks the configuration of the GPIOs, the sampling timer and the DMA streams of the keypad, and the debouncing of the scans using the Unity framework.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* HW independent libraries */
+#include <stdlib.h>
+#include <unity.h>
+#include "port_keypad.h"
+#include "port_system.h"
+/* HW dependent libraries */
+#include "stm32f4_system.h"
+#include "stm32f4_keypad.h"
+#include "stm32f4xx.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define ALL_RELEASED 0xFFFFU    /*!< Value of the inputs port when no key is pressed (pull-ups) @hideinitializer */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Feed the same scan to the keypad a number of times.
+ *
+ * @param row0_idr  Value of the inputs port while row 0 is active.
+ * @param row1_idr  Value of the inputs port while row 1 is active.
+ * @param n         Number of scans.
+ */
+static void _feed_scans(uint16_t row0_idr, uint16_t row1_idr, uint32_t n)
+{
+    uint16_t samples[STM32F4_KEYPAD_NUM_ROWS] = {row0_idr, row1_idr};
+    for (uint32_t i = 0; i < n; i++)
+    {
+        stm32f4_keypad_process_samples(samples);
+    }
+}
+
+void setUp(void)
+{
+    port_keypad_init();
+    stm32f4_keypad_reset();
+}
+
+void tearDown(void)
+{
+    port_keypad_stop();
+}
+
+void test_regs_gpio(void)
+{
+    uint32_t input_pins[] = {STM32F4_KEYPAD_AUX_1_PIN, STM32F4_KEYPAD_AUX_2_PIN, STM32F4_KEYPAD_COL_0_PIN, STM32F4_KEYPAD_COL_1_PIN, STM32F4_KEYPAD_COL_2_PIN};
+    for (uint32_t i = 0; i < sizeof(input_pins) / sizeof(input_pins[0]); i++)
+    {
+        uint32_t pin = input_pins[i];
+        UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_GPIO_MODE_IN, (STM32F4_KEYPAD_INPUT_GPIO->MODER >> (pin * 2U)) & 0x03U, __LINE__, "ERROR: The keypad inputs must be configured as inputs");
+        UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_GPIO_PUPDR_PULLUP, (STM32F4_KEYPAD_INPUT_GPIO->PUPDR >> (pin * 2U)) & 0x03U, __LINE__, "ERROR: The keypad inputs must have pull-up");
+    }
+
+    uint32_t row_pins[] = {STM32F4_KEYPAD_ROW_0_PIN, STM32F4_KEYPAD_ROW_1_PIN};
+    for (uint32_t i = 0; i < STM32F4_KEYPAD_NUM_ROWS; i++)
+    {
+        uint32_t pin = row_pins[i];
+        UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_GPIO_MODE_OUT, (STM32F4_KEYPAD_ROW_GPIO->MODER >> (pin * 2U)) & 0x03U, __LINE__, "ERROR: The rows of the matrix must be configured as outputs");
+        UNITY_TEST_ASSERT_EQUAL_UINT32(BIT_POS_TO_MASK(pin), STM32F4_KEYPAD_ROW_GPIO->ODR & BIT_POS_TO_MASK(pin), __LINE__, "ERROR: The rows of the matrix must be inactive (high) after the configuration");
+    }
+}
+
+void test_regs_timer(void)
+{
+    UNITY_TEST_ASSERT_EQUAL_UINT32(RCC_APB2ENR_TIM8EN, RCC->APB2ENR & RCC_APB2ENR_TIM8EN, __LINE__, "ERROR: The clock of the sampling timer is not enabled");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, STM32F4_KEYPAD_TIMER->CR1 & TIM_CR1_CEN, __LINE__, "ERROR: The sampling timer must not be enabled by the configuration");
+
+    uint32_t period_us = (uint32_t)(((uint64_t)(STM32F4_KEYPAD_TIMER->PSC + 1) * (STM32F4_KEYPAD_TIMER->ARR + 1) * 1000000ULL) / SystemCoreClock);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_KEYPAD_SAMPLE_PERIOD_US, period_us, __LINE__, "ERROR: The sampling period is not correct");
+    UNITY_TEST_ASSERT(STM32F4_KEYPAD_TIMER->CCR1 < STM32F4_KEYPAD_TIMER->ARR, __LINE__, "ERROR: The rows must be updated before the inputs are sampled");
+
+    uint32_t dma_requests = TIM_DIER_UDE | TIM_DIER_CC1DE;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(dma_requests, STM32F4_KEYPAD_TIMER->DIER & dma_requests, __LINE__, "ERROR: The sampling timer must request the DMA on update and CC1 events");
+}
+
+void test_regs_dma(void)
+{
+    UNITY_TEST_ASSERT_EQUAL_UINT32(RCC_AHB1ENR_DMA2EN, RCC->AHB1ENR & RCC_AHB1ENR_DMA2EN, __LINE__, "ERROR: The clock of DMA2 is not enabled");
+
+    uint32_t sample_cr = STM32F4_KEYPAD_SAMPLE_DMA->CR;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_KEYPAD_DMA_CHANNEL, (sample_cr >> DMA_SxCR_CHSEL_Pos) & 0x07U, __LINE__, "ERROR: The sampling stream is not connected to TIM8_UP");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(DMA_SxCR_CIRC | DMA_SxCR_MINC | DMA_SxCR_HTIE | DMA_SxCR_TCIE, sample_cr & (DMA_SxCR_CIRC | DMA_SxCR_MINC | DMA_SxCR_HTIE | DMA_SxCR_TCIE), __LINE__, "ERROR: The sampling stream must be circular and interrupt at half and complete transfer");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, sample_cr & (DMA_SxCR_DIR_0 | DMA_SxCR_DIR_1), __LINE__, "ERROR: The sampling stream must be peripheral to memory");
+    UNITY_TEST_ASSERT_EQUAL_UINT32((uint32_t)(uintptr_t)&STM32F4_KEYPAD_INPUT_GPIO->IDR, STM32F4_KEYPAD_SAMPLE_DMA->PAR, __LINE__, "ERROR: The sampling stream must read the IDR of the inputs port");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(2 * STM32F4_KEYPAD_NUM_ROWS, STM32F4_KEYPAD_SAMPLE_DMA->NDTR, __LINE__, "ERROR: The sampling stream must fill two scans");
+
+    uint32_t row_cr = STM32F4_KEYPAD_ROW_DMA->CR;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(DMA_SxCR_DIR_0, row_cr & (DMA_SxCR_DIR_0 | DMA_SxCR_DIR_1), __LINE__, "ERROR: The rows stream must be memory to peripheral");
+    UNITY_TEST_ASSERT_EQUAL_UINT32((uint32_t)(uintptr_t)&STM32F4_KEYPAD_ROW_GPIO->BSRR, STM32F4_KEYPAD_ROW_DMA->PAR, __LINE__, "ERROR: The rows stream must write the BSRR of the rows port");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_KEYPAD_NUM_ROWS, STM32F4_KEYPAD_ROW_DMA->NDTR, __LINE__, "ERROR: The rows stream must transfer one pattern per row");
+}
+
+void test_debounce_direct_key(void)
+{
+    uint16_t aux_1_low = ALL_RELEASED & ~BIT_POS_TO_MASK(STM32F4_KEYPAD_AUX_1_PIN);
+
+    _feed_scans(aux_1_low, aux_1_low, PORT_KEYPAD_DEBOUNCE_SCANS - 1);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, port_keypad_get_state(), __LINE__, "ERROR: A key must not be pressed before the debounce scans");
+
+    // A bounce restarts the count
+    _feed_scans(ALL_RELEASED, ALL_RELEASED, 1);
+    _feed_scans(aux_1_low, aux_1_low, PORT_KEYPAD_DEBOUNCE_SCANS - 1);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, port_keypad_get_state(), __LINE__, "ERROR: A bounce must restart the debounce of a key");
+
+    _feed_scans(aux_1_low, aux_1_low, 1);
+    UNITY_TEST_ASSERT(port_keypad_get_key(PORT_KEYPAD_AUX_1_ID), __LINE__, "ERROR: The key must be pressed after the debounce scans");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(BIT_POS_TO_MASK(PORT_KEYPAD_AUX_1_ID), port_keypad_get_pressed_events(), __LINE__, "ERROR: The press of the key must generate one event");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, port_keypad_get_pressed_events(), __LINE__, "ERROR: The events must be cleared when they are read");
+
+    _feed_scans(ALL_RELEASED, ALL_RELEASED, PORT_KEYPAD_DEBOUNCE_SCANS);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, port_keypad_get_state(), __LINE__, "ERROR: The key must be released after the debounce scans");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, port_keypad_get_pressed_events(), __LINE__, "ERROR: The release of a key must not generate a press event");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(3 * PORT_KEYPAD_DEBOUNCE_SCANS, port_keypad_get_scan_count(), __LINE__, "ERROR: The number of scans is not correct");
+}
+
+void test_debounce_matrix(void)
+{
+    // Keys R0C0 and R1C2 pressed: column 0 is low while row 0 is active and column 2 is low while row 1 is active
+    uint16_t row0_idr = ALL_RELEASED & ~BIT_POS_TO_MASK(STM32F4_KEYPAD_COL_0_PIN);
+    uint16_t row1_idr = ALL_RELEASED & ~BIT_POS_TO_MASK(STM32F4_KEYPAD_COL_2_PIN);
+
+    _feed_scans(row0_idr, row1_idr, PORT_KEYPAD_DEBOUNCE_SCANS);
+
+    uint32_t expected = BIT_POS_TO_MASK(PORT_KEYPAD_MATRIX_R0C0_ID) | BIT_POS_TO_MASK(PORT_KEYPAD_MATRIX_R1C2_ID);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(expected, port_keypad_get_state(), __LINE__, "ERROR: The keys of the matrix are not decoded with their rows");
+    UNITY_TEST_ASSERT(!port_keypad_get_key(PORT_KEYPAD_NUM_KEYS), __LINE__, "ERROR: An invalid key ID must be reported as released");
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_regs_gpio);
+    RUN_TEST(test_regs_timer);
+    RUN_TEST(test_regs_dma);
+    RUN_TEST(test_debounce_direct_key);
+    RUN_TEST(test_debounce_matrix);
+
+    exit(UNITY_END());
+}
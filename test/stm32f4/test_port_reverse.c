@@ -0,0 +1,141 @@
+/**
+ * @file test_port_reverse.c
+ * @brief Unit test for the port driver of the reverse-gear and ignition inputs.
+ *
+ * It checks the configuration of the GPIO pins and their EXTI lines, the priority of the interrupt and the reading and debounce
+ * of the levels of the inputs using the Unity framework.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* HW independent libraries */
+#include <stdlib.h>
+#include <unity.h>
+#include "port_reverse.h"
+#include "port_system.h"
+/* HW dependent libraries */
+#include "stm32f4_system.h"
+#include "stm32f4_reverse.h"
+#include "stm32f4xx.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define TEST_PORT_REVERSE_GEAR_ID 0     /*!< Reverse input identifier @hideinitializer */
+#define TEST_SETTLE_MS 1                /*!< Time in ms for an unconnected input to follow its pull resistor @hideinitializer */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Check the configuration of the GPIO pin and EXTI line of an input.
+ *
+ * @param p_port    GPIO port of the input.
+ * @param pin       GPIO pin of the input.
+ * @param exti_port Value of the EXTICR field of the port.
+ */
+static void _check_input(GPIO_TypeDef *p_port, uint8_t pin, uint32_t exti_port)
+{
+    uint32_t mode = ((p_port->MODER) >> (pin * 2)) & GPIO_MODER_MODER0_Msk;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_GPIO_MODE_IN, mode, __LINE__, "ERROR: The vehicle input is not configured as input");
+
+    uint32_t pupd = ((p_port->PUPDR) >> (pin * 2)) & GPIO_PUPDR_PUPD0_Msk;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_GPIO_PUPDR_PULLDOWN, pupd, __LINE__, "ERROR: The vehicle input must have a pull-down (inactive when disconnected)");
+
+    uint32_t exticr = ((SYSCFG->EXTICR[pin / 4]) >> ((pin % 4) * 4)) & 0xF;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(exti_port, exticr, __LINE__, "ERROR: The EXTI line is not connected to the port of the vehicle input");
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, (EXTI->RTSR >> pin) & 0x1, __LINE__, "ERROR: The vehicle input must interrupt on the rising edge");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, (EXTI->FTSR >> pin) & 0x1, __LINE__, "ERROR: The vehicle input must interrupt on the falling edge");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, (EXTI->EMR >> pin) & 0x1, __LINE__, "ERROR: The vehicle input must not be in event mode");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, (EXTI->IMR >> pin) & 0x1, __LINE__, "ERROR: The vehicle input must be in interrupt mode");
+}
+
+void setUp(void)
+{
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOCEN;
+    port_reverse_init(TEST_PORT_REVERSE_GEAR_ID);
+    port_reverse_disable_interrupts(TEST_PORT_REVERSE_GEAR_ID); // The levels are read by the tests, not by the ISR
+}
+
+void tearDown(void)
+{
+    port_reverse_set_engaged(TEST_PORT_REVERSE_GEAR_ID, false);
+    port_reverse_set_ignition(TEST_PORT_REVERSE_GEAR_ID, false);
+}
+
+void test_pins(void)
+{
+    UNITY_TEST_ASSERT_EQUAL_INT(0, PORT_REVERSE_GEAR_ID, __LINE__, "ERROR: PORT_REVERSE_GEAR_ID must be 0");
+    UNITY_TEST_ASSERT_EQUAL_INT(GPIOC, STM32F4_REVERSE_GEAR_GPIO, __LINE__, "ERROR: Reverse-gear GPIO must be GPIOC");
+    UNITY_TEST_ASSERT_EQUAL_INT(8, STM32F4_REVERSE_GEAR_PIN, __LINE__, "ERROR: Reverse-gear pin must be 8");
+    UNITY_TEST_ASSERT_EQUAL_INT(GPIOC, STM32F4_REVERSE_IGNITION_GPIO, __LINE__, "ERROR: Ignition GPIO must be GPIOC");
+    UNITY_TEST_ASSERT_EQUAL_INT(9, STM32F4_REVERSE_IGNITION_PIN, __LINE__, "ERROR: Ignition pin must be 9");
+}
+
+void test_config(void)
+{
+    EXTI->RTSR = 0;
+    EXTI->FTSR = 0;
+    EXTI->IMR = 0;
+    port_reverse_init(TEST_PORT_REVERSE_GEAR_ID);
+
+    _check_input(STM32F4_REVERSE_GEAR_GPIO, STM32F4_REVERSE_GEAR_PIN, 0x2);
+    _check_input(STM32F4_REVERSE_IGNITION_GPIO, STM32F4_REVERSE_IGNITION_PIN, 0x2);
+
+    uint32_t pPreemptPriority;
+    uint32_t pSubPriority;
+    NVIC_DecodePriority(NVIC_GetPriority(EXTI9_5_IRQn), NVIC_GetPriorityGrouping(), &pPreemptPriority, &pSubPriority);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, pPreemptPriority, __LINE__, "ERROR: The vehicle inputs must have the priority of the button");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, pSubPriority, __LINE__, "ERROR: Wrong subpriority of the vehicle inputs");
+}
+
+void test_update(void)
+{
+    // Disconnected inputs follow their pull resistor: the pull-down reads as released and off
+    port_reverse_set_engaged(TEST_PORT_REVERSE_GEAR_ID, true);
+    port_reverse_set_ignition(TEST_PORT_REVERSE_GEAR_ID, true);
+    port_reverse_update(TEST_PORT_REVERSE_GEAR_ID);
+    UNITY_TEST_ASSERT(port_reverse_get_engaged(TEST_PORT_REVERSE_GEAR_ID), __LINE__, "ERROR: A new level must not be taken before the debounce time");
+    UNITY_TEST_ASSERT(port_reverse_get_debouncing(TEST_PORT_REVERSE_GEAR_ID), __LINE__, "ERROR: A new level must be debounced");
+    port_system_delay_ms(PORT_REVERSE_DEBOUNCE_MS);
+    UNITY_TEST_ASSERT(!port_reverse_get_engaged(TEST_PORT_REVERSE_GEAR_ID), __LINE__, "ERROR: A low reverse-gear input must read as released");
+    UNITY_TEST_ASSERT(!port_reverse_get_ignition(TEST_PORT_REVERSE_GEAR_ID), __LINE__, "ERROR: A low ignition input must read as off");
+
+    // A pull-up on the reverse-gear input only simulates the signal of the vehicle
+    stm32f4_system_gpio_config(STM32F4_REVERSE_GEAR_GPIO, STM32F4_REVERSE_GEAR_PIN, STM32F4_GPIO_MODE_IN, STM32F4_GPIO_PUPDR_PULLUP);
+    port_system_delay_ms(TEST_SETTLE_MS);
+    port_reverse_update(TEST_PORT_REVERSE_GEAR_ID);
+    port_system_delay_ms(PORT_REVERSE_DEBOUNCE_MS);
+    UNITY_TEST_ASSERT(!port_reverse_get_debouncing(TEST_PORT_REVERSE_GEAR_ID), __LINE__, "ERROR: A level stable for the debounce time must be taken");
+    UNITY_TEST_ASSERT(port_reverse_get_engaged(TEST_PORT_REVERSE_GEAR_ID), __LINE__, "ERROR: A high reverse-gear input must read as engaged");
+    UNITY_TEST_ASSERT(!port_reverse_get_ignition(TEST_PORT_REVERSE_GEAR_ID), __LINE__, "ERROR: The ignition must not follow the reverse-gear input");
+}
+
+void test_pending_interrupt(void)
+{
+    // Write 1 to clear: the pending flags can only be checked after a real edge
+    port_reverse_clear_pending_interrupt(TEST_PORT_REVERSE_GEAR_ID);
+    UNITY_TEST_ASSERT(!port_reverse_get_pending_interrupt(TEST_PORT_REVERSE_GEAR_ID), __LINE__, "ERROR: The pending interrupts of the vehicle inputs must be cleared");
+
+    // An edge of the ignition input (made with its pull resistors) is a pending interrupt of the inputs
+    stm32f4_system_gpio_config(STM32F4_REVERSE_IGNITION_GPIO, STM32F4_REVERSE_IGNITION_PIN, STM32F4_GPIO_MODE_IN, STM32F4_GPIO_PUPDR_PULLUP);
+    port_system_delay_ms(TEST_SETTLE_MS);
+    UNITY_TEST_ASSERT(port_reverse_get_pending_interrupt(TEST_PORT_REVERSE_GEAR_ID), __LINE__, "ERROR: An edge of the ignition input must be a pending interrupt");
+
+    port_reverse_clear_pending_interrupt(TEST_PORT_REVERSE_GEAR_ID);
+    UNITY_TEST_ASSERT(!port_reverse_get_pending_interrupt(TEST_PORT_REVERSE_GEAR_ID), __LINE__, "ERROR: The pending interrupt must be cleared");
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_pins);
+    RUN_TEST(test_config);
+    RUN_TEST(test_update);
+    RUN_TEST(test_pending_interrupt);
+
+    exit(UNITY_END());
+}
@@ -0,0 +1,111 @@
+/**
+ * @file test_port_system_ramfunc.c
+ * @brief Unit test for the execution of the ISRs from SRAM and for the interrupt latency probes.
+ *
+ * It checks that the ISRs marked with `PORT_RAMFUNC` are linked in SRAM, that the vector table points to them and that
+ * their code was copied at startup, and that the probes measure the latency of a pended interrupt using the Unity framework.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* HW independent libraries */
+#include <stdlib.h>
+#include <unity.h>
+#include "port_system.h"
+/* HW dependent libraries */
+#include "stm32f4_system.h"
+#include "stm32f4xx.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define TEST_NUM_CORE_EXCEPTIONS 16U    /*!< Number of entries of the vector table before the peripheral interrupts @hideinitializer */
+#define TEST_MIN_LATENCY_CYCLES 12U     /*!< Minimum number of cycles of the exception entry of the Cortex-M4 @hideinitializer */
+
+/* ISRs of interr.c */
+extern void SysTick_Handler(void);
+extern void EXTI15_10_IRQHandler(void);
+extern void TIM2_IRQHandler(void);
+
+#ifdef USE_RAMFUNC
+/* Symbols of the linker script fragment stm32f4_ramfunc.ld */
+extern uint32_t _siramfunc;
+extern uint32_t _sramfunc;
+extern uint32_t _eramfunc;
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Check that an ISR is in SRAM and that its entry of the vector table points to it.
+ *
+ * @param p_isr     Pointer to the ISR.
+ * @param irqn      Interrupt number of the ISR.
+ */
+static void _check_isr_in_sram(void (*p_isr)(void), IRQn_Type irqn)
+{
+    uint32_t address = (uint32_t)(uintptr_t)p_isr;
+    const uint32_t *p_vectors = (const uint32_t *)(uintptr_t)SCB->VTOR;
+
+    UNITY_TEST_ASSERT(address >= SRAM1_BASE, __LINE__, "ERROR: The ISR must be placed in SRAM");
+    UNITY_TEST_ASSERT_EQUAL_HEX32(address, p_vectors[TEST_NUM_CORE_EXCEPTIONS + irqn], __LINE__, "ERROR: The vector table must point to the ISR in SRAM");
+}
+#endif
+
+void setUp(void)
+{
+    stm32f4_system_irq_latency_reset();
+}
+
+void tearDown(void)
+{
+    NVIC_DisableIRQ(TIM2_IRQn);
+}
+
+void test_ramfunc_placement(void)
+{
+#ifdef USE_RAMFUNC
+    _check_isr_in_sram(SysTick_Handler, SysTick_IRQn);
+    _check_isr_in_sram(EXTI15_10_IRQHandler, EXTI15_10_IRQn);
+    _check_isr_in_sram(TIM2_IRQHandler, TIM2_IRQn);
+
+    // If the script of the platform collects .RamFunc in .data, the section of the fragment is empty and .data is copied by the startup code
+    const uint32_t *p_src = &_siramfunc;
+    for (const uint32_t *p_dst = &_sramfunc; p_dst < &_eramfunc; p_dst++, p_src++)
+    {
+        UNITY_TEST_ASSERT_EQUAL_HEX32(*p_src, *p_dst, __LINE__, "ERROR: The functions in SRAM must be a copy of their load image in flash");
+    }
+#else
+    TEST_IGNORE_MESSAGE("The ISRs are executed from flash (USE_RAMFUNC not defined)");
+#endif
+}
+
+void test_irq_latency_probe(void)
+{
+#ifdef USE_IRQ_LATENCY
+    NVIC_SetPriority(TIM2_IRQn, NVIC_EncodePriority(NVIC_GetPriorityGrouping(), 1, 0));
+    NVIC_EnableIRQ(TIM2_IRQn);
+
+    stm32f4_system_irq_latency_trigger(TIM2_IRQn);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, stm32f4_irq_latency.count, __LINE__, "ERROR: The probe of the ISR must record one measurement");
+    UNITY_TEST_ASSERT_EQUAL_INT32(STM32F4_IRQ_LATENCY_NONE, stm32f4_irq_latency.armed_irqn, __LINE__, "ERROR: The probe must disarm the measurement");
+    UNITY_TEST_ASSERT(stm32f4_irq_latency.last >= TEST_MIN_LATENCY_CYCLES, __LINE__, "ERROR: The latency cannot be shorter than the exception entry");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(stm32f4_irq_latency.last, stm32f4_irq_latency.max, __LINE__, "ERROR: The maximum latency of one measurement must be the measurement");
+
+    // A probe of another ISR must not record anything
+    stm32f4_system_irq_latency_probe(EXTI15_10_IRQn);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, stm32f4_irq_latency.count, __LINE__, "ERROR: Only the armed interrupt must be measured");
+#else
+    TEST_IGNORE_MESSAGE("The latency probes are not compiled (USE_IRQ_LATENCY not defined)");
+#endif
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_ramfunc_placement);
+    RUN_TEST(test_irq_latency_probe);
+
+    exit(UNITY_END());
+}
@@ -0,0 +1,155 @@
+/**
+ * @file test_port_tof.c
+ * @brief Unit test for the ToF port driver.
+ *
+ * It checks the configuration of the GPIOs, the I2C controller and the DMA streams of the bus of the ToF sensors, and the
+ * decoding of the result block of a measurement using the Unity framework. The sensor does not need to be connected.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* HW independent libraries */
+#include <stdlib.h>
+#include <unity.h>
+#include "port_tof.h"
+#include "port_system.h"
+/* HW dependent libraries */
+#include "stm32f4_system.h"
+#include "stm32f4_tof.h"
+#include "stm32f4xx.h"
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Build a result block of the sensor.
+ *
+ * @param p_result          Array of `STM32F4_TOF_RESULT_LEN` bytes.
+ * @param status            Range status.
+ * @param signal_rate_q7    Signal rate in Mcps (Q9.7).
+ * @param distance_mm       Distance in mm.
+ */
+static void _build_result(uint8_t *p_result, uint8_t status, uint16_t signal_rate_q7, uint16_t distance_mm)
+{
+    for (uint32_t i = 0; i < STM32F4_TOF_RESULT_LEN; i++)
+    {
+        p_result[i] = 0;
+    }
+    p_result[0] = (uint8_t)((status << 3) | 0x01U);
+    p_result[6] = (uint8_t)(signal_rate_q7 >> 8);
+    p_result[7] = (uint8_t)signal_rate_q7;
+    p_result[10] = (uint8_t)(distance_mm >> 8);
+    p_result[11] = (uint8_t)distance_mm;
+}
+
+/**
+ * @brief Check the mode, alternate function, output type and pull of a pin of the bus.
+ */
+static void _check_bus_pin(GPIO_TypeDef *p_port, uint32_t pin, const char *p_name)
+{
+    UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_GPIO_MODE_AF, (p_port->MODER >> (pin * 2U)) & 0x03U, __LINE__, p_name);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_TOF_I2C_AF, (p_port->AFR[pin / 8] >> ((pin % 8) * 4)) & 0xFU, __LINE__, p_name);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(BIT_POS_TO_MASK(pin), p_port->OTYPER & BIT_POS_TO_MASK(pin), __LINE__, p_name);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_GPIO_PUPDR_PULLUP, (p_port->PUPDR >> (pin * 2U)) & 0x03U, __LINE__, p_name);
+}
+
+void setUp(void)
+{
+    // Without a sensor it returns false, but the HW is configured anyway
+    (void)port_tof_init(PORT_REAR_TOF_SENSOR_ID);
+}
+
+void tearDown(void)
+{
+    port_tof_stop(PORT_REAR_TOF_SENSOR_ID);
+}
+
+void test_regs_gpio(void)
+{
+    _check_bus_pin(STM32F4_TOF_SCL_GPIO, STM32F4_TOF_SCL_PIN, "ERROR: SCL must be an open drain pin of I2C2 (AF4) with pull-up");
+    _check_bus_pin(STM32F4_TOF_SDA_GPIO, STM32F4_TOF_SDA_PIN, "ERROR: SDA must be an open drain pin of I2C2 (AF4) with pull-up");
+
+    uint32_t int_pin = STM32F4_REAR_TOF_INT_PIN;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_GPIO_MODE_IN, (STM32F4_REAR_TOF_INT_GPIO->MODER >> (int_pin * 2U)) & 0x03U, __LINE__, "ERROR: The interrupt pin of the sensor must be an input");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_GPIO_PUPDR_PULLUP, (STM32F4_REAR_TOF_INT_GPIO->PUPDR >> (int_pin * 2U)) & 0x03U, __LINE__, "ERROR: The interrupt pin of the sensor (open drain) must have pull-up");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(BIT_POS_TO_MASK(int_pin), EXTI->FTSR & BIT_POS_TO_MASK(int_pin), __LINE__, "ERROR: The interrupt pin of the sensor must interrupt on the falling edge");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, EXTI->RTSR & BIT_POS_TO_MASK(int_pin), __LINE__, "ERROR: The interrupt pin of the sensor must not interrupt on the rising edge");
+
+    uint32_t xshut_pin = STM32F4_REAR_TOF_XSHUT_PIN;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_GPIO_MODE_OUT, (STM32F4_REAR_TOF_XSHUT_GPIO->MODER >> (xshut_pin * 2U)) & 0x03U, __LINE__, "ERROR: The shutdown pin of the sensor must be an output");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(BIT_POS_TO_MASK(xshut_pin), STM32F4_REAR_TOF_XSHUT_GPIO->ODR & BIT_POS_TO_MASK(xshut_pin), __LINE__, "ERROR: The sensor must be powered up (shutdown pin high)");
+}
+
+void test_regs_i2c(void)
+{
+    UNITY_TEST_ASSERT_EQUAL_UINT32(RCC_APB1ENR_I2C2EN, RCC->APB1ENR & RCC_APB1ENR_I2C2EN, __LINE__, "ERROR: The clock of I2C2 is not enabled");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(I2C_CR1_PE, STM32F4_TOF_I2C->CR1 & I2C_CR1_PE, __LINE__, "ERROR: I2C2 must be enabled");
+
+    uint32_t pclk_hz = SystemCoreClock >> APBPrescTable[(RCC->CFGR & RCC_CFGR_PPRE1) >> RCC_CFGR_PPRE1_Pos];
+    UNITY_TEST_ASSERT_EQUAL_UINT32(pclk_hz / 1000000, STM32F4_TOF_I2C->CR2 & I2C_CR2_FREQ, __LINE__, "ERROR: The frequency of I2C2 must be the one of APB1 in MHz");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(I2C_CCR_FS, STM32F4_TOF_I2C->CCR & (I2C_CCR_FS | I2C_CCR_DUTY), __LINE__, "ERROR: The bus must be in fast mode with duty 2:1");
+
+    uint32_t scl_hz = pclk_hz / (3 * (STM32F4_TOF_I2C->CCR & I2C_CCR_CCR));
+    UNITY_TEST_ASSERT(scl_hz <= STM32F4_TOF_I2C_SPEED_HZ, __LINE__, "ERROR: The clock of the bus must not exceed its speed");
+    UNITY_TEST_ASSERT(scl_hz > (STM32F4_TOF_I2C_SPEED_HZ * 9) / 10, __LINE__, "ERROR: The clock of the bus is too slow");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, STM32F4_TOF_I2C->CR2 & I2C_CR2_ITBUFEN, __LINE__, "ERROR: The data of the bus must be moved by the DMA, not by the buffer interrupts");
+}
+
+void test_regs_dma(void)
+{
+    UNITY_TEST_ASSERT_EQUAL_UINT32(RCC_AHB1ENR_DMA1EN, RCC->AHB1ENR & RCC_AHB1ENR_DMA1EN, __LINE__, "ERROR: The clock of DMA1 is not enabled");
+
+    uint32_t tx_cr = STM32F4_TOF_TX_DMA->CR;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_TOF_DMA_CHANNEL, (tx_cr >> DMA_SxCR_CHSEL_Pos) & 0x07U, __LINE__, "ERROR: The TX stream is not connected to I2C2_TX");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(DMA_SxCR_DIR_0, tx_cr & (DMA_SxCR_DIR_0 | DMA_SxCR_DIR_1), __LINE__, "ERROR: The TX stream must be memory to peripheral");
+    UNITY_TEST_ASSERT_EQUAL_UINT32((uint32_t)(uintptr_t)&STM32F4_TOF_I2C->DR, STM32F4_TOF_TX_DMA->PAR, __LINE__, "ERROR: The TX stream must write the DR of I2C2");
+
+    uint32_t rx_cr = STM32F4_TOF_RX_DMA->CR;
+    UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_TOF_DMA_CHANNEL, (rx_cr >> DMA_SxCR_CHSEL_Pos) & 0x07U, __LINE__, "ERROR: The RX stream is not connected to I2C2_RX");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, rx_cr & (DMA_SxCR_DIR_0 | DMA_SxCR_DIR_1), __LINE__, "ERROR: The RX stream must be peripheral to memory");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(DMA_SxCR_MINC | DMA_SxCR_TCIE | DMA_SxCR_TEIE, rx_cr & (DMA_SxCR_MINC | DMA_SxCR_TCIE | DMA_SxCR_TEIE), __LINE__, "ERROR: The RX stream must increment the memory and interrupt at complete transfer and on error");
+    UNITY_TEST_ASSERT_EQUAL_UINT32((uint32_t)(uintptr_t)&STM32F4_TOF_I2C->DR, STM32F4_TOF_RX_DMA->PAR, __LINE__, "ERROR: The RX stream must read the DR of I2C2");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, (tx_cr | rx_cr) & DMA_SxCR_EN, __LINE__, "ERROR: The streams must not be enabled without a transfer");
+}
+
+void test_process_result(void)
+{
+    uint8_t result[STM32F4_TOF_RESULT_LEN];
+
+    // 345 mm with 2.5 Mcps
+    _build_result(result, STM32F4_TOF_RANGE_STATUS_VALID, (uint16_t)(2.5 * 128), 345);
+    stm32f4_tof_process_result(PORT_REAR_TOF_SENSOR_ID, result);
+    UNITY_TEST_ASSERT(port_tof_get_range_valid(PORT_REAR_TOF_SENSOR_ID), __LINE__, "ERROR: A range with the valid status must be valid");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(345, port_tof_get_distance_mm(PORT_REAR_TOF_SENSOR_ID), __LINE__, "ERROR: Wrong distance of the result (big endian, bytes 10-11)");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(2500, port_tof_get_signal_rate_kcps(PORT_REAR_TOF_SENSOR_ID), __LINE__, "ERROR: Wrong signal rate of the result (Q9.7 Mcps, bytes 6-7)");
+    UNITY_TEST_ASSERT(!port_tof_get_measurement_ready(PORT_REAR_TOF_SENSOR_ID), __LINE__, "ERROR: The decoding of a result must not set the measurement ready flag");
+
+    // Weak signal (range status 4: phase fail)
+    _build_result(result, 4, 10, 1200);
+    stm32f4_tof_process_result(PORT_REAR_TOF_SENSOR_ID, result);
+    UNITY_TEST_ASSERT(!port_tof_get_range_valid(PORT_REAR_TOF_SENSOR_ID), __LINE__, "ERROR: A range without the valid status must not be valid");
+
+    // No target
+    _build_result(result, STM32F4_TOF_RANGE_STATUS_VALID, 10, STM32F4_TOF_RANGE_OUT);
+    stm32f4_tof_process_result(PORT_REAR_TOF_SENSOR_ID, result);
+    UNITY_TEST_ASSERT(!port_tof_get_range_valid(PORT_REAR_TOF_SENSOR_ID), __LINE__, "ERROR: The out of range distance must not be valid");
+
+    // Invalid IDs
+    stm32f4_tof_process_result(PORT_REAR_TOF_SENSOR_ID + 1, result);
+    UNITY_TEST_ASSERT(!port_tof_start_measurement(PORT_REAR_TOF_SENSOR_ID + 1), __LINE__, "ERROR: A measurement of an invalid ID must not start");
+    UNITY_TEST_ASSERT(!port_tof_get_busy(PORT_REAR_TOF_SENSOR_ID + 1), __LINE__, "ERROR: An invalid ID must not be busy");
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_regs_gpio);
+    RUN_TEST(test_regs_i2c);
+    RUN_TEST(test_regs_dma);
+    RUN_TEST(test_process_result);
+
+    exit(UNITY_END());
+}
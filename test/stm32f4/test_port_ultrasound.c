@@ -725,6 +725,58 @@ void test_echo_port_generalization(void)
     UNITY_TEST_ASSERT_EQUAL_UINT32(expected_gpio_pupd, curr_gpio_pupd, __LINE__, "ERROR: The configuration function is not generalizing the GPIO and/or pin but working with the specific GPIO and pin for the echo signal");
 }
 
+/**
+ * @brief Test the power gating of the sensor through the supply-enable pin.
+ */
+void test_power_gating(void)
+{
+    GPIO_TypeDef *p_power_gpio_port = GPIOC;
+    uint8_t power_gpio_pin = 7;
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOCEN;
+
+    // Without supply-enable pin the sensor is always ready
+    stm32f4_ultrasound_set_new_power_gpio(PORT_REAR_PARKING_SENSOR_ID, NULL, 0);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, port_ultrasound_get_settle_remaining_ms(PORT_REAR_PARKING_SENSOR_ID), __LINE__, "ERROR: A sensor without supply-enable pin must not wait for settling");
+
+    // The supply-enable pin is configured as output and the sensor is powered down
+    stm32f4_ultrasound_set_new_power_gpio(PORT_REAR_PARKING_SENSOR_ID, p_power_gpio_port, power_gpio_pin);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(STM32F4_GPIO_MODE_OUT, (p_power_gpio_port->MODER >> (power_gpio_pin * 2U)) & 0x03U, __LINE__, "ERROR: The supply-enable pin is not configured as output");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, p_power_gpio_port->ODR & BIT_POS_TO_MASK(power_gpio_pin), __LINE__, "ERROR: The sensor must be powered down after configuring the supply-enable pin");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(PORT_PARKING_SENSOR_POWER_SETTLE_MS, port_ultrasound_get_settle_remaining_ms(PORT_REAR_PARKING_SENSOR_ID), __LINE__, "ERROR: A powered down sensor must report the whole settling time");
+
+    // Power up: the sensor is not ready until it settles
+    port_ultrasound_power_on(PORT_REAR_PARKING_SENSOR_ID);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(BIT_POS_TO_MASK(power_gpio_pin), p_power_gpio_port->ODR & BIT_POS_TO_MASK(power_gpio_pin), __LINE__, "ERROR: The supply-enable pin is not high after powering up the sensor");
+    UNITY_TEST_ASSERT(port_ultrasound_get_settle_remaining_ms(PORT_REAR_PARKING_SENSOR_ID) > 0, __LINE__, "ERROR: The sensor must wait for settling right after powering up");
+
+    port_system_delay_ms(PORT_PARKING_SENSOR_POWER_SETTLE_MS + 1);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, port_ultrasound_get_settle_remaining_ms(PORT_REAR_PARKING_SENSOR_ID), __LINE__, "ERROR: The sensor must be ready after the settling time");
+
+    // Stopping the sensor powers it down
+    port_ultrasound_stop_ultrasound(PORT_REAR_PARKING_SENSOR_ID);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, p_power_gpio_port->ODR & BIT_POS_TO_MASK(power_gpio_pin), __LINE__, "ERROR: The sensor must be powered down when it is stopped");
+
+    // Restore the default configuration
+    stm32f4_ultrasound_set_new_power_gpio(PORT_REAR_PARKING_SENSOR_ID, STM32F4_REAR_PARKING_SENSOR_POWER_GPIO, STM32F4_REAR_PARKING_SENSOR_POWER_PIN);
+    RCC->AHB1ENR &= ~RCC_AHB1ENR_GPIOCEN;
+}
+
+/**
+ * @brief Test that the echo received flags of all the sensors are read at once.
+ */
+void test_echo_received_mask(void)
+{
+    port_ultrasound_reset_echo_ticks(PORT_REAR_PARKING_SENSOR_ID);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, port_ultrasound_get_echo_received_mask(), __LINE__, "ERROR: No sensor must have an echo after resetting the echo ticks");
+
+    port_ultrasound_set_echo_received(PORT_REAR_PARKING_SENSOR_ID, true);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(BIT_POS_TO_MASK(PORT_REAR_PARKING_SENSOR_ID), port_ultrasound_get_echo_received_mask(), __LINE__, "ERROR: The echo received flag of the sensor is not in its bit of the mask");
+    UNITY_TEST_ASSERT(port_ultrasound_get_echo_received(PORT_REAR_PARKING_SENSOR_ID), __LINE__, "ERROR: The echo received flag of the sensor must be set");
+
+    port_ultrasound_set_echo_received(PORT_REAR_PARKING_SENSOR_ID, false);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, port_ultrasound_get_echo_received_mask(), __LINE__, "ERROR: The echo received flag of the sensor must be cleared in the mask");
+}
+
 int main(void)
 {
     port_system_init();
@@ -760,5 +812,9 @@ int main(void)
     RUN_TEST(test_trigger_port_generalization);
     RUN_TEST(test_echo_port_generalization);
 
+    // Test power gating of the sensor
+    RUN_TEST(test_power_gating);
+    RUN_TEST(test_echo_received_mask);
+
     exit(UNITY_END());
 }
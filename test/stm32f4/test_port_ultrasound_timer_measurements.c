@@ -181,6 +181,30 @@ void test_meas_timer_timeout(void)
     UNITY_TEST_ASSERT_EQUAL_UINT32(true, trigger_ready, __LINE__, "ERROR: ULTRASOUND trigger_ready flag must be set after the measurement timer timeout");
 }
 
+void test_meas_timer_period_change(void)
+{
+    // The timer runs with the long period of the warm standby
+    port_ultrasound_init(TEST_PORT_REAR_PARKING_SENSOR_ID);
+    port_ultrasound_set_measurement_period_ms(PORT_PARKING_SENSOR_STANDBY_PERIOD_MS);
+    port_ultrasound_set_trigger_ready(TEST_PORT_REAR_PARKING_SENSOR_ID, false);
+    NVIC_ClearPendingIRQ(MEASUREMENT_TIMER_IRQ);    // Left pending by the timeout of the previous test
+    NVIC_EnableIRQ(MEASUREMENT_TIMER_IRQ);
+    MEASUREMENT_TIMER->CR1 |= TIM_CR1_CEN;
+    port_system_delay_ms(50);
+
+    // The short period applies at once, not after the rest of the long one
+    port_ultrasound_set_measurement_period_ms(PORT_PARKING_SENSOR_TIMEOUT_MS);
+    bool trigger_ready = port_ultrasound_get_trigger_ready(TEST_PORT_REAR_PARKING_SENSOR_ID);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(false, trigger_ready, __LINE__, "ERROR: Changing the period must not request a measurement");
+
+    port_system_delay_ms(PORT_PARKING_SENSOR_TIMEOUT_MS + 1);
+    NVIC_DisableIRQ(MEASUREMENT_TIMER_IRQ);
+    MEASUREMENT_TIMER->CR1 &= ~TIM_CR1_CEN;
+
+    trigger_ready = port_ultrasound_get_trigger_ready(TEST_PORT_REAR_PARKING_SENSOR_ID);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(true, trigger_ready, __LINE__, "ERROR: The new period must apply without waiting out the old one");
+}
+
 void test_start_measurement(void)
 {
     // Call configuration function to set the measurement
@@ -234,6 +258,7 @@ int main(void)
     RUN_TEST(test_meas_timer_priority);
     RUN_TEST(test_meas_timer_duration);
     RUN_TEST(test_meas_timer_timeout);
+    RUN_TEST(test_meas_timer_period_change);
 
     // Test start measurement
     RUN_TEST(test_start_measurement);
@@ -0,0 +1,182 @@
+/**
+ * @file test_can_publisher.c
+ * @brief Unit test for the CAN publisher of the distances and the state.
+ *
+ * It checks the packing of the sensors in the frames, the time to collision and the software queue in front of the mailboxes,
+ * with the CAN controller in loopback mode, using the Unity framework.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+/* System dependent libraries */
+#include <stdlib.h>
+#include <string.h>
+#include <unity.h>
+
+/* HW independent libraries */
+#include "port_system.h"
+#include "port_can.h"
+
+/* Include CAN publisher library */
+#include "can_publisher.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define TEST_NUM_SENSORS 6          /*!< Number of sensors of the tests: 2 pages of distances, 1 page of confidences @hideinitializer */
+#define TEST_NUM_FRAMES 6           /*!< Frames of a publication of all the messages (1 state, 2 distance, 1 confidence, 2 TTC) @hideinitializer */
+#define TEST_TIMEOUT_MS 20          /*!< Maximum time in ms to receive the frames sent in loopback @hideinitializer */
+#define TEST_BURST 25               /*!< Number of frames published at once to fill the queue @hideinitializer */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Move the queued frames to the mailboxes and receive the frames sent in loopback until the expected number arrives.
+ *
+ * @param p_frames  Array to store the received frames.
+ * @param num       Number of frames expected.
+ * @return uint32_t Number of frames received.
+ */
+static uint32_t _receive_frames(port_can_frame_t *p_frames, uint32_t num)
+{
+    uint32_t received = 0;
+    uint32_t start = port_system_get_millis();
+    while ((received < num) && ((port_system_get_millis() - start) < TEST_TIMEOUT_MS))
+    {
+        can_publisher_run();
+        if (port_can_receive(&p_frames[received]))
+        {
+            received++;
+        }
+    }
+    return received;
+}
+
+/**
+ * @brief Read a 2-byte field of a frame (little endian).
+ */
+static uint16_t _get_u16(const port_can_frame_t *p_frame, uint32_t offset)
+{
+    return (uint16_t)(p_frame->data[offset] | (p_frame->data[offset + 1] << 8));
+}
+
+void setUp(void)
+{
+    port_can_frame_t frame;
+    UNITY_TEST_ASSERT(can_publisher_init(TEST_NUM_SENSORS, true), __LINE__, "ERROR: The CAN controller has not started in loopback");
+    while (port_can_receive(&frame))
+    {
+        // Flush the frames of the previous test
+    }
+}
+
+void tearDown(void)
+{
+    // Nothing to do
+}
+
+void test_frames(void)
+{
+    port_can_frame_t frames[TEST_NUM_FRAMES];
+    memset(frames, 0, sizeof(frames));
+
+    for (uint32_t i = 0; i < TEST_NUM_SENSORS - 1; i++)
+    {
+        can_publisher_set_sensor(i, 100 + i, 80 + i, 0);
+    }
+    can_publisher_set_state(3);
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TEST_NUM_FRAMES, _receive_frames(frames, TEST_NUM_FRAMES), __LINE__, "ERROR: All the messages must be published in the first run");
+
+    // The mailboxes are sent in chronological order
+    UNITY_TEST_ASSERT_EQUAL_UINT32(CAN_PUBLISHER_ID_STATE, frames[0].id, __LINE__, "ERROR: The state must be published first");
+    UNITY_TEST_ASSERT_EQUAL_UINT8(8, frames[0].dlc, __LINE__, "ERROR: Wrong DLC of the state");
+    UNITY_TEST_ASSERT_EQUAL_UINT8(3, frames[0].data[0], __LINE__, "ERROR: Wrong state of the system");
+    UNITY_TEST_ASSERT_EQUAL_UINT8(TEST_NUM_SENSORS, frames[0].data[1], __LINE__, "ERROR: Wrong number of sensors");
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(CAN_PUBLISHER_ID_DISTANCE, frames[1].id, __LINE__, "ERROR: Wrong identifier of the first page of distances");
+    UNITY_TEST_ASSERT_EQUAL_UINT8(8, frames[1].dlc, __LINE__, "ERROR: A full page of distances must hold 4 sensors");
+    UNITY_TEST_ASSERT_EQUAL_UINT16(100, _get_u16(&frames[1], 0), __LINE__, "ERROR: Wrong distance of the sensor 0");
+    UNITY_TEST_ASSERT_EQUAL_UINT16(103, _get_u16(&frames[1], 6), __LINE__, "ERROR: Wrong distance of the sensor 3");
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(CAN_PUBLISHER_ID_DISTANCE + 1, frames[2].id, __LINE__, "ERROR: Wrong identifier of the second page of distances");
+    UNITY_TEST_ASSERT_EQUAL_UINT8(4, frames[2].dlc, __LINE__, "ERROR: The last page of distances must hold only the remaining sensors");
+    UNITY_TEST_ASSERT_EQUAL_UINT16(104, _get_u16(&frames[2], 0), __LINE__, "ERROR: Wrong distance of the sensor 4");
+    UNITY_TEST_ASSERT_EQUAL_UINT16(CAN_PUBLISHER_NO_VALUE, _get_u16(&frames[2], 2), __LINE__, "ERROR: A sensor without measurement must be published as no value");
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(CAN_PUBLISHER_ID_CONFIDENCE, frames[3].id, __LINE__, "ERROR: Wrong identifier of the confidences");
+    UNITY_TEST_ASSERT_EQUAL_UINT8(TEST_NUM_SENSORS, frames[3].dlc, __LINE__, "ERROR: All the confidences must fit in one frame");
+    UNITY_TEST_ASSERT_EQUAL_UINT8(84, frames[3].data[4], __LINE__, "ERROR: Wrong confidence of the sensor 4");
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(CAN_PUBLISHER_ID_TTC, frames[4].id, __LINE__, "ERROR: Wrong identifier of the first page of TTC");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(CAN_PUBLISHER_ID_TTC + 1, frames[5].id, __LINE__, "ERROR: Wrong identifier of the second page of TTC");
+    UNITY_TEST_ASSERT_EQUAL_UINT16(CAN_PUBLISHER_NO_VALUE, _get_u16(&frames[4], 0), __LINE__, "ERROR: A single measurement must not give a time to collision");
+
+    // Nothing else until the next period
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, can_publisher_run(), __LINE__, "ERROR: No message must be published before its period");
+}
+
+void test_ttc(void)
+{
+    port_can_frame_t frames[TEST_NUM_FRAMES];
+
+    can_publisher_set_period(CAN_PUBLISHER_MSG_STATE, 0);
+    can_publisher_set_period(CAN_PUBLISHER_MSG_DISTANCE, 0);
+    can_publisher_set_period(CAN_PUBLISHER_MSG_CONFIDENCE, 0);
+
+    // Approaching at 10 cm every 100 ms from 90 cm: 900 ms to the collision
+    can_publisher_set_sensor(0, 100, 100, 1000);
+    can_publisher_set_sensor(0, 90, 100, 1100);
+    // Moving away
+    can_publisher_set_sensor(1, 50, 100, 1000);
+    can_publisher_set_sensor(1, 60, 100, 1100);
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(2, _receive_frames(frames, 2), __LINE__, "ERROR: Only the pages of TTC must be published");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(CAN_PUBLISHER_ID_TTC, frames[0].id, __LINE__, "ERROR: Wrong identifier of the first page of TTC");
+    UNITY_TEST_ASSERT_EQUAL_UINT16(900 / CAN_PUBLISHER_TTC_UNIT_MS, _get_u16(&frames[0], 0), __LINE__, "ERROR: Wrong time to collision of an approaching obstacle");
+    UNITY_TEST_ASSERT_EQUAL_UINT16(CAN_PUBLISHER_NO_VALUE, _get_u16(&frames[0], 2), __LINE__, "ERROR: An obstacle moving away must not give a time to collision");
+}
+
+void test_queue(void)
+{
+    port_can_frame_t frame = {.id = 0x123, .dlc = 1, .data = {0}};
+    can_publisher_stats_t stats;
+
+    for (uint32_t msg = 0; msg < CAN_PUBLISHER_NUM_MSGS; msg++)
+    {
+        can_publisher_set_period((can_publisher_msg_t)msg, 0);
+    }
+
+    // The burst is much faster than the bus: the mailboxes and then the queue get full
+    for (uint32_t i = 0; i < TEST_BURST; i++)
+    {
+        frame.data[0] = (uint8_t)i;
+        can_publisher_publish(&frame);
+    }
+    can_publisher_get_stats(&stats);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(TEST_BURST, stats.queued + stats.dropped, __LINE__, "ERROR: Every frame must be queued or dropped");
+    UNITY_TEST_ASSERT(stats.dropped > 0, __LINE__, "ERROR: The frames that do not fit in the queue must be dropped");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(CAN_PUBLISHER_QUEUE_LEN, stats.max_depth, __LINE__, "ERROR: The queue must be filled before dropping frames");
+
+    // The queue is emptied into the mailboxes as the bus sends the frames
+    uint32_t start = port_system_get_millis();
+    while ((stats.sent < stats.queued) && ((port_system_get_millis() - start) < TEST_TIMEOUT_MS))
+    {
+        can_publisher_run();
+        while (port_can_receive(&frame))
+        {
+        }
+        can_publisher_get_stats(&stats);
+    }
+    UNITY_TEST_ASSERT_EQUAL_UINT32(stats.queued, stats.sent, __LINE__, "ERROR: All the queued frames must be sent");
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_frames);
+    RUN_TEST(test_ttc);
+    RUN_TEST(test_queue);
+
+    exit(UNITY_END());
+}
@@ -0,0 +1,131 @@
+/**
+ * @file test_dsp_kernels.c
+ * @brief Unit test for the arithmetic kernels of the per-measurement path.
+ *
+ * Each kernel is compared with its portable C reference. On the target this checks the packed SIMD implementation.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+/* System dependent libraries */
+#include <stdlib.h>
+#include <unity.h>
+
+/* HW independent libraries */
+#include "port_system.h"
+
+/* Include kernels libraries */
+#include "dsp_kernels.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define TEST_DSP_NUM_RANDOM 20000   /*!< Number of random inputs of each kernel @hideinitializer */
+#define TEST_DSP_WINDOW 5           /*!< Size of the window of the filters @hideinitializer */
+
+static uint32_t lfsr_state; /*!< State of the pseudo-random generator of the inputs */
+
+/**
+ * @brief Pseudo-random generator of the inputs (xorshift32). It is deterministic, so a failure can be reproduced.
+ *
+ * @return uint32_t Next pseudo-random value.
+ */
+static uint32_t _random(void)
+{
+    lfsr_state ^= lfsr_state << 13;
+    lfsr_state ^= lfsr_state >> 17;
+    lfsr_state ^= lfsr_state << 5;
+    return lfsr_state;
+}
+
+void setUp(void)
+{
+    lfsr_state = 0x2545F491U;
+}
+
+void tearDown(void)
+{
+    // Nothing to do
+}
+
+void test_blend_rgb(void)
+{
+    uint32_t red = DSP_RGB_PACK(255, 0, 0);
+    uint32_t yellow = DSP_RGB_PACK(94, 94, 0);
+    UNITY_TEST_ASSERT_EQUAL_HEX32(red, dsp_blend_rgb(red, yellow, 0), __LINE__, "ERROR: t = 0 must return the first color");
+    UNITY_TEST_ASSERT_EQUAL_HEX32(yellow, dsp_blend_rgb(red, yellow, 255), __LINE__, "ERROR: t = 255 must return the second color");
+    UNITY_TEST_ASSERT_EQUAL_HEX32(DSP_RGB_PACK(174, 47, 0), dsp_blend_rgb(red, yellow, 128), __LINE__, "ERROR: The levels must be blended with truncation");
+
+    for (uint32_t i = 0; i < TEST_DSP_NUM_RANDOM; i++)
+    {
+        uint32_t rgb_1 = _random() & 0xFFFFFFU;
+        uint32_t rgb_2 = _random() & 0xFFFFFFU;
+        uint8_t t = (uint8_t)_random();
+        UNITY_TEST_ASSERT_EQUAL_HEX32(dsp_blend_rgb_c(rgb_1, rgb_2, t), dsp_blend_rgb(rgb_1, rgb_2, t), __LINE__, "ERROR: The blend does not match the reference");
+    }
+}
+
+void test_echo_ticks(void)
+{
+    UNITY_TEST_ASSERT_EQUAL_UINT32(583, dsp_echo_ticks(1, 584, 0), __LINE__, "ERROR: Wrong duration of an echo within a period of the timer");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(131172, dsp_echo_ticks(100, 200, 2), __LINE__, "ERROR: Each overflow must add a period of the timer");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1168, dsp_echo_ticks(64371, 3, 1), __LINE__, "ERROR: The overflow of a wrap around between the edges must not be counted twice");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(136618, dsp_echo_ticks(60000, 10, 3), __LINE__, "ERROR: Wrong duration of an echo that wraps around with several overflows");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(636, dsp_echo_ticks(65000, 100, 0), __LINE__, "ERROR: A wrap around without its overflow counted must not underflow");
+}
+
+void test_ticks_to_cm(void)
+{
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, dsp_ticks_to_cm(58), __LINE__, "ERROR: Less than 58.3 us must be 0 cm");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, dsp_ticks_to_cm(59), __LINE__, "ERROR: 59 us must be 1 cm");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(100, dsp_ticks_to_cm(5830), __LINE__, "ERROR: 5830 us must be 100 cm");
+
+    // All the echoes of a measurement period and random ones, also above the limit of the reciprocal
+    for (uint32_t ticks = 0; ticks < 100000; ticks++)
+    {
+        UNITY_TEST_ASSERT_EQUAL_UINT32(dsp_ticks_to_cm_c(ticks), dsp_ticks_to_cm(ticks), __LINE__, "ERROR: The conversion does not match the reference");
+    }
+    for (uint32_t i = 0; i < TEST_DSP_NUM_RANDOM; i++)
+    {
+        uint32_t ticks = _random();
+        UNITY_TEST_ASSERT_EQUAL_UINT32(dsp_ticks_to_cm_c(ticks), dsp_ticks_to_cm(ticks), __LINE__, "ERROR: The conversion does not match the reference");
+    }
+}
+
+void test_median_and_mean(void)
+{
+    uint32_t window[TEST_DSP_WINDOW] = {40, 10, 50, 20, 30};
+    UNITY_TEST_ASSERT_EQUAL_UINT32(30, dsp_median_u32(window, TEST_DSP_WINDOW), __LINE__, "ERROR: Wrong median of an odd window");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(30, dsp_median_u32(window, TEST_DSP_WINDOW - 1), __LINE__, "ERROR: The median of an even window must be the mean of the central values");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(40, window[0], __LINE__, "ERROR: The median must not modify the window");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(30, dsp_mean_u32(window, TEST_DSP_WINDOW), __LINE__, "ERROR: Wrong mean of the window");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, dsp_median_u32(window, 0), __LINE__, "ERROR: The median of an empty window must be 0");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, dsp_mean_u32(window, 0), __LINE__, "ERROR: The mean of an empty window must be 0");
+
+    // Small values to force repeated ones, usual distances and values that do not fit in 16 bits
+    uint32_t masks[] = {0x3U, 0x7FFU, 0xFFFFFFFFU};
+    for (uint32_t m = 0; m < sizeof(masks) / sizeof(masks[0]); m++)
+    {
+        for (uint32_t i = 0; i < TEST_DSP_NUM_RANDOM; i++)
+        {
+            for (uint32_t k = 0; k < TEST_DSP_WINDOW; k++)
+            {
+                window[k] = _random() & masks[m];
+            }
+            UNITY_TEST_ASSERT_EQUAL_UINT32(dsp_median_u32_c(window, TEST_DSP_WINDOW), dsp_median_u32(window, TEST_DSP_WINDOW), __LINE__, "ERROR: The median does not match the reference");
+            UNITY_TEST_ASSERT_EQUAL_UINT32(dsp_mean_u32_c(window, TEST_DSP_WINDOW), dsp_mean_u32(window, TEST_DSP_WINDOW), __LINE__, "ERROR: The mean does not match the reference");
+        }
+    }
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_blend_rgb);
+    RUN_TEST(test_echo_ticks);
+    RUN_TEST(test_ticks_to_cm);
+    RUN_TEST(test_median_and_mean);
+
+    exit(UNITY_END());
+}
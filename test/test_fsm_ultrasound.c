@@ -31,6 +31,11 @@
 /* Global variables ----------------------------------------------------------*/
 static char msg[200];                      /*!< Buffer for the error messages */
 static fsm_ultrasound_t *p_fsm_ultrasound; /*!< Pointer to the ultrasound FSM */
+static ranging_result_t short_range_result; /*!< Result of the next measurement of the short-range backend of the test */
+static bool short_range_ready;             /*!< The measurement of the short-range backend of the test has completed */
+static uint32_t short_range_enables;       /*!< Number of calls to the enable of the short-range backend of the test */
+static uint32_t short_range_disables;      /*!< Number of calls to the disable of the short-range backend of the test */
+static uint32_t short_range_starts;        /*!< Number of measurements started by the short-range backend of the test */
 
 /* Private functions ---------------------------------------------------------*/
 void setUp(void)
@@ -43,6 +48,64 @@ void tearDown(void)
     // Nothing to do
 }
 
+static void _short_range_enable(uint32_t sensor_id)
+{
+    short_range_enables++;
+}
+
+static void _short_range_disable(uint32_t sensor_id)
+{
+    short_range_disables++;
+}
+
+static bool _short_range_start(uint32_t sensor_id)
+{
+    short_range_starts++;
+    return true;
+}
+
+static bool _short_range_poll(uint32_t sensor_id, ranging_result_t *p_result)
+{
+    if (!short_range_ready)
+    {
+        return false;
+    }
+    short_range_ready = false;
+    *p_result = short_range_result;
+    return true;
+}
+
+/**
+ * @brief Short-range backend of the test, whose results are set by the test.
+ */
+static const ranging_backend_t short_range_backend = {
+    .p_init = NULL,
+    .p_enable = _short_range_enable,
+    .p_disable = _short_range_disable,
+    .p_start = _short_range_start,
+    .p_poll = _short_range_poll,
+    .timeout_ms = 1000,
+};
+
+/**
+ * @brief Publish a window of echoes of the same distance.
+ *
+ * @param end_tick  Tick of the falling edge of the echoes (the rising edge is at tick 0).
+ */
+static void _publish_window(uint32_t end_tick)
+{
+    for (uint32_t i = 0; i < FSM_ULTRASOUND_NUM_MEASUREMENTS; i++)
+    {
+        fsm_ultrasound_set_state(p_fsm_ultrasound, WAIT_ECHO_END);
+
+        port_ultrasound_set_echo_received(PORT_REAR_PARKING_SENSOR_ID, true);
+        port_ultrasound_set_echo_init_tick(PORT_REAR_PARKING_SENSOR_ID, 0);
+        port_ultrasound_set_echo_end_tick(PORT_REAR_PARKING_SENSOR_ID, end_tick);
+        port_ultrasound_set_echo_overflows(PORT_REAR_PARKING_SENSOR_ID, 0);
+        fsm_ultrasound_fire(p_fsm_ultrasound);
+    }
+}
+
 /**
  * @brief Test the configuration of the ultrasound FSM.
  *
@@ -242,6 +305,357 @@ void test_stop_measurement(void)
     UNITY_TEST_ASSERT_EQUAL_UINT32(false, echo_received, __LINE__, "The echo signal should be cleared after stopping the measurement");
 }
 
+/**
+ * @brief Check that a sensor stopped in the middle of a measurement measures again when it is started.
+ *
+ */
+void test_stop_in_measurement(void)
+{
+    // Stop while waiting for the echo: the timers that would end the measurement are disabled
+    fsm_ultrasound_start(p_fsm_ultrasound);
+    fsm_ultrasound_set_state(p_fsm_ultrasound, WAIT_ECHO_END);
+    fsm_ultrasound_stop(p_fsm_ultrasound);
+    UNITY_TEST_ASSERT_EQUAL_INT(WAIT_START, fsm_ultrasound_get_state(p_fsm_ultrasound), __LINE__, "The FSM must go back to WAIT_START when the sensor is stopped");
+
+    // Start again: the first measurement is triggered
+    fsm_ultrasound_start(p_fsm_ultrasound);
+    fsm_ultrasound_fire(p_fsm_ultrasound);
+    UNITY_TEST_ASSERT_EQUAL_INT(TRIGGER_START, fsm_ultrasound_get_state(p_fsm_ultrasound), __LINE__, "The FSM must trigger a new measurement after being started again");
+
+    fsm_ultrasound_stop(p_fsm_ultrasound);
+}
+
+/**
+ * @brief Check the warm standby: low rate of measurements with the window filled, and a new median with the first measurement after leaving it.
+ *
+ */
+void test_warm_standby(void)
+{
+    uint32_t init_ticks[FSM_ULTRASOUND_NUM_MEASUREMENTS] = {1, 64371, 3, 63208, 5};
+    uint32_t end_ticks[FSM_ULTRASOUND_NUM_MEASUREMENTS] = {584, 3, 1752, 4, 2920};
+    uint32_t overflows[FSM_ULTRASOUND_NUM_MEASUREMENTS] = {0, 1, 0, 1, 0};
+    uint32_t expected_median = 30;
+
+    fsm_ultrasound_start(p_fsm_ultrasound);
+    uint32_t active_arr = MEASUREMENT_TIMER->ARR;
+
+    fsm_ultrasound_start_standby(p_fsm_ultrasound);
+    UNITY_TEST_ASSERT(fsm_ultrasound_get_status(p_fsm_ultrasound), __LINE__, "The sensor must keep measuring in warm standby");
+    UNITY_TEST_ASSERT(fsm_ultrasound_get_standby(p_fsm_ultrasound), __LINE__, "The sensor must be in warm standby");
+    UNITY_TEST_ASSERT(MEASUREMENT_TIMER->ARR > active_arr, __LINE__, "The measurement period in warm standby must be longer than the active one");
+
+    // Fill the window in warm standby
+    for (uint32_t i = 0; i < FSM_ULTRASOUND_NUM_MEASUREMENTS; i++)
+    {
+        fsm_ultrasound_set_state(p_fsm_ultrasound, WAIT_ECHO_END); // Avoids jumping to the next state
+
+        port_ultrasound_set_echo_received(PORT_REAR_PARKING_SENSOR_ID, true);
+        port_ultrasound_set_echo_init_tick(PORT_REAR_PARKING_SENSOR_ID, init_ticks[i]);
+        port_ultrasound_set_echo_end_tick(PORT_REAR_PARKING_SENSOR_ID, end_ticks[i]);
+        port_ultrasound_set_echo_overflows(PORT_REAR_PARKING_SENSOR_ID, overflows[i]);
+        fsm_ultrasound_fire(p_fsm_ultrasound);
+    }
+    UNITY_TEST_ASSERT(fsm_ultrasound_get_new_measurement_ready(p_fsm_ultrasound), __LINE__, "The median must be computed in warm standby");
+
+    // Leave the warm standby: the stale median is not published, the next measurement is triggered right away
+    port_ultrasound_set_trigger_ready(PORT_REAR_PARKING_SENSOR_ID, false);
+    fsm_ultrasound_start(p_fsm_ultrasound);
+    UNITY_TEST_ASSERT(!fsm_ultrasound_get_standby(p_fsm_ultrasound), __LINE__, "The sensor must leave the warm standby when it is started");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(active_arr, MEASUREMENT_TIMER->ARR, __LINE__, "The active measurement period must be restored after the warm standby");
+    UNITY_TEST_ASSERT(port_ultrasound_get_trigger_ready(PORT_REAR_PARKING_SENSOR_ID), __LINE__, "A new measurement must be triggered right after leaving the warm standby");
+    UNITY_TEST_ASSERT(!fsm_ultrasound_get_new_measurement_ready(p_fsm_ultrasound), __LINE__, "The median of the warm standby must not be shown as a new measurement");
+
+    // A single measurement publishes the median of the window with it
+    fsm_ultrasound_set_state(p_fsm_ultrasound, WAIT_ECHO_END);
+    port_ultrasound_set_echo_received(PORT_REAR_PARKING_SENSOR_ID, true);
+    port_ultrasound_set_echo_init_tick(PORT_REAR_PARKING_SENSOR_ID, init_ticks[2]);
+    port_ultrasound_set_echo_end_tick(PORT_REAR_PARKING_SENSOR_ID, end_ticks[2]);
+    port_ultrasound_set_echo_overflows(PORT_REAR_PARKING_SENSOR_ID, overflows[2]);
+    fsm_ultrasound_fire(p_fsm_ultrasound);
+
+    UNITY_TEST_ASSERT(fsm_ultrasound_get_new_measurement_ready(p_fsm_ultrasound), __LINE__, "The first measurement after the warm standby must publish a new median");
+    UNITY_TEST_ASSERT_INT_WITHIN(1, expected_median, fsm_ultrasound_get_distance(p_fsm_ultrasound), __LINE__, "ERROR: Wrong median after leaving the warm standby");
+
+    fsm_ultrasound_stop(p_fsm_ultrasound);
+}
+
+void test_snapshot_restore(void)
+{
+    uint32_t init_ticks[FSM_ULTRASOUND_NUM_MEASUREMENTS] = {1, 64371, 3, 63208, 5};
+    uint32_t end_ticks[FSM_ULTRASOUND_NUM_MEASUREMENTS] = {584, 3, 1752, 4, 2920};
+    uint32_t overflows[FSM_ULTRASOUND_NUM_MEASUREMENTS] = {0, 1, 0, 1, 0};
+    uint32_t expected_median = 30;
+    fsm_ultrasound_snapshot_t snapshot;
+
+    // Fill the window
+    fsm_ultrasound_start(p_fsm_ultrasound);
+    for (uint32_t i = 0; i < FSM_ULTRASOUND_NUM_MEASUREMENTS; i++)
+    {
+        fsm_ultrasound_set_state(p_fsm_ultrasound, WAIT_ECHO_END);
+
+        port_ultrasound_set_echo_received(PORT_REAR_PARKING_SENSOR_ID, true);
+        port_ultrasound_set_echo_init_tick(PORT_REAR_PARKING_SENSOR_ID, init_ticks[i]);
+        port_ultrasound_set_echo_end_tick(PORT_REAR_PARKING_SENSOR_ID, end_ticks[i]);
+        port_ultrasound_set_echo_overflows(PORT_REAR_PARKING_SENSOR_ID, overflows[i]);
+        fsm_ultrasound_fire(p_fsm_ultrasound);
+    }
+    fsm_ultrasound_save(p_fsm_ultrasound, &snapshot);
+    UNITY_TEST_ASSERT(snapshot.status, __LINE__, "The snapshot must record that the sensor is measuring");
+    UNITY_TEST_ASSERT(snapshot.window_full, __LINE__, "The snapshot must record that the window is full");
+
+    // A new FSM (as after a reset) resumes with the window of the snapshot
+    fsm_ultrasound_stop(p_fsm_ultrasound);
+    fsm_ultrasound_destroy(p_fsm_ultrasound);
+    p_fsm_ultrasound = fsm_ultrasound_new(PORT_REAR_PARKING_SENSOR_ID);
+    fsm_ultrasound_restore(p_fsm_ultrasound, &snapshot, true);
+    UNITY_TEST_ASSERT(fsm_ultrasound_get_status(p_fsm_ultrasound), __LINE__, "The sensor must be measuring after restoring the snapshot");
+    UNITY_TEST_ASSERT(!fsm_ultrasound_get_new_measurement_ready(p_fsm_ultrasound), __LINE__, "The median of the snapshot must not be shown as a new measurement");
+
+    // The median of the restored window is published once a majority of it is new, not with the first measurement
+    for (uint32_t i = 0; i < FSM_ULTRASOUND_RESTORE_NEW_MEASUREMENTS; i++)
+    {
+        UNITY_TEST_ASSERT(!fsm_ultrasound_get_new_measurement_ready(p_fsm_ultrasound), __LINE__, "The restored window must not be published before a majority of it is new");
+
+        fsm_ultrasound_set_state(p_fsm_ultrasound, WAIT_ECHO_END);
+        port_ultrasound_set_echo_received(PORT_REAR_PARKING_SENSOR_ID, true);
+        port_ultrasound_set_echo_init_tick(PORT_REAR_PARKING_SENSOR_ID, init_ticks[2]);
+        port_ultrasound_set_echo_end_tick(PORT_REAR_PARKING_SENSOR_ID, end_ticks[2]);
+        port_ultrasound_set_echo_overflows(PORT_REAR_PARKING_SENSOR_ID, overflows[2]);
+        fsm_ultrasound_fire(p_fsm_ultrasound);
+    }
+
+    UNITY_TEST_ASSERT(fsm_ultrasound_get_new_measurement_ready(p_fsm_ultrasound), __LINE__, "The restored window must be published once a majority of it is new");
+    UNITY_TEST_ASSERT_INT_WITHIN(1, expected_median, fsm_ultrasound_get_distance(p_fsm_ultrasound), __LINE__, "ERROR: Wrong median after restoring the snapshot");
+
+    fsm_ultrasound_stop(p_fsm_ultrasound);
+}
+
+/**
+ * @brief Check that an outdated snapshot (e.g., after a power-on reset) resumes the sensor with an empty window.
+ *
+ */
+void test_snapshot_restore_outdated(void)
+{
+    fsm_ultrasound_snapshot_t snapshot;
+
+    // Snapshot of a full window of 10 cm
+    fsm_ultrasound_start(p_fsm_ultrasound);
+    for (uint32_t i = 0; i < FSM_ULTRASOUND_NUM_MEASUREMENTS; i++)
+    {
+        fsm_ultrasound_set_state(p_fsm_ultrasound, WAIT_ECHO_END);
+
+        port_ultrasound_set_echo_received(PORT_REAR_PARKING_SENSOR_ID, true);
+        port_ultrasound_set_echo_init_tick(PORT_REAR_PARKING_SENSOR_ID, 0);
+        port_ultrasound_set_echo_end_tick(PORT_REAR_PARKING_SENSOR_ID, 584);
+        port_ultrasound_set_echo_overflows(PORT_REAR_PARKING_SENSOR_ID, 0);
+        fsm_ultrasound_fire(p_fsm_ultrasound);
+    }
+    fsm_ultrasound_save(p_fsm_ultrasound, &snapshot);
+
+    fsm_ultrasound_stop(p_fsm_ultrasound);
+    fsm_ultrasound_destroy(p_fsm_ultrasound);
+    p_fsm_ultrasound = fsm_ultrasound_new(PORT_REAR_PARKING_SENSOR_ID);
+    fsm_ultrasound_restore(p_fsm_ultrasound, &snapshot, false);
+    UNITY_TEST_ASSERT(fsm_ultrasound_get_status(p_fsm_ultrasound), __LINE__, "The sensor must be measuring after restoring the snapshot");
+
+    // Only a whole window of new distances (50 cm) is published
+    for (uint32_t i = 0; i < FSM_ULTRASOUND_NUM_MEASUREMENTS; i++)
+    {
+        UNITY_TEST_ASSERT(!fsm_ultrasound_get_new_measurement_ready(p_fsm_ultrasound), __LINE__, "The distances of an outdated snapshot must not be published");
+
+        fsm_ultrasound_set_state(p_fsm_ultrasound, WAIT_ECHO_END);
+        port_ultrasound_set_echo_received(PORT_REAR_PARKING_SENSOR_ID, true);
+        port_ultrasound_set_echo_init_tick(PORT_REAR_PARKING_SENSOR_ID, 0);
+        port_ultrasound_set_echo_end_tick(PORT_REAR_PARKING_SENSOR_ID, 2920);
+        port_ultrasound_set_echo_overflows(PORT_REAR_PARKING_SENSOR_ID, 0);
+        fsm_ultrasound_fire(p_fsm_ultrasound);
+    }
+
+    UNITY_TEST_ASSERT(fsm_ultrasound_get_new_measurement_ready(p_fsm_ultrasound), __LINE__, "A whole window of new distances must be published");
+    UNITY_TEST_ASSERT_INT_WITHIN(1, 50, fsm_ultrasound_get_distance(p_fsm_ultrasound), __LINE__, "ERROR: The median must only hold new distances");
+
+    fsm_ultrasound_stop(p_fsm_ultrasound);
+}
+
+/**
+ * @brief Check the queue of measurements: every median published is kept with its time until it is read, oldest first,
+ * and the ones published while the queue is full are counted as overruns.
+ *
+ */
+void test_measurement_queue(void)
+{
+    uint32_t num_windows = FSM_ULTRASOUND_QUEUE_LEN + 2;
+    fsm_ultrasound_measurement_t measurements[FSM_ULTRASOUND_QUEUE_LEN + 2];
+
+    // Publish a window per distance (10 cm, 20 cm, ...) without reading them
+    fsm_ultrasound_start(p_fsm_ultrasound);
+    for (uint32_t w = 0; w < num_windows; w++)
+    {
+        for (uint32_t i = 0; i < FSM_ULTRASOUND_NUM_MEASUREMENTS; i++)
+        {
+            fsm_ultrasound_set_state(p_fsm_ultrasound, WAIT_ECHO_END);
+
+            port_ultrasound_set_echo_received(PORT_REAR_PARKING_SENSOR_ID, true);
+            port_ultrasound_set_echo_init_tick(PORT_REAR_PARKING_SENSOR_ID, 0);
+            port_ultrasound_set_echo_end_tick(PORT_REAR_PARKING_SENSOR_ID, 584 * (w + 1)); // 10 cm per window
+            port_ultrasound_set_echo_overflows(PORT_REAR_PARKING_SENSOR_ID, 0);
+            fsm_ultrasound_fire(p_fsm_ultrasound);
+        }
+        port_system_delay_ms(1);
+    }
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(FSM_ULTRASOUND_QUEUE_LEN, fsm_ultrasound_get_num_measurements(p_fsm_ultrasound), __LINE__, "The queue must hold the measurements that have not been read, up to its length");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(num_windows - FSM_ULTRASOUND_QUEUE_LEN, fsm_ultrasound_get_overruns(p_fsm_ultrasound), __LINE__, "The measurements published while the queue is full must be counted as overruns");
+
+    // Read in two batches: the oldest measurements come first, and the queued ones are never overwritten
+    uint32_t num = fsm_ultrasound_read_measurements(p_fsm_ultrasound, measurements, 3);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(3, num, __LINE__, "A batch read must stop at the size of the array");
+    num += fsm_ultrasound_read_measurements(p_fsm_ultrasound, &measurements[num], num_windows);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(FSM_ULTRASOUND_QUEUE_LEN, num, __LINE__, "A batch read must return all the queued measurements");
+    UNITY_TEST_ASSERT(!fsm_ultrasound_get_new_measurement_ready(p_fsm_ultrasound), __LINE__, "There must be no new measurement after reading the whole queue");
+
+    for (uint32_t i = 0; i < num; i++)
+    {
+        sprintf(msg, "ERROR: Wrong distance of the measurement %ld of the queue", i);
+        UNITY_TEST_ASSERT_INT_WITHIN(1, 10 * (i + 1), measurements[i].distance_cm, __LINE__, msg);
+        UNITY_TEST_ASSERT_EQUAL_UINT32(100, measurements[i].confidence_pct, __LINE__, "A window of equal distances must have full confidence");
+        if (i > 0)
+        {
+            UNITY_TEST_ASSERT(measurements[i].timestamp_ms > measurements[i - 1].timestamp_ms, __LINE__, "The measurements must be timestamped when they are published");
+        }
+    }
+
+    fsm_ultrasound_stop(p_fsm_ultrasound);
+}
+
+/**
+ * @brief Check that the warm standby, whose distances are not read, keeps the newest ones in the queue without counting overruns.
+ *
+ */
+void test_measurement_queue_standby(void)
+{
+    uint32_t num_windows = FSM_ULTRASOUND_QUEUE_LEN + 2;
+    fsm_ultrasound_measurement_t measurement;
+
+    fsm_ultrasound_start_standby(p_fsm_ultrasound);
+    for (uint32_t w = 0; w < num_windows; w++)
+    {
+        for (uint32_t i = 0; i < FSM_ULTRASOUND_NUM_MEASUREMENTS; i++)
+        {
+            fsm_ultrasound_set_state(p_fsm_ultrasound, WAIT_ECHO_END);
+
+            port_ultrasound_set_echo_received(PORT_REAR_PARKING_SENSOR_ID, true);
+            port_ultrasound_set_echo_init_tick(PORT_REAR_PARKING_SENSOR_ID, 0);
+            port_ultrasound_set_echo_end_tick(PORT_REAR_PARKING_SENSOR_ID, 584 * (w + 1)); // 10 cm per window
+            port_ultrasound_set_echo_overflows(PORT_REAR_PARKING_SENSOR_ID, 0);
+            fsm_ultrasound_fire(p_fsm_ultrasound);
+        }
+    }
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, fsm_ultrasound_get_overruns(p_fsm_ultrasound), __LINE__, "The distances of the warm standby must not be counted as overruns");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(FSM_ULTRASOUND_QUEUE_LEN, fsm_ultrasound_get_num_measurements(p_fsm_ultrasound), __LINE__, "The queue must stay full in the warm standby");
+
+    // The oldest distances have been replaced by the newest ones
+    fsm_ultrasound_read_measurements(p_fsm_ultrasound, &measurement, 1);
+    UNITY_TEST_ASSERT_INT_WITHIN(1, 10 * (num_windows - FSM_ULTRASOUND_QUEUE_LEN + 1), measurement.distance_cm, __LINE__, "ERROR: The warm standby must replace the oldest distance of the queue");
+
+    fsm_ultrasound_stop(p_fsm_ultrasound);
+}
+
+/**
+ * @brief Check that the measurements queued before a stop, and their overruns, do not survive until the next start.
+ *
+ */
+void test_measurement_queue_stop(void)
+{
+    uint32_t num_windows = FSM_ULTRASOUND_QUEUE_LEN + 1;
+
+    fsm_ultrasound_start(p_fsm_ultrasound);
+    for (uint32_t w = 0; w < num_windows; w++)
+    {
+        for (uint32_t i = 0; i < FSM_ULTRASOUND_NUM_MEASUREMENTS; i++)
+        {
+            fsm_ultrasound_set_state(p_fsm_ultrasound, WAIT_ECHO_END);
+
+            port_ultrasound_set_echo_received(PORT_REAR_PARKING_SENSOR_ID, true);
+            port_ultrasound_set_echo_init_tick(PORT_REAR_PARKING_SENSOR_ID, 0);
+            port_ultrasound_set_echo_end_tick(PORT_REAR_PARKING_SENSOR_ID, 584 * (w + 1)); // 10 cm per window
+            port_ultrasound_set_echo_overflows(PORT_REAR_PARKING_SENSOR_ID, 0);
+            fsm_ultrasound_fire(p_fsm_ultrasound);
+        }
+    }
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, fsm_ultrasound_get_overruns(p_fsm_ultrasound), __LINE__, "The window published while the queue is full must be counted as an overrun");
+
+    fsm_ultrasound_stop(p_fsm_ultrasound);
+    fsm_ultrasound_start(p_fsm_ultrasound);
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, fsm_ultrasound_get_num_measurements(p_fsm_ultrasound), __LINE__, "The measurements of the previous run must be flushed when the sensor is stopped");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, fsm_ultrasound_get_overruns(p_fsm_ultrasound), __LINE__, "The overruns of the previous run must be reset when the sensor is stopped");
+    UNITY_TEST_ASSERT(!fsm_ultrasound_get_new_measurement_ready(p_fsm_ultrasound), __LINE__, "There must be no new measurement after a new start");
+
+    fsm_ultrasound_stop(p_fsm_ultrasound);
+}
+
+/**
+ * @brief Check that the short-range device only measures while the distance is within the short range, and that its results are published.
+ *
+ */
+void test_short_range(void)
+{
+    ranging_device_t device;
+    fsm_ultrasound_measurement_t measurement;
+    uint32_t distance_cm, confidence_pct, timestamp_ms;
+
+    ranging_init(&device, &short_range_backend, 0);
+    fsm_ultrasound_set_short_range(p_fsm_ultrasound, &device);
+    fsm_ultrasound_start(p_fsm_ultrasound);
+
+    // Far: only the ultrasound sensor measures
+    _publish_window(5840); // 100 cm
+    fsm_ultrasound_fire(p_fsm_ultrasound);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, short_range_enables, __LINE__, "The short-range device must not be enabled out of the short range");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, short_range_starts, __LINE__, "The short-range device must not measure out of the short range");
+
+    // Within the short range: the device is enabled and measures with the same fire that publishes the distance
+    _publish_window(1168); // 20 cm
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, short_range_enables, __LINE__, "The short-range device must be enabled when the distance enters the short range");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, short_range_starts, __LINE__, "The short-range device must start a measurement when it is enabled");
+    while (fsm_ultrasound_read_measurements(p_fsm_ultrasound, &measurement, 1) > 0) {}
+
+    // A result within the short range is published with its confidence, and the next measurement is started
+    short_range_result.distance_cm = 12;
+    short_range_result.confidence_pct = 90;
+    short_range_ready = true;
+    fsm_ultrasound_fire(p_fsm_ultrasound);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, fsm_ultrasound_read_measurements(p_fsm_ultrasound, &measurement, 1), __LINE__, "The result of the short-range device must be published");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(12, measurement.distance_cm, __LINE__, "ERROR: Wrong distance of the short-range device");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(90, measurement.confidence_pct, __LINE__, "ERROR: The result of the short-range device must keep its confidence");
+    UNITY_TEST_ASSERT(fsm_ultrasound_get_measurement(p_fsm_ultrasound, &distance_cm, &confidence_pct, &timestamp_ms), __LINE__, "There must be a last distance");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(12, distance_cm, __LINE__, "ERROR: The result of the short-range device must be the last distance");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(90, confidence_pct, __LINE__, "ERROR: The last distance must keep the confidence of the short-range device");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(2, short_range_starts, __LINE__, "The short-range device must measure continuously");
+
+    // Results without confidence or out of the short range are not published
+    short_range_result.distance_cm = 0;
+    short_range_result.confidence_pct = 0;
+    short_range_ready = true;
+    fsm_ultrasound_fire(p_fsm_ultrasound);
+    short_range_result.distance_cm = FSM_ULTRASOUND_SHORT_RANGE_CM + 10;
+    short_range_result.confidence_pct = 100;
+    short_range_ready = true;
+    fsm_ultrasound_fire(p_fsm_ultrasound);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, fsm_ultrasound_get_num_measurements(p_fsm_ultrasound), __LINE__, "The results without confidence or out of the short range must not be published");
+
+    // Far again: the device is disabled
+    _publish_window(5840); // 100 cm
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, short_range_disables, __LINE__, "The short-range device must be disabled when the distance leaves the short range");
+
+    // Stop within the short range: the device is disabled
+    _publish_window(1168); // 20 cm
+    fsm_ultrasound_stop(p_fsm_ultrasound);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(2, short_range_disables, __LINE__, "The short-range device must be disabled when the sensor stops");
+}
+
 int main(void)
 {
     port_system_init();
@@ -253,5 +667,13 @@ int main(void)
     RUN_TEST(test_echo_received_and_distance);
     RUN_TEST(test_new_measurement);
     RUN_TEST(test_stop_measurement);
+    RUN_TEST(test_stop_in_measurement);
+    RUN_TEST(test_warm_standby);
+    RUN_TEST(test_snapshot_restore);
+    RUN_TEST(test_snapshot_restore_outdated);
+    RUN_TEST(test_measurement_queue);
+    RUN_TEST(test_measurement_queue_standby);
+    RUN_TEST(test_measurement_queue_stop);
+    RUN_TEST(test_short_range);
     exit(UNITY_END());
 }
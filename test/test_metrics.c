@@ -0,0 +1,102 @@
+/**
+ * @file test_metrics.c
+ * @brief Unit test for the metrics registry.
+ *
+ * The tests are ignored when the project is built without `USE_METRICS`.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+/* System dependent libraries */
+#include <stdlib.h>
+#include <unity.h>
+
+/* HW independent libraries */
+#include "port_system.h"
+
+/* Include metrics libraries */
+#include "metrics.h"
+
+static uint32_t visited_metrics; /*!< Number of metrics visited by `metrics_for_each()` */
+
+void setUp(void)
+{
+#ifndef USE_METRICS
+    TEST_IGNORE_MESSAGE("Metrics compiled out. Build with -DUSE_METRICS=true");
+#endif
+    metrics_reset();
+    visited_metrics = 0;
+}
+
+void tearDown(void)
+{
+    // Nothing to do
+}
+
+#ifdef USE_METRICS
+static void _count_visitor(const metrics_entry_t *p_entry, void *p_ctx)
+{
+    UNITY_TEST_ASSERT_EQUAL_INT(visited_metrics, p_entry->id, __LINE__, "The metrics are not visited in the order of metrics_id_t");
+    visited_metrics++;
+    *(uint32_t *)p_ctx += p_entry->value;
+}
+#endif
+
+void test_counter_and_gauge(void)
+{
+    metrics_counter_inc(METRIC_ULTRASOUND_MEASUREMENTS);
+    metrics_counter_add(METRIC_ULTRASOUND_MEASUREMENTS, 2);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(3, metrics_get_value(METRIC_ULTRASOUND_MEASUREMENTS), __LINE__, "The counter does not accumulate the events");
+
+    metrics_gauge_set(METRIC_ULTRASOUND_DISTANCE_CM, 40);
+    metrics_gauge_set(METRIC_ULTRASOUND_DISTANCE_CM, 25);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(25, metrics_get_value(METRIC_ULTRASOUND_DISTANCE_CM), __LINE__, "The gauge does not keep the last value");
+
+    metrics_reset();
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, metrics_get_value(METRIC_ULTRASOUND_MEASUREMENTS), __LINE__, "The counter is not cleared by metrics_reset()");
+}
+
+void test_histogram(void)
+{
+#ifdef USE_METRICS
+    metrics_histogram_record(METRIC_BUTTON_PRESS_MS, 10);     // 10 >> 6 = 0 -> bucket 0
+    metrics_histogram_record(METRIC_BUTTON_PRESS_MS, 200);    // 200 >> 6 = 3 -> bucket 2
+    metrics_histogram_record(METRIC_BUTTON_PRESS_MS, 100000); // Saturates in the last bucket
+    UNITY_TEST_ASSERT_EQUAL_UINT32(3, metrics_get_value(METRIC_BUTTON_PRESS_MS), __LINE__, "The histogram does not count its samples");
+
+    uint32_t total = 0;
+    metrics_for_each(_count_visitor, &total);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(METRICS_NUM_METRICS, visited_metrics, __LINE__, "metrics_for_each() does not visit every metric");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(3, total, __LINE__, "metrics_for_each() does not report the values of the metrics");
+#endif
+}
+
+void test_quantiles(void)
+{
+#ifdef USE_METRICS
+    for (uint32_t i = 1; i <= 1000; i++)
+    {
+        metrics_quantile_record(METRIC_ULTRASOUND_DISTANCE_Q, i);
+    }
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1000, metrics_get_value(METRIC_ULTRASOUND_DISTANCE_Q), __LINE__, "The quantile metric does not count its samples");
+    UNITY_TEST_ASSERT_UINT32_WITHIN(20, 500, metrics_get_quantile(METRIC_ULTRASOUND_DISTANCE_Q, 0), __LINE__, "The median is not estimated");
+    UNITY_TEST_ASSERT_UINT32_WITHIN(20, 900, metrics_get_quantile(METRIC_ULTRASOUND_DISTANCE_Q, 1), __LINE__, "The p90 is not estimated");
+    UNITY_TEST_ASSERT_UINT32_WITHIN(10, 990, metrics_get_quantile(METRIC_ULTRASOUND_DISTANCE_Q, 2), __LINE__, "The p99 is not estimated");
+
+    metrics_reset();
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, metrics_get_quantile(METRIC_ULTRASOUND_DISTANCE_Q, 0), __LINE__, "The quantiles are not cleared by metrics_reset()");
+#endif
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_counter_and_gauge);
+    RUN_TEST(test_histogram);
+    RUN_TEST(test_quantiles);
+
+    exit(UNITY_END());
+}
@@ -0,0 +1,171 @@
+/**
+ * @file test_pt_ultrasound.c
+ * @brief Unit test for the protothreads and the ranging cycle of the ultrasound sensors on them.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+/* System dependent libraries */
+#include <stdlib.h>
+#include <unity.h>
+
+/* HW independent libraries */
+#include "port_ultrasound.h"
+#include "port_system.h"
+
+/* Include protothread libraries */
+#include "pt.h"
+#include "pt_ultrasound.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define PORT_REAR_PARKING_SENSOR_ID 0 /*!< Ultrasound identifier @hideinitializer */
+
+/* Global variables ----------------------------------------------------------*/
+static pt_ultrasound_t pt_ultrasound;  /*!< Ultrasound ranged by a protothread */
+
+/**
+ * @brief Context of the protothread of the test of the primitives.
+ */
+typedef struct
+{
+    pt_t pt;            /*!< Context of the protothread */
+    bool go;            /*!< Condition of the wait */
+    uint32_t steps;     /*!< Number of steps executed */
+} test_pt_t;
+
+/* Private functions ---------------------------------------------------------*/
+/**
+ * @brief Protothread of the test of the primitives: step, wait, step, yield, step, end.
+ */
+static PT_THREAD(_test_thread(test_pt_t *p_ctx))
+{
+    PT_BEGIN(&p_ctx->pt);
+
+    p_ctx->steps++;
+    PT_WAIT_UNTIL(&p_ctx->pt, p_ctx->go);
+    p_ctx->steps++;
+    PT_YIELD(&p_ctx->pt);
+    p_ctx->steps++;
+
+    PT_END(&p_ctx->pt);
+}
+
+/**
+ * @brief Simulate the trigger and the echo of a measurement, resuming the cycle after each event, until the next trigger.
+ *
+ * @param init_tick Tick of the rising edge of the echo.
+ * @param end_tick  Tick of the falling edge of the echo.
+ * @param overflows Number of overflows of the echo timer.
+ */
+static void _echo(uint32_t init_tick, uint32_t end_tick, uint32_t overflows)
+{
+    port_ultrasound_set_trigger_end(PORT_REAR_PARKING_SENSOR_ID, true);
+    pt_ultrasound_run(&pt_ultrasound);
+
+    port_ultrasound_set_echo_init_tick(PORT_REAR_PARKING_SENSOR_ID, init_tick);
+    pt_ultrasound_run(&pt_ultrasound);
+
+    port_ultrasound_set_echo_end_tick(PORT_REAR_PARKING_SENSOR_ID, end_tick);
+    port_ultrasound_set_echo_overflows(PORT_REAR_PARKING_SENSOR_ID, overflows);
+    port_ultrasound_set_echo_received(PORT_REAR_PARKING_SENSOR_ID, true);
+    pt_ultrasound_run(&pt_ultrasound);
+
+    // Next measurement period
+    port_ultrasound_set_trigger_ready(PORT_REAR_PARKING_SENSOR_ID, true);
+    pt_ultrasound_run(&pt_ultrasound);
+}
+
+void setUp(void)
+{
+    pt_ultrasound_init(&pt_ultrasound, PORT_REAR_PARKING_SENSOR_ID);
+}
+
+void tearDown(void)
+{
+    pt_ultrasound_stop(&pt_ultrasound);
+}
+
+void test_primitives(void)
+{
+    test_pt_t ctx = {.go = false, .steps = 0};
+    PT_INIT(&ctx.pt);
+
+    UNITY_TEST_ASSERT_EQUAL_INT(PT_WAITING, _test_thread(&ctx), __LINE__, "ERROR: The protothread must block in the wait");
+    UNITY_TEST_ASSERT_EQUAL_INT(PT_WAITING, _test_thread(&ctx), __LINE__, "ERROR: The protothread must stay blocked while the condition is false");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, ctx.steps, __LINE__, "ERROR: The resume must not execute again the steps before the wait");
+
+    ctx.go = true;
+    UNITY_TEST_ASSERT_EQUAL_INT(PT_YIELDED, _test_thread(&ctx), __LINE__, "ERROR: The protothread must continue after the wait and yield");
+    UNITY_TEST_ASSERT_EQUAL_INT(PT_ENDED, _test_thread(&ctx), __LINE__, "ERROR: The protothread must continue after the yield and end");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(3, ctx.steps, __LINE__, "ERROR: Wrong number of steps of the protothread");
+
+    // It starts again after the end
+    UNITY_TEST_ASSERT_EQUAL_INT(PT_YIELDED, _test_thread(&ctx), __LINE__, "ERROR: The protothread must start again after its end");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(5, ctx.steps, __LINE__, "ERROR: The protothread must start from the beginning after its end");
+}
+
+void test_trigger(void)
+{
+    // Stopped: the cycle does not trigger
+    port_ultrasound_set_trigger_ready(PORT_REAR_PARKING_SENSOR_ID, true);
+    UNITY_TEST_ASSERT_EQUAL_INT(PT_WAITING, pt_ultrasound_run(&pt_ultrasound), __LINE__, "ERROR: The cycle must wait for the start of the sensor");
+    UNITY_TEST_ASSERT(port_ultrasound_get_trigger_ready(PORT_REAR_PARKING_SENSOR_ID), __LINE__, "ERROR: The cycle must not trigger a stopped sensor");
+
+    pt_ultrasound_start(&pt_ultrasound);
+    pt_ultrasound_run(&pt_ultrasound);
+    UNITY_TEST_ASSERT(!port_ultrasound_get_trigger_ready(PORT_REAR_PARKING_SENSOR_ID), __LINE__, "ERROR: The cycle must trigger a measurement after the start");
+
+    port_ultrasound_set_trigger_end(PORT_REAR_PARKING_SENSOR_ID, true);
+    pt_ultrasound_run(&pt_ultrasound);
+    UNITY_TEST_ASSERT(!port_ultrasound_get_trigger_end(PORT_REAR_PARKING_SENSOR_ID), __LINE__, "ERROR: The cycle must clear the end of the trigger signal");
+}
+
+void test_echo_and_distance(void)
+{
+    uint32_t init_ticks[FSM_ULTRASOUND_NUM_MEASUREMENTS] = {1, 64371, 3, 63208, 5};
+    uint32_t end_ticks[FSM_ULTRASOUND_NUM_MEASUREMENTS] = {584, 3, 1752, 4, 2920};
+    uint32_t overflows[FSM_ULTRASOUND_NUM_MEASUREMENTS] = {0, 1, 0, 1, 0};
+    uint32_t expected_median = 30;
+
+    pt_ultrasound_start(&pt_ultrasound);
+    pt_ultrasound_run(&pt_ultrasound);
+
+    for (uint32_t i = 0; i < FSM_ULTRASOUND_NUM_MEASUREMENTS; i++)
+    {
+        UNITY_TEST_ASSERT(!pt_ultrasound_get_new_measurement_ready(&pt_ultrasound), __LINE__, "ERROR: The median must not be computed before the window is full");
+        _echo(init_ticks[i], end_ticks[i], overflows[i]);
+        UNITY_TEST_ASSERT(!port_ultrasound_get_echo_received(PORT_REAR_PARKING_SENSOR_ID), __LINE__, "ERROR: The echo must be cleared after computing its distance");
+    }
+
+    UNITY_TEST_ASSERT(pt_ultrasound_get_new_measurement_ready(&pt_ultrasound), __LINE__, "ERROR: The median must be computed when the window is full");
+    UNITY_TEST_ASSERT_INT_WITHIN(1, expected_median, pt_ultrasound_get_distance(&pt_ultrasound), __LINE__, "ERROR: Wrong median of the window of distances");
+    UNITY_TEST_ASSERT(!pt_ultrasound_get_new_measurement_ready(&pt_ultrasound), __LINE__, "ERROR: Getting the distance must clear the flag of new measurement");
+}
+
+void test_stop(void)
+{
+    pt_ultrasound_start(&pt_ultrasound);
+    pt_ultrasound_run(&pt_ultrasound);
+
+    // Stopped while waiting for an echo that will not arrive: the next start begins with a new trigger
+    pt_ultrasound_stop(&pt_ultrasound);
+    UNITY_TEST_ASSERT(!pt_ultrasound_get_status(&pt_ultrasound), __LINE__, "ERROR: The sensor must be stopped");
+
+    pt_ultrasound_start(&pt_ultrasound);
+    pt_ultrasound_run(&pt_ultrasound);
+    UNITY_TEST_ASSERT(!port_ultrasound_get_trigger_ready(PORT_REAR_PARKING_SENSOR_ID), __LINE__, "ERROR: The cycle must trigger again after a stop and a start");
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_primitives);
+    RUN_TEST(test_trigger);
+    RUN_TEST(test_echo_and_distance);
+    RUN_TEST(test_stop);
+
+    exit(UNITY_END());
+}
@@ -0,0 +1,231 @@
+/**
+ * @file test_ranging.c
+ * @brief Unit test for the generic ranging interface and its ultrasound and ToF backends.
+ *
+ * The generic logic (busy device, timeout, NULL entries) is checked with a backend of the test. The ultrasound backend is
+ * driven through the setters of the port, as the ISRs would do. The ToF backend only needs the sensor for the measurements.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+/* System dependent libraries */
+#include <stdlib.h>
+#include <unity.h>
+
+/* HW independent libraries */
+#include "port_ultrasound.h"
+#include "port_tof.h"
+#include "port_system.h"
+
+/* Include ranging libraries */
+#include "ranging.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define PORT_REAR_PARKING_SENSOR_ID 0   /*!< Ultrasound identifier @hideinitializer */
+#define TEST_TIMEOUT_MS 5U              /*!< Timeout of the backend of the test @hideinitializer */
+
+/* Global variables ----------------------------------------------------------*/
+static ranging_device_t device;     /*!< Device under test */
+static bool test_ready;             /*!< The measurement of the backend of the test has completed */
+static uint32_t test_starts;        /*!< Number of measurements started by the backend of the test */
+static uint32_t test_disables;      /*!< Number of calls to the disable of the backend of the test */
+
+/* Private functions ---------------------------------------------------------*/
+static bool _test_start(uint32_t sensor_id)
+{
+    (void)sensor_id;
+    test_starts++;
+    return true;
+}
+
+static bool _test_poll(uint32_t sensor_id, ranging_result_t *p_result)
+{
+    (void)sensor_id;
+    if (!test_ready)
+    {
+        return false;
+    }
+    p_result->distance_cm = 123;
+    p_result->confidence_pct = 80;
+    return true;
+}
+
+static void _test_disable(uint32_t sensor_id)
+{
+    (void)sensor_id;
+    test_disables++;
+}
+
+/**
+ * @brief Backend of the test: only start, poll and disable.
+ */
+static const ranging_backend_t test_backend = {
+    .p_init = NULL,
+    .p_enable = NULL,
+    .p_disable = _test_disable,
+    .p_start = _test_start,
+    .p_poll = _test_poll,
+    .timeout_ms = TEST_TIMEOUT_MS,
+};
+
+/**
+ * @brief Simulate the echo of a measurement of the ultrasound sensor.
+ *
+ * @param init_tick Tick of the rising edge of the echo.
+ * @param end_tick  Tick of the falling edge of the echo.
+ */
+static void _echo(uint32_t init_tick, uint32_t end_tick)
+{
+    port_ultrasound_set_echo_init_tick(PORT_REAR_PARKING_SENSOR_ID, init_tick);
+    port_ultrasound_set_echo_end_tick(PORT_REAR_PARKING_SENSOR_ID, end_tick);
+    port_ultrasound_set_echo_overflows(PORT_REAR_PARKING_SENSOR_ID, 0);
+    port_ultrasound_set_echo_received(PORT_REAR_PARKING_SENSOR_ID, true);
+}
+
+/**
+ * @brief Enable the ultrasound device and wait for its sensor to settle.
+ */
+static void _enable_ultrasound(void)
+{
+    ranging_init(&device, &ranging_ultrasound_backend, PORT_REAR_PARKING_SENSOR_ID);
+    ranging_enable(&device);
+    port_system_delay_ms(port_ultrasound_get_settle_remaining_ms(PORT_REAR_PARKING_SENSOR_ID));
+    while (port_ultrasound_get_settle_remaining_ms(PORT_REAR_PARKING_SENSOR_ID) > 0)
+    {
+        // Wait for the sensor to settle
+    }
+}
+
+void setUp(void)
+{
+    test_ready = false;
+    test_starts = 0;
+    test_disables = 0;
+}
+
+void tearDown(void)
+{
+    if (device.p_backend != NULL)
+    {
+        ranging_disable(&device);
+    }
+}
+
+void test_generic(void)
+{
+    ranging_result_t result;
+    ranging_init(&device, &test_backend, 0);
+
+    UNITY_TEST_ASSERT(!ranging_start(&device), __LINE__, "ERROR: A disabled device must not start a measurement");
+    ranging_enable(&device);
+    UNITY_TEST_ASSERT(!ranging_get_result(&device, &result), __LINE__, "ERROR: A device without measurements must not have a result");
+
+    UNITY_TEST_ASSERT(ranging_start(&device), __LINE__, "ERROR: An enabled device must start a measurement");
+    UNITY_TEST_ASSERT(ranging_get_busy(&device), __LINE__, "ERROR: The device must be busy during the measurement");
+    UNITY_TEST_ASSERT(!ranging_start(&device), __LINE__, "ERROR: A busy device must not start another measurement");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, test_starts, __LINE__, "ERROR: The backend must start one measurement");
+    UNITY_TEST_ASSERT(!ranging_poll(&device), __LINE__, "ERROR: The poll must not complete a measurement in progress");
+
+    test_ready = true;
+    uint32_t before_ms = port_system_get_millis();
+    UNITY_TEST_ASSERT(ranging_poll(&device), __LINE__, "ERROR: The poll must complete a finished measurement");
+    UNITY_TEST_ASSERT(!ranging_get_busy(&device), __LINE__, "ERROR: The device must not be busy after the measurement");
+    UNITY_TEST_ASSERT(!ranging_poll(&device), __LINE__, "ERROR: A measurement must complete only once");
+    UNITY_TEST_ASSERT(ranging_get_result(&device, &result), __LINE__, "ERROR: The device must have a result");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(123, result.distance_cm, __LINE__, "ERROR: Wrong distance of the result");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(80, ranging_get_confidence_pct(&device), __LINE__, "ERROR: Wrong confidence of the result");
+    UNITY_TEST_ASSERT(result.timestamp_ms >= before_ms, __LINE__, "ERROR: The result must be timestamped when it completes");
+}
+
+void test_timeout(void)
+{
+    ranging_init(&device, &test_backend, 0);
+    ranging_enable(&device);
+    ranging_start(&device);
+
+    port_system_delay_ms(TEST_TIMEOUT_MS + 1);
+    UNITY_TEST_ASSERT(ranging_poll(&device), __LINE__, "ERROR: A measurement must complete at its timeout");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, ranging_get_confidence_pct(&device), __LINE__, "ERROR: A measurement that times out must have confidence 0");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, test_disables, __LINE__, "ERROR: A measurement that times out must be aborted");
+    UNITY_TEST_ASSERT(ranging_start(&device), __LINE__, "ERROR: The device must measure again after a timeout");
+}
+
+void test_ultrasound(void)
+{
+    _enable_ultrasound();
+
+    UNITY_TEST_ASSERT(ranging_start(&device), __LINE__, "ERROR: The ultrasound device must trigger when the sensor is ready");
+    UNITY_TEST_ASSERT(!port_ultrasound_get_trigger_ready(PORT_REAR_PARKING_SENSOR_ID), __LINE__, "ERROR: The start must trigger the sensor");
+
+    port_ultrasound_set_trigger_end(PORT_REAR_PARKING_SENSOR_ID, true);
+    UNITY_TEST_ASSERT(!ranging_poll(&device), __LINE__, "ERROR: The measurement must not complete before the echo");
+    UNITY_TEST_ASSERT(!port_ultrasound_get_trigger_end(PORT_REAR_PARKING_SENSOR_ID), __LINE__, "ERROR: The poll must clear the end of the trigger signal");
+
+    // 1750 us: 30 cm
+    _echo(2, 1752);
+    UNITY_TEST_ASSERT(ranging_poll(&device), __LINE__, "ERROR: The measurement must complete with the echo");
+    UNITY_TEST_ASSERT_INT_WITHIN(1, 30, ranging_get_distance_cm(&device), __LINE__, "ERROR: Wrong distance of the echo");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(RANGING_CONFIDENCE_MAX, ranging_get_confidence_pct(&device), __LINE__, "ERROR: An echo in range must have full confidence");
+    UNITY_TEST_ASSERT(!port_ultrasound_get_echo_received(PORT_REAR_PARKING_SENSOR_ID), __LINE__, "ERROR: The echo must be cleared after computing its distance");
+
+    // The next trigger waits for the measurement period
+    UNITY_TEST_ASSERT(!ranging_start(&device), __LINE__, "ERROR: The device must not trigger before the next measurement period");
+    port_ultrasound_set_trigger_ready(PORT_REAR_PARKING_SENSOR_ID, true);
+    UNITY_TEST_ASSERT(ranging_start(&device), __LINE__, "ERROR: The device must trigger in the next measurement period");
+
+    // 30000 us: 514 cm, out of range
+    _echo(1, 30001);
+    UNITY_TEST_ASSERT(ranging_poll(&device), __LINE__, "ERROR: The measurement must complete with the echo");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, ranging_get_confidence_pct(&device), __LINE__, "ERROR: An echo out of range must have confidence 0");
+}
+
+void test_ultrasound_no_echo(void)
+{
+    _enable_ultrasound();
+    ranging_start(&device);
+
+    // A whole measurement period without echo
+    port_ultrasound_set_trigger_ready(PORT_REAR_PARKING_SENSOR_ID, true);
+    UNITY_TEST_ASSERT(ranging_poll(&device), __LINE__, "ERROR: The measurement must complete at the next period without echo");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, ranging_get_confidence_pct(&device), __LINE__, "ERROR: A measurement without echo must have confidence 0");
+}
+
+void test_tof(void)
+{
+    ranging_init(&device, &ranging_tof_backend, PORT_REAR_TOF_SENSOR_ID);
+    ranging_enable(&device);
+    if (!ranging_start(&device))
+    {
+        TEST_IGNORE_MESSAGE("The ToF sensor is not connected");
+    }
+
+    while (!ranging_poll(&device))
+    {
+        // Ranging and transfers of the bus
+    }
+    if (port_tof_get_range_valid(PORT_REAR_TOF_SENSOR_ID))
+    {
+        UNITY_TEST_ASSERT_EQUAL_UINT32((port_tof_get_distance_mm(PORT_REAR_TOF_SENSOR_ID) + 5) / 10, ranging_get_distance_cm(&device), __LINE__, "ERROR: The distance of the ToF sensor must be rounded to cm");
+        UNITY_TEST_ASSERT(ranging_get_confidence_pct(&device) > 0, __LINE__, "ERROR: A valid range must have confidence");
+    }
+    else
+    {
+        UNITY_TEST_ASSERT_EQUAL_UINT32(0, ranging_get_confidence_pct(&device), __LINE__, "ERROR: An invalid range must have confidence 0");
+    }
+    UNITY_TEST_ASSERT(!port_tof_get_measurement_ready(PORT_REAR_TOF_SENSOR_ID), __LINE__, "ERROR: The poll must clear the measurement ready flag");
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_generic);
+    RUN_TEST(test_timeout);
+    RUN_TEST(test_ultrasound);
+    RUN_TEST(test_ultrasound_no_echo);
+    RUN_TEST(test_tof);
+
+    exit(UNITY_END());
+}
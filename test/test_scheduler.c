@@ -0,0 +1,151 @@
+/**
+ * @file test_scheduler.c
+ * @brief Unit test for the cooperative earliest-deadline-first scheduler.
+ *
+ * It checks the order of execution of the tasks, the release of the periodic tasks and the detection of the deadline misses using the Unity framework.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+/* System dependent libraries */
+#include <stdlib.h>
+#include <unity.h>
+
+/* HW independent libraries */
+#include "port_system.h"
+
+/* Include scheduler library */
+#include "scheduler.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define TEST_MAX_RUNS 16        /*!< Maximum number of executions recorded by a test @hideinitializer */
+#define TEST_PERIOD_MS 50       /*!< Period of the periodic tasks of the tests @hideinitializer */
+
+/* Global variables */
+static uint32_t runs_arr[TEST_MAX_RUNS];   /*!< Identifiers of the executed tasks, in order of execution */
+static uint32_t num_runs;                   /*!< Number of executions recorded */
+
+/* Private functions ----------------------------------------------------------*/
+/**
+ * @brief Job that records its identifier (stored in the context) in the list of executions.
+ *
+ * @param p_ctx Pointer to the identifier of the task.
+ */
+static void _job_record(void *p_ctx)
+{
+    if (num_runs < TEST_MAX_RUNS)
+    {
+        runs_arr[num_runs++] = *(uint32_t *)p_ctx;
+    }
+}
+
+/**
+ * @brief Job that takes longer than its deadline.
+ *
+ * @param p_ctx Pointer to the execution time in ms.
+ */
+static void _job_slow(void *p_ctx)
+{
+    port_system_delay_ms(*(uint32_t *)p_ctx);
+}
+
+void setUp(void)
+{
+    scheduler_init();
+    num_runs = 0;
+}
+
+void tearDown(void)
+{
+    // Nothing to do
+}
+
+void test_edf_order(void)
+{
+    static uint32_t ids[] = {0, 1, 2, 3};
+    scheduler_add_task("late", _job_record, &ids[0], 0, 20);
+    scheduler_add_task("early", _job_record, &ids[1], 0, 5);
+    scheduler_add_task("middle", _job_record, &ids[2], 0, 10);
+    scheduler_add_task("middle_tie", _job_record, &ids[3], 0, 10);
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(4, scheduler_run_round(), __LINE__, "ERROR: Every task with period 0 must run once per round");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, runs_arr[0], __LINE__, "ERROR: The task with the earliest deadline must run first");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(2, runs_arr[1], __LINE__, "ERROR: The tasks must run in order of deadline");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(3, runs_arr[2], __LINE__, "ERROR: In case of a tie, the task added first must run first");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, runs_arr[3], __LINE__, "ERROR: The task with the latest deadline must run last");
+
+    UNITY_TEST_ASSERT(scheduler_run_next(), __LINE__, "ERROR: A new round must start when no task is released");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, runs_arr[4], __LINE__, "ERROR: The new round must start with the earliest deadline");
+}
+
+void test_periodic_release(void)
+{
+    static uint32_t ids[] = {0, 1};
+    scheduler_add_task("fsm", _job_record, &ids[0], 0, 5);
+    int32_t job_id = scheduler_add_task("job", _job_record, &ids[1], TEST_PERIOD_MS, 0);
+
+    // The job is released when it is added, and it runs after the FSM because of its later deadline
+    UNITY_TEST_ASSERT_EQUAL_UINT32(2, scheduler_run_round(), __LINE__, "ERROR: The periodic task must be released when it is added");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, runs_arr[0], __LINE__, "ERROR: The FSM with a tighter deadline must run before the background job");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, runs_arr[1], __LINE__, "ERROR: The background job must run after the FSM");
+
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, scheduler_run_round(), __LINE__, "ERROR: The periodic task must not run before its period");
+
+    port_system_delay_ms(TEST_PERIOD_MS);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(2, scheduler_run_round(), __LINE__, "ERROR: The periodic task must be released every period");
+
+    scheduler_stats_t stats = {0};
+    scheduler_get_stats(job_id, &stats);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(2, stats.runs, __LINE__, "ERROR: Wrong number of executions of the periodic task");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, stats.misses, __LINE__, "ERROR: The periodic task must not miss its deadline");
+}
+
+void test_deadline_miss(void)
+{
+    static uint32_t exec_ms = 10;
+    static uint32_t id = 0;
+    int32_t slow_id = scheduler_add_task("slow", _job_slow, &exec_ms, 0, 2);
+    int32_t fast_id = scheduler_add_task("fast", _job_record, &id, 0, 50);
+
+    scheduler_run_round();
+
+    scheduler_stats_t stats = {0};
+    scheduler_get_stats(slow_id, &stats);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, stats.misses, __LINE__, "ERROR: A task that completes after its deadline must record a miss");
+    UNITY_TEST_ASSERT(stats.max_lateness_ms >= exec_ms - 2, __LINE__, "ERROR: Wrong lateness of the deadline miss");
+    UNITY_TEST_ASSERT(stats.max_exec_ms >= exec_ms, __LINE__, "ERROR: Wrong execution time of the task");
+
+    scheduler_get_stats(fast_id, &stats);
+    UNITY_TEST_ASSERT_EQUAL_UINT32(0, stats.misses, __LINE__, "ERROR: A task that completes before its deadline must not record a miss");
+    UNITY_TEST_ASSERT_EQUAL_UINT32(1, scheduler_get_total_misses(), __LINE__, "ERROR: Wrong total number of deadline misses");
+}
+
+void test_invalid_tasks(void)
+{
+    static uint32_t id = 0;
+    UNITY_TEST_ASSERT_EQUAL_INT32(SCHEDULER_INVALID_TASK_ID, scheduler_add_task("null", NULL, NULL, 0, 5), __LINE__, "ERROR: A task without function must be rejected");
+    UNITY_TEST_ASSERT_EQUAL_INT32(SCHEDULER_INVALID_TASK_ID, scheduler_add_task("no_deadline", _job_record, &id, 0, 0), __LINE__, "ERROR: A task without period nor deadline must be rejected");
+
+    for (uint32_t i = 0; i < SCHEDULER_MAX_TASKS; i++)
+    {
+        UNITY_TEST_ASSERT_EQUAL_INT32((int32_t)i, scheduler_add_task("task", _job_record, &id, TEST_PERIOD_MS, 0), __LINE__, "ERROR: Wrong identifier of a new task");
+    }
+    UNITY_TEST_ASSERT_EQUAL_INT32(SCHEDULER_INVALID_TASK_ID, scheduler_add_task("full", _job_record, &id, TEST_PERIOD_MS, 0), __LINE__, "ERROR: A task must be rejected when the scheduler is full");
+
+    scheduler_init();
+    UNITY_TEST_ASSERT(!scheduler_run_next(), __LINE__, "ERROR: An empty scheduler must not run any task");
+}
+
+int main(void)
+{
+    port_system_init();
+    UNITY_BEGIN();
+
+    RUN_TEST(test_edf_order);
+    RUN_TEST(test_periodic_release);
+    RUN_TEST(test_deadline_miss);
+    RUN_TEST(test_invalid_tasks);
+
+    exit(UNITY_END());
+}
@@ -0,0 +1,180 @@
+/**
+ * @file acoustic_model.h
+ * @brief Header for acoustic_model.c file. Physics-based model of the echoes of the ultrasound sensors on the host.
+ *
+ * The model computes the width of the echo pulse of an HC-SR04-like sensor from the geometry of a scene. The sensor reports the
+ * first arrival whose amplitude is over its detection threshold, so the width is not always the round trip of the nearest
+ * obstacle:
+ * - Direct echoes of the obstacles: round trip at the speed of sound of the air temperature, amplitude from the reflectivity of the
+ *   material, the directivity of the beam (bearing of the obstacle), the specular loss of a tilted surface (incidence), the
+ *   spreading of the wave and the absorption of the air.
+ * - Multipath: sensor, obstacle, second obstacle and back. It is detected when the direct echoes are weak (ghost distances).
+ * - Ground: the backscatter of the ground in the lower part of the beam (clutter at a fixed slant range), and the echoes of the
+ *   obstacles that bounce on the ground on the way back.
+ * - Interference: the bursts of other sensors (of the same car or of another one) heard during the listening window, which give
+ *   echoes shorter than the real one.
+ * - Jitter: Gaussian noise on the arrival time, from a seeded generator so the sequences are reproducible.
+ *
+ * The amplitudes are relative to the echo of a perfect reflector facing the sensor on its axis at 1 m.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef ACOUSTIC_MODEL_H_
+#define ACOUSTIC_MODEL_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define ACOUSTIC_MODEL_MAX_OBSTACLES 8      /*!<    Maximum number of obstacles of a scene */
+#define ACOUSTIC_MODEL_MAX_INTERFERERS 4    /*!<    Maximum number of foreign sensors of a scene */
+
+/* Enums */
+/**
+ * @brief Origin of a detected echo.
+ */
+typedef enum
+{
+    ACOUSTIC_ECHO_NONE = 0,         /*!<    No arrival over the threshold: the sensor times out */
+    ACOUSTIC_ECHO_DIRECT,           /*!<    Direct echo of an obstacle */
+    ACOUSTIC_ECHO_MULTIPATH,        /*!<    Echo through 2 obstacles */
+    ACOUSTIC_ECHO_GROUND,           /*!<    Backscatter of the ground */
+    ACOUSTIC_ECHO_GROUND_BOUNCE,    /*!<    Echo of an obstacle that bounces on the ground */
+    ACOUSTIC_ECHO_INTERFERENCE,     /*!<    Burst of a foreign sensor */
+} acoustic_echo_source_t;
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Obstacle of a scene, in the horizontal plane of the sensor.
+ */
+typedef struct
+{
+    double distance_m;      /*!<    Distance from the sensor to the obstacle */
+    double bearing_deg;     /*!<    Angle of the obstacle off the axis of the sensor */
+    double incidence_deg;   /*!<    Angle between the normal of the surface and the line to the sensor (0: facing the sensor) */
+    double reflectivity;    /*!<    Fraction of the pressure reflected: ~0.95 concrete or metal, ~0.6 plastic, ~0.1 foam or fabric */
+    double roughness;       /*!<    Fraction of the reflection that is diffuse (0: mirror, 1: scatters in all directions) */
+} acoustic_obstacle_t;
+
+/**
+ * @brief Foreign sensor that emits bursts heard by the sensor.
+ */
+typedef struct
+{
+    double period_us;       /*!<    Period of its bursts */
+    double phase_us;        /*!<    Time of its first burst */
+    double distance_m;      /*!<    Length of the path from the foreign sensor to the sensor */
+    double amplitude;       /*!<    Amplitude of its burst at 1 m, directivities included */
+} acoustic_interferer_t;
+
+/**
+ * @brief Parameters of the sensor.
+ */
+typedef struct
+{
+    double beam_half_angle_deg; /*!<    Angle off the axis where the round-trip amplitude is halved (-6 dB) */
+    double threshold;           /*!<    Minimum amplitude of a detected arrival */
+    double height_m;            /*!<    Height of the sensor over the ground */
+    double tilt_deg;            /*!<    Angle of the axis over the horizontal (positive: pointing up) */
+    double blind_us;            /*!<    Time after the burst while the transducer rings and arrivals are not detected */
+    double burst_us;            /*!<    Time from the end of the trigger to the rising edge of the echo pin */
+    double timeout_us;          /*!<    Width of the echo pulse when nothing is detected */
+} acoustic_sensor_t;
+
+/**
+ * @brief Scene seen by a sensor.
+ */
+typedef struct
+{
+    double temperature_c;                                           /*!<    Temperature of the air */
+    double absorption_db_m;                                         /*!<    Absorption of the air at the frequency of the sensor */
+    double ground_reflectivity;                                     /*!<    Reflectivity of the ground (0: no ground reflections) */
+    double ground_backscatter;                                      /*!<    Fraction of the ground reflection scattered back to the sensor */
+    double jitter_us;                                               /*!<    Standard deviation of the noise of the arrival times */
+    uint32_t num_obstacles;                                         /*!<    Number of obstacles */
+    acoustic_obstacle_t obstacles[ACOUSTIC_MODEL_MAX_OBSTACLES];    /*!<    Obstacles */
+    uint32_t num_interferers;                                       /*!<    Number of foreign sensors */
+    acoustic_interferer_t interferers[ACOUSTIC_MODEL_MAX_INTERFERERS]; /*!< Foreign sensors */
+} acoustic_scene_t;
+
+/**
+ * @brief Echo reported by the sensor for a trigger.
+ */
+typedef struct
+{
+    double width_us;                    /*!<    Width of the echo pulse */
+    double amplitude;                   /*!<    Amplitude of the detected arrival (0 if none) */
+    acoustic_echo_source_t source;      /*!<    Origin of the detected arrival */
+    uint32_t index;                     /*!<    Obstacle (direct, multipath, ground bounce) or foreign sensor of the arrival */
+} acoustic_echo_t;
+
+/**
+ * @brief State of a model: the scene, the sensor and the generator of the noise.
+ */
+typedef struct
+{
+    acoustic_scene_t scene;     /*!<    Scene. It can be changed between triggers */
+    acoustic_sensor_t sensor;   /*!<    Sensor */
+    uint64_t rng;               /*!<    State of the generator of the noise */
+} acoustic_model_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Initialize a model with an HC-SR04 sensor (15 deg beam, 0.08 threshold, 0.5 m high, horizontal) and an empty scene at
+ * 20 degC with the absorption of 40 kHz and an asphalt ground.
+ *
+ * @param p_model       Pointer to the model.
+ * @param seed          Seed of the noise. The same seed gives the same sequence of echoes.
+ */
+void acoustic_model_init(acoustic_model_t *p_model, uint64_t seed);
+
+/**
+ * @brief Add an obstacle to the scene.
+ *
+ * @param p_model       Pointer to the model.
+ * @param p_obstacle    Pointer to the obstacle.
+ * @retval true if added, false if the scene is full.
+ */
+bool acoustic_model_add_obstacle(acoustic_model_t *p_model, const acoustic_obstacle_t *p_obstacle);
+
+/**
+ * @brief Add a foreign sensor to the scene.
+ *
+ * @param p_model       Pointer to the model.
+ * @param p_interferer  Pointer to the foreign sensor.
+ * @retval true if added, false if the scene is full.
+ */
+bool acoustic_model_add_interferer(acoustic_model_t *p_model, const acoustic_interferer_t *p_interferer);
+
+/**
+ * @brief Speed of sound in the air.
+ *
+ * @param temperature_c Temperature of the air.
+ * @return double       Speed in m/s.
+ */
+double acoustic_model_speed_of_sound(double temperature_c);
+
+/**
+ * @brief Compute the echo of a trigger.
+ *
+ * @param p_model       Pointer to the model. Its noise generator advances.
+ * @param trigger_us    Time of the end of the trigger, in the time base of the foreign sensors.
+ * @return acoustic_echo_t Echo reported by the sensor.
+ */
+acoustic_echo_t acoustic_model_echo(acoustic_model_t *p_model, double trigger_us);
+
+/**
+ * @brief Get the name of an origin of an echo, for the reports.
+ *
+ * @param source        Origin.
+ * @return const char*  Name.
+ */
+const char *acoustic_model_source_name(acoustic_echo_source_t source);
+
+#endif /* ACOUSTIC_MODEL_H_ */
@@ -0,0 +1,74 @@
+/**
+ * @file acoustic_model_stm32f4.h
+ * @brief Header for acoustic_model_stm32f4.c file. Connects the acoustic model to the pins of the host register model of the STM32F4.
+ *
+ * Each sensor is a pair of pins of the board: when the firmware ends a trigger pulse (falling edge of the trigger pin), the
+ * acoustic model of the sensor computes the echo and its pulse is scheduled on the echo pin, so it goes through the input
+ * capture of the echo timer and the ISRs of the port as on the target.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef ACOUSTIC_MODEL_STM32F4_H_
+#define ACOUSTIC_MODEL_STM32F4_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Project includes */
+#include "acoustic_model.h"
+#include "stm32f4_model.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define ACOUSTIC_MODEL_STM32F4_MAX_SENSORS 4    /*!<    Maximum number of sensors connected to the board */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Sensor connected to the board.
+ */
+typedef struct
+{
+    acoustic_model_t *p_model;      /*!<    Acoustic model of the sensor. The test can change its scene between triggers */
+    GPIO_TypeDef *p_trigger_port;   /*!<    Port of the trigger pin */
+    uint8_t trigger_pin;            /*!<    Trigger pin */
+    GPIO_TypeDef *p_echo_port;      /*!<    Port of the echo pin */
+    uint8_t echo_pin;               /*!<    Echo pin */
+} acoustic_model_stm32f4_sensor_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Connect sensors to the board. It replaces the pin callback of the register model.
+ *
+ * @param p_sensors     Array of sensors. It is copied.
+ * @param num_sensors   Number of sensors.
+ * @retval true if connected, false if there are too many sensors.
+ */
+bool acoustic_model_stm32f4_attach(const acoustic_model_stm32f4_sensor_t *p_sensors, uint32_t num_sensors);
+
+/**
+ * @brief Disconnect the sensors and remove the pin callback.
+ */
+void acoustic_model_stm32f4_detach(void);
+
+/**
+ * @brief Last echo sent by a sensor.
+ *
+ * @param idx           Index of the sensor in the array of `acoustic_model_stm32f4_attach()`.
+ * @param p_echo        Pointer that receives the echo.
+ * @retval true if the sensor has been triggered since it was connected.
+ */
+bool acoustic_model_stm32f4_get_last_echo(uint32_t idx, acoustic_echo_t *p_echo);
+
+/**
+ * @brief Number of triggers received by a sensor since it was connected.
+ *
+ * @param idx           Index of the sensor.
+ * @return uint32_t     Number of triggers.
+ */
+uint32_t acoustic_model_stm32f4_get_triggers(uint32_t idx);
+
+#endif /* ACOUSTIC_MODEL_STM32F4_H_ */
@@ -0,0 +1,305 @@
+/**
+ * @file acoustic_model.c
+ * @brief Physics-based model of the echoes of the ultrasound sensors on the host.
+ *
+ * All the arrivals of a trigger are computed (direct, multipath, ground and interference) and the earliest one over the
+ * threshold, after the ringing of the transducer, is the echo reported by the sensor.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <math.h>
+#include <stddef.h>
+
+/* Project includes */
+#include "acoustic_model.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define ACOUSTIC_MODEL_PI 3.14159265358979323846   /*!<    Pi */
+#define ACOUSTIC_MODEL_DIFFUSE_GAIN 0.3             /*!<    Amplitude of a fully diffuse reflection relative to a mirror facing the sensor */
+#define ACOUSTIC_MODEL_MULTIPATH_GAIN 0.5           /*!<    Loss of the oblique reflections of a multipath arrival */
+#define ACOUSTIC_MODEL_GROUND_STEP_M 0.01           /*!<    Step of the search of the ground clutter along the slant range */
+#define ACOUSTIC_MODEL_US_PER_S 1e6                 /*!<    Microseconds per second */
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Degrees to radians.
+ */
+static double _rad(double deg)
+{
+    return deg * ACOUSTIC_MODEL_PI / 180.0;
+}
+
+/**
+ * @brief One-way directivity of the transducer at an angle off its axis. The round trip (squared) is halved at the half angle.
+ */
+static double _directivity(const acoustic_sensor_t *p_sensor, double off_axis_deg)
+{
+    double ratio = off_axis_deg / p_sensor->beam_half_angle_deg;
+    return pow(0.5, 0.5 * ratio * ratio);
+}
+
+/**
+ * @brief Directivity of a direction given by its horizontal bearing and its elevation over the horizontal.
+ */
+static double _directivity_2d(const acoustic_sensor_t *p_sensor, double bearing_deg, double elevation_deg)
+{
+    double vertical_deg = elevation_deg - p_sensor->tilt_deg;
+    return _directivity(p_sensor, sqrt(bearing_deg * bearing_deg + vertical_deg * vertical_deg));
+}
+
+/**
+ * @brief Loss of spreading and absorption along an acoustic path, relative to the round trip of 1 m.
+ */
+static double _path_gain(const acoustic_scene_t *p_scene, double path_m)
+{
+    return (2.0 / path_m) * pow(10.0, -p_scene->absorption_db_m * (path_m - 2.0) / 20.0);
+}
+
+/**
+ * @brief Fraction of the reflection of an obstacle that returns to the sensor: the mirror part is lost when the surface is
+ * tilted out of the beam, the diffuse part falls off with the cosine of the incidence.
+ */
+static double _surface_gain(const acoustic_sensor_t *p_sensor, const acoustic_obstacle_t *p_obstacle)
+{
+    double mirror = _directivity(p_sensor, 2.0 * p_obstacle->incidence_deg);
+    double diffuse = ACOUSTIC_MODEL_DIFFUSE_GAIN * cos(_rad(p_obstacle->incidence_deg));
+    return (1.0 - p_obstacle->roughness) * mirror * mirror + p_obstacle->roughness * ((diffuse > 0.0) ? diffuse : 0.0);
+}
+
+/**
+ * @brief Uniform random number in (0, 1] (xorshift64*).
+ */
+static double _uniform(acoustic_model_t *p_model)
+{
+    p_model->rng ^= p_model->rng >> 12;
+    p_model->rng ^= p_model->rng << 25;
+    p_model->rng ^= p_model->rng >> 27;
+    uint64_t value = p_model->rng * 0x2545F4914F6CDD1DULL;
+    return ((double)(value >> 11) + 1.0) / 9007199254740992.0;
+}
+
+/**
+ * @brief Gaussian random number with zero mean and unit variance (Box-Muller).
+ */
+static double _gaussian(acoustic_model_t *p_model)
+{
+    double u1 = _uniform(p_model);
+    double u2 = _uniform(p_model);
+    return sqrt(-2.0 * log(u1)) * cos(2.0 * ACOUSTIC_MODEL_PI * u2);
+}
+
+/**
+ * @brief Keep an arrival if it is detectable and earlier than the best one so far.
+ */
+static void _arrival(const acoustic_sensor_t *p_sensor, acoustic_echo_t *p_best, double time_us, double amplitude,
+                     acoustic_echo_source_t source, uint32_t index)
+{
+    if ((amplitude < p_sensor->threshold) || (time_us < p_sensor->blind_us) || (time_us > p_sensor->timeout_us))
+    {
+        return;
+    }
+    if ((p_best->source == ACOUSTIC_ECHO_NONE) || (time_us < p_best->width_us))
+    {
+        p_best->width_us = time_us;
+        p_best->amplitude = amplitude;
+        p_best->source = source;
+        p_best->index = index;
+    }
+}
+
+/**
+ * @brief Earliest detectable backscatter of the ground: the slant range grows from the foot of the sensor until the ground in
+ * the beam is loud enough.
+ */
+static void _ground_clutter(const acoustic_model_t *p_model, acoustic_echo_t *p_best, double speed_m_s)
+{
+    const acoustic_scene_t *p_scene = &p_model->scene;
+    const acoustic_sensor_t *p_sensor = &p_model->sensor;
+    double gain = p_scene->ground_reflectivity * p_scene->ground_backscatter;
+    if ((gain <= 0.0) || (p_sensor->height_m <= 0.0))
+    {
+        return;
+    }
+    double max_range_m = p_sensor->timeout_us * speed_m_s / (2.0 * ACOUSTIC_MODEL_US_PER_S);
+    for (double range_m = p_sensor->height_m; range_m <= max_range_m; range_m += ACOUSTIC_MODEL_GROUND_STEP_M)
+    {
+        double elevation_deg = -asin(p_sensor->height_m / range_m) * 180.0 / ACOUSTIC_MODEL_PI;
+        double d = _directivity_2d(p_sensor, 0.0, elevation_deg);
+        double amplitude = gain * d * d * _path_gain(p_scene, 2.0 * range_m);
+        double time_us = 2.0 * range_m / speed_m_s * ACOUSTIC_MODEL_US_PER_S;
+        if ((amplitude >= p_sensor->threshold) && (time_us >= p_sensor->blind_us))
+        {
+            _arrival(p_sensor, p_best, time_us, amplitude, ACOUSTIC_ECHO_GROUND, 0);
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Earliest detectable burst of each foreign sensor in the listening window.
+ */
+static void _interference(const acoustic_model_t *p_model, acoustic_echo_t *p_best, double emission_us, double speed_m_s)
+{
+    const acoustic_scene_t *p_scene = &p_model->scene;
+    const acoustic_sensor_t *p_sensor = &p_model->sensor;
+    for (uint32_t i = 0; i < p_scene->num_interferers; i++)
+    {
+        const acoustic_interferer_t *p_foreign = &p_scene->interferers[i];
+        if (p_foreign->period_us <= 0.0)
+        {
+            continue;
+        }
+        double flight_us = p_foreign->distance_m / speed_m_s * ACOUSTIC_MODEL_US_PER_S;
+        double amplitude = p_foreign->amplitude / p_foreign->distance_m * pow(10.0, -p_scene->absorption_db_m * (p_foreign->distance_m - 1.0) / 20.0);
+        double first_us = emission_us + p_sensor->blind_us;
+        double k = ceil((first_us - flight_us - p_foreign->phase_us) / p_foreign->period_us);
+        double arrival_us = p_foreign->phase_us + ((k > 0.0) ? k : 0.0) * p_foreign->period_us + flight_us;
+        _arrival(p_sensor, p_best, arrival_us - emission_us, amplitude, ACOUSTIC_ECHO_INTERFERENCE, i);
+    }
+}
+
+/* Public functions -----------------------------------------------------------*/
+void acoustic_model_init(acoustic_model_t *p_model, uint64_t seed)
+{
+    if (p_model == NULL)
+    {
+        return;
+    }
+    p_model->scene = (acoustic_scene_t){
+        .temperature_c = 20.0,
+        .absorption_db_m = 1.3,
+        .ground_reflectivity = 0.9,
+        .ground_backscatter = 0.05,
+        .jitter_us = 0.0,
+    };
+    p_model->sensor = (acoustic_sensor_t){
+        .beam_half_angle_deg = 15.0,
+        .threshold = 0.08,
+        .height_m = 0.5,
+        .tilt_deg = 0.0,
+        .blind_us = 120.0,
+        .burst_us = 250.0,
+        .timeout_us = 38000.0,
+    };
+    p_model->rng = (seed != 0) ? seed : 0x9E3779B97F4A7C15ULL; /* xorshift needs a state different from 0 */
+}
+
+bool acoustic_model_add_obstacle(acoustic_model_t *p_model, const acoustic_obstacle_t *p_obstacle)
+{
+    if ((p_model == NULL) || (p_obstacle == NULL) || (p_model->scene.num_obstacles >= ACOUSTIC_MODEL_MAX_OBSTACLES))
+    {
+        return false;
+    }
+    p_model->scene.obstacles[p_model->scene.num_obstacles++] = *p_obstacle;
+    return true;
+}
+
+bool acoustic_model_add_interferer(acoustic_model_t *p_model, const acoustic_interferer_t *p_interferer)
+{
+    if ((p_model == NULL) || (p_interferer == NULL) || (p_model->scene.num_interferers >= ACOUSTIC_MODEL_MAX_INTERFERERS))
+    {
+        return false;
+    }
+    p_model->scene.interferers[p_model->scene.num_interferers++] = *p_interferer;
+    return true;
+}
+
+double acoustic_model_speed_of_sound(double temperature_c)
+{
+    return 331.3 * sqrt(1.0 + temperature_c / 273.15);
+}
+
+acoustic_echo_t acoustic_model_echo(acoustic_model_t *p_model, double trigger_us)
+{
+    acoustic_echo_t best = {.width_us = 0.0, .amplitude = 0.0, .source = ACOUSTIC_ECHO_NONE, .index = 0};
+    if (p_model == NULL)
+    {
+        return best;
+    }
+    const acoustic_scene_t *p_scene = &p_model->scene;
+    const acoustic_sensor_t *p_sensor = &p_model->sensor;
+    double speed_m_s = acoustic_model_speed_of_sound(p_scene->temperature_c);
+    double us_per_m = ACOUSTIC_MODEL_US_PER_S / speed_m_s;
+
+    for (uint32_t i = 0; i < p_scene->num_obstacles; i++)
+    {
+        const acoustic_obstacle_t *p_obstacle = &p_scene->obstacles[i];
+        double surface = p_obstacle->reflectivity * _surface_gain(p_sensor, p_obstacle);
+        double d_direct = _directivity_2d(p_sensor, p_obstacle->bearing_deg, 0.0);
+
+        /* Direct echo */
+        double path_m = 2.0 * p_obstacle->distance_m;
+        _arrival(p_sensor, &best, path_m * us_per_m, surface * d_direct * d_direct * _path_gain(p_scene, path_m), ACOUSTIC_ECHO_DIRECT, i);
+
+        /* Echo that bounces on the ground on one way: the image of the sensor is 2 heights under it. Both ways arrive together */
+        if ((p_scene->ground_reflectivity > 0.0) && (p_sensor->height_m > 0.0))
+        {
+            double ground_leg_m = hypot(p_obstacle->distance_m, 2.0 * p_sensor->height_m);
+            double elevation_deg = -atan2(2.0 * p_sensor->height_m, p_obstacle->distance_m) * 180.0 / ACOUSTIC_MODEL_PI;
+            double d_ground = _directivity_2d(p_sensor, p_obstacle->bearing_deg, elevation_deg);
+            path_m = p_obstacle->distance_m + ground_leg_m;
+            double amplitude = 2.0 * surface * p_scene->ground_reflectivity * d_direct * d_ground * _path_gain(p_scene, path_m);
+            _arrival(p_sensor, &best, path_m * us_per_m, amplitude, ACOUSTIC_ECHO_GROUND_BOUNCE, i);
+        }
+
+        /* Multipath through a second obstacle */
+        double x_i = p_obstacle->distance_m * cos(_rad(p_obstacle->bearing_deg));
+        double y_i = p_obstacle->distance_m * sin(_rad(p_obstacle->bearing_deg));
+        for (uint32_t j = 0; j < p_scene->num_obstacles; j++)
+        {
+            if (j == i)
+            {
+                continue;
+            }
+            const acoustic_obstacle_t *p_other = &p_scene->obstacles[j];
+            double x_j = p_other->distance_m * cos(_rad(p_other->bearing_deg));
+            double y_j = p_other->distance_m * sin(_rad(p_other->bearing_deg));
+            path_m = p_obstacle->distance_m + hypot(x_j - x_i, y_j - y_i) + p_other->distance_m;
+            double amplitude = ACOUSTIC_MODEL_MULTIPATH_GAIN * p_obstacle->reflectivity * p_other->reflectivity * d_direct *
+                               _directivity_2d(p_sensor, p_other->bearing_deg, 0.0) * _path_gain(p_scene, path_m);
+            _arrival(p_sensor, &best, path_m * us_per_m, amplitude, ACOUSTIC_ECHO_MULTIPATH, i);
+        }
+    }
+
+    _ground_clutter(p_model, &best, speed_m_s);
+    _interference(p_model, &best, trigger_us + p_sensor->burst_us, speed_m_s);
+
+    if (best.source == ACOUSTIC_ECHO_NONE)
+    {
+        best.width_us = p_sensor->timeout_us;
+        return best;
+    }
+    if (p_scene->jitter_us > 0.0)
+    {
+        best.width_us += p_scene->jitter_us * _gaussian(p_model);
+        if (best.width_us < 0.0)
+        {
+            best.width_us = 0.0;
+        }
+    }
+    return best;
+}
+
+const char *acoustic_model_source_name(acoustic_echo_source_t source)
+{
+    switch (source)
+    {
+    case ACOUSTIC_ECHO_DIRECT:
+        return "direct";
+    case ACOUSTIC_ECHO_MULTIPATH:
+        return "multipath";
+    case ACOUSTIC_ECHO_GROUND:
+        return "ground";
+    case ACOUSTIC_ECHO_GROUND_BOUNCE:
+        return "ground bounce";
+    case ACOUSTIC_ECHO_INTERFERENCE:
+        return "interference";
+    default:
+        return "none";
+    }
+}
@@ -0,0 +1,89 @@
+/**
+ * @file acoustic_model_stm32f4.c
+ * @brief Connects the acoustic model to the pins of the host register model of the STM32F4.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stddef.h>
+
+/* Project includes */
+#include "acoustic_model_stm32f4.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define ACOUSTIC_MODEL_STM32F4_CYCLES_PER_US (STM32F4_MODEL_CLOCK_HZ / 1000000.0)   /*!<    CPU cycles of the model per microsecond */
+
+/* Global variables */
+static acoustic_model_stm32f4_sensor_t sensors[ACOUSTIC_MODEL_STM32F4_MAX_SENSORS];    /*!<    Connected sensors */
+static acoustic_echo_t last_echoes[ACOUSTIC_MODEL_STM32F4_MAX_SENSORS];                 /*!<    Last echo of each sensor */
+static uint32_t triggers[ACOUSTIC_MODEL_STM32F4_MAX_SENSORS];                           /*!<    Triggers of each sensor */
+static uint32_t num_connected;                                                          /*!<    Number of connected sensors */
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Pin callback of the register model: the end of a trigger schedules the echo of its sensor.
+ */
+static void _pin_changed(GPIO_TypeDef *p_port, uint8_t pin, bool level, uint64_t cycles)
+{
+    if (level)
+    {
+        return;
+    }
+    for (uint32_t i = 0; i < num_connected; i++)
+    {
+        acoustic_model_stm32f4_sensor_t *p_sensor = &sensors[i];
+        if ((p_sensor->p_trigger_port != p_port) || (p_sensor->trigger_pin != pin))
+        {
+            continue;
+        }
+        double trigger_us = (double)cycles / ACOUSTIC_MODEL_STM32F4_CYCLES_PER_US;
+        acoustic_echo_t echo = acoustic_model_echo(p_sensor->p_model, trigger_us);
+        uint64_t start = cycles + (uint64_t)(p_sensor->p_model->sensor.burst_us * ACOUSTIC_MODEL_STM32F4_CYCLES_PER_US);
+        uint64_t width = (uint64_t)(echo.width_us * ACOUSTIC_MODEL_STM32F4_CYCLES_PER_US + 0.5);
+        stm32f4_model_gpio_pulse(p_sensor->p_echo_port, p_sensor->echo_pin, start, (width > 0) ? width : 1);
+        last_echoes[i] = echo;
+        triggers[i]++;
+    }
+}
+
+/* Public functions -----------------------------------------------------------*/
+bool acoustic_model_stm32f4_attach(const acoustic_model_stm32f4_sensor_t *p_sensors, uint32_t num_sensors)
+{
+    if ((p_sensors == NULL) || (num_sensors > ACOUSTIC_MODEL_STM32F4_MAX_SENSORS))
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < num_sensors; i++)
+    {
+        sensors[i] = p_sensors[i];
+        triggers[i] = 0;
+    }
+    num_connected = num_sensors;
+    stm32f4_model_gpio_set_callback(_pin_changed);
+    return true;
+}
+
+void acoustic_model_stm32f4_detach(void)
+{
+    num_connected = 0;
+    stm32f4_model_gpio_set_callback(NULL);
+}
+
+bool acoustic_model_stm32f4_get_last_echo(uint32_t idx, acoustic_echo_t *p_echo)
+{
+    if ((idx >= num_connected) || (p_echo == NULL) || (triggers[idx] == 0))
+    {
+        return false;
+    }
+    *p_echo = last_echoes[idx];
+    return true;
+}
+
+uint32_t acoustic_model_stm32f4_get_triggers(uint32_t idx)
+{
+    return (idx < num_connected) ? triggers[idx] : 0;
+}
@@ -0,0 +1,218 @@
+/**
+ * @file test_acoustic_model.c
+ * @brief Unit test for the physics-based acoustic echo model.
+ *
+ * Each test builds a small scene and checks the width and the origin of the echo against the geometry: round trip at the speed
+ * of sound of the temperature, loss of the echoes out of the beam or of tilted mirrors, range limited by the absorption, ghost
+ * echoes of multipath and ground, and early echoes of foreign sensors.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <math.h>
+
+/* Project includes */
+#include "tools_test.h"
+#include "acoustic_model.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define TEST_SEED 12345U    /*!< Seed of the noise of the tests @hideinitializer */
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Round trip of a distance at a temperature, in us.
+ */
+static double _round_trip_us(double distance_m, double temperature_c)
+{
+    return 2.0 * distance_m / acoustic_model_speed_of_sound(temperature_c) * 1e6;
+}
+
+/**
+ * @brief Model without ground with a concrete wall facing the sensor.
+ */
+static void _wall(acoustic_model_t *p_model, double distance_m)
+{
+    acoustic_model_init(p_model, TEST_SEED);
+    p_model->scene.ground_reflectivity = 0.0;
+    acoustic_obstacle_t wall = {.distance_m = distance_m, .bearing_deg = 0.0, .incidence_deg = 0.0, .reflectivity = 0.95, .roughness = 0.1};
+    acoustic_model_add_obstacle(p_model, &wall);
+}
+
+/**
+ * @brief The echo of a facing wall is its round trip, which depends on the temperature.
+ */
+static void test_round_trip(void)
+{
+    TOOLS_TEST_ASSERT(fabs(acoustic_model_speed_of_sound(20.0) - 343.2) < 0.2, "speed of sound at 20 degC");
+
+    acoustic_model_t model;
+    _wall(&model, 1.0);
+    acoustic_echo_t echo = acoustic_model_echo(&model, 0.0);
+    TOOLS_TEST_ASSERT(echo.source == ACOUSTIC_ECHO_DIRECT, "direct echo of the wall");
+    TOOLS_TEST_ASSERT(fabs(echo.width_us - _round_trip_us(1.0, 20.0)) < 0.01, "width is the round trip");
+
+    model.scene.temperature_c = -10.0;
+    echo = acoustic_model_echo(&model, 0.0);
+    TOOLS_TEST_ASSERT(fabs(echo.width_us - _round_trip_us(1.0, -10.0)) < 0.01, "cold air: slower sound, longer echo");
+    TOOLS_TEST_ASSERT(echo.width_us > _round_trip_us(1.0, 20.0) + 250.0, "the error of a fixed speed is centimeters");
+}
+
+/**
+ * @brief The amplitude falls with the distance until the absorption hides the wall.
+ */
+static void test_range(void)
+{
+    acoustic_model_t model;
+    _wall(&model, 0.5);
+    double near = acoustic_model_echo(&model, 0.0).amplitude;
+    model.scene.obstacles[0].distance_m = 2.0;
+    double far = acoustic_model_echo(&model, 0.0).amplitude;
+    TOOLS_TEST_ASSERT(near > far, "nearer walls are louder");
+
+    model.scene.obstacles[0].distance_m = 7.0;
+    acoustic_echo_t echo = acoustic_model_echo(&model, 0.0);
+    TOOLS_TEST_ASSERT(echo.source == ACOUSTIC_ECHO_NONE, "out of range");
+    TOOLS_TEST_ASSERT(echo.width_us == model.sensor.timeout_us, "no echo: timeout width");
+}
+
+/**
+ * @brief Out of the beam or tilted like a mirror, the wall is missed; a rough surface still returns an echo.
+ */
+static void test_angles(void)
+{
+    acoustic_model_t model;
+    _wall(&model, 1.5);
+    model.scene.obstacles[0].bearing_deg = 40.0;
+    TOOLS_TEST_ASSERT(acoustic_model_echo(&model, 0.0).source == ACOUSTIC_ECHO_NONE, "out of the beam");
+
+    model.scene.obstacles[0].bearing_deg = 0.0;
+    model.scene.obstacles[0].incidence_deg = 30.0;
+    model.scene.obstacles[0].roughness = 0.0;
+    TOOLS_TEST_ASSERT(acoustic_model_echo(&model, 0.0).source == ACOUSTIC_ECHO_NONE, "tilted mirror reflects away");
+
+    model.scene.obstacles[0].roughness = 0.8;
+    TOOLS_TEST_ASSERT(acoustic_model_echo(&model, 0.0).source == ACOUSTIC_ECHO_DIRECT, "rough surface scatters back");
+
+    model.scene.obstacles[0].roughness = 0.1;
+    model.scene.obstacles[0].incidence_deg = 0.0;
+    model.scene.obstacles[0].reflectivity = 0.05;
+    TOOLS_TEST_ASSERT(acoustic_model_echo(&model, 0.0).source == ACOUSTIC_ECHO_NONE, "foam absorbs the burst");
+}
+
+/**
+ * @brief A tilted mirror that is missed directly is seen through a second reflector: a ghost farther than the obstacle.
+ */
+static void test_multipath(void)
+{
+    acoustic_model_t model;
+    _wall(&model, 1.0);
+    model.scene.obstacles[0].incidence_deg = 45.0;
+    model.scene.obstacles[0].roughness = 0.0;
+    acoustic_obstacle_t pillar = {.distance_m = 1.2, .bearing_deg = 10.0, .incidence_deg = 45.0, .reflectivity = 0.95, .roughness = 0.0};
+    acoustic_model_add_obstacle(&model, &pillar);
+    acoustic_echo_t echo = acoustic_model_echo(&model, 0.0);
+    TOOLS_TEST_ASSERT(echo.source == ACOUSTIC_ECHO_MULTIPATH, "only the multipath is detected");
+    TOOLS_TEST_ASSERT(echo.width_us > _round_trip_us(1.0, 20.0), "the ghost is farther than the nearest obstacle");
+}
+
+/**
+ * @brief A sensor tilted down sees the rough ground; a horizontal one does not.
+ */
+static void test_ground(void)
+{
+    acoustic_model_t model;
+    acoustic_model_init(&model, TEST_SEED);
+    model.scene.ground_backscatter = 0.4; /* Gravel */
+    TOOLS_TEST_ASSERT(acoustic_model_echo(&model, 0.0).source == ACOUSTIC_ECHO_NONE, "the ground is under the beam");
+
+    model.sensor.tilt_deg = -25.0;
+    acoustic_echo_t echo = acoustic_model_echo(&model, 0.0);
+    TOOLS_TEST_ASSERT(echo.source == ACOUSTIC_ECHO_GROUND, "ground clutter");
+    double slant_m = model.sensor.height_m / sin(25.0 * 3.14159265358979 / 180.0);
+    TOOLS_TEST_ASSERT(echo.width_us < _round_trip_us(slant_m, 20.0) * 1.2, "near the slant range of the axis");
+}
+
+/**
+ * @brief A foreign burst inside the listening window gives an echo earlier than the wall; outside, it is not heard.
+ */
+static void test_interference(void)
+{
+    acoustic_model_t model;
+    _wall(&model, 2.0);
+    acoustic_interferer_t foreign = {.period_us = 60000.0, .phase_us = 1000.0, .distance_m = 1.0, .amplitude = 1.0};
+    acoustic_model_add_interferer(&model, &foreign);
+
+    acoustic_echo_t echo = acoustic_model_echo(&model, 0.0);
+    TOOLS_TEST_ASSERT(echo.source == ACOUSTIC_ECHO_INTERFERENCE, "foreign burst detected first");
+    double expected = 1000.0 + 1.0 / acoustic_model_speed_of_sound(20.0) * 1e6 - model.sensor.burst_us;
+    TOOLS_TEST_ASSERT(fabs(echo.width_us - expected) < 0.01, "arrival of the foreign burst");
+
+    echo = acoustic_model_echo(&model, 20000.0);
+    TOOLS_TEST_ASSERT(echo.source == ACOUSTIC_ECHO_DIRECT, "the next foreign burst comes after the echo");
+    echo = acoustic_model_echo(&model, 60000.0 - 2000.0);
+    TOOLS_TEST_ASSERT(echo.source == ACOUSTIC_ECHO_INTERFERENCE, "periodic bursts");
+}
+
+/**
+ * @brief The jitter has the configured deviation and the same seed gives the same sequence.
+ */
+static void test_jitter(void)
+{
+    acoustic_model_t a;
+    acoustic_model_t b;
+    _wall(&a, 1.0);
+    _wall(&b, 1.0);
+    a.scene.jitter_us = 20.0;
+    b.scene.jitter_us = 20.0;
+    double expected = _round_trip_us(1.0, 20.0);
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    bool same = true;
+    const int n = 4000;
+    for (int i = 0; i < n; i++)
+    {
+        double w = acoustic_model_echo(&a, 0.0).width_us;
+        same = same && (w == acoustic_model_echo(&b, 0.0).width_us);
+        sum += w - expected;
+        sum_sq += (w - expected) * (w - expected);
+    }
+    double mean = sum / n;
+    double sd = sqrt(sum_sq / n - mean * mean);
+    TOOLS_TEST_ASSERT(same, "reproducible with the seed");
+    TOOLS_TEST_ASSERT(fabs(mean) < 1.5, "unbiased noise");
+    TOOLS_TEST_ASSERT(fabs(sd - 20.0) < 1.5, "standard deviation of the noise");
+}
+
+/**
+ * @brief Full scenes are rejected.
+ */
+static void test_limits(void)
+{
+    acoustic_model_t model;
+    acoustic_model_init(&model, TEST_SEED);
+    acoustic_obstacle_t obstacle = {.distance_m = 1.0, .reflectivity = 0.5};
+    for (int i = 0; i < ACOUSTIC_MODEL_MAX_OBSTACLES; i++)
+    {
+        TOOLS_TEST_ASSERT(acoustic_model_add_obstacle(&model, &obstacle), "room for the obstacle");
+    }
+    TOOLS_TEST_ASSERT(!acoustic_model_add_obstacle(&model, &obstacle), "scene full");
+    TOOLS_TEST_ASSERT(!acoustic_model_add_obstacle(NULL, &obstacle), "NULL model");
+}
+
+/* Main function -----------------------------------------------------------*/
+int main(void)
+{
+    TOOLS_TEST_RUN(test_round_trip);
+    TOOLS_TEST_RUN(test_range);
+    TOOLS_TEST_RUN(test_angles);
+    TOOLS_TEST_RUN(test_multipath);
+    TOOLS_TEST_RUN(test_ground);
+    TOOLS_TEST_RUN(test_interference);
+    TOOLS_TEST_RUN(test_jitter);
+    TOOLS_TEST_RUN(test_limits);
+    return TOOLS_TEST_END();
+}
@@ -0,0 +1,51 @@
+/**
+ * @file test_acoustic_model_fw.c
+ * @brief Firmware side of the test of the acoustic model on the port (compiled with the instrumentation of the register model).
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdbool.h>
+
+/* Project includes */
+#include "test_acoustic_model_fw.h"
+#include "port_system.h"
+#include "port_ultrasound.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define FW_ECHO_TIMER_PERIOD 65536U /*!< Ticks of a period of the echo timer (ARR + 1) */
+
+/* Public functions -----------------------------------------------------------*/
+void fw_init(uint32_t ultrasound_id)
+{
+    port_system_init();
+    port_ultrasound_init(ultrasound_id);
+}
+
+uint32_t fw_measure(uint32_t ultrasound_id, uint32_t timeout_ms)
+{
+    port_ultrasound_reset_echo_ticks(ultrasound_id);
+    port_ultrasound_start_measurement(ultrasound_id);
+    while (!port_ultrasound_get_trigger_end(ultrasound_id))
+    {
+    }
+    port_ultrasound_stop_trigger_timer(ultrasound_id);
+    port_ultrasound_set_trigger_end(ultrasound_id, false);
+
+    uint32_t start = port_system_get_millis();
+    while (!port_ultrasound_get_echo_received(ultrasound_id) && ((port_system_get_millis() - start) < timeout_ms))
+    {
+    }
+    uint32_t ticks = FW_NO_ECHO;
+    if (port_ultrasound_get_echo_received(ultrasound_id))
+    {
+        ticks = port_ultrasound_get_echo_end_tick(ultrasound_id) + port_ultrasound_get_echo_overflows(ultrasound_id) * FW_ECHO_TIMER_PERIOD -
+                port_ultrasound_get_echo_init_tick(ultrasound_id);
+    }
+    port_ultrasound_stop_ultrasound(ultrasound_id);
+    return ticks;
+}
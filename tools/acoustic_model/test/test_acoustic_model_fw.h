@@ -0,0 +1,33 @@
+/**
+ * @file test_acoustic_model_fw.h
+ * @brief Firmware side of the test of the acoustic model on the port (compiled with the instrumentation of the register model).
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef TEST_ACOUSTIC_MODEL_FW_H_
+#define TEST_ACOUSTIC_MODEL_FW_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+#define FW_NO_ECHO UINT32_MAX   /*!< Result of a measurement without echo */
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Initialize the system and the ultrasound port of a sensor.
+ */
+void fw_init(uint32_t ultrasound_id);
+
+/**
+ * @brief Make a measurement as the ultrasound FSM does: trigger, wait for the echo and stop.
+ *
+ * @return uint32_t Duration of the echo in ticks of the echo timer (us), or `FW_NO_ECHO` after the timeout.
+ */
+uint32_t fw_measure(uint32_t ultrasound_id, uint32_t timeout_ms);
+
+#endif /* TEST_ACOUSTIC_MODEL_FW_H_ */
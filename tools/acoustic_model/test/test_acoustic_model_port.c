@@ -0,0 +1,100 @@
+/**
+ * @file test_acoustic_model_port.c
+ * @brief Test of the acoustic model on the echo capture path of the port, run on the host register model of the STM32F4.
+ *
+ * The unmodified ultrasound port triggers the sensor of the board; the acoustic model answers on the echo pin and the port
+ * measures the echo with the input capture of its timer and its ISRs.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <math.h>
+
+/* Project includes */
+#include "tools_test.h"
+#include "acoustic_model_stm32f4.h"
+#include "test_acoustic_model_fw.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define TEST_SENSOR_ID 0U           /*!< Rear parking sensor of the board @hideinitializer */
+#define TEST_TIMEOUT_MS 100U        /*!< Maximum wait of an echo @hideinitializer */
+
+/* Global variables */
+static acoustic_model_t model;      /*!< Acoustic model of the rear sensor */
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Connect the acoustic model to the pins of the rear sensor of the board (trigger PB0, echo PA1).
+ */
+static void _attach(void)
+{
+    acoustic_model_stm32f4_sensor_t sensor = {.p_model = &model, .p_trigger_port = GPIOB, .trigger_pin = 0, .p_echo_port = GPIOA, .echo_pin = 1};
+    acoustic_model_stm32f4_attach(&sensor, 1);
+}
+
+/**
+ * @brief The port measures the round trip of the wall of the scene, to the tick of its timer.
+ */
+static void test_port_measures_scene(void)
+{
+    acoustic_model_init(&model, 7U);
+    acoustic_obstacle_t wall = {.distance_m = 1.0, .bearing_deg = 0.0, .incidence_deg = 0.0, .reflectivity = 0.95, .roughness = 0.1};
+    acoustic_model_add_obstacle(&model, &wall);
+
+    uint32_t ticks = fw_measure(TEST_SENSOR_ID, TEST_TIMEOUT_MS);
+    acoustic_echo_t echo;
+    TOOLS_TEST_ASSERT(acoustic_model_stm32f4_get_last_echo(0, &echo), "the sensor has been triggered");
+    TOOLS_TEST_ASSERT(acoustic_model_stm32f4_get_triggers(0) == 1, "one trigger per measurement");
+    TOOLS_TEST_ASSERT(echo.source == ACOUSTIC_ECHO_DIRECT, "direct echo");
+    TOOLS_TEST_ASSERT(fabs((double)ticks - echo.width_us) <= 1.0, "the capture measures the width of the echo");
+
+    model.scene.obstacles[0].distance_m = 3.0;
+    model.scene.temperature_c = 35.0;
+    ticks = fw_measure(TEST_SENSOR_ID, TEST_TIMEOUT_MS);
+    acoustic_model_stm32f4_get_last_echo(0, &echo);
+    TOOLS_TEST_ASSERT(fabs((double)ticks - echo.width_us) <= 1.0, "the scene can change between triggers");
+}
+
+/**
+ * @brief Without echo the pin stays high for the timeout of the sensor, longer than the period of the echo timer.
+ */
+static void test_port_no_echo(void)
+{
+    acoustic_model_init(&model, 7U);
+    uint32_t ticks = fw_measure(TEST_SENSOR_ID, TEST_TIMEOUT_MS);
+    TOOLS_TEST_ASSERT(fabs((double)ticks - model.sensor.timeout_us) <= 1.0, "timeout width with the overflows of the timer");
+}
+
+/**
+ * @brief A foreign sensor shortens the measured echo.
+ */
+static void test_port_interference(void)
+{
+    acoustic_model_init(&model, 7U);
+    acoustic_obstacle_t wall = {.distance_m = 2.0, .reflectivity = 0.95};
+    acoustic_model_add_obstacle(&model, &wall);
+    acoustic_interferer_t foreign = {.period_us = 1500.0, .phase_us = 0.0, .distance_m = 0.8, .amplitude = 1.0};
+    acoustic_model_add_interferer(&model, &foreign);
+
+    uint32_t ticks = fw_measure(TEST_SENSOR_ID, TEST_TIMEOUT_MS);
+    acoustic_echo_t echo;
+    acoustic_model_stm32f4_get_last_echo(0, &echo);
+    TOOLS_TEST_ASSERT(echo.source == ACOUSTIC_ECHO_INTERFERENCE, "the foreign burst comes first");
+    TOOLS_TEST_ASSERT(ticks < 2.0 * 2.0 / acoustic_model_speed_of_sound(20.0) * 1e6, "shorter than the wall");
+}
+
+/* Main function -----------------------------------------------------------*/
+int main(void)
+{
+    fw_init(TEST_SENSOR_ID);
+    _attach();
+    TOOLS_TEST_RUN(test_port_measures_scene);
+    TOOLS_TEST_RUN(test_port_no_echo);
+    TOOLS_TEST_RUN(test_port_interference);
+    acoustic_model_stm32f4_detach();
+    return TOOLS_TEST_END();
+}
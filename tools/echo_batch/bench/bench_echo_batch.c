@@ -0,0 +1,85 @@
+/**
+ * @file bench_echo_batch.c
+ * @brief Benchmark of the batch processing of echoes: throughput of each implementation supported by the CPU.
+ *
+ * Usage: `bench_echo_batch [number_of_echoes]` (default: 10 million).
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Project includes */
+#include "echo_batch.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define BENCH_DEFAULT_ECHOES 10000000UL  /*!< Default number of echoes of the batch @hideinitializer */
+#define BENCH_REPETITIONS 5              /*!< Number of runs of each implementation. The fastest one is reported @hideinitializer */
+
+/**
+ * @brief Current time in seconds of a monotonic clock.
+ */
+static double _now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char *argv[])
+{
+    size_t count = (argc > 1) ? (size_t)strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_ECHOES;
+    uint32_t *p_init = malloc(count * sizeof(uint32_t));
+    uint32_t *p_end = malloc(count * sizeof(uint32_t));
+    uint32_t *p_overflows = malloc(count * sizeof(uint32_t));
+    uint32_t *p_distance = malloc(count * sizeof(uint32_t));
+    uint32_t *p_median = malloc((count / ECHO_BATCH_WINDOW + 1) * sizeof(uint32_t));
+    if (!p_init || !p_end || !p_overflows || !p_distance || !p_median)
+    {
+        fprintf(stderr, "Not enough memory for %zu echoes\n", count);
+        return 1;
+    }
+
+    // Echoes of objects between 2 cm and 4 m, some of them wrapping around the period of the timer
+    uint32_t seed = 12345U;
+    for (size_t i = 0; i < count; i++)
+    {
+        seed = seed * 1664525U + 1013904223U;
+        p_init[i] = seed >> 16;
+        p_end[i] = (p_init[i] + 116U + ((seed >> 4) % 23200U)) & 0xFFFFU;
+        p_overflows[i] = (p_end[i] < p_init[i]) ? 1U : 0U;
+    }
+    echo_batch_t batch = {p_init, p_end, p_overflows, count};
+
+    printf("%zu echoes\n", count);
+    double scalar_s = 0;
+    for (echo_batch_impl_t impl = ECHO_BATCH_IMPL_SCALAR; impl <= echo_batch_best_impl(); impl++)
+    {
+        double best_s = 1e30;
+        for (int r = 0; r < BENCH_REPETITIONS; r++)
+        {
+            double start = _now_s();
+            echo_batch_process(&batch, p_distance, p_median, impl);
+            double elapsed = _now_s() - start;
+            best_s = (elapsed < best_s) ? elapsed : best_s;
+        }
+        if (impl == ECHO_BATCH_IMPL_SCALAR)
+        {
+            scalar_s = best_s;
+        }
+        printf("%-8s %8.2f ms %8.1f Mechoes/s  x%.2f\n", echo_batch_impl_name(impl), best_s * 1e3, (double)count / best_s * 1e-6, scalar_s / best_s);
+    }
+
+    free(p_init);
+    free(p_end);
+    free(p_overflows);
+    free(p_distance);
+    free(p_median);
+    return 0;
+}
@@ -0,0 +1,101 @@
+/**
+ * @file echo_batch.h
+ * @brief Header for echo_batch.c file. Batch processing of recorded echoes on the host.
+ *
+ * It computes, for a batch of recorded echoes, the same distances and medians as `do_set_distance()` of the ultrasound FSM,
+ * bit by bit, but many echoes per call. The echoes are passed as a structure of arrays, one array per field of the port
+ * (`echo_init_tick`, `echo_end_tick`, `echo_overflows`), so the vector kernels load 4 (SSE2) or 8 (AVX2) echoes per instruction.
+ *
+ * The scalar implementation is the reference: it follows `do_set_distance()` and uses the portable kernels of the firmware (`dsp_kernels.h`).
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef ECHO_BATCH_H_
+#define ECHO_BATCH_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define ECHO_BATCH_WINDOW 5     /*!<    Number of distances of each median. It must match `FSM_ULTRASOUND_NUM_MEASUREMENTS`   */
+
+/* Enums */
+/**
+ * @brief Implementations of the kernels.
+ */
+typedef enum
+{
+    ECHO_BATCH_IMPL_AUTO = 0,   /*!<    Best implementation supported by the CPU */
+    ECHO_BATCH_IMPL_SCALAR,     /*!<    Scalar reference */
+    ECHO_BATCH_IMPL_SSE2,       /*!<    4 echoes per instruction (x86-64 baseline) */
+    ECHO_BATCH_IMPL_AVX2,       /*!<    8 echoes per instruction */
+} echo_batch_impl_t;
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Batch of recorded echoes as a structure of arrays. Element `i` of the three arrays is echo `i`.
+ */
+typedef struct
+{
+    const uint32_t *p_init_tick;    /*!<    Tick of the timer at the rising edge of each echo */
+    const uint32_t *p_end_tick;     /*!<    Tick of the timer at the falling edge of each echo */
+    const uint32_t *p_overflows;    /*!<    Number of overflows of the timer during each echo */
+    size_t count;                   /*!<    Number of echoes of the batch */
+} echo_batch_t;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Get the best implementation supported by the CPU that runs the program.
+ *
+ * @return echo_batch_impl_t    `ECHO_BATCH_IMPL_AVX2`, `ECHO_BATCH_IMPL_SSE2` or `ECHO_BATCH_IMPL_SCALAR`. Never `ECHO_BATCH_IMPL_AUTO`.
+ */
+echo_batch_impl_t echo_batch_best_impl(void);
+
+/**
+ * @brief Get the name of an implementation, for the reports.
+ *
+ * @param impl          Implementation.
+ * @return const char*  Name of the implementation.
+ */
+const char *echo_batch_impl_name(echo_batch_impl_t impl);
+
+/**
+ * @brief Compute the distance of each echo of a batch.
+ * If the implementation is not supported by the CPU, the best supported one is used.
+ *
+ * @param p_batch       Pointer to the batch of echoes.
+ * @param p_distance_cm Pointer to an array of `p_batch->count` elements that receives the distances in cm.
+ * @param impl          Implementation of the kernel.
+ */
+void echo_batch_distances(const echo_batch_t *p_batch, uint32_t *p_distance_cm, echo_batch_impl_t impl);
+
+/**
+ * @brief Compute the median of each window of `ECHO_BATCH_WINDOW` consecutive distances, as the ultrasound FSM does.
+ * The windows do not overlap. The distances that do not complete a window are ignored.
+ *
+ * @param p_distance_cm Pointer to the distances in cm.
+ * @param count         Number of distances.
+ * @param p_median_cm   Pointer to an array of `count / ECHO_BATCH_WINDOW` elements that receives the medians.
+ * @param impl          Implementation of the kernel.
+ * @return size_t       Number of medians: `count / ECHO_BATCH_WINDOW`.
+ */
+size_t echo_batch_medians(const uint32_t *p_distance_cm, size_t count, uint32_t *p_median_cm, echo_batch_impl_t impl);
+
+/**
+ * @brief Compute the distances of a batch of echoes and then their medians.
+ *
+ * @param p_batch       Pointer to the batch of echoes.
+ * @param p_distance_cm Pointer to an array of `p_batch->count` elements that receives the distances in cm.
+ * @param p_median_cm   Pointer to an array of `p_batch->count / ECHO_BATCH_WINDOW` elements that receives the medians.
+ * @param impl          Implementation of the kernels.
+ * @return size_t       Number of medians.
+ */
+size_t echo_batch_process(const echo_batch_t *p_batch, uint32_t *p_distance_cm, uint32_t *p_median_cm, echo_batch_impl_t impl);
+
+#endif /* ECHO_BATCH_H_ */
@@ -0,0 +1,359 @@
+/**
+ * @file echo_batch.c
+ * @brief Batch processing of recorded echoes on the host: scalar reference and SSE2/AVX2 kernels.
+ *
+ * The vector kernels compute the conversion into cm with the reciprocal of `dsp_ticks_to_cm()`, which is exact for echoes
+ * shorter than 2^30 ticks. The few lanes above that limit are recomputed with the scalar reference, so the results are always exact.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stddef.h>
+
+/* Project includes */
+#include "echo_batch.h"
+#include "dsp_kernels.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#include <immintrin.h>
+#define ECHO_BATCH_X86  /*!<    The SSE2 and AVX2 kernels are compiled. They are selected at run time */
+#endif
+
+/* Defines and enums ----------------------------------------------------------*/
+#define ECHO_BATCH_TIMER_PERIOD 65536U  /*!<    Number of ticks of a period of the echo timer (ARR + 1)   */
+#define ECHO_BATCH_SIGN_BIAS 0x80000000U /*!<   Bias that turns an unsigned comparison into a signed one   */
+
+_Static_assert(ECHO_BATCH_WINDOW == 5, "The vector kernels implement the median network of 5 values");
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Duration of an echo in ticks, exactly as `do_set_distance()` computes it.
+ *
+ * @param init_tick     Tick of the timer at the rising edge.
+ * @param end_tick      Tick of the timer at the falling edge.
+ * @param overflows     Number of overflows of the timer during the echo.
+ * @return uint32_t     Duration of the echo in ticks.
+ */
+static uint32_t _echo_ticks(uint32_t init_tick, uint32_t end_tick, uint32_t overflows)
+{
+    uint32_t ticks_elapsed;
+    if (end_tick >= init_tick)
+    {
+        ticks_elapsed = end_tick - init_tick;
+    }
+    else
+    {
+        ticks_elapsed = (ECHO_BATCH_TIMER_PERIOD - init_tick) + end_tick;
+        if (overflows > 0)
+        {
+            overflows = overflows - 1;
+        }
+    }
+    return ticks_elapsed + (overflows * ECHO_BATCH_TIMER_PERIOD);
+}
+
+/**
+ * @brief Scalar reference of the distances of the echoes `[first, last)` of a batch.
+ */
+static void _distances_scalar(const echo_batch_t *p_batch, uint32_t *p_distance_cm, size_t first, size_t last)
+{
+    for (size_t i = first; i < last; i++)
+    {
+        uint32_t ticks = _echo_ticks(p_batch->p_init_tick[i], p_batch->p_end_tick[i], p_batch->p_overflows[i]);
+        p_distance_cm[i] = dsp_ticks_to_cm_c(ticks);
+    }
+}
+
+/**
+ * @brief Scalar reference of the medians of the windows `[first, last)`.
+ */
+static void _medians_scalar(const uint32_t *p_distance_cm, uint32_t *p_median_cm, size_t first, size_t last)
+{
+    for (size_t w = first; w < last; w++)
+    {
+        p_median_cm[w] = dsp_median_u32_c(&p_distance_cm[w * ECHO_BATCH_WINDOW], ECHO_BATCH_WINDOW);
+    }
+}
+
+#ifdef ECHO_BATCH_X86
+/**
+ * @brief Recompute with the scalar reference the lanes of a vector whose echo is too long for the reciprocal.
+ *
+ * @param p_batch       Pointer to the batch.
+ * @param p_distance_cm Pointer to the distances.
+ * @param first         Index of the echo of the first lane.
+ * @param big_lanes     Bit `l` is 1 if lane `l` must be recomputed.
+ */
+static void _fix_big_lanes(const echo_batch_t *p_batch, uint32_t *p_distance_cm, size_t first, uint32_t big_lanes)
+{
+    for (size_t lane = 0; big_lanes != 0; lane++, big_lanes >>= 1)
+    {
+        if (big_lanes & 1U)
+        {
+            _distances_scalar(p_batch, p_distance_cm, first + lane, first + lane + 1);
+        }
+    }
+}
+
+/**
+ * @brief Unsigned minimum of 4 lanes with SSE2, which only has signed comparisons.
+ */
+__attribute__((target("sse2")))
+static inline __m128i _min_epu32_sse2(__m128i a, __m128i b)
+{
+    const __m128i bias = _mm_set1_epi32((int32_t)ECHO_BATCH_SIGN_BIAS);
+    __m128i a_gt_b = _mm_cmpgt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+    return _mm_or_si128(_mm_and_si128(a_gt_b, b), _mm_andnot_si128(a_gt_b, a));
+}
+
+/**
+ * @brief Unsigned maximum of 4 lanes with SSE2.
+ */
+__attribute__((target("sse2")))
+static inline __m128i _max_epu32_sse2(__m128i a, __m128i b)
+{
+    const __m128i bias = _mm_set1_epi32((int32_t)ECHO_BATCH_SIGN_BIAS);
+    __m128i a_gt_b = _mm_cmpgt_epi32(_mm_xor_si128(a, bias), _mm_xor_si128(b, bias));
+    return _mm_or_si128(_mm_and_si128(a_gt_b, a), _mm_andnot_si128(a_gt_b, b));
+}
+
+/**
+ * @brief Distances of a batch, 4 echoes per iteration.
+ */
+__attribute__((target("sse2")))
+static void _distances_sse2(const echo_batch_t *p_batch, uint32_t *p_distance_cm)
+{
+    const __m128i bias = _mm_set1_epi32((int32_t)ECHO_BATCH_SIGN_BIAS);
+    const __m128i period = _mm_set1_epi32((int32_t)ECHO_BATCH_TIMER_PERIOD);
+    const __m128i magic = _mm_set1_epi32((int32_t)DSP_TICKS_TO_CM_MAGIC);
+    const __m128i low_mask = _mm_set_epi32(0, -1, 0, -1);
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t i = 0;
+    for (; i + 4 <= p_batch->count; i += 4)
+    {
+        __m128i init = _mm_loadu_si128((const __m128i *)&p_batch->p_init_tick[i]);
+        __m128i end = _mm_loadu_si128((const __m128i *)&p_batch->p_end_tick[i]);
+        __m128i overflows = _mm_loadu_si128((const __m128i *)&p_batch->p_overflows[i]);
+
+        // Wrapped echoes (end < init): add a period and discount one overflow, if any
+        __m128i wrapped = _mm_cmpgt_epi32(_mm_xor_si128(init, bias), _mm_xor_si128(end, bias));
+        __m128i ticks = _mm_add_epi32(_mm_sub_epi32(end, init), _mm_and_si128(wrapped, period));
+        __m128i discount = _mm_andnot_si128(_mm_cmpeq_epi32(overflows, zero), wrapped);
+        overflows = _mm_add_epi32(overflows, discount);
+        ticks = _mm_add_epi32(ticks, _mm_slli_epi32(overflows, 16));
+
+        // ticks * magic >> 30, for the even and the odd lanes
+        __m128i even = _mm_srli_epi64(_mm_mul_epu32(ticks, magic), DSP_TICKS_TO_CM_SHIFT);
+        __m128i odd = _mm_srli_epi64(_mm_mul_epu32(_mm_srli_epi64(ticks, 32), magic), DSP_TICKS_TO_CM_SHIFT);
+        __m128i distance = _mm_or_si128(_mm_and_si128(even, low_mask), _mm_slli_epi64(odd, 32));
+        _mm_storeu_si128((__m128i *)&p_distance_cm[i], distance);
+
+        __m128i small = _mm_cmpeq_epi32(_mm_srli_epi32(ticks, DSP_TICKS_TO_CM_SHIFT), zero);
+        uint32_t big_lanes = (uint32_t)(~_mm_movemask_ps(_mm_castsi128_ps(small))) & 0xFU;
+        if (big_lanes != 0)
+        {
+            _fix_big_lanes(p_batch, p_distance_cm, i, big_lanes);
+        }
+    }
+    _distances_scalar(p_batch, p_distance_cm, i, p_batch->count);
+}
+
+/**
+ * @brief Distances of a batch, 8 echoes per iteration.
+ */
+__attribute__((target("avx2")))
+static void _distances_avx2(const echo_batch_t *p_batch, uint32_t *p_distance_cm)
+{
+    const __m256i bias = _mm256_set1_epi32((int32_t)ECHO_BATCH_SIGN_BIAS);
+    const __m256i period = _mm256_set1_epi32((int32_t)ECHO_BATCH_TIMER_PERIOD);
+    const __m256i magic = _mm256_set1_epi32((int32_t)DSP_TICKS_TO_CM_MAGIC);
+    const __m256i zero = _mm256_setzero_si256();
+
+    size_t i = 0;
+    for (; i + 8 <= p_batch->count; i += 8)
+    {
+        __m256i init = _mm256_loadu_si256((const __m256i *)&p_batch->p_init_tick[i]);
+        __m256i end = _mm256_loadu_si256((const __m256i *)&p_batch->p_end_tick[i]);
+        __m256i overflows = _mm256_loadu_si256((const __m256i *)&p_batch->p_overflows[i]);
+
+        // Wrapped echoes (end < init): add a period and discount one overflow, if any
+        __m256i wrapped = _mm256_cmpgt_epi32(_mm256_xor_si256(init, bias), _mm256_xor_si256(end, bias));
+        __m256i ticks = _mm256_add_epi32(_mm256_sub_epi32(end, init), _mm256_and_si256(wrapped, period));
+        __m256i discount = _mm256_andnot_si256(_mm256_cmpeq_epi32(overflows, zero), wrapped);
+        overflows = _mm256_add_epi32(overflows, discount);
+        ticks = _mm256_add_epi32(ticks, _mm256_slli_epi32(overflows, 16));
+
+        // ticks * magic >> 30, for the even and the odd lanes
+        __m256i even = _mm256_srli_epi64(_mm256_mul_epu32(ticks, magic), DSP_TICKS_TO_CM_SHIFT);
+        __m256i odd = _mm256_srli_epi64(_mm256_mul_epu32(_mm256_srli_epi64(ticks, 32), magic), DSP_TICKS_TO_CM_SHIFT);
+        __m256i distance = _mm256_blend_epi32(even, _mm256_slli_epi64(odd, 32), 0xAA);
+        _mm256_storeu_si256((__m256i *)&p_distance_cm[i], distance);
+
+        __m256i small = _mm256_cmpeq_epi32(_mm256_srli_epi32(ticks, DSP_TICKS_TO_CM_SHIFT), zero);
+        uint32_t big_lanes = (uint32_t)(~_mm256_movemask_ps(_mm256_castsi256_ps(small))) & 0xFFU;
+        if (big_lanes != 0)
+        {
+            _fix_big_lanes(p_batch, p_distance_cm, i, big_lanes);
+        }
+    }
+    _distances_scalar(p_batch, p_distance_cm, i, p_batch->count);
+}
+
+/**
+ * @brief Medians of 4 windows per iteration with the median network of 5 values, one window per lane.
+ */
+__attribute__((target("sse2")))
+static void _medians_sse2(const uint32_t *p_distance_cm, uint32_t *p_median_cm, size_t num_windows)
+{
+    size_t w = 0;
+    for (; w + 4 <= num_windows; w += 4)
+    {
+        const uint32_t *p = &p_distance_cm[w * ECHO_BATCH_WINDOW];
+        __m128i v[ECHO_BATCH_WINDOW];
+        for (uint32_t j = 0; j < ECHO_BATCH_WINDOW; j++)
+        {
+            v[j] = _mm_set_epi32((int32_t)p[3 * ECHO_BATCH_WINDOW + j], (int32_t)p[2 * ECHO_BATCH_WINDOW + j], (int32_t)p[ECHO_BATCH_WINDOW + j], (int32_t)p[j]);
+        }
+        __m128i a0 = _min_epu32_sse2(v[0], v[1]);
+        __m128i a1 = _max_epu32_sse2(v[0], v[1]);
+        __m128i a3 = _min_epu32_sse2(v[3], v[4]);
+        __m128i a4 = _max_epu32_sse2(v[3], v[4]);
+        __m128i b3 = _max_epu32_sse2(a0, a3);
+        __m128i b1 = _min_epu32_sse2(a1, a4);
+        __m128i c1 = _min_epu32_sse2(b1, v[2]);
+        __m128i c2 = _max_epu32_sse2(b1, v[2]);
+        __m128i d2 = _min_epu32_sse2(c2, b3);
+        _mm_storeu_si128((__m128i *)&p_median_cm[w], _max_epu32_sse2(c1, d2));
+    }
+    _medians_scalar(p_distance_cm, p_median_cm, w, num_windows);
+}
+
+/**
+ * @brief Medians of 8 windows per iteration with the median network of 5 values, one window per lane.
+ */
+__attribute__((target("avx2")))
+static void _medians_avx2(const uint32_t *p_distance_cm, uint32_t *p_median_cm, size_t num_windows)
+{
+    const __m256i stride = _mm256_setr_epi32(0, 5, 10, 15, 20, 25, 30, 35);
+
+    size_t w = 0;
+    for (; w + 8 <= num_windows; w += 8)
+    {
+        const int *p = (const int *)&p_distance_cm[w * ECHO_BATCH_WINDOW];
+        __m256i v[ECHO_BATCH_WINDOW];
+        for (uint32_t j = 0; j < ECHO_BATCH_WINDOW; j++)
+        {
+            v[j] = _mm256_i32gather_epi32(p + j, stride, 4);
+        }
+        __m256i a0 = _mm256_min_epu32(v[0], v[1]);
+        __m256i a1 = _mm256_max_epu32(v[0], v[1]);
+        __m256i a3 = _mm256_min_epu32(v[3], v[4]);
+        __m256i a4 = _mm256_max_epu32(v[3], v[4]);
+        __m256i b3 = _mm256_max_epu32(a0, a3);
+        __m256i b1 = _mm256_min_epu32(a1, a4);
+        __m256i c1 = _mm256_min_epu32(b1, v[2]);
+        __m256i c2 = _mm256_max_epu32(b1, v[2]);
+        __m256i d2 = _mm256_min_epu32(c2, b3);
+        _mm256_storeu_si256((__m256i *)&p_median_cm[w], _mm256_max_epu32(c1, d2));
+    }
+    _medians_scalar(p_distance_cm, p_median_cm, w, num_windows);
+}
+#endif
+
+/**
+ * @brief Resolve the implementation that will actually run.
+ *
+ * @param impl                  Requested implementation.
+ * @return echo_batch_impl_t    The requested one if the CPU supports it. Otherwise, the best supported one.
+ */
+static echo_batch_impl_t _resolve_impl(echo_batch_impl_t impl)
+{
+    echo_batch_impl_t best = echo_batch_best_impl();
+    if ((impl == ECHO_BATCH_IMPL_AUTO) || (impl > best))
+    {
+        return best;
+    }
+    return impl;
+}
+
+/* Public functions -----------------------------------------------------------*/
+echo_batch_impl_t echo_batch_best_impl(void)
+{
+#ifdef ECHO_BATCH_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return ECHO_BATCH_IMPL_AVX2;
+    }
+    if (__builtin_cpu_supports("sse2"))
+    {
+        return ECHO_BATCH_IMPL_SSE2;
+    }
+#endif
+    return ECHO_BATCH_IMPL_SCALAR;
+}
+
+const char *echo_batch_impl_name(echo_batch_impl_t impl)
+{
+    switch (impl)
+    {
+    case ECHO_BATCH_IMPL_SCALAR:
+        return "scalar";
+    case ECHO_BATCH_IMPL_SSE2:
+        return "sse2";
+    case ECHO_BATCH_IMPL_AVX2:
+        return "avx2";
+    default:
+        return "auto";
+    }
+}
+
+void echo_batch_distances(const echo_batch_t *p_batch, uint32_t *p_distance_cm, echo_batch_impl_t impl)
+{
+    switch (_resolve_impl(impl))
+    {
+#ifdef ECHO_BATCH_X86
+    case ECHO_BATCH_IMPL_AVX2:
+        _distances_avx2(p_batch, p_distance_cm);
+        break;
+    case ECHO_BATCH_IMPL_SSE2:
+        _distances_sse2(p_batch, p_distance_cm);
+        break;
+#endif
+    default:
+        _distances_scalar(p_batch, p_distance_cm, 0, p_batch->count);
+        break;
+    }
+}
+
+size_t echo_batch_medians(const uint32_t *p_distance_cm, size_t count, uint32_t *p_median_cm, echo_batch_impl_t impl)
+{
+    size_t num_windows = count / ECHO_BATCH_WINDOW;
+    switch (_resolve_impl(impl))
+    {
+#ifdef ECHO_BATCH_X86
+    case ECHO_BATCH_IMPL_AVX2:
+        _medians_avx2(p_distance_cm, p_median_cm, num_windows);
+        break;
+    case ECHO_BATCH_IMPL_SSE2:
+        _medians_sse2(p_distance_cm, p_median_cm, num_windows);
+        break;
+#endif
+    default:
+        _medians_scalar(p_distance_cm, p_median_cm, 0, num_windows);
+        break;
+    }
+    return num_windows;
+}
+
+size_t echo_batch_process(const echo_batch_t *p_batch, uint32_t *p_distance_cm, uint32_t *p_median_cm, echo_batch_impl_t impl)
+{
+    echo_batch_distances(p_batch, p_distance_cm, impl);
+    return echo_batch_medians(p_distance_cm, p_batch->count, p_median_cm, impl);
+}
@@ -0,0 +1,155 @@
+/**
+ * @file test_echo_batch.c
+ * @brief Unit test for the batch processing of echoes.
+ *
+ * Every implementation supported by the CPU must give the same distances and medians as the scalar reference, bit by bit.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdlib.h>
+#include <string.h>
+
+/* Project includes */
+#include "tools_test.h"
+#include "echo_batch.h"
+#include "dsp_kernels.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define TEST_NUM_ECHOES 4099    /*!< Number of echoes of the random batch. Not a multiple of the vectors nor of the window @hideinitializer */
+
+/* Global variables */
+static uint32_t init_tick[TEST_NUM_ECHOES];     /*!< Rising edges of the batch */
+static uint32_t end_tick[TEST_NUM_ECHOES];      /*!< Falling edges of the batch */
+static uint32_t overflows[TEST_NUM_ECHOES];     /*!< Overflows of the batch */
+static uint32_t lfsr_state = 0x2545F491U;       /*!< State of the pseudo-random generator */
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Pseudo-random generator of the inputs (xorshift32).
+ */
+static uint32_t _random(void)
+{
+    lfsr_state ^= lfsr_state << 13;
+    lfsr_state ^= lfsr_state >> 17;
+    lfsr_state ^= lfsr_state << 5;
+    return lfsr_state;
+}
+
+/**
+ * @brief Fill the batch with random echoes: short ones, wrapped ones, with and without overflows, and absurdly long ones.
+ */
+static void _fill_batch(void)
+{
+    for (uint32_t i = 0; i < TEST_NUM_ECHOES; i++)
+    {
+        init_tick[i] = _random() & 0xFFFFU;
+        end_tick[i] = _random() & 0xFFFFU;
+        switch (i % 4)
+        {
+        case 0:
+            overflows[i] = 0;
+            break;
+        case 1:
+            overflows[i] = _random() & 0x3U;
+            break;
+        case 2:
+            overflows[i] = _random() & 0xFFFFU;    // Beyond the limit of the reciprocal
+            break;
+        default:
+            overflows[i] = _random();              // The number of ticks wraps around as in the FSM
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Distance of an echo as written in `do_set_distance()` of the ultrasound FSM, before the kernels of the firmware.
+ */
+static uint32_t _fsm_distance(uint32_t init, uint32_t end, uint32_t ov)
+{
+    uint32_t ticks_elapsed;
+    if (end >= init)
+    {
+        ticks_elapsed = end - init;
+    }
+    else
+    {
+        ticks_elapsed = (65536 - init) + end;
+        if (ov > 0)
+        {
+            ov = ov - 1;
+        }
+    }
+    ticks_elapsed = ticks_elapsed + (ov * 65536);
+    return (uint32_t)(((uint64_t)ticks_elapsed * 10) / 583);
+}
+
+/* Tests -----------------------------------------------------------------------*/
+void test_scalar_matches_fsm(void)
+{
+    echo_batch_t batch = {init_tick, end_tick, overflows, TEST_NUM_ECHOES};
+    static uint32_t distance[TEST_NUM_ECHOES];
+    echo_batch_distances(&batch, distance, ECHO_BATCH_IMPL_SCALAR);
+
+    uint32_t mismatches = 0;
+    for (uint32_t i = 0; i < TEST_NUM_ECHOES; i++)
+    {
+        mismatches += (distance[i] != _fsm_distance(init_tick[i], end_tick[i], overflows[i]));
+    }
+    TOOLS_TEST_ASSERT(mismatches == 0, "The scalar reference does not match do_set_distance()");
+
+    uint32_t window[ECHO_BATCH_WINDOW] = {172, 1715, 168, 0, 170};
+    uint32_t median;
+    TOOLS_TEST_ASSERT(echo_batch_medians(window, ECHO_BATCH_WINDOW, &median, ECHO_BATCH_IMPL_SCALAR) == 1, "A full window must give one median");
+    TOOLS_TEST_ASSERT(median == 170, "Wrong median of the window");
+}
+
+void test_vector_matches_scalar(void)
+{
+    echo_batch_t batch = {init_tick, end_tick, overflows, TEST_NUM_ECHOES};
+    static uint32_t ref_distance[TEST_NUM_ECHOES];
+    static uint32_t ref_median[TEST_NUM_ECHOES / ECHO_BATCH_WINDOW];
+    static uint32_t distance[TEST_NUM_ECHOES];
+    static uint32_t median[TEST_NUM_ECHOES / ECHO_BATCH_WINDOW];
+
+    size_t num_medians = echo_batch_process(&batch, ref_distance, ref_median, ECHO_BATCH_IMPL_SCALAR);
+    TOOLS_TEST_ASSERT(num_medians == TEST_NUM_ECHOES / ECHO_BATCH_WINDOW, "The incomplete window must be ignored");
+
+    // Medians of small distances too, so that the windows have repeated values
+    static uint32_t small_distance[TEST_NUM_ECHOES];
+    static uint32_t ref_small_median[TEST_NUM_ECHOES / ECHO_BATCH_WINDOW];
+    for (uint32_t i = 0; i < TEST_NUM_ECHOES; i++)
+    {
+        small_distance[i] = ref_distance[i] & 0x3U;
+    }
+    echo_batch_medians(small_distance, TEST_NUM_ECHOES, ref_small_median, ECHO_BATCH_IMPL_SCALAR);
+
+    for (echo_batch_impl_t impl = ECHO_BATCH_IMPL_SSE2; impl <= echo_batch_best_impl(); impl++)
+    {
+        printf("  checking %s\n", echo_batch_impl_name(impl));
+        memset(distance, 0, sizeof(distance));
+        memset(median, 0, sizeof(median));
+        TOOLS_TEST_ASSERT(echo_batch_process(&batch, distance, median, impl) == num_medians, "Wrong number of medians");
+        TOOLS_TEST_ASSERT(memcmp(distance, ref_distance, sizeof(distance)) == 0, "The distances do not match the scalar reference");
+        TOOLS_TEST_ASSERT(memcmp(median, ref_median, sizeof(median)) == 0, "The medians do not match the scalar reference");
+
+        echo_batch_medians(small_distance, TEST_NUM_ECHOES, median, impl);
+        TOOLS_TEST_ASSERT(memcmp(median, ref_small_median, sizeof(median)) == 0, "The medians of repeated values do not match the scalar reference");
+    }
+}
+
+int main(void)
+{
+    _fill_batch();
+    printf("Best implementation: %s\n", echo_batch_impl_name(echo_batch_best_impl()));
+
+    TOOLS_TEST_RUN(test_scalar_matches_fsm);
+    TOOLS_TEST_RUN(test_vector_matches_scalar);
+
+    return TOOLS_TEST_END();
+}
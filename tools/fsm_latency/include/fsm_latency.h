@@ -0,0 +1,220 @@
+/**
+ * @file fsm_latency.h
+ * @brief Header for fsm_latency.c file. Exhaustive worst-case response-latency analysis of the FSMs of the Urbanite.
+ *
+ * The analyser explores the combined state space of `fsm_button`, `fsm_ultrasound`, `fsm_display` and `fsm_urbanite` as they are
+ * composed in `main.c`: one round of the main loop fires each FSM once, in the order of their deadlines in the scheduler. The
+ * transition tables are the ones of the firmware (same states, guards and actions, checked against the sources by the tests), but
+ * the guards that read the HW are abstracted to input events:
+ * - User and vehicle inputs: press and release of the button (the release tells the class of the duration of the press), reverse
+ *   gear and ignition. They can happen between any two rounds. The obstacle stays far, except for the crossing into the danger band,
+ *   which is only the input of its pair.
+ * - Timers of the port and of the sensor: debounce, power settle, measurement period, trigger, echo start and echo end. Each one
+ *   has the maximum delay of its configuration. The ones of a measurement can expire between any two rounds; the long ones only
+ *   while the loop waits, in any order that their delays allow.
+ *
+ * Time is only accounted where the main loop waits: a round costs `round_us`, a blocking action (`port_system_delay_ms()`) costs
+ * its delay, and when no FSM can progress the loop waits for the next timers at their maximum delay. The SysTick is suspended by
+ * the low power mode and only resumed by the ISRs that do it in the firmware, so the timers based on `port_system_get_millis()` do
+ * not expire while it is stopped. The bounds are upper bounds: every behaviour of the firmware is a path of the model whose time
+ * is not lower than the real one.
+ *
+ * For each pair of input and output, the analyser applies the input in every reachable state where it can happen (with no other
+ * input pending) and computes the longest path (time and iterations of the main loop) to the output, plus the round in progress
+ * when the input arrives. A path that can loop forever or waits for an input that never
+ * comes makes the latency unbounded, and the state where it gets stuck is reported.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef FSM_LATENCY_H_
+#define FSM_LATENCY_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Defines */
+#define FSM_LATENCY_WITNESS_LEN 160     /*!<    Maximum length of the description of the state where a latency is unbounded */
+
+/* Enums */
+/**
+ * @brief FSMs of the product, in the order they are added to the scheduler in `main.c`.
+ */
+typedef enum
+{
+    FSM_LATENCY_BUTTON = 0,     /*!<    `fsm_button` */
+    FSM_LATENCY_ULTRASOUND,     /*!<    `fsm_ultrasound` */
+    FSM_LATENCY_DISPLAY,        /*!<    `fsm_display` */
+    FSM_LATENCY_URBANITE,       /*!<    `fsm_urbanite` */
+    FSM_LATENCY_NUM_FSMS,       /*!<    Number of FSMs */
+} fsm_latency_fsm_t;
+
+/**
+ * @brief Pairs of input and output analysed.
+ */
+typedef enum
+{
+    FSM_LATENCY_PRESS_ON = 0,           /*!<    Release of an ON press while OFF: MEASURE */
+    FSM_LATENCY_PRESS_ON_DISTANCE,      /*!<    Release of an ON press while OFF: first distance on the LED */
+    FSM_LATENCY_PRESS_OFF,              /*!<    Release of an OFF press while ON: LED off */
+    FSM_LATENCY_PRESS_PAUSE,            /*!<    Release of a pause press while ON: LED off */
+    FSM_LATENCY_PRESS_EMERGENCY,        /*!<    Release of an emergency press while ON: LED red */
+    FSM_LATENCY_PRESS_EMERGENCY_OFF,    /*!<    Release of an emergency press in EMERGENCY: MEASURE */
+    FSM_LATENCY_ECHO,                   /*!<    End of the echo that completes a median while ON: LED updated */
+    FSM_LATENCY_CROSSING,               /*!<    Obstacle crossing into the danger band while ON: LED shows it */
+    FSM_LATENCY_REVERSE_ON,             /*!<    Reverse gear engaged while OFF: first distance on the LED */
+    FSM_LATENCY_REVERSE_OFF,            /*!<    Reverse gear released while ON by the reverse gear: LED off */
+    FSM_LATENCY_NUM_QUERIES,            /*!<    Number of pairs */
+} fsm_latency_query_t;
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Configuration of the analysis. The default one is the product of `main.c` on the Urbanite board.
+ */
+typedef struct
+{
+    uint32_t round_us;                              /*!<    Upper bound of the execution time of a round of the main loop */
+    uint32_t debounce_ms;                           /*!<    Debounce time of the button */
+    uint32_t settle_ms;                             /*!<    Power settle time of the sensor (0: always powered) */
+    uint32_t period_ms;                             /*!<    Measurement period of the sensor */
+    uint32_t standby_period_ms;                     /*!<    Measurement period of the sensor in warm standby */
+    uint32_t trigger_us;                            /*!<    Duration of the trigger pulse */
+    uint32_t echo_start_max_us;                     /*!<    Maximum time from the end of the trigger to the start of the echo */
+    uint32_t echo_max_us;                           /*!<    Maximum duration of the echo pulse (timeout of the sensor) */
+    bool reverse_enabled;                           /*!<    The reverse gear turns the system ON and OFF */
+    bool warm_standby;                              /*!<    The sensor is kept in warm standby while the ignition is on */
+    uint32_t deadline_ms[FSM_LATENCY_NUM_FSMS];     /*!<    Relative deadline of the task of each FSM in the scheduler */
+} fsm_latency_config_t;
+
+/**
+ * @brief Transition of the table of an FSM of the model.
+ */
+typedef struct
+{
+    int32_t orig_state;     /*!<    Origin state */
+    const char *p_in;       /*!<    Name of the guard in the firmware */
+    int32_t dest_state;     /*!<    Destination state */
+    const char *p_out;      /*!<    Name of the action in the firmware, NULL if none */
+    uint32_t blocking_ms;   /*!<    Time the action blocks the main loop (`port_system_delay_ms()`), 0 if it does not */
+} fsm_latency_trans_info_t;
+
+/**
+ * @brief Worst case of a pair of input and output.
+ */
+typedef struct
+{
+    uint32_t stimuli;                           /*!<    Number of reachable states where the input can happen */
+    bool bounded;                               /*!<    The output always happens after the input */
+    uint64_t worst_us;                          /*!<    Worst time from the input to the output */
+    uint32_t worst_iterations;                  /*!<    Iterations of the main loop that change the state on the worst path */
+    uint64_t blocking_us;                       /*!<    Time of the worst path spent in blocking actions */
+    const char *p_blocking_action;              /*!<    First blocking action of the worst path, NULL if none */
+    char witness[FSM_LATENCY_WITNESS_LEN];      /*!<    If unbounded, state where the path loops or gets stuck */
+} fsm_latency_result_t;
+
+/**
+ * @brief Blocking action reachable in the product.
+ */
+typedef struct
+{
+    fsm_latency_fsm_t fsm;      /*!<    FSM of the action */
+    const char *p_action;       /*!<    Name of the action */
+    int32_t orig_state;         /*!<    Origin state of its transition */
+    uint32_t blocking_ms;       /*!<    Time it blocks the main loop */
+} fsm_latency_blocking_t;
+
+typedef struct fsm_latency_t fsm_latency_t;     /*!<    Reachable state space of the product and the memory of the analysis */
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Fill a configuration with the product of `main.c` on the Urbanite board: timings of the port headers, sensor always
+ * powered, HC-SR04 echo timeout, reverse gear with warm standby and the deadlines of the scheduler.
+ *
+ * @param p_cfg         Pointer to the configuration.
+ */
+void fsm_latency_default_config(fsm_latency_config_t *p_cfg);
+
+/**
+ * @brief Explore the reachable state space of the product from the initial state of `main.c`.
+ *
+ * @param p_cfg         Pointer to the configuration. It is copied.
+ * @return fsm_latency_t* Pointer to the state space, NULL if there is not enough memory.
+ */
+fsm_latency_t *fsm_latency_new(const fsm_latency_config_t *p_cfg);
+
+/**
+ * @brief Get the number of reachable states of the product.
+ *
+ * @param p_fsm_latency Pointer to the state space.
+ * @return uint32_t     Number of states.
+ */
+uint32_t fsm_latency_get_num_states(fsm_latency_t *p_fsm_latency);
+
+/**
+ * @brief Compute the worst case of a pair of input and output.
+ *
+ * @param p_fsm_latency Pointer to the state space.
+ * @param query         Pair of input and output.
+ * @param p_result      Pointer to the result.
+ * @retval true if the analysis is complete, false if there is not enough memory.
+ */
+bool fsm_latency_analyse(fsm_latency_t *p_fsm_latency, fsm_latency_query_t query, fsm_latency_result_t *p_result);
+
+/**
+ * @brief Get the blocking actions that are reachable in the product.
+ *
+ * @param p_fsm_latency Pointer to the state space.
+ * @param p_blocking    Array where the blocking actions are stored.
+ * @param max           Size of the array.
+ * @return uint32_t     Number of blocking actions found (it can be greater than `max`).
+ */
+uint32_t fsm_latency_get_blocking(fsm_latency_t *p_fsm_latency, fsm_latency_blocking_t *p_blocking, uint32_t max);
+
+/**
+ * @brief Free a state space.
+ *
+ * @param p_fsm_latency Pointer to the state space.
+ */
+void fsm_latency_destroy(fsm_latency_t *p_fsm_latency);
+
+/**
+ * @brief Get a transition of the table of an FSM of the model.
+ *
+ * @param fsm           FSM.
+ * @param index         Index of the transition in the table.
+ * @param p_info        Pointer where the transition is stored.
+ * @retval true if the transition exists, false after the end of the table.
+ */
+bool fsm_latency_get_transition(fsm_latency_fsm_t fsm, uint32_t index, fsm_latency_trans_info_t *p_info);
+
+/**
+ * @brief Get the name of a state of an FSM, as in the enumeration of the firmware.
+ *
+ * @param fsm           FSM.
+ * @param state         State.
+ * @return const char*  Name, "?" if the state does not exist.
+ */
+const char *fsm_latency_state_name(fsm_latency_fsm_t fsm, int32_t state);
+
+/**
+ * @brief Get the name of an FSM.
+ *
+ * @param fsm           FSM.
+ * @return const char*  Name.
+ */
+const char *fsm_latency_fsm_name(fsm_latency_fsm_t fsm);
+
+/**
+ * @brief Get the description of a pair of input and output, for the reports.
+ *
+ * @param query         Pair of input and output.
+ * @return const char*  Description.
+ */
+const char *fsm_latency_query_name(fsm_latency_query_t query);
+
+#endif /* FSM_LATENCY_H_ */
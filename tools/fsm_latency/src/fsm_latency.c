@@ -0,0 +1,1866 @@
+/**
+ * @file fsm_latency.c
+ * @brief Exhaustive worst-case response-latency analysis of the FSMs of the Urbanite.
+ *
+ * The state of the product is a small structure: the state and the flags of each FSM, the flags and the pending timers of the
+ * port, and the inputs. The distances are abstracted to 2 bands (far and near, under half of `WARNING_MIN_CM`), so the window of
+ * the median of the ultrasound FSM is a mask of 5 bits. The guards and actions below are the ones of the firmware over this
+ * state; the names of the tables are the names of the firmware.
+ *
+ * The timers are of 2 kinds. The short ones (trigger and echo edges) can expire at any time before their maximum delay, so they
+ * are delivered between any two rounds, or waited for. The long ones (debounce, settle and measurement period) last much longer
+ * than a burst of rounds, so they only expire while the loop waits. A wait ends with any set of the timers that can expire, so the
+ * adversary can choose the order. The limits come from the period, which repeats exactly: it cannot expire more times than fit in
+ * the delay of a pending debounce or settle time (with the SysTick running), nor before the end of the measurement triggered when
+ * it restarted. The waits for that measurement are taken from the wait for the period, so a measurement costs one period.
+ *
+ * Fields that the firmware no longer reads are cleared (the class of a release once it is stored, the slots of the window
+ * not written since the start, the echo once it is used), so equivalent states are merged.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* HW dependent includes */
+#include "port_button.h"
+#include "port_ultrasound.h"
+
+/* Project includes */
+#include "fsm_latency.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define FSM_LATENCY_ECHO_TIMEOUT_US 38000   /*!<    Width of the echo of the HC-SR04 when nothing is detected */
+#define FSM_LATENCY_ECHO_START_US 500       /*!<    Maximum time from the end of the trigger to the start of the echo (burst) */
+#define FSM_LATENCY_WINDOW_MASK 0x1FU       /*!<    Mask of the window of the median (`FSM_ULTRASOUND_NUM_MEASUREMENTS` slots) */
+#define FSM_LATENCY_WINDOW_LEN 5U           /*!<    Number of slots of the window of the median */
+#define FSM_LATENCY_NONE UINT32_MAX         /*!<    Index of a state that is not in a set */
+
+/* States of the FSMs, with the names and values of the firmware */
+enum { BUTTON_RELEASED = 0, BUTTON_PRESSED_WAIT, BUTTON_PRESSED, BUTTON_RELEASED_WAIT };
+enum { WAIT_START = 0, TRIGGER_START, WAIT_ECHO_START, WAIT_ECHO_END, SET_DISTANCE };
+enum { WAIT_DISPLAY = 0, SET_DISPLAY };
+enum { OFF = 0, MEASURE, SLEEP_WHILE_OFF, SLEEP_WHILE_ON, EMERGENCY };
+
+/**
+ * @brief Class of the duration of a press measured by the button FSM, relative to the times of the Urbanite.
+ */
+enum
+{
+    DURATION_NONE = 0,      /*!<    No duration (0) */
+    DURATION_SHORT,         /*!<    Shorter than the pause time: ignored */
+    DURATION_PAUSE,         /*!<    Pause time to ON/OFF time */
+    DURATION_ON_OFF,        /*!<    ON/OFF time to emergency time */
+    DURATION_EMERGENCY,     /*!<    Longer than the emergency time */
+};
+
+/**
+ * @brief Abstract distances of the ultrasound and display FSMs.
+ */
+enum
+{
+    DIST_NONE = 0,  /*!<    -1: initial distance of the display */
+    DIST_ZERO,      /*!<    0 cm: distance of a started sensor, and the red phase of the emergency */
+    DIST_FAR,       /*!<    Over half of `WARNING_MIN_CM` */
+    DIST_NEAR,      /*!<    Under half of `WARNING_MIN_CM`: shown even if the display is paused */
+    DIST_500,       /*!<    500 cm: dark phase of the emergency */
+};
+
+/**
+ * @brief Last color written to the RGB LED.
+ */
+enum
+{
+    LED_OFF = 0,    /*!<    `COLOR_OFF` */
+    LED_RED,        /*!<    0 cm */
+    LED_FAR,        /*!<    Color of a far distance */
+    LED_NEAR,       /*!<    Color of a near distance */
+    LED_UNDEFINED,  /*!<    Distance out of the ranges of `_compute_display_levels()`: the color is not initialized */
+};
+
+/**
+ * @brief Timers of the port and the sensor (bit masks of `pending`).
+ */
+enum
+{
+    EV_DEBOUNCE = 0x01,     /*!<    Debounce of the button (`port_system_get_millis()`) */
+    EV_SETTLE = 0x02,       /*!<    Power settle of the sensor (`port_system_get_millis()`) */
+    EV_PERIOD = 0x04,       /*!<    Update of the measurement timer (TIM5): trigger ready */
+    EV_TRIGGER = 0x08,      /*!<    Update of the trigger timer (TIM3): trigger end */
+    EV_ECHO_START = 0x10,   /*!<    Rising edge of the echo (TIM2) */
+    EV_ECHO_END = 0x20,     /*!<    Falling edge of the echo (TIM2) */
+    EV_ALL = 0x3F,
+};
+#define EV_LONG (EV_DEBOUNCE | EV_SETTLE | EV_PERIOD)   /*!<    Timers that only expire while the loop waits */
+#define EV_MILLIS (EV_DEBOUNCE | EV_SETTLE)             /*!<    Timers that only advance with the SysTick */
+#define EV_SHORT (EV_TRIGGER | EV_ECHO_START | EV_ECHO_END) /*!< Timers of a measurement, restarted with the period */
+
+/**
+ * @brief Inputs of the user, the vehicle and the scene.
+ */
+enum
+{
+    IN_PRESS = 0,               /*!<    The button is pressed */
+    IN_RELEASE_SHORT,           /*!<    The button is released after a short press */
+    IN_RELEASE_PAUSE,           /*!<    The button is released after a pause press */
+    IN_RELEASE_ON_OFF,          /*!<    The button is released after an ON/OFF press */
+    IN_RELEASE_EMERGENCY,       /*!<    The button is released after an emergency press */
+    IN_REVERSE,                 /*!<    The reverse gear is engaged or released */
+    IN_IGNITION,                /*!<    The ignition is turned on or off */
+    IN_CROSSING,                /*!<    The obstacle crosses into the near band. Only applied as the input of its pair */
+    IN_NUM,
+};
+
+/**
+ * @brief Phases of the observer of a pair of input and output.
+ */
+enum { OBS_INPUT = 0, OBS_STEP_1, OBS_STEP_2, OBS_DONE };
+
+/**
+ * @brief States of the analysis of a state.
+ */
+enum { MEMO_NEW = 0, MEMO_ACTIVE, MEMO_DONE, MEMO_UNBOUNDED };
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief State of the product. All the fields are bytes, so states are compared and hashed as memory.
+ */
+typedef struct
+{
+    /* Button FSM and button */
+    uint8_t btn;                /*!<    State of the button FSM */
+    uint8_t btn_duration;       /*!<    Class of the duration measured */
+    uint8_t btn_timeout;        /*!<    The debounce time has expired (`check_timeout`) */
+    uint8_t pressed;            /*!<    Level of the button seen by its ISR */
+    uint8_t press_class;        /*!<    Class of the duration of the last release */
+    /* Ultrasound FSM */
+    uint8_t us;                 /*!<    State of the ultrasound FSM */
+    uint8_t us_status;          /*!<    The sensor is active */
+    uint8_t us_standby;         /*!<    The sensor is in warm standby */
+    uint8_t us_new;             /*!<    A new median is ready */
+    uint8_t us_idx;             /*!<    Next slot of the window */
+    uint8_t us_window;          /*!<    Window: bit i set if the distance of slot i is near */
+    uint8_t us_full;            /*!<    The window is full */
+    uint8_t us_publish_next;    /*!<    Publish the median with the next measurement */
+    uint8_t us_distance;        /*!<    Median published */
+    /* Ultrasound port */
+    uint8_t powered;            /*!<    The supply of the sensor is enabled */
+    uint8_t tim5;               /*!<    The measurement timer is running */
+    uint8_t period_standby;     /*!<    The measurement timer is set to the period of the warm standby */
+    uint8_t period_long;        /*!<    The pending period may be the one of the warm standby */
+    uint8_t period_waited;      /*!<    Timers of the measurement waited for since the period restarted (`EV_SHORT`) */
+    uint8_t trig_ready;         /*!<    Trigger ready flag */
+    uint8_t trig_end;           /*!<    Trigger end flag */
+    uint8_t echo_armed;         /*!<    The echo timer is running */
+    uint8_t echo_init;          /*!<    The start of the echo has been captured */
+    uint8_t echo_received;      /*!<    The end of the echo has been captured */
+    uint8_t echo_sample;        /*!<    Band of the distance of the echo captured */
+    /* Display FSM and LED */
+    uint8_t disp;               /*!<    State of the display FSM */
+    uint8_t disp_status;        /*!<    The display is active */
+    uint8_t disp_new_color;     /*!<    A new color has to be set */
+    uint8_t disp_idle;          /*!<    The active display is idle */
+    uint8_t disp_distance;      /*!<    Distance of the display */
+    uint8_t led;                /*!<    Last color written */
+    /* Urbanite FSM */
+    uint8_t urb;                /*!<    State of the Urbanite FSM */
+    uint8_t paused;             /*!<    The display is paused */
+    uint8_t em_aux;             /*!<    Phase of the emergency */
+    uint8_t em;                 /*!<    Emergency mode */
+    uint8_t by_reverse;         /*!<    Turned ON by the reverse gear */
+    uint8_t dismissed;          /*!<    Turned OFF with the button while in reverse */
+    /* System and inputs */
+    uint8_t systick;            /*!<    The SysTick is running */
+    uint8_t reverse;            /*!<    Reverse gear engaged */
+    uint8_t ignition;           /*!<    Ignition on */
+    uint8_t band;               /*!<    Band of the obstacle */
+    uint8_t pending;            /*!<    Timers running (`EV_*`) */
+    uint8_t debounce_periods;   /*!<    Expirations of the period since the debounce time started, with the SysTick running */
+    uint8_t settle_periods;     /*!<    Expirations of the period since the settle time started, with the SysTick running */
+    uint8_t observer;           /*!<    Phase of the observer of the pair analysed (`OBS_*`) */
+} fsm_latency_state_t;
+
+/**
+ * @brief Transition of the model: the information of the firmware table and the abstract guard and action.
+ */
+typedef struct
+{
+    fsm_latency_trans_info_t info;                                          /*!<    Transition of the firmware */
+    bool (*in)(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s); /*!<    Guard */
+    void (*out)(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s);      /*!<    Action, NULL if none */
+} fsm_latency_trans_t;
+
+/**
+ * @brief Set of states: array of states and open-addressing hash table of their indexes.
+ */
+typedef struct
+{
+    fsm_latency_state_t *p_states;  /*!<    States */
+    uint32_t num;                   /*!<    Number of states */
+    uint32_t cap;                   /*!<    Capacity of the array */
+    uint32_t *p_slots;              /*!<    Hash table: index + 1 of a state, 0 if empty */
+    uint32_t num_slots;             /*!<    Size of the hash table (power of 2) */
+} fsm_latency_set_t;
+
+/**
+ * @brief Analysis of a state: longest path to the output.
+ */
+typedef struct
+{
+    uint64_t time_us;               /*!<    Time of the longest path */
+    uint64_t blocking_us;           /*!<    Time of the longest path in blocking actions */
+    const char *p_blocking_action;  /*!<    First blocking action of the longest path */
+    uint32_t iterations;            /*!<    Iterations that change the state on the longest path */
+    uint8_t status;                 /*!<    `MEMO_*` */
+} fsm_latency_memo_t;
+
+/**
+ * @brief Transitions fired by a round of the main loop.
+ */
+typedef struct
+{
+    const fsm_latency_trans_t *p_fired[FSM_LATENCY_NUM_FSMS];  /*!<    Transition fired by each FSM, NULL if none */
+    uint64_t blocking_us;                                       /*!<    Time blocked by the actions */
+    uint64_t output_blocking_us;                                /*!<    Time blocked by the actions fired up to the output */
+    bool output;                                                /*!<    The output of the pair analysed has happened */
+    const char *p_blocking_action;                              /*!<    First blocking action */
+} fsm_latency_round_t;
+
+struct fsm_latency_t
+{
+    fsm_latency_config_t cfg;                   /*!<    Configuration */
+    fsm_latency_fsm_t order[FSM_LATENCY_NUM_FSMS]; /*!<  Order of the FSMs in a round */
+    uint32_t delay_us[8];                       /*!<    Maximum delay of each timer, by bit of `EV_*` */
+    uint8_t debounce_periods_max;               /*!<    Expirations of the period that make a pending debounce time expire first */
+    uint8_t settle_periods_max;                 /*!<    Expirations of the period that make a pending settle time expire first */
+    bool chain_in_period;                       /*!<    The timers of a measurement always expire before the period */
+    fsm_latency_set_t reach;                    /*!<    Reachable states */
+    fsm_latency_query_t query;                  /*!<    Pair analysed (`FSM_LATENCY_NUM_QUERIES` while exploring) */
+    fsm_latency_set_t paths;                    /*!<    States after the input of the pair */
+    fsm_latency_memo_t *p_memo;                 /*!<    Analysis of each state of `paths` */
+    uint32_t memo_cap;                          /*!<    Capacity of `p_memo` */
+    bool unbounded;                             /*!<    An unbounded path has been found */
+    bool out_of_memory;                         /*!<    A set could not grow */
+    char witness[FSM_LATENCY_WITNESS_LEN];      /*!<    State of the first unbounded path */
+};
+
+/* Private functions -----------------------------------------------------------*/
+/* Port and public functions of the FSMs, over the abstract state */
+/**
+ * @brief Arm a timer.
+ */
+static void _arm(fsm_latency_state_t *p_s, uint8_t ev)
+{
+    p_s->pending |= ev;
+    if (ev & EV_DEBOUNCE)
+    {
+        p_s->debounce_periods = 0;
+    }
+    if (ev & EV_SETTLE)
+    {
+        p_s->settle_periods = 0;
+    }
+}
+
+/**
+ * @brief Stop a timer.
+ */
+static void _disarm(fsm_latency_state_t *p_s, uint8_t ev)
+{
+    p_s->pending &= ~ev;
+}
+
+static void _port_power_on(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    if ((p_lat->cfg.settle_ms == 0) || p_s->powered)
+    {
+        return;
+    }
+    p_s->powered = true;
+    _arm(p_s, EV_SETTLE);
+}
+
+static bool _port_settled(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return (p_lat->cfg.settle_ms == 0) || (p_s->powered && !(p_s->pending & EV_SETTLE));
+}
+
+static void _port_reset_echo_ticks(fsm_latency_state_t *p_s)
+{
+    p_s->echo_init = false;
+    p_s->echo_received = false;
+}
+
+/**
+ * @brief Start the measurement timer from 0. The ARR is preloaded, so the pending period can still be the previous one.
+ */
+static void _port_restart_period(fsm_latency_state_t *p_s)
+{
+    p_s->tim5 = true;
+    p_s->period_long = p_s->period_long || p_s->period_standby;
+    p_s->period_waited = 0;
+    _arm(p_s, EV_PERIOD);
+}
+
+static void _port_set_period(fsm_latency_state_t *p_s, bool standby)
+{
+    p_s->period_standby = standby;
+    p_s->period_long = p_s->period_long || standby;
+}
+
+static void _port_stop_ultrasound(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    _disarm(p_s, EV_TRIGGER | EV_ECHO_START | EV_ECHO_END | EV_PERIOD);
+    p_s->echo_armed = false;
+    p_s->tim5 = false;
+    _port_reset_echo_ticks(p_s);
+    if (p_lat->cfg.settle_ms != 0)
+    {
+        p_s->powered = false;
+        _disarm(p_s, EV_SETTLE);
+    }
+}
+
+static void _port_start_measurement(fsm_latency_state_t *p_s)
+{
+    p_s->trig_ready = false;
+    _port_restart_period(p_s);
+    _arm(p_s, EV_TRIGGER);
+    p_s->echo_armed = true;
+}
+
+static void _ultrasound_start(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    if (p_s->us_status && p_s->us_standby)
+    {
+        p_s->us_standby = false;
+        p_s->us_publish_next = true;
+        p_s->us_new = false;
+        _port_set_period(p_s, false);
+        p_s->trig_ready = true;
+        return;
+    }
+
+    p_s->us_status = true;
+    p_s->us_idx = 0;
+    p_s->us_window = 0;     // Not read until the slots are written again
+    p_s->us_full = false;
+    p_s->us_publish_next = false;
+    p_s->us_distance = DIST_ZERO;
+
+    _port_power_on(p_lat, p_s);
+    _port_reset_echo_ticks(p_s);
+    p_s->trig_ready = true;
+    if (!p_s->tim5)
+    {
+        _port_restart_period(p_s);
+    }
+}
+
+static void _ultrasound_stop(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    p_s->us_status = false;
+    p_s->us = WAIT_START;
+    _port_stop_ultrasound(p_lat, p_s);
+    if (p_s->us_standby)
+    {
+        p_s->us_standby = false;
+        _port_set_period(p_s, false);
+    }
+}
+
+static void _ultrasound_start_standby(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    if (!p_s->us_status)
+    {
+        _ultrasound_start(p_lat, p_s);
+    }
+    p_s->us_standby = true;
+    _port_set_period(p_s, true);
+}
+
+static void _display_set_distance(fsm_latency_state_t *p_s, uint8_t distance)
+{
+    p_s->disp_distance = distance;
+    p_s->disp_new_color = true;
+}
+
+/* Button FSM */
+static bool btn_check_button_pressed(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return p_s->pressed;
+}
+
+static bool btn_check_timeout(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return p_s->btn_timeout;
+}
+
+static bool btn_check_button_released(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return !p_s->pressed;
+}
+
+static void btn_do_store_tick_pressed(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    p_s->btn_timeout = false;
+    _arm(p_s, EV_DEBOUNCE);
+}
+
+static void btn_do_set_duration(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    p_s->btn_duration = p_s->press_class;
+    p_s->press_class = DURATION_NONE;
+    p_s->btn_timeout = false;
+    _arm(p_s, EV_DEBOUNCE);
+}
+
+/* Ultrasound FSM */
+static bool us_check_on(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return p_s->trig_ready && p_s->us_status && _port_settled(p_lat, p_s);
+}
+
+static bool us_check_off(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return !p_s->us_status;
+}
+
+static bool us_check_trigger_end(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return p_s->trig_end;
+}
+
+static bool us_check_echo_init(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return p_s->echo_init;
+}
+
+static bool us_check_echo_received(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return p_s->echo_received;
+}
+
+static bool us_check_new_measurement(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return p_s->trig_ready;
+}
+
+static void us_do_start_measurement(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    _port_start_measurement(p_s);
+}
+
+static void us_do_stop_measurement(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    _port_stop_ultrasound(p_lat, p_s);
+}
+
+static void us_do_stop_trigger(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    _disarm(p_s, EV_TRIGGER);
+    p_s->trig_end = false;
+}
+
+static void us_do_start_new_measurement(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    _port_start_measurement(p_s);
+}
+
+static void us_do_set_distance(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    uint8_t bit = (uint8_t)(1U << p_s->us_idx);
+    p_s->us_window = (p_s->echo_sample == DIST_NEAR) ? (p_s->us_window | bit) : (p_s->us_window & ~bit);
+
+    p_s->us_idx++;
+    if (p_s->us_idx >= FSM_LATENCY_WINDOW_LEN)
+    {
+        p_s->us_idx = 0;
+        p_s->us_full = true;
+    }
+
+    if ((p_s->us_idx == 0) || (p_s->us_publish_next && p_s->us_full))
+    {
+        p_s->us_publish_next = false;
+        p_s->us_distance = (__builtin_popcount(p_s->us_window & FSM_LATENCY_WINDOW_MASK) > (int)(FSM_LATENCY_WINDOW_LEN / 2)) ? DIST_NEAR : DIST_FAR;
+        p_s->us_new = true;
+    }
+
+    p_s->echo_armed = false;
+    _disarm(p_s, EV_ECHO_START | EV_ECHO_END);
+    _port_reset_echo_ticks(p_s);
+}
+
+/* Display FSM */
+static bool disp_check_active(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return p_s->disp_status;
+}
+
+static bool disp_check_set_new_color(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return p_s->disp_new_color;
+}
+
+static bool disp_check_off(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return !p_s->disp_status;
+}
+
+static void disp_do_set_on(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    p_s->led = LED_OFF;
+}
+
+static void disp_do_set_color(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    static const uint8_t colors[] = {[DIST_NONE] = LED_UNDEFINED, [DIST_ZERO] = LED_RED, [DIST_FAR] = LED_FAR, [DIST_NEAR] = LED_NEAR, [DIST_500] = LED_UNDEFINED};
+    p_s->led = colors[p_s->disp_distance];
+    p_s->disp_new_color = false;
+    p_s->disp_idle = true;
+}
+
+static void disp_do_set_off(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    p_s->led = LED_OFF;
+    p_s->disp_idle = false;
+}
+
+/* Urbanite FSM */
+static bool _urb_warm_standby_required(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return p_lat->cfg.reverse_enabled && p_lat->cfg.warm_standby && p_s->ignition;
+}
+
+static bool urb_check_reverse_on(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return p_lat->cfg.reverse_enabled && !p_s->dismissed && p_s->reverse;
+}
+
+static bool urb_check_reverse_off(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return p_s->by_reverse && !p_s->reverse;
+}
+
+static bool urb_check_reverse_rearm(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return p_s->dismissed && !p_s->reverse;
+}
+
+static bool urb_check_warm_standby_change(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return p_lat->cfg.reverse_enabled && p_lat->cfg.warm_standby && (_urb_warm_standby_required(p_lat, p_s) != p_s->us_status);
+}
+
+static bool _urb_check_reverse_activity(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    if ((p_s->urb == OFF) || (p_s->urb == SLEEP_WHILE_OFF))
+    {
+        return urb_check_reverse_on(p_lat, p_s) || urb_check_reverse_rearm(p_lat, p_s) || urb_check_warm_standby_change(p_lat, p_s);
+    }
+    return urb_check_reverse_off(p_lat, p_s);
+}
+
+static bool urb_check_on(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return (p_s->btn_duration == DURATION_ON_OFF) || (p_s->btn_duration == DURATION_EMERGENCY);
+}
+
+static bool urb_check_off(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return p_s->btn_duration == DURATION_ON_OFF;
+}
+
+static bool urb_check_emergency_on(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return p_s->btn_duration == DURATION_EMERGENCY;
+}
+
+static bool urb_check_emergency_continue(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return p_s->em;
+}
+
+static bool urb_check_emergency_off(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return p_s->btn_duration == DURATION_EMERGENCY;
+}
+
+static bool urb_check_new_measure(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return p_s->us_new;
+}
+
+static bool urb_check_pause_display(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return p_s->btn_duration == DURATION_PAUSE;
+}
+
+static bool urb_check_activity(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    bool display_activity = p_s->disp_status && !p_s->disp_idle;
+    bool button_activity = (p_s->btn != BUTTON_RELEASED);
+    return display_activity || button_activity || _urb_check_reverse_activity(p_lat, p_s);
+}
+
+static bool urb_check_no_activity(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return !urb_check_activity(p_lat, p_s);
+}
+
+static bool urb_check_activity_in_measure(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    return urb_check_new_measure(p_lat, p_s) || (p_s->btn != BUTTON_RELEASED) || urb_check_reverse_off(p_lat, p_s);
+}
+
+static void _urb_stop_or_standby(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    if (_urb_warm_standby_required(p_lat, p_s))
+    {
+        _ultrasound_start_standby(p_lat, p_s);
+    }
+    else
+    {
+        _ultrasound_stop(p_lat, p_s);
+    }
+}
+
+static void urb_do_start_up_measure(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    p_s->btn_duration = DURATION_NONE;
+    _ultrasound_start(p_lat, p_s);
+    p_s->disp_status = true;
+}
+
+static void urb_do_stop_urbanite(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    p_s->btn_duration = DURATION_NONE;
+    _urb_stop_or_standby(p_lat, p_s);
+    p_s->disp_status = false;
+    p_s->paused = false;
+    p_s->dismissed = p_lat->cfg.reverse_enabled && p_s->reverse;
+    p_s->by_reverse = false;
+}
+
+static void urb_do_start_up_reverse(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    p_s->by_reverse = true;
+    _ultrasound_start(p_lat, p_s);
+    p_s->disp_status = true;
+}
+
+static void urb_do_stop_reverse(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    p_s->by_reverse = false;
+    p_s->paused = false;
+    _urb_stop_or_standby(p_lat, p_s);
+    p_s->disp_status = false;
+}
+
+static void urb_do_rearm_reverse(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    p_s->dismissed = false;
+}
+
+static void urb_do_warm_standby(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    _urb_stop_or_standby(p_lat, p_s);
+}
+
+static void urb_do_pause_display(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    p_s->btn_duration = DURATION_NONE;
+    p_s->paused = !p_s->paused;
+    p_s->disp_status = !p_s->paused;
+}
+
+static void urb_do_display_distance(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    uint8_t distance = p_s->us_distance;
+    p_s->us_new = false;
+
+    if (p_s->paused)
+    {
+        if ((distance == DIST_ZERO) || (distance == DIST_NEAR))
+        {
+            _display_set_distance(p_s, distance);
+            p_s->disp_status = true;
+        }
+        else
+        {
+            p_s->disp_status = false;
+        }
+    }
+    else
+    {
+        _display_set_distance(p_s, distance);
+    }
+}
+
+static void urb_do_start_emergency(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    p_s->btn_duration = DURATION_NONE;
+    p_s->disp_status = true;
+    _ultrasound_stop(p_lat, p_s);
+    p_s->em_aux = true;
+    p_s->em = true;
+}
+
+static void urb_do_stop_emergency(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    p_s->btn_duration = DURATION_NONE;
+    _ultrasound_start(p_lat, p_s);
+    if (p_s->paused)
+    {
+        p_s->disp_status = false;
+    }
+    p_s->em_aux = false;
+    p_s->em = false;
+}
+
+static void urb_do_continue_emergency(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    _display_set_distance(p_s, p_s->em_aux ? DIST_ZERO : DIST_500);
+    p_s->em_aux = !p_s->em_aux;
+}
+
+static void urb_do_sleep(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    // The millisecond counter stops: the periods that expire from now on do not count for the debounce and settle times
+    p_s->systick = false;
+    p_s->debounce_periods = 0;
+    p_s->settle_periods = 0;
+}
+
+/* Transition tables, in the order of the firmware */
+#define TRANS(fsm, orig, in, dest, out, blocking_ms) {{orig, #in, dest, #out, blocking_ms}, fsm##_##in, fsm##_##out}   /*!< Transition with an action @hideinitializer */
+#define TRANS_NO_OUT(fsm, orig, in, dest) {{orig, #in, dest, NULL, 0}, fsm##_##in, NULL}                                /*!< Transition without action @hideinitializer */
+#define urb_do_sleep_off urb_do_sleep                   /*!< The 4 sleep actions of the Urbanite start the low power mode @hideinitializer */
+#define urb_do_sleep_while_off urb_do_sleep             /*!< See `urb_do_sleep_off` @hideinitializer */
+#define urb_do_sleep_while_measure urb_do_sleep         /*!< See `urb_do_sleep_off` @hideinitializer */
+#define urb_do_sleep_while_on urb_do_sleep              /*!< See `urb_do_sleep_off` @hideinitializer */
+
+static const fsm_latency_trans_t trans_button[] = {
+    TRANS(btn, BUTTON_RELEASED, check_button_pressed, BUTTON_PRESSED_WAIT, do_store_tick_pressed, 0),
+    TRANS_NO_OUT(btn, BUTTON_PRESSED_WAIT, check_timeout, BUTTON_PRESSED),
+    TRANS(btn, BUTTON_PRESSED, check_button_released, BUTTON_RELEASED_WAIT, do_set_duration, 0),
+    TRANS_NO_OUT(btn, BUTTON_RELEASED_WAIT, check_timeout, BUTTON_RELEASED),
+};
+
+static const fsm_latency_trans_t trans_ultrasound[] = {
+    TRANS(us, WAIT_START, check_on, TRIGGER_START, do_start_measurement, 0),
+    TRANS(us, TRIGGER_START, check_trigger_end, WAIT_ECHO_START, do_stop_trigger, 0),
+    TRANS_NO_OUT(us, WAIT_ECHO_START, check_echo_init, WAIT_ECHO_END),
+    TRANS(us, WAIT_ECHO_END, check_echo_received, SET_DISTANCE, do_set_distance, 0),
+    TRANS(us, SET_DISTANCE, check_new_measurement, TRIGGER_START, do_start_new_measurement, 0),
+    TRANS(us, SET_DISTANCE, check_off, WAIT_START, do_stop_measurement, 0),
+};
+
+static const fsm_latency_trans_t trans_display[] = {
+    TRANS(disp, WAIT_DISPLAY, check_active, SET_DISPLAY, do_set_on, 0),
+    TRANS(disp, SET_DISPLAY, check_set_new_color, SET_DISPLAY, do_set_color, 0),
+    TRANS(disp, SET_DISPLAY, check_off, WAIT_DISPLAY, do_set_off, 0),
+};
+
+static const fsm_latency_trans_t trans_urbanite[] = {
+    TRANS(urb, OFF, check_no_activity, SLEEP_WHILE_OFF, do_sleep_off, 0),
+    TRANS_NO_OUT(urb, SLEEP_WHILE_OFF, check_activity, OFF),
+    TRANS(urb, SLEEP_WHILE_OFF, check_no_activity, SLEEP_WHILE_OFF, do_sleep_while_off, 0),
+    TRANS(urb, OFF, check_on, MEASURE, do_start_up_measure, 0),
+    TRANS(urb, OFF, check_reverse_on, MEASURE, do_start_up_reverse, 0),
+    TRANS(urb, OFF, check_reverse_rearm, OFF, do_rearm_reverse, 0),
+    TRANS(urb, OFF, check_warm_standby_change, OFF, do_warm_standby, 0),
+    TRANS(urb, MEASURE, check_pause_display, MEASURE, do_pause_display, 0),
+    TRANS(urb, MEASURE, check_new_measure, MEASURE, do_display_distance, 0),
+    TRANS(urb, MEASURE, check_no_activity, SLEEP_WHILE_ON, do_sleep_while_measure, 0),
+    TRANS_NO_OUT(urb, SLEEP_WHILE_ON, check_activity_in_measure, MEASURE),
+    TRANS(urb, SLEEP_WHILE_ON, check_no_activity, SLEEP_WHILE_ON, do_sleep_while_on, 0),
+    TRANS(urb, MEASURE, check_emergency_on, EMERGENCY, do_start_emergency, 0),
+    TRANS(urb, EMERGENCY, check_emergency_off, MEASURE, do_stop_emergency, 0),
+    TRANS(urb, EMERGENCY, check_emergency_continue, EMERGENCY, do_continue_emergency, 1000),
+    TRANS(urb, MEASURE, check_off, OFF, do_stop_urbanite, 0),
+    TRANS(urb, MEASURE, check_reverse_off, OFF, do_stop_reverse, 0),
+};
+
+/**
+ * @brief Tables of the FSMs, indexed by `fsm_latency_fsm_t`.
+ */
+static const struct
+{
+    const fsm_latency_trans_t *p_trans;     /*!<    Transitions */
+    uint32_t num_trans;                     /*!<    Number of transitions */
+    const char *p_name;                     /*!<    Name of the FSM */
+    const char *const *p_state_names;       /*!<    Names of the states */
+    uint32_t num_states;                    /*!<    Number of states */
+} fsm_tables[FSM_LATENCY_NUM_FSMS] = {
+    [FSM_LATENCY_BUTTON] = {trans_button, sizeof(trans_button) / sizeof(trans_button[0]), "button",
+                            (const char *const[]){"BUTTON_RELEASED", "BUTTON_PRESSED_WAIT", "BUTTON_PRESSED", "BUTTON_RELEASED_WAIT"}, 4},
+    [FSM_LATENCY_ULTRASOUND] = {trans_ultrasound, sizeof(trans_ultrasound) / sizeof(trans_ultrasound[0]), "ultrasound",
+                                (const char *const[]){"WAIT_START", "TRIGGER_START", "WAIT_ECHO_START", "WAIT_ECHO_END", "SET_DISTANCE"}, 5},
+    [FSM_LATENCY_DISPLAY] = {trans_display, sizeof(trans_display) / sizeof(trans_display[0]), "display",
+                             (const char *const[]){"WAIT_DISPLAY", "SET_DISPLAY"}, 2},
+    [FSM_LATENCY_URBANITE] = {trans_urbanite, sizeof(trans_urbanite) / sizeof(trans_urbanite[0]), "urbanite",
+                              (const char *const[]){"OFF", "MEASURE", "SLEEP_WHILE_OFF", "SLEEP_WHILE_ON", "EMERGENCY"}, 5},
+};
+
+/* Sets of states */
+/**
+ * @brief Hash of a state (FNV-1a).
+ */
+static uint32_t _hash(const fsm_latency_state_t *p_s)
+{
+    const uint8_t *p = (const uint8_t *)p_s;
+    uint32_t h = 2166136261U;
+    for (size_t i = 0; i < sizeof(*p_s); i++)
+    {
+        h = (h ^ p[i]) * 16777619U;
+    }
+    return h;
+}
+
+static void _set_free(fsm_latency_set_t *p_set)
+{
+    free(p_set->p_states);
+    free(p_set->p_slots);
+    memset(p_set, 0, sizeof(*p_set));
+}
+
+/**
+ * @brief Double the hash table of a set and insert again its states.
+ */
+static bool _set_rehash(fsm_latency_set_t *p_set)
+{
+    uint32_t num_slots = (p_set->num_slots == 0) ? 1024U : 2U * p_set->num_slots;
+    uint32_t *p_slots = calloc(num_slots, sizeof(uint32_t));
+    if (p_slots == NULL)
+    {
+        return false;
+    }
+    for (uint32_t i = 0; i < p_set->num; i++)
+    {
+        uint32_t slot = _hash(&p_set->p_states[i]) & (num_slots - 1U);
+        while (p_slots[slot] != 0)
+        {
+            slot = (slot + 1U) & (num_slots - 1U);
+        }
+        p_slots[slot] = i + 1U;
+    }
+    free(p_set->p_slots);
+    p_set->p_slots = p_slots;
+    p_set->num_slots = num_slots;
+    return true;
+}
+
+/**
+ * @brief Find a state in a set, and add it if it is not there.
+ *
+ * @param p_set     Pointer to the set.
+ * @param p_s       Pointer to the state.
+ * @param p_added   Pointer where it is stored if the state has been added.
+ * @return uint32_t Index of the state, `FSM_LATENCY_NONE` if there is not enough memory.
+ */
+static uint32_t _set_add(fsm_latency_set_t *p_set, const fsm_latency_state_t *p_s, bool *p_added)
+{
+    *p_added = false;
+    if ((2U * (p_set->num + 1U) > p_set->num_slots) && !_set_rehash(p_set))
+    {
+        return FSM_LATENCY_NONE;
+    }
+
+    uint32_t slot = _hash(p_s) & (p_set->num_slots - 1U);
+    while (p_set->p_slots[slot] != 0)
+    {
+        uint32_t idx = p_set->p_slots[slot] - 1U;
+        if (memcmp(&p_set->p_states[idx], p_s, sizeof(*p_s)) == 0)
+        {
+            return idx;
+        }
+        slot = (slot + 1U) & (p_set->num_slots - 1U);
+    }
+
+    if (p_set->num == p_set->cap)
+    {
+        uint32_t cap = (p_set->cap == 0) ? 1024U : 2U * p_set->cap;
+        fsm_latency_state_t *p_states = realloc(p_set->p_states, cap * sizeof(fsm_latency_state_t));
+        if (p_states == NULL)
+        {
+            return FSM_LATENCY_NONE;
+        }
+        p_set->p_states = p_states;
+        p_set->cap = cap;
+    }
+    p_set->p_states[p_set->num] = *p_s;
+    p_set->p_slots[slot] = p_set->num + 1U;
+    *p_added = true;
+    return p_set->num++;
+}
+
+/* Semantics of the product */
+/**
+ * @brief Maximum delay of a timer.
+ */
+static uint32_t _delay_us(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s, uint8_t ev)
+{
+    if ((ev == EV_PERIOD) && p_s->period_long)
+    {
+        return p_lat->cfg.standby_period_ms * 1000U;
+    }
+    return p_lat->delay_us[__builtin_ctz(ev)];
+}
+
+/**
+ * @brief Timers that can be delivered: running, and not based on the SysTick while it is stopped.
+ *
+ * @param p_s       Pointer to the state.
+ * @param waiting   The loop waits for them: the long timers can be delivered too.
+ */
+static uint8_t _deliverable(const fsm_latency_state_t *p_s, bool waiting)
+{
+    uint8_t ev = p_s->pending;
+    if (!p_s->systick)
+    {
+        ev &= ~EV_MILLIS;
+    }
+    if (!waiting)
+    {
+        ev &= ~EV_LONG;
+    }
+    return ev;
+}
+
+/**
+ * @brief Check that a set of timers can expire together: the period cannot expire again once a pending debounce or settle time
+ * must have expired before it, nor before the end of the measurement started with it.
+ */
+static bool _feasible(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s, uint8_t mask)
+{
+    if (!(mask & EV_PERIOD))
+    {
+        return true;
+    }
+    if (p_lat->chain_in_period && ((p_s->pending & (EV_TRIGGER | EV_ECHO_START)) || ((p_s->pending & EV_ECHO_END) && !(mask & EV_ECHO_END))))
+    {
+        return false;
+    }
+    if ((p_s->pending & EV_DEBOUNCE) && !(mask & EV_DEBOUNCE) && (p_s->debounce_periods >= p_lat->debounce_periods_max))
+    {
+        return false;
+    }
+    return !((p_s->pending & EV_SETTLE) && !(mask & EV_SETTLE) && (p_s->settle_periods >= p_lat->settle_periods_max));
+}
+
+/**
+ * @brief Deliver a timer: the ISR sets its flag.
+ */
+static void _deliver(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s, uint8_t ev)
+{
+    switch (ev)
+    {
+    case EV_DEBOUNCE:
+        p_s->btn_timeout = true;
+        _disarm(p_s, EV_DEBOUNCE);
+        break;
+    case EV_SETTLE:
+        _disarm(p_s, EV_SETTLE);
+        break;
+    case EV_PERIOD:
+        // The timer goes on with the period of its ARR
+        p_s->trig_ready = true;
+        p_s->period_long = p_s->period_standby;
+        p_s->period_waited = 0;
+        if (p_s->systick)
+        {
+            p_s->debounce_periods += ((p_s->pending & EV_DEBOUNCE) && (p_s->debounce_periods < p_lat->debounce_periods_max)) ? 1U : 0U;
+            p_s->settle_periods += ((p_s->pending & EV_SETTLE) && (p_s->settle_periods < p_lat->settle_periods_max)) ? 1U : 0U;
+        }
+        break;
+    case EV_TRIGGER:
+        p_s->trig_end = true;
+        _disarm(p_s, EV_TRIGGER);
+        if (p_s->echo_armed)
+        {
+            _arm(p_s, EV_ECHO_START);
+        }
+        break;
+    case EV_ECHO_START:
+        p_s->echo_init = true;
+        p_s->systick = true;
+        _disarm(p_s, EV_ECHO_START);
+        _arm(p_s, EV_ECHO_END);
+        break;
+    case EV_ECHO_END:
+        p_s->echo_received = true;
+        p_s->echo_sample = (p_s->band == DIST_NEAR) ? DIST_NEAR : DIST_FAR;
+        p_s->systick = true;
+        _disarm(p_s, EV_ECHO_END);
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Deliver a set of timers, in the order they can be chained (trigger, echo start, echo end).
+ */
+static void _deliver_mask(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s, uint8_t mask)
+{
+    for (uint8_t ev = 1; ev <= EV_ECHO_END; ev <<= 1)
+    {
+        if (mask & ev)
+        {
+            _deliver(p_lat, p_s, ev);
+        }
+    }
+}
+
+/**
+ * @brief Deliver the timers that must have expired during a blocking action, including the ones they arm.
+ */
+static void _deliver_expired(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s, uint64_t elapsed_us)
+{
+    uint8_t delivered = 0;
+    uint8_t due;
+    do
+    {
+        due = 0;
+        for (uint8_t ev = 1; ev <= EV_ECHO_END; ev <<= 1)
+        {
+            if ((_deliverable(p_s, true) & ev & ~delivered) && (_delay_us(p_lat, p_s, ev) <= elapsed_us))
+            {
+                due |= ev;
+            }
+        }
+        _deliver_mask(p_lat, p_s, due);
+        delivered |= due;
+    } while (due != 0);
+}
+
+/**
+ * @brief Observer of the pair analysed: follow its phases with the transitions fired, or at the end of a round (`p_trans` NULL).
+ */
+static void _observe(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s, fsm_latency_fsm_t fsm, const fsm_latency_trans_t *p_trans)
+{
+    const char *p_out = (p_trans != NULL) ? p_trans->info.p_out : NULL;
+    bool entered_measure = (fsm == FSM_LATENCY_URBANITE) && (p_trans != NULL) && (p_trans->info.dest_state == MEASURE) && (p_trans->info.orig_state != MEASURE);
+    bool entered_off = (fsm == FSM_LATENCY_URBANITE) && (p_trans != NULL) && (p_trans->info.dest_state == OFF) && (p_trans->info.orig_state == MEASURE);
+    bool displayed = (p_out != NULL) && (strcmp(p_out, "do_display_distance") == 0);
+    bool colored = (p_out != NULL) && (strcmp(p_out, "do_set_color") == 0);
+
+    switch (p_lat->query)
+    {
+    case FSM_LATENCY_PRESS_ON:
+    case FSM_LATENCY_PRESS_EMERGENCY_OFF:
+        if (entered_measure)
+        {
+            p_s->observer = OBS_DONE;
+        }
+        break;
+    case FSM_LATENCY_PRESS_ON_DISTANCE:
+    case FSM_LATENCY_REVERSE_ON:
+        if (entered_measure && (p_s->observer == OBS_INPUT))
+        {
+            p_s->observer = OBS_STEP_1;
+        }
+        else if (displayed && (p_s->observer == OBS_STEP_1))
+        {
+            p_s->observer = OBS_STEP_2;
+        }
+        else if (colored && (p_s->observer == OBS_STEP_2))
+        {
+            p_s->observer = OBS_DONE;
+        }
+        break;
+    case FSM_LATENCY_PRESS_OFF:
+    case FSM_LATENCY_REVERSE_OFF:
+        if (entered_off)
+        {
+            p_s->observer = OBS_STEP_1;
+        }
+        else if ((p_trans == NULL) && (p_s->observer == OBS_STEP_1) && (p_s->disp == WAIT_DISPLAY))
+        {
+            p_s->observer = OBS_DONE;
+        }
+        break;
+    case FSM_LATENCY_PRESS_PAUSE:
+        if ((p_out != NULL) && (strcmp(p_out, "do_pause_display") == 0))
+        {
+            p_s->observer = OBS_STEP_1;
+        }
+        else if ((p_trans == NULL) && (p_s->observer == OBS_STEP_1) && (p_s->disp == WAIT_DISPLAY))
+        {
+            p_s->observer = OBS_DONE;
+        }
+        break;
+    case FSM_LATENCY_PRESS_EMERGENCY:
+        if ((p_out != NULL) && (strcmp(p_out, "do_start_emergency") == 0))
+        {
+            p_s->observer = OBS_STEP_1;
+        }
+        else if (colored && (p_s->observer == OBS_STEP_1) && (p_s->led == LED_RED))
+        {
+            p_s->observer = OBS_DONE;
+        }
+        break;
+    case FSM_LATENCY_ECHO:
+        if ((p_out != NULL) && (strcmp(p_out, "do_set_distance") == 0) && p_s->us_new)
+        {
+            p_s->observer = OBS_STEP_1;
+        }
+        else if (displayed && (p_s->observer == OBS_STEP_1))
+        {
+            p_s->observer = OBS_STEP_2;
+        }
+        else if (colored && (p_s->observer == OBS_STEP_2))
+        {
+            p_s->observer = OBS_DONE;
+        }
+        break;
+    case FSM_LATENCY_CROSSING:
+        if (colored && (p_s->led == LED_NEAR))
+        {
+            p_s->observer = OBS_DONE;
+        }
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Run a round of the main loop: fire each FSM once, in the order of the scheduler.
+ */
+static void _round(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s, fsm_latency_round_t *p_round)
+{
+    memset(p_round, 0, sizeof(*p_round));
+    for (uint32_t i = 0; i < FSM_LATENCY_NUM_FSMS; i++)
+    {
+        fsm_latency_fsm_t fsm = p_lat->order[i];
+        uint8_t *p_state = (fsm == FSM_LATENCY_BUTTON) ? &p_s->btn : (fsm == FSM_LATENCY_ULTRASOUND) ? &p_s->us : (fsm == FSM_LATENCY_DISPLAY) ? &p_s->disp : &p_s->urb;
+
+        for (uint32_t t = 0; t < fsm_tables[fsm].num_trans; t++)
+        {
+            const fsm_latency_trans_t *p_trans = &fsm_tables[fsm].p_trans[t];
+            if ((p_trans->info.orig_state == *p_state) && p_trans->in(p_lat, p_s))
+            {
+                if (p_trans->out != NULL)
+                {
+                    p_trans->out(p_lat, p_s);
+                }
+                *p_state = (uint8_t)p_trans->info.dest_state;
+                p_round->p_fired[fsm] = p_trans;
+                if (p_trans->info.blocking_ms != 0)
+                {
+                    p_round->blocking_us += p_trans->info.blocking_ms * 1000ULL;
+                    p_round->p_blocking_action = (p_round->p_blocking_action != NULL) ? p_round->p_blocking_action : p_trans->info.p_out;
+                }
+                _observe(p_lat, p_s, fsm, p_trans);
+                if ((p_s->observer == OBS_DONE) && !p_round->output)
+                {
+                    p_round->output = true;
+                    p_round->output_blocking_us = p_round->blocking_us;
+                }
+                break;
+            }
+        }
+    }
+    _observe(p_lat, p_s, FSM_LATENCY_NUM_FSMS, NULL);
+    if ((p_s->observer == OBS_DONE) && !p_round->output)
+    {
+        p_round->output = true;
+        p_round->output_blocking_us = p_round->blocking_us;
+    }
+}
+
+/**
+ * @brief Apply an input of the user, the vehicle or the scene. Their ISRs resume the SysTick.
+ *
+ * @retval true if the input can happen in the state.
+ */
+static bool _input(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s, uint32_t in)
+{
+    switch (in)
+    {
+    case IN_PRESS:
+        if (p_s->pressed)
+        {
+            return false;
+        }
+        p_s->pressed = true;
+        break;
+    case IN_RELEASE_SHORT:
+    case IN_RELEASE_PAUSE:
+    case IN_RELEASE_ON_OFF:
+    case IN_RELEASE_EMERGENCY:
+        // The button FSM sees a release before the debounce time as a short press
+        if (!p_s->pressed || ((in != IN_RELEASE_SHORT) && (p_s->btn != BUTTON_PRESSED)))
+        {
+            return false;
+        }
+        p_s->pressed = false;
+        p_s->press_class = (uint8_t)(DURATION_SHORT + (in - IN_RELEASE_SHORT));
+        break;
+    case IN_REVERSE:
+        if (!p_lat->cfg.reverse_enabled)
+        {
+            return false;
+        }
+        p_s->reverse = !p_s->reverse;
+        break;
+    case IN_IGNITION:
+        if (!p_lat->cfg.reverse_enabled)
+        {
+            return false;
+        }
+        p_s->ignition = !p_s->ignition;
+        break;
+    case IN_CROSSING:
+        // The echo does not interrupt until it is measured
+        p_s->band = (p_s->band == DIST_NEAR) ? DIST_FAR : DIST_NEAR;
+        return true;
+    default:
+        return false;
+    }
+    p_s->systick = true;
+    return true;
+}
+
+/**
+ * @brief Clear the fields that are not read again until they are written, so equivalent states are merged.
+ */
+static void _canonical(fsm_latency_state_t *p_s)
+{
+    // The timeout is cleared when the debounce time starts
+    if ((p_s->btn == BUTTON_RELEASED) || (p_s->btn == BUTTON_PRESSED))
+    {
+        p_s->btn_timeout = false;
+    }
+    // The median is only read when it is new
+    if (!p_s->us_new)
+    {
+        p_s->us_distance = DIST_ZERO;
+    }
+    p_s->debounce_periods = (p_s->pending & EV_DEBOUNCE) ? p_s->debounce_periods : 0U;
+    p_s->settle_periods = (p_s->pending & EV_SETTLE) ? p_s->settle_periods : 0U;
+    p_s->period_waited = (p_s->pending & EV_PERIOD) ? p_s->period_waited : 0U;
+}
+
+/**
+ * @brief Successors of a state after a round: the timers delivered before the next round and the time they take.
+ *
+ * @param p_lat     Pointer to the analyser.
+ * @param p_pre     Pointer to the state before the round.
+ * @param p_post    Pointer to the state after the round.
+ * @param p_round   Pointer to the round.
+ * @param p_succ    Array of 64 states where the successors are stored.
+ * @param p_cost_us Array of 64 times of the successors (round, blocking and wait).
+ * @param p_changed Pointer where it is stored if the round has changed the state (it is not an idle iteration).
+ * @return uint32_t Number of successors. 0 if the loop waits for a timer that never expires.
+ */
+static uint32_t _successors(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_pre, const fsm_latency_state_t *p_post, const fsm_latency_round_t *p_round,
+                            fsm_latency_state_t *p_succ, uint64_t *p_cost_us, bool *p_changed)
+{
+    uint32_t num = 0;
+    uint64_t round_us = p_lat->cfg.round_us + p_round->blocking_us;
+    *p_changed = (memcmp(p_pre, p_post, sizeof(*p_pre)) != 0);
+
+    if (!*p_changed)
+    {
+        // Idle iteration: the loop spins or sleeps until some timers expire, at their maximum delay
+        uint8_t waitable = _deliverable(p_post, true);
+        for (uint8_t mask = waitable; mask != 0; mask = (uint8_t)((mask - 1U) & waitable))
+        {
+            if (!_feasible(p_lat, p_post, mask))
+            {
+                continue;
+            }
+            uint64_t wait_us = 0;
+            for (uint8_t ev = 1; ev <= EV_ECHO_END; ev <<= 1)
+            {
+                uint64_t delay_us = _delay_us(p_lat, p_post, ev);
+                if (ev == EV_PERIOD)
+                {
+                    // The waits for the timers of the measurement are part of the period, which restarted with it
+                    for (uint8_t waited = p_post->period_waited; waited != 0; waited &= (uint8_t)(waited - 1U))
+                    {
+                        delay_us -= _delay_us(p_lat, p_post, (uint8_t)(waited & -waited));
+                    }
+                }
+                wait_us = ((mask & ev) && (delay_us > wait_us)) ? delay_us : wait_us;
+            }
+            p_succ[num] = *p_post;
+            _deliver_mask(p_lat, &p_succ[num], mask);
+            if (p_lat->chain_in_period && (p_succ[num].pending & EV_PERIOD))
+            {
+                p_succ[num].period_waited |= mask & EV_SHORT;
+            }
+            _canonical(&p_succ[num]);
+            p_cost_us[num++] = round_us + wait_us;
+        }
+        return num;
+    }
+
+    fsm_latency_state_t base = *p_post;
+    if (p_round->blocking_us != 0)
+    {
+        _deliver_expired(p_lat, &base, round_us);
+    }
+
+    // Any subset of the short timers, which can have expired during the round
+    uint8_t ready = _deliverable(&base, false);
+    uint8_t mask = ready;
+    do
+    {
+        p_succ[num] = base;
+        _deliver_mask(p_lat, &p_succ[num], mask);
+        _canonical(&p_succ[num]);
+        p_cost_us[num++] = round_us;
+        mask = (uint8_t)((mask - 1U) & ready);
+    } while (mask != ready);
+    return num;
+}
+
+/**
+ * @brief Describe a state for the reports.
+ */
+static void _describe(const fsm_latency_state_t *p_s, char *p_buf, size_t len)
+{
+    snprintf(p_buf, len, "%s, %s, %s, %s, timers 0x%02X%s", fsm_latency_state_name(FSM_LATENCY_BUTTON, p_s->btn), fsm_latency_state_name(FSM_LATENCY_ULTRASOUND, p_s->us),
+             fsm_latency_state_name(FSM_LATENCY_DISPLAY, p_s->disp), fsm_latency_state_name(FSM_LATENCY_URBANITE, p_s->urb), p_s->pending, p_s->systick ? "" : ", SysTick stopped");
+}
+
+/**
+ * @brief Explore the reachable states from the initial one of `main.c`, with the inputs between any two rounds.
+ */
+static bool _explore(fsm_latency_t *p_lat)
+{
+    fsm_latency_state_t init;
+    memset(&init, 0, sizeof(init));
+    init.btn = BUTTON_RELEASED;
+    init.us = WAIT_START;
+    init.trig_ready = true;
+    init.us_distance = DIST_ZERO;
+    init.disp = WAIT_DISPLAY;
+    init.disp_distance = DIST_NONE;
+    init.led = LED_OFF;
+    init.urb = OFF;
+    init.systick = true;
+    init.band = DIST_FAR;
+    init.echo_sample = DIST_FAR;
+
+    bool added;
+    if (_set_add(&p_lat->reach, &init, &added) == FSM_LATENCY_NONE)
+    {
+        return false;
+    }
+
+    fsm_latency_state_t succ[64];
+    uint64_t cost_us[64];
+    for (uint32_t idx = 0; idx < p_lat->reach.num; idx++)
+    {
+        fsm_latency_state_t pre = p_lat->reach.p_states[idx];
+        fsm_latency_state_t post = pre;
+        fsm_latency_round_t round;
+        bool changed;
+        _round(p_lat, &post, &round);
+        uint32_t num = _successors(p_lat, &pre, &post, &round, succ, cost_us, &changed);
+
+        // The inputs can also happen while the loop is idle
+        if (!changed)
+        {
+            succ[num++] = post;
+        }
+
+        for (uint32_t i = 0; i < num; i++)
+        {
+            // The obstacle stays in the far band: the crossing is only the input of its pair
+            for (uint32_t in = 0; in <= IN_CROSSING; in++)
+            {
+                fsm_latency_state_t next = succ[i];
+                if ((in < IN_CROSSING) && !_input(p_lat, &next, in))
+                {
+                    continue;
+                }
+                if ((in == IN_CROSSING) && !changed && (i == num - 1U))
+                {
+                    continue;   // The idle loop without inputs nor timers is not a successor
+                }
+                if (_set_add(&p_lat->reach, &next, &added) == FSM_LATENCY_NONE)
+                {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Check if the input of the pair analysed can happen in a reachable state, and apply it.
+ *
+ * @retval true if it can happen.
+ */
+static bool _stimulus(const fsm_latency_t *p_lat, fsm_latency_state_t *p_s)
+{
+    bool on = (p_s->urb == MEASURE) || (p_s->urb == SLEEP_WHILE_ON);
+    bool off = (p_s->urb == OFF) || (p_s->urb == SLEEP_WHILE_OFF);
+    // A release of a press longer than the debounce time is seen by the button FSM in BUTTON_PRESSED
+    bool held = p_s->pressed && (p_s->btn == BUTTON_PRESSED);
+    bool measuring = on && p_s->us_status && !p_s->us_standby;
+    bool publishes = (p_s->us_idx == FSM_LATENCY_WINDOW_LEN - 1U) || (p_s->us_publish_next && p_s->us_full);
+    // No other input is pending: the durations of the older presses are used (the short ones are ignored) and the reverse gear
+    // has been seen
+    bool no_duration = (p_s->btn_duration == DURATION_NONE) || (p_s->btn_duration == DURATION_SHORT);
+    bool no_reverse = !_urb_check_reverse_activity(p_lat, p_s);
+    bool no_press = (p_s->btn == BUTTON_RELEASED) && !p_s->pressed && no_duration;
+    held = held && no_duration && no_reverse;
+    uint32_t in;
+
+    switch (p_lat->query)
+    {
+    case FSM_LATENCY_PRESS_ON:
+    case FSM_LATENCY_PRESS_ON_DISTANCE:
+        if (!(held && off))
+        {
+            return false;
+        }
+        in = IN_RELEASE_ON_OFF;
+        break;
+    case FSM_LATENCY_PRESS_OFF:
+        if (!(held && on))
+        {
+            return false;
+        }
+        in = IN_RELEASE_ON_OFF;
+        break;
+    case FSM_LATENCY_PRESS_PAUSE:
+        // Far obstacle: the paused display is turned off
+        if (!(held && on && !p_s->paused && p_s->disp_status && (p_s->band == DIST_FAR) && (p_s->us_window == 0)))
+        {
+            return false;
+        }
+        in = IN_RELEASE_PAUSE;
+        break;
+    case FSM_LATENCY_PRESS_EMERGENCY:
+        if (!(held && on))
+        {
+            return false;
+        }
+        in = IN_RELEASE_EMERGENCY;
+        break;
+    case FSM_LATENCY_PRESS_EMERGENCY_OFF:
+        if (!(held && (p_s->urb == EMERGENCY)))
+        {
+            return false;
+        }
+        in = IN_RELEASE_EMERGENCY;
+        break;
+    case FSM_LATENCY_ECHO:
+        if (!((p_s->pending & EV_ECHO_END) && measuring && !p_s->paused && publishes && no_press && no_reverse))
+        {
+            return false;
+        }
+        _deliver(p_lat, p_s, EV_ECHO_END);
+        return true;
+    case FSM_LATENCY_CROSSING:
+        // Steady far obstacle, paused or not: the near one is shown in both cases
+        if (!(measuring && no_press && no_reverse && (p_s->band == DIST_FAR) && (p_s->us_window == 0) && (p_s->disp_distance != DIST_NEAR)))
+        {
+            return false;
+        }
+        in = IN_CROSSING;
+        break;
+    case FSM_LATENCY_REVERSE_ON:
+        if (!(off && no_press && no_reverse && !p_s->reverse && !p_s->dismissed))
+        {
+            return false;
+        }
+        in = IN_REVERSE;
+        break;
+    case FSM_LATENCY_REVERSE_OFF:
+        if (!(on && no_press && p_s->reverse && p_s->by_reverse))
+        {
+            return false;
+        }
+        in = IN_REVERSE;
+        break;
+    default:
+        return false;
+    }
+    return _input(p_lat, p_s, in);
+}
+
+/**
+ * @brief Maximum time from an input to the end of the round in progress: the input can arrive right after its FSM has been fired,
+ * and the round can block in any action that leads to the state.
+ *
+ * @param p_lat         Pointer to the analyser.
+ * @param p_s           Pointer to the state after the round.
+ * @param pp_action     Pointer where the blocking action is stored, NULL if none.
+ * @return uint64_t     Time of the round.
+ */
+static uint64_t _arrival_us(const fsm_latency_t *p_lat, const fsm_latency_state_t *p_s, const char **pp_action)
+{
+    const uint8_t states[FSM_LATENCY_NUM_FSMS] = {[FSM_LATENCY_BUTTON] = p_s->btn, [FSM_LATENCY_ULTRASOUND] = p_s->us, [FSM_LATENCY_DISPLAY] = p_s->disp, [FSM_LATENCY_URBANITE] = p_s->urb};
+    uint64_t arrival_us = p_lat->cfg.round_us;
+    *pp_action = NULL;
+    for (uint32_t fsm = 0; fsm < FSM_LATENCY_NUM_FSMS; fsm++)
+    {
+        uint32_t blocking_ms = 0;
+        for (uint32_t t = 0; t < fsm_tables[fsm].num_trans; t++)
+        {
+            const fsm_latency_trans_info_t *p_info = &fsm_tables[fsm].p_trans[t].info;
+            if ((p_info->dest_state == states[fsm]) && (p_info->blocking_ms > blocking_ms))
+            {
+                blocking_ms = p_info->blocking_ms;
+                *pp_action = (*pp_action != NULL) ? *pp_action : p_info->p_out;
+            }
+        }
+        arrival_us += blocking_ms * 1000ULL;
+    }
+    return arrival_us;
+}
+
+/**
+ * @brief Mark the analysis of a state as unbounded, and keep the first witness.
+ */
+static void _unbounded(fsm_latency_t *p_lat, uint32_t idx, const fsm_latency_state_t *p_s, const char *p_why)
+{
+    p_lat->p_memo[idx].status = MEMO_UNBOUNDED;
+    if (!p_lat->unbounded)
+    {
+        int len = snprintf(p_lat->witness, sizeof(p_lat->witness), "%s: ", p_why);
+        _describe(p_s, &p_lat->witness[len], sizeof(p_lat->witness) - (size_t)len);
+        p_lat->unbounded = true;
+    }
+}
+
+/**
+ * @brief Add a state to the set of the paths, with its analysis.
+ */
+static uint32_t _paths_add(fsm_latency_t *p_lat, const fsm_latency_state_t *p_s)
+{
+    bool added;
+    uint32_t idx = _set_add(&p_lat->paths, p_s, &added);
+    if (idx == FSM_LATENCY_NONE)
+    {
+        p_lat->out_of_memory = true;
+        return FSM_LATENCY_NONE;
+    }
+    if (idx >= p_lat->memo_cap)
+    {
+        uint32_t cap = p_lat->paths.cap;
+        fsm_latency_memo_t *p_memo = realloc(p_lat->p_memo, cap * sizeof(fsm_latency_memo_t));
+        if (p_memo == NULL)
+        {
+            p_lat->out_of_memory = true;
+            return FSM_LATENCY_NONE;
+        }
+        memset(&p_memo[p_lat->memo_cap], 0, (cap - p_lat->memo_cap) * sizeof(fsm_latency_memo_t));
+        p_lat->p_memo = p_memo;
+        p_lat->memo_cap = cap;
+    }
+    return idx;
+}
+
+/**
+ * @brief Longest path from a state to the output of the pair analysed (depth-first, with the analysis of each state kept).
+ * A state already in the path means that the adversary can loop without the output.
+ */
+static void _longest(fsm_latency_t *p_lat, uint32_t idx)
+{
+    fsm_latency_state_t pre = p_lat->paths.p_states[idx];
+    fsm_latency_state_t post = pre;
+    fsm_latency_state_t succ[64];
+    uint64_t cost_us[64];
+    fsm_latency_round_t round;
+    bool changed;
+
+    p_lat->p_memo[idx].status = MEMO_ACTIVE;
+    _round(p_lat, &post, &round);
+
+    if (post.observer == OBS_DONE)
+    {
+        fsm_latency_memo_t *p_memo = &p_lat->p_memo[idx];
+        // The FSMs fired after the output do not delay it
+        p_memo->time_us = p_lat->cfg.round_us + round.output_blocking_us;
+        p_memo->blocking_us = round.output_blocking_us;
+        p_memo->p_blocking_action = (round.output_blocking_us != 0) ? round.p_blocking_action : NULL;
+        p_memo->iterations = 1;
+        p_memo->status = MEMO_DONE;
+        return;
+    }
+
+    uint32_t num = _successors(p_lat, &pre, &post, &round, succ, cost_us, &changed);
+    if (num == 0)
+    {
+        _unbounded(p_lat, idx, &post, "stuck");
+        return;
+    }
+
+    fsm_latency_memo_t best = {0};
+    for (uint32_t i = 0; i < num; i++)
+    {
+        uint32_t next = _paths_add(p_lat, &succ[i]);
+        if (next == FSM_LATENCY_NONE)
+        {
+            return;
+        }
+        if (p_lat->p_memo[next].status == MEMO_NEW)
+        {
+            _longest(p_lat, next);
+        }
+        if (p_lat->out_of_memory)
+        {
+            return;
+        }
+        if (p_lat->p_memo[next].status == MEMO_ACTIVE)
+        {
+            _unbounded(p_lat, idx, &succ[i], "loop");
+            return;
+        }
+        if (p_lat->p_memo[next].status == MEMO_UNBOUNDED)
+        {
+            p_lat->p_memo[idx].status = MEMO_UNBOUNDED;
+            return;
+        }
+
+        const fsm_latency_memo_t *p_next = &p_lat->p_memo[next];
+        uint64_t time_us = cost_us[i] + p_next->time_us;
+        if ((i == 0) || (time_us > best.time_us) || ((time_us == best.time_us) && (p_next->iterations + changed > best.iterations)))
+        {
+            best.time_us = time_us;
+            best.iterations = p_next->iterations + (changed ? 1U : 0U);
+            best.blocking_us = round.blocking_us + p_next->blocking_us;
+            best.p_blocking_action = (round.p_blocking_action != NULL) ? round.p_blocking_action : p_next->p_blocking_action;
+        }
+    }
+    best.status = MEMO_DONE;
+    p_lat->p_memo[idx] = best;
+}
+
+/* Public functions -----------------------------------------------------------*/
+void fsm_latency_default_config(fsm_latency_config_t *p_cfg)
+{
+    memset(p_cfg, 0, sizeof(*p_cfg));
+    p_cfg->round_us = 1000;     // Resolution of `port_system_get_millis()`
+    p_cfg->debounce_ms = PORT_PARKING_BUTTON_DEBOUNCE_TIME_MS;
+    p_cfg->settle_ms = 0;       // The Urbanite board has no supply-enable pin for the sensor
+    p_cfg->period_ms = PORT_PARKING_SENSOR_TIMEOUT_MS;
+    p_cfg->standby_period_ms = PORT_PARKING_SENSOR_STANDBY_PERIOD_MS;
+    p_cfg->trigger_us = PORT_PARKING_SENSOR_TRIGGER_UP_US;
+    p_cfg->echo_start_max_us = FSM_LATENCY_ECHO_START_US;
+    p_cfg->echo_max_us = FSM_LATENCY_ECHO_TIMEOUT_US;
+    p_cfg->reverse_enabled = true;
+    p_cfg->warm_standby = true;
+    p_cfg->deadline_ms[FSM_LATENCY_BUTTON] = 10;
+    p_cfg->deadline_ms[FSM_LATENCY_ULTRASOUND] = 10;
+    p_cfg->deadline_ms[FSM_LATENCY_DISPLAY] = 5;
+    p_cfg->deadline_ms[FSM_LATENCY_URBANITE] = 20;
+}
+
+fsm_latency_t *fsm_latency_new(const fsm_latency_config_t *p_cfg)
+{
+    fsm_latency_t *p_lat = calloc(1, sizeof(fsm_latency_t));
+    if (p_lat == NULL)
+    {
+        return NULL;
+    }
+    p_lat->cfg = *p_cfg;
+    p_lat->query = FSM_LATENCY_NUM_QUERIES;
+
+    // Earliest deadline first; the ties in the order the tasks are added
+    for (uint32_t i = 0; i < FSM_LATENCY_NUM_FSMS; i++)
+    {
+        uint32_t j = i;
+        while ((j > 0) && (p_cfg->deadline_ms[p_lat->order[j - 1]] > p_cfg->deadline_ms[i]))
+        {
+            p_lat->order[j] = p_lat->order[j - 1];
+            j--;
+        }
+        p_lat->order[j] = (fsm_latency_fsm_t)i;
+    }
+
+    // A debounce or a settle time expires when the millisecond counter is past it
+    p_lat->delay_us[__builtin_ctz(EV_DEBOUNCE)] = (p_cfg->debounce_ms + 1U) * 1000U;
+    p_lat->delay_us[__builtin_ctz(EV_SETTLE)] = (p_cfg->settle_ms + 1U) * 1000U;
+    p_lat->delay_us[__builtin_ctz(EV_PERIOD)] = p_cfg->period_ms * 1000U;
+    p_lat->delay_us[__builtin_ctz(EV_TRIGGER)] = p_cfg->trigger_us;
+    p_lat->delay_us[__builtin_ctz(EV_ECHO_START)] = p_cfg->echo_start_max_us;
+    p_lat->delay_us[__builtin_ctz(EV_ECHO_END)] = p_cfg->echo_max_us;
+
+    // After k expirations of the period, k - 1 whole periods (the shorter one) have elapsed
+    uint32_t period_us = (p_cfg->period_ms != 0) ? p_cfg->period_ms * 1000U : 1U;
+    p_lat->debounce_periods_max = (uint8_t)((p_lat->delay_us[__builtin_ctz(EV_DEBOUNCE)] + period_us - 1U) / period_us + 1U);
+    p_lat->settle_periods_max = (uint8_t)((p_lat->delay_us[__builtin_ctz(EV_SETTLE)] + period_us - 1U) / period_us + 1U);
+
+    // A measurement (trigger and echo) ends before the period restarted with it, if it is shorter than the period
+    uint32_t chain_us = p_cfg->trigger_us + p_cfg->echo_start_max_us + p_cfg->echo_max_us;
+    p_lat->chain_in_period = (chain_us < p_cfg->period_ms * 1000U) && (chain_us < p_cfg->standby_period_ms * 1000U);
+
+    if (!_explore(p_lat))
+    {
+        fsm_latency_destroy(p_lat);
+        return NULL;
+    }
+    return p_lat;
+}
+
+uint32_t fsm_latency_get_num_states(fsm_latency_t *p_fsm_latency)
+{
+    return p_fsm_latency->reach.num;
+}
+
+bool fsm_latency_analyse(fsm_latency_t *p_fsm_latency, fsm_latency_query_t query, fsm_latency_result_t *p_result)
+{
+    fsm_latency_t *p_lat = p_fsm_latency;
+    memset(p_result, 0, sizeof(*p_result));
+    p_result->bounded = true;
+
+    _set_free(&p_lat->paths);
+    free(p_lat->p_memo);
+    p_lat->p_memo = NULL;
+    p_lat->memo_cap = 0;
+    p_lat->query = query;
+    p_lat->unbounded = false;
+    p_lat->out_of_memory = false;
+
+    for (uint32_t i = 0; i < p_lat->reach.num; i++)
+    {
+        fsm_latency_state_t s = p_lat->reach.p_states[i];
+        const char *p_arrival_action;
+        uint64_t arrival_us = _arrival_us(p_lat, &s, &p_arrival_action);
+        if (!_stimulus(p_lat, &s))
+        {
+            continue;
+        }
+        p_result->stimuli++;
+        s.observer = OBS_INPUT;
+
+        uint32_t idx = _paths_add(p_lat, &s);
+        if (idx == FSM_LATENCY_NONE)
+        {
+            break;
+        }
+        if (p_lat->p_memo[idx].status == MEMO_NEW)
+        {
+            _longest(p_lat, idx);
+        }
+        if (p_lat->out_of_memory)
+        {
+            break;
+        }
+
+        const fsm_latency_memo_t *p_memo = &p_lat->p_memo[idx];
+        if (p_memo->status == MEMO_UNBOUNDED)
+        {
+            p_result->bounded = false;
+        }
+        else if (arrival_us + p_memo->time_us > p_result->worst_us)
+        {
+            p_result->worst_us = arrival_us + p_memo->time_us;
+            p_result->worst_iterations = p_memo->iterations;
+            p_result->blocking_us = (arrival_us - p_lat->cfg.round_us) + p_memo->blocking_us;
+            p_result->p_blocking_action = (p_arrival_action != NULL) ? p_arrival_action : p_memo->p_blocking_action;
+        }
+    }
+
+    if (!p_result->bounded)
+    {
+        snprintf(p_result->witness, sizeof(p_result->witness), "%s", p_lat->witness);
+    }
+    p_lat->query = FSM_LATENCY_NUM_QUERIES;
+    return !p_lat->out_of_memory;
+}
+
+uint32_t fsm_latency_get_blocking(fsm_latency_t *p_fsm_latency, fsm_latency_blocking_t *p_blocking, uint32_t max)
+{
+    uint32_t num = 0;
+    for (fsm_latency_fsm_t fsm = 0; fsm < FSM_LATENCY_NUM_FSMS; fsm++)
+    {
+        for (uint32_t t = 0; t < fsm_tables[fsm].num_trans; t++)
+        {
+            const fsm_latency_trans_t *p_trans = &fsm_tables[fsm].p_trans[t];
+            if (p_trans->info.blocking_ms == 0)
+            {
+                continue;
+            }
+
+            // Reachable if it is fired in a round from a reachable state
+            bool reachable = false;
+            for (uint32_t i = 0; (i < p_fsm_latency->reach.num) && !reachable; i++)
+            {
+                fsm_latency_state_t s = p_fsm_latency->reach.p_states[i];
+                fsm_latency_round_t round;
+                _round(p_fsm_latency, &s, &round);
+                reachable = (round.p_fired[fsm] == p_trans);
+            }
+            if (reachable)
+            {
+                if (num < max)
+                {
+                    p_blocking[num].fsm = fsm;
+                    p_blocking[num].p_action = p_trans->info.p_out;
+                    p_blocking[num].orig_state = p_trans->info.orig_state;
+                    p_blocking[num].blocking_ms = p_trans->info.blocking_ms;
+                }
+                num++;
+            }
+        }
+    }
+    return num;
+}
+
+void fsm_latency_destroy(fsm_latency_t *p_fsm_latency)
+{
+    _set_free(&p_fsm_latency->reach);
+    _set_free(&p_fsm_latency->paths);
+    free(p_fsm_latency->p_memo);
+    free(p_fsm_latency);
+}
+
+bool fsm_latency_get_transition(fsm_latency_fsm_t fsm, uint32_t index, fsm_latency_trans_info_t *p_info)
+{
+    if ((fsm >= FSM_LATENCY_NUM_FSMS) || (index >= fsm_tables[fsm].num_trans))
+    {
+        return false;
+    }
+    *p_info = fsm_tables[fsm].p_trans[index].info;
+    return true;
+}
+
+const char *fsm_latency_state_name(fsm_latency_fsm_t fsm, int32_t state)
+{
+    if ((fsm >= FSM_LATENCY_NUM_FSMS) || (state < 0) || ((uint32_t)state >= fsm_tables[fsm].num_states))
+    {
+        return "?";
+    }
+    return fsm_tables[fsm].p_state_names[state];
+}
+
+const char *fsm_latency_fsm_name(fsm_latency_fsm_t fsm)
+{
+    return (fsm < FSM_LATENCY_NUM_FSMS) ? fsm_tables[fsm].p_name : "?";
+}
+
+const char *fsm_latency_query_name(fsm_latency_query_t query)
+{
+    static const char *const names[FSM_LATENCY_NUM_QUERIES] = {
+        [FSM_LATENCY_PRESS_ON] = "ON press -> MEASURE",
+        [FSM_LATENCY_PRESS_ON_DISTANCE] = "ON press -> first distance on the LED",
+        [FSM_LATENCY_PRESS_OFF] = "OFF press -> LED off",
+        [FSM_LATENCY_PRESS_PAUSE] = "pause press -> LED off",
+        [FSM_LATENCY_PRESS_EMERGENCY] = "emergency press -> LED red",
+        [FSM_LATENCY_PRESS_EMERGENCY_OFF] = "emergency press in EMERGENCY -> MEASURE",
+        [FSM_LATENCY_ECHO] = "echo of a median -> LED updated",
+        [FSM_LATENCY_CROSSING] = "danger band crossing -> LED shows it",
+        [FSM_LATENCY_REVERSE_ON] = "reverse engaged -> first distance on the LED",
+        [FSM_LATENCY_REVERSE_OFF] = "reverse released -> LED off",
+    };
+    return (query < FSM_LATENCY_NUM_QUERIES) ? names[query] : "?";
+}
@@ -0,0 +1,81 @@
+/**
+ * @file fsm_latency_main.c
+ * @brief Report of the worst-case response latencies of the Urbanite: each pair of input and output, and the blocking actions
+ * against the deadlines of the scheduler. The exit status is 1 if a latency is unbounded.
+ *
+ * Usage: `fsm_latency [round_us]` (default: 1000, the resolution of `port_system_get_millis()`).
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Project includes */
+#include "fsm_latency.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define MAX_BLOCKING 16     /*!< Maximum number of blocking actions reported @hideinitializer */
+
+int main(int argc, char *argv[])
+{
+    fsm_latency_config_t cfg;
+    fsm_latency_default_config(&cfg);
+    if (argc > 1)
+    {
+        cfg.round_us = (uint32_t)strtoul(argv[1], NULL, 10);
+    }
+
+    fsm_latency_t *p_lat = fsm_latency_new(&cfg);
+    if (p_lat == NULL)
+    {
+        fprintf(stderr, "Not enough memory for the state space\n");
+        return 1;
+    }
+    printf("%u reachable states, round of %u us\n\n", fsm_latency_get_num_states(p_lat), cfg.round_us);
+    printf("%-46s %8s %6s %12s %12s\n", "input -> output", "stimuli", "iters", "worst (ms)", "blocked (ms)");
+
+    int status = 0;
+    for (fsm_latency_query_t query = 0; query < FSM_LATENCY_NUM_QUERIES; query++)
+    {
+        fsm_latency_result_t result;
+        if (!fsm_latency_analyse(p_lat, query, &result))
+        {
+            fprintf(stderr, "Not enough memory for the analysis\n");
+            fsm_latency_destroy(p_lat);
+            return 1;
+        }
+        if (!result.bounded)
+        {
+            printf("%-46s %8u %6s %12s %12s\n", fsm_latency_query_name(query), result.stimuli, "-", "UNBOUNDED", "-");
+            printf("    %s\n", result.witness);
+            status = 1;
+            continue;
+        }
+        printf("%-46s %8u %6u %12.3f %12.3f%s%s\n", fsm_latency_query_name(query), result.stimuli, result.worst_iterations, result.worst_us / 1000.0,
+               result.blocking_us / 1000.0, (result.p_blocking_action != NULL) ? "  " : "", (result.p_blocking_action != NULL) ? result.p_blocking_action : "");
+    }
+
+    fsm_latency_blocking_t blocking[MAX_BLOCKING];
+    uint32_t num = fsm_latency_get_blocking(p_lat, blocking, MAX_BLOCKING);
+    printf("\nBlocking actions:%s\n", (num == 0) ? " none" : "");
+    for (uint32_t i = 0; (i < num) && (i < MAX_BLOCKING); i++)
+    {
+        printf("  %s %s in %s: %u ms\n", fsm_latency_fsm_name(blocking[i].fsm), blocking[i].p_action, fsm_latency_state_name(blocking[i].fsm, blocking[i].orig_state),
+               blocking[i].blocking_ms);
+        for (fsm_latency_fsm_t fsm = 0; fsm < FSM_LATENCY_NUM_FSMS; fsm++)
+        {
+            if (blocking[i].blocking_ms > cfg.deadline_ms[fsm])
+            {
+                printf("    misses the deadline of %s (%u ms)\n", fsm_latency_fsm_name(fsm), cfg.deadline_ms[fsm]);
+            }
+        }
+    }
+
+    fsm_latency_destroy(p_lat);
+    return status;
+}
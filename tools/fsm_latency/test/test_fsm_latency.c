@@ -0,0 +1,309 @@
+/**
+ * @file test_fsm_latency.c
+ * @brief Unit test for the worst-case response-latency analyser of the FSMs.
+ *
+ * The model must be the firmware: its transition tables are compared row by row with the ones of the sources, the blocking time
+ * of each action with its `port_system_delay_ms()` and the order of the FSMs with the deadlines of `main.c`. The analysis runs
+ * without the reverse gear, so it is fast enough for a unit test.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdlib.h>
+#include <string.h>
+
+/* Project includes */
+#include "tools_test.h"
+#include "fsm_latency.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define TEST_TOKEN_LEN 64   /*!< Maximum length of a field of a transition of the sources @hideinitializer */
+
+/* Global variables */
+static const char *const source_files[FSM_LATENCY_NUM_FSMS] = {
+    "/common/src/fsm_button.c", "/common/src/fsm_ultrasound.c", "/common/src/fsm_display.c", "/common/src/fsm_urbanite.c",
+};     /*!< Sources of the FSMs, relative to the root of the project */
+static const char *const deadline_names[FSM_LATENCY_NUM_FSMS] = {
+    "MAIN_BUTTON_DEADLINE_MS", "MAIN_ULTRASOUND_DEADLINE_MS", "MAIN_DISPLAY_DEADLINE_MS", "MAIN_URBANITE_DEADLINE_MS",
+};     /*!< Deadlines of the tasks of the FSMs in `main.c` */
+static fsm_latency_t *p_lat;    /*!< State space of the product without the reverse gear */
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Read a source file of the project. The caller frees the text.
+ */
+static char *_read_source(const char *p_path)
+{
+    char path[512];
+    snprintf(path, sizeof(path), "%s%s", FSM_LATENCY_SOURCE_DIR, p_path);
+    FILE *p_file = fopen(path, "rb");
+    if (p_file == NULL)
+    {
+        return NULL;
+    }
+    fseek(p_file, 0, SEEK_END);
+    long len = ftell(p_file);
+    fseek(p_file, 0, SEEK_SET);
+    char *p_text = calloc((size_t)len + 1U, 1);
+    if ((p_text != NULL) && (fread(p_text, 1, (size_t)len, p_file) != (size_t)len))
+    {
+        free(p_text);
+        p_text = NULL;
+    }
+    fclose(p_file);
+    return p_text;
+}
+
+/**
+ * @brief Read a field of a row of a transition table (`{orig, in, dest, out}`), and move past its separator.
+ */
+static const char *_read_token(const char *p, char *p_token)
+{
+    while ((*p == ' ') || (*p == '\t') || (*p == '{'))
+    {
+        p++;
+    }
+    size_t len = 0;
+    while ((*p != ',') && (*p != '}') && (*p != '\0') && (len < TEST_TOKEN_LEN - 1U))
+    {
+        if ((*p != ' ') && (*p != '\t'))
+        {
+            p_token[len++] = *p;
+        }
+        p++;
+    }
+    p_token[len] = '\0';
+    return (*p == ',') ? p + 1 : p;
+}
+
+/**
+ * @brief Longest delay of the `port_system_delay_ms()` calls in the body of an action of a source, 0 if none.
+ */
+static uint32_t _action_delay_ms(const char *p_text, const char *p_action)
+{
+    char signature[TEST_TOKEN_LEN + 32];
+    snprintf(signature, sizeof(signature), "static void %s(", p_action);
+    const char *p_body = strstr(p_text, signature);
+    if (p_body == NULL)
+    {
+        return 0;
+    }
+    const char *p_end = strstr(p_body, "\n}");
+    uint32_t delay_ms = 0;
+    for (const char *p = strstr(p_body, "port_system_delay_ms("); (p != NULL) && (p < p_end); p = strstr(p + 1, "port_system_delay_ms("))
+    {
+        uint32_t ms = (uint32_t)strtoul(p + strlen("port_system_delay_ms("), NULL, 10);
+        delay_ms = (ms > delay_ms) ? ms : delay_ms;
+    }
+    return delay_ms;
+}
+
+/* Tests */
+/**
+ * @brief The transitions of the model are the ones of the firmware, in the same order, with the blocking time of their actions.
+ */
+static void test_tables_match_sources(void)
+{
+    for (fsm_latency_fsm_t fsm = 0; fsm < FSM_LATENCY_NUM_FSMS; fsm++)
+    {
+        char *p_text = _read_source(source_files[fsm]);
+        TOOLS_TEST_ASSERT(p_text != NULL, "The source of an FSM cannot be read");
+        if (p_text == NULL)
+        {
+            continue;
+        }
+
+        char table[TEST_TOKEN_LEN];
+        snprintf(table, sizeof(table), "fsm_trans_%s[] = {", fsm_latency_fsm_name(fsm));
+        const char *p = strstr(p_text, table);
+        TOOLS_TEST_ASSERT(p != NULL, "The transition table of an FSM is not in its source");
+        p = (p != NULL) ? p + strlen(table) - 1U : NULL;
+
+        uint32_t index = 0;
+        while (p != NULL)
+        {
+            // Next row: {orig, in, dest, out}
+            p = strchr(p + 1, '{');
+            if (p == NULL)
+            {
+                break;
+            }
+            char orig[TEST_TOKEN_LEN], in[TEST_TOKEN_LEN], dest[TEST_TOKEN_LEN], out[TEST_TOKEN_LEN];
+            p = _read_token(p, orig);
+            if (strcmp(orig, "-1") == 0)
+            {
+                break;
+            }
+            p = _read_token(p, in);
+            p = _read_token(p, dest);
+            p = _read_token(p, out);
+
+            fsm_latency_trans_info_t info;
+            TOOLS_TEST_ASSERT(fsm_latency_get_transition(fsm, index, &info), "The firmware has more transitions than the model");
+            if (!fsm_latency_get_transition(fsm, index, &info))
+            {
+                break;
+            }
+            TOOLS_TEST_ASSERT(strcmp(orig, fsm_latency_state_name(fsm, info.orig_state)) == 0, "Wrong origin state of a transition");
+            TOOLS_TEST_ASSERT(strcmp(in, info.p_in) == 0, "Wrong guard of a transition");
+            TOOLS_TEST_ASSERT(strcmp(dest, fsm_latency_state_name(fsm, info.dest_state)) == 0, "Wrong destination state of a transition");
+            TOOLS_TEST_ASSERT(strcmp(out, (info.p_out != NULL) ? info.p_out : "NULL") == 0, "Wrong action of a transition");
+            if (info.p_out != NULL)
+            {
+                TOOLS_TEST_ASSERT(_action_delay_ms(p_text, info.p_out) == info.blocking_ms, "Wrong blocking time of an action");
+            }
+            index++;
+        }
+        fsm_latency_trans_info_t info;
+        TOOLS_TEST_ASSERT(index > 0, "Empty transition table in the source");
+        TOOLS_TEST_ASSERT(!fsm_latency_get_transition(fsm, index, &info), "The model has more transitions than the firmware");
+        free(p_text);
+    }
+}
+
+/**
+ * @brief The default configuration has the deadlines of the scheduler in `main.c`.
+ */
+static void test_deadlines_match_main(void)
+{
+    fsm_latency_config_t cfg;
+    fsm_latency_default_config(&cfg);
+    char *p_text = _read_source("/main.c");
+    TOOLS_TEST_ASSERT(p_text != NULL, "main.c cannot be read");
+    if (p_text == NULL)
+    {
+        return;
+    }
+    for (fsm_latency_fsm_t fsm = 0; fsm < FSM_LATENCY_NUM_FSMS; fsm++)
+    {
+        const char *p = strstr(p_text, deadline_names[fsm]);
+        TOOLS_TEST_ASSERT(p != NULL, "Deadline of an FSM not defined in main.c");
+        if (p != NULL)
+        {
+            TOOLS_TEST_ASSERT(strtoul(p + strlen(deadline_names[fsm]), NULL, 10) == cfg.deadline_ms[fsm], "Wrong deadline of an FSM");
+        }
+    }
+    free(p_text);
+}
+
+/**
+ * @brief Every reaction has a bound, and the ones that only wait for the next rounds take a few rounds.
+ */
+static void test_bounded(void)
+{
+    fsm_latency_config_t cfg;
+    fsm_latency_default_config(&cfg);
+    for (fsm_latency_query_t query = 0; query < FSM_LATENCY_NUM_QUERIES; query++)
+    {
+        fsm_latency_result_t result;
+        TOOLS_TEST_ASSERT(fsm_latency_analyse(p_lat, query, &result), "Not enough memory for the analysis");
+        TOOLS_TEST_ASSERT(result.bounded, fsm_latency_query_name(query));
+        if ((query == FSM_LATENCY_REVERSE_ON) || (query == FSM_LATENCY_REVERSE_OFF))
+        {
+            TOOLS_TEST_ASSERT(result.stimuli == 0, "The reverse gear cannot be used when it is disabled");
+        }
+        else
+        {
+            TOOLS_TEST_ASSERT(result.stimuli > 0, "The input of a pair never happens");
+        }
+    }
+
+    fsm_latency_result_t result;
+    fsm_latency_analyse(p_lat, FSM_LATENCY_PRESS_OFF, &result);
+    TOOLS_TEST_ASSERT(result.worst_us <= 5U * cfg.round_us, "The OFF press must turn the LED off in a few rounds");
+    fsm_latency_analyse(p_lat, FSM_LATENCY_ECHO, &result);
+    TOOLS_TEST_ASSERT(result.worst_us <= 5U * cfg.round_us, "A new median must be shown in a few rounds");
+    TOOLS_TEST_ASSERT(result.blocking_us == 0, "No action blocks the display of a median");
+}
+
+/**
+ * @brief The first distance needs the window of the median: it takes about a window of measurement periods.
+ */
+static void test_first_distance(void)
+{
+    fsm_latency_config_t cfg;
+    fsm_latency_default_config(&cfg);
+    fsm_latency_result_t on;
+    fsm_latency_result_t distance;
+    fsm_latency_analyse(p_lat, FSM_LATENCY_PRESS_ON, &on);
+    fsm_latency_analyse(p_lat, FSM_LATENCY_PRESS_ON_DISTANCE, &distance);
+    TOOLS_TEST_ASSERT(on.worst_us < distance.worst_us, "The first distance is shown after the system is ON");
+    TOOLS_TEST_ASSERT(distance.worst_us >= 4U * cfg.period_ms * 1000U, "The window of the median takes at least 4 periods to fill");
+    TOOLS_TEST_ASSERT(distance.worst_us <= 6U * cfg.period_ms * 1000U + 100U * cfg.round_us, "The first distance takes too long");
+}
+
+/**
+ * @brief The delay of the emergency blocks the main loop: it is reported, with the deadlines it misses, and it delays the reactions.
+ */
+static void test_blocking_emergency(void)
+{
+    fsm_latency_config_t cfg;
+    fsm_latency_default_config(&cfg);
+    fsm_latency_blocking_t blocking[4];
+    uint32_t num = fsm_latency_get_blocking(p_lat, blocking, 4);
+    TOOLS_TEST_ASSERT(num == 1, "The emergency must be the only blocking action");
+    if (num >= 1)
+    {
+        TOOLS_TEST_ASSERT(blocking[0].fsm == FSM_LATENCY_URBANITE, "The blocking action must be of the Urbanite");
+        TOOLS_TEST_ASSERT(strcmp(blocking[0].p_action, "do_continue_emergency") == 0, "The blocking action must be the emergency");
+        TOOLS_TEST_ASSERT(blocking[0].blocking_ms > cfg.deadline_ms[FSM_LATENCY_DISPLAY], "The emergency must miss the deadline of the display");
+    }
+
+    fsm_latency_result_t result;
+    fsm_latency_analyse(p_lat, FSM_LATENCY_PRESS_EMERGENCY_OFF, &result);
+    TOOLS_TEST_ASSERT(result.blocking_us >= 1000000U, "A press during the delay of the emergency waits for it");
+    TOOLS_TEST_ASSERT((result.p_blocking_action != NULL) && (strcmp(result.p_blocking_action, "do_continue_emergency") == 0), "The delay must be reported");
+    fsm_latency_analyse(p_lat, FSM_LATENCY_PRESS_EMERGENCY, &result);
+    TOOLS_TEST_ASSERT(result.worst_us >= 1000000U, "The red LED of the emergency comes after a delay");
+    TOOLS_TEST_ASSERT(result.worst_us < 2000000U, "The red LED must not wait for 2 delays");
+}
+
+/**
+ * @brief A slower loop gives longer bounds.
+ */
+static void test_round_time(void)
+{
+    fsm_latency_config_t cfg;
+    fsm_latency_default_config(&cfg);
+    cfg.reverse_enabled = false;
+    cfg.round_us *= 2U;
+    fsm_latency_t *p_slow = fsm_latency_new(&cfg);
+    TOOLS_TEST_ASSERT(p_slow != NULL, "Not enough memory for the state space");
+    if (p_slow == NULL)
+    {
+        return;
+    }
+    fsm_latency_result_t fast;
+    fsm_latency_result_t slow;
+    fsm_latency_analyse(p_lat, FSM_LATENCY_PRESS_OFF, &fast);
+    fsm_latency_analyse(p_slow, FSM_LATENCY_PRESS_OFF, &slow);
+    TOOLS_TEST_ASSERT(slow.bounded && (slow.worst_us > fast.worst_us), "The bound must grow with the time of a round");
+    fsm_latency_destroy(p_slow);
+}
+
+int main(void)
+{
+    fsm_latency_config_t cfg;
+    fsm_latency_default_config(&cfg);
+    cfg.reverse_enabled = false;
+    p_lat = fsm_latency_new(&cfg);
+    if (p_lat == NULL)
+    {
+        printf("Not enough memory for the state space\n");
+        return 1;
+    }
+
+    TOOLS_TEST_RUN(test_tables_match_sources);
+    TOOLS_TEST_RUN(test_deadlines_match_main);
+    TOOLS_TEST_RUN(test_bounded);
+    TOOLS_TEST_RUN(test_first_distance);
+    TOOLS_TEST_RUN(test_blocking_emergency);
+    TOOLS_TEST_RUN(test_round_time);
+
+    fsm_latency_destroy(p_lat);
+    return TOOLS_TEST_END();
+}
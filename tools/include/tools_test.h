@@ -0,0 +1,52 @@
+/**
+ * @file tools_test.h
+ * @brief Minimal assertions for the unit tests of the host tools.
+ *
+ * The host tools are built without MatrixMCU, so Unity is not available. A test is a `void` function that uses `TOOLS_TEST_ASSERT()`,
+ * and `main()` runs them with `TOOLS_TEST_RUN()` and returns `TOOLS_TEST_END()`, so CTest sees the failures in the exit status.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef TOOLS_TEST_H_
+#define TOOLS_TEST_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+
+/* Global variables */
+static unsigned tools_test_failures;   /*!< Number of failed assertions of the test program */
+
+/* Defines and enums ----------------------------------------------------------*/
+/**
+ * @brief Check a condition. If it is false, print the location and the message and count the failure, but go on with the test.
+ * @hideinitializer
+ */
+#define TOOLS_TEST_ASSERT(cond, msg)                                                    \
+    do                                                                                  \
+    {                                                                                   \
+        if (!(cond))                                                                    \
+        {                                                                               \
+            printf("%s:%d: FAIL: %s\n", __FILE__, __LINE__, (msg));                     \
+            tools_test_failures++;                                                      \
+        }                                                                               \
+    } while (0)
+
+/**
+ * @brief Run a test function and print its result.
+ * @hideinitializer
+ */
+#define TOOLS_TEST_RUN(test)                                                            \
+    do                                                                                  \
+    {                                                                                   \
+        unsigned failures_before = tools_test_failures;                                 \
+        test();                                                                         \
+        printf("%s: %s\n", #test, (tools_test_failures == failures_before) ? "PASS" : "FAIL"); \
+    } while (0)
+
+#define TOOLS_TEST_END() ((tools_test_failures == 0) ? 0 : 1)  /*!< Exit status of the test program @hideinitializer */
+
+#endif /* TOOLS_TEST_H_ */
@@ -0,0 +1,238 @@
+/**
+ * @file test_quantile.c
+ * @brief Accuracy test of the streaming quantile estimator against the exact quantiles.
+ *
+ * Each stream (uniform, bell-shaped, exponential, bimodal, echo widths with outliers, sorted in both directions and constant) is
+ * fed to estimators of the median, p90 and p99, and the estimates are compared with the exact quantiles of the whole stream in
+ * rank: the fraction of the samples below the estimate must be close to the probability. Built with a low `QUANTILE_MAX_COUNT`
+ * (`test_quantile_aging`), the positions are halved many times, so the recent samples weight more: only the stationary streams
+ * are checked, with a tolerance `TEST_AGING_FACTOR` times wider.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
+
+/* Project includes */
+#include "tools_test.h"
+#include "quantile.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define TEST_SAMPLES 100000U    /*!< Number of samples of each stream @hideinitializer */
+#define TEST_NUM_PROBS 3U       /*!< Number of quantiles estimated @hideinitializer */
+#define TEST_AGING_FACTOR 3.0   /*!< Widening of the tolerance when the positions are halved during the stream @hideinitializer */
+#define TEST_AGING (QUANTILE_MAX_COUNT < TEST_SAMPLES)  /*!< The positions are halved during the streams @hideinitializer */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Streams of the test.
+ */
+typedef enum
+{
+    STREAM_UNIFORM = 0,     /*!< Uniform in [0, 10000) */
+    STREAM_BELL,            /*!< Sum of 12 uniforms (close to a normal distribution) */
+    STREAM_EXPONENTIAL,     /*!< Exponential of mean 500 (long tail, as the loop times) */
+    STREAM_BIMODAL,         /*!< 70% around 300 and 30% around 3000 */
+    STREAM_ECHO,            /*!< Echo widths of a moving obstacle in us, with 3% timeouts */
+    STREAM_ASCENDING,       /*!< Sorted ascending */
+    STREAM_DESCENDING,      /*!< Sorted descending */
+    STREAM_CONSTANT,        /*!< Always the same value */
+    NUM_STREAMS             /*!< Number of streams */
+} test_stream_t;
+
+/* Global variables */
+static uint32_t samples[TEST_SAMPLES];      /*!< Samples of the current stream */
+static uint32_t sorted[TEST_SAMPLES];       /*!< Samples of the current stream, sorted */
+static const uint32_t probs_pct[TEST_NUM_PROBS] = {50, 90, 99};     /*!< Percentiles estimated */
+static const double tolerance[TEST_NUM_PROBS] = {0.02, 0.02, 0.005}; /*!< Maximum rank error of each percentile */
+static const bool stationary[NUM_STREAMS] = {true, true, true, true, false, false, false, true};   /*!< The distribution does not change along the stream */
+static const char *const stream_names[NUM_STREAMS] = {"uniform", "bell", "exponential", "bimodal", "echo", "ascending", "descending", "constant"};
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Pseudo-random generator (xorshift32).
+ */
+static uint32_t _random(uint32_t *p_state)
+{
+    *p_state ^= *p_state << 13;
+    *p_state ^= *p_state >> 17;
+    *p_state ^= *p_state << 5;
+    return *p_state;
+}
+
+/**
+ * @brief Comparison of `qsort()` for the exact quantiles.
+ */
+static int _compare(const void *a, const void *b)
+{
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * @brief Generate the samples of a stream.
+ */
+static void _generate(test_stream_t stream)
+{
+    uint32_t state = 0x12345678U + (uint32_t)stream;
+    for (uint32_t i = 0; i < TEST_SAMPLES; i++)
+    {
+        uint32_t r = _random(&state);
+        switch (stream)
+        {
+        case STREAM_UNIFORM:
+            samples[i] = r % 10000U;
+            break;
+        case STREAM_BELL:
+            samples[i] = 0;
+            for (uint32_t j = 0; j < 12; j++)
+            {
+                samples[i] += _random(&state) % 1000U;
+            }
+            break;
+        case STREAM_EXPONENTIAL:
+            samples[i] = (uint32_t)(-500.0 * log(((double)(r >> 8) + 1.0) / 16777217.0));
+            break;
+        case STREAM_BIMODAL:
+            samples[i] = ((r % 10U) < 7U) ? (250U + (_random(&state) % 100U)) : (2800U + (_random(&state) % 400U));
+            break;
+        case STREAM_ECHO:
+        {
+            // Obstacle approaching from 400 to 20 cm and back, 58 us/cm, +-2 cm of noise, and timeouts of the sensor
+            uint32_t phase = i % 20000U;
+            uint32_t cm = (phase < 10000U) ? (400U - (phase * 380U) / 10000U) : (20U + ((phase - 10000U) * 380U) / 10000U);
+            samples[i] = ((r % 100U) < 3U) ? 38000U : ((cm + (_random(&state) % 5U) - 2U) * 58U);
+            break;
+        }
+        case STREAM_ASCENDING:
+            samples[i] = i;
+            break;
+        case STREAM_DESCENDING:
+            samples[i] = TEST_SAMPLES - i;
+            break;
+        default:
+            samples[i] = 1234U;
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Fraction of the samples strictly below a value and fraction lower or equal, with a binary search in the sorted samples.
+ */
+static void _rank(uint32_t value, double *p_below, double *p_below_equal)
+{
+    uint32_t lo = 0, hi = TEST_SAMPLES;
+    while (lo < hi)
+    {
+        uint32_t mid = (lo + hi) / 2;
+        if (sorted[mid] < value) { lo = mid + 1; } else { hi = mid; }
+    }
+    uint32_t below = lo;
+    hi = TEST_SAMPLES;
+    while (lo < hi)
+    {
+        uint32_t mid = (lo + hi) / 2;
+        if (sorted[mid] <= value) { lo = mid + 1; } else { hi = mid; }
+    }
+    *p_below = (double)below / TEST_SAMPLES;
+    *p_below_equal = (double)lo / TEST_SAMPLES;
+}
+
+/**
+ * @brief The estimates of every stream are within the rank tolerance of the exact quantiles.
+ */
+static void test_accuracy(void)
+{
+    for (test_stream_t stream = 0; stream < NUM_STREAMS; stream++)
+    {
+        if (TEST_AGING && !stationary[stream])
+        {
+            continue;
+        }
+        _generate(stream);
+        quantile_t estimators[TEST_NUM_PROBS];
+        for (uint32_t j = 0; j < TEST_NUM_PROBS; j++)
+        {
+            quantile_init(&estimators[j], QUANTILE_PROB(probs_pct[j]));
+        }
+        for (uint32_t i = 0; i < TEST_SAMPLES; i++)
+        {
+            for (uint32_t j = 0; j < TEST_NUM_PROBS; j++)
+            {
+                quantile_update(&estimators[j], samples[i]);
+            }
+        }
+
+        for (uint32_t i = 0; i < TEST_SAMPLES; i++)
+        {
+            sorted[i] = samples[i];
+        }
+        qsort(sorted, TEST_SAMPLES, sizeof(uint32_t), _compare);
+
+        printf("%-12s", stream_names[stream]);
+        for (uint32_t j = 0; j < TEST_NUM_PROBS; j++)
+        {
+            double p = probs_pct[j] / 100.0;
+            uint32_t exact = sorted[(uint32_t)(p * (TEST_SAMPLES - 1))];
+            uint32_t estimate = quantile_get(&estimators[j]);
+            double below, below_equal;
+            _rank(estimate, &below, &below_equal);
+            // Rank error: 0 if the probability is within the ranks of the estimate (ties), else the distance to them
+            double error = (p < below) ? (below - p) : ((p > below_equal) ? (p - below_equal) : 0.0);
+            printf("  p%u: exact %6u, estimate %6u, rank error %.4f", probs_pct[j], exact, estimate, error);
+            TOOLS_TEST_ASSERT(error <= (TEST_AGING ? (TEST_AGING_FACTOR * tolerance[j]) : tolerance[j]), stream_names[stream]);
+        }
+        printf("\n");
+    }
+}
+
+/**
+ * @brief With less than 5 samples, the estimate is the exact quantile. Without samples, it is 0.
+ */
+static void test_few_samples(void)
+{
+    quantile_t median, max;
+    quantile_init(&median, QUANTILE_PROB(50));
+    quantile_init(&max, QUANTILE_PROB_ONE);
+    TOOLS_TEST_ASSERT(quantile_get(&median) == 0, "Without samples the estimate is 0");
+
+    const uint32_t values[4] = {40, 10, 30, 20};
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        quantile_update(&median, values[i]);
+        quantile_update(&max, values[i]);
+    }
+    TOOLS_TEST_ASSERT(quantile_get_count(&median) == 4, "The samples must be counted");
+    TOOLS_TEST_ASSERT(quantile_get(&median) == 30, "The median of 4 samples is the nearest rank (rounded up)");
+    TOOLS_TEST_ASSERT(quantile_get(&max) == 40, "The quantile 1 is the maximum");
+}
+
+/**
+ * @brief Samples greater than the range of the fixed point saturate instead of wrapping around.
+ */
+static void test_saturation(void)
+{
+    quantile_t q;
+    quantile_init(&q, QUANTILE_PROB(50));
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        quantile_update(&q, UINT32_MAX);
+    }
+    TOOLS_TEST_ASSERT(quantile_get(&q) == QUANTILE_MAX_VALUE, "The samples must saturate at QUANTILE_MAX_VALUE");
+}
+
+int main(void)
+{
+    printf("QUANTILE_MAX_COUNT = %lu\n", (unsigned long)QUANTILE_MAX_COUNT);
+    TOOLS_TEST_RUN(test_accuracy);
+    TOOLS_TEST_RUN(test_few_samples);
+    TOOLS_TEST_RUN(test_saturation);
+    return TOOLS_TEST_END();
+}
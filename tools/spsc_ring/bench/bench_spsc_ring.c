@@ -0,0 +1,182 @@
+/**
+ * @file bench_spsc_ring.c
+ * @brief Benchmark of the lock-free SPSC ring buffer: throughput of single and batch transfers.
+ *
+ * Each case moves the elements from a producer to a consumer, first in the same thread (cost of the functions alone) and then
+ * in 2 threads (cost with the indexes bouncing between the caches of 2 cores).
+ *
+ * Usage: `bench_spsc_ring [number_of_elements]` (default: 20 million).
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include <sched.h>
+
+/* Project includes */
+#include "spsc_ring.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define BENCH_DEFAULT_ELEMENTS 20000000UL   /*!< Default number of elements of each case @hideinitializer */
+#define BENCH_REPETITIONS 5                 /*!< Number of runs of each case. The fastest one is reported @hideinitializer */
+#define BENCH_RING_LEN 256                  /*!< Capacity of the ring @hideinitializer */
+#define BENCH_BATCH 16U                     /*!< Number of elements of the batches @hideinitializer */
+
+SPSC_RING_DEFINE(bench_ring, uint32_t, BENCH_RING_LEN)
+
+/* Global variables */
+static bench_ring_t ring;       /*!< Ring of the benchmark */
+static uint32_t num_elements;   /*!< Number of elements of each case */
+static uint32_t batch_size;     /*!< Size of the batches of the running case. 1 for single push and pop */
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Current time in seconds of a monotonic clock.
+ */
+static double _now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Producer of the 2-thread cases. It waits for free slots instead of dropping elements.
+ */
+static void *_producer(void *p_arg)
+{
+    uint32_t batch[BENCH_BATCH];
+    uint32_t sent = 0;
+    while (sent < num_elements)
+    {
+        if (BENCH_RING_LEN - bench_ring_count(&ring) < batch_size)
+        {
+            sched_yield(); // Let the consumer run on a single-core host
+        }
+        else if (batch_size == 1)
+        {
+            sent += bench_ring_push(&ring, &sent) ? 1U : 0U;
+        }
+        else
+        {
+            for (uint32_t i = 0; i < batch_size; i++)
+            {
+                batch[i] = sent + i;
+            }
+            sent += bench_ring_push_batch(&ring, batch, batch_size);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Consumer of the 2-thread cases. It returns a checksum so the reads are not optimized out.
+ */
+static uint32_t _consume(void)
+{
+    uint32_t batch[BENCH_BATCH];
+    uint32_t received = 0;
+    uint32_t sum = 0;
+    while (received < num_elements)
+    {
+        uint32_t n = bench_ring_pop_batch(&ring, batch, batch_size);
+        if (n == 0)
+        {
+            sched_yield();
+        }
+        for (uint32_t i = 0; i < n; i++)
+        {
+            sum += batch[i];
+        }
+        received += n;
+    }
+    return sum;
+}
+
+/**
+ * @brief Move the elements through the ring in a single thread: fill a batch and drain it.
+ */
+static uint32_t _run_single_thread(void)
+{
+    uint32_t batch[BENCH_BATCH];
+    uint32_t sum = 0;
+    for (uint32_t sent = 0; sent < num_elements; sent += batch_size)
+    {
+        if (batch_size == 1)
+        {
+            uint32_t v = 0;
+            bench_ring_push(&ring, &sent);
+            bench_ring_pop(&ring, &v);
+            sum += v;
+        }
+        else
+        {
+            for (uint32_t i = 0; i < batch_size; i++)
+            {
+                batch[i] = sent + i;
+            }
+            bench_ring_push_batch(&ring, batch, batch_size);
+            uint32_t n = bench_ring_pop_batch(&ring, batch, batch_size);
+            for (uint32_t i = 0; i < n; i++)
+            {
+                sum += batch[i];
+            }
+        }
+    }
+    return sum;
+}
+
+/**
+ * @brief Move the elements through the ring with a producer thread and the calling thread as consumer.
+ */
+static uint32_t _run_two_threads(void)
+{
+    pthread_t producer;
+    if (pthread_create(&producer, NULL, _producer, NULL) != 0)
+    {
+        return 0;
+    }
+    uint32_t sum = _consume();
+    pthread_join(producer, NULL);
+    return sum;
+}
+
+/**
+ * @brief Run a case several times and print the best throughput.
+ */
+static void _bench(const char *p_name, uint32_t (*p_run)(void), uint32_t batch)
+{
+    double best_s = 1e30;
+    uint32_t checksum = 0;
+    batch_size = batch;
+    for (int r = 0; r < BENCH_REPETITIONS; r++)
+    {
+        bench_ring_init(&ring);
+        double start = _now_s();
+        checksum = p_run();
+        double elapsed = _now_s() - start;
+        best_s = (elapsed < best_s) ? elapsed : best_s;
+    }
+    printf("%-16s batch %2u %8.2f ms %8.1f Melements/s %6.2f ns/element (checksum %08x, overruns %u)\n", p_name, batch, best_s * 1e3,
+           (double)num_elements / best_s * 1e-6, best_s * 1e9 / (double)num_elements, checksum, bench_ring_get_overruns(&ring));
+}
+
+int main(int argc, char *argv[])
+{
+    num_elements = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_ELEMENTS;
+    num_elements -= num_elements % BENCH_BATCH; // Whole batches, so every case moves the same elements
+
+    printf("%u elements, ring of %u\n", num_elements, BENCH_RING_LEN);
+    _bench("single thread", _run_single_thread, 1);
+    _bench("single thread", _run_single_thread, BENCH_BATCH);
+    _bench("two threads", _run_two_threads, 1);
+    _bench("two threads", _run_two_threads, BENCH_BATCH);
+    return 0;
+}
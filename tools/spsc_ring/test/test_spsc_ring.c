@@ -0,0 +1,238 @@
+/**
+ * @file test_spsc_ring.c
+ * @brief Unit and stress test for the lock-free SPSC ring buffer.
+ *
+ * The unit tests check the semantics in a single thread: order, full and empty rings, overruns, wrap-around of the slots and
+ * of the 32-bit indexes, and the batch functions. The stress test runs a producer and a consumer in 2 threads (so with real
+ * concurrency and the fences of the host) and checks that every element is received once, in order, or counted as an overrun.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <pthread.h>
+#include <sched.h>
+
+/* Project includes */
+#include "tools_test.h"
+#include "spsc_ring.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define TEST_RING_LEN 8                 /*!< Capacity of the ring of the unit tests @hideinitializer */
+#define TEST_STRESS_LEN 64              /*!< Capacity of the ring of the stress test @hideinitializer */
+#define TEST_STRESS_ITEMS 500000U       /*!< Number of elements sent by the producer of the stress test @hideinitializer */
+#define TEST_STRESS_MAX_BATCH 13U       /*!< Maximum size of the random batches of the stress test @hideinitializer */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Element of the stress test. The check word detects torn or stale slots.
+ */
+typedef struct
+{
+    uint32_t seq;   /*!< Sequence number */
+    uint32_t check; /*!< Complement of the sequence number */
+} test_item_t;
+
+SPSC_RING_DEFINE(test_ring, uint32_t, TEST_RING_LEN)
+SPSC_RING_DEFINE(stress_ring, test_item_t, TEST_STRESS_LEN)
+
+/* Global variables */
+static stress_ring_t stress;            /*!< Ring shared by the threads of the stress test */
+static volatile int producer_done;      /*!< The producer has sent all the elements */
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Pseudo-random generator of the batch sizes (xorshift32). Each thread has its own state.
+ */
+static uint32_t _random(uint32_t *p_state)
+{
+    *p_state ^= *p_state << 13;
+    *p_state ^= *p_state >> 17;
+    *p_state ^= *p_state << 5;
+    return *p_state;
+}
+
+/**
+ * @brief Elements come out in order, and a full ring drops the new ones and counts them.
+ */
+static void test_push_pop(void)
+{
+    test_ring_t ring;
+    test_ring_init(&ring);
+    uint32_t v;
+    TOOLS_TEST_ASSERT(!test_ring_pop(&ring, &v), "An empty ring must not pop");
+    TOOLS_TEST_ASSERT(test_ring_front(&ring) == NULL, "An empty ring has no front");
+
+    for (uint32_t i = 0; i < TEST_RING_LEN; i++)
+    {
+        TOOLS_TEST_ASSERT(test_ring_push(&ring, &i), "A ring with free slots must accept the element");
+    }
+    uint32_t extra = 99;
+    TOOLS_TEST_ASSERT(!test_ring_push(&ring, &extra), "A full ring must reject the element");
+    TOOLS_TEST_ASSERT(!test_ring_push(&ring, &extra), "A full ring must reject the element");
+    TOOLS_TEST_ASSERT(test_ring_get_overruns(&ring) == 2, "Each rejected element is an overrun");
+    TOOLS_TEST_ASSERT(test_ring_get_max_level(&ring) == TEST_RING_LEN, "The maximum level is the capacity");
+    TOOLS_TEST_ASSERT(test_ring_count(&ring) == TEST_RING_LEN, "The full ring holds the capacity");
+
+    for (uint32_t i = 0; i < TEST_RING_LEN; i++)
+    {
+        TOOLS_TEST_ASSERT(test_ring_pop(&ring, &v) && (v == i), "The elements come out in order, without the rejected ones");
+    }
+    TOOLS_TEST_ASSERT(test_ring_count(&ring) == 0, "The ring must be empty again");
+}
+
+/**
+ * @brief The slots and the 32-bit indexes wrap around without losing elements.
+ */
+static void test_wrap_around(void)
+{
+    test_ring_t ring;
+    test_ring_init(&ring);
+    ring.head = UINT32_MAX - 2U; // Indexes close to the wrap-around of the counters
+    ring.tail = UINT32_MAX - 2U;
+
+    uint32_t expected = 0;
+    uint32_t next = 0;
+    for (uint32_t round = 0; round < 100; round++)
+    {
+        for (uint32_t i = 0; i < 5; i++, next++)
+        {
+            TOOLS_TEST_ASSERT(test_ring_push(&ring, &next), "The ring must accept the element");
+        }
+        TOOLS_TEST_ASSERT(test_ring_count(&ring) == 5, "The count is right across the wrap-around");
+        const uint32_t *p_front = test_ring_front(&ring);
+        TOOLS_TEST_ASSERT((p_front != NULL) && (*p_front == expected), "The front is the oldest element");
+        test_ring_drop(&ring);
+        expected++;
+        uint32_t v;
+        for (uint32_t i = 0; i < 4; i++, expected++)
+        {
+            TOOLS_TEST_ASSERT(test_ring_pop(&ring, &v) && (v == expected), "The elements come out in order");
+        }
+    }
+    TOOLS_TEST_ASSERT(test_ring_get_overruns(&ring) == 0, "No element must be dropped");
+    TOOLS_TEST_ASSERT(test_ring_get_max_level(&ring) == 5, "The maximum level is the largest burst");
+}
+
+/**
+ * @brief Batches are split at the end of the buffer and truncated to the free slots or to the queued elements.
+ */
+static void test_batch(void)
+{
+    test_ring_t ring;
+    test_ring_init(&ring);
+    uint32_t in[TEST_RING_LEN + 3];
+    uint32_t out[TEST_RING_LEN + 3];
+    for (uint32_t i = 0; i < TEST_RING_LEN + 3; i++)
+    {
+        in[i] = 100 + i;
+    }
+
+    TOOLS_TEST_ASSERT(test_ring_push_batch(&ring, in, 5) == 5, "The whole batch fits");
+    TOOLS_TEST_ASSERT(test_ring_pop_batch(&ring, out, 3) == 3, "The batch pops the elements asked");
+    TOOLS_TEST_ASSERT((out[0] == 100) && (out[2] == 102), "The batch pops the oldest elements");
+
+    // Head at slot 3, tail at slot 5: the next batch wraps around the end of the buffer
+    TOOLS_TEST_ASSERT(test_ring_push_batch(&ring, in + 5, TEST_RING_LEN) == TEST_RING_LEN - 2, "The batch is truncated to the free slots");
+    TOOLS_TEST_ASSERT(test_ring_get_overruns(&ring) == 2, "The truncated elements are overruns");
+    TOOLS_TEST_ASSERT(test_ring_pop_batch(&ring, out, TEST_RING_LEN + 3) == TEST_RING_LEN, "The batch is truncated to the queued elements");
+    for (uint32_t i = 0; i < TEST_RING_LEN; i++)
+    {
+        TOOLS_TEST_ASSERT(out[i] == 103 + i, "The wrapped batch comes out in order");
+    }
+    TOOLS_TEST_ASSERT(test_ring_pop_batch(&ring, out, 1) == 0, "An empty ring pops nothing");
+    TOOLS_TEST_ASSERT(test_ring_push_batch(&ring, in, 0) == 0, "An empty batch pushes nothing");
+}
+
+/**
+ * @brief Producer of the stress test: random batches and single pushes. When the ring is full, it usually waits.
+ */
+static void *_producer(void *p_arg)
+{
+    uint32_t state = 0x2545F491U;
+    test_item_t batch[TEST_STRESS_MAX_BATCH];
+    uint32_t seq = 0;
+    while (seq < TEST_STRESS_ITEMS)
+    {
+        uint32_t n = _random(&state) % TEST_STRESS_MAX_BATCH + 1U;
+        n = (TEST_STRESS_ITEMS - seq < n) ? (TEST_STRESS_ITEMS - seq) : n;
+        if ((TEST_STRESS_LEN - stress_ring_count(&stress) < n) && ((_random(&state) & 0x7U) != 0))
+        {
+            sched_yield(); // Usually wait for the consumer, but sometimes overrun the ring on purpose
+            continue;
+        }
+        for (uint32_t i = 0; i < n; i++)
+        {
+            batch[i].seq = seq + i;
+            batch[i].check = ~(seq + i);
+        }
+        if (n == 1)
+        {
+            stress_ring_push(&stress, &batch[0]);
+        }
+        else
+        {
+            stress_ring_push_batch(&stress, batch, n);
+        }
+        seq += n;
+    }
+    __atomic_store_n(&producer_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+/**
+ * @brief A producer and a consumer run concurrently: nothing is lost, duplicated, reordered or torn.
+ */
+static void test_stress(void)
+{
+    stress_ring_init(&stress);
+    producer_done = 0;
+    pthread_t producer;
+    TOOLS_TEST_ASSERT(pthread_create(&producer, NULL, _producer, NULL) == 0, "The producer thread must start");
+
+    uint32_t state = 0x12345678U;
+    test_item_t batch[TEST_STRESS_MAX_BATCH];
+    uint32_t received = 0;
+    uint32_t last_seq = 0;
+    uint32_t errors = 0;
+    for (;;)
+    {
+        int done = __atomic_load_n(&producer_done, __ATOMIC_ACQUIRE); // Read before the ring, so the last elements are not missed
+        uint32_t n = stress_ring_pop_batch(&stress, batch, _random(&state) % TEST_STRESS_MAX_BATCH + 1U);
+        if (n == 0)
+        {
+            if (done)
+            {
+                break;
+            }
+            sched_yield(); // Let the producer run on a single-core host
+        }
+        for (uint32_t i = 0; i < n; i++)
+        {
+            if ((batch[i].check != ~batch[i].seq) || ((received > 0) && (batch[i].seq <= last_seq)))
+            {
+                errors++;
+            }
+            last_seq = batch[i].seq;
+            received++;
+        }
+    }
+    pthread_join(producer, NULL);
+
+    printf("stress: %u received, %u overruns, max level %u\n", received, stress_ring_get_overruns(&stress), stress_ring_get_max_level(&stress));
+    TOOLS_TEST_ASSERT(errors == 0, "The elements must be received in order and not torn");
+    TOOLS_TEST_ASSERT(received + stress_ring_get_overruns(&stress) == TEST_STRESS_ITEMS, "Every element is received or counted as an overrun");
+    TOOLS_TEST_ASSERT(stress_ring_get_max_level(&stress) <= TEST_STRESS_LEN, "The level never exceeds the capacity");
+}
+
+int main(void)
+{
+    TOOLS_TEST_RUN(test_push_pop);
+    TOOLS_TEST_RUN(test_wrap_around);
+    TOOLS_TEST_RUN(test_batch);
+    TOOLS_TEST_RUN(test_stress);
+    return TOOLS_TEST_END();
+}
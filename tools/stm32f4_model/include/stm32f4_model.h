@@ -0,0 +1,188 @@
+/**
+ * @file stm32f4_model.h
+ * @brief Host register model of the STM32F446 with a virtual clock.
+ *
+ * The model runs the unmodified sources of `port/stm32f4` (and the test suites of `test/stm32f4`) on the development computer.
+ * The sources are compiled against the device header `stm32f4xx.h` of the model and with the instrumentation of the thread
+ * sanitizer of the compiler (`-fsanitize=thread`, without its runtime), so every load and store of the firmware to a global or
+ * through a pointer, and every call, calls the model before it is made. The model uses these calls to:
+ * - Advance the virtual clock a fixed number of CPU cycles per access or call (`STM32F4_MODEL_CYCLES_PER_ACCESS` by default). A busy
+ *   wait such as `while ((msTicks - tickstart) < ms);` therefore takes virtual time but only microseconds of host time.
+ * - Run the peripherals up to the current time, in chronological order: counters, compare and capture of the timers, SysTick,
+ *   and the edges of the pins scheduled by the test.
+ * - Take the pending interrupts before the access, with the priorities, the preemption and the tail-chaining of the NVIC. The
+ *   handlers (`TIM2_IRQHandler()`, ...) are called synchronously, nested if they preempt each other.
+ * - Refresh the registers with a value that depends on time before they are read (e.g., `TIMx->CNT`, `SysTick->VAL`), and
+ *   apply the side effects of the writes after they are made (e.g., `BSRR`, the write-1-to-clear and read-clear-write-0 flags,
+ *   `EGR`).
+ *
+ * Modelled behaviour:
+ * - RCC: the clock-enable bits gate the timers. The clock tree is fixed: the core, the buses and the timers run at the HSI
+ *   (`STM32F4_MODEL_CLOCK_HZ`).
+ * - GPIOA-C: mode, pull resistors, `ODR`/`BSRR`/`IDR`, alternate functions of TIM2-5. The level of an input is driven by the test
+ *   (`stm32f4_model_gpio_drive()`), or else set by its pull resistor (floating inputs read low).
+ * - EXTI and SYSCFG: edge detection of the lines 0-15 of the pin selected by `EXTICR`, `PR` (write 1 to clear) and `SWIER`.
+ * - TIM2-5: up-counting with prescaler, auto-reload preload, update event and `UG`, one-pulse mode, output compare (frozen,
+ *   active, inactive, toggle, forced and PWM 1/2 modes with polarity) and input capture on the rising, falling or both edges with
+ *   overcapture. `SR` is read/clear-by-writing-0 and the interrupt is `SR & DIER`.
+ * - SysTick: down-counter with reload, `COUNTFLAG` and exception. `SCB->ICSR` `PENDSTSET`, `AIRCR` priority grouping.
+ * - NVIC: enable, pending, active, priorities (`IP`, `SHP`), `STIR`. PRIMASK is an intrinsic of the model.
+ * - DWT: cycle counter. PWR: backup regulator ready. CRC: CRC-32 of the data register.
+ *
+ * Not modelled: input filters and capture prescalers, slave and master modes, center-aligned and down-counting, DMA requests, the
+ * clock tree and the low-power modes (Stop behaves as Sleep). TIM1/8, DMA, CAN and the flash interface are plain registers without
+ * behaviour.
+ *
+ * Time only advances on memory accesses of the instrumented code, with `__WFI()` (up to the next event) and with the functions
+ * of this API, so the model is deterministic.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef STM32F4_MODEL_H_
+#define STM32F4_MODEL_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Project includes */
+#include "stm32f4xx.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define STM32F4_MODEL_CLOCK_HZ 16000000U                   /*!< Frequency of the core, the buses and the timers (HSI) */
+#define STM32F4_MODEL_CYCLES_PER_ACCESS 4U                 /*!< Default CPU cycles of an instrumented memory access */
+#define STM32F4_MODEL_EXCEPTION_CYCLES 12U                 /*!< CPU cycles of the entry and of the exit of an exception */
+#define STM32F4_MODEL_WFI_TIMEOUT_S 60U                    /*!< Virtual seconds a `__WFI()` waits for an interrupt before the model aborts */
+#define STM32F4_MODEL_PIN_EVENTS 64U                       /*!< Maximum number of scheduled pin edges */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Function called when the level of a pin changes.
+ *
+ * @param p_port Port of the pin.
+ * @param pin Pin number.
+ * @param level New level of the pin.
+ * @param cycles Virtual time of the change in CPU cycles.
+ */
+typedef void (*stm32f4_model_pin_cb_t)(GPIO_TypeDef *p_port, uint8_t pin, bool level, uint64_t cycles);
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Reset the registers and the state of the model to the reset values of the MCU, and the virtual clock to 0.
+ *
+ * It is called before `main()`, and then `SystemInit()` as the startup code of the target does.
+ */
+void stm32f4_model_reset(void);
+
+/**
+ * @brief Set the CPU cycles that an instrumented memory access takes.
+ *
+ * @param cycles Cycles per access (at least 1).
+ */
+void stm32f4_model_set_cycles_per_access(uint32_t cycles);
+
+/**
+ * @brief Current virtual time in CPU cycles.
+ *
+ * @return uint64_t Cycles since the reset of the model.
+ */
+uint64_t stm32f4_model_get_cycles(void);
+
+/**
+ * @brief Current virtual time in microseconds.
+ *
+ * @return uint64_t Microseconds since the reset of the model.
+ */
+uint64_t stm32f4_model_get_us(void);
+
+/**
+ * @brief Advance the virtual clock, running the peripherals and the interrupts that become due.
+ *
+ * @param us Microseconds to advance.
+ */
+void stm32f4_model_advance_us(uint32_t us);
+
+/**
+ * @brief Advance the virtual clock a number of CPU cycles, running the peripherals and the interrupts that become due.
+ *
+ * @param cycles Cycles to advance.
+ */
+void stm32f4_model_advance_cycles(uint64_t cycles);
+
+/**
+ * @brief Drive the level of a pin from outside the MCU. It is seen by `IDR`, the EXTI and the input capture of the timers.
+ *
+ * @param p_port Port of the pin.
+ * @param pin Pin number.
+ * @param level Level driven.
+ */
+void stm32f4_model_gpio_drive(GPIO_TypeDef *p_port, uint8_t pin, bool level);
+
+/**
+ * @brief Stop driving a pin from outside the MCU. Its level is set again by its pull resistor.
+ *
+ * @param p_port Port of the pin.
+ * @param pin Pin number.
+ */
+void stm32f4_model_gpio_release(GPIO_TypeDef *p_port, uint8_t pin);
+
+/**
+ * @brief Schedule the external drive of a pin to a level at a virtual time.
+ *
+ * Events at the same time are applied in the order they were scheduled.
+ *
+ * @param p_port Port of the pin.
+ * @param pin Pin number.
+ * @param level Level driven.
+ * @param cycles Virtual time in CPU cycles. If it is in the past, the level is driven at the next access.
+ * @retval true if the event was scheduled, false if the queue is full.
+ */
+bool stm32f4_model_gpio_schedule(GPIO_TypeDef *p_port, uint8_t pin, bool level, uint64_t cycles);
+
+/**
+ * @brief Schedule a high pulse on a pin driven from outside the MCU.
+ *
+ * @param p_port Port of the pin.
+ * @param pin Pin number.
+ * @param start_cycles Virtual time of the rising edge in CPU cycles.
+ * @param width_cycles Width of the pulse in CPU cycles.
+ * @retval true if both edges were scheduled, false if the queue is full.
+ */
+bool stm32f4_model_gpio_pulse(GPIO_TypeDef *p_port, uint8_t pin, uint64_t start_cycles, uint64_t width_cycles);
+
+/**
+ * @brief Remove the scheduled edges of all the pins.
+ */
+void stm32f4_model_gpio_clear_schedule(void);
+
+/**
+ * @brief Level of a pin as seen on the board: output, alternate function output or external drive.
+ *
+ * @param p_port Port of the pin.
+ * @param pin Pin number.
+ * @return true if the pin is high.
+ */
+bool stm32f4_model_gpio_get_level(GPIO_TypeDef *p_port, uint8_t pin);
+
+/**
+ * @brief Set the function called when the level of any pin changes. NULL to remove it.
+ *
+ * The function is called from the model, so it must not access the registers of the MCU. It can schedule new pin events.
+ *
+ * @param cb Function to call.
+ */
+void stm32f4_model_gpio_set_callback(stm32f4_model_pin_cb_t cb);
+
+/**
+ * @brief Number of times an interrupt or exception has been taken since the reset of the model.
+ *
+ * @param irqn Interrupt number (`SysTick_IRQn` or a peripheral interrupt).
+ * @return uint32_t Number of entries of its handler.
+ */
+uint32_t stm32f4_model_get_irq_count(IRQn_Type irqn);
+
+#endif /* STM32F4_MODEL_H_ */
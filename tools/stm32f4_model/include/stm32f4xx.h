@@ -0,0 +1,1107 @@
+/**
+ * @file stm32f4xx.h
+ * @brief Device header of the STM32F446 for the host register model.
+ *
+ * It replaces the CMSIS device header of MatrixMCU when the port of the STM32F4 is compiled for the host, so the sources of
+ * `port/stm32f4` are compiled without changes. The register blocks have the layout of the CMSIS structures, but they are
+ * variables of the model (`stm32f4_model_regs`) instead of fixed addresses, and the core functions of CMSIS (NVIC, SysTick)
+ * access them as on the target. The intrinsics of the core (`__WFI()`, `__disable_irq()`, ...) are functions of the model.
+ *
+ * Only the registers and the bits used by the project are defined. The behaviour of the registers is described in
+ * `stm32f4_model.h`.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef STM32F4XX_H_
+#define STM32F4XX_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Configuration of the core */
+#define __CM4_REV 0x0001U       /*!< Core revision r0p1 */
+#define __MPU_PRESENT 1U        /*!< The STM32F4 provides an MPU */
+#define __NVIC_PRIO_BITS 4U     /*!< The STM32F4 uses 4 bits for the priority levels */
+#define __FPU_PRESENT 1U        /*!< The STM32F4 provides an FPU */
+#define __FPU_USED 1U           /*!< The FPU is used */
+
+#define __I volatile const      /*!< Read-only register */
+#define __O volatile            /*!< Write-only register */
+#define __IO volatile           /*!< Read-write register */
+
+/**
+ * @brief Interrupt numbers of the STM32F446. Negative numbers are exceptions of the core.
+ */
+typedef enum
+{
+    NonMaskableInt_IRQn = -14,
+    MemoryManagement_IRQn = -12,
+    BusFault_IRQn = -11,
+    UsageFault_IRQn = -10,
+    SVCall_IRQn = -5,
+    DebugMonitor_IRQn = -4,
+    PendSV_IRQn = -2,
+    SysTick_IRQn = -1,
+    WWDG_IRQn = 0,
+    PVD_IRQn = 1,
+    TAMP_STAMP_IRQn = 2,
+    RTC_WKUP_IRQn = 3,
+    FLASH_IRQn = 4,
+    RCC_IRQn = 5,
+    EXTI0_IRQn = 6,
+    EXTI1_IRQn = 7,
+    EXTI2_IRQn = 8,
+    EXTI3_IRQn = 9,
+    EXTI4_IRQn = 10,
+    DMA1_Stream0_IRQn = 11,
+    DMA1_Stream1_IRQn = 12,
+    DMA1_Stream2_IRQn = 13,
+    DMA1_Stream3_IRQn = 14,
+    DMA1_Stream4_IRQn = 15,
+    DMA1_Stream5_IRQn = 16,
+    DMA1_Stream6_IRQn = 17,
+    ADC_IRQn = 18,
+    CAN1_TX_IRQn = 19,
+    CAN1_RX0_IRQn = 20,
+    CAN1_RX1_IRQn = 21,
+    CAN1_SCE_IRQn = 22,
+    EXTI9_5_IRQn = 23,
+    TIM1_BRK_TIM9_IRQn = 24,
+    TIM1_UP_TIM10_IRQn = 25,
+    TIM1_TRG_COM_TIM11_IRQn = 26,
+    TIM1_CC_IRQn = 27,
+    TIM2_IRQn = 28,
+    TIM3_IRQn = 29,
+    TIM4_IRQn = 30,
+    I2C1_EV_IRQn = 31,
+    I2C1_ER_IRQn = 32,
+    I2C2_EV_IRQn = 33,
+    I2C2_ER_IRQn = 34,
+    SPI1_IRQn = 35,
+    SPI2_IRQn = 36,
+    USART1_IRQn = 37,
+    USART2_IRQn = 38,
+    USART3_IRQn = 39,
+    EXTI15_10_IRQn = 40,
+    RTC_Alarm_IRQn = 41,
+    OTG_FS_WKUP_IRQn = 42,
+    TIM8_BRK_TIM12_IRQn = 43,
+    TIM8_UP_TIM13_IRQn = 44,
+    TIM8_TRG_COM_TIM14_IRQn = 45,
+    TIM8_CC_IRQn = 46,
+    DMA1_Stream7_IRQn = 47,
+    FMC_IRQn = 48,
+    SDIO_IRQn = 49,
+    TIM5_IRQn = 50,
+    SPI3_IRQn = 51,
+    UART4_IRQn = 52,
+    UART5_IRQn = 53,
+    TIM6_DAC_IRQn = 54,
+    TIM7_IRQn = 55,
+    DMA2_Stream0_IRQn = 56,
+    DMA2_Stream1_IRQn = 57,
+    DMA2_Stream2_IRQn = 58,
+    DMA2_Stream3_IRQn = 59,
+    DMA2_Stream4_IRQn = 60,
+    CAN2_TX_IRQn = 63,
+    CAN2_RX0_IRQn = 64,
+    CAN2_RX1_IRQn = 65,
+    CAN2_SCE_IRQn = 66,
+    OTG_FS_IRQn = 67,
+    DMA2_Stream5_IRQn = 68,
+    DMA2_Stream6_IRQn = 69,
+    DMA2_Stream7_IRQn = 70,
+    USART6_IRQn = 71,
+    I2C3_EV_IRQn = 72,
+    I2C3_ER_IRQn = 73,
+    FPU_IRQn = 81,
+} IRQn_Type;
+
+/* Typedefs --------------------------------------------------------------------*/
+/* Peripherals of the device */
+/**
+ * @brief General-purpose and advanced-control timers.
+ */
+typedef struct
+{
+    __IO uint32_t CR1;      /*!< Control register 1 */
+    __IO uint32_t CR2;      /*!< Control register 2 */
+    __IO uint32_t SMCR;     /*!< Slave mode control register */
+    __IO uint32_t DIER;     /*!< DMA/interrupt enable register */
+    __IO uint32_t SR;       /*!< Status register */
+    __IO uint32_t EGR;      /*!< Event generation register */
+    __IO uint32_t CCMR1;    /*!< Capture/compare mode register 1 */
+    __IO uint32_t CCMR2;    /*!< Capture/compare mode register 2 */
+    __IO uint32_t CCER;     /*!< Capture/compare enable register */
+    __IO uint32_t CNT;      /*!< Counter register */
+    __IO uint32_t PSC;      /*!< Prescaler */
+    __IO uint32_t ARR;      /*!< Auto-reload register */
+    __IO uint32_t RCR;      /*!< Repetition counter register */
+    __IO uint32_t CCR1;     /*!< Capture/compare register 1 */
+    __IO uint32_t CCR2;     /*!< Capture/compare register 2 */
+    __IO uint32_t CCR3;     /*!< Capture/compare register 3 */
+    __IO uint32_t CCR4;     /*!< Capture/compare register 4 */
+    __IO uint32_t BDTR;     /*!< Break and dead-time register */
+    __IO uint32_t DCR;      /*!< DMA control register */
+    __IO uint32_t DMAR;     /*!< DMA address for full transfer */
+    __IO uint32_t OR;       /*!< Option register */
+} TIM_TypeDef;
+
+/**
+ * @brief General-purpose I/Os.
+ */
+typedef struct
+{
+    __IO uint32_t MODER;    /*!< Port mode register */
+    __IO uint32_t OTYPER;   /*!< Port output type register */
+    __IO uint32_t OSPEEDR;  /*!< Port output speed register */
+    __IO uint32_t PUPDR;    /*!< Port pull-up/pull-down register */
+    __IO uint32_t IDR;      /*!< Port input data register */
+    __IO uint32_t ODR;      /*!< Port output data register */
+    __IO uint32_t BSRR;     /*!< Port bit set/reset register */
+    __IO uint32_t LCKR;     /*!< Port configuration lock register */
+    __IO uint32_t AFR[2];   /*!< Alternate function registers (low and high) */
+} GPIO_TypeDef;
+
+/**
+ * @brief External interrupt/event controller.
+ */
+typedef struct
+{
+    __IO uint32_t IMR;      /*!< Interrupt mask register */
+    __IO uint32_t EMR;      /*!< Event mask register */
+    __IO uint32_t RTSR;     /*!< Rising trigger selection register */
+    __IO uint32_t FTSR;     /*!< Falling trigger selection register */
+    __IO uint32_t SWIER;    /*!< Software interrupt event register */
+    __IO uint32_t PR;       /*!< Pending register */
+} EXTI_TypeDef;
+
+/**
+ * @brief System configuration controller.
+ */
+typedef struct
+{
+    __IO uint32_t MEMRMP;       /*!< Memory remap register */
+    __IO uint32_t PMC;          /*!< Peripheral mode configuration register */
+    __IO uint32_t EXTICR[4];    /*!< External interrupt configuration registers */
+    uint32_t RESERVED[2];       /*!< Reserved */
+    __IO uint32_t CMPCR;        /*!< Compensation cell control register */
+    uint32_t RESERVED1[2];      /*!< Reserved */
+    __IO uint32_t CFGR;         /*!< Configuration register */
+} SYSCFG_TypeDef;
+
+/**
+ * @brief Reset and clock control.
+ */
+typedef struct
+{
+    __IO uint32_t CR;           /*!< Clock control register */
+    __IO uint32_t PLLCFGR;      /*!< PLL configuration register */
+    __IO uint32_t CFGR;         /*!< Clock configuration register */
+    __IO uint32_t CIR;          /*!< Clock interrupt register */
+    __IO uint32_t AHB1RSTR;     /*!< AHB1 peripheral reset register */
+    __IO uint32_t AHB2RSTR;     /*!< AHB2 peripheral reset register */
+    __IO uint32_t AHB3RSTR;     /*!< AHB3 peripheral reset register */
+    uint32_t RESERVED0;         /*!< Reserved */
+    __IO uint32_t APB1RSTR;     /*!< APB1 peripheral reset register */
+    __IO uint32_t APB2RSTR;     /*!< APB2 peripheral reset register */
+    uint32_t RESERVED1[2];      /*!< Reserved */
+    __IO uint32_t AHB1ENR;      /*!< AHB1 peripheral clock enable register */
+    __IO uint32_t AHB2ENR;      /*!< AHB2 peripheral clock enable register */
+    __IO uint32_t AHB3ENR;      /*!< AHB3 peripheral clock enable register */
+    uint32_t RESERVED2;         /*!< Reserved */
+    __IO uint32_t APB1ENR;      /*!< APB1 peripheral clock enable register */
+    __IO uint32_t APB2ENR;      /*!< APB2 peripheral clock enable register */
+    uint32_t RESERVED3[2];      /*!< Reserved */
+    __IO uint32_t AHB1LPENR;    /*!< AHB1 peripheral clock enable in low power mode register */
+    __IO uint32_t AHB2LPENR;    /*!< AHB2 peripheral clock enable in low power mode register */
+    __IO uint32_t AHB3LPENR;    /*!< AHB3 peripheral clock enable in low power mode register */
+    uint32_t RESERVED4;         /*!< Reserved */
+    __IO uint32_t APB1LPENR;    /*!< APB1 peripheral clock enable in low power mode register */
+    __IO uint32_t APB2LPENR;    /*!< APB2 peripheral clock enable in low power mode register */
+    uint32_t RESERVED5[2];      /*!< Reserved */
+    __IO uint32_t BDCR;         /*!< Backup domain control register */
+    __IO uint32_t CSR;          /*!< Clock control & status register */
+} RCC_TypeDef;
+
+/**
+ * @brief Power control.
+ */
+typedef struct
+{
+    __IO uint32_t CR;   /*!< Power control register */
+    __IO uint32_t CSR;  /*!< Power control/status register */
+} PWR_TypeDef;
+
+/**
+ * @brief Flash interface.
+ */
+typedef struct
+{
+    __IO uint32_t ACR;      /*!< Access control register */
+    __IO uint32_t KEYR;     /*!< Key register */
+    __IO uint32_t OPTKEYR;  /*!< Option key register */
+    __IO uint32_t SR;       /*!< Status register */
+    __IO uint32_t CR;       /*!< Control register */
+    __IO uint32_t OPTCR;    /*!< Option control register */
+} FLASH_TypeDef;
+
+/**
+ * @brief CRC calculation unit.
+ */
+typedef struct
+{
+    __IO uint32_t DR;   /*!< Data register */
+    __IO uint8_t IDR;   /*!< Independent data register */
+    uint8_t RESERVED0;  /*!< Reserved */
+    uint16_t RESERVED1; /*!< Reserved */
+    __IO uint32_t CR;   /*!< Control register */
+} CRC_TypeDef;
+
+/**
+ * @brief Stream of a DMA controller.
+ */
+typedef struct
+{
+    __IO uint32_t CR;   /*!< Configuration register */
+    __IO uint32_t NDTR; /*!< Number of data register */
+    __IO uint32_t PAR;  /*!< Peripheral address register */
+    __IO uint32_t M0AR; /*!< Memory 0 address register */
+    __IO uint32_t M1AR; /*!< Memory 1 address register */
+    __IO uint32_t FCR;  /*!< FIFO control register */
+} DMA_Stream_TypeDef;
+
+/**
+ * @brief DMA controller.
+ */
+typedef struct
+{
+    __IO uint32_t LISR;     /*!< Low interrupt status register */
+    __IO uint32_t HISR;     /*!< High interrupt status register */
+    __IO uint32_t LIFCR;    /*!< Low interrupt flag clear register */
+    __IO uint32_t HIFCR;    /*!< High interrupt flag clear register */
+} DMA_TypeDef;
+
+/**
+ * @brief Inter-integrated circuit (I2C) interface.
+ */
+typedef struct
+{
+    __IO uint32_t CR1;      /*!< Control register 1 */
+    __IO uint32_t CR2;      /*!< Control register 2 */
+    __IO uint32_t OAR1;     /*!< Own address register 1 */
+    __IO uint32_t OAR2;     /*!< Own address register 2 */
+    __IO uint32_t DR;       /*!< Data register */
+    __IO uint32_t SR1;      /*!< Status register 1 */
+    __IO uint32_t SR2;      /*!< Status register 2 */
+    __IO uint32_t CCR;      /*!< Clock control register */
+    __IO uint32_t TRISE;    /*!< Rise time register */
+    __IO uint32_t FLTR;     /*!< Filter register */
+} I2C_TypeDef;
+
+/**
+ * @brief Transmit mailbox of the CAN controller.
+ */
+typedef struct
+{
+    __IO uint32_t TIR;  /*!< Identifier register */
+    __IO uint32_t TDTR; /*!< Data length control and time stamp register */
+    __IO uint32_t TDLR; /*!< Data low register */
+    __IO uint32_t TDHR; /*!< Data high register */
+} CAN_TxMailBox_TypeDef;
+
+/**
+ * @brief Receive FIFO mailbox of the CAN controller.
+ */
+typedef struct
+{
+    __IO uint32_t RIR;  /*!< Identifier register */
+    __IO uint32_t RDTR; /*!< Data length control and time stamp register */
+    __IO uint32_t RDLR; /*!< Data low register */
+    __IO uint32_t RDHR; /*!< Data high register */
+} CAN_FIFOMailBox_TypeDef;
+
+/**
+ * @brief Filter bank of the CAN controller.
+ */
+typedef struct
+{
+    __IO uint32_t FR1;  /*!< Filter bank register 1 */
+    __IO uint32_t FR2;  /*!< Filter bank register 2 */
+} CAN_FilterRegister_TypeDef;
+
+/**
+ * @brief CAN controller.
+ */
+typedef struct
+{
+    __IO uint32_t MCR;                                  /*!< Master control register */
+    __IO uint32_t MSR;                                  /*!< Master status register */
+    __IO uint32_t TSR;                                  /*!< Transmit status register */
+    __IO uint32_t RF0R;                                 /*!< Receive FIFO 0 register */
+    __IO uint32_t RF1R;                                 /*!< Receive FIFO 1 register */
+    __IO uint32_t IER;                                  /*!< Interrupt enable register */
+    __IO uint32_t ESR;                                  /*!< Error status register */
+    __IO uint32_t BTR;                                  /*!< Bit timing register */
+    uint32_t RESERVED0[88];                             /*!< Reserved */
+    CAN_TxMailBox_TypeDef sTxMailBox[3];                /*!< Transmit mailboxes */
+    CAN_FIFOMailBox_TypeDef sFIFOMailBox[2];            /*!< Receive FIFO mailboxes */
+    uint32_t RESERVED1[12];                             /*!< Reserved */
+    __IO uint32_t FMR;                                  /*!< Filter master register */
+    __IO uint32_t FM1R;                                 /*!< Filter mode register */
+    uint32_t RESERVED2;                                 /*!< Reserved */
+    __IO uint32_t FS1R;                                 /*!< Filter scale register */
+    uint32_t RESERVED3;                                 /*!< Reserved */
+    __IO uint32_t FFA1R;                                /*!< Filter FIFO assignment register */
+    uint32_t RESERVED4;                                 /*!< Reserved */
+    __IO uint32_t FA1R;                                 /*!< Filter activation register */
+    uint32_t RESERVED5[8];                              /*!< Reserved */
+    CAN_FilterRegister_TypeDef sFilterRegister[28];     /*!< Filter banks */
+} CAN_TypeDef;
+
+/* Peripherals of the core */
+/**
+ * @brief System control block.
+ */
+typedef struct
+{
+    __I uint32_t CPUID;     /*!< CPUID base register */
+    __IO uint32_t ICSR;     /*!< Interrupt control and state register */
+    __IO uint32_t VTOR;     /*!< Vector table offset register */
+    __IO uint32_t AIRCR;    /*!< Application interrupt and reset control register */
+    __IO uint32_t SCR;      /*!< System control register */
+    __IO uint32_t CCR;      /*!< Configuration control register */
+    __IO uint8_t SHP[12];   /*!< System handlers priority registers (4-7, 8-11, 12-15) */
+    __IO uint32_t SHCSR;    /*!< System handler control and state register */
+    __IO uint32_t CFSR;     /*!< Configurable fault status register */
+    __IO uint32_t HFSR;     /*!< HardFault status register */
+    __IO uint32_t DFSR;     /*!< Debug fault status register */
+    __IO uint32_t MMFAR;    /*!< MemManage fault address register */
+    __IO uint32_t BFAR;     /*!< BusFault address register */
+    __IO uint32_t AFSR;     /*!< Auxiliary fault status register */
+    __I uint32_t PFR[2];    /*!< Processor feature register */
+    __I uint32_t DFR;       /*!< Debug feature register */
+    __I uint32_t ADR;       /*!< Auxiliary feature register */
+    __I uint32_t MMFR[4];   /*!< Memory model feature register */
+    __I uint32_t ISAR[5];   /*!< Instruction set attributes register */
+    uint32_t RESERVED0[5];  /*!< Reserved */
+    __IO uint32_t CPACR;    /*!< Coprocessor access control register */
+} SCB_Type;
+
+/**
+ * @brief System timer.
+ */
+typedef struct
+{
+    __IO uint32_t CTRL;     /*!< Control and status register */
+    __IO uint32_t LOAD;     /*!< Reload value register */
+    __IO uint32_t VAL;      /*!< Current value register */
+    __I uint32_t CALIB;     /*!< Calibration register */
+} SysTick_Type;
+
+/**
+ * @brief Nested vectored interrupt controller.
+ */
+typedef struct
+{
+    __IO uint32_t ISER[8];      /*!< Interrupt set enable registers */
+    uint32_t RESERVED0[24];     /*!< Reserved */
+    __IO uint32_t ICER[8];      /*!< Interrupt clear enable registers */
+    uint32_t RESERVED1[24];     /*!< Reserved */
+    __IO uint32_t ISPR[8];      /*!< Interrupt set pending registers */
+    uint32_t RESERVED2[24];     /*!< Reserved */
+    __IO uint32_t ICPR[8];      /*!< Interrupt clear pending registers */
+    uint32_t RESERVED3[24];     /*!< Reserved */
+    __IO uint32_t IABR[8];      /*!< Interrupt active bit registers */
+    uint32_t RESERVED4[56];     /*!< Reserved */
+    __IO uint8_t IP[240];       /*!< Interrupt priority registers (8 bits wide) */
+    uint32_t RESERVED5[644];    /*!< Reserved */
+    __O uint32_t STIR;          /*!< Software trigger interrupt register */
+} NVIC_Type;
+
+/**
+ * @brief Data watchpoint and trace unit (only the cycle counter).
+ */
+typedef struct
+{
+    __IO uint32_t CTRL;     /*!< Control register */
+    __IO uint32_t CYCCNT;   /*!< Cycle count register */
+    __IO uint32_t CPICNT;   /*!< CPI count register */
+    __IO uint32_t EXCCNT;   /*!< Exception overhead count register */
+    __IO uint32_t SLEEPCNT; /*!< Sleep count register */
+    __IO uint32_t LSUCNT;   /*!< LSU count register */
+    __IO uint32_t FOLDCNT;  /*!< Folded-instruction count register */
+} DWT_Type;
+
+/**
+ * @brief Core debug registers.
+ */
+typedef struct
+{
+    __IO uint32_t DHCSR;    /*!< Debug halting control and status register */
+    __O uint32_t DCRSR;     /*!< Debug core register selector register */
+    __IO uint32_t DCRDR;    /*!< Debug core register data register */
+    __IO uint32_t DEMCR;    /*!< Debug exception and monitor control register */
+} CoreDebug_Type;
+
+/**
+ * @brief Registers of all the peripherals of the model. They are a single object, so an access is identified as an access to a
+ * register with a range check.
+ */
+typedef struct
+{
+    TIM_TypeDef tim1;                   /*!< TIM1 (registers only) */
+    TIM_TypeDef tim2;                   /*!< TIM2 */
+    TIM_TypeDef tim3;                   /*!< TIM3 */
+    TIM_TypeDef tim4;                   /*!< TIM4 */
+    TIM_TypeDef tim5;                   /*!< TIM5 */
+    TIM_TypeDef tim8;                   /*!< TIM8 (registers only) */
+    GPIO_TypeDef gpio[3];               /*!< GPIOA, GPIOB and GPIOC */
+    EXTI_TypeDef exti;                  /*!< EXTI */
+    SYSCFG_TypeDef syscfg;              /*!< SYSCFG */
+    RCC_TypeDef rcc;                    /*!< RCC */
+    PWR_TypeDef pwr;                    /*!< PWR */
+    FLASH_TypeDef flash;                /*!< Flash interface */
+    CRC_TypeDef crc;                    /*!< CRC calculation unit */
+    DMA_TypeDef dma1;                   /*!< DMA1 (registers only) */
+    DMA_TypeDef dma2;                   /*!< DMA2 (registers only) */
+    DMA_Stream_TypeDef dma1_stream[8];  /*!< Streams of DMA1 (registers only) */
+    DMA_Stream_TypeDef dma2_stream[8];  /*!< Streams of DMA2 (registers only) */
+    I2C_TypeDef i2c2;                   /*!< I2C2 (registers only) */
+    CAN_TypeDef can1;                   /*!< CAN1 (registers only) */
+    SCB_Type scb;                       /*!< System control block */
+    SysTick_Type systick;               /*!< System timer */
+    NVIC_Type nvic;                     /*!< Interrupt controller */
+    DWT_Type dwt;                       /*!< Cycle counter */
+    CoreDebug_Type core_debug;          /*!< Core debug */
+} stm32f4_model_regs_t;
+
+extern stm32f4_model_regs_t stm32f4_model_regs;    /*!< Registers of the model */
+extern uint8_t stm32f4_model_bkpsram[4096];        /*!< Backup SRAM of the model */
+
+/* Defines and enums ----------------------------------------------------------*/
+/* Instances */
+#define TIM1 (&stm32f4_model_regs.tim1)                     /*!< TIM1 @hideinitializer */
+#define TIM2 (&stm32f4_model_regs.tim2)                     /*!< TIM2 @hideinitializer */
+#define TIM3 (&stm32f4_model_regs.tim3)                     /*!< TIM3 @hideinitializer */
+#define TIM4 (&stm32f4_model_regs.tim4)                     /*!< TIM4 @hideinitializer */
+#define TIM5 (&stm32f4_model_regs.tim5)                     /*!< TIM5 @hideinitializer */
+#define TIM8 (&stm32f4_model_regs.tim8)                     /*!< TIM8 @hideinitializer */
+#define GPIOA (&stm32f4_model_regs.gpio[0])                 /*!< GPIOA @hideinitializer */
+#define GPIOB (&stm32f4_model_regs.gpio[1])                 /*!< GPIOB @hideinitializer */
+#define GPIOC (&stm32f4_model_regs.gpio[2])                 /*!< GPIOC @hideinitializer */
+#define EXTI (&stm32f4_model_regs.exti)                     /*!< EXTI @hideinitializer */
+#define SYSCFG (&stm32f4_model_regs.syscfg)                 /*!< SYSCFG @hideinitializer */
+#define RCC (&stm32f4_model_regs.rcc)                       /*!< RCC @hideinitializer */
+#define PWR (&stm32f4_model_regs.pwr)                       /*!< PWR @hideinitializer */
+#define FLASH (&stm32f4_model_regs.flash)                   /*!< Flash interface @hideinitializer */
+#define CRC (&stm32f4_model_regs.crc)                       /*!< CRC @hideinitializer */
+#define DMA1 (&stm32f4_model_regs.dma1)                     /*!< DMA1 @hideinitializer */
+#define DMA2 (&stm32f4_model_regs.dma2)                     /*!< DMA2 @hideinitializer */
+#define DMA1_Stream0 (&stm32f4_model_regs.dma1_stream[0])   /*!< Stream 0 of DMA1 @hideinitializer */
+#define DMA1_Stream1 (&stm32f4_model_regs.dma1_stream[1])   /*!< Stream 1 of DMA1 @hideinitializer */
+#define DMA1_Stream2 (&stm32f4_model_regs.dma1_stream[2])   /*!< Stream 2 of DMA1 @hideinitializer */
+#define DMA1_Stream3 (&stm32f4_model_regs.dma1_stream[3])   /*!< Stream 3 of DMA1 @hideinitializer */
+#define DMA1_Stream4 (&stm32f4_model_regs.dma1_stream[4])   /*!< Stream 4 of DMA1 @hideinitializer */
+#define DMA1_Stream5 (&stm32f4_model_regs.dma1_stream[5])   /*!< Stream 5 of DMA1 @hideinitializer */
+#define DMA1_Stream6 (&stm32f4_model_regs.dma1_stream[6])   /*!< Stream 6 of DMA1 @hideinitializer */
+#define DMA1_Stream7 (&stm32f4_model_regs.dma1_stream[7])   /*!< Stream 7 of DMA1 @hideinitializer */
+#define DMA2_Stream0 (&stm32f4_model_regs.dma2_stream[0])   /*!< Stream 0 of DMA2 @hideinitializer */
+#define DMA2_Stream1 (&stm32f4_model_regs.dma2_stream[1])   /*!< Stream 1 of DMA2 @hideinitializer */
+#define DMA2_Stream2 (&stm32f4_model_regs.dma2_stream[2])   /*!< Stream 2 of DMA2 @hideinitializer */
+#define DMA2_Stream3 (&stm32f4_model_regs.dma2_stream[3])   /*!< Stream 3 of DMA2 @hideinitializer */
+#define DMA2_Stream4 (&stm32f4_model_regs.dma2_stream[4])   /*!< Stream 4 of DMA2 @hideinitializer */
+#define DMA2_Stream5 (&stm32f4_model_regs.dma2_stream[5])   /*!< Stream 5 of DMA2 @hideinitializer */
+#define DMA2_Stream6 (&stm32f4_model_regs.dma2_stream[6])   /*!< Stream 6 of DMA2 @hideinitializer */
+#define DMA2_Stream7 (&stm32f4_model_regs.dma2_stream[7])   /*!< Stream 7 of DMA2 @hideinitializer */
+#define I2C2 (&stm32f4_model_regs.i2c2)                     /*!< I2C2 @hideinitializer */
+#define CAN1 (&stm32f4_model_regs.can1)                     /*!< CAN1 @hideinitializer */
+#define SCB (&stm32f4_model_regs.scb)                       /*!< System control block @hideinitializer */
+#define SysTick (&stm32f4_model_regs.systick)               /*!< System timer @hideinitializer */
+#define NVIC (&stm32f4_model_regs.nvic)                     /*!< Interrupt controller @hideinitializer */
+#define DWT (&stm32f4_model_regs.dwt)                       /*!< Cycle counter @hideinitializer */
+#define CoreDebug (&stm32f4_model_regs.core_debug)          /*!< Core debug @hideinitializer */
+
+/* Memories */
+#define SRAM1_BASE 0x20000000UL                                     /*!< Base address of SRAM1 on the target */
+#define BKPSRAM_BASE ((uintptr_t)stm32f4_model_bkpsram)            /*!< Base address of the backup SRAM of the model */
+
+/* Register access helpers */
+#define SET_BIT(REG, BIT) ((REG) |= (BIT))                                                          /*!< Set bits of a register @hideinitializer */
+#define CLEAR_BIT(REG, BIT) ((REG) &= ~(BIT))                                                       /*!< Clear bits of a register @hideinitializer */
+#define READ_BIT(REG, BIT) ((REG) & (BIT))                                                          /*!< Read bits of a register @hideinitializer */
+#define CLEAR_REG(REG) ((REG) = (0x0))                                                              /*!< Clear a register @hideinitializer */
+#define WRITE_REG(REG, VAL) ((REG) = (VAL))                                                         /*!< Write a register @hideinitializer */
+#define READ_REG(REG) ((REG))                                                                       /*!< Read a register @hideinitializer */
+#define MODIFY_REG(REG, CLEARMASK, SETMASK) WRITE_REG((REG), (((READ_REG(REG)) & (~(CLEARMASK))) | (SETMASK))) /*!< Modify bits of a register @hideinitializer */
+
+/* Bit definitions. The masks are `unsigned int` (32 bits), not `unsigned long` as in CMSIS: `long` has 64 bits on the host, and
+ * `REG &= ~MASK` would not fit in the registers. */
+/* TIM */
+#define TIM_CR1_CEN_Pos 0U
+#define TIM_CR1_CEN_Msk (0x1U << TIM_CR1_CEN_Pos)
+#define TIM_CR1_CEN TIM_CR1_CEN_Msk
+#define TIM_CR1_UDIS_Pos 1U
+#define TIM_CR1_UDIS_Msk (0x1U << TIM_CR1_UDIS_Pos)
+#define TIM_CR1_UDIS TIM_CR1_UDIS_Msk
+#define TIM_CR1_URS_Pos 2U
+#define TIM_CR1_URS_Msk (0x1U << TIM_CR1_URS_Pos)
+#define TIM_CR1_URS TIM_CR1_URS_Msk
+#define TIM_CR1_OPM_Pos 3U
+#define TIM_CR1_OPM_Msk (0x1U << TIM_CR1_OPM_Pos)
+#define TIM_CR1_OPM TIM_CR1_OPM_Msk
+#define TIM_CR1_DIR_Pos 4U
+#define TIM_CR1_DIR_Msk (0x1U << TIM_CR1_DIR_Pos)
+#define TIM_CR1_DIR TIM_CR1_DIR_Msk
+#define TIM_CR1_ARPE_Pos 7U
+#define TIM_CR1_ARPE_Msk (0x1U << TIM_CR1_ARPE_Pos)
+#define TIM_CR1_ARPE TIM_CR1_ARPE_Msk
+#define TIM_CR2_MMS_Pos 4U
+#define TIM_CR2_MMS_Msk (0x7U << TIM_CR2_MMS_Pos)
+#define TIM_CR2_MMS TIM_CR2_MMS_Msk
+#define TIM_DIER_UIE_Pos 0U
+#define TIM_DIER_UIE_Msk (0x1U << TIM_DIER_UIE_Pos)
+#define TIM_DIER_UIE TIM_DIER_UIE_Msk
+#define TIM_DIER_CC1IE_Pos 1U
+#define TIM_DIER_CC1IE_Msk (0x1U << TIM_DIER_CC1IE_Pos)
+#define TIM_DIER_CC1IE TIM_DIER_CC1IE_Msk
+#define TIM_DIER_CC2IE_Pos 2U
+#define TIM_DIER_CC2IE_Msk (0x1U << TIM_DIER_CC2IE_Pos)
+#define TIM_DIER_CC2IE TIM_DIER_CC2IE_Msk
+#define TIM_DIER_CC3IE_Pos 3U
+#define TIM_DIER_CC3IE_Msk (0x1U << TIM_DIER_CC3IE_Pos)
+#define TIM_DIER_CC3IE TIM_DIER_CC3IE_Msk
+#define TIM_DIER_CC4IE_Pos 4U
+#define TIM_DIER_CC4IE_Msk (0x1U << TIM_DIER_CC4IE_Pos)
+#define TIM_DIER_CC4IE TIM_DIER_CC4IE_Msk
+#define TIM_DIER_UDE_Pos 8U
+#define TIM_DIER_UDE_Msk (0x1U << TIM_DIER_UDE_Pos)
+#define TIM_DIER_UDE TIM_DIER_UDE_Msk
+#define TIM_DIER_CC1DE_Pos 9U
+#define TIM_DIER_CC1DE_Msk (0x1U << TIM_DIER_CC1DE_Pos)
+#define TIM_DIER_CC1DE TIM_DIER_CC1DE_Msk
+#define TIM_SR_UIF_Pos 0U
+#define TIM_SR_UIF_Msk (0x1U << TIM_SR_UIF_Pos)
+#define TIM_SR_UIF TIM_SR_UIF_Msk
+#define TIM_SR_CC1IF_Pos 1U
+#define TIM_SR_CC1IF_Msk (0x1U << TIM_SR_CC1IF_Pos)
+#define TIM_SR_CC1IF TIM_SR_CC1IF_Msk
+#define TIM_SR_CC2IF_Pos 2U
+#define TIM_SR_CC2IF_Msk (0x1U << TIM_SR_CC2IF_Pos)
+#define TIM_SR_CC2IF TIM_SR_CC2IF_Msk
+#define TIM_SR_CC3IF_Pos 3U
+#define TIM_SR_CC3IF_Msk (0x1U << TIM_SR_CC3IF_Pos)
+#define TIM_SR_CC3IF TIM_SR_CC3IF_Msk
+#define TIM_SR_CC4IF_Pos 4U
+#define TIM_SR_CC4IF_Msk (0x1U << TIM_SR_CC4IF_Pos)
+#define TIM_SR_CC4IF TIM_SR_CC4IF_Msk
+#define TIM_SR_CC1OF_Pos 9U
+#define TIM_SR_CC1OF_Msk (0x1U << TIM_SR_CC1OF_Pos)
+#define TIM_SR_CC1OF TIM_SR_CC1OF_Msk
+#define TIM_SR_CC2OF_Pos 10U
+#define TIM_SR_CC2OF_Msk (0x1U << TIM_SR_CC2OF_Pos)
+#define TIM_SR_CC2OF TIM_SR_CC2OF_Msk
+#define TIM_SR_CC3OF_Pos 11U
+#define TIM_SR_CC3OF_Msk (0x1U << TIM_SR_CC3OF_Pos)
+#define TIM_SR_CC3OF TIM_SR_CC3OF_Msk
+#define TIM_SR_CC4OF_Pos 12U
+#define TIM_SR_CC4OF_Msk (0x1U << TIM_SR_CC4OF_Pos)
+#define TIM_SR_CC4OF TIM_SR_CC4OF_Msk
+#define TIM_EGR_UG_Pos 0U
+#define TIM_EGR_UG_Msk (0x1U << TIM_EGR_UG_Pos)
+#define TIM_EGR_UG TIM_EGR_UG_Msk
+#define TIM_CCMR1_CC1S_Pos 0U
+#define TIM_CCMR1_CC1S_Msk (0x3U << TIM_CCMR1_CC1S_Pos)
+#define TIM_CCMR1_CC1S TIM_CCMR1_CC1S_Msk
+#define TIM_CCMR1_CC1S_0 (0x1U << TIM_CCMR1_CC1S_Pos)
+#define TIM_CCMR1_CC1S_1 (0x2U << TIM_CCMR1_CC1S_Pos)
+#define TIM_CCMR1_OC1PE_Pos 3U
+#define TIM_CCMR1_OC1PE_Msk (0x1U << TIM_CCMR1_OC1PE_Pos)
+#define TIM_CCMR1_OC1PE TIM_CCMR1_OC1PE_Msk
+#define TIM_CCMR1_OC1M_Pos 4U
+#define TIM_CCMR1_OC1M_Msk (0x7U << TIM_CCMR1_OC1M_Pos)
+#define TIM_CCMR1_OC1M TIM_CCMR1_OC1M_Msk
+#define TIM_CCMR1_OC1M_0 (0x1U << TIM_CCMR1_OC1M_Pos)
+#define TIM_CCMR1_OC1M_1 (0x2U << TIM_CCMR1_OC1M_Pos)
+#define TIM_CCMR1_OC1M_2 (0x4U << TIM_CCMR1_OC1M_Pos)
+#define TIM_CCMR1_IC1PSC_Pos 2U
+#define TIM_CCMR1_IC1PSC_Msk (0x3U << TIM_CCMR1_IC1PSC_Pos)
+#define TIM_CCMR1_IC1PSC TIM_CCMR1_IC1PSC_Msk
+#define TIM_CCMR1_IC1F_Pos 4U
+#define TIM_CCMR1_IC1F_Msk (0xFU << TIM_CCMR1_IC1F_Pos)
+#define TIM_CCMR1_IC1F TIM_CCMR1_IC1F_Msk
+#define TIM_CCMR1_CC2S_Pos 8U
+#define TIM_CCMR1_CC2S_Msk (0x3U << TIM_CCMR1_CC2S_Pos)
+#define TIM_CCMR1_CC2S TIM_CCMR1_CC2S_Msk
+#define TIM_CCMR1_CC2S_0 (0x1U << TIM_CCMR1_CC2S_Pos)
+#define TIM_CCMR1_CC2S_1 (0x2U << TIM_CCMR1_CC2S_Pos)
+#define TIM_CCMR1_OC2PE_Pos 11U
+#define TIM_CCMR1_OC2PE_Msk (0x1U << TIM_CCMR1_OC2PE_Pos)
+#define TIM_CCMR1_OC2PE TIM_CCMR1_OC2PE_Msk
+#define TIM_CCMR1_OC2M_Pos 12U
+#define TIM_CCMR1_OC2M_Msk (0x7U << TIM_CCMR1_OC2M_Pos)
+#define TIM_CCMR1_OC2M TIM_CCMR1_OC2M_Msk
+#define TIM_CCMR1_OC2M_0 (0x1U << TIM_CCMR1_OC2M_Pos)
+#define TIM_CCMR1_OC2M_1 (0x2U << TIM_CCMR1_OC2M_Pos)
+#define TIM_CCMR1_OC2M_2 (0x4U << TIM_CCMR1_OC2M_Pos)
+#define TIM_CCMR1_IC2PSC_Pos 10U
+#define TIM_CCMR1_IC2PSC_Msk (0x3U << TIM_CCMR1_IC2PSC_Pos)
+#define TIM_CCMR1_IC2PSC TIM_CCMR1_IC2PSC_Msk
+#define TIM_CCMR1_IC2F_Pos 12U
+#define TIM_CCMR1_IC2F_Msk (0xFU << TIM_CCMR1_IC2F_Pos)
+#define TIM_CCMR1_IC2F TIM_CCMR1_IC2F_Msk
+#define TIM_CCMR2_CC3S_Pos 0U
+#define TIM_CCMR2_CC3S_Msk (0x3U << TIM_CCMR2_CC3S_Pos)
+#define TIM_CCMR2_CC3S TIM_CCMR2_CC3S_Msk
+#define TIM_CCMR2_OC3PE_Pos 3U
+#define TIM_CCMR2_OC3PE_Msk (0x1U << TIM_CCMR2_OC3PE_Pos)
+#define TIM_CCMR2_OC3PE TIM_CCMR2_OC3PE_Msk
+#define TIM_CCMR2_OC3M_Pos 4U
+#define TIM_CCMR2_OC3M_Msk (0x7U << TIM_CCMR2_OC3M_Pos)
+#define TIM_CCMR2_OC3M TIM_CCMR2_OC3M_Msk
+#define TIM_CCMR2_OC3M_0 (0x1U << TIM_CCMR2_OC3M_Pos)
+#define TIM_CCMR2_OC3M_1 (0x2U << TIM_CCMR2_OC3M_Pos)
+#define TIM_CCMR2_OC3M_2 (0x4U << TIM_CCMR2_OC3M_Pos)
+#define TIM_CCMR2_CC4S_Pos 8U
+#define TIM_CCMR2_CC4S_Msk (0x3U << TIM_CCMR2_CC4S_Pos)
+#define TIM_CCMR2_CC4S TIM_CCMR2_CC4S_Msk
+#define TIM_CCMR2_OC4PE_Pos 11U
+#define TIM_CCMR2_OC4PE_Msk (0x1U << TIM_CCMR2_OC4PE_Pos)
+#define TIM_CCMR2_OC4PE TIM_CCMR2_OC4PE_Msk
+#define TIM_CCMR2_OC4M_Pos 12U
+#define TIM_CCMR2_OC4M_Msk (0x7U << TIM_CCMR2_OC4M_Pos)
+#define TIM_CCMR2_OC4M TIM_CCMR2_OC4M_Msk
+#define TIM_CCMR2_OC4M_0 (0x1U << TIM_CCMR2_OC4M_Pos)
+#define TIM_CCMR2_OC4M_1 (0x2U << TIM_CCMR2_OC4M_Pos)
+#define TIM_CCMR2_OC4M_2 (0x4U << TIM_CCMR2_OC4M_Pos)
+#define TIM_CCER_CC1E_Pos 0U
+#define TIM_CCER_CC1E_Msk (0x1U << TIM_CCER_CC1E_Pos)
+#define TIM_CCER_CC1E TIM_CCER_CC1E_Msk
+#define TIM_CCER_CC1P_Pos 1U
+#define TIM_CCER_CC1P_Msk (0x1U << TIM_CCER_CC1P_Pos)
+#define TIM_CCER_CC1P TIM_CCER_CC1P_Msk
+#define TIM_CCER_CC1NP_Pos 3U
+#define TIM_CCER_CC1NP_Msk (0x1U << TIM_CCER_CC1NP_Pos)
+#define TIM_CCER_CC1NP TIM_CCER_CC1NP_Msk
+#define TIM_CCER_CC2E_Pos 4U
+#define TIM_CCER_CC2E_Msk (0x1U << TIM_CCER_CC2E_Pos)
+#define TIM_CCER_CC2E TIM_CCER_CC2E_Msk
+#define TIM_CCER_CC2P_Pos 5U
+#define TIM_CCER_CC2P_Msk (0x1U << TIM_CCER_CC2P_Pos)
+#define TIM_CCER_CC2P TIM_CCER_CC2P_Msk
+#define TIM_CCER_CC2NP_Pos 7U
+#define TIM_CCER_CC2NP_Msk (0x1U << TIM_CCER_CC2NP_Pos)
+#define TIM_CCER_CC2NP TIM_CCER_CC2NP_Msk
+#define TIM_CCER_CC3E_Pos 8U
+#define TIM_CCER_CC3E_Msk (0x1U << TIM_CCER_CC3E_Pos)
+#define TIM_CCER_CC3E TIM_CCER_CC3E_Msk
+#define TIM_CCER_CC3P_Pos 9U
+#define TIM_CCER_CC3P_Msk (0x1U << TIM_CCER_CC3P_Pos)
+#define TIM_CCER_CC3P TIM_CCER_CC3P_Msk
+#define TIM_CCER_CC3NP_Pos 11U
+#define TIM_CCER_CC3NP_Msk (0x1U << TIM_CCER_CC3NP_Pos)
+#define TIM_CCER_CC3NP TIM_CCER_CC3NP_Msk
+#define TIM_CCER_CC4E_Pos 12U
+#define TIM_CCER_CC4E_Msk (0x1U << TIM_CCER_CC4E_Pos)
+#define TIM_CCER_CC4E TIM_CCER_CC4E_Msk
+#define TIM_CCER_CC4P_Pos 13U
+#define TIM_CCER_CC4P_Msk (0x1U << TIM_CCER_CC4P_Pos)
+#define TIM_CCER_CC4P TIM_CCER_CC4P_Msk
+#define TIM_CCER_CC4NP_Pos 15U
+#define TIM_CCER_CC4NP_Msk (0x1U << TIM_CCER_CC4NP_Pos)
+#define TIM_CCER_CC4NP TIM_CCER_CC4NP_Msk
+#define TIM_BDTR_MOE_Pos 15U
+#define TIM_BDTR_MOE_Msk (0x1U << TIM_BDTR_MOE_Pos)
+#define TIM_BDTR_MOE TIM_BDTR_MOE_Msk
+
+/* GPIO */
+#define GPIO_MODER_MODER0_Pos 0U
+#define GPIO_MODER_MODER0_Msk (0x3U << GPIO_MODER_MODER0_Pos)
+#define GPIO_MODER_MODER0 GPIO_MODER_MODER0_Msk
+#define GPIO_PUPDR_PUPD0_Pos 0U
+#define GPIO_PUPDR_PUPD0_Msk (0x3U << GPIO_PUPDR_PUPD0_Pos)
+#define GPIO_PUPDR_PUPD0 GPIO_PUPDR_PUPD0_Msk
+#define GPIO_ODR_OD0_Pos 0U
+#define GPIO_ODR_OD0_Msk (0x1U << GPIO_ODR_OD0_Pos)
+#define GPIO_ODR_OD0 GPIO_ODR_OD0_Msk
+#define GPIO_IDR_ID0_Pos 0U
+#define GPIO_IDR_ID0_Msk (0x1U << GPIO_IDR_ID0_Pos)
+#define GPIO_IDR_ID0 GPIO_IDR_ID0_Msk
+
+/* EXTI */
+#define EXTI_IMR_MR0_Pos 0U
+#define EXTI_IMR_MR0_Msk (0x1U << EXTI_IMR_MR0_Pos)
+#define EXTI_IMR_MR0 EXTI_IMR_MR0_Msk
+#define EXTI_EMR_MR0_Pos 0U
+#define EXTI_EMR_MR0_Msk (0x1U << EXTI_EMR_MR0_Pos)
+#define EXTI_EMR_MR0 EXTI_EMR_MR0_Msk
+#define EXTI_RTSR_TR0_Pos 0U
+#define EXTI_RTSR_TR0_Msk (0x1U << EXTI_RTSR_TR0_Pos)
+#define EXTI_RTSR_TR0 EXTI_RTSR_TR0_Msk
+#define EXTI_FTSR_TR0_Pos 0U
+#define EXTI_FTSR_TR0_Msk (0x1U << EXTI_FTSR_TR0_Pos)
+#define EXTI_FTSR_TR0 EXTI_FTSR_TR0_Msk
+#define EXTI_PR_PR0_Pos 0U
+#define EXTI_PR_PR0_Msk (0x1U << EXTI_PR_PR0_Pos)
+#define EXTI_PR_PR0 EXTI_PR_PR0_Msk
+
+/* RCC */
+#define RCC_CR_HSION_Pos 0U
+#define RCC_CR_HSION_Msk (0x1U << RCC_CR_HSION_Pos)
+#define RCC_CR_HSION RCC_CR_HSION_Msk
+#define RCC_CR_HSIRDY_Pos 1U
+#define RCC_CR_HSIRDY_Msk (0x1U << RCC_CR_HSIRDY_Pos)
+#define RCC_CR_HSIRDY RCC_CR_HSIRDY_Msk
+#define RCC_CR_HSITRIM_Pos 3U
+#define RCC_CR_HSITRIM_Msk (0x1FU << RCC_CR_HSITRIM_Pos)
+#define RCC_CR_HSITRIM RCC_CR_HSITRIM_Msk
+#define RCC_CFGR_SW_Pos 0U
+#define RCC_CFGR_SW_Msk (0x3U << RCC_CFGR_SW_Pos)
+#define RCC_CFGR_SW RCC_CFGR_SW_Msk
+#define RCC_CFGR_SW_HSI 0x00000000U
+#define RCC_CFGR_HPRE_Pos 4U
+#define RCC_CFGR_HPRE_Msk (0xFU << RCC_CFGR_HPRE_Pos)
+#define RCC_CFGR_HPRE RCC_CFGR_HPRE_Msk
+#define RCC_CFGR_PPRE1_Pos 10U
+#define RCC_CFGR_PPRE1_Msk (0x7U << RCC_CFGR_PPRE1_Pos)
+#define RCC_CFGR_PPRE1 RCC_CFGR_PPRE1_Msk
+#define RCC_AHB1ENR_GPIOAEN (0x1U << 0U)
+#define RCC_AHB1ENR_GPIOBEN (0x1U << 1U)
+#define RCC_AHB1ENR_GPIOCEN (0x1U << 2U)
+#define RCC_AHB1ENR_CRCEN (0x1U << 12U)
+#define RCC_AHB1ENR_BKPSRAMEN (0x1U << 18U)
+#define RCC_AHB1ENR_DMA1EN (0x1U << 21U)
+#define RCC_AHB1ENR_DMA2EN (0x1U << 22U)
+#define RCC_APB1ENR_TIM2EN (0x1U << 0U)
+#define RCC_APB1ENR_TIM3EN (0x1U << 1U)
+#define RCC_APB1ENR_TIM4EN (0x1U << 2U)
+#define RCC_APB1ENR_TIM5EN (0x1U << 3U)
+#define RCC_APB1ENR_I2C1EN (0x1U << 21U)
+#define RCC_APB1ENR_I2C2EN (0x1U << 22U)
+#define RCC_APB1ENR_CAN1EN (0x1U << 25U)
+#define RCC_APB1ENR_PWREN (0x1U << 28U)
+#define RCC_APB2ENR_TIM1EN (0x1U << 0U)
+#define RCC_APB2ENR_TIM8EN (0x1U << 1U)
+#define RCC_APB2ENR_SYSCFGEN (0x1U << 14U)
+#define RCC_CSR_RMVF (0x1U << 24U)
+#define RCC_CSR_BORRSTF (0x1U << 25U)
+#define RCC_CSR_PORRSTF (0x1U << 27U)
+
+/* PWR */
+#define PWR_CR_LPDS (0x1U << 0U)
+#define PWR_CR_PDDS (0x1U << 1U)
+#define PWR_CR_CWUF (0x1U << 2U)
+#define PWR_CR_CSBF (0x1U << 3U)
+#define PWR_CR_DBP (0x1U << 8U)
+#define PWR_CR_VOS_Pos 14U
+#define PWR_CR_VOS_Msk (0x3U << PWR_CR_VOS_Pos)
+#define PWR_CR_VOS PWR_CR_VOS_Msk
+#define PWR_CSR_WUF (0x1U << 0U)
+#define PWR_CSR_SBF (0x1U << 1U)
+#define PWR_CSR_BRR (0x1U << 3U)
+#define PWR_CSR_BRE (0x1U << 9U)
+
+/* FLASH */
+#define FLASH_ACR_LATENCY_Pos 0U
+#define FLASH_ACR_LATENCY_Msk (0xFU << FLASH_ACR_LATENCY_Pos)
+#define FLASH_ACR_LATENCY FLASH_ACR_LATENCY_Msk
+#define FLASH_ACR_LATENCY_2WS 0x00000002U
+#define FLASH_ACR_PRFTEN (0x1U << 8U)
+#define FLASH_ACR_ICEN (0x1U << 9U)
+#define FLASH_ACR_DCEN (0x1U << 10U)
+#define FLASH_ACR_ICRST (0x1U << 11U)
+#define FLASH_ACR_DCRST (0x1U << 12U)
+
+/* CRC */
+#define CRC_CR_RESET (0x1U << 0U)
+
+/* DMA */
+#define DMA_SxCR_EN (0x1U << 0U)
+#define DMA_SxCR_TEIE (0x1U << 2U)
+#define DMA_SxCR_HTIE (0x1U << 3U)
+#define DMA_SxCR_TCIE (0x1U << 4U)
+#define DMA_SxCR_DIR_0 (0x1U << 6U)
+#define DMA_SxCR_DIR_1 (0x1U << 7U)
+#define DMA_SxCR_CIRC (0x1U << 8U)
+#define DMA_SxCR_PINC (0x1U << 9U)
+#define DMA_SxCR_MINC (0x1U << 10U)
+#define DMA_SxCR_PSIZE_0 (0x1U << 11U)
+#define DMA_SxCR_PSIZE_1 (0x1U << 12U)
+#define DMA_SxCR_MSIZE_0 (0x1U << 13U)
+#define DMA_SxCR_MSIZE_1 (0x1U << 14U)
+#define DMA_SxCR_PL_0 (0x1U << 16U)
+#define DMA_SxCR_PL_1 (0x1U << 17U)
+#define DMA_SxCR_CHSEL_Pos 25U
+#define DMA_LISR_FEIF1 (0x1U << 6U)
+#define DMA_LISR_TEIF1 (0x1U << 9U)
+#define DMA_LISR_HTIF1 (0x1U << 10U)
+#define DMA_LISR_TCIF1 (0x1U << 11U)
+#define DMA_LIFCR_CFEIF1 (0x1U << 6U)
+#define DMA_LIFCR_CDMEIF1 (0x1U << 8U)
+#define DMA_LIFCR_CTEIF1 (0x1U << 9U)
+#define DMA_LIFCR_CHTIF1 (0x1U << 10U)
+#define DMA_LIFCR_CTCIF1 (0x1U << 11U)
+#define DMA_LIFCR_CFEIF2 (0x1U << 16U)
+#define DMA_LIFCR_CDMEIF2 (0x1U << 18U)
+#define DMA_LIFCR_CTEIF2 (0x1U << 19U)
+#define DMA_LIFCR_CHTIF2 (0x1U << 20U)
+#define DMA_LIFCR_CTCIF2 (0x1U << 21U)
+#define DMA_LISR_TEIF2 (0x1U << 19U)
+#define DMA_LISR_TCIF2 (0x1U << 21U)
+#define DMA_HISR_TEIF7 (0x1U << 25U)
+#define DMA_HISR_TCIF7 (0x1U << 27U)
+#define DMA_HIFCR_CFEIF7 (0x1U << 22U)
+#define DMA_HIFCR_CDMEIF7 (0x1U << 24U)
+#define DMA_HIFCR_CTEIF7 (0x1U << 25U)
+#define DMA_HIFCR_CHTIF7 (0x1U << 26U)
+#define DMA_HIFCR_CTCIF7 (0x1U << 27U)
+
+/* I2C */
+#define I2C_CR1_PE (0x1U << 0U)
+#define I2C_CR1_START (0x1U << 8U)
+#define I2C_CR1_STOP (0x1U << 9U)
+#define I2C_CR1_ACK (0x1U << 10U)
+#define I2C_CR1_SWRST (0x1U << 15U)
+#define I2C_CR2_FREQ_Pos 0U
+#define I2C_CR2_FREQ (0x3FU << I2C_CR2_FREQ_Pos)
+#define I2C_CR2_ITERREN (0x1U << 8U)
+#define I2C_CR2_ITEVTEN (0x1U << 9U)
+#define I2C_CR2_ITBUFEN (0x1U << 10U)
+#define I2C_CR2_DMAEN (0x1U << 11U)
+#define I2C_CR2_LAST (0x1U << 12U)
+#define I2C_SR1_SB (0x1U << 0U)
+#define I2C_SR1_ADDR (0x1U << 1U)
+#define I2C_SR1_BTF (0x1U << 2U)
+#define I2C_SR1_RXNE (0x1U << 6U)
+#define I2C_SR1_TXE (0x1U << 7U)
+#define I2C_SR1_BERR (0x1U << 8U)
+#define I2C_SR1_ARLO (0x1U << 9U)
+#define I2C_SR1_AF (0x1U << 10U)
+#define I2C_SR1_OVR (0x1U << 11U)
+#define I2C_SR2_BUSY (0x1U << 1U)
+#define I2C_CCR_CCR (0xFFFU << 0U)
+#define I2C_CCR_DUTY (0x1U << 14U)
+#define I2C_CCR_FS (0x1U << 15U)
+
+/* CAN */
+#define CAN_MCR_INRQ (0x1U << 0U)
+#define CAN_MCR_SLEEP (0x1U << 1U)
+#define CAN_MCR_TXFP (0x1U << 2U)
+#define CAN_MCR_ABOM (0x1U << 6U)
+#define CAN_MSR_INAK (0x1U << 0U)
+#define CAN_MSR_SLAK (0x1U << 1U)
+#define CAN_TSR_CODE_Pos 24U
+#define CAN_TSR_CODE_Msk (0x3U << CAN_TSR_CODE_Pos)
+#define CAN_TSR_CODE CAN_TSR_CODE_Msk
+#define CAN_TSR_TME0 (0x1U << 26U)
+#define CAN_TSR_TME1 (0x1U << 27U)
+#define CAN_TSR_TME2 (0x1U << 28U)
+#define CAN_TI0R_TXRQ (0x1U << 0U)
+#define CAN_TI0R_IDE (0x1U << 2U)
+#define CAN_TI0R_EXID_Pos 3U
+#define CAN_TI0R_STID_Pos 21U
+#define CAN_TDT0R_DLC (0xFU << 0U)
+#define CAN_RF0R_FMP0 (0x3U << 0U)
+#define CAN_RF0R_RFOM0 (0x1U << 5U)
+#define CAN_RI0R_IDE (0x1U << 2U)
+#define CAN_RI0R_EXID_Pos 3U
+#define CAN_RI0R_STID_Pos 21U
+#define CAN_RDT0R_DLC (0xFU << 0U)
+#define CAN_BTR_BRP_Pos 0U
+#define CAN_BTR_BRP (0x3FFU << CAN_BTR_BRP_Pos)
+#define CAN_BTR_TS1_Pos 16U
+#define CAN_BTR_TS1 (0xFU << CAN_BTR_TS1_Pos)
+#define CAN_BTR_TS2_Pos 20U
+#define CAN_BTR_TS2 (0x7U << CAN_BTR_TS2_Pos)
+#define CAN_BTR_SJW_Pos 24U
+#define CAN_BTR_SJW (0x3U << CAN_BTR_SJW_Pos)
+#define CAN_BTR_LBKM (0x1U << 30U)
+#define CAN_BTR_SILM (0x1U << 31U)
+#define CAN_FMR_FINIT (0x1U << 0U)
+#define CAN_FA1R_FACT0 (0x1U << 0U)
+#define CAN_FM1R_FBM0 (0x1U << 0U)
+#define CAN_FS1R_FSC0 (0x1U << 0U)
+#define CAN_FFA1R_FFA0 (0x1U << 0U)
+
+/* SCB */
+#define SCB_ICSR_PENDSTCLR_Pos 25U
+#define SCB_ICSR_PENDSTCLR_Msk (1U << SCB_ICSR_PENDSTCLR_Pos)
+#define SCB_ICSR_PENDSTSET_Pos 26U
+#define SCB_ICSR_PENDSTSET_Msk (1U << SCB_ICSR_PENDSTSET_Pos)
+#define SCB_AIRCR_VECTKEY_Pos 16U
+#define SCB_AIRCR_VECTKEY_Msk (0xFFFFU << SCB_AIRCR_VECTKEY_Pos)
+#define SCB_AIRCR_PRIGROUP_Pos 8U
+#define SCB_AIRCR_PRIGROUP_Msk (7U << SCB_AIRCR_PRIGROUP_Pos)
+#define SCB_SCR_SLEEPDEEP_Pos 2U
+#define SCB_SCR_SLEEPDEEP_Msk (1U << SCB_SCR_SLEEPDEEP_Pos)
+
+/* SysTick */
+#define SysTick_CTRL_ENABLE_Pos 0U
+#define SysTick_CTRL_ENABLE_Msk (1U << SysTick_CTRL_ENABLE_Pos)
+#define SysTick_CTRL_TICKINT_Pos 1U
+#define SysTick_CTRL_TICKINT_Msk (1U << SysTick_CTRL_TICKINT_Pos)
+#define SysTick_CTRL_CLKSOURCE_Pos 2U
+#define SysTick_CTRL_CLKSOURCE_Msk (1U << SysTick_CTRL_CLKSOURCE_Pos)
+#define SysTick_CTRL_COUNTFLAG_Pos 16U
+#define SysTick_CTRL_COUNTFLAG_Msk (1U << SysTick_CTRL_COUNTFLAG_Pos)
+#define SysTick_LOAD_RELOAD_Msk (0xFFFFFFU)
+
+/* DWT and CoreDebug */
+#define DWT_CTRL_CYCCNTENA_Pos 0U
+#define DWT_CTRL_CYCCNTENA_Msk (1U << DWT_CTRL_CYCCNTENA_Pos)
+#define CoreDebug_DEMCR_TRCENA_Pos 24U
+#define CoreDebug_DEMCR_TRCENA_Msk (1U << CoreDebug_DEMCR_TRCENA_Pos)
+
+/* Function prototypes -------------------------------------------------------*/
+/* Clock of the system (defined by the port, as on the target) */
+extern uint32_t SystemCoreClock;            /*!< Frequency of the System clock */
+extern const uint8_t AHBPrescTable[16];     /*!< Prescaler values for AHB bus */
+extern const uint8_t APBPrescTable[8];      /*!< Prescaler values for APB bus */
+void SystemInit(void);
+
+/* Intrinsics of the core, implemented by the model */
+void stm32f4_model_wfi(void);
+void stm32f4_model_set_primask(uint32_t primask);
+uint32_t stm32f4_model_get_primask(void);
+
+static inline void __WFI(void) { stm32f4_model_wfi(); }                                     /*!< Wait for an interrupt: the virtual clock runs until one is taken */
+static inline void __WFE(void) { stm32f4_model_wfi(); }                                     /*!< Wait for an event: as `__WFI()` */
+static inline void __NOP(void) {}                                                           /*!< No operation */
+static inline void __DSB(void) { __atomic_signal_fence(__ATOMIC_SEQ_CST); }                 /*!< Data synchronization barrier (compiler barrier) */
+static inline void __ISB(void) { __atomic_signal_fence(__ATOMIC_SEQ_CST); }                 /*!< Instruction synchronization barrier (compiler barrier) */
+static inline void __DMB(void) { __atomic_signal_fence(__ATOMIC_SEQ_CST); }                 /*!< Data memory barrier (compiler barrier) */
+static inline void __disable_irq(void) { stm32f4_model_set_primask(1U); }                   /*!< Mask the configurable interrupts */
+static inline void __enable_irq(void) { stm32f4_model_set_primask(0U); }                    /*!< Unmask the configurable interrupts */
+static inline uint32_t __get_PRIMASK(void) { return stm32f4_model_get_primask(); }          /*!< Read PRIMASK */
+static inline void __set_PRIMASK(uint32_t primask) { stm32f4_model_set_primask(primask); }  /*!< Write PRIMASK */
+
+/* Functions of the NVIC and the SysTick of CMSIS. They access the registers as on the target */
+static inline void NVIC_SetPriorityGrouping(uint32_t PriorityGroup)
+{
+    uint32_t reg_value = SCB->AIRCR;
+    reg_value &= ~(SCB_AIRCR_VECTKEY_Msk | SCB_AIRCR_PRIGROUP_Msk);
+    reg_value |= (0x5FAU << SCB_AIRCR_VECTKEY_Pos) | ((PriorityGroup & 0x07UL) << SCB_AIRCR_PRIGROUP_Pos);
+    SCB->AIRCR = reg_value;
+}
+
+static inline uint32_t NVIC_GetPriorityGrouping(void)
+{
+    return (SCB->AIRCR & SCB_AIRCR_PRIGROUP_Msk) >> SCB_AIRCR_PRIGROUP_Pos;
+}
+
+static inline void NVIC_EnableIRQ(IRQn_Type IRQn)
+{
+    if ((int32_t)IRQn >= 0)
+    {
+        NVIC->ISER[((uint32_t)IRQn) >> 5UL] = 1UL << (((uint32_t)IRQn) & 0x1FUL);
+    }
+}
+
+static inline uint32_t NVIC_GetEnableIRQ(IRQn_Type IRQn)
+{
+    if ((int32_t)IRQn >= 0)
+    {
+        return (NVIC->ISER[((uint32_t)IRQn) >> 5UL] >> (((uint32_t)IRQn) & 0x1FUL)) & 1UL;
+    }
+    return 0U;
+}
+
+static inline void NVIC_DisableIRQ(IRQn_Type IRQn)
+{
+    if ((int32_t)IRQn >= 0)
+    {
+        NVIC->ICER[((uint32_t)IRQn) >> 5UL] = 1UL << (((uint32_t)IRQn) & 0x1FUL);
+    }
+}
+
+static inline uint32_t NVIC_GetPendingIRQ(IRQn_Type IRQn)
+{
+    if ((int32_t)IRQn >= 0)
+    {
+        return (NVIC->ISPR[((uint32_t)IRQn) >> 5UL] >> (((uint32_t)IRQn) & 0x1FUL)) & 1UL;
+    }
+    return 0U;
+}
+
+static inline void NVIC_SetPendingIRQ(IRQn_Type IRQn)
+{
+    if ((int32_t)IRQn >= 0)
+    {
+        NVIC->ISPR[((uint32_t)IRQn) >> 5UL] = 1UL << (((uint32_t)IRQn) & 0x1FUL);
+    }
+}
+
+static inline void NVIC_ClearPendingIRQ(IRQn_Type IRQn)
+{
+    if ((int32_t)IRQn >= 0)
+    {
+        NVIC->ICPR[((uint32_t)IRQn) >> 5UL] = 1UL << (((uint32_t)IRQn) & 0x1FUL);
+    }
+}
+
+static inline uint32_t NVIC_GetActive(IRQn_Type IRQn)
+{
+    if ((int32_t)IRQn >= 0)
+    {
+        return (NVIC->IABR[((uint32_t)IRQn) >> 5UL] >> (((uint32_t)IRQn) & 0x1FUL)) & 1UL;
+    }
+    return 0U;
+}
+
+static inline void NVIC_SetPriority(IRQn_Type IRQn, uint32_t priority)
+{
+    if ((int32_t)IRQn >= 0)
+    {
+        NVIC->IP[((uint32_t)IRQn)] = (uint8_t)((priority << (8U - __NVIC_PRIO_BITS)) & 0xFFUL);
+    }
+    else
+    {
+        SCB->SHP[(((uint32_t)IRQn) & 0xFUL) - 4UL] = (uint8_t)((priority << (8U - __NVIC_PRIO_BITS)) & 0xFFUL);
+    }
+}
+
+static inline uint32_t NVIC_GetPriority(IRQn_Type IRQn)
+{
+    if ((int32_t)IRQn >= 0)
+    {
+        return ((uint32_t)NVIC->IP[((uint32_t)IRQn)] >> (8U - __NVIC_PRIO_BITS));
+    }
+    return ((uint32_t)SCB->SHP[(((uint32_t)IRQn) & 0xFUL) - 4UL] >> (8U - __NVIC_PRIO_BITS));
+}
+
+static inline uint32_t NVIC_EncodePriority(uint32_t PriorityGroup, uint32_t PreemptPriority, uint32_t SubPriority)
+{
+    uint32_t PriorityGroupTmp = (PriorityGroup & 0x07UL);
+    uint32_t PreemptPriorityBits = ((7UL - PriorityGroupTmp) > __NVIC_PRIO_BITS) ? __NVIC_PRIO_BITS : (7UL - PriorityGroupTmp);
+    uint32_t SubPriorityBits = ((PriorityGroupTmp + __NVIC_PRIO_BITS) < 7UL) ? 0UL : ((PriorityGroupTmp - 7UL) + __NVIC_PRIO_BITS);
+    return (((PreemptPriority & ((1UL << PreemptPriorityBits) - 1UL)) << SubPriorityBits) | ((SubPriority & ((1UL << SubPriorityBits) - 1UL))));
+}
+
+static inline void NVIC_DecodePriority(uint32_t Priority, uint32_t PriorityGroup, uint32_t *const pPreemptPriority, uint32_t *const pSubPriority)
+{
+    uint32_t PriorityGroupTmp = (PriorityGroup & 0x07UL);
+    uint32_t PreemptPriorityBits = ((7UL - PriorityGroupTmp) > __NVIC_PRIO_BITS) ? __NVIC_PRIO_BITS : (7UL - PriorityGroupTmp);
+    uint32_t SubPriorityBits = ((PriorityGroupTmp + __NVIC_PRIO_BITS) < 7UL) ? 0UL : ((PriorityGroupTmp - 7UL) + __NVIC_PRIO_BITS);
+    *pPreemptPriority = (Priority >> SubPriorityBits) & ((1UL << PreemptPriorityBits) - 1UL);
+    *pSubPriority = (Priority) & ((1UL << SubPriorityBits) - 1UL);
+}
+
+static inline uint32_t SysTick_Config(uint32_t ticks)
+{
+    if ((ticks - 1UL) > SysTick_LOAD_RELOAD_Msk)
+    {
+        return 1UL;
+    }
+    SysTick->LOAD = (uint32_t)(ticks - 1UL);
+    NVIC_SetPriority(SysTick_IRQn, (1UL << __NVIC_PRIO_BITS) - 1UL);
+    SysTick->VAL = 0UL;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+    return 0UL;
+}
+
+#endif /* STM32F4XX_H_ */
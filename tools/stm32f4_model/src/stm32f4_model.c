@@ -0,0 +1,922 @@
+/**
+ * @file stm32f4_model.c
+ * @brief Core of the host register model of the STM32F4: virtual clock, memory-access callbacks, NVIC and system peripherals.
+ *
+ * This file is not instrumented. The firmware under test is compiled with `-fsanitize=thread`, so each of its loads and stores
+ * calls `__tsan_readN()` or `__tsan_writeN()` before the access, and each function calls `__tsan_func_entry()`. A callback:
+ * 1. Applies the side effects of the previous store to a register (the store has been made by then), comparing the value written
+ *    with the value before the store.
+ * 2. Advances the virtual clock one access, runs the events of the peripherals that become due and takes the pending interrupts.
+ * 3. Records the register about to be stored, or refreshes the register about to be loaded.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stddef.h>
+#include <string.h>
+
+/* Project includes */
+#include "stm32f4_model_priv.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define STM32F4_MODEL_NUM_IRQS 97U                          /*!< Number of interrupts of the STM32F446 */
+#define STM32F4_MODEL_NUM_EXCEPTIONS (16U + STM32F4_MODEL_NUM_IRQS) /*!< Exceptions of the core and interrupts */
+#define STM32F4_MODEL_SYSTICK_EXC 15U                       /*!< Exception number of the SysTick */
+#define STM32F4_MODEL_THREAD_PRIO 0x100U                    /*!< Execution priority of the thread mode (lower than any exception) */
+#define STM32F4_MODEL_MAX_STORE_WORDS 5U                    /*!< Words touched by a store of up to 16 bytes */
+
+#define STM32F4_MODEL_IN(p, block) (((uintptr_t)(p) - (uintptr_t) & (block)) < sizeof(block)) /*!< The address is in a register block @hideinitializer */
+
+/**
+ * @brief Handlers of the interrupts, as named by the startup code of the target. They are weak, so a missing handler is NULL.
+ * @hideinitializer
+ */
+#define STM32F4_MODEL_HANDLERS(X)                                                                                     \
+    X(WWDG_IRQn, WWDG_IRQHandler)                                                                                     \
+    X(PVD_IRQn, PVD_IRQHandler)                                                                                       \
+    X(TAMP_STAMP_IRQn, TAMP_STAMP_IRQHandler)                                                                         \
+    X(RTC_WKUP_IRQn, RTC_WKUP_IRQHandler)                                                                             \
+    X(FLASH_IRQn, FLASH_IRQHandler)                                                                                   \
+    X(RCC_IRQn, RCC_IRQHandler)                                                                                       \
+    X(EXTI0_IRQn, EXTI0_IRQHandler)                                                                                   \
+    X(EXTI1_IRQn, EXTI1_IRQHandler)                                                                                   \
+    X(EXTI2_IRQn, EXTI2_IRQHandler)                                                                                   \
+    X(EXTI3_IRQn, EXTI3_IRQHandler)                                                                                   \
+    X(EXTI4_IRQn, EXTI4_IRQHandler)                                                                                   \
+    X(DMA1_Stream0_IRQn, DMA1_Stream0_IRQHandler)                                                                     \
+    X(DMA1_Stream1_IRQn, DMA1_Stream1_IRQHandler)                                                                     \
+    X(DMA1_Stream2_IRQn, DMA1_Stream2_IRQHandler)                                                                     \
+    X(DMA1_Stream3_IRQn, DMA1_Stream3_IRQHandler)                                                                     \
+    X(DMA1_Stream4_IRQn, DMA1_Stream4_IRQHandler)                                                                     \
+    X(DMA1_Stream5_IRQn, DMA1_Stream5_IRQHandler)                                                                     \
+    X(DMA1_Stream6_IRQn, DMA1_Stream6_IRQHandler)                                                                     \
+    X(ADC_IRQn, ADC_IRQHandler)                                                                                       \
+    X(CAN1_TX_IRQn, CAN1_TX_IRQHandler)                                                                               \
+    X(CAN1_RX0_IRQn, CAN1_RX0_IRQHandler)                                                                             \
+    X(CAN1_RX1_IRQn, CAN1_RX1_IRQHandler)                                                                             \
+    X(CAN1_SCE_IRQn, CAN1_SCE_IRQHandler)                                                                             \
+    X(EXTI9_5_IRQn, EXTI9_5_IRQHandler)                                                                               \
+    X(TIM1_BRK_TIM9_IRQn, TIM1_BRK_TIM9_IRQHandler)                                                                   \
+    X(TIM1_UP_TIM10_IRQn, TIM1_UP_TIM10_IRQHandler)                                                                   \
+    X(TIM1_TRG_COM_TIM11_IRQn, TIM1_TRG_COM_TIM11_IRQHandler)                                                         \
+    X(TIM1_CC_IRQn, TIM1_CC_IRQHandler)                                                                               \
+    X(TIM2_IRQn, TIM2_IRQHandler)                                                                                     \
+    X(TIM3_IRQn, TIM3_IRQHandler)                                                                                     \
+    X(TIM4_IRQn, TIM4_IRQHandler)                                                                                     \
+    X(I2C1_EV_IRQn, I2C1_EV_IRQHandler)                                                                               \
+    X(I2C1_ER_IRQn, I2C1_ER_IRQHandler)                                                                               \
+    X(I2C2_EV_IRQn, I2C2_EV_IRQHandler)                                                                               \
+    X(I2C2_ER_IRQn, I2C2_ER_IRQHandler)                                                                               \
+    X(SPI1_IRQn, SPI1_IRQHandler)                                                                                     \
+    X(SPI2_IRQn, SPI2_IRQHandler)                                                                                     \
+    X(USART1_IRQn, USART1_IRQHandler)                                                                                 \
+    X(USART2_IRQn, USART2_IRQHandler)                                                                                 \
+    X(USART3_IRQn, USART3_IRQHandler)                                                                                 \
+    X(EXTI15_10_IRQn, EXTI15_10_IRQHandler)                                                                           \
+    X(RTC_Alarm_IRQn, RTC_Alarm_IRQHandler)                                                                           \
+    X(TIM8_BRK_TIM12_IRQn, TIM8_BRK_TIM12_IRQHandler)                                                                 \
+    X(TIM8_UP_TIM13_IRQn, TIM8_UP_TIM13_IRQHandler)                                                                   \
+    X(TIM8_TRG_COM_TIM14_IRQn, TIM8_TRG_COM_TIM14_IRQHandler)                                                         \
+    X(TIM8_CC_IRQn, TIM8_CC_IRQHandler)                                                                               \
+    X(DMA1_Stream7_IRQn, DMA1_Stream7_IRQHandler)                                                                     \
+    X(TIM5_IRQn, TIM5_IRQHandler)                                                                                     \
+    X(TIM6_DAC_IRQn, TIM6_DAC_IRQHandler)                                                                             \
+    X(TIM7_IRQn, TIM7_IRQHandler)                                                                                     \
+    X(DMA2_Stream0_IRQn, DMA2_Stream0_IRQHandler)                                                                     \
+    X(DMA2_Stream1_IRQn, DMA2_Stream1_IRQHandler)                                                                     \
+    X(DMA2_Stream2_IRQn, DMA2_Stream2_IRQHandler)                                                                     \
+    X(DMA2_Stream3_IRQn, DMA2_Stream3_IRQHandler)                                                                     \
+    X(DMA2_Stream4_IRQn, DMA2_Stream4_IRQHandler)                                                                     \
+    X(CAN2_TX_IRQn, CAN2_TX_IRQHandler)                                                                               \
+    X(CAN2_RX0_IRQn, CAN2_RX0_IRQHandler)                                                                             \
+    X(DMA2_Stream5_IRQn, DMA2_Stream5_IRQHandler)                                                                     \
+    X(DMA2_Stream6_IRQn, DMA2_Stream6_IRQHandler)                                                                     \
+    X(DMA2_Stream7_IRQn, DMA2_Stream7_IRQHandler)                                                                     \
+    X(I2C3_EV_IRQn, I2C3_EV_IRQHandler)                                                                               \
+    X(I2C3_ER_IRQn, I2C3_ER_IRQHandler)                                                                               \
+    X(FPU_IRQn, FPU_IRQHandler)
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Store to the registers recorded by a callback, applied at the next callback.
+ */
+typedef struct
+{
+    volatile uint32_t *p_word;                      /*!< First word touched by the store */
+    uint32_t num;                                   /*!< Number of words touched. 0 if there is no store pending */
+    uint32_t old[STM32F4_MODEL_MAX_STORE_WORDS];    /*!< Value of the words before the store */
+} stm32f4_model_store_t;
+
+/* Global variables */
+stm32f4_model_regs_t stm32f4_model_regs;    /*!< Registers of the model */
+uint8_t stm32f4_model_bkpsram[4096];        /*!< Backup SRAM of the model. It keeps its content across resets */
+
+/* Handlers of the firmware and its startup function */
+#define STM32F4_MODEL_DECLARE_HANDLER(irqn, handler) extern void handler(void) __attribute__((weak));
+STM32F4_MODEL_HANDLERS(STM32F4_MODEL_DECLARE_HANDLER)
+extern void SysTick_Handler(void) __attribute__((weak));
+#pragma weak SystemInit
+
+static uint64_t now;                                        /*!< Virtual time in CPU cycles */
+static uint64_t next_event = STM32F4_MODEL_NEVER;           /*!< Time of the next event of any peripheral */
+static uint32_t cycles_per_access = STM32F4_MODEL_CYCLES_PER_ACCESS; /*!< Cycles of an instrumented access */
+static uint32_t model_depth;                                /*!< The model is running: the accesses of callbacks are not counted */
+static stm32f4_model_store_t pending_store;                 /*!< Store to the registers not applied yet */
+
+static bool irq_dirty;                                      /*!< An interrupt may have to be taken */
+static uint32_t primask;                                    /*!< PRIMASK of the core */
+static uint32_t prigroup;                                   /*!< Priority grouping of the AIRCR */
+static uint32_t nvic_enabled[4];                            /*!< Enabled interrupts */
+static uint32_t nvic_pending[4];                            /*!< Pending interrupts */
+static uint32_t nvic_active[4];                             /*!< Active interrupts */
+static bool systick_pending;                                /*!< The SysTick exception is pending */
+static bool systick_active;                                 /*!< The SysTick exception is active */
+static uint32_t active_prio[STM32F4_MODEL_NUM_EXCEPTIONS];  /*!< Group priority of the nested active exceptions */
+static uint32_t active_depth;                               /*!< Number of nested active exceptions */
+static uint64_t taken;                                      /*!< Number of exceptions taken */
+static uint32_t irq_counts[STM32F4_MODEL_NUM_EXCEPTIONS];   /*!< Number of entries of each exception */
+
+static uint64_t systick_next = STM32F4_MODEL_NEVER;         /*!< Time when the SysTick counter reaches 0 */
+static uint32_t systick_val;                                /*!< Value of the SysTick counter while it is stopped */
+static bool systick_countflag;                              /*!< COUNTFLAG of the SysTick */
+
+static uint32_t dwt_base;                                   /*!< Cycle counter at `dwt_time` */
+static uint64_t dwt_time;                                   /*!< Time of the last write or enable of the cycle counter */
+
+/* Private functions -----------------------------------------------------------*/
+static void _run_until(uint64_t limit);
+
+/**
+ * @brief Handler of an exception. NULL if the firmware does not define it.
+ */
+static void (*_handler(uint32_t exc))(void)
+{
+    if (exc == STM32F4_MODEL_SYSTICK_EXC)
+    {
+        return SysTick_Handler;
+    }
+    switch ((int32_t)exc - 16)
+    {
+#define STM32F4_MODEL_CASE_HANDLER(irqn, handler) \
+    case irqn:                                    \
+        return handler;
+        STM32F4_MODEL_HANDLERS(STM32F4_MODEL_CASE_HANDLER)
+    default:
+        return NULL;
+    }
+}
+
+/**
+ * @brief Interrupt lines asserted by the peripherals: `SR & DIER` of TIM2-5 and `PR & IMR` of the EXTI.
+ */
+static void _irq_lines(uint32_t lines[4])
+{
+    static const struct
+    {
+        TIM_TypeDef *p_tim;
+        IRQn_Type irqn;
+    } tims[] = {{TIM2, TIM2_IRQn}, {TIM3, TIM3_IRQn}, {TIM4, TIM4_IRQn}, {TIM5, TIM5_IRQn}};
+    static const struct
+    {
+        uint32_t mask;
+        IRQn_Type irqn;
+    } extis[] = {{0x0001U, EXTI0_IRQn}, {0x0002U, EXTI1_IRQn}, {0x0004U, EXTI2_IRQn}, {0x0008U, EXTI3_IRQn}, {0x0010U, EXTI4_IRQn}, {0x03E0U, EXTI9_5_IRQn}, {0xFC00U, EXTI15_10_IRQn}};
+
+    memset(lines, 0, 4 * sizeof(uint32_t));
+    for (uint32_t i = 0; i < sizeof(tims) / sizeof(tims[0]); i++)
+    {
+        if (tims[i].p_tim->SR & tims[i].p_tim->DIER & 0x5FU)
+        {
+            lines[tims[i].irqn >> 5] |= 1U << (tims[i].irqn & 0x1FU);
+        }
+    }
+    uint32_t exti = EXTI->PR & EXTI->IMR;
+    for (uint32_t i = 0; i < sizeof(extis) / sizeof(extis[0]); i++)
+    {
+        if (exti & extis[i].mask)
+        {
+            lines[extis[i].irqn >> 5] |= 1U << (extis[i].irqn & 0x1FU);
+        }
+    }
+}
+
+/**
+ * @brief Latch the asserted lines of the inactive interrupts as pending, as the NVIC does.
+ */
+static void _irq_latch(void)
+{
+    uint32_t lines[4];
+    _irq_lines(lines);
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        nvic_pending[i] |= lines[i] & ~nvic_active[i];
+    }
+}
+
+/**
+ * @brief Priority byte of an exception (only the 4 implemented bits).
+ */
+static uint32_t _priority(uint32_t exc)
+{
+    if (exc == STM32F4_MODEL_SYSTICK_EXC)
+    {
+        return SCB->SHP[11] & 0xF0U;
+    }
+    return NVIC->IP[exc - 16U] & 0xF0U;
+}
+
+/**
+ * @brief Group (preemption) priority of a priority byte with the current grouping.
+ */
+static uint32_t _group(uint32_t priority)
+{
+    return priority >> (prigroup + 1U);
+}
+
+/**
+ * @brief Select the pending exception to take: the lowest group priority, then the lowest priority, then the lowest number.
+ *
+ * @param ignore_primask Select it even if PRIMASK is set (wake-up of `__WFI()`).
+ * @return int32_t Exception number, or -1 if none can preempt the current execution priority.
+ */
+static int32_t _select(bool ignore_primask)
+{
+    _irq_latch();
+    if (primask && !ignore_primask)
+    {
+        return -1;
+    }
+    uint32_t current = (active_depth > 0) ? active_prio[active_depth - 1] : STM32F4_MODEL_THREAD_PRIO;
+    int32_t best = -1;
+    uint32_t best_prio = 0;
+    if (systick_pending)
+    {
+        best = STM32F4_MODEL_SYSTICK_EXC;
+        best_prio = _priority(STM32F4_MODEL_SYSTICK_EXC);
+    }
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        uint32_t candidates = nvic_pending[i] & nvic_enabled[i];
+        while (candidates)
+        {
+            uint32_t bit = (uint32_t)__builtin_ctz(candidates);
+            candidates &= candidates - 1U;
+            uint32_t exc = 16U + i * 32U + bit;
+            uint32_t prio = _priority(exc);
+            if ((best < 0) || (prio < best_prio))
+            {
+                best = (int32_t)exc;
+                best_prio = prio;
+            }
+        }
+    }
+    if ((best < 0) || (_group(best_prio) >= current))
+    {
+        return -1;
+    }
+    return best;
+}
+
+/**
+ * @brief Apply the store recorded by the previous callback, now that it has been made.
+ */
+static void _commit(void)
+{
+    if (pending_store.num == 0)
+    {
+        return;
+    }
+    uint32_t num = pending_store.num;
+    pending_store.num = 0;
+    model_depth++;
+    for (uint32_t i = 0; i < num; i++)
+    {
+        volatile uint32_t *p_reg = pending_store.p_word + i;
+        uint32_t old = pending_store.old[i];
+        uint32_t written = *p_reg;
+
+        if (STM32F4_MODEL_IN(p_reg, stm32f4_model_regs.tim2) || STM32F4_MODEL_IN(p_reg, stm32f4_model_regs.tim3) ||
+            STM32F4_MODEL_IN(p_reg, stm32f4_model_regs.tim4) || STM32F4_MODEL_IN(p_reg, stm32f4_model_regs.tim5))
+        {
+            stm32f4_model_tim_write(p_reg, old, written);
+        }
+        else if (STM32F4_MODEL_IN(p_reg, stm32f4_model_regs.gpio) || STM32F4_MODEL_IN(p_reg, stm32f4_model_regs.exti))
+        {
+            stm32f4_model_gpio_write(p_reg, old, written);
+        }
+        else if (p_reg == &RCC->CR)
+        {
+            // The oscillators are ready as soon as they are on: HSI, HSE and PLL
+            *p_reg = (written & ~0x02020002U) | ((written & 0x01U) << 1) | ((written & 0x00010000U) << 1) | ((written & 0x01000000U) << 1);
+        }
+        else if (p_reg == &RCC->CFGR)
+        {
+            *p_reg = (written & ~0x0CU) | ((written & 0x03U) << 2); // The clock switch is immediate
+        }
+        else if (p_reg == &RCC->APB1ENR)
+        {
+            stm32f4_model_tim_clock_changed();
+        }
+        else if (p_reg == &PWR->CR)
+        {
+            if (written & PWR_CR_CWUF)
+            {
+                PWR->CSR &= ~PWR_CSR_WUF;
+            }
+            if (written & PWR_CR_CSBF)
+            {
+                PWR->CSR &= ~PWR_CSR_SBF;
+            }
+            *p_reg = written & ~(PWR_CR_CWUF | PWR_CR_CSBF);
+        }
+        else if (p_reg == &PWR->CSR)
+        {
+            uint32_t writable = PWR_CSR_BRE | (0x1U << 8); // BRE and EWUP
+            uint32_t csr = (old & ~(writable | PWR_CSR_BRR)) | (written & writable);
+            *p_reg = csr | ((csr & PWR_CSR_BRE) ? PWR_CSR_BRR : 0U); // The backup regulator is ready at once
+        }
+        else if (p_reg == &CRC->DR)
+        {
+            uint32_t crc = old ^ written;
+            for (uint32_t bit = 0; bit < 32; bit++)
+            {
+                crc = (crc & 0x80000000U) ? ((crc << 1) ^ 0x04C11DB7U) : (crc << 1);
+            }
+            *p_reg = crc;
+        }
+        else if (p_reg == &CRC->CR)
+        {
+            if (written & CRC_CR_RESET)
+            {
+                CRC->DR = 0xFFFFFFFFU;
+            }
+            *p_reg = 0;
+        }
+        else if (p_reg == &SCB->ICSR)
+        {
+            if (written & SCB_ICSR_PENDSTSET_Msk)
+            {
+                systick_pending = true;
+            }
+            else if (written & SCB_ICSR_PENDSTCLR_Msk)
+            {
+                systick_pending = false;
+            }
+            *p_reg = systick_pending ? SCB_ICSR_PENDSTSET_Msk : 0U;
+        }
+        else if (p_reg == &SCB->AIRCR)
+        {
+            if ((written >> SCB_AIRCR_VECTKEY_Pos) == 0x05FAU)
+            {
+                prigroup = (written & SCB_AIRCR_PRIGROUP_Msk) >> SCB_AIRCR_PRIGROUP_Pos;
+            }
+            *p_reg = (0xFA05UL << SCB_AIRCR_VECTKEY_Pos) | (prigroup << SCB_AIRCR_PRIGROUP_Pos);
+        }
+        else if (p_reg == &SysTick->CTRL)
+        {
+            bool was_enabled = old & SysTick_CTRL_ENABLE_Msk;
+            bool enabled = written & SysTick_CTRL_ENABLE_Msk;
+            *p_reg = (written & ~SysTick_CTRL_COUNTFLAG_Msk) | (systick_countflag ? SysTick_CTRL_COUNTFLAG_Msk : 0U);
+            if (!was_enabled && enabled)
+            {
+                uint64_t div = (written & SysTick_CTRL_CLKSOURCE_Msk) ? 1U : 8U;
+                uint32_t load = SysTick->LOAD & SysTick_LOAD_RELOAD_Msk;
+                uint64_t ticks = (systick_val != 0) ? systick_val : ((load != 0) ? (uint64_t)load + 1U : 0U);
+                systick_next = (ticks != 0) ? now + ticks * div : STM32F4_MODEL_NEVER;
+            }
+            else if (was_enabled && !enabled)
+            {
+                uint64_t div = (old & SysTick_CTRL_CLKSOURCE_Msk) ? 1U : 8U;
+                uint32_t period = (SysTick->LOAD & SysTick_LOAD_RELOAD_Msk) + 1U;
+                systick_val = (systick_next == STM32F4_MODEL_NEVER) ? 0U : (uint32_t)(((systick_next - now) / div) % period);
+                systick_next = STM32F4_MODEL_NEVER;
+            }
+        }
+        else if (p_reg == &SysTick->VAL)
+        {
+            // Any write clears the counter and COUNTFLAG. The counter reloads at the next tick
+            *p_reg = 0;
+            systick_val = 0;
+            systick_countflag = false;
+            if (SysTick->CTRL & SysTick_CTRL_ENABLE_Msk)
+            {
+                uint64_t div = (SysTick->CTRL & SysTick_CTRL_CLKSOURCE_Msk) ? 1U : 8U;
+                uint32_t load = SysTick->LOAD & SysTick_LOAD_RELOAD_Msk;
+                systick_next = (load != 0) ? now + ((uint64_t)load + 1U) * div : STM32F4_MODEL_NEVER;
+            }
+        }
+        else if (STM32F4_MODEL_IN(p_reg, NVIC->ISER) || STM32F4_MODEL_IN(p_reg, NVIC->ICER))
+        {
+            uint32_t n = (uint32_t)(STM32F4_MODEL_IN(p_reg, NVIC->ISER) ? (p_reg - NVIC->ISER) : (p_reg - NVIC->ICER));
+            if (n < 4)
+            {
+                nvic_enabled[n] = STM32F4_MODEL_IN(p_reg, NVIC->ISER) ? (nvic_enabled[n] | written) : (nvic_enabled[n] & ~written);
+            }
+            NVIC->ISER[n] = (n < 4) ? nvic_enabled[n] : 0U;
+            NVIC->ICER[n] = NVIC->ISER[n];
+        }
+        else if (STM32F4_MODEL_IN(p_reg, NVIC->ISPR) || STM32F4_MODEL_IN(p_reg, NVIC->ICPR))
+        {
+            uint32_t n = (uint32_t)(STM32F4_MODEL_IN(p_reg, NVIC->ISPR) ? (p_reg - NVIC->ISPR) : (p_reg - NVIC->ICPR));
+            if (n < 4)
+            {
+                nvic_pending[n] = STM32F4_MODEL_IN(p_reg, NVIC->ISPR) ? (nvic_pending[n] | written) : (nvic_pending[n] & ~written);
+            }
+            NVIC->ISPR[n] = (n < 4) ? nvic_pending[n] : 0U;
+            NVIC->ICPR[n] = NVIC->ISPR[n];
+        }
+        else if (STM32F4_MODEL_IN(p_reg, NVIC->IABR))
+        {
+            *p_reg = old; // Read-only
+        }
+        else if (p_reg == &NVIC->STIR)
+        {
+            uint32_t irq = written & 0x1FFU;
+            if (irq < STM32F4_MODEL_NUM_IRQS)
+            {
+                nvic_pending[irq >> 5] |= 1U << (irq & 0x1FU);
+            }
+            *p_reg = 0;
+        }
+        else if (p_reg == &DWT->CTRL)
+        {
+            if ((old ^ written) & DWT_CTRL_CYCCNTENA_Msk)
+            {
+                if (written & DWT_CTRL_CYCCNTENA_Msk)
+                {
+                    dwt_time = now;
+                }
+                else
+                {
+                    dwt_base += (uint32_t)(now - dwt_time);
+                }
+            }
+        }
+        else if (p_reg == &DWT->CYCCNT)
+        {
+            dwt_base = written;
+            dwt_time = now;
+        }
+        // Any other register is plain memory
+    }
+    model_depth--;
+    stm32f4_model_events_changed();
+    irq_dirty = true;
+}
+
+/**
+ * @brief Refresh a register whose value depends on time or on the state of the model, before it is read.
+ */
+static void _refresh(volatile uint32_t *p_reg)
+{
+    if (STM32F4_MODEL_IN(p_reg, stm32f4_model_regs.tim2) || STM32F4_MODEL_IN(p_reg, stm32f4_model_regs.tim3) ||
+        STM32F4_MODEL_IN(p_reg, stm32f4_model_regs.tim4) || STM32F4_MODEL_IN(p_reg, stm32f4_model_regs.tim5))
+    {
+        stm32f4_model_tim_read(p_reg);
+    }
+    else if (p_reg == &SysTick->CTRL)
+    {
+        *p_reg = (*p_reg & ~SysTick_CTRL_COUNTFLAG_Msk) | (systick_countflag ? SysTick_CTRL_COUNTFLAG_Msk : 0U);
+        systick_countflag = false; // COUNTFLAG is cleared by the read
+    }
+    else if (p_reg == &SysTick->VAL)
+    {
+        if (systick_next == STM32F4_MODEL_NEVER)
+        {
+            *p_reg = systick_val;
+        }
+        else
+        {
+            uint64_t div = (SysTick->CTRL & SysTick_CTRL_CLKSOURCE_Msk) ? 1U : 8U;
+            uint32_t period = (SysTick->LOAD & SysTick_LOAD_RELOAD_Msk) + 1U;
+            *p_reg = (uint32_t)(((systick_next - now) / div) % period);
+        }
+    }
+    else if (STM32F4_MODEL_IN(p_reg, NVIC->ISPR) || STM32F4_MODEL_IN(p_reg, NVIC->ICPR))
+    {
+        _irq_latch();
+        uint32_t n = (uint32_t)(STM32F4_MODEL_IN(p_reg, NVIC->ISPR) ? (p_reg - NVIC->ISPR) : (p_reg - NVIC->ICPR));
+        *p_reg = (n < 4) ? nvic_pending[n] : 0U;
+    }
+    else if (STM32F4_MODEL_IN(p_reg, NVIC->IABR))
+    {
+        uint32_t n = (uint32_t)(p_reg - NVIC->IABR);
+        *p_reg = (n < 4) ? nvic_active[n] : 0U;
+    }
+    else if (p_reg == &SCB->ICSR)
+    {
+        *p_reg = systick_pending ? SCB_ICSR_PENDSTSET_Msk : 0U;
+    }
+    else if (p_reg == &DWT->CYCCNT)
+    {
+        *p_reg = (DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) ? dwt_base + (uint32_t)(now - dwt_time) : dwt_base;
+    }
+}
+
+/**
+ * @brief Take an exception: run its handler, nested, with the entry and exit times of the core.
+ */
+static void _take(uint32_t exc)
+{
+    void (*handler)(void) = _handler(exc);
+    if (handler == NULL)
+    {
+        char msg[80];
+        snprintf(msg, sizeof(msg), "no handler for the exception %u (IRQn %d)", exc, (int)exc - 16);
+        stm32f4_model_fatal(msg);
+    }
+    if (exc == STM32F4_MODEL_SYSTICK_EXC)
+    {
+        systick_pending = false;
+        systick_active = true;
+    }
+    else
+    {
+        nvic_pending[(exc - 16U) >> 5] &= ~(1U << ((exc - 16U) & 0x1FU));
+        nvic_active[(exc - 16U) >> 5] |= 1U << ((exc - 16U) & 0x1FU);
+    }
+    active_prio[active_depth++] = _group(_priority(exc));
+    irq_counts[exc]++;
+    taken++;
+
+    _run_until(now + STM32F4_MODEL_EXCEPTION_CYCLES); // Stacking: only a higher priority can arrive late
+    handler();
+    _commit();
+    _run_until(now + STM32F4_MODEL_EXCEPTION_CYCLES); // Unstacking
+
+    active_depth--;
+    if (exc == STM32F4_MODEL_SYSTICK_EXC)
+    {
+        systick_active = false;
+    }
+    else
+    {
+        nvic_active[(exc - 16U) >> 5] &= ~(1U << ((exc - 16U) & 0x1FU));
+    }
+    irq_dirty = true; // Tail-chain the pending exceptions, or pend again a line still asserted
+}
+
+/**
+ * @brief Take the pending exceptions that can preempt the current execution priority.
+ */
+static void _dispatch(void)
+{
+    while (irq_dirty && (model_depth == 0))
+    {
+        int32_t exc = _select(false);
+        if (exc < 0)
+        {
+            irq_dirty = false;
+            return;
+        }
+        _take((uint32_t)exc);
+    }
+}
+
+/**
+ * @brief Run the SysTick counter when it reaches 0 at a time.
+ */
+static void _systick_run(uint64_t t)
+{
+    uint64_t div = (SysTick->CTRL & SysTick_CTRL_CLKSOURCE_Msk) ? 1U : 8U;
+    uint32_t load = SysTick->LOAD & SysTick_LOAD_RELOAD_Msk;
+    systick_countflag = true;
+    if (SysTick->CTRL & SysTick_CTRL_TICKINT_Msk)
+    {
+        systick_pending = true;
+        irq_dirty = true;
+    }
+    systick_next = (load != 0) ? t + ((uint64_t)load + 1U) * div : STM32F4_MODEL_NEVER;
+}
+
+/**
+ * @brief Advance the virtual clock up to a time, running the events in chronological order and taking the interrupts.
+ */
+static void _run_until(uint64_t limit)
+{
+    while (next_event <= limit)
+    {
+        uint64_t t = next_event;
+        if (now < t)
+        {
+            now = t;
+        }
+        model_depth++;
+        if (systick_next <= t)
+        {
+            _systick_run(t);
+        }
+        if (stm32f4_model_tim_next_event() <= t)
+        {
+            stm32f4_model_tim_run(t);
+        }
+        if (stm32f4_model_gpio_next_event() <= t)
+        {
+            stm32f4_model_gpio_run(t);
+        }
+        model_depth--;
+        stm32f4_model_events_changed();
+        _dispatch();
+    }
+    if (now < limit)
+    {
+        now = limit;
+    }
+    _dispatch();
+}
+
+/**
+ * @brief Callback of an instrumented access of the firmware, made before the access.
+ */
+static void _access(uintptr_t addr, size_t size, bool store)
+{
+    if (model_depth > 0)
+    {
+        return;
+    }
+    _commit();
+    _run_until(now + cycles_per_access);
+
+    uintptr_t offset = addr - (uintptr_t)&stm32f4_model_regs;
+    if ((offset >= sizeof(stm32f4_model_regs)) || (size == 0))
+    {
+        return;
+    }
+    volatile uint32_t *p_first = (volatile uint32_t *)(addr & ~(uintptr_t)3U);
+    volatile uint32_t *p_last = (volatile uint32_t *)((addr + size - 1U) & ~(uintptr_t)3U);
+    if (p_last >= (volatile uint32_t *)(&stm32f4_model_regs + 1))
+    {
+        p_last = (volatile uint32_t *)(&stm32f4_model_regs + 1) - 1;
+    }
+    uint32_t num = (uint32_t)(p_last - p_first) + 1U;
+    if (store)
+    {
+        pending_store.p_word = p_first;
+        pending_store.num = (num > STM32F4_MODEL_MAX_STORE_WORDS) ? STM32F4_MODEL_MAX_STORE_WORDS : num;
+        for (uint32_t i = 0; i < pending_store.num; i++)
+        {
+            pending_store.old[i] = p_first[i];
+        }
+    }
+    else
+    {
+        model_depth++;
+        for (uint32_t i = 0; i < num; i++)
+        {
+            _refresh(p_first + i);
+        }
+        model_depth--;
+    }
+}
+
+/**
+ * @brief Reset the model and run `SystemInit()` of the firmware before `main()`, as the startup code of the target.
+ */
+__attribute__((constructor)) static void _startup(void)
+{
+    stm32f4_model_reset();
+    if (SystemInit != NULL)
+    {
+        SystemInit();
+    }
+}
+
+/* Memory-access callbacks of the instrumented code ------------------------------*/
+/* The thread sanitizer of GCC calls these functions before every load and store to memory that may be shared (globals, pointers;
+ * not the locals that do not escape), and at the entry and the exit of the functions. The model implements them instead of the
+ * runtime of the sanitizer. */
+#define STM32F4_MODEL_PROTOTYPES(size)                          \
+    void __tsan_read##size(void *p_addr);                       \
+    void __tsan_write##size(void *p_addr);                      \
+    void __tsan_unaligned_read##size(void *p_addr);             \
+    void __tsan_unaligned_write##size(void *p_addr);
+#define STM32F4_MODEL_CALLBACKS(size)                                                                   \
+    void __tsan_read##size(void *p_addr) { _access((uintptr_t)p_addr, size, false); }                   \
+    void __tsan_write##size(void *p_addr) { _access((uintptr_t)p_addr, size, true); }                   \
+    void __tsan_unaligned_read##size(void *p_addr) { _access((uintptr_t)p_addr, size, false); }         \
+    void __tsan_unaligned_write##size(void *p_addr) { _access((uintptr_t)p_addr, size, true); }
+
+void __tsan_init(void);
+void __tsan_func_entry(void *p_caller);
+void __tsan_func_exit(void);
+void __tsan_read_range(void *p_addr, unsigned long size);
+void __tsan_write_range(void *p_addr, unsigned long size);
+void __tsan_atomic_signal_fence(int order);
+void __tsan_atomic_thread_fence(int order);
+uint32_t __tsan_atomic32_load(const volatile uint32_t *p_addr, int order);
+void __tsan_atomic32_store(volatile uint32_t *p_addr, uint32_t value, int order);
+uint32_t __tsan_atomic32_fetch_or(volatile uint32_t *p_addr, uint32_t value, int order);
+uint32_t __tsan_atomic32_fetch_and(volatile uint32_t *p_addr, uint32_t value, int order);
+STM32F4_MODEL_PROTOTYPES(1)
+STM32F4_MODEL_PROTOTYPES(2)
+STM32F4_MODEL_PROTOTYPES(4)
+STM32F4_MODEL_PROTOTYPES(8)
+STM32F4_MODEL_PROTOTYPES(16)
+
+STM32F4_MODEL_CALLBACKS(1)
+STM32F4_MODEL_CALLBACKS(2)
+STM32F4_MODEL_CALLBACKS(4)
+STM32F4_MODEL_CALLBACKS(8)
+STM32F4_MODEL_CALLBACKS(16)
+
+void __tsan_init(void) {}
+void __tsan_func_entry(void *p_caller) { _access(0, 0, false); } /* The call and the push of the return address */
+void __tsan_func_exit(void) {}
+void __tsan_read_range(void *p_addr, unsigned long size) { _access((uintptr_t)p_addr, size, false); }
+void __tsan_write_range(void *p_addr, unsigned long size) { _access((uintptr_t)p_addr, size, true); }
+void __tsan_atomic_signal_fence(int order) {}
+void __tsan_atomic_thread_fence(int order) {}
+
+/* The atomics of the firmware (exclusive load and store on the target) are an access that reads and writes */
+uint32_t __tsan_atomic32_load(const volatile uint32_t *p_addr, int order)
+{
+    _access((uintptr_t)p_addr, 4, false);
+    return *p_addr;
+}
+
+void __tsan_atomic32_store(volatile uint32_t *p_addr, uint32_t value, int order)
+{
+    _access((uintptr_t)p_addr, 4, true);
+    *p_addr = value;
+}
+
+uint32_t __tsan_atomic32_fetch_or(volatile uint32_t *p_addr, uint32_t value, int order)
+{
+    _access((uintptr_t)p_addr, 4, false);
+    uint32_t old = *p_addr;
+    _access((uintptr_t)p_addr, 4, true);
+    *p_addr = old | value;
+    return old;
+}
+
+uint32_t __tsan_atomic32_fetch_and(volatile uint32_t *p_addr, uint32_t value, int order)
+{
+    _access((uintptr_t)p_addr, 4, false);
+    uint32_t old = *p_addr;
+    _access((uintptr_t)p_addr, 4, true);
+    *p_addr = old & value;
+    return old;
+}
+
+/* Intrinsics of the core ---------------------------------------------------------*/
+void stm32f4_model_wfi(void)
+{
+    _commit();
+    uint64_t start = now;
+    uint64_t taken_before = taken;
+    uint64_t timeout = (uint64_t)STM32F4_MODEL_WFI_TIMEOUT_S * STM32F4_MODEL_CLOCK_HZ;
+    for (;;)
+    {
+        irq_dirty = true;
+        _dispatch();
+        if ((taken != taken_before) || (_select(true) >= 0))
+        {
+            return; // An interrupt has been taken, or it would be but PRIMASK is set
+        }
+        if (next_event == STM32F4_MODEL_NEVER)
+        {
+            stm32f4_model_fatal("__WFI() without any running timer nor scheduled pin edge: the core would sleep forever");
+        }
+        if (next_event - start > timeout)
+        {
+            stm32f4_model_fatal("__WFI() has not been woken up by any interrupt");
+        }
+        _run_until(next_event);
+    }
+}
+
+void stm32f4_model_set_primask(uint32_t value)
+{
+    _commit();
+    primask = value & 0x1U;
+    irq_dirty = true;
+    _dispatch();
+}
+
+uint32_t stm32f4_model_get_primask(void)
+{
+    return primask;
+}
+
+/* Interface with the peripherals --------------------------------------------------*/
+void stm32f4_model_commit(void)
+{
+    _commit();
+}
+
+uint64_t stm32f4_model_now(void)
+{
+    return now;
+}
+
+void stm32f4_model_events_changed(void)
+{
+    uint64_t t = systick_next;
+    uint64_t tim = stm32f4_model_tim_next_event();
+    uint64_t gpio = stm32f4_model_gpio_next_event();
+    t = (tim < t) ? tim : t;
+    next_event = (gpio < t) ? gpio : t;
+}
+
+void stm32f4_model_irq_changed(void)
+{
+    irq_dirty = true;
+}
+
+void stm32f4_model_fatal(const char *p_msg)
+{
+    fflush(stdout);
+    fprintf(stderr, "stm32f4_model: %s (at %llu us)\n", p_msg, (unsigned long long)(now / (STM32F4_MODEL_CLOCK_HZ / 1000000U)));
+    abort();
+}
+
+/* Public functions -----------------------------------------------------------*/
+void stm32f4_model_reset(void)
+{
+    memset(&stm32f4_model_regs, 0, sizeof(stm32f4_model_regs));
+    now = 0;
+    model_depth = 0;
+    pending_store.num = 0;
+    irq_dirty = false;
+    primask = 0;
+    prigroup = 0;
+    memset(nvic_enabled, 0, sizeof(nvic_enabled));
+    memset(nvic_pending, 0, sizeof(nvic_pending));
+    memset(nvic_active, 0, sizeof(nvic_active));
+    systick_pending = false;
+    systick_active = false;
+    active_depth = 0;
+    taken = 0;
+    memset(irq_counts, 0, sizeof(irq_counts));
+    systick_next = STM32F4_MODEL_NEVER;
+    systick_val = 0;
+    systick_countflag = false;
+    dwt_base = 0;
+    dwt_time = 0;
+
+    /* Reset values of the registers that are not 0 */
+    RCC->CR = 0x00000083U;
+    RCC->AHB1ENR = 0x00100000U;
+    RCC->CSR = 0x0E000000U;
+    GPIOA->MODER = 0xA8000000U; // Debug pins
+    GPIOA->PUPDR = 0x64000000U;
+    GPIOA->OSPEEDR = 0x0C000000U;
+    GPIOB->MODER = 0x00000280U;
+    GPIOB->PUPDR = 0x00000100U;
+    GPIOB->OSPEEDR = 0x000000C0U;
+    CRC->DR = 0xFFFFFFFFU;
+    CAN1->MCR = 0x00010002U;
+    CAN1->MSR = 0x00000C02U;
+    CAN1->TSR = 0x1C000000U;
+    CAN1->BTR = 0x01230000U;
+    SCB->AIRCR = 0xFA050000U;
+    SCB->CCR = 0x00000200U;
+    *(volatile uint32_t *)&SCB->CPUID = 0x410FC241U;
+    DWT->CTRL = 0x40000000U;
+
+    stm32f4_model_tim_reset();
+    stm32f4_model_gpio_reset();
+    stm32f4_model_events_changed();
+}
+
+void stm32f4_model_set_cycles_per_access(uint32_t cycles)
+{
+    cycles_per_access = (cycles > 0) ? cycles : 1U;
+}
+
+uint64_t stm32f4_model_get_cycles(void)
+{
+    return now;
+}
+
+uint64_t stm32f4_model_get_us(void)
+{
+    return now / (STM32F4_MODEL_CLOCK_HZ / 1000000U);
+}
+
+void stm32f4_model_advance_cycles(uint64_t cycles)
+{
+    _commit();
+    _run_until(now + cycles);
+}
+
+void stm32f4_model_advance_us(uint32_t us)
+{
+    stm32f4_model_advance_cycles((uint64_t)us * (STM32F4_MODEL_CLOCK_HZ / 1000000U));
+}
+
+uint32_t stm32f4_model_get_irq_count(IRQn_Type irqn)
+{
+    int32_t exc = 16 + (int32_t)irqn;
+    if ((exc < 0) || (exc >= (int32_t)STM32F4_MODEL_NUM_EXCEPTIONS))
+    {
+        return 0;
+    }
+    return irq_counts[exc];
+}
@@ -0,0 +1,346 @@
+/**
+ * @file stm32f4_model_gpio.c
+ * @brief GPIOA-C, EXTI and scheduled pin edges of the host register model of the STM32F4.
+ *
+ * The level of each pin is computed from its mode: the output register, the output of the timer channel of its alternate
+ * function, or the external drive set by the test (and else its pull resistor). When a level changes, the edge is propagated to
+ * `IDR`, to the EXTI line of the pin (if `SYSCFG->EXTICR` selects its port), to the input of the timer channel of its alternate
+ * function and to the callback of the test.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stddef.h>
+
+/* Project includes */
+#include "stm32f4_model_priv.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define STM32F4_MODEL_GPIO_MODE_OUT 1U  /*!< General purpose output mode */
+#define STM32F4_MODEL_GPIO_MODE_AF 2U   /*!< Alternate function mode */
+#define STM32F4_MODEL_GPIO_MODE_AN 3U   /*!< Analog mode */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief Connection of a pin to a channel of a timer through an alternate function.
+ */
+typedef struct
+{
+    uint8_t port;   /*!< Port index: 0 for GPIOA to 2 for GPIOC */
+    uint8_t pin;    /*!< Pin number */
+    uint8_t af;     /*!< Alternate function */
+    uint8_t tim;    /*!< Timer index: 0 for TIM2 to 3 for TIM5 */
+    uint8_t ch;     /*!< Channel index: 0 for CH1 to 3 for CH4 */
+} stm32f4_model_af_t;
+
+/**
+ * @brief Scheduled external drive of a pin.
+ */
+typedef struct
+{
+    uint64_t t;         /*!< Time of the edge */
+    uint8_t port;       /*!< Port index */
+    uint8_t pin;        /*!< Pin number */
+    bool level;         /*!< Level driven */
+} stm32f4_model_pin_event_t;
+
+/* Global variables */
+static const stm32f4_model_af_t af_table[] = {
+    /* TIM2 (AF1) */
+    {0, 0, 1, 0, 0}, {0, 5, 1, 0, 0}, {0, 15, 1, 0, 0}, {0, 1, 1, 0, 1}, {1, 3, 1, 0, 1}, {0, 2, 1, 0, 2}, {1, 10, 1, 0, 2}, {0, 3, 1, 0, 3}, {1, 11, 1, 0, 3},
+    /* TIM3 (AF2) */
+    {0, 6, 2, 1, 0}, {1, 4, 2, 1, 0}, {2, 6, 2, 1, 0}, {0, 7, 2, 1, 1}, {1, 5, 2, 1, 1}, {2, 7, 2, 1, 1}, {1, 0, 2, 1, 2}, {2, 8, 2, 1, 2}, {1, 1, 2, 1, 3}, {2, 9, 2, 1, 3},
+    /* TIM4 (AF2) */
+    {1, 6, 2, 2, 0}, {1, 7, 2, 2, 1}, {1, 8, 2, 2, 2}, {1, 9, 2, 2, 3},
+    /* TIM5 (AF2) */
+    {0, 0, 2, 3, 0}, {0, 1, 2, 3, 1}, {0, 2, 2, 3, 2}, {0, 3, 2, 3, 3},
+}; /*!< Timer channels of the alternate functions of the pins */
+
+static GPIO_TypeDef *const ports[STM32F4_MODEL_NUM_GPIOS] = {GPIOA, GPIOB, GPIOC}; /*!< Modelled ports */
+static uint16_t drive_mask[STM32F4_MODEL_NUM_GPIOS];                              /*!< Pins driven from outside */
+static uint16_t drive_level[STM32F4_MODEL_NUM_GPIOS];                             /*!< Levels driven from outside */
+static uint16_t levels[STM32F4_MODEL_NUM_GPIOS];                                  /*!< Level of the pins */
+static stm32f4_model_pin_event_t events[STM32F4_MODEL_PIN_EVENTS];                /*!< Scheduled edges, sorted by time */
+static uint32_t num_events;                                                       /*!< Number of scheduled edges */
+static stm32f4_model_pin_cb_t pin_cb;                                             /*!< Function called on every change of a pin */
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Index of a port, or -1 if the port is not modelled.
+ */
+static int32_t _port_index(const GPIO_TypeDef *p_port)
+{
+    for (uint32_t i = 0; i < STM32F4_MODEL_NUM_GPIOS; i++)
+    {
+        if (p_port == ports[i])
+        {
+            return (int32_t)i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Timer channel selected by the alternate function of a pin, or NULL.
+ */
+static const stm32f4_model_af_t *_af_channel(uint32_t port, uint32_t pin)
+{
+    const GPIO_TypeDef *p_port = ports[port];
+    if (((p_port->MODER >> (2U * pin)) & 0x3U) != STM32F4_MODEL_GPIO_MODE_AF)
+    {
+        return NULL;
+    }
+    uint32_t af = (p_port->AFR[pin / 8U] >> (4U * (pin % 8U))) & 0xFU;
+    for (uint32_t i = 0; i < sizeof(af_table) / sizeof(af_table[0]); i++)
+    {
+        if ((af_table[i].port == port) && (af_table[i].pin == pin) && (af_table[i].af == af))
+        {
+            return &af_table[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Level of a pin that the MCU does not drive: external drive, or else its pull resistor.
+ */
+static bool _external_level(uint32_t port, uint32_t pin)
+{
+    if (drive_mask[port] & (1U << pin))
+    {
+        return drive_level[port] & (1U << pin);
+    }
+    return ((ports[port]->PUPDR >> (2U * pin)) & 0x3U) == 0x1U; // Pull-up. Pull-down and floating are low
+}
+
+/**
+ * @brief Level of a pin.
+ */
+static bool _pin_level(uint32_t port, uint32_t pin)
+{
+    const GPIO_TypeDef *p_port = ports[port];
+    switch ((p_port->MODER >> (2U * pin)) & 0x3U)
+    {
+    case STM32F4_MODEL_GPIO_MODE_OUT:
+        if ((p_port->OTYPER & (1U << pin)) && (p_port->ODR & (1U << pin)))
+        {
+            return _external_level(port, pin); // Open drain released
+        }
+        return p_port->ODR & (1U << pin);
+    case STM32F4_MODEL_GPIO_MODE_AF:
+    {
+        const stm32f4_model_af_t *p_af = _af_channel(port, pin);
+        bool level;
+        if ((p_af != NULL) && stm32f4_model_tim_output(p_af->tim, p_af->ch, &level))
+        {
+            return level;
+        }
+        return _external_level(port, pin);
+    }
+    default:
+        return _external_level(port, pin);
+    }
+}
+
+/**
+ * @brief Propagate an edge of a pin to its EXTI line and to the timer channel of its alternate function.
+ */
+static void _edge(uint32_t port, uint32_t pin, bool level, uint64_t t)
+{
+    if (pin_cb != NULL)
+    {
+        pin_cb(ports[port], (uint8_t)pin, level, t);
+    }
+
+    uint32_t line = 1U << pin;
+    uint32_t selected = (SYSCFG->EXTICR[pin / 4U] >> (4U * (pin % 4U))) & 0xFU;
+    if ((selected == port) && ((level ? EXTI->RTSR : EXTI->FTSR) & line))
+    {
+        EXTI->PR |= line;
+        stm32f4_model_irq_changed();
+    }
+
+    const stm32f4_model_af_t *p_af = _af_channel(port, pin);
+    if (p_af != NULL)
+    {
+        stm32f4_model_tim_input(p_af->tim, p_af->ch, level, t);
+    }
+}
+
+/* Public functions -----------------------------------------------------------*/
+void stm32f4_model_gpio_reset(void)
+{
+    for (uint32_t i = 0; i < STM32F4_MODEL_NUM_GPIOS; i++)
+    {
+        drive_mask[i] = 0;
+        drive_level[i] = 0;
+        levels[i] = 0;
+    }
+    num_events = 0;
+    pin_cb = NULL;
+    stm32f4_model_gpio_update(0); // Levels of the pull resistors of the debug pins
+}
+
+uint64_t stm32f4_model_gpio_next_event(void)
+{
+    return (num_events > 0) ? events[0].t : STM32F4_MODEL_NEVER;
+}
+
+void stm32f4_model_gpio_run(uint64_t t)
+{
+    while ((num_events > 0) && (events[0].t <= t))
+    {
+        stm32f4_model_pin_event_t event = events[0];
+        num_events--;
+        for (uint32_t i = 0; i < num_events; i++)
+        {
+            events[i] = events[i + 1];
+        }
+        drive_mask[event.port] |= 1U << event.pin;
+        drive_level[event.port] = (uint16_t)((drive_level[event.port] & ~(1U << event.pin)) | ((event.level ? 1U : 0U) << event.pin));
+        stm32f4_model_gpio_update(t); // One update per edge, so a zero-width pulse still makes 2 edges
+    }
+}
+
+void stm32f4_model_gpio_write(volatile uint32_t *p_reg, uint32_t old, uint32_t written)
+{
+    if ((uintptr_t)p_reg - (uintptr_t)EXTI < sizeof(EXTI_TypeDef))
+    {
+        if (p_reg == &EXTI->PR)
+        {
+            *p_reg = old & ~written; // Write 1 to clear
+            EXTI->SWIER &= ~written;
+        }
+        else if (p_reg == &EXTI->SWIER)
+        {
+            EXTI->PR |= written & ~old & EXTI->IMR;
+        }
+        stm32f4_model_irq_changed();
+        return;
+    }
+
+    for (uint32_t i = 0; i < STM32F4_MODEL_NUM_GPIOS; i++)
+    {
+        GPIO_TypeDef *p_port = ports[i];
+        if (p_reg == &p_port->BSRR)
+        {
+            p_port->ODR = ((p_port->ODR & ~(written >> 16)) | (written & 0xFFFFU)) & 0xFFFFU; // Set has priority over reset
+            *p_reg = 0;
+        }
+        else if (p_reg == &p_port->ODR)
+        {
+            *p_reg = written & 0xFFFFU;
+        }
+        else if (p_reg == &p_port->IDR)
+        {
+            *p_reg = old; // Read-only
+        }
+    }
+    stm32f4_model_gpio_update(stm32f4_model_now());
+}
+
+void stm32f4_model_gpio_update(uint64_t t)
+{
+    for (uint32_t port = 0; port < STM32F4_MODEL_NUM_GPIOS; port++)
+    {
+        uint16_t new_levels = 0;
+        uint16_t analog = 0;
+        for (uint32_t pin = 0; pin < 16; pin++)
+        {
+            new_levels |= (uint16_t)((_pin_level(port, pin) ? 1U : 0U) << pin);
+            analog |= (uint16_t)((((ports[port]->MODER >> (2U * pin)) & 0x3U) == STM32F4_MODEL_GPIO_MODE_AN) ? (1U << pin) : 0U);
+        }
+        uint16_t changed = new_levels ^ levels[port];
+        levels[port] = new_levels;
+        ports[port]->IDR = new_levels & ~analog;
+        for (uint32_t pin = 0; changed != 0; pin++, changed >>= 1)
+        {
+            if (changed & 0x1U)
+            {
+                _edge(port, pin, (new_levels >> pin) & 0x1U, t);
+            }
+        }
+    }
+}
+
+/* Functions of the API ------------------------------------------------------------*/
+void stm32f4_model_gpio_drive(GPIO_TypeDef *p_port, uint8_t pin, bool level)
+{
+    int32_t port = _port_index(p_port);
+    if ((port < 0) || (pin > 15))
+    {
+        return;
+    }
+    stm32f4_model_commit();
+    drive_mask[port] |= 1U << pin;
+    drive_level[port] = (uint16_t)((drive_level[port] & ~(1U << pin)) | ((level ? 1U : 0U) << pin));
+    stm32f4_model_gpio_update(stm32f4_model_now());
+    stm32f4_model_irq_changed();
+}
+
+void stm32f4_model_gpio_release(GPIO_TypeDef *p_port, uint8_t pin)
+{
+    int32_t port = _port_index(p_port);
+    if ((port < 0) || (pin > 15))
+    {
+        return;
+    }
+    stm32f4_model_commit();
+    drive_mask[port] &= ~(1U << pin);
+    stm32f4_model_gpio_update(stm32f4_model_now());
+    stm32f4_model_irq_changed();
+}
+
+bool stm32f4_model_gpio_schedule(GPIO_TypeDef *p_port, uint8_t pin, bool level, uint64_t cycles)
+{
+    int32_t port = _port_index(p_port);
+    if ((port < 0) || (pin > 15) || (num_events >= STM32F4_MODEL_PIN_EVENTS))
+    {
+        return false;
+    }
+    uint32_t i = num_events;
+    while ((i > 0) && (events[i - 1].t > cycles)) // After the events at the same time: they keep their order
+    {
+        events[i] = events[i - 1];
+        i--;
+    }
+    events[i] = (stm32f4_model_pin_event_t){.t = cycles, .port = (uint8_t)port, .pin = pin, .level = level};
+    num_events++;
+    stm32f4_model_events_changed();
+    return true;
+}
+
+bool stm32f4_model_gpio_pulse(GPIO_TypeDef *p_port, uint8_t pin, uint64_t start_cycles, uint64_t width_cycles)
+{
+    if (num_events + 2U > STM32F4_MODEL_PIN_EVENTS)
+    {
+        return false;
+    }
+    return stm32f4_model_gpio_schedule(p_port, pin, true, start_cycles) && stm32f4_model_gpio_schedule(p_port, pin, false, start_cycles + width_cycles);
+}
+
+void stm32f4_model_gpio_clear_schedule(void)
+{
+    num_events = 0;
+    stm32f4_model_events_changed();
+}
+
+bool stm32f4_model_gpio_get_level(GPIO_TypeDef *p_port, uint8_t pin)
+{
+    int32_t port = _port_index(p_port);
+    if ((port < 0) || (pin > 15))
+    {
+        return false;
+    }
+    stm32f4_model_commit();
+    return (levels[port] >> pin) & 0x1U;
+}
+
+void stm32f4_model_gpio_set_callback(stm32f4_model_pin_cb_t cb)
+{
+    pin_cb = cb;
+}
@@ -0,0 +1,153 @@
+/**
+ * @file stm32f4_model_priv.h
+ * @brief Interface between the modules of the host register model of the STM32F4: core, timers and GPIO.
+ *
+ * The core (`stm32f4_model.c`) owns the virtual clock, the memory-access callbacks, the NVIC and the system peripherals. It calls
+ * the timers and the GPIO to apply the writes to their registers, to refresh their registers before they are read and to run their
+ * events in chronological order. All the times are virtual times in CPU cycles.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef STM32F4_MODEL_PRIV_H_
+#define STM32F4_MODEL_PRIV_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Project includes */
+#include "stm32f4_model.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define STM32F4_MODEL_NEVER UINT64_MAX  /*!< Time of an event that is not scheduled */
+#define STM32F4_MODEL_NUM_TIMS 4U       /*!< Number of modelled timers: TIM2, TIM3, TIM4 and TIM5 */
+#define STM32F4_MODEL_NUM_GPIOS 3U      /*!< Number of modelled ports: GPIOA, GPIOB and GPIOC */
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/* Core */
+/**
+ * @brief Current virtual time in CPU cycles.
+ */
+uint64_t stm32f4_model_now(void);
+
+/**
+ * @brief Apply the last store of the firmware to the registers, if it has not been applied yet. Called by the functions of the
+ * API before they use the registers.
+ */
+void stm32f4_model_commit(void);
+
+/**
+ * @brief Notify the core that the time of the next event of a peripheral may have changed.
+ */
+void stm32f4_model_events_changed(void);
+
+/**
+ * @brief Notify the core that an interrupt line or a pending flag may have changed.
+ */
+void stm32f4_model_irq_changed(void);
+
+/**
+ * @brief Print a diagnostic with the virtual time and abort the program.
+ *
+ * @param p_msg Message.
+ */
+void stm32f4_model_fatal(const char *p_msg);
+
+/* Timers */
+/**
+ * @brief Reset the state of TIM2-5. The registers have been reset by the core.
+ */
+void stm32f4_model_tim_reset(void);
+
+/**
+ * @brief Time of the next event of the timers: counter update or compare match.
+ */
+uint64_t stm32f4_model_tim_next_event(void);
+
+/**
+ * @brief Run the events of the timers due at a time.
+ *
+ * @param t Time of the events.
+ */
+void stm32f4_model_tim_run(uint64_t t);
+
+/**
+ * @brief Apply a write to a register of a timer.
+ *
+ * @param p_reg Register written.
+ * @param old Value before the write.
+ * @param written Value written.
+ */
+void stm32f4_model_tim_write(volatile uint32_t *p_reg, uint32_t old, uint32_t written);
+
+/**
+ * @brief Refresh a register of a timer before it is read.
+ *
+ * @param p_reg Register read.
+ */
+void stm32f4_model_tim_read(volatile uint32_t *p_reg);
+
+/**
+ * @brief Re-evaluate the timers after a change of their clock-enable bits in the RCC.
+ */
+void stm32f4_model_tim_clock_changed(void);
+
+/**
+ * @brief Edge on the input of a channel (TIx) of a timer.
+ *
+ * @param tim Index of the timer (0 for TIM2 to 3 for TIM5).
+ * @param ti Index of the input (0 for TI1 to 3 for TI4).
+ * @param level New level of the input.
+ * @param t Time of the edge.
+ */
+void stm32f4_model_tim_input(uint32_t tim, uint32_t ti, bool level, uint64_t t);
+
+/**
+ * @brief Output of a channel of a timer (OCx after the polarity).
+ *
+ * @param tim Index of the timer (0 for TIM2 to 3 for TIM5).
+ * @param ch Index of the channel (0 for CH1 to 3 for CH4).
+ * @param p_level Level of the output, if enabled.
+ * @retval true if the channel drives its pin, false if the output is disabled.
+ */
+bool stm32f4_model_tim_output(uint32_t tim, uint32_t ch, bool *p_level);
+
+/* GPIO and EXTI */
+/**
+ * @brief Reset the state of the pins and the scheduled edges. The registers have been reset by the core.
+ */
+void stm32f4_model_gpio_reset(void);
+
+/**
+ * @brief Time of the next scheduled edge of a pin.
+ */
+uint64_t stm32f4_model_gpio_next_event(void);
+
+/**
+ * @brief Apply the scheduled edges due at a time.
+ *
+ * @param t Time of the edges.
+ */
+void stm32f4_model_gpio_run(uint64_t t);
+
+/**
+ * @brief Apply a write to a register of a port or of the EXTI.
+ *
+ * @param p_reg Register written.
+ * @param old Value before the write.
+ * @param written Value written.
+ */
+void stm32f4_model_gpio_write(volatile uint32_t *p_reg, uint32_t old, uint32_t written);
+
+/**
+ * @brief Recompute the level of all the pins and propagate the edges to `IDR`, the EXTI, the timers and the callback.
+ *
+ * @param t Time of the change.
+ */
+void stm32f4_model_gpio_update(uint64_t t);
+
+#endif /* STM32F4_MODEL_PRIV_H_ */
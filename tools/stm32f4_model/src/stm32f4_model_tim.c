@@ -0,0 +1,527 @@
+/**
+ * @file stm32f4_model_tim.c
+ * @brief General-purpose timers TIM2-5 of the host register model of the STM32F4.
+ *
+ * The counter is not incremented cycle by cycle. Each timer keeps the value of its counter at the last tick it has been run to,
+ * and the core runs it again at its next event: the overflow (update event) or a compare match of an output channel. The counter
+ * at any time in between is computed when `CNT` is read or a capture is made. The active (shadow) values of `PSC`, `ARR` and
+ * `CCRx` are loaded at the update event when their preload is enabled.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stddef.h>
+
+/* Project includes */
+#include "stm32f4_model_priv.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define STM32F4_MODEL_TIM_SR_CCIF(ch) (TIM_SR_CC1IF << (ch))     /*!< Capture/compare flag of a channel @hideinitializer */
+#define STM32F4_MODEL_TIM_SR_CCOF(ch) (TIM_SR_CC1OF << (ch))     /*!< Overcapture flag of a channel @hideinitializer */
+#define STM32F4_MODEL_TIM_CCER_E(ch) (TIM_CCER_CC1E << (4U * (ch)))    /*!< Enable bit of a channel @hideinitializer */
+#define STM32F4_MODEL_TIM_CCER_P(ch) (TIM_CCER_CC1P << (4U * (ch)))    /*!< Polarity bit of a channel @hideinitializer */
+#define STM32F4_MODEL_TIM_CCER_NP(ch) (TIM_CCER_CC1NP << (4U * (ch)))  /*!< Complementary polarity bit of a channel @hideinitializer */
+
+/* Typedefs --------------------------------------------------------------------*/
+/**
+ * @brief State of a timer that is not visible in its registers.
+ */
+typedef struct
+{
+    TIM_TypeDef *p_tim;     /*!< Registers */
+    uint32_t rcc_en;        /*!< Clock-enable bit in `RCC->APB1ENR` */
+    uint32_t max;           /*!< Maximum value of the counter: 16 or 32 bits */
+    bool running;           /*!< The counter is enabled and clocked */
+    uint64_t t_last;        /*!< Time of the last tick the timer has been run to */
+    uint32_t cnt;           /*!< Counter at `t_last` */
+    uint32_t psc;           /*!< Active prescaler */
+    uint32_t arr;           /*!< Active auto-reload value */
+    uint32_t ccr[4];        /*!< Active compare values of the output channels */
+    bool ref[4];            /*!< Reference output (OCxREF) of the channels */
+    uint64_t next;          /*!< Time of the next event */
+} stm32f4_model_tim_t;
+
+/* Global variables */
+static stm32f4_model_tim_t tims[STM32F4_MODEL_NUM_TIMS] = {
+    {.p_tim = TIM2, .rcc_en = RCC_APB1ENR_TIM2EN, .max = 0xFFFFFFFFU},
+    {.p_tim = TIM3, .rcc_en = RCC_APB1ENR_TIM3EN, .max = 0xFFFFU},
+    {.p_tim = TIM4, .rcc_en = RCC_APB1ENR_TIM4EN, .max = 0xFFFFU},
+    {.p_tim = TIM5, .rcc_en = RCC_APB1ENR_TIM5EN, .max = 0xFFFFFFFFU},
+}; /*!< Timers of the model */
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Timer of a register, or NULL if the register is not of TIM2-5.
+ */
+static stm32f4_model_tim_t *_tim_of(volatile uint32_t *p_reg)
+{
+    for (uint32_t i = 0; i < STM32F4_MODEL_NUM_TIMS; i++)
+    {
+        if ((uintptr_t)p_reg - (uintptr_t)tims[i].p_tim < sizeof(TIM_TypeDef))
+        {
+            return &tims[i];
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Capture/compare selection of a channel (CCxS): 0 output, 1 input TIx, 2 input of the paired channel, 3 TRC.
+ */
+static uint32_t _ccs(const stm32f4_model_tim_t *p_t, uint32_t ch)
+{
+    uint32_t ccmr = (ch < 2) ? p_t->p_tim->CCMR1 : p_t->p_tim->CCMR2;
+    return (ccmr >> (8U * (ch & 1U))) & 0x3U;
+}
+
+/**
+ * @brief Output compare mode of a channel (OCxM).
+ */
+static uint32_t _ocm(const stm32f4_model_tim_t *p_t, uint32_t ch)
+{
+    uint32_t ccmr = (ch < 2) ? p_t->p_tim->CCMR1 : p_t->p_tim->CCMR2;
+    return (ccmr >> (8U * (ch & 1U) + 4U)) & 0x7U;
+}
+
+/**
+ * @brief Preload of the compare value of a channel (OCxPE).
+ */
+static bool _ocpe(const stm32f4_model_tim_t *p_t, uint32_t ch)
+{
+    uint32_t ccmr = (ch < 2) ? p_t->p_tim->CCMR1 : p_t->p_tim->CCMR2;
+    return (ccmr >> (8U * (ch & 1U) + 3U)) & 0x1U;
+}
+
+/**
+ * @brief Capture/compare register of a channel.
+ */
+static volatile uint32_t *_ccr_reg(const stm32f4_model_tim_t *p_t, uint32_t ch)
+{
+    return &p_t->p_tim->CCR1 + ch;
+}
+
+/**
+ * @brief Last value of the counter before it overflows: the auto-reload value, or the maximum if the counter is already above it.
+ */
+static uint32_t _top(const stm32f4_model_tim_t *p_t)
+{
+    return (p_t->cnt <= p_t->arr) ? p_t->arr : p_t->max;
+}
+
+/**
+ * @brief Bit mask of the outputs of the channels: enables in bits 0-3 and levels in bits 4-7.
+ */
+static uint32_t _outputs(uint32_t tim)
+{
+    uint32_t mask = 0;
+    for (uint32_t ch = 0; ch < 4; ch++)
+    {
+        bool level;
+        if (stm32f4_model_tim_output(tim, ch, &level))
+        {
+            mask |= (1U << ch) | ((level ? 1U : 0U) << (ch + 4U));
+        }
+    }
+    return mask;
+}
+
+/**
+ * @brief Update the reference outputs that depend on the counter: forced and PWM modes.
+ */
+static void _update_refs(stm32f4_model_tim_t *p_t)
+{
+    for (uint32_t ch = 0; ch < 4; ch++)
+    {
+        if (_ccs(p_t, ch) != 0)
+        {
+            continue;
+        }
+        switch (_ocm(p_t, ch))
+        {
+        case 4: // Force inactive
+            p_t->ref[ch] = false;
+            break;
+        case 5: // Force active
+            p_t->ref[ch] = true;
+            break;
+        case 6: // PWM mode 1: active while CNT < CCR
+            p_t->ref[ch] = p_t->cnt < p_t->ccr[ch];
+            break;
+        case 7: // PWM mode 2: inactive while CNT < CCR
+            p_t->ref[ch] = p_t->cnt >= p_t->ccr[ch];
+            break;
+        default: // Frozen, or changed on the compare match
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Schedule the next event of a timer: the overflow or the first compare match of an output channel before it.
+ */
+static void _reschedule(stm32f4_model_tim_t *p_t)
+{
+    if (!p_t->running)
+    {
+        p_t->next = STM32F4_MODEL_NEVER;
+        return;
+    }
+    uint32_t top = _top(p_t);
+    uint64_t ticks = (uint64_t)top - p_t->cnt + 1U;
+    for (uint32_t ch = 0; ch < 4; ch++)
+    {
+        uint32_t ccr = p_t->ccr[ch];
+        if ((_ccs(p_t, ch) == 0) && (ccr > p_t->cnt) && (ccr <= top) && ((uint64_t)(ccr - p_t->cnt) < ticks))
+        {
+            ticks = ccr - p_t->cnt;
+        }
+    }
+    p_t->next = p_t->t_last + ticks * ((uint64_t)p_t->psc + 1U);
+}
+
+/**
+ * @brief Run the counter of a timer up to a time without events in between (the last tick before the time).
+ */
+static void _sync(stm32f4_model_tim_t *p_t, uint64_t t)
+{
+    if (!p_t->running || (t <= p_t->t_last))
+    {
+        return;
+    }
+    uint64_t period = (uint64_t)p_t->psc + 1U;
+    uint64_t ticks = (t - p_t->t_last) / period;
+    if (ticks == 0)
+    {
+        return;
+    }
+    uint64_t cnt = p_t->cnt + ticks;
+    uint64_t top = _top(p_t);
+    p_t->cnt = (uint32_t)((cnt > top) ? (cnt % (top + 1U)) : cnt); // Only if an event has been missed
+    p_t->t_last += ticks * period;
+}
+
+/**
+ * @brief Start or stop the counter after a change of `CEN` or of the clock-enable bit.
+ */
+static void _update_running(stm32f4_model_tim_t *p_t, uint64_t t)
+{
+    bool running = (p_t->p_tim->CR1 & TIM_CR1_CEN) && (RCC->APB1ENR & p_t->rcc_en);
+    if (running && !p_t->running)
+    {
+        p_t->t_last = t;
+    }
+    p_t->running = running;
+}
+
+/**
+ * @brief Update event: load the shadow registers and set UIF. An overflow in one-pulse mode stops the counter.
+ *
+ * @param by_ug The event has been generated by software (`UG`), not by an overflow.
+ */
+static void _update_event(stm32f4_model_tim_t *p_t, bool by_ug)
+{
+    TIM_TypeDef *p_tim = p_t->p_tim;
+    if (p_tim->CR1 & TIM_CR1_UDIS)
+    {
+        return;
+    }
+    p_t->psc = p_tim->PSC & 0xFFFFU;
+    p_t->arr = p_tim->ARR & p_t->max;
+    for (uint32_t ch = 0; ch < 4; ch++)
+    {
+        if ((_ccs(p_t, ch) == 0) && _ocpe(p_t, ch))
+        {
+            p_t->ccr[ch] = *_ccr_reg(p_t, ch) & p_t->max;
+        }
+    }
+    if (!(by_ug && (p_tim->CR1 & TIM_CR1_URS)))
+    {
+        p_tim->SR |= TIM_SR_UIF;
+        stm32f4_model_irq_changed();
+    }
+    if (!by_ug && (p_tim->CR1 & TIM_CR1_OPM))
+    {
+        p_tim->CR1 &= ~TIM_CR1_CEN;
+        p_t->running = false;
+    }
+}
+
+/**
+ * @brief Compare match of an output channel: set CCxIF and change the reference of the compare modes.
+ */
+static void _compare_match(stm32f4_model_tim_t *p_t, uint32_t ch)
+{
+    p_t->p_tim->SR |= STM32F4_MODEL_TIM_SR_CCIF(ch);
+    stm32f4_model_irq_changed();
+    switch (_ocm(p_t, ch))
+    {
+    case 1: // Active on match
+        p_t->ref[ch] = true;
+        break;
+    case 2: // Inactive on match
+        p_t->ref[ch] = false;
+        break;
+    case 3: // Toggle
+        p_t->ref[ch] = !p_t->ref[ch];
+        break;
+    default:
+        break;
+    }
+}
+
+/**
+ * @brief Capture the counter in a channel: CCxIF, or CCxOF if the previous capture has not been read.
+ */
+static void _capture(stm32f4_model_tim_t *p_t, uint32_t ch)
+{
+    *_ccr_reg(p_t, ch) = p_t->cnt;
+    if (p_t->p_tim->SR & STM32F4_MODEL_TIM_SR_CCIF(ch))
+    {
+        p_t->p_tim->SR |= STM32F4_MODEL_TIM_SR_CCOF(ch);
+    }
+    p_t->p_tim->SR |= STM32F4_MODEL_TIM_SR_CCIF(ch);
+    stm32f4_model_irq_changed();
+}
+
+/* Public functions -----------------------------------------------------------*/
+void stm32f4_model_tim_reset(void)
+{
+    for (uint32_t i = 0; i < STM32F4_MODEL_NUM_TIMS; i++)
+    {
+        stm32f4_model_tim_t *p_t = &tims[i];
+        p_t->p_tim->ARR = p_t->max;
+        p_t->running = false;
+        p_t->t_last = 0;
+        p_t->cnt = 0;
+        p_t->psc = 0;
+        p_t->arr = p_t->max;
+        for (uint32_t ch = 0; ch < 4; ch++)
+        {
+            p_t->ccr[ch] = 0;
+            p_t->ref[ch] = false;
+        }
+        p_t->next = STM32F4_MODEL_NEVER;
+    }
+}
+
+uint64_t stm32f4_model_tim_next_event(void)
+{
+    uint64_t next = STM32F4_MODEL_NEVER;
+    for (uint32_t i = 0; i < STM32F4_MODEL_NUM_TIMS; i++)
+    {
+        next = (tims[i].next < next) ? tims[i].next : next;
+    }
+    return next;
+}
+
+void stm32f4_model_tim_run(uint64_t t)
+{
+    bool outputs_changed = false;
+    for (uint32_t i = 0; i < STM32F4_MODEL_NUM_TIMS; i++)
+    {
+        stm32f4_model_tim_t *p_t = &tims[i];
+        if (p_t->next > t)
+        {
+            continue;
+        }
+        uint32_t outputs = _outputs(i);
+        uint64_t ticks = (t - p_t->t_last) / ((uint64_t)p_t->psc + 1U);
+        bool overflow = (uint64_t)p_t->cnt + ticks > _top(p_t);
+        p_t->cnt = overflow ? 0U : p_t->cnt + (uint32_t)ticks;
+        p_t->t_last = t;
+        if (overflow)
+        {
+            _update_event(p_t, false);
+        }
+        for (uint32_t ch = 0; ch < 4; ch++)
+        {
+            if ((_ccs(p_t, ch) == 0) && (p_t->cnt == p_t->ccr[ch]))
+            {
+                _compare_match(p_t, ch);
+            }
+        }
+        _update_refs(p_t);
+        _reschedule(p_t);
+        outputs_changed = outputs_changed || (_outputs(i) != outputs);
+    }
+    if (outputs_changed)
+    {
+        stm32f4_model_gpio_update(t);
+    }
+}
+
+void stm32f4_model_tim_write(volatile uint32_t *p_reg, uint32_t old, uint32_t written)
+{
+    stm32f4_model_tim_t *p_t = _tim_of(p_reg);
+    if (p_t == NULL)
+    {
+        return;
+    }
+    TIM_TypeDef *p_tim = p_t->p_tim;
+    uint64_t now = stm32f4_model_now();
+    uint32_t outputs = _outputs((uint32_t)(p_t - tims));
+    _sync(p_t, now);
+
+    if (p_reg == &p_tim->CR1)
+    {
+        if (!(written & TIM_CR1_ARPE))
+        {
+            p_t->arr = p_tim->ARR & p_t->max;
+        }
+        _update_running(p_t, now);
+    }
+    else if (p_reg == &p_tim->SR)
+    {
+        *p_reg = old & written; // Read/clear by writing 0
+    }
+    else if (p_reg == &p_tim->EGR)
+    {
+        if (written & TIM_EGR_UG)
+        {
+            // The counter and the prescaler restart
+            p_t->cnt = 0;
+            p_t->t_last = now;
+            _update_event(p_t, true);
+        }
+        for (uint32_t ch = 0; ch < 4; ch++)
+        {
+            if (written & (TIM_SR_CC1IF << ch)) // CCxG
+            {
+                if (_ccs(p_t, ch) == 0)
+                {
+                    _compare_match(p_t, ch);
+                }
+                else
+                {
+                    _capture(p_t, ch);
+                }
+            }
+        }
+        *p_reg = 0;
+    }
+    else if (p_reg == &p_tim->CNT)
+    {
+        p_t->cnt = written & p_t->max;
+        p_t->t_last = now;
+        *p_reg = p_t->cnt;
+    }
+    else if (p_reg == &p_tim->ARR)
+    {
+        *p_reg = written & p_t->max;
+        if (!(p_tim->CR1 & TIM_CR1_ARPE))
+        {
+            p_t->arr = written & p_t->max;
+        }
+    }
+    else if ((p_reg >= &p_tim->CCR1) && (p_reg <= &p_tim->CCR4))
+    {
+        uint32_t ch = (uint32_t)(p_reg - &p_tim->CCR1);
+        if (_ccs(p_t, ch) != 0)
+        {
+            *p_reg = old; // Read-only in input capture
+        }
+        else
+        {
+            *p_reg = written & p_t->max;
+            if (!_ocpe(p_t, ch))
+            {
+                p_t->ccr[ch] = written & p_t->max;
+            }
+        }
+    }
+    else if ((p_reg == &p_tim->CCMR1) || (p_reg == &p_tim->CCMR2))
+    {
+        for (uint32_t ch = 0; ch < 4; ch++)
+        {
+            if ((_ccs(p_t, ch) == 0) && !_ocpe(p_t, ch))
+            {
+                p_t->ccr[ch] = *_ccr_reg(p_t, ch) & p_t->max;
+            }
+        }
+    }
+    // PSC is loaded at the update event. DIER, CCER and the rest take effect at once
+
+    _update_refs(p_t);
+    _reschedule(p_t);
+    if (_outputs((uint32_t)(p_t - tims)) != outputs)
+    {
+        stm32f4_model_gpio_update(now);
+    }
+}
+
+void stm32f4_model_tim_read(volatile uint32_t *p_reg)
+{
+    stm32f4_model_tim_t *p_t = _tim_of(p_reg);
+    if (p_t == NULL)
+    {
+        return;
+    }
+    TIM_TypeDef *p_tim = p_t->p_tim;
+    if (p_reg == &p_tim->CNT)
+    {
+        _sync(p_t, stm32f4_model_now());
+        *p_reg = p_t->cnt;
+    }
+    else if ((p_reg >= &p_tim->CCR1) && (p_reg <= &p_tim->CCR4))
+    {
+        uint32_t ch = (uint32_t)(p_reg - &p_tim->CCR1);
+        if (_ccs(p_t, ch) != 0)
+        {
+            p_tim->SR &= ~STM32F4_MODEL_TIM_SR_CCIF(ch); // Reading a capture clears its flag
+            stm32f4_model_irq_changed();
+        }
+    }
+}
+
+void stm32f4_model_tim_clock_changed(void)
+{
+    uint64_t now = stm32f4_model_now();
+    for (uint32_t i = 0; i < STM32F4_MODEL_NUM_TIMS; i++)
+    {
+        _sync(&tims[i], now);
+        _update_running(&tims[i], now);
+        _reschedule(&tims[i]);
+    }
+}
+
+void stm32f4_model_tim_input(uint32_t tim, uint32_t ti, bool level, uint64_t t)
+{
+    stm32f4_model_tim_t *p_t = &tims[tim];
+    uint32_t ccer = p_t->p_tim->CCER;
+    for (uint32_t ch = 0; ch < 4; ch++)
+    {
+        uint32_t ccs = _ccs(p_t, ch);
+        if ((ccs == 0) || (ccs == 3) || !(ccer & STM32F4_MODEL_TIM_CCER_E(ch)))
+        {
+            continue;
+        }
+        uint32_t source = (ccs == 1) ? ch : (ch ^ 1U); // CCxS = 10 selects TI2 for CC1, TI1 for CC2, TI4 for CC3 and TI3 for CC4
+        if (source != ti)
+        {
+            continue;
+        }
+        bool falling = ccer & STM32F4_MODEL_TIM_CCER_P(ch);
+        bool both = falling && (ccer & STM32F4_MODEL_TIM_CCER_NP(ch));
+        if (both || (level != falling))
+        {
+            _sync(p_t, t);
+            _capture(p_t, ch);
+        }
+    }
+}
+
+bool stm32f4_model_tim_output(uint32_t tim, uint32_t ch, bool *p_level)
+{
+    const stm32f4_model_tim_t *p_t = &tims[tim];
+    uint32_t ccer = p_t->p_tim->CCER;
+    if ((_ccs(p_t, ch) != 0) || !(ccer & STM32F4_MODEL_TIM_CCER_E(ch)))
+    {
+        return false;
+    }
+    *p_level = p_t->ref[ch] != (bool)(ccer & STM32F4_MODEL_TIM_CCER_P(ch));
+    return true;
+}
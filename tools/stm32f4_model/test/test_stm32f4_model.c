@@ -0,0 +1,180 @@
+/**
+ * @file test_stm32f4_model.c
+ * @brief Unit test of the host register model of the STM32F4.
+ *
+ * The peripherals are configured by the firmware side of the test (`test_stm32f4_model_fw.c`, instrumented as the port), and
+ * this program checks the virtual times of the updates, the PWM edges and the captures, and the order of the handlers with
+ * preemption and tail-chaining.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Project includes */
+#include "tools_test.h"
+#include "stm32f4_model.h"
+#include "test_stm32f4_model_fw.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define TEST_CYCLES_PER_US (STM32F4_MODEL_CLOCK_HZ / 1000000U)  /*!< CPU cycles per microsecond @hideinitializer */
+#define TEST_EDGES_LEN 16U                                      /*!< Maximum edges recorded by the pin callback @hideinitializer */
+
+/* Global variables */
+static uint64_t edges_cycles[TEST_EDGES_LEN];   /*!< Times of the edges of PB6 */
+static bool edges_level[TEST_EDGES_LEN];        /*!< Levels after the edges of PB6 */
+static uint32_t edges_len;                      /*!< Number of edges of PB6 recorded */
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Reset the model and the traces before a test.
+ */
+static void _setup(void)
+{
+    stm32f4_model_reset();
+    stm32f4_model_gpio_set_callback(NULL);
+    fw_reset();
+    edges_len = 0;
+}
+
+/**
+ * @brief Record the edges of PB6.
+ */
+static void _pin_cb(GPIO_TypeDef *p_port, uint8_t pin, bool level, uint64_t cycles)
+{
+    if ((p_port == GPIOB) && (pin == 6) && (edges_len < TEST_EDGES_LEN))
+    {
+        edges_cycles[edges_len] = cycles;
+        edges_level[edges_len] = level;
+        edges_len++;
+    }
+}
+
+/**
+ * @brief Instrumented code takes virtual time, and the clock only advances with it or with the API.
+ */
+static void test_virtual_clock(void)
+{
+    _setup();
+    stm32f4_model_set_cycles_per_access(1);
+    uint64_t start = stm32f4_model_get_cycles();
+    fw_busy_loop(1000);
+    uint64_t elapsed = stm32f4_model_get_cycles() - start;
+    TOOLS_TEST_ASSERT(elapsed >= 2000, "each iteration loads and stores the counter");
+    stm32f4_model_set_cycles_per_access(STM32F4_MODEL_CYCLES_PER_ACCESS);
+
+    start = stm32f4_model_get_us();
+    stm32f4_model_advance_us(1500);
+    TOOLS_TEST_ASSERT(stm32f4_model_get_us() - start == 1500, "advance moves the clock exactly");
+}
+
+/**
+ * @brief The update interrupt of a timer comes once per period, and `__WFI()` sleeps until it.
+ */
+static void test_timer_update(void)
+{
+    _setup();
+    fw_tim3_periodic(1000);
+    uint64_t start = stm32f4_model_get_cycles(); /* The counter has been enabled by the last store */
+    stm32f4_model_advance_us(4500);
+    TOOLS_TEST_ASSERT(stm32f4_model_get_irq_count(TIM3_IRQn) == 4, "4 updates in 4.5 ms");
+    TOOLS_TEST_ASSERT((fw_read(&TIM3->SR) & TIM_SR_UIF) == 0, "the handler clears UIF");
+
+    fw_wfi();
+    uint64_t wake = stm32f4_model_get_cycles() - start;
+    TOOLS_TEST_ASSERT(stm32f4_model_get_irq_count(TIM3_IRQn) == 5, "the sleep ends with the next update");
+    TOOLS_TEST_ASSERT((wake >= 5000U * TEST_CYCLES_PER_US) && (wake <= 5000U * TEST_CYCLES_PER_US + 100U), "the sleep lasts until the next update");
+
+    uint32_t cnt = fw_read(&TIM3->CNT);
+    TOOLS_TEST_ASSERT(cnt < 5, "the counter is read at the current time");
+}
+
+/**
+ * @brief A PWM mode 1 output is high from the update to the compare match.
+ */
+static void test_pwm_output(void)
+{
+    _setup();
+    stm32f4_model_gpio_set_callback(_pin_cb);
+    fw_tim4_pwm(1600, 400);
+    stm32f4_model_advance_us(500);
+    TOOLS_TEST_ASSERT(edges_len >= 8, "5 periods of 100 us");
+    for (uint32_t i = 1; i + 1 < edges_len; i++)
+    {
+        uint64_t width = edges_cycles[i + 1] - edges_cycles[i];
+        uint64_t expected = edges_level[i] ? 400 : 1200;
+        TOOLS_TEST_ASSERT(width == expected, "high for CCR1 cycles and low for the rest of the period");
+    }
+    TOOLS_TEST_ASSERT(stm32f4_model_gpio_get_level(GPIOB, 6) == edges_level[edges_len - 1], "the level follows the last edge");
+}
+
+/**
+ * @brief An external pulse is captured on both edges with the resolution of the timer.
+ */
+static void test_input_capture(void)
+{
+    _setup();
+    fw_tim2_capture();
+    uint64_t start = stm32f4_model_get_cycles() + 100 * TEST_CYCLES_PER_US;
+    TOOLS_TEST_ASSERT(stm32f4_model_gpio_pulse(GPIOA, 1, start, 580 * TEST_CYCLES_PER_US), "the pulse is scheduled");
+    stm32f4_model_advance_us(1000);
+    TOOLS_TEST_ASSERT(fw_captures_len == 2, "rising and falling edges captured");
+    TOOLS_TEST_ASSERT(fw_captures[1] - fw_captures[0] == 580, "the width of the pulse in timer ticks");
+    TOOLS_TEST_ASSERT(stm32f4_model_get_irq_count(TIM2_IRQn) == 2, "one interrupt per edge");
+}
+
+/**
+ * @brief A pin edge enters its EXTI handler; a higher priority interrupt preempts it and a lower one is tail-chained.
+ */
+static void test_exti_nesting(void)
+{
+    _setup();
+    fw_exti0_falling();
+    stm32f4_model_advance_us(10);
+    TOOLS_TEST_ASSERT(fw_log_len == 0, "no edge with the pull-up");
+    TOOLS_TEST_ASSERT(fw_read(&GPIOA->IDR) & GPIO_IDR_ID0, "the pull-up sets the input");
+
+    stm32f4_model_gpio_drive(GPIOA, 0, false);
+    stm32f4_model_advance_us(10);
+    const uint32_t expected[] = {EXTI0_IRQn, EXTI1_IRQn, EXTI0_IRQn | FW_LOG_EXIT, EXTI2_IRQn};
+    TOOLS_TEST_ASSERT(fw_log_len == 4, "3 handlers");
+    for (uint32_t i = 0; (i < fw_log_len) && (i < 4); i++)
+    {
+        TOOLS_TEST_ASSERT(fw_log[i] == expected[i], "EXTI1 preempts EXTI0 and EXTI2 runs after it");
+    }
+    TOOLS_TEST_ASSERT((fw_read(&EXTI->PR) & EXTI_PR_PR0) == 0, "the handler clears the pending flag");
+
+    stm32f4_model_gpio_release(GPIOA, 0);
+    stm32f4_model_advance_us(10);
+    TOOLS_TEST_ASSERT(stm32f4_model_get_irq_count(EXTI0_IRQn) == 1, "the rising edge is not detected");
+}
+
+/**
+ * @brief SysTick interrupts at its reload rate.
+ */
+static void test_systick(void)
+{
+    _setup();
+    TOOLS_TEST_ASSERT(fw_systick_config(STM32F4_MODEL_CLOCK_HZ / 1000U) == 0, "valid reload");
+    stm32f4_model_advance_us(10000);
+    uint32_t count = stm32f4_model_get_irq_count(SysTick_IRQn);
+    TOOLS_TEST_ASSERT((count >= 9) && (count <= 10), "one exception per millisecond");
+    TOOLS_TEST_ASSERT(fw_ticks == count, "the handler runs on each exception");
+}
+
+/* Main function -----------------------------------------------------------*/
+int main(void)
+{
+    TOOLS_TEST_RUN(test_virtual_clock);
+    TOOLS_TEST_RUN(test_timer_update);
+    TOOLS_TEST_RUN(test_pwm_output);
+    TOOLS_TEST_RUN(test_input_capture);
+    TOOLS_TEST_RUN(test_exti_nesting);
+    TOOLS_TEST_RUN(test_systick);
+    return TOOLS_TEST_END();
+}
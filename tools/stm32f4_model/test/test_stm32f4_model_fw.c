@@ -0,0 +1,181 @@
+/**
+ * @file test_stm32f4_model_fw.c
+ * @brief Firmware side of the unit test of the host register model of the STM32F4.
+ *
+ * This file is compiled with the instrumentation of the firmware, so its accesses to the registers advance the virtual clock and
+ * are seen by the model, as the accesses of the port. The test program (not instrumented) calls these functions to configure
+ * the peripherals, and the handlers record when they are entered and left.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Project includes */
+#include "test_stm32f4_model_fw.h"
+
+/* Global variables */
+volatile uint32_t fw_log[FW_LOG_LEN];         /*!< Trace of the handlers: IRQ number, plus `FW_LOG_EXIT` when it returns */
+volatile uint32_t fw_log_len;                 /*!< Number of entries of the trace */
+volatile uint32_t fw_captures[FW_LOG_LEN];    /*!< Values of `TIM2->CCR2` read by the capture handler */
+volatile uint32_t fw_captures_len;            /*!< Number of captures */
+volatile uint32_t fw_ticks;                   /*!< Count of the SysTick handler */
+volatile uint32_t fw_count;                   /*!< Counter of the busy loop */
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Add an entry to the trace of the handlers.
+ */
+static void _log(uint32_t entry)
+{
+    if (fw_log_len < FW_LOG_LEN)
+    {
+        fw_log[fw_log_len++] = entry;
+    }
+}
+
+/* Handlers --------------------------------------------------------------------*/
+void TIM2_IRQHandler(void)
+{
+    if (TIM2->SR & TIM_SR_CC2IF)
+    {
+        if (fw_captures_len < FW_LOG_LEN)
+        {
+            fw_captures[fw_captures_len++] = TIM2->CCR2; /* Reading the capture clears CC2IF */
+        }
+    }
+    TIM2->SR &= ~TIM_SR_UIF;
+}
+
+void TIM3_IRQHandler(void)
+{
+    TIM3->SR &= ~TIM_SR_UIF;
+    _log(TIM3_IRQn);
+}
+
+void SysTick_Handler(void)
+{
+    fw_ticks++;
+}
+
+void EXTI0_IRQHandler(void)
+{
+    EXTI->PR = EXTI_PR_PR0;
+    _log(EXTI0_IRQn);
+    NVIC->STIR = EXTI2_IRQn; /* Lower priority: tail-chained after this handler */
+    NVIC->STIR = EXTI1_IRQn; /* Higher priority: preempts this handler */
+    _log(EXTI0_IRQn | FW_LOG_EXIT);
+}
+
+void EXTI1_IRQHandler(void)
+{
+    _log(EXTI1_IRQn);
+}
+
+void EXTI2_IRQHandler(void)
+{
+    _log(EXTI2_IRQn);
+}
+
+/* Public functions -----------------------------------------------------------*/
+void fw_reset(void)
+{
+    fw_log_len = 0;
+    fw_captures_len = 0;
+    fw_ticks = 0;
+}
+
+void fw_tim3_periodic(uint32_t period_us)
+{
+    RCC->APB1ENR |= RCC_APB1ENR_TIM3EN;
+    TIM3->PSC = 15; /* 1 MHz */
+    TIM3->ARR = period_us - 1;
+    TIM3->EGR = TIM_EGR_UG;
+    TIM3->SR &= ~TIM_SR_UIF;
+    TIM3->DIER |= TIM_DIER_UIE;
+    NVIC_SetPriority(TIM3_IRQn, 2);
+    NVIC_EnableIRQ(TIM3_IRQn);
+    TIM3->CR1 |= TIM_CR1_CEN;
+}
+
+void fw_tim4_pwm(uint32_t period_cycles, uint32_t high_cycles)
+{
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOBEN;
+    RCC->APB1ENR |= RCC_APB1ENR_TIM4EN;
+    GPIOB->MODER = (GPIOB->MODER & ~(GPIO_MODER_MODER0 << (6 * 2))) | (0x2U << (6 * 2)); /* Alternate */
+    GPIOB->AFR[0] = (GPIOB->AFR[0] & ~(0xFU << (6 * 4))) | (2U << (6 * 4)); /* AF2: TIM4 */
+    TIM4->PSC = 0;
+    TIM4->ARR = period_cycles - 1;
+    TIM4->CCR1 = high_cycles;
+    TIM4->CCMR1 = TIM_CCMR1_OC1M_2 | TIM_CCMR1_OC1M_1 | TIM_CCMR1_OC1PE; /* PWM mode 1 */
+    TIM4->CCER = TIM_CCER_CC1E;
+    TIM4->CR1 = TIM_CR1_ARPE;
+    TIM4->EGR = TIM_EGR_UG;
+    TIM4->CR1 |= TIM_CR1_CEN;
+}
+
+void fw_tim2_capture(void)
+{
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN;
+    RCC->APB1ENR |= RCC_APB1ENR_TIM2EN;
+    GPIOA->MODER = (GPIOA->MODER & ~(GPIO_MODER_MODER0 << (1 * 2))) | (0x2U << (1 * 2)); /* Alternate */
+    GPIOA->AFR[0] = (GPIOA->AFR[0] & ~(0xFU << (1 * 4))) | (1U << (1 * 4)); /* AF1: TIM2 */
+    TIM2->PSC = 15; /* 1 MHz */
+    TIM2->ARR = 0xFFFFFFFFU;
+    TIM2->CCMR1 = TIM_CCMR1_CC2S_0; /* IC2 mapped on TI2 */
+    TIM2->CCER = TIM_CCER_CC2P | TIM_CCER_CC2NP | TIM_CCER_CC2E; /* Both edges */
+    TIM2->EGR = TIM_EGR_UG;
+    TIM2->SR = 0;
+    TIM2->DIER = TIM_DIER_CC2IE;
+    NVIC_EnableIRQ(TIM2_IRQn);
+    TIM2->CR1 = TIM_CR1_CEN;
+}
+
+void fw_exti0_falling(void)
+{
+    RCC->AHB1ENR |= RCC_AHB1ENR_GPIOAEN;
+    RCC->APB2ENR |= RCC_APB2ENR_SYSCFGEN;
+    GPIOA->MODER &= ~GPIO_MODER_MODER0;
+    GPIOA->PUPDR = (GPIOA->PUPDR & ~GPIO_PUPDR_PUPD0) | 0x1U; /* Pull-up */
+    SYSCFG->EXTICR[0] &= ~0xFU; /* PA0 */
+    EXTI->FTSR |= EXTI_FTSR_TR0;
+    EXTI->RTSR &= ~EXTI_RTSR_TR0;
+    EXTI->IMR |= EXTI_IMR_MR0;
+    NVIC_SetPriority(EXTI0_IRQn, 2);
+    NVIC_SetPriority(EXTI1_IRQn, 1);
+    NVIC_SetPriority(EXTI2_IRQn, 3);
+    NVIC_EnableIRQ(EXTI0_IRQn);
+    NVIC_EnableIRQ(EXTI1_IRQn);
+    NVIC_EnableIRQ(EXTI2_IRQn);
+}
+
+uint32_t fw_systick_config(uint32_t ticks)
+{
+    return SysTick_Config(ticks);
+}
+
+void fw_wfi(void)
+{
+    __WFI();
+}
+
+uint32_t fw_busy_loop(uint32_t iterations)
+{
+    fw_count = 0;
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        fw_count++;
+    }
+    return fw_count;
+}
+
+uint32_t fw_read(volatile uint32_t *p_reg)
+{
+    return *p_reg;
+}
+
+void fw_write(volatile uint32_t *p_reg, uint32_t value)
+{
+    *p_reg = value;
+}
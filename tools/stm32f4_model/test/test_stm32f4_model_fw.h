@@ -0,0 +1,82 @@
+/**
+ * @file test_stm32f4_model_fw.h
+ * @brief Firmware side of the unit test of the host register model of the STM32F4 (compiled with the instrumentation).
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef TEST_STM32F4_MODEL_FW_H_
+#define TEST_STM32F4_MODEL_FW_H_
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+
+/* Project includes */
+#include "stm32f4xx.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define FW_LOG_LEN 32U              /*!< Maximum entries of the traces */
+#define FW_LOG_EXIT 0x100U          /*!< Flag of the trace entries written when a handler returns */
+
+/* Global variables */
+extern volatile uint32_t fw_log[FW_LOG_LEN];
+extern volatile uint32_t fw_log_len;
+extern volatile uint32_t fw_captures[FW_LOG_LEN];
+extern volatile uint32_t fw_captures_len;
+extern volatile uint32_t fw_ticks;
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Clear the traces of the handlers.
+ */
+void fw_reset(void);
+
+/**
+ * @brief Start TIM3 with an update interrupt every period (1 us resolution).
+ */
+void fw_tim3_periodic(uint32_t period_us);
+
+/**
+ * @brief Start a PWM (mode 1, preloaded) on TIM4 CH1, output on PB6.
+ */
+void fw_tim4_pwm(uint32_t period_cycles, uint32_t high_cycles);
+
+/**
+ * @brief Start the input capture of both edges of PA1 on TIM2 CH2 (1 us resolution). The handler stores the captures.
+ */
+void fw_tim2_capture(void);
+
+/**
+ * @brief Configure the falling edge of PA0 (with pull-up) on EXTI0, and the priorities of EXTI0 (2), EXTI1 (1) and EXTI2 (3).
+ */
+void fw_exti0_falling(void);
+
+/**
+ * @brief `SysTick_Config()` of CMSIS.
+ */
+uint32_t fw_systick_config(uint32_t ticks);
+
+/**
+ * @brief Sleep until an interrupt.
+ */
+void fw_wfi(void);
+
+/**
+ * @brief Loop on a global counter.
+ */
+uint32_t fw_busy_loop(uint32_t iterations);
+
+/**
+ * @brief Load a register.
+ */
+uint32_t fw_read(volatile uint32_t *p_reg);
+
+/**
+ * @brief Store a register.
+ */
+void fw_write(volatile uint32_t *p_reg, uint32_t value);
+
+#endif /* TEST_STM32F4_MODEL_FW_H_ */
@@ -0,0 +1,141 @@
+/**
+ * @file unity.c
+ * @brief Subset of the Unity test framework for the suites of `test/stm32f4` run on the host register model.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <string.h>
+#include <setjmp.h>
+#include <inttypes.h>
+
+/* Project includes */
+#include "unity.h"
+
+/* Global variables */
+static const char *p_suite_file;    /*!< Source file of the suite */
+static const char *p_test_name;     /*!< Name of the running test */
+static int test_line;               /*!< Line of the running test */
+static int num_tests;               /*!< Tests run */
+static int num_failures;            /*!< Tests failed */
+static int num_ignored;             /*!< Tests ignored */
+static jmp_buf abort_frame;         /*!< Context to leave a test that fails or is ignored */
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Print the header of a result line: `file:line:test:`.
+ */
+static void _print_header(int line)
+{
+    printf("%s:%d:%s:", p_suite_file, line, p_test_name);
+}
+
+/* Public functions -----------------------------------------------------------*/
+void UnityBegin(const char *p_file)
+{
+    p_suite_file = p_file;
+    num_tests = 0;
+    num_failures = 0;
+    num_ignored = 0;
+}
+
+int UnityEnd(void)
+{
+    printf("\n-----------------------\n%d Tests %d Failures %d Ignored \n%s\n", num_tests, num_failures, num_ignored, (num_failures == 0) ? "OK" : "FAIL");
+    fflush(stdout);
+    return num_failures;
+}
+
+void UnityDefaultTestRun(void (*func)(void), const char *p_name, int line)
+{
+    p_test_name = p_name;
+    test_line = line;
+    num_tests++;
+    if (setjmp(abort_frame) == 0)
+    {
+        setUp();
+        func();
+        tearDown();
+        _print_header(test_line);
+        printf("PASS\n");
+    }
+    fflush(stdout);
+}
+
+void UnityFail(const char *p_msg, int line, const char *p_detail)
+{
+    _print_header(line);
+    printf("FAIL");
+    if (p_detail != NULL)
+    {
+        printf(": %s", p_detail);
+    }
+    if (p_msg != NULL)
+    {
+        printf(": %s", p_msg);
+    }
+    printf("\n");
+    num_failures++;
+    longjmp(abort_frame, 1);
+}
+
+void UnityIgnore(const char *p_msg, int line)
+{
+    _print_header(line);
+    printf("IGNORE");
+    if (p_msg != NULL)
+    {
+        printf(": %s", p_msg);
+    }
+    printf("\n");
+    num_ignored++;
+    longjmp(abort_frame, 1);
+}
+
+void UnityAssertEqualNumber(int64_t expected, int64_t actual, const char *p_msg, int line, int is_hex)
+{
+    if (expected != actual)
+    {
+        char detail[96];
+        if (is_hex)
+        {
+            snprintf(detail, sizeof(detail), "Expected 0x%08" PRIX64 " Was 0x%08" PRIX64, (uint64_t)expected, (uint64_t)actual);
+        }
+        else
+        {
+            snprintf(detail, sizeof(detail), "Expected %" PRId64 " Was %" PRId64, expected, actual);
+        }
+        UnityFail(p_msg, line, detail);
+    }
+}
+
+void UnityAssertNumbersWithin(uint64_t delta, int64_t expected, int64_t actual, const char *p_msg, int line)
+{
+    uint64_t diff = (expected > actual) ? (uint64_t)(expected - actual) : (uint64_t)(actual - expected);
+    if (diff > delta)
+    {
+        char detail[96];
+        snprintf(detail, sizeof(detail), "Values Not Within Delta %" PRIu64 " Expected %" PRId64 " Was %" PRId64, delta, expected, actual);
+        UnityFail(p_msg, line, detail);
+    }
+}
+
+void UnityAssertEqualMemory(const void *p_expected, const void *p_actual, size_t len, const char *p_msg, int line)
+{
+    const uint8_t *p_e = p_expected;
+    const uint8_t *p_a = p_actual;
+    for (size_t i = 0; i < len; i++)
+    {
+        if (p_e[i] != p_a[i])
+        {
+            char detail[96];
+            snprintf(detail, sizeof(detail), "Element %zu Expected %u Was %u", i, p_e[i], p_a[i]);
+            UnityFail(p_msg, line, detail);
+        }
+    }
+}
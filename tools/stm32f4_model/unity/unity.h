@@ -0,0 +1,119 @@
+/**
+ * @file unity.h
+ * @brief Subset of the Unity test framework for the suites of `test/stm32f4` run on the host register model.
+ *
+ * Unity is provided by MatrixMCU, which is not available to the host tools. This subset has the same interface for the
+ * assertions used by the suites (`UNITY_TEST_ASSERT_xxx()` with line and message, and the short `TEST_ASSERT_xxx()` forms) and
+ * prints the same report, so the suites are compiled without changes. A failed assertion ends the test with `longjmp()`, as Unity
+ * does without `UNITY_EXCLUDE_SETJMP_H`.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+#ifndef UNITY_FRAMEWORK_H
+#define UNITY_FRAMEWORK_H
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>  /* Included by Unity for its output */
+#include <math.h>   /* Included by Unity for the floating-point assertions */
+
+/* Function prototypes and explanation -------------------------------------------------*/
+/**
+ * @brief Function run before each test. Defined by the suite.
+ */
+void setUp(void);
+
+/**
+ * @brief Function run after each test. Defined by the suite.
+ */
+void tearDown(void);
+
+/**
+ * @brief Start a suite.
+ *
+ * @param p_file Name of the source file of the suite.
+ */
+void UnityBegin(const char *p_file);
+
+/**
+ * @brief End a suite and print its report.
+ *
+ * @return int Number of failed tests.
+ */
+int UnityEnd(void);
+
+/**
+ * @brief Run a test between `setUp()` and `tearDown()`.
+ *
+ * @param func Test.
+ * @param p_name Name of the test.
+ * @param line Line of the test in the suite.
+ */
+void UnityDefaultTestRun(void (*func)(void), const char *p_name, int line);
+
+/**
+ * @brief Fail the running test.
+ *
+ * @param p_msg Message of the assertion.
+ * @param line Line of the assertion.
+ * @param p_detail Values compared, or NULL.
+ */
+void UnityFail(const char *p_msg, int line, const char *p_detail);
+
+/**
+ * @brief Ignore the running test.
+ *
+ * @param p_msg Reason.
+ * @param line Line of the call.
+ */
+void UnityIgnore(const char *p_msg, int line);
+
+/**
+ * @brief Compare 2 integers and fail the test if they are different.
+ */
+void UnityAssertEqualNumber(int64_t expected, int64_t actual, const char *p_msg, int line, int is_hex);
+
+/**
+ * @brief Compare 2 integers and fail the test if they differ more than a delta.
+ */
+void UnityAssertNumbersWithin(uint64_t delta, int64_t expected, int64_t actual, const char *p_msg, int line);
+
+/**
+ * @brief Compare 2 memory blocks and fail the test if they are different.
+ */
+void UnityAssertEqualMemory(const void *p_expected, const void *p_actual, size_t len, const char *p_msg, int line);
+
+/* Defines and enums ----------------------------------------------------------*/
+#define UNITY_BEGIN() UnityBegin(__FILE__)                                  /*!< Start the suite @hideinitializer */
+#define UNITY_END() UnityEnd()                                              /*!< End the suite @hideinitializer */
+#define RUN_TEST(func) UnityDefaultTestRun(func, #func, __LINE__)           /*!< Run a test @hideinitializer */
+
+#define UNITY_TEST_FAIL(line, message) UnityFail((message), (int)(line), NULL)                                                     /*!< @hideinitializer */
+#define UNITY_TEST_ASSERT(condition, line, message) do { if (!(condition)) { UNITY_TEST_FAIL((line), (message)); } } while (0)     /*!< @hideinitializer */
+#define UNITY_TEST_ASSERT_EQUAL_INT(expected, actual, line, message) UnityAssertEqualNumber((int64_t)(expected), (int64_t)(actual), (message), (int)(line), 0)   /*!< @hideinitializer */
+#define UNITY_TEST_ASSERT_EQUAL_INT32(expected, actual, line, message) UnityAssertEqualNumber((int32_t)(expected), (int32_t)(actual), (message), (int)(line), 0) /*!< @hideinitializer */
+#define UNITY_TEST_ASSERT_EQUAL_UINT8(expected, actual, line, message) UnityAssertEqualNumber((uint8_t)(expected), (uint8_t)(actual), (message), (int)(line), 0) /*!< @hideinitializer */
+#define UNITY_TEST_ASSERT_EQUAL_UINT16(expected, actual, line, message) UnityAssertEqualNumber((uint16_t)(expected), (uint16_t)(actual), (message), (int)(line), 0) /*!< @hideinitializer */
+#define UNITY_TEST_ASSERT_EQUAL_UINT32(expected, actual, line, message) UnityAssertEqualNumber((uint32_t)(expected), (uint32_t)(actual), (message), (int)(line), 0) /*!< @hideinitializer */
+#define UNITY_TEST_ASSERT_EQUAL_HEX32(expected, actual, line, message) UnityAssertEqualNumber((uint32_t)(expected), (uint32_t)(actual), (message), (int)(line), 1) /*!< @hideinitializer */
+#define UNITY_TEST_ASSERT_EQUAL_PTR(expected, actual, line, message) UnityAssertEqualNumber((int64_t)(uintptr_t)(expected), (int64_t)(uintptr_t)(actual), (message), (int)(line), 1) /*!< @hideinitializer */
+#define UNITY_TEST_ASSERT_INT_WITHIN(delta, expected, actual, line, message) UnityAssertNumbersWithin((uint64_t)(delta), (int64_t)(expected), (int64_t)(actual), (message), (int)(line)) /*!< @hideinitializer */
+#define UNITY_TEST_ASSERT_UINT32_WITHIN(delta, expected, actual, line, message) UnityAssertNumbersWithin((uint64_t)(delta), (uint32_t)(expected), (uint32_t)(actual), (message), (int)(line)) /*!< @hideinitializer */
+#define UNITY_TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, actual, num, line, message) UnityAssertEqualMemory((expected), (actual), (size_t)(num), (message), (int)(line)) /*!< @hideinitializer */
+
+#define TEST_FAIL_MESSAGE(message) UNITY_TEST_FAIL(__LINE__, (message))                                       /*!< @hideinitializer */
+#define TEST_IGNORE_MESSAGE(message) UnityIgnore((message), __LINE__)                                         /*!< @hideinitializer */
+#define TEST_IGNORE() UnityIgnore(NULL, __LINE__)                                                             /*!< @hideinitializer */
+#define TEST_ASSERT(condition) UNITY_TEST_ASSERT((condition), __LINE__, " Expression Evaluated To FALSE")     /*!< @hideinitializer */
+#define TEST_ASSERT_TRUE(condition) UNITY_TEST_ASSERT((condition), __LINE__, " Expected TRUE Was FALSE")      /*!< @hideinitializer */
+#define TEST_ASSERT_FALSE(condition) UNITY_TEST_ASSERT(!(condition), __LINE__, " Expected FALSE Was TRUE")    /*!< @hideinitializer */
+#define TEST_ASSERT_EQUAL(expected, actual) UNITY_TEST_ASSERT_EQUAL_INT((expected), (actual), __LINE__, NULL) /*!< @hideinitializer */
+#define TEST_ASSERT_EQUAL_INT(expected, actual) UNITY_TEST_ASSERT_EQUAL_INT((expected), (actual), __LINE__, NULL)       /*!< @hideinitializer */
+#define TEST_ASSERT_EQUAL_UINT32(expected, actual) UNITY_TEST_ASSERT_EQUAL_UINT32((expected), (actual), __LINE__, NULL) /*!< @hideinitializer */
+
+#endif /* UNITY_FRAMEWORK_H */
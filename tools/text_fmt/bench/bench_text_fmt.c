@@ -0,0 +1,82 @@
+/**
+ * @file bench_text_fmt.c
+ * @brief Benchmark of the text formatter of the diagnostics against the `snprintf()` of the C library of the host.
+ *
+ * Each case formats one of the messages of the FSMs many times. The ratio is indicative: on the target, newlib `printf()` is
+ * also much larger in flash, which is measured by `example_text_fmt_benchmark` on the board.
+ *
+ * Usage: `bench_text_fmt [number_of_calls]` (default: 5 million).
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Project includes */
+#include "text_fmt.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define BENCH_DEFAULT_CALLS 5000000UL   /*!< Default number of calls of each case @hideinitializer */
+#define BENCH_REPETITIONS 5             /*!< Number of runs of each case. The fastest one is reported @hideinitializer */
+
+/* Global variables */
+static volatile uint32_t sink;  /*!< Destination of the results, so the compiler does not remove the calls */
+static char buf[TEXT_FMT_LINE_LEN]; /*!< Output of the calls */
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Current time in seconds of a monotonic clock.
+ */
+static double _now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Run a case with both formatters and print the best time per call of each one.
+ * @hideinitializer
+ */
+#define BENCH_CASE(name, calls, ...)                                                    \
+    do                                                                                  \
+    {                                                                                   \
+        double best_fmt = 1e9, best_libc = 1e9;                                         \
+        for (int rep = 0; rep < BENCH_REPETITIONS; rep++)                               \
+        {                                                                               \
+            double start = _now_s();                                                    \
+            for (unsigned long i = 0; i < (calls); i++)                                 \
+            {                                                                           \
+                sink += text_fmt(buf, sizeof(buf), __VA_ARGS__);                        \
+            }                                                                           \
+            double t = _now_s() - start;                                                \
+            best_fmt = (t < best_fmt) ? t : best_fmt;                                   \
+            start = _now_s();                                                           \
+            for (unsigned long i = 0; i < (calls); i++)                                 \
+            {                                                                           \
+                sink += (uint32_t)snprintf(buf, sizeof(buf), __VA_ARGS__);              \
+            }                                                                           \
+            t = _now_s() - start;                                                       \
+            best_libc = (t < best_libc) ? t : best_libc;                                \
+        }                                                                               \
+        printf("%-28s text_fmt %7.1f ns/call, snprintf %7.1f ns/call (x%.1f)\n", (name), \
+               best_fmt * 1e9 / (calls), best_libc * 1e9 / (calls), best_libc / best_fmt); \
+    } while (0)
+
+int main(int argc, char *argv[])
+{
+    unsigned long calls = (argc > 1) ? strtoul(argv[1], NULL, 10) : BENCH_DEFAULT_CALLS;
+    long now = 1234567;
+
+    BENCH_CASE("distance (%ld %ld)", calls, "[URBANITE][%ld] Distance: %ld cm\n", now, 173L);
+    BENCH_CASE("state (%ld %s)", calls, "[URBANITE][%ld] Resumed from snapshot (%s)\n", now, "ON");
+    BENCH_CASE("press (%ld %ld)", calls, "[DEBUG][%ld] Duracion: %ld\n", now, 1200L);
+    BENCH_CASE("limits (%d %ld)", calls, "%d %ld %lu", -2147483647, -9223372036854775807L, 18446744073709551615UL);
+    return 0;
+}
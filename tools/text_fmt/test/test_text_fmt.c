@@ -0,0 +1,219 @@
+/**
+ * @file test_text_fmt.c
+ * @brief Unit and stress test for the text formatter of the diagnostics.
+ *
+ * The output of every supported conversion is compared with the `snprintf()` of the host, also at the limits of the types and
+ * when the buffer is too small. The stress test runs several producers in threads (as ISRs preempting the main loop) on the
+ * same ring and checks that every line is popped once, complete and in the order of its producer, or counted as an overrun.
+ *
+ * @author Alvaro Castillo Esteban
+ * @author Maya Lopez Romero
+ * @date 18/10/2026
+ */
+
+/* Includes ------------------------------------------------------------------*/
+/* Standard C includes */
+#include <limits.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+/* Project includes */
+#include "tools_test.h"
+#include "text_fmt.h"
+
+/* Defines and enums ----------------------------------------------------------*/
+#define TEST_BUF_LEN 128                /*!< Size of the buffers of the comparisons @hideinitializer */
+#define TEST_STRESS_PRODUCERS 3U        /*!< Number of producer threads of the stress test @hideinitializer */
+#define TEST_STRESS_LINES 20000U        /*!< Number of lines sent by each producer of the stress test @hideinitializer */
+
+/* Global variables */
+static text_fmt_ring_t stress;              /*!< Ring shared by the threads of the stress test */
+static volatile uint32_t producers_done;    /*!< Number of producers that have sent all their lines */
+
+/* Private functions -----------------------------------------------------------*/
+/**
+ * @brief Compare the output of the formatter with the output of `snprintf()` for the same format and arguments.
+ * @hideinitializer
+ */
+#define TEST_COMPARE(size, ...)                                                                     \
+    do                                                                                              \
+    {                                                                                               \
+        char expected[TEST_BUF_LEN];                                                                \
+        char actual[TEST_BUF_LEN];                                                                  \
+        memset(actual, 'X', sizeof(actual));                                                        \
+        int n = snprintf(expected, (size), __VA_ARGS__);                                            \
+        uint32_t len = text_fmt(actual, (size), __VA_ARGS__);                                       \
+        uint32_t expected_len = ((uint32_t)n < (size)) ? (uint32_t)n : (size) - 1;                  \
+        TOOLS_TEST_ASSERT(strcmp(actual, expected) == 0, "The text must be the one of snprintf()"); \
+        TOOLS_TEST_ASSERT(len == expected_len, "The length must be the one written");               \
+        TOOLS_TEST_ASSERT(actual[len] == '\0', "The text must be terminated");                      \
+    } while (0)
+
+/**
+ * @brief Every conversion gives the same text as `snprintf()`, also at the limits of the types.
+ */
+static void test_conversions(void)
+{
+    TEST_COMPARE(TEST_BUF_LEN, "no conversions");
+    TEST_COMPARE(TEST_BUF_LEN, "%d %d %d %d", 0, -1, INT_MAX, INT_MIN);
+    TEST_COMPARE(TEST_BUF_LEN, "%ld %ld %ld", 0L, LONG_MAX, LONG_MIN);
+    TEST_COMPARE(TEST_BUF_LEN, "%u %u %lu %lu", 0U, UINT_MAX, 7UL, ULONG_MAX);
+    TEST_COMPARE(TEST_BUF_LEN, "%x %x %lx", 0U, 0xDEADBEEFU, ULONG_MAX);
+    TEST_COMPARE(TEST_BUF_LEN, "%i %c%c %% %s", -42, 'o', 'k', "string");
+    TEST_COMPARE(TEST_BUF_LEN, "[%s]%s[%s]", "", "abc", "");
+
+    // Messages of the FSMs
+    TEST_COMPARE(TEST_BUF_LEN, "[URBANITE][%ld] Distance: %ld cm\n", 123456L, 17L);
+    TEST_COMPARE(TEST_BUF_LEN, "[URBANITE][%ld] Resumed from snapshot (%s)\n", 4294967L, "ON");
+    TEST_COMPARE(TEST_BUF_LEN, "[DEBUG][%ld] Duración: %ld\n", 1000L, 3001L);
+}
+
+/**
+ * @brief A text that does not fit is truncated and terminated, and nothing is written after the buffer.
+ */
+static void test_truncation(void)
+{
+    TEST_COMPARE(1, "%s", "abc");
+    TEST_COMPARE(2, "%ld", -12345L);
+    TEST_COMPARE(5, "%ld", 123456789L);
+    TEST_COMPARE(8, "id %s: %d", "sensor", 9);
+    TEST_COMPARE(10, "%d%%%d", 1234, 5678);
+
+    char buf[8];
+    memset(buf, 'X', sizeof(buf));
+    TOOLS_TEST_ASSERT(text_fmt(buf, 4, "%s", "overflow") == 3, "Only the characters that fit are written");
+    TOOLS_TEST_ASSERT(buf[4] == 'X', "Nothing is written after the buffer");
+    TOOLS_TEST_ASSERT(text_fmt(buf, 0, "%s", "x") == 0, "An empty buffer is not written");
+    TOOLS_TEST_ASSERT(buf[0] == 'o', "An empty buffer is not written");
+    TOOLS_TEST_ASSERT(text_fmt(NULL, 8, "x") == 0, "A NULL buffer is not written");
+}
+
+/**
+ * @brief Unsupported and incomplete conversions are copied as they are, and a NULL string is printed as in glibc.
+ */
+static void test_unsupported(void)
+{
+    char buf[TEST_BUF_LEN];
+    const char *p_format = "%f %q|%l";  // Not a literal, so the compiler does not check it
+    text_fmt(buf, sizeof(buf), p_format, 3);
+    TOOLS_TEST_ASSERT(strcmp(buf, "%f %q|%l") == 0, "Unsupported conversions must be copied");
+
+    const char *volatile p_null = NULL;     // Volatile, so the compiler does not warn about the NULL argument
+    text_fmt(buf, sizeof(buf), "%d %s", 1, p_null);
+    TOOLS_TEST_ASSERT(strcmp(buf, "1 (null)") == 0, "A NULL string must be printed as (null)");
+}
+
+/**
+ * @brief Lines come out in order, a full ring drops the new ones and counts them, and long lines are truncated.
+ */
+static void test_ring(void)
+{
+    text_fmt_ring_t ring;
+    char line[TEXT_FMT_LINE_LEN];
+    text_fmt_ring_init(&ring);
+    TOOLS_TEST_ASSERT(!text_fmt_ring_pop(&ring, line, sizeof(line)), "An empty ring must not pop");
+
+    for (int32_t i = 0; i < TEXT_FMT_RING_LEN; i++)
+    {
+        TOOLS_TEST_ASSERT(text_fmt_ring_printf(&ring, "line %d", i), "A ring with free slots must accept the line");
+    }
+    TOOLS_TEST_ASSERT(!text_fmt_ring_printf(&ring, "dropped"), "A full ring must reject the line");
+    TOOLS_TEST_ASSERT(text_fmt_ring_get_overruns(&ring) == 1, "Each rejected line is an overrun");
+
+    // Wrap around the slots several times
+    for (int32_t i = 0; i < 3 * TEXT_FMT_RING_LEN; i++)
+    {
+        char expected[TEXT_FMT_LINE_LEN];
+        snprintf(expected, sizeof(expected), "line %d", i);
+        TOOLS_TEST_ASSERT(text_fmt_ring_pop(&ring, line, sizeof(line)), "A ring with lines must pop");
+        TOOLS_TEST_ASSERT(strcmp(line, expected) == 0, "Lines must come out in order");
+        TOOLS_TEST_ASSERT(text_fmt_ring_printf(&ring, "line %d", i + TEXT_FMT_RING_LEN), "A freed slot must be reused");
+    }
+
+    char small[4];
+    text_fmt_ring_init(&ring);
+    text_fmt_ring_printf(&ring, "%s", "long line");
+    TOOLS_TEST_ASSERT(text_fmt_ring_pop(&ring, small, sizeof(small)) && (strcmp(small, "lon") == 0), "The copy is truncated to the buffer");
+
+    char long_str[2 * TEXT_FMT_LINE_LEN];
+    memset(long_str, 'a', sizeof(long_str) - 1);
+    long_str[sizeof(long_str) - 1] = '\0';
+    text_fmt_ring_printf(&ring, "%s", long_str);
+    TOOLS_TEST_ASSERT(text_fmt_ring_pop(&ring, line, sizeof(line)) && (strlen(line) == TEXT_FMT_LINE_LEN - 1), "The line is truncated to the slot");
+}
+
+/**
+ * @brief Producer of the stress test. It retries the lines dropped by a full ring, so every line is eventually sent.
+ */
+static void *_producer(void *p_arg)
+{
+    uint32_t id = (uint32_t)(uintptr_t)p_arg;
+    for (uint32_t seq = 0; seq < TEST_STRESS_LINES; seq++)
+    {
+        while (!text_fmt_ring_printf(&stress, "p%u seq %u check %x", id, seq, ~seq))
+        {
+            sched_yield();
+        }
+    }
+    __atomic_fetch_add(&producers_done, 1, __ATOMIC_RELEASE);
+    return NULL;
+}
+
+/**
+ * @brief Several producers and one consumer on the same ring: no line is lost, duplicated or torn, and each producer's are in order.
+ */
+static void test_stress(void)
+{
+    text_fmt_ring_init(&stress);
+    producers_done = 0;
+
+    pthread_t producers[TEST_STRESS_PRODUCERS];
+    for (uint32_t i = 0; i < TEST_STRESS_PRODUCERS; i++)
+    {
+        TOOLS_TEST_ASSERT(pthread_create(&producers[i], NULL, _producer, (void *)(uintptr_t)i) == 0, "The producer thread must start");
+    }
+
+    uint32_t next_seq[TEST_STRESS_PRODUCERS] = {0};
+    uint32_t received = 0;
+    bool ok = true;
+    char line[TEXT_FMT_LINE_LEN];
+    while (ok)
+    {
+        if (!text_fmt_ring_pop(&stress, line, sizeof(line)))
+        {
+            if ((__atomic_load_n(&producers_done, __ATOMIC_ACQUIRE) == TEST_STRESS_PRODUCERS) && !text_fmt_ring_pop(&stress, line, sizeof(line)))
+            {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+        unsigned id, seq, check;
+        if ((sscanf(line, "p%u seq %u check %x", &id, &seq, &check) != 3) || (id >= TEST_STRESS_PRODUCERS) || (check != ~seq) ||
+            (seq != next_seq[id]))
+        {
+            ok = false;
+            break;
+        }
+        next_seq[id]++;
+        received++;
+    }
+    for (uint32_t i = 0; i < TEST_STRESS_PRODUCERS; i++)
+    {
+        pthread_join(producers[i], NULL);
+    }
+
+    TOOLS_TEST_ASSERT(ok, "Every line must be complete and in the order of its producer");
+    TOOLS_TEST_ASSERT(received == TEST_STRESS_PRODUCERS * TEST_STRESS_LINES, "Every line must be received");
+}
+
+int main(void)
+{
+    TOOLS_TEST_RUN(test_conversions);
+    TOOLS_TEST_RUN(test_truncation);
+    TOOLS_TEST_RUN(test_unsupported);
+    TOOLS_TEST_RUN(test_ring);
+    TOOLS_TEST_RUN(test_stress);
+    return TOOLS_TEST_END();
+}